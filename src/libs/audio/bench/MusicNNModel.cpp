@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <filesystem>
 #include <random>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
@@ -63,6 +64,35 @@ namespace lms::audio::musicnn::benchmarks
             benchmark::DoNotOptimize(model.forward(patch));
     }
 
+    static void BM_MusicNNModel_forwardBatch(benchmark::State& state)
+    {
+        const std::filesystem::path path{ getMusicNNModelPathFromEnv() };
+        if (path.empty())
+        {
+            state.SkipWithMessage("LMS_MUSICNN_MODEL not set");
+            return;
+        }
+
+        const MusicNNModel model{ path };
+        const std::size_t batchSize{ static_cast<std::size_t>(state.range(0)) };
+
+        const auto patch{ makeRandomPatch() };
+        std::vector<float> patches;
+        for (std::size_t i{}; i < batchSize; ++i)
+            patches.insert(std::cend(patches), std::cbegin(patch), std::cend(patch));
+        std::vector<float> embeddings(batchSize * MusicNNModel::outputSize);
+
+        for (auto _ : state)
+        {
+            model.forward(patches, embeddings);
+            benchmark::DoNotOptimize(embeddings.data());
+        }
+
+        state.counters["patches"] = benchmark::Counter(static_cast<double>(state.iterations() * batchSize), benchmark::Counter::kIsRate);
+        state.counters["dynamicBatch"] = model.hasDynamicBatchSize() ? 1 : 0;
+    }
+
     BENCHMARK(BM_MusicNNModel_forward);
+    BENCHMARK(BM_MusicNNModel_forwardBatch)->RangeMultiplier(2)->Range(1, 64)->Unit(benchmark::kMillisecond);
 
 } // namespace lms::audio::musicnn::benchmarks
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/io_context.hpp>
+
+#include "audio/Exception.hpp"
+#include "audio/ITranscoder.hpp"
+#include "core/IChildProcessManager.hpp"
+#include "core/IConfig.hpp"
+#include "core/IOContextRunner.hpp"
+#include "core/Service.hpp"
+#include "core/testing/FileWriters.hpp"
+
+namespace lms::audio::benchmarks
+{
+    namespace
+    {
+        constexpr unsigned sampleRate{ 44'100 };
+        constexpr unsigned channelCount{ 2 };
+        constexpr std::chrono::seconds sourceDuration{ 60 };
+        constexpr std::size_t readBufferSize{ 262'144 }; // same as the transcoding resource handler
+        constexpr std::size_t maxThreadCount{ 8 }; // in-process transcodes run in the io context threads
+
+        // 16-bit PCM WAV, with a few tones to avoid trivially compressible data
+        void writeWavFile(const std::filesystem::path& path)
+        {
+            const std::size_t frameCount{ sampleRate * static_cast<std::size_t>(sourceDuration.count()) };
+            const std::size_t dataSize{ frameCount * channelCount * 2 };
+
+            std::ofstream os{ path, std::ios::binary | std::ios::trunc };
+            core::testing::writeWavHeader(os, sampleRate, channelCount, dataSize);
+
+            for (std::size_t i{}; i < frameCount; ++i)
+            {
+                const double t{ static_cast<double>(i) / sampleRate };
+                for (unsigned channel{}; channel < channelCount; ++channel)
+                {
+                    const double value{ 0.3 * std::sin(2 * std::numbers::pi * (220 + 110 * channel) * t) + 0.2 * std::sin(2 * std::numbers::pi * 1234.5 * t * (1 + t / 60)) };
+                    core::testing::writeLE(os, static_cast<std::uint16_t>(static_cast<std::int16_t>(value * 32767)), 2);
+                }
+            }
+        }
+
+        class TranscoderFixture
+        {
+        public:
+            TranscoderFixture()
+                : _tmpDir{ std::filesystem::temp_directory_path() / "lms-bench-transcoder" }
+                , _ioContextRunner{ _ioContext, maxThreadCount, "Bench" }
+            {
+                std::filesystem::create_directories(_tmpDir);
+
+                {
+                    std::ofstream configFile{ _tmpDir / "lms.conf" };
+                }
+                _config.assign(core::createConfig(_tmpDir / "lms.conf"));
+                _childProcessManager.assign(core::createChildProcessManager(_ioContext));
+
+                writeWavFile(getInputFile());
+            }
+
+            ~TranscoderFixture()
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(_tmpDir, ec);
+            }
+
+            TranscoderFixture(const TranscoderFixture&) = delete;
+            TranscoderFixture& operator=(const TranscoderFixture&) = delete;
+
+            std::filesystem::path getInputFile() const { return _tmpDir / "input.wav"; }
+            boost::asio::io_context& getIOContext() { return _ioContext; }
+
+        private:
+            const std::filesystem::path _tmpDir;
+            boost::asio::io_context _ioContext;
+            core::IOContextRunner _ioContextRunner;
+            core::Service<core::IConfig> _config;
+            core::Service<core::IChildProcessManager> _childProcessManager;
+        };
+
+        TranscoderFixture& getTranscoderFixture()
+        {
+            static TranscoderFixture fixture;
+            return fixture;
+        }
+
+        TranscodeParameters createTranscodeParameters(const std::filesystem::path& inputFile, core::media::Container container, core::media::Codec codec)
+        {
+            TranscodeParameters parameters;
+            parameters.inputParameters.filePath = inputFile;
+            parameters.inputParameters.audioProperties = AudioProperties{
+                .container = core::media::Container::WAV,
+                .codec = core::media::Codec::PCM,
+                .duration = sourceDuration,
+                .bitrate = sampleRate * channelCount * 16,
+                .channelCount = channelCount,
+                .sampleRate = sampleRate,
+                .bitsPerSample = 16,
+            };
+            parameters.outputParameters.format = TranscodeOutputFormat{ container, codec };
+            parameters.outputParameters.bitrate = 128'000;
+
+            return parameters;
+        }
+
+        // Works for both backends, callbacks are called from the io context threads
+        std::size_t readBlocking(ITranscoder& transcoder, std::span<std::byte> buffer)
+        {
+            std::promise<std::size_t> readPromise;
+            std::future<std::size_t> readFuture{ readPromise.get_future() };
+
+            transcoder.asyncRead(buffer.data(), buffer.size(), [&](std::size_t nbReadBytes) { readPromise.set_value(nbReadBytes); });
+
+            return readFuture.get();
+        }
+
+        template<TranscoderBackend backend, core::media::Container container, core::media::Codec codec>
+        void BM_Transcoder(benchmark::State& state)
+        {
+            using Clock = std::chrono::steady_clock;
+
+            const TranscodeParameters parameters{ createTranscodeParameters(getTranscoderFixture().getInputFile(), container, codec) };
+            std::vector<std::byte> buffer(readBufferSize);
+            std::vector<double> firstByteLatencies; // in ms
+            std::size_t outputByteCount{};
+
+            for (auto _ : state)
+            {
+                const Clock::time_point start{ Clock::now() };
+
+                std::unique_ptr<ITranscoder> transcoder;
+                try
+                {
+                    transcoder = createTranscoder(getTranscoderFixture().getIOContext(), parameters, backend);
+                }
+                catch (const Exception& e)
+                {
+                    state.SkipWithError(e.what());
+                    break;
+                }
+
+                bool firstByteReceived{};
+                while (!transcoder->finished())
+                {
+                    const std::size_t nbReadBytes{ readBlocking(*transcoder, buffer) };
+                    if (nbReadBytes > 0 && !firstByteReceived)
+                    {
+                        firstByteLatencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+                        firstByteReceived = true;
+                    }
+                    outputByteCount += nbReadBytes;
+                }
+            }
+
+            if (!firstByteLatencies.empty())
+            {
+                std::sort(std::begin(firstByteLatencies), std::end(firstByteLatencies));
+                const auto percentile{ [&](double p) { return firstByteLatencies[static_cast<std::size_t>(p * (firstByteLatencies.size() - 1))]; } };
+
+                state.counters["first_byte_p50_ms"] = benchmark::Counter{ percentile(0.5), benchmark::Counter::kAvgThreads };
+                state.counters["first_byte_p99_ms"] = benchmark::Counter{ percentile(0.99), benchmark::Counter::kAvgThreads };
+            }
+            state.counters["output_bytes"] = benchmark::Counter{ static_cast<double>(outputByteCount), benchmark::Counter::kAvgIterations };
+            // Throughput, in seconds of audio transcoded per second
+            state.counters["audio_speed"] = benchmark::Counter{ static_cast<double>(state.iterations() * sourceDuration.count()), benchmark::Counter::kIsRate };
+            state.SetItemsProcessed(state.iterations());
+        }
+    } // namespace
+
+    BENCHMARK_TEMPLATE(BM_Transcoder, TranscoderBackend::ChildProcess, core::media::Container::MPEG, core::media::Codec::MP3)->ThreadRange(1, maxThreadCount)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK_TEMPLATE(BM_Transcoder, TranscoderBackend::InProcess, core::media::Container::MPEG, core::media::Codec::MP3)->ThreadRange(1, maxThreadCount)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK_TEMPLATE(BM_Transcoder, TranscoderBackend::ChildProcess, core::media::Container::Ogg, core::media::Codec::Opus)->ThreadRange(1, maxThreadCount)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK_TEMPLATE(BM_Transcoder, TranscoderBackend::InProcess, core::media::Container::Ogg, core::media::Codec::Opus)->ThreadRange(1, maxThreadCount)->UseRealTime()->Unit(benchmark::kMillisecond);
+} // namespace lms::audio::benchmarks
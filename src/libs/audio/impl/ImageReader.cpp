@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audio/IImageReader.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "audio/Exception.hpp"
+
+namespace lms::audio
+{
+    std::vector<std::byte> readImageData(const std::filesystem::path& p, std::uint64_t dataOffset, std::size_t dataSize)
+    {
+        const int fd{ ::open(p.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (fd == -1)
+            throw IOFileException{ p, "open failed", std::error_code{ errno, std::generic_category() } };
+
+        std::vector<std::byte> data(dataSize);
+
+        std::size_t readSize{};
+        std::error_code ec;
+        while (readSize < dataSize)
+        {
+            const ::ssize_t res{ ::pread(fd, data.data() + readSize, dataSize - readSize, static_cast<::off_t>(dataOffset + readSize)) };
+            if (res == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                ec = std::error_code{ errno, std::generic_category() };
+                break;
+            }
+            if (res == 0)
+                break; // file is shorter than expected
+
+            readSize += static_cast<std::size_t>(res);
+        }
+
+        ::close(fd);
+
+        if (ec)
+            throw IOFileException{ p, "pread failed", ec };
+        if (readSize != dataSize)
+            throw Exception{ "File '" + p.string() + "': unexpected end of file while reading image data" };
+
+        return data;
+    }
+} // namespace lms::audio
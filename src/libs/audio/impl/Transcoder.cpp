@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include "audio/ITranscoder.hpp"
+
+#include "ffmpeg/InProcessTranscoder.hpp"
+#include "ffmpeg/Transcoder.hpp"
+
+namespace lms::audio
+{
+    std::unique_ptr<ITranscoder> createTranscoder(boost::asio::io_context& ioContext, const TranscodeParameters& parameters, TranscoderBackend backend)
+    {
+        switch (backend)
+        {
+        case TranscoderBackend::ChildProcess:
+            return std::make_unique<ffmpeg::Transcoder>(parameters);
+        case TranscoderBackend::InProcess:
+            return std::make_unique<ffmpeg::InProcessTranscoder>(ioContext, parameters);
+        }
+
+        return nullptr;
+    }
+} // namespace lms::audio
@@ -337,6 +337,9 @@ namespace lms::audio::ffmpeg
             const ::AVPacket& pkt{ avstream->attached_pic };
 
             picture.data = std::span{ reinterpret_cast<const std::byte*>(pkt.data), static_cast<std::size_t>(pkt.size) };
+            // only set by demuxers that read the picture as is from the file (ex: MP4 cover art)
+            if (pkt.pos >= 0)
+                picture.dataOffset = static_cast<std::uint64_t>(pkt.pos);
             func(picture, metadata);
         }
     }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <optional>
@@ -41,6 +42,7 @@ namespace lms::audio::ffmpeg
     {
         std::string mimeType;
         std::span<const std::byte> data; // valid as long as IAudioFile exists
+        std::optional<std::uint64_t> dataOffset;
     };
 
     struct ContainerInfo
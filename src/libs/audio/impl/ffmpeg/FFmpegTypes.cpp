@@ -25,11 +25,20 @@ extern "C"
 #include <libavcodec/avcodec.h>
 #include <libavcodec/packet.h>
 #include <libavformat/avformat.h>
+#include <libavformat/avio.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/mem.h>
 #include <libswresample/swresample.h>
 }
 
 namespace lms::audio::ffmpeg
 {
+    void AvAudioFifoDeleter::operator()(AVAudioFifo* fifo) const noexcept
+    {
+        if (fifo)
+            ::av_audio_fifo_free(fifo);
+    }
+
     void AvCodecContextDeleter::operator()(AVCodecContext* ctx) const noexcept
     {
         if (ctx)
@@ -44,12 +53,27 @@ namespace lms::audio::ffmpeg
         ::avformat_close_input(&ctx);
     }
 
+    void AvOutputFormatContextDeleter::operator()(AVFormatContext* ctx) const noexcept
+    {
+        if (ctx)
+            ::avformat_free_context(ctx);
+    }
+
     void AvFrameDeleter::operator()(AVFrame* frame) const noexcept
     {
         if (frame)
             ::av_frame_free(&frame);
     }
 
+    void AvIOContextDeleter::operator()(AVIOContext* ctx) const noexcept
+    {
+        if (!ctx)
+            return;
+
+        ::av_freep(&ctx->buffer);
+        ::avio_context_free(&ctx);
+    }
+
     void AVPacketDeleter::operator()(AVPacket* packet) const noexcept
     {
         if (packet)
@@ -24,9 +24,11 @@
 
 extern "C"
 {
+    struct AVAudioFifo;
     struct AVCodecContext;
     struct AVFormatContext;
     struct AVFrame;
+    struct AVIOContext;
     struct AVPacket;
 
     struct SwrContext;
@@ -34,6 +36,12 @@ extern "C"
 
 namespace lms::audio::ffmpeg
 {
+    struct AvAudioFifoDeleter
+    {
+        void operator()(AVAudioFifo* fifo) const noexcept;
+    };
+    using AVAudioFifoPtr = std::unique_ptr<AVAudioFifo, AvAudioFifoDeleter>;
+
     struct AvCodecContextDeleter
     {
         void operator()(AVCodecContext* ctx) const noexcept;
@@ -46,12 +54,26 @@ namespace lms::audio::ffmpeg
     };
     using AVFormatContextPtr = std::unique_ptr<AVFormatContext, AvFormatContextDeleter>;
 
+    // For contexts created using avformat_alloc_output_context2
+    struct AvOutputFormatContextDeleter
+    {
+        void operator()(AVFormatContext* ctx) const noexcept;
+    };
+    using AVOutputFormatContextPtr = std::unique_ptr<AVFormatContext, AvOutputFormatContextDeleter>;
+
     struct AvFrameDeleter
     {
         void operator()(AVFrame* frame) const noexcept;
     };
     using AVFramePtr = std::unique_ptr<AVFrame, AvFrameDeleter>;
 
+    // Also frees the internal buffer
+    struct AvIOContextDeleter
+    {
+        void operator()(AVIOContext* ctx) const noexcept;
+    };
+    using AVIOContextPtr = std::unique_ptr<AVIOContext, AvIOContextDeleter>;
+
     struct AVPacketDeleter
     {
         void operator()(AVPacket* packet) const noexcept;
@@ -44,6 +44,7 @@ namespace lms::audio::ffmpeg
             Image image;
             image.data = picture.data;
             image.mimeType = picture.mimeType;
+            image.dataOffset = picture.dataOffset;
             if (metaDataHasKeyword(metaData, "front"))
                 image.type = core::media::ImageType::FrontCover;
             else if (metaDataHasKeyword(metaData, "back"))
@@ -0,0 +1,725 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InProcessTranscoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavformat/avio.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/mem.h>
+#include <libavutil/samplefmt.h>
+#include <libswresample/swresample.h>
+}
+
+#include "core/ILogger.hpp"
+#include "core/media/MimeType.hpp"
+
+#include "audio/Exception.hpp"
+
+#include "Exception.hpp"
+
+namespace lms::audio::ffmpeg
+{
+#define LOG(severity, message) LMS_LOG(TRANSCODING, severity, "[" << _debugId << "] - " << message)
+
+    namespace
+    {
+        constexpr int outputIOBufferSize{ 32 * 1024 };
+        constexpr int defaultEncoderFrameSize{ 4096 }; // for encoders that accept any frame size
+
+        const char* getMuxerName(core::media::Container container)
+        {
+            switch (container)
+            {
+            case core::media::Container::FLAC:
+                return "flac";
+            case core::media::Container::Ogg:
+                return "ogg";
+            case core::media::Container::MPEG:
+                return "mp3";
+
+            default:
+                throw Exception{ "Unsupported container type " + std::string{ core::media::containerToString(container).str() } };
+            }
+        }
+
+        const char* getEncoderName(core::media::Codec codec)
+        {
+            switch (codec)
+            {
+            case core::media::Codec::MP3:
+                return "libmp3lame";
+            case core::media::Codec::Opus:
+                return "libopus";
+            case core::media::Codec::Vorbis:
+                return "libvorbis";
+            case core::media::Codec::FLAC:
+                return "flac";
+
+            default:
+                throw Exception{ "Unhandled codec type " + std::string{ core::media::getCodecDesc(codec).name.str() } };
+            }
+        }
+
+        std::span<const int> getSupportedSampleRates(const ::AVCodec* encoder)
+        {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+            const void* configs{};
+            int count{};
+            if (::avcodec_get_supported_config(nullptr, encoder, AV_CODEC_CONFIG_SAMPLE_RATE, 0, &configs, &count) < 0 || !configs)
+                return {};
+
+            return std::span{ static_cast<const int*>(configs), static_cast<std::size_t>(count) };
+#else
+            const int* sampleRates{ encoder->supported_samplerates };
+            if (!sampleRates)
+                return {};
+
+            std::size_t count{};
+            while (sampleRates[count] != 0)
+                ++count;
+
+            return std::span{ sampleRates, count };
+#endif
+        }
+
+        std::span<const ::AVSampleFormat> getSupportedSampleFormats(const ::AVCodec* encoder)
+        {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+            const void* configs{};
+            int count{};
+            if (::avcodec_get_supported_config(nullptr, encoder, AV_CODEC_CONFIG_SAMPLE_FORMAT, 0, &configs, &count) < 0 || !configs)
+                return {};
+
+            return std::span{ static_cast<const ::AVSampleFormat*>(configs), static_cast<std::size_t>(count) };
+#else
+            const ::AVSampleFormat* sampleFormats{ encoder->sample_fmts };
+            if (!sampleFormats)
+                return {};
+
+            std::size_t count{};
+            while (sampleFormats[count] != AV_SAMPLE_FMT_NONE)
+                ++count;
+
+            return std::span{ sampleFormats, count };
+#endif
+        }
+
+        // Same as ffmpeg: use the requested rate if supported, otherwise the closest higher one, or the highest one
+        int selectSampleRate(const ::AVCodec* encoder, int requestedSampleRate)
+        {
+            const std::span<const int> supportedSampleRates{ getSupportedSampleRates(encoder) };
+            if (supportedSampleRates.empty())
+                return requestedSampleRate;
+
+            std::optional<int> bestSampleRate;
+            for (const int sampleRate : supportedSampleRates)
+            {
+                if (sampleRate == requestedSampleRate)
+                    return sampleRate;
+
+                if (!bestSampleRate
+                    || (sampleRate > requestedSampleRate && (*bestSampleRate < requestedSampleRate || sampleRate < *bestSampleRate))
+                    || (sampleRate < requestedSampleRate && *bestSampleRate < requestedSampleRate && sampleRate > *bestSampleRate))
+                {
+                    bestSampleRate = sampleRate;
+                }
+            }
+
+            return *bestSampleRate;
+        }
+
+        ::AVSampleFormat selectSampleFormat(const ::AVCodec* encoder, std::optional<unsigned> bitsPerSample, ::AVSampleFormat inputSampleFormat)
+        {
+            const std::span<const ::AVSampleFormat> supportedSampleFormats{ getSupportedSampleFormats(encoder) };
+            if (supportedSampleFormats.empty())
+                return inputSampleFormat;
+
+            auto findSupportedFormat{ [&](::AVSampleFormat sampleFormat) -> std::optional<::AVSampleFormat> {
+                for (const ::AVSampleFormat candidate : { ::av_get_packed_sample_fmt(sampleFormat), ::av_get_planar_sample_fmt(sampleFormat) })
+                {
+                    if (std::find(std::cbegin(supportedSampleFormats), std::cend(supportedSampleFormats), candidate) != std::cend(supportedSampleFormats))
+                        return candidate;
+                }
+                return std::nullopt;
+            } };
+
+            std::optional<::AVSampleFormat> sampleFormat;
+            if (bitsPerSample == 16)
+                sampleFormat = findSupportedFormat(AV_SAMPLE_FMT_S16);
+            else if (bitsPerSample == 32)
+                sampleFormat = findSupportedFormat(AV_SAMPLE_FMT_S32);
+
+            if (!sampleFormat)
+                sampleFormat = findSupportedFormat(inputSampleFormat);
+
+            return sampleFormat ? *sampleFormat : supportedSampleFormats.front();
+        }
+    } // namespace
+
+    std::atomic<std::size_t> InProcessTranscoder::_nextDebugId;
+
+    InProcessTranscoder::InProcessTranscoder(boost::asio::io_context& ioContext, const TranscodeParameters& parameters)
+        : _debugId{ _nextDebugId++ }
+        , _ioContext{ ioContext }
+        , _inputParams{ parameters.inputParameters }
+        , _outputParams{ parameters.outputParameters }
+    {
+        if (!_outputParams.format)
+            throw Exception{ "Output format must be set" };
+
+        try
+        {
+            if (!std::filesystem::exists(_inputParams.filePath))
+                throw Exception{ "File " + _inputParams.filePath.string() + " does not exist!" };
+            if (!std::filesystem::is_regular_file(_inputParams.filePath))
+                throw Exception{ "File " + _inputParams.filePath.string() + " is not regular!" };
+        }
+        catch (const std::filesystem::filesystem_error& e)
+        {
+            throw IOFileException{ _inputParams.filePath, "Failed to check if file exists", e.code() };
+        }
+
+        LOG(INFO, "Transcoding file " << _inputParams.filePath << " (in process)");
+
+        utils::init();
+
+        openInput();
+        openDecoder();
+        openEncoder();
+        openResampler();
+        openOutput();
+    }
+
+    InProcessTranscoder::~InProcessTranscoder()
+    {
+        // wait for the read in progress, if any
+        const std::scoped_lock lock{ _asyncReadState->mutex };
+        _asyncReadState->destroyed = true;
+    }
+
+    void InProcessTranscoder::openInput()
+    {
+        {
+            ::AVFormatContext* context{};
+            const int error{ ::avformat_open_input(&context, _inputParams.filePath.c_str(), nullptr, nullptr) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot open '" + _inputParams.filePath.string() + "'", error };
+            _inputContext = AVFormatContextPtr{ context };
+        }
+
+        {
+            const int error{ ::avformat_find_stream_info(_inputContext.get(), nullptr) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot find stream information in '" + _inputParams.filePath.string() + "'", error };
+        }
+
+        _inputStreamIndex = ::av_find_best_stream(_inputContext.get(), AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if (_inputStreamIndex < 0)
+            throw FFmpegException{ "Cannot find best audio stream in '" + _inputParams.filePath.string() + "'", _inputStreamIndex };
+
+        // Skip other streams (including covers!)
+        for (unsigned i{}; i < _inputContext->nb_streams; ++i)
+        {
+            if (static_cast<int>(i) != _inputStreamIndex)
+                _inputContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+
+        if (_inputParams.offset.count() > 0)
+        {
+            const ::AVStream* stream{ _inputContext->streams[_inputStreamIndex] };
+
+            using OffsetPeriod = std::chrono::milliseconds::period;
+            constexpr ::AVRational offsetTimebase{ static_cast<int>(OffsetPeriod::num), static_cast<int>(OffsetPeriod::den) };
+
+            const std::int64_t targetTimestamp{ ::av_rescale_q(_inputParams.offset.count(), offsetTimebase, stream->time_base) };
+            const int error{ ::av_seek_frame(_inputContext.get(), _inputStreamIndex, targetTimestamp, AVSEEK_FLAG_BACKWARD) };
+            if (error < 0)
+                LOG(WARNING, "Failed to seek to offset: " << utils::averrorToString(error));
+            else
+                _seekTimestamp = targetTimestamp; // landed on the previous key frame
+        }
+
+        _inputPacket = AVPacketPtr{ ::av_packet_alloc() };
+        if (!_inputPacket)
+            throw Exception{ "Cannot allocate input packet" };
+    }
+
+    void InProcessTranscoder::openDecoder()
+    {
+        const ::AVCodecParameters* codecParameters{ _inputContext->streams[_inputStreamIndex]->codecpar };
+
+        const ::AVCodec* decoder{ ::avcodec_find_decoder(codecParameters->codec_id) };
+        if (!decoder)
+            throw Exception{ "Cannot find decoder" };
+
+        _decoderContext = AVCodecContextPtr{ ::avcodec_alloc_context3(decoder) };
+        if (!_decoderContext)
+            throw Exception{ "Cannot allocate decoder context" };
+
+        {
+            const int error{ ::avcodec_parameters_to_context(_decoderContext.get(), codecParameters) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot init decoder parameters", error };
+        }
+
+        {
+            const int error{ ::avcodec_open2(_decoderContext.get(), decoder, nullptr) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot open decoder", error };
+        }
+
+        _decodedFrame = AVFramePtr{ ::av_frame_alloc() };
+        if (!_decodedFrame)
+            throw Exception{ "Cannot allocate decoded frame" };
+    }
+
+    void InProcessTranscoder::openEncoder()
+    {
+        const char* encoderName{ getEncoderName(_outputParams.format->codec) };
+        const ::AVCodec* encoder{ ::avcodec_find_encoder_by_name(encoderName) };
+        if (!encoder)
+            throw Exception{ "Cannot find encoder '" + std::string{ encoderName } + "'" };
+
+        _encoderContext = AVCodecContextPtr{ ::avcodec_alloc_context3(encoder) };
+        if (!_encoderContext)
+            throw Exception{ "Cannot allocate encoder context" };
+
+        // Same defaults as the child process backend: keep the input properties unless specified
+        const int channelCount{ _outputParams.channelCount ? static_cast<int>(*_outputParams.channelCount) : _decoderContext->ch_layout.nb_channels };
+        ::av_channel_layout_default(&_encoderContext->ch_layout, channelCount);
+        _encoderContext->sample_rate = selectSampleRate(encoder, _outputParams.sampleRate ? static_cast<int>(*_outputParams.sampleRate) : _decoderContext->sample_rate);
+        _encoderContext->sample_fmt = selectSampleFormat(encoder, _outputParams.bitsPerSample, _decoderContext->sample_fmt);
+        _encoderContext->time_base = ::AVRational{ 1, _encoderContext->sample_rate };
+        if (_outputParams.bitrate)
+            _encoderContext->bit_rate = *_outputParams.bitrate;
+        if (!_outputParams.bitsPerSample && _decoderContext->bits_per_raw_sample > 0)
+            _encoderContext->bits_per_raw_sample = std::min(_decoderContext->bits_per_raw_sample, ::av_get_bytes_per_sample(_encoderContext->sample_fmt) * 8);
+
+        if (const ::AVOutputFormat* outputFormat{ ::av_guess_format(getMuxerName(_outputParams.format->container), nullptr, nullptr) }; outputFormat && (outputFormat->flags & AVFMT_GLOBALHEADER))
+            _encoderContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+        {
+            const int error{ ::avcodec_open2(_encoderContext.get(), encoder, nullptr) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot open encoder '" + std::string{ encoderName } + "'", error };
+        }
+
+        _encoderFrameSize = (encoder->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE) || _encoderContext->frame_size <= 0 ? defaultEncoderFrameSize : _encoderContext->frame_size;
+
+        _encoderFrame = AVFramePtr{ ::av_frame_alloc() };
+        if (!_encoderFrame)
+            throw Exception{ "Cannot allocate encoder frame" };
+
+        _encoderFrame->format = _encoderContext->sample_fmt;
+        _encoderFrame->sample_rate = _encoderContext->sample_rate;
+        _encoderFrame->nb_samples = _encoderFrameSize;
+        if (const int error{ ::av_channel_layout_copy(&_encoderFrame->ch_layout, &_encoderContext->ch_layout) }; error < 0)
+            throw FFmpegException{ "Cannot copy channel layout", error };
+        if (const int error{ ::av_frame_get_buffer(_encoderFrame.get(), 0) }; error < 0)
+            throw FFmpegException{ "Cannot allocate encoder frame buffer", error };
+
+        _outputPacket = AVPacketPtr{ ::av_packet_alloc() };
+        if (!_outputPacket)
+            throw Exception{ "Cannot allocate output packet" };
+
+        LOG(DEBUG, "Encoder '" << encoderName << "': sample rate = " << _encoderContext->sample_rate << ", channels = " << channelCount << ", sample format = " << ::av_get_sample_fmt_name(_encoderContext->sample_fmt) << ", frame size = " << _encoderFrameSize);
+    }
+
+    void InProcessTranscoder::openResampler()
+    {
+        {
+            ::SwrContext* context{};
+            const int error{ ::swr_alloc_set_opts2(
+                &context,                       // existing context
+                &_encoderContext->ch_layout,    // out layout
+                _encoderContext->sample_fmt,    // out format
+                _encoderContext->sample_rate,   // out rate
+                &_decoderContext->ch_layout,    // in layout
+                _decoderContext->sample_fmt,    // in format
+                _decoderContext->sample_rate,   // in rate
+                0,                              // log offset
+                nullptr) };
+
+            if (error < 0 || !context)
+                throw FFmpegException{ "Cannot allocate resampler context", error };
+
+            _resampleContext = SwrContextPtr{ context };
+        }
+
+        {
+            const int error{ ::swr_init(_resampleContext.get()) };
+            if (error < 0)
+                throw FFmpegException{ "Cannot initialize resampler", error };
+        }
+
+        _resampledFrame = AVFramePtr{ ::av_frame_alloc() };
+        if (!_resampledFrame)
+            throw Exception{ "Cannot allocate resampled frame" };
+
+        _fifo = AVAudioFifoPtr{ ::av_audio_fifo_alloc(_encoderContext->sample_fmt, _encoderContext->ch_layout.nb_channels, _encoderFrameSize) };
+        if (!_fifo)
+            throw Exception{ "Cannot allocate audio fifo" };
+    }
+
+    void InProcessTranscoder::openOutput()
+    {
+        {
+            ::AVFormatContext* context{};
+            const int error{ ::avformat_alloc_output_context2(&context, nullptr, getMuxerName(_outputParams.format->container), nullptr) };
+            if (error < 0 || !context)
+                throw FFmpegException{ "Cannot allocate output context", error };
+            _outputContext = AVOutputFormatContextPtr{ context };
+        }
+
+        {
+            auto* buffer{ static_cast<unsigned char*>(::av_malloc(outputIOBufferSize)) };
+            if (!buffer)
+                throw Exception{ "Cannot allocate output buffer" };
+
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+            auto writePacket{ &InProcessTranscoder::writeOutputPacket };
+#else
+            auto writePacket{ [](void* opaque, std::uint8_t* data, int size) { return InProcessTranscoder::writeOutputPacket(opaque, data, size); } };
+#endif
+            _ioContext = AVIOContextPtr{ ::avio_alloc_context(buffer, outputIOBufferSize, 1 /* write */, this, nullptr, writePacket, nullptr) };
+            if (!_ioContext)
+            {
+                ::av_free(buffer);
+                throw Exception{ "Cannot allocate output IO context" };
+            }
+        }
+
+        _outputContext->pb = _ioContext.get();
+        _outputContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+        _outputStream = ::avformat_new_stream(_outputContext.get(), nullptr);
+        if (!_outputStream)
+            throw Exception{ "Cannot create output stream" };
+
+        _outputStream->time_base = _encoderContext->time_base;
+        if (const int error{ ::avcodec_parameters_from_context(_outputStream->codecpar, _encoderContext.get()) }; error < 0)
+            throw FFmpegException{ "Cannot init output stream parameters", error };
+
+        if (!_outputParams.stripMetadata)
+        {
+            ::av_dict_copy(&_outputContext->metadata, _inputContext->metadata, 0);
+            ::av_dict_copy(&_outputStream->metadata, _inputContext->streams[_inputStreamIndex]->metadata, 0);
+        }
+
+        // Written in the pending output
+        if (const int error{ ::avformat_write_header(_outputContext.get(), nullptr) }; error < 0)
+            throw FFmpegException{ "Cannot write output header", error };
+    }
+
+    void InProcessTranscoder::asyncRead(std::byte* buffer, std::size_t bufferSize, ReadCallback callback)
+    {
+        // keep libav off the thread of the caller, that may serve other requests
+        boost::asio::post(_ioContext, [this, asyncReadState = _asyncReadState, buffer, bufferSize, callback = std::move(callback)] {
+            const std::scoped_lock lock{ asyncReadState->mutex };
+
+            // forbidden to use any captured param here as the reader has gone
+            if (asyncReadState->destroyed)
+                return;
+
+            callback(readSome(buffer, bufferSize));
+        });
+    }
+
+    std::size_t InProcessTranscoder::readSome(std::byte* buffer, std::size_t bufferSize)
+    {
+        const std::size_t pendingByteCount{ consumePendingOutput(std::span{ buffer, bufferSize }) };
+
+        _readBuffer = std::span{ buffer + pendingByteCount, bufferSize - pendingByteCount };
+        _readByteCount = pendingByteCount;
+
+        try
+        {
+            // The first read returns as soon as possible to reduce the time to first byte, next ones fill the buffer
+            while (!_outputFinished && !_readBuffer.empty() && (_firstReadDone || _readByteCount == 0))
+            {
+                processInput();
+                ::avio_flush(_ioContext.get());
+            }
+        }
+        catch (const Exception& e)
+        {
+            LOG(ERROR, "Transcode failed: " << e.what());
+            _outputFinished = true;
+            _failed = true;
+        }
+
+        _firstReadDone = true;
+        _readBuffer = {};
+
+        return _readByteCount;
+    }
+
+    std::string_view InProcessTranscoder::getOutputMimeType() const
+    {
+        return core::media::getMimeType(_outputParams.format->container, _outputParams.format->codec).str();
+    }
+
+    bool InProcessTranscoder::finished() const
+    {
+        return _outputFinished && _pendingOutputOffset == _pendingOutput.size();
+    }
+
+    bool InProcessTranscoder::failed() const
+    {
+        return _failed;
+    }
+
+    void InProcessTranscoder::processInput()
+    {
+        if (!_inputEof)
+        {
+            const int readError{ ::av_read_frame(_inputContext.get(), _inputPacket.get()) };
+            if (readError == AVERROR_EOF)
+            {
+                _inputEof = true;
+                // flush decoder
+                ::avcodec_send_packet(_decoderContext.get(), nullptr);
+            }
+            else if (readError < 0)
+            {
+                throw FFmpegException{ "av_read_frame failed", readError };
+            }
+            else
+            {
+                if (_inputPacket->stream_index == _inputStreamIndex)
+                {
+                    const int sendError{ ::avcodec_send_packet(_decoderContext.get(), _inputPacket.get()) };
+                    if (sendError == AVERROR_INVALIDDATA)
+                        LOG(DEBUG, "Skipping invalid packet");
+                    else if (sendError < 0)
+                        throw FFmpegException{ "avcodec_send_packet failed", sendError };
+                }
+                ::av_packet_unref(_inputPacket.get());
+            }
+        }
+
+        receiveDecodedFrames();
+        encodeFifo(_decoderFlushed);
+
+        if (_decoderFlushed)
+        {
+            // flush encoder
+            encodeFrame(nullptr);
+
+            if (const int error{ ::av_write_trailer(_outputContext.get()) }; error < 0)
+                throw FFmpegException{ "Cannot write output trailer", error };
+
+            _outputFinished = true;
+            LOG(DEBUG, "Transcode done");
+        }
+    }
+
+    void InProcessTranscoder::receiveDecodedFrames()
+    {
+        while (true)
+        {
+            const int error{ ::avcodec_receive_frame(_decoderContext.get(), _decodedFrame.get()) };
+            if (error == AVERROR(EAGAIN))
+                return;
+
+            if (error == AVERROR_EOF)
+            {
+                resampleToFifo(nullptr);
+                _decoderFlushed = true;
+                return;
+            }
+
+            if (error < 0)
+                throw FFmpegException{ "avcodec_receive_frame failed", error };
+
+            const int skippedSampleCount{ computeSkippedSampleCount(*_decodedFrame) };
+            if (skippedSampleCount < _decodedFrame->nb_samples)
+                resampleToFifo(_decodedFrame.get(), skippedSampleCount);
+            ::av_frame_unref(_decodedFrame.get());
+        }
+    }
+
+    int InProcessTranscoder::computeSkippedSampleCount(const ::AVFrame& frame)
+    {
+        if (!_seekTimestamp)
+            return 0;
+
+        const std::int64_t timestamp{ frame.best_effort_timestamp };
+        if (timestamp == AV_NOPTS_VALUE)
+        {
+            LOG(DEBUG, "Cannot trim decoded frames to the requested offset: no timestamp");
+            _seekTimestamp.reset();
+            return 0;
+        }
+
+        const ::AVRational sampleTimebase{ 1, _decoderContext->sample_rate };
+        const std::int64_t skippedSampleCount{ ::av_rescale_q(*_seekTimestamp - timestamp, _inputContext->streams[_inputStreamIndex]->time_base, sampleTimebase) };
+        if (skippedSampleCount < frame.nb_samples)
+            _seekTimestamp.reset(); // reached the requested offset
+
+        return static_cast<int>(std::clamp<std::int64_t>(skippedSampleCount, 0, frame.nb_samples));
+    }
+
+    void InProcessTranscoder::resampleToFifo(const ::AVFrame* frame, int skippedSampleCount)
+    {
+        const int inputSampleCount{ frame ? frame->nb_samples - skippedSampleCount : 0 };
+        const int maxOutputSampleCount{ ::swr_get_out_samples(_resampleContext.get(), inputSampleCount) };
+        if (maxOutputSampleCount < 0)
+            throw FFmpegException{ "swr_get_out_samples failed", maxOutputSampleCount };
+        if (maxOutputSampleCount == 0)
+            return;
+
+        if (maxOutputSampleCount > _resampledFrameCapacity)
+        {
+            ::av_frame_unref(_resampledFrame.get());
+            _resampledFrame->format = _encoderContext->sample_fmt;
+            _resampledFrame->sample_rate = _encoderContext->sample_rate;
+            _resampledFrame->nb_samples = maxOutputSampleCount;
+            if (const int error{ ::av_channel_layout_copy(&_resampledFrame->ch_layout, &_encoderContext->ch_layout) }; error < 0)
+                throw FFmpegException{ "Cannot copy channel layout", error };
+            if (const int error{ ::av_frame_get_buffer(_resampledFrame.get(), 0) }; error < 0)
+                throw FFmpegException{ "Cannot allocate resampled frame buffer", error };
+
+            _resampledFrameCapacity = maxOutputSampleCount;
+        }
+
+        // only the first frame after a seek is partially skipped
+        std::vector<const std::uint8_t*> skippedInputData;
+        if (frame && skippedSampleCount > 0)
+        {
+            const auto sampleFormat{ static_cast<::AVSampleFormat>(frame->format) };
+            const bool planar{ ::av_sample_fmt_is_planar(sampleFormat) != 0 };
+            const int planeCount{ planar ? frame->ch_layout.nb_channels : 1 };
+            const int skippedByteCount{ skippedSampleCount * ::av_get_bytes_per_sample(sampleFormat) * (planar ? 1 : frame->ch_layout.nb_channels) };
+
+            for (int plane{}; plane < planeCount; ++plane)
+                skippedInputData.push_back(frame->extended_data[plane] + skippedByteCount);
+        }
+
+        const std::uint8_t** inputData{};
+        if (!skippedInputData.empty())
+            inputData = skippedInputData.data();
+        else if (frame)
+            inputData = const_cast<const std::uint8_t**>(frame->extended_data);
+        const int outputSampleCount{ ::swr_convert(_resampleContext.get(),
+                                                   _resampledFrame->extended_data,
+                                                   _resampledFrameCapacity,
+                                                   inputData,
+                                                   inputSampleCount) };
+        if (outputSampleCount < 0)
+            throw FFmpegException{ "swr_convert failed", outputSampleCount };
+
+        if (outputSampleCount > 0)
+        {
+            if (const int error{ ::av_audio_fifo_write(_fifo.get(), reinterpret_cast<void**>(_resampledFrame->extended_data), outputSampleCount) }; error < outputSampleCount)
+                throw FFmpegException{ "av_audio_fifo_write failed", error < 0 ? error : AVERROR(ENOMEM) };
+        }
+    }
+
+    void InProcessTranscoder::encodeFifo(bool flush)
+    {
+        // Each frame must contain exactly frame_size samples, except the last one
+        while (::av_audio_fifo_size(_fifo.get()) >= _encoderFrameSize || (flush && ::av_audio_fifo_size(_fifo.get()) > 0))
+        {
+            // The encoder may still reference the previous frame data
+            _encoderFrame->nb_samples = _encoderFrameSize;
+            if (const int error{ ::av_frame_make_writable(_encoderFrame.get()) }; error < 0)
+                throw FFmpegException{ "Cannot make encoder frame writable", error };
+
+            const int sampleCount{ ::av_audio_fifo_read(_fifo.get(), reinterpret_cast<void**>(_encoderFrame->extended_data), _encoderFrameSize) };
+            if (sampleCount < 0)
+                throw FFmpegException{ "av_audio_fifo_read failed", sampleCount };
+
+            _encoderFrame->nb_samples = sampleCount;
+            _encoderFrame->pts = _nextPts;
+            _nextPts += sampleCount;
+
+            encodeFrame(_encoderFrame.get());
+        }
+    }
+
+    void InProcessTranscoder::encodeFrame(const ::AVFrame* frame)
+    {
+        if (const int error{ ::avcodec_send_frame(_encoderContext.get(), frame) }; error < 0)
+            throw FFmpegException{ "avcodec_send_frame failed", error };
+
+        while (true)
+        {
+            const int error{ ::avcodec_receive_packet(_encoderContext.get(), _outputPacket.get()) };
+            if (error == AVERROR(EAGAIN) || error == AVERROR_EOF)
+                return;
+            if (error < 0)
+                throw FFmpegException{ "avcodec_receive_packet failed", error };
+
+            ::av_packet_rescale_ts(_outputPacket.get(), _encoderContext->time_base, _outputStream->time_base);
+            _outputPacket->stream_index = _outputStream->index;
+
+            // single stream: no need to interleave
+            const int writeError{ ::av_write_frame(_outputContext.get(), _outputPacket.get()) };
+            ::av_packet_unref(_outputPacket.get());
+            if (writeError < 0)
+                throw FFmpegException{ "av_write_frame failed", writeError };
+        }
+    }
+
+    std::size_t InProcessTranscoder::consumePendingOutput(std::span<std::byte> buffer)
+    {
+        const std::size_t byteCount{ std::min(buffer.size(), _pendingOutput.size() - _pendingOutputOffset) };
+        std::copy_n(std::cbegin(_pendingOutput) + _pendingOutputOffset, byteCount, std::begin(buffer));
+        _pendingOutputOffset += byteCount;
+
+        if (_pendingOutputOffset == _pendingOutput.size())
+        {
+            _pendingOutput.clear();
+            _pendingOutputOffset = 0;
+        }
+
+        return byteCount;
+    }
+
+    void InProcessTranscoder::onOutput(std::span<const std::byte> data)
+    {
+        const std::size_t directByteCount{ std::min(data.size(), _readBuffer.size()) };
+        std::copy_n(std::cbegin(data), directByteCount, std::begin(_readBuffer));
+        _readBuffer = _readBuffer.subspan(directByteCount);
+        _readByteCount += directByteCount;
+
+        _pendingOutput.insert(std::cend(_pendingOutput), std::cbegin(data) + directByteCount, std::cend(data));
+    }
+
+    int InProcessTranscoder::writeOutputPacket(void* opaque, const std::uint8_t* data, int size)
+    {
+        static_cast<InProcessTranscoder*>(opaque)->onOutput(std::span{ reinterpret_cast<const std::byte*>(data), static_cast<std::size_t>(size) });
+        return size;
+    }
+} // namespace lms::audio::ffmpeg
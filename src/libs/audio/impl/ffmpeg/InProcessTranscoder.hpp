@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#include "audio/ITranscoder.hpp"
+
+#include "FFmpegTypes.hpp"
+
+extern "C"
+{
+    struct AVStream;
+}
+
+namespace lms::audio::ffmpeg
+{
+    // Transcodes using libav, in the thread of the reader for sync reads, in the io context for async reads
+    // Encoded data is directly written into the reader's buffer, only the overflow is kept for the next read
+    class InProcessTranscoder : public ITranscoder
+    {
+    public:
+        InProcessTranscoder(boost::asio::io_context& ioContext, const TranscodeParameters& parameters);
+        ~InProcessTranscoder() override;
+        InProcessTranscoder(const InProcessTranscoder&) = delete;
+        InProcessTranscoder& operator=(const InProcessTranscoder&) = delete;
+
+    private:
+        // callback is called from the io context
+        void asyncRead(std::byte* buffer, std::size_t bufferSize, ReadCallback) override;
+        std::size_t readSome(std::byte* buffer, std::size_t bufferSize) override;
+
+        std::string_view getOutputMimeType() const override;
+        const TranscodeOutputParameters& getOutputParameters() const override { return _outputParams; }
+
+        bool finished() const override;
+        bool failed() const override;
+
+        void openInput();
+        void openDecoder();
+        void openEncoder();
+        void openOutput();
+        void openResampler();
+
+        void processInput();
+        void receiveDecodedFrames();
+        int computeSkippedSampleCount(const ::AVFrame& frame);
+        void resampleToFifo(const ::AVFrame* frame, int skippedSampleCount = 0);
+        void encodeFifo(bool flush);
+        void encodeFrame(const ::AVFrame* frame);
+
+        std::size_t consumePendingOutput(std::span<std::byte> buffer);
+        void onOutput(std::span<const std::byte> data);
+        static int writeOutputPacket(void* opaque, const std::uint8_t* data, int size);
+
+        static std::atomic<std::size_t> _nextDebugId;
+        const std::size_t _debugId;
+        boost::asio::io_context& _ioContext;
+
+        // Shared with the posted reads, that may run after the destruction of the transcoder
+        struct AsyncReadState
+        {
+            std::mutex mutex; // held during the read and the callback
+            bool destroyed{};
+        };
+        const std::shared_ptr<AsyncReadState> _asyncReadState{ std::make_shared<AsyncReadState>() };
+
+        const TranscodeInputParameters _inputParams;
+        const TranscodeOutputParameters _outputParams;
+
+        // Input
+        AVFormatContextPtr _inputContext;
+        int _inputStreamIndex{};
+        AVCodecContextPtr _decoderContext;
+        AVPacketPtr _inputPacket;
+        AVFramePtr _decodedFrame;
+        std::optional<std::int64_t> _seekTimestamp; // decoded samples before this timestamp (in the stream time base) are dropped
+        bool _inputEof{};
+        bool _decoderFlushed{};
+
+        // Resampling, the fifo is used to feed the encoder with frames of the expected size
+        SwrContextPtr _resampleContext;
+        AVFramePtr _resampledFrame;
+        int _resampledFrameCapacity{};
+        AVAudioFifoPtr _fifo;
+
+        // Output
+        AVCodecContextPtr _encoderContext;
+        AVFramePtr _encoderFrame;
+        int _encoderFrameSize{};
+        std::int64_t _nextPts{};
+        AVPacketPtr _outputPacket;
+        AVIOContextPtr _ioContext;
+        AVOutputFormatContextPtr _outputContext;
+        ::AVStream* _outputStream{};
+        bool _outputFinished{};
+        bool _failed{}; // the output is truncated
+
+        std::span<std::byte> _readBuffer; // remaining space in the buffer of the current read
+        std::size_t _readByteCount{};
+        bool _firstReadDone{};
+        std::vector<std::byte> _pendingOutput; // output that did not fit in the reader's buffer
+        std::size_t _pendingOutputOffset{};
+    };
+} // namespace lms::audio::ffmpeg
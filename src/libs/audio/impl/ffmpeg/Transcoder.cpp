@@ -31,14 +31,6 @@
 #include "audio/Exception.hpp"
 #include "audio/TranscodeTypes.hpp"
 
-namespace lms::audio
-{
-    std::unique_ptr<ITranscoder> createTranscoder(const TranscodeParameters& parameters)
-    {
-        return std::make_unique<ffmpeg::Transcoder>(parameters);
-    }
-} // namespace lms::audio
-
 namespace lms::audio::ffmpeg
 {
 #define LOG(severity, message) LMS_LOG(TRANSCODING, severity, "[" << _debugId << "] - " << message)
@@ -251,4 +243,12 @@ namespace lms::audio::ffmpeg
 
         return _childProcess->finished();
     }
+
+    bool Transcoder::failed() const
+    {
+        assert(_childProcess);
+        assert(_childProcess->finished());
+
+        return _childProcess->getExitCode() != 0;
+    }
 } // namespace lms::audio::ffmpeg
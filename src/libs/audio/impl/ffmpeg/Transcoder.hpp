@@ -46,6 +46,7 @@ namespace lms::audio::ffmpeg
         const TranscodeOutputParameters& getOutputParameters() const override { return _outputParams; }
 
         bool finished() const override;
+        bool failed() const override;
         static void init();
         void start();
 
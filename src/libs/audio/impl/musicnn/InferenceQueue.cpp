@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InferenceQueue.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <iterator>
+
+#include "audio/Exception.hpp"
+
+namespace lms::audio::musicnn
+{
+    InferenceQueue::Submitter::Submitter(InferenceQueue& queue)
+        : _queue{ queue }
+    {
+        std::scoped_lock lock{ _queue._mutex };
+        _queue._submitterCount += 1;
+    }
+
+    InferenceQueue::Submitter::~Submitter()
+    {
+        {
+            std::scoped_lock lock{ _queue._mutex };
+            _queue._submitterCount -= 1;
+        }
+
+        // the pending patches may no longer be worth waiting for
+        _queue._cond.notify_all();
+    }
+
+    InferenceQueue::InferenceQueue(std::size_t inputSize, std::size_t outputSize, std::size_t maxBatchSize, std::chrono::milliseconds maxGatherDelay, BatchRunner batchRunner)
+        : _inputSize{ inputSize }
+        , _outputSize{ outputSize }
+        , _maxBatchSize{ maxBatchSize }
+        , _maxGatherDelay{ maxGatherDelay }
+        , _batchRunner{ std::move(batchRunner) }
+    {
+        if (_inputSize == 0 || _outputSize == 0 || _maxBatchSize == 0)
+            throw audio::Exception{ "Inference queue: input size, output size and max batch size must be > 0" };
+    }
+
+    InferenceQueue::~InferenceQueue()
+    {
+        assert(_requests.empty());
+        assert(_submitterCount == 0);
+    }
+
+    void InferenceQueue::process(std::span<const float> inputs, std::span<float> outputs)
+    {
+        assert(inputs.size() % _inputSize == 0);
+        const std::size_t patchCount{ inputs.size() / _inputSize };
+        assert(outputs.size() == patchCount * _outputSize);
+
+        if (patchCount == 0)
+            return;
+
+        // only accessed with the mutex locked, the spans are written by the batches
+        Request request{ .submitTime = clock::now(), .inputs = inputs, .outputs = outputs, .patchCount = patchCount, .nextPatchIndex = 0, .pendingPatchCount = patchCount, .failed = false, .errorMessage = {} };
+
+        std::vector<BatchPart> batchParts;
+        std::vector<float> batchInputs;
+        std::vector<float> batchOutputs;
+        std::string errorMessage;
+
+        std::unique_lock lock{ _mutex };
+        _requests.push_back(&request);
+        _untakenPatchCount += patchCount;
+        _processingCount += 1;
+        _cond.notify_all(); // may complete a batch other threads are gathering
+
+        while (request.pendingPatchCount > 0)
+        {
+            if (_requests.empty())
+            {
+                // the remaining patches are being computed by other threads
+                _cond.wait(lock);
+                continue;
+            }
+
+            if (shouldGatherMorePatches())
+            {
+                _cond.wait_until(lock, _requests.front()->submitTime + _maxGatherDelay);
+                continue;
+            }
+
+            takeBatch(batchParts);
+
+            lock.unlock();
+            const bool success{ runBatch(batchParts, batchInputs, batchOutputs, errorMessage) };
+            lock.lock();
+
+            for (const BatchPart& part : batchParts)
+            {
+                part.request->pendingPatchCount -= part.patchCount;
+                if (!success)
+                {
+                    part.request->failed = true;
+                    part.request->errorMessage = errorMessage;
+                }
+            }
+            _cond.notify_all();
+        }
+
+        _processingCount -= 1;
+
+        if (request.failed)
+            throw audio::Exception{ request.errorMessage };
+    }
+
+    bool InferenceQueue::shouldGatherMorePatches() const
+    {
+        // some submitters have not sent their patches yet, they may fill the batch
+        return _untakenPatchCount < _maxBatchSize
+               && _submitterCount > _processingCount
+               && clock::now() < _requests.front()->submitTime + _maxGatherDelay;
+    }
+
+    void InferenceQueue::takeBatch(std::vector<BatchPart>& batchParts)
+    {
+        batchParts.clear();
+
+        std::size_t batchPatchCount{};
+        while (!_requests.empty() && batchPatchCount < _maxBatchSize)
+        {
+            Request& request{ *_requests.front() };
+
+            const std::size_t patchCount{ std::min(request.patchCount - request.nextPatchIndex, _maxBatchSize - batchPatchCount) };
+            batchParts.push_back(BatchPart{ .request = &request, .firstPatchIndex = request.nextPatchIndex, .patchCount = patchCount });
+            request.nextPatchIndex += patchCount;
+            batchPatchCount += patchCount;
+            _untakenPatchCount -= patchCount;
+
+            if (request.nextPatchIndex == request.patchCount)
+                _requests.pop_front();
+        }
+    }
+
+    bool InferenceQueue::runBatch(std::span<const BatchPart> batchParts, std::vector<float>& batchInputs, std::vector<float>& batchOutputs, std::string& errorMessage) const
+    {
+        try
+        {
+            // no need to gather the patches of a single request
+            if (batchParts.size() == 1)
+            {
+                const BatchPart& part{ batchParts.front() };
+                _batchRunner(part.request->inputs.subspan(part.firstPatchIndex * _inputSize, part.patchCount * _inputSize),
+                             part.request->outputs.subspan(part.firstPatchIndex * _outputSize, part.patchCount * _outputSize));
+                return true;
+            }
+
+            batchInputs.clear();
+            for (const BatchPart& part : batchParts)
+            {
+                const auto inputs{ part.request->inputs.subspan(part.firstPatchIndex * _inputSize, part.patchCount * _inputSize) };
+                batchInputs.insert(std::cend(batchInputs), std::cbegin(inputs), std::cend(inputs));
+            }
+
+            batchOutputs.resize(batchInputs.size() / _inputSize * _outputSize);
+            _batchRunner(batchInputs, batchOutputs);
+
+            std::size_t batchOutputOffset{};
+            for (const BatchPart& part : batchParts)
+            {
+                const auto outputs{ part.request->outputs.subspan(part.firstPatchIndex * _outputSize, part.patchCount * _outputSize) };
+                std::copy_n(std::next(std::cbegin(batchOutputs), static_cast<std::ptrdiff_t>(batchOutputOffset)), outputs.size(), std::begin(outputs));
+                batchOutputOffset += outputs.size();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            // reported to the owner of each patch of the batch
+            errorMessage = e.what();
+            return false;
+        }
+
+        return true;
+    }
+} // namespace lms::audio::musicnn
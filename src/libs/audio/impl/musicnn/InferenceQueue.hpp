@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lms::audio::musicnn
+{
+    // Gathers the patches submitted by concurrent extractions into shared inference batches
+    // There is no dedicated inference thread: the submitting threads run the pending batches, from any extraction, while waiting for their own results
+    // A batch that is not full is delayed (up to maxGatherDelay) as long as some registered submitters may still add their patches to it
+    class InferenceQueue
+    {
+    public:
+        // Inputs and outputs of several patches, laid out one after another
+        using BatchRunner = std::function<void(std::span<const float> inputs, std::span<float> outputs)>;
+
+        InferenceQueue(std::size_t inputSize, std::size_t outputSize, std::size_t maxBatchSize, std::chrono::milliseconds maxGatherDelay, BatchRunner batchRunner);
+        ~InferenceQueue();
+        InferenceQueue(const InferenceQueue&) = delete;
+        InferenceQueue& operator=(const InferenceQueue&) = delete;
+
+        // To be held by each extraction while it computes and submits its patches: tells the queue that more patches may come
+        class Submitter
+        {
+        public:
+            Submitter(InferenceQueue& queue);
+            ~Submitter();
+            Submitter(const Submitter&) = delete;
+            Submitter& operator=(const Submitter&) = delete;
+
+        private:
+            InferenceQueue& _queue;
+        };
+
+        // Blocks until all the outputs are computed
+        // Throws audio::Exception if a batch containing some of the patches failed
+        void process(std::span<const float> inputs, std::span<float> outputs);
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct Request
+        {
+            clock::time_point submitTime;
+            std::span<const float> inputs;
+            std::span<float> outputs;
+            std::size_t patchCount{};
+            std::size_t nextPatchIndex{}; // first patch not yet taken by a batch
+            std::size_t pendingPatchCount{}; // patches not yet computed
+            bool failed{};
+            std::string errorMessage;
+        };
+
+        // Consecutive patches of a request
+        struct BatchPart
+        {
+            Request* request{};
+            std::size_t firstPatchIndex{};
+            std::size_t patchCount{};
+        };
+
+        bool shouldGatherMorePatches() const;
+        void takeBatch(std::vector<BatchPart>& batchParts);
+        bool runBatch(std::span<const BatchPart> batchParts, std::vector<float>& batchInputs, std::vector<float>& batchOutputs, std::string& errorMessage) const;
+
+        const std::size_t _inputSize;
+        const std::size_t _outputSize;
+        const std::size_t _maxBatchSize;
+        const std::chrono::milliseconds _maxGatherDelay;
+        const BatchRunner _batchRunner;
+
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        std::deque<Request*> _requests; // requests having patches not yet taken by a batch, oldest first
+        std::size_t _untakenPatchCount{}; // patches of _requests not yet taken by a batch
+        std::size_t _submitterCount{};
+        std::size_t _processingCount{}; // threads in process()
+    };
+} // namespace lms::audio::musicnn
@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cmath>
 #include <numeric>
+#include <vector>
 
 #include "audio/Exception.hpp"
 #include "audio/IMusicNNEmbeddingExtractor.hpp"
@@ -99,6 +100,7 @@ namespace lms::audio::musicnn
         : _melFilterBank{ features::computeMelFilterBank(fftSize, sampleRate, melBandCount, melFMin, melFMax) }
         , _model{ modelPath }
         , _maxPatchCount{ maxPatchCount }
+        , _inferenceQueue{ MusicNNModel::inputSize, MusicNNModel::outputSize, maxInferenceBatchSize, maxInferenceGatherDelay, [this](std::span<const float> melPatches, std::span<float> embeddings) { _model.forward(melPatches, embeddings); } }
     {
         static_assert(MusicNNEmbeddingExtractor::windowSize == MusicNNEmbeddingExtractor::fftSize);
         if (_maxPatchCount <= 0)
@@ -107,6 +109,9 @@ namespace lms::audio::musicnn
 
     IMusicNNEmbeddingExtractor::ExtractionResult MusicNNEmbeddingExtractor::extract(const std::filesystem::path& audioFile) const
     {
+        // lets the batches of the concurrent extractions wait for the patches of this one
+        const InferenceQueue::Submitter inferenceSubmitter{ _inferenceQueue };
+
         auto frameDecoder{ std::make_unique<FrameDecoder>(audioFile,
                                                           PcmParameters{ .channelCount = 1,
                                                                          .sampleRate = static_cast<unsigned>(sampleRate),
@@ -124,6 +129,23 @@ namespace lms::audio::musicnn
         const std::size_t patchGapFrameCount{ estimatedFrameCount ? computePatchGap(frameDecoder->getEstimatedFrameCount(), patchFrameCount, _maxPatchCount) : (2 * patchFrameCount) };
         const auto patchAccumulator{ std::make_unique<PatchAccumulator>() };
 
+        // meaningful patches not submitted yet, sent to the inference queue by chunks to bound memory usage
+        std::vector<float> melPatches;
+        melPatches.reserve(maxInferenceBatchSize * MusicNNModel::inputSize);
+        std::vector<float> embeddings;
+        const auto processMelPatches{ [&] {
+            embeddings.resize(melPatches.size() / MusicNNModel::inputSize * MusicNNModel::outputSize);
+            _inferenceQueue.process(melPatches, embeddings);
+
+            for (std::size_t offset{}; offset < embeddings.size(); offset += MusicNNModel::outputSize)
+            {
+                for (std::size_t d{}; d < MusicNNModel::outputSize; ++d)
+                    embeddingAccumulators[d].add(embeddings[offset + d]);
+                ++result.patchCount;
+            }
+            melPatches.clear();
+        } };
+
         while (true)
         {
             patchAccumulator->reset();
@@ -151,12 +173,14 @@ namespace lms::audio::musicnn
             if (!patchAccumulator->meaningful())
                 continue;
 
-            const auto embedding{ _model.forward(patchAccumulator->data()) };
-            for (std::size_t d{}; d < embedding.size(); ++d)
-                embeddingAccumulators[d].add(embedding[d]);
-            ++result.patchCount;
+            melPatches.insert(std::cend(melPatches), std::cbegin(patchAccumulator->data()), std::cend(patchAccumulator->data()));
+            if (melPatches.size() == maxInferenceBatchSize * MusicNNModel::inputSize)
+                processMelPatches();
         }
 
+        if (!melPatches.empty())
+            processMelPatches();
+
         if (result.patchCount > 0)
         {
             for (std::size_t d{}; d < decltype(_model)::outputSize; ++d)
@@ -19,8 +19,11 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "audio/IMusicNNEmbeddingExtractor.hpp"
 
+#include "InferenceQueue.hpp"
 #include "MusicNNModel.hpp"
 #include "features/MelFilterBank.hpp"
 #include "utils/PcmSpectralFrameDecoder.hpp"
@@ -48,6 +51,8 @@ namespace lms::audio::musicnn
         static constexpr float melFMin{ 0.F };
         static constexpr float melFMax{ 8'000.F };
         static constexpr std::size_t patchFrameCount{ MusicNNModel::inputFrames }; // 187 frames = 3 s
+        static constexpr std::size_t maxInferenceBatchSize{ 32 }; // patches, possibly from several tracks
+        static constexpr std::chrono::milliseconds maxInferenceGatherDelay{ 50 }; // to wait for the patches of the concurrent extractions
 
         class PatchAccumulator;
 
@@ -55,5 +60,6 @@ namespace lms::audio::musicnn
         const features::MelFilterBank _melFilterBank;
         const MusicNNModel _model;
         const std::size_t _maxPatchCount;
+        mutable InferenceQueue _inferenceQueue; // shared by the concurrent extractions
     };
 } // namespace lms::audio::musicnn
@@ -19,7 +19,10 @@
 
 #include "MusicNNModel.hpp"
 
+#include <cassert>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <onnxruntime_cxx_api.h>
 
@@ -29,17 +32,14 @@ namespace lms::audio::musicnn
 {
     namespace
     {
-        // Shape of the ONNX model's single input tensor: [batch=1, T=187, mel=96]
-        const std::array<std::int64_t, 3> inputShape{ 1,
-                                                      static_cast<std::int64_t>(MusicNNModel::inputFrames),
-                                                      static_cast<std::int64_t>(MusicNNModel::inputBands) };
-
-        // Shape of the ONNX model's single output tensor: [batch=1, embedding=200]
-        const std::array<std::int64_t, 2> outputShape{ 1,
-                                                       static_cast<std::int64_t>(MusicNNModel::outputSize) };
-
         constexpr const char* inputName{ "mel_patch" };
         constexpr const char* outputName{ "embedding" };
+
+        bool hasDynamicBatchDimension(const Ort::Session& session)
+        {
+            const std::vector<std::int64_t> shape{ session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape() };
+            return !shape.empty() && shape.front() < 0;
+        }
     } // namespace
 
     struct MusicNNModel::Impl
@@ -52,44 +52,42 @@ namespace lms::audio::musicnn
         explicit Impl(const std::filesystem::path& onnxPath)
             : env{ ORT_LOGGING_LEVEL_ERROR, "MusicNN" }
             , session{ [&]() -> Ort::Session {
+                // parallelism comes from the concurrent extractions, each running its own batches
                 sessionOptions.SetIntraOpNumThreads(1);
                 sessionOptions.SetInterOpNumThreads(1);
                 return Ort::Session{ env, onnxPath.c_str(), sessionOptions };
             }() }
             , memoryInfo{ Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault) }
+            , dynamicBatchSize{ hasDynamicBatchDimension(session) }
         {
         }
-    };
 
-    MusicNNModel::MusicNNModel(const std::filesystem::path& onnxPath)
-    {
-        try
-        {
-            _impl = std::make_unique<Impl>(onnxPath);
-        }
-        catch (const Ort::Exception& e)
-        {
-            throw audio::Exception{ std::string{ "Failed to load ONNX model '" } + onnxPath.string() + "': " + e.what() };
-        }
-    }
+        void run(std::span<const float> melPatches, std::span<float> embeddings, std::size_t patchCount);
 
-    MusicNNModel::~MusicNNModel() = default;
+        const bool dynamicBatchSize;
+    };
 
-    std::array<float, MusicNNModel::outputSize> MusicNNModel::forward(
-        std::span<const float, inputFrames * inputBands> melPatch) const
+    void MusicNNModel::Impl::run(std::span<const float> melPatches, std::span<float> embeddings, std::size_t patchCount)
     {
+        // [batch, T=187, mel=96]
+        const std::array<std::int64_t, 3> inputShape{ static_cast<std::int64_t>(patchCount),
+                                                      static_cast<std::int64_t>(MusicNNModel::inputFrames),
+                                                      static_cast<std::int64_t>(MusicNNModel::inputBands) };
+        // [batch, embedding=200]
+        const std::array<std::int64_t, 2> outputShape{ static_cast<std::int64_t>(patchCount),
+                                                       static_cast<std::int64_t>(MusicNNModel::outputSize) };
+
         Ort::Value inputTensor{ Ort::Value::CreateTensor<float>(
-            _impl->memoryInfo,
-            const_cast<float*>(melPatch.data()), // safe cast
-            melPatch.size(),
+            memoryInfo,
+            const_cast<float*>(melPatches.data()), // safe cast
+            patchCount * MusicNNModel::inputSize,
             inputShape.data(),
             inputShape.size()) };
 
-        std::array<float, outputSize> result{};
         Ort::Value outputTensor{ Ort::Value::CreateTensor<float>(
-            _impl->memoryInfo,
-            result.data(),
-            result.size(),
+            memoryInfo,
+            embeddings.data(),
+            patchCount * MusicNNModel::outputSize,
             outputShape.data(),
             outputShape.size()) };
 
@@ -97,15 +95,57 @@ namespace lms::audio::musicnn
         {
             auto inputNames{ std::to_array({ inputName }) };
             auto outputNames{ std::to_array({ outputName }) };
-            _impl->session.Run(Ort::RunOptions{ nullptr },
-                               inputNames.data(), &inputTensor, 1,
-                               outputNames.data(), &outputTensor, 1);
+            session.Run(Ort::RunOptions{ nullptr },
+                        inputNames.data(), &inputTensor, 1,
+                        outputNames.data(), &outputTensor, 1);
         }
         catch (const Ort::Exception& e)
         {
             throw audio::Exception{ std::string{ "ONNX inference failed: " } + e.what() };
         }
+    }
+
+    MusicNNModel::MusicNNModel(const std::filesystem::path& onnxPath)
+    {
+        try
+        {
+            _impl = std::make_unique<Impl>(onnxPath);
+        }
+        catch (const Ort::Exception& e)
+        {
+            throw audio::Exception{ std::string{ "Failed to load ONNX model '" } + onnxPath.string() + "': " + e.what() };
+        }
+    }
+
+    MusicNNModel::~MusicNNModel() = default;
+
+    std::array<float, MusicNNModel::outputSize> MusicNNModel::forward(std::span<const float, inputSize> melPatch) const
+    {
+        std::array<float, outputSize> result{};
+        _impl->run(melPatch, result, 1);
 
         return result;
     }
+
+    void MusicNNModel::forward(std::span<const float> melPatches, std::span<float> embeddings) const
+    {
+        assert(melPatches.size() % inputSize == 0);
+        const std::size_t patchCount{ melPatches.size() / inputSize };
+        assert(embeddings.size() == patchCount * outputSize);
+
+        if (_impl->dynamicBatchSize)
+        {
+            if (patchCount > 0)
+                _impl->run(melPatches, embeddings, patchCount);
+            return;
+        }
+
+        for (std::size_t i{}; i < patchCount; ++i)
+            _impl->run(melPatches.subspan(i * inputSize, inputSize), embeddings.subspan(i * outputSize, outputSize), 1);
+    }
+
+    bool MusicNNModel::hasDynamicBatchSize() const
+    {
+        return _impl->dynamicBatchSize;
+    }
 } // namespace lms::audio::musicnn
@@ -28,8 +28,9 @@
 namespace lms::audio::musicnn
 {
     // The ONNX model must be exported with:
-    //   input  "mel_patch"  shape [1, 1, 187, 96]
-    //   output "embedding"  shape [1, 200]
+    //   input  "mel_patch"  shape [batch, 187, 96]
+    //   output "embedding"  shape [batch, 200]
+    // where batch is either dynamic or 1 (patches are then run one by one)
     //
     // Export script: tools/musicnn/export_onnx.py
     class MusicNNModel
@@ -44,8 +45,14 @@ namespace lms::audio::musicnn
         static inline constexpr std::size_t inputFrames{ 187 };
         static inline constexpr std::size_t inputBands{ 96 };
         static inline constexpr std::size_t outputSize{ 200 };
+        static inline constexpr std::size_t inputSize{ inputFrames * inputBands };
 
-        [[nodiscard]] std::array<float, outputSize> forward(std::span<const float, inputFrames * inputBands> melPatch) const;
+        [[nodiscard]] std::array<float, outputSize> forward(std::span<const float, inputSize> melPatch) const;
+
+        // Patches laid out one after another, embeddings written the same way
+        // Runs as a single inference if the model has a dynamic batch dimension
+        void forward(std::span<const float> melPatches, std::span<float> embeddings) const;
+        [[nodiscard]] bool hasDynamicBatchSize() const;
 
     private:
         // Pimpl: keep ORT headers out of translation units that include this header.
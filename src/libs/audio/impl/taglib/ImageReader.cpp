@@ -21,12 +21,17 @@
 
 #include "TagLibDefs.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
 #include <taglib/aifffile.h>
 #include <taglib/apetag.h>
 #include <taglib/asffile.h>
 #include <taglib/attachedpictureframe.h>
 #include <taglib/flacfile.h>
 #include <taglib/flacpicture.h>
+#include <taglib/id3v2header.h>
 #include <taglib/id3v2tag.h>
 #include <taglib/mp4coverart.h>
 #include <taglib/mp4file.h>
@@ -228,7 +233,62 @@ namespace lms::audio::taglib
         }
 #endif // LMS_TAGLIB_HAS_APE_COMPLEX_PROPERTIES
 
-        void visitID3V2Images(const ::TagLib::ID3v2::Tag& id3v2Tags, const ImageReader::ImageVisitor& visitor)
+        // Finds where picture data is stored verbatim in the file, so that it can be read later without parsing the file
+        // Pictures are expected to be visited in file order: each search starts after the previously located picture
+        class PictureDataLocator
+        {
+        public:
+            PictureDataLocator(::TagLib::File& file, std::int64_t searchEnd)
+                : _file{ file }
+                , _searchEnd{ searchEnd }
+            {
+            }
+
+            std::optional<std::uint64_t> locate(std::span<const std::byte> data)
+            {
+                constexpr std::size_t maxPatternSize{ 64 };
+                constexpr std::int64_t chunkSize{ 64 * 1024 };
+
+                if (data.empty())
+                    return std::nullopt;
+
+                const ::TagLib::ByteVector pattern{ reinterpret_cast<const char*>(data.data()), static_cast<unsigned int>(std::min(data.size(), maxPatternSize)) };
+                for (std::int64_t chunkOffset{ _searchBegin }; chunkOffset < _searchEnd; chunkOffset += chunkSize)
+                {
+                    // chunks overlap so that a pattern across two chunks is found
+                    _file.seek(chunkOffset);
+                    const ::TagLib::ByteVector chunk{ _file.readBlock(static_cast<std::size_t>(std::min<std::int64_t>(chunkSize + pattern.size() - 1, _searchEnd - chunkOffset))) };
+                    if (chunk.size() < pattern.size())
+                        break;
+
+                    for (int pos{ chunk.find(pattern) }; pos >= 0 && pos < chunkSize; pos = chunk.find(pattern, static_cast<unsigned int>(pos) + 1))
+                    {
+                        const std::int64_t offset{ chunkOffset + pos };
+                        if (matches(offset, data))
+                        {
+                            _searchBegin = offset + static_cast<std::int64_t>(data.size());
+                            return static_cast<std::uint64_t>(offset);
+                        }
+                    }
+                }
+
+                return std::nullopt;
+            }
+
+        private:
+            bool matches(std::int64_t offset, std::span<const std::byte> data)
+            {
+                _file.seek(offset);
+                const ::TagLib::ByteVector block{ _file.readBlock(data.size()) };
+                return block.size() == data.size() && std::memcmp(block.data(), data.data(), data.size()) == 0;
+            }
+
+            ::TagLib::File& _file;
+            std::int64_t _searchBegin{};
+            const std::int64_t _searchEnd;
+        };
+
+        void visitID3V2Images(const ::TagLib::ID3v2::Tag& id3v2Tags, PictureDataLocator* locator, const ImageReader::ImageVisitor& visitor)
         {
             const auto& frameListMap{ id3v2Tags.frameListMap() };
 
@@ -246,6 +306,8 @@ namespace lms::audio::taglib
                 image.description = attachedPictureFrame->description().to8Bit(true);
                 image.mimeType = attachedPictureFrame->mimeType().to8Bit(true);
                 image.data = pictureData;
+                if (locator)
+                    image.dataOffset = locator->locate(pictureData); // not found if the frame is unsynchronized or compressed
                 visitor(image);
             }
         }
@@ -301,7 +363,35 @@ namespace lms::audio::taglib
             }
         }
 
-        void visitFLACImages(const ::TagLib::List<TagLib::FLAC::Picture*>& pictureList, const ImageReader::ImageVisitor& visitor)
+        // Returns the offset of the first audio frame, or 0 if the metadata blocks cannot be walked
+        std::int64_t getFLACMetadataEnd(::TagLib::File& file)
+        {
+            constexpr unsigned int markerSize{ 4 };
+            constexpr unsigned int blockHeaderSize{ 4 };
+
+            file.seek(0);
+            if (file.readBlock(markerSize) != ::TagLib::ByteVector{ "fLaC", markerSize })
+                return 0;
+
+            std::int64_t offset{ markerSize };
+            while (true)
+            {
+                file.seek(offset);
+                const ::TagLib::ByteVector blockHeader{ file.readBlock(blockHeaderSize) };
+                if (blockHeader.size() != blockHeaderSize)
+                    return 0;
+
+                const bool isLastBlock{ (static_cast<unsigned char>(blockHeader[0]) & 0x80) != 0 };
+                offset += static_cast<std::int64_t>(blockHeaderSize + blockHeader.toUInt(1, 3, true));
+                if (offset > file.length())
+                    return 0;
+
+                if (isLastBlock)
+                    return offset;
+            }
+        }
+
+        void visitFLACImages(const ::TagLib::List<TagLib::FLAC::Picture*>& pictureList, PictureDataLocator* locator, const ImageReader::ImageVisitor& visitor)
         {
             for (TagLib::FLAC::Picture* flacPicture : pictureList)
             {
@@ -313,6 +403,8 @@ namespace lms::audio::taglib
                 image.description = flacPicture->description().to8Bit(true);
                 image.mimeType = flacPicture->mimeType().to8Bit(true);
                 image.data = pictureData;
+                if (locator)
+                    image.dataOffset = locator->locate(pictureData);
 
                 visitor(image);
             }
@@ -359,7 +451,11 @@ namespace lms::audio::taglib
         if (TagLib::MPEG::File * mp3File{ dynamic_cast<TagLib::MPEG::File*>(&_file) })
         {
             if (mp3File->hasID3v2Tag())
-                visitID3V2Images(*mp3File->ID3v2Tag(), visitor);
+            {
+                // Only look for pictures in the tag, at the beginning of the file
+                PictureDataLocator locator{ _file, mp3File->ID3v2Tag()->header()->completeTagSize() };
+                visitID3V2Images(*mp3File->ID3v2Tag(), &locator, visitor);
+            }
         }
         // MP4
         else if (const TagLib::MP4::File * mp4File{ dynamic_cast<const TagLib::MP4::File*>(&_file) })
@@ -376,31 +472,38 @@ namespace lms::audio::taglib
         else if (TagLib::FLAC::File * flacFile{ dynamic_cast<TagLib::FLAC::File*>(&_file) })
         {
             if (flacFile->hasID3v2Tag()) // usage discouraged
-                visitID3V2Images(*flacFile->ID3v2Tag(), visitor);
+            {
+                PictureDataLocator locator{ _file, flacFile->ID3v2Tag()->header()->completeTagSize() };
+                visitID3V2Images(*flacFile->ID3v2Tag(), &locator, visitor);
+            }
             else
-                visitFLACImages(flacFile->pictureList(), visitor);
+            {
+                // Picture blocks are stored before the audio frames: do not look further
+                PictureDataLocator locator{ _file, getFLACMetadataEnd(_file) };
+                visitFLACImages(flacFile->pictureList(), &locator, visitor);
+            }
         }
         // Ogg vorbis
         else if (const TagLib::Ogg::Vorbis::File * vorbisFile{ dynamic_cast<const TagLib::Ogg::Vorbis::File*>(&_file) })
         {
-            visitFLACImages(vorbisFile->tag()->pictureList(), visitor);
+            visitFLACImages(vorbisFile->tag()->pictureList(), nullptr, visitor);
         }
         // Ogg Opus
         else if (const TagLib::Ogg::Opus::File * opusFile{ dynamic_cast<TagLib::Ogg::Opus::File*>(&_file) })
         {
-            visitFLACImages(opusFile->tag()->pictureList(), visitor);
+            visitFLACImages(opusFile->tag()->pictureList(), nullptr, visitor);
         }
         // Aiff
         else if (const TagLib::RIFF::AIFF::File * aiffFile{ dynamic_cast<TagLib::RIFF::AIFF::File*>(&_file) })
         {
             if (aiffFile->hasID3v2Tag())
-                visitID3V2Images(*aiffFile->tag(), visitor);
+                visitID3V2Images(*aiffFile->tag(), nullptr, visitor);
         }
         // Wav
         else if (const TagLib::RIFF::WAV::File * wavFile{ dynamic_cast<TagLib::RIFF::WAV::File*>(&_file) })
         {
             if (wavFile->hasID3v2Tag())
-                visitID3V2Images(*wavFile->ID3v2Tag(), visitor);
+                visitID3V2Images(*wavFile->ID3v2Tag(), nullptr, visitor);
         }
         // MPC
         else if (TagLib::MPC::File * mpcFile{ dynamic_cast<TagLib::MPC::File*>(&_file) })
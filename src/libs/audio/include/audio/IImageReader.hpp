@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
 #include <functional>
+#include <optional>
 #include <span>
 #include <string>
+#include <vector>
 
 #include "core/media/ImageType.hpp"
 
@@ -33,6 +37,7 @@ namespace lms::audio
         std::string mimeType{ "application/octet-stream" };
         std::string description;
         std::span<const std::byte> data;
+        std::optional<std::uint64_t> dataOffset; // position of data in the file, only set if data is stored verbatim
     };
 
     class IImageReader
@@ -43,4 +48,8 @@ namespace lms::audio
         using ImageVisitor = std::function<void(const Image& image)>;
         virtual void visitImages(const ImageVisitor& visitor) const = 0;
     };
+
+    // Reads image data using a previously retrieved Image::dataOffset, without parsing the file
+    // May throw Exception
+    std::vector<std::byte> readImageData(const std::filesystem::path& p, std::uint64_t dataOffset, std::size_t dataSize);
 } // namespace lms::audio
@@ -24,6 +24,8 @@
 #include <memory>
 #include <string_view>
 
+#include <boost/asio/io_context.hpp>
+
 #include "TranscodeTypes.hpp"
 
 namespace lms::audio
@@ -42,7 +44,16 @@ namespace lms::audio
         virtual const TranscodeOutputParameters& getOutputParameters() const = 0;
 
         virtual bool finished() const = 0;
+        // only meaningful once finished: the transcode stopped on an error and the output is truncated
+        virtual bool failed() const = 0;
     };
 
-    std::unique_ptr<ITranscoder> createTranscoder(const TranscodeParameters& parameters);
+    enum class TranscoderBackend
+    {
+        ChildProcess, // spawns a ffmpeg process, reads its output through a pipe
+        InProcess,    // demuxes, decodes, resamples and encodes using libav, in the io context threads for async reads
+    };
+    static inline constexpr TranscoderBackend defaultTranscoderBackend{ TranscoderBackend::ChildProcess };
+    // ioContext runs the async reads of the in-process backend
+    std::unique_ptr<ITranscoder> createTranscoder(boost::asio::io_context& ioContext, const TranscodeParameters& parameters, TranscoderBackend backend = defaultTranscoderBackend);
 } // namespace lms::audio
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <gtest/gtest.h>
+
+#include "audio/Exception.hpp"
+#include "audio/IPcmDecoder.hpp"
+#include "audio/ITranscoder.hpp"
+#include "audio/PcmTypes.hpp"
+#include "core/testing/FileWriters.hpp"
+#include "core/testing/TemporaryFile.hpp"
+
+namespace lms::audio::tests
+{
+    namespace
+    {
+        using core::testing::TemporaryFile;
+        using core::testing::writeLE;
+
+        constexpr unsigned sampleRate{ 44'100 };
+        constexpr unsigned channelCount{ 2 };
+
+        TranscodeParameters createTranscodeParameters(const std::filesystem::path& inputFile)
+        {
+            TranscodeParameters parameters;
+            parameters.inputParameters.filePath = inputFile;
+            parameters.inputParameters.audioProperties = AudioProperties{
+                .container = core::media::Container::WAV,
+                .codec = core::media::Codec::PCM,
+                .duration = std::chrono::seconds{ 1 },
+                .bitrate = sampleRate * channelCount * 16,
+                .channelCount = channelCount,
+                .sampleRate = sampleRate,
+                .bitsPerSample = 16,
+            };
+            parameters.outputParameters.format = TranscodeOutputFormat{ core::media::Container::FLAC, core::media::Codec::FLAC };
+
+            return parameters;
+        }
+
+        void writeWavFile(const std::filesystem::path& path, std::chrono::seconds duration)
+        {
+            const std::size_t dataSize{ sampleRate * channelCount * 2 * static_cast<std::size_t>(duration.count()) };
+            std::ofstream os{ path, std::ios::binary | std::ios::trunc };
+            core::testing::writeWavHeader(os, sampleRate, channelCount, dataSize);
+            for (std::size_t i{}; i < dataSize / 2; ++i)
+                writeLE(os, static_cast<std::uint16_t>(i * 37), 2);
+        }
+
+        void transcodeToFile(boost::asio::io_context& ioContext, const TranscodeParameters& parameters, const std::filesystem::path& outputFile)
+        {
+            const auto transcoder{ createTranscoder(ioContext, parameters, TranscoderBackend::InProcess) };
+
+            std::ofstream os{ outputFile, std::ios::binary | std::ios::trunc };
+            std::array<std::byte, 65'536> buffer;
+            while (!transcoder->finished())
+                os.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(transcoder->readSome(buffer.data(), buffer.size())));
+            EXPECT_FALSE(transcoder->failed());
+        }
+
+        std::size_t countSamples(const std::filesystem::path& file)
+        {
+            const auto decoder{ createPcmDecoder(file, {}, PcmParameters{ .channelCount = channelCount, .sampleRate = sampleRate, .sampleType = PcmSampleType::Signed16, .byteOrder = std::endian::native, .planar = false }) };
+
+            std::vector<std::byte> buffer(4096 * channelCount * 2);
+            std::array<IPcmDecoder::WritableBuffer, 1> buffers{ buffer };
+            std::size_t sampleCount{};
+            while (const std::size_t readSampleCount{ decoder->readSamples(buffers) })
+                sampleCount += readSampleCount;
+
+            return sampleCount;
+        }
+
+        std::size_t readAll(ITranscoder& transcoder)
+        {
+            std::array<std::byte, 65'536> buffer;
+            std::size_t totalSize{};
+            while (!transcoder.finished())
+                totalSize += transcoder.readSome(buffer.data(), buffer.size());
+
+            return totalSize;
+        }
+    } // namespace
+
+    TEST(InProcessTranscoder, validInput)
+    {
+        const TemporaryFile input{ "lms-test-transcoder-valid.wav" };
+        writeWavFile(input.getPath(), std::chrono::seconds{ 1 });
+
+        boost::asio::io_context ioContext;
+        const auto transcoder{ createTranscoder(ioContext, createTranscodeParameters(input.getPath()), TranscoderBackend::InProcess) };
+        EXPECT_GT(readAll(*transcoder), 0);
+        EXPECT_TRUE(transcoder->finished());
+        EXPECT_FALSE(transcoder->failed());
+    }
+
+    TEST(InProcessTranscoder, asyncRead)
+    {
+        const TemporaryFile input{ "lms-test-transcoder-async.wav" };
+        writeWavFile(input.getPath(), std::chrono::seconds{ 1 });
+
+        boost::asio::io_context ioContext;
+        const auto transcoder{ createTranscoder(ioContext, createTranscodeParameters(input.getPath()), TranscoderBackend::InProcess) };
+
+        std::array<std::byte, 65'536> buffer;
+        std::size_t totalSize{};
+        while (!transcoder->finished())
+        {
+            std::optional<std::size_t> readSize;
+            transcoder->asyncRead(buffer.data(), buffer.size(), [&](std::size_t nbReadBytes) { readSize = nbReadBytes; });
+
+            // the work is done in the io context
+            EXPECT_FALSE(readSize);
+            ioContext.restart();
+            ioContext.run();
+            ASSERT_TRUE(readSize);
+            totalSize += *readSize;
+        }
+
+        EXPECT_GT(totalSize, 0);
+        EXPECT_FALSE(transcoder->failed());
+    }
+
+    TEST(InProcessTranscoder, asyncReadAfterDestruction)
+    {
+        const TemporaryFile input{ "lms-test-transcoder-destroyed.wav" };
+        writeWavFile(input.getPath(), std::chrono::seconds{ 1 });
+
+        boost::asio::io_context ioContext;
+        std::array<std::byte, 65'536> buffer;
+        bool callbackCalled{};
+        {
+            const auto transcoder{ createTranscoder(ioContext, createTranscodeParameters(input.getPath()), TranscoderBackend::InProcess) };
+            transcoder->asyncRead(buffer.data(), buffer.size(), [&](std::size_t) { callbackCalled = true; });
+        }
+
+        ioContext.run();
+        EXPECT_FALSE(callbackCalled);
+    }
+
+    TEST(InProcessTranscoder, offset)
+    {
+        const TemporaryFile input{ "lms-test-transcoder-offset.wav" };
+        writeWavFile(input.getPath(), std::chrono::seconds{ 3 });
+
+        // FLAC frames hold thousands of samples: seeking lands on the start of a frame
+        boost::asio::io_context ioContext;
+        const TemporaryFile source{ "lms-test-transcoder-offset-source.flac" };
+        transcodeToFile(ioContext, createTranscodeParameters(input.getPath()), source.getPath());
+
+        constexpr std::chrono::milliseconds offset{ 1'234 };
+        TranscodeParameters parameters{ createTranscodeParameters(source.getPath()) };
+        parameters.inputParameters.audioProperties.container = core::media::Container::FLAC;
+        parameters.inputParameters.audioProperties.codec = core::media::Codec::FLAC;
+        parameters.inputParameters.offset = offset;
+        const TemporaryFile output{ "lms-test-transcoder-offset-output.flac" };
+        transcodeToFile(ioContext, parameters, output.getPath());
+
+        const std::size_t sourceSampleCount{ countSamples(source.getPath()) };
+        EXPECT_EQ(sourceSampleCount, 3 * sampleRate);
+        const std::size_t expectedSampleCount{ sourceSampleCount - helpers::durationToSampleCount(offset, sampleRate) };
+        EXPECT_NEAR(static_cast<double>(countSamples(output.getPath())), static_cast<double>(expectedSampleCount), 2.);
+    }
+
+    TEST(InProcessTranscoder, corruptInput)
+    {
+        const TemporaryFile input{ "lms-test-transcoder-corrupt.wav" };
+        {
+            // RIFF/WAVE signature but no format chunk, followed by garbage
+            std::ofstream os{ input.getPath(), std::ios::binary | std::ios::trunc };
+            os.write("RIFF", 4);
+            writeLE(os, 4 + 65'536, 4);
+            os.write("WAVE", 4);
+            for (std::uint32_t i{}; i < 65'536; ++i)
+                os.put(static_cast<char>((i * 2654435761u) >> 24));
+        }
+
+        // must never look like a successful transcode: either rejected upfront or reported as failed
+        bool errorReported{};
+        try
+        {
+            boost::asio::io_context ioContext;
+            const auto transcoder{ createTranscoder(ioContext, createTranscodeParameters(input.getPath()), TranscoderBackend::InProcess) };
+            readAll(*transcoder);
+            errorReported = transcoder->failed();
+        }
+        catch (const Exception&)
+        {
+            errorReported = true;
+        }
+
+        EXPECT_TRUE(errorReported);
+    }
+} // namespace lms::audio::tests
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "audio/Exception.hpp"
+
+#include "musicnn/InferenceQueue.hpp"
+
+namespace lms::audio::musicnn::tests
+{
+    namespace
+    {
+        constexpr std::size_t inputSize{ 4 };
+        constexpr std::size_t outputSize{ 2 };
+        constexpr std::chrono::milliseconds longGatherDelay{ 60'000 };
+
+        // outputs of a patch: sum and max of its inputs
+        void computeOutputs(std::span<const float> inputs, std::span<float> outputs)
+        {
+            ASSERT_EQ(inputs.size() / inputSize * outputSize, outputs.size());
+            for (std::size_t i{}; i < inputs.size() / inputSize; ++i)
+            {
+                const auto patch{ inputs.subspan(i * inputSize, inputSize) };
+                outputs[i * outputSize] = std::accumulate(std::cbegin(patch), std::cend(patch), 0.F);
+                outputs[i * outputSize + 1] = *std::max_element(std::cbegin(patch), std::cend(patch));
+            }
+        }
+
+        std::vector<float> generateInputs(std::size_t patchCount, float seed)
+        {
+            std::vector<float> inputs(patchCount * inputSize);
+            for (std::size_t i{}; i < inputs.size(); ++i)
+                inputs[i] = seed + static_cast<float>(i);
+            return inputs;
+        }
+    } // namespace
+
+    TEST(InferenceQueue, singleRequest)
+    {
+        std::size_t batchCount{};
+        // no registered submitter: nothing to wait for
+        InferenceQueue queue{ inputSize, outputSize, 3, longGatherDelay, [&](std::span<const float> inputs, std::span<float> outputs) {
+                                 EXPECT_LE(inputs.size(), 3 * inputSize);
+                                 computeOutputs(inputs, outputs);
+                                 batchCount++;
+                             } };
+
+        const std::vector<float> inputs{ generateInputs(7, 1.F) };
+        std::vector<float> outputs(7 * outputSize);
+        queue.process(inputs, outputs);
+        EXPECT_EQ(batchCount, 3);
+
+        std::vector<float> expectedOutputs(7 * outputSize);
+        computeOutputs(inputs, expectedOutputs);
+        EXPECT_EQ(outputs, expectedOutputs);
+
+        // nothing to do
+        queue.process({}, {});
+        EXPECT_EQ(batchCount, 3);
+    }
+
+    TEST(InferenceQueue, concurrentRequests)
+    {
+        constexpr std::size_t maxBatchSize{ 8 };
+        constexpr std::size_t threadCount{ 8 };
+        constexpr std::size_t requestCountPerThread{ 50 };
+
+        std::atomic<std::size_t> computedPatchCount{};
+        InferenceQueue queue{ inputSize, outputSize, maxBatchSize, std::chrono::milliseconds{ 1 }, [&](std::span<const float> inputs, std::span<float> outputs) {
+                                 EXPECT_LE(inputs.size(), maxBatchSize * inputSize);
+                                 computeOutputs(inputs, outputs);
+                                 computedPatchCount += inputs.size() / inputSize;
+                             } };
+
+        std::atomic<std::size_t> processedPatchCount{};
+        std::vector<std::thread> threads;
+        for (std::size_t threadIndex{}; threadIndex < threadCount; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex] {
+                const InferenceQueue::Submitter submitter{ queue };
+                for (std::size_t i{}; i < requestCountPerThread; ++i)
+                {
+                    const std::size_t patchCount{ 1 + (threadIndex + i) % 11 };
+                    const std::vector<float> inputs{ generateInputs(patchCount, static_cast<float>(threadIndex * 1000 + i)) };
+                    std::vector<float> outputs(patchCount * outputSize);
+                    queue.process(inputs, outputs);
+
+                    std::vector<float> expectedOutputs(patchCount * outputSize);
+                    computeOutputs(inputs, expectedOutputs);
+                    EXPECT_EQ(outputs, expectedOutputs);
+                    processedPatchCount += patchCount;
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        EXPECT_EQ(computedPatchCount, processedPatchCount);
+    }
+
+    TEST(InferenceQueue, batchesGatherRequests)
+    {
+        constexpr std::size_t maxBatchSize{ 8 };
+        constexpr std::size_t threadCount{ 2 };
+
+        std::vector<std::size_t> batchPatchCounts;
+        InferenceQueue queue{ inputSize, outputSize, maxBatchSize, longGatherDelay, [&](std::span<const float> inputs, std::span<float> outputs) {
+                                 computeOutputs(inputs, outputs);
+                                 batchPatchCounts.push_back(inputs.size() / inputSize);
+                             } };
+
+        // registered before any request is submitted, so that the first request waits for the other one
+        std::optional<InferenceQueue::Submitter> submitters[threadCount];
+        for (auto& submitter : submitters)
+            submitter.emplace(queue);
+
+        std::vector<std::thread> threads;
+        for (std::size_t threadIndex{}; threadIndex < threadCount; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex] {
+                const std::vector<float> inputs{ generateInputs(maxBatchSize / threadCount, static_cast<float>(threadIndex * 1000)) };
+                std::vector<float> outputs(maxBatchSize / threadCount * outputSize);
+                queue.process(inputs, outputs);
+
+                std::vector<float> expectedOutputs(outputs.size());
+                computeOutputs(inputs, expectedOutputs);
+                EXPECT_EQ(outputs, expectedOutputs);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (auto& submitter : submitters)
+            submitter.reset();
+
+        // a single batch, made of the patches of both requests
+        EXPECT_EQ(batchPatchCounts, std::vector<std::size_t>{ maxBatchSize });
+    }
+
+    TEST(InferenceQueue, gatherDelay)
+    {
+        std::size_t batchCount{};
+        InferenceQueue queue{ inputSize, outputSize, 8, std::chrono::milliseconds{ 10 }, [&](std::span<const float> inputs, std::span<float> outputs) {
+                                 computeOutputs(inputs, outputs);
+                                 batchCount++;
+                             } };
+
+        // never submits anything: the request must not wait for it longer than the gather delay
+        const InferenceQueue::Submitter idleSubmitter{ queue };
+        const InferenceQueue::Submitter submitter{ queue };
+
+        const std::vector<float> inputs{ generateInputs(2, 1.F) };
+        std::vector<float> outputs(2 * outputSize);
+        queue.process(inputs, outputs);
+        EXPECT_EQ(batchCount, 1);
+
+        std::vector<float> expectedOutputs(2 * outputSize);
+        computeOutputs(inputs, expectedOutputs);
+        EXPECT_EQ(outputs, expectedOutputs);
+    }
+
+    TEST(InferenceQueue, failure)
+    {
+        InferenceQueue queue{ inputSize, outputSize, 4, longGatherDelay, [&](std::span<const float> inputs, std::span<float> outputs) {
+                                 if (std::any_of(std::cbegin(inputs), std::cend(inputs), [](float input) { return input < 0; }))
+                                     throw Exception{ "negative input" };
+                                 computeOutputs(inputs, outputs);
+                             } };
+
+        const std::vector<float> invalidInputs{ generateInputs(2, -10.F) };
+        std::vector<float> outputs(2 * outputSize);
+        EXPECT_THROW(queue.process(invalidInputs, outputs), Exception);
+
+        // the queue is still usable
+        const std::vector<float> inputs{ generateInputs(2, 1.F) };
+        EXPECT_NO_THROW(queue.process(inputs, outputs));
+    }
+
+    TEST(InferenceQueue, invalidParameters)
+    {
+        EXPECT_THROW((InferenceQueue{ inputSize, outputSize, 0, longGatherDelay, computeOutputs }), Exception);
+    }
+} // namespace lms::audio::musicnn::tests
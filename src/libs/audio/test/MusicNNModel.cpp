@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <filesystem>
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -73,4 +74,30 @@ namespace lms::audio::musicnn::tests
         EXPECT_NO_THROW({ [[maybe_unused]] const auto output{ model.forward(patch) }; });
     }
 
+    TEST(MusicNNModel, CanForwardBatch)
+    {
+        const std::filesystem::path path{ getMusicNNModelPathFromEnv() };
+
+        if (path.empty())
+            GTEST_SKIP() << "LMS_MUSICNN_MODEL not set";
+
+        const MusicNNModel model{ path };
+        const auto patch{ makeRandomPatch() };
+        const auto expectedOutput{ model.forward(patch) };
+
+        constexpr std::size_t batchSize{ 3 };
+        std::vector<float> patches;
+        for (std::size_t i{}; i < batchSize; ++i)
+            patches.insert(std::cend(patches), std::cbegin(patch), std::cend(patch));
+
+        std::vector<float> outputs(batchSize * MusicNNModel::outputSize);
+        ASSERT_NO_THROW(model.forward(patches, outputs));
+
+        for (std::size_t i{}; i < batchSize; ++i)
+        {
+            for (std::size_t d{}; d < MusicNNModel::outputSize; ++d)
+                EXPECT_NEAR(outputs[i * MusicNNModel::outputSize + d], expectedOutput[d], 1e-4F) << "patch " << i << ", dim " << d;
+        }
+    }
+
 } // namespace lms::audio::musicnn::tests
\ No newline at end of file
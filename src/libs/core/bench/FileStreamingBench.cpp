@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/AlignedHeapArray.hpp"
+#include "core/testing/TemporaryFile.hpp"
+
+#include "FileChunkReader.hpp"
+
+namespace lms::core::benchs
+{
+    namespace
+    {
+        constexpr std::size_t chunkSize{ 262'144 };
+
+        class TmpFile : public core::testing::TemporaryFile
+        {
+        public:
+            TmpFile(std::size_t size)
+                : TemporaryFile{ "lms_bench_file_" + std::to_string(size) }
+            {
+                std::ofstream ofs{ getPath(), std::ios::binary };
+                std::vector<char> data(chunkSize);
+                for (std::size_t i{}; i < data.size(); ++i)
+                    data[i] = static_cast<char>(i);
+                for (std::size_t written{}; written < size; written += data.size())
+                    ofs.write(data.data(), static_cast<std::streamsize>(std::min(data.size(), size - written)));
+            }
+        };
+
+        constexpr std::size_t fileSize{ 128 * 1024 * 1024 };
+
+        const TmpFile& getTmpFile()
+        {
+            static const TmpFile file{ fileSize };
+            return file;
+        }
+
+        // Mimics the response stream, that copies what is written in its own buffer
+        class ResponseStreamBuf : public std::streambuf
+        {
+        protected:
+            std::streamsize xsputn(const char* data, std::streamsize count) override
+            {
+                const std::size_t copySize{ std::min(static_cast<std::size_t>(count), _buffer.size()) };
+                std::memcpy(_buffer.data(), data, copySize);
+                benchmark::DoNotOptimize(_buffer.data());
+                return count;
+            }
+
+        private:
+            std::vector<char> _buffer = std::vector<char>(chunkSize);
+        };
+    } // namespace
+
+    // Former FileResourceHandler strategy: one stream and one allocation per chunk
+    static void BM_FileStreaming_ifstream(benchmark::State& state)
+    {
+        const TmpFile& file{ getTmpFile() };
+        ResponseStreamBuf streamBuf;
+        std::ostream response{ &streamBuf };
+
+        for (auto _ : state)
+        {
+            std::ifstream ifs{ file.getPath(), std::ios::in | std::ios::binary };
+            for (std::size_t offset{}; offset < fileSize; offset += chunkSize)
+            {
+                std::vector<char> buf(std::min(chunkSize, fileSize - offset));
+                ifs.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+                response.write(buf.data(), ifs.gcount());
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * fileSize));
+    }
+
+    static void BM_FileStreaming_chunkReader(benchmark::State& state)
+    {
+        const TmpFile& file{ getTmpFile() };
+        ResponseStreamBuf streamBuf;
+        std::ostream response{ &streamBuf };
+        AlignedHeapArray<char, 4096> buffer{ chunkSize };
+
+        for (auto _ : state)
+        {
+            FileChunkReader reader{ file.getPath() };
+            reader.adviseSequentialRead(0, fileSize);
+            for (std::size_t offset{}; offset < fileSize; offset += chunkSize)
+            {
+                std::error_code ec;
+                const std::size_t readSize{ reader.read(offset, std::span<char>{ buffer.data(), std::min(chunkSize, fileSize - offset) }, ec) };
+                response.write(buffer.data(), static_cast<std::streamsize>(readSize));
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * fileSize));
+    }
+
+    BENCHMARK(BM_FileStreaming_ifstream)->Threads(1)->Threads(std::thread::hardware_concurrency())->UseRealTime();
+    BENCHMARK(BM_FileStreaming_chunkReader)->Threads(1)->Threads(std::thread::hardware_concurrency())->UseRealTime();
+} // namespace lms::core::benchs
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/IJob.hpp"
+#include "core/IJobScheduler.hpp"
+
+namespace lms::core::benchs
+{
+    namespace
+    {
+        // Does almost nothing, so that only the scheduling overhead is measured
+        class TinyJob : public IJob
+        {
+        public:
+            TinyJob(std::atomic<std::size_t>& counter)
+                : _counter{ counter } {}
+
+        private:
+            LiteralString getName() const override { return "TinyJob"; }
+            void run() override { _counter.fetch_add(1, std::memory_order_relaxed); }
+
+            std::atomic<std::size_t>& _counter;
+        };
+
+        constexpr std::size_t jobBatchSize{ 1000 };
+
+        void runTinyJobs(benchmark::State& state, bool mixPriorities)
+        {
+            const auto scheduler{ createJobScheduler("Bench", static_cast<std::size_t>(state.range(0))) };
+
+            std::atomic<std::size_t> counter{};
+            std::vector<std::unique_ptr<IJob>> doneJobs;
+            for (auto _ : state)
+            {
+                for (std::size_t i{}; i < jobBatchSize; ++i)
+                    scheduler->scheduleJob(std::make_unique<TinyJob>(counter), mixPriorities && (i % 4 == 0) ? JobPriority::Interactive : JobPriority::Background);
+
+                scheduler->wait();
+                while (scheduler->popJobsDone(doneJobs, jobBatchSize) > 0)
+                    doneJobs.clear();
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(counter.load()));
+        }
+
+        // Process the done jobs while the others are still running, as the scanner does
+        void runTinyJobsWithQueue(benchmark::State& state)
+        {
+            const auto scheduler{ createJobScheduler("Bench", static_cast<std::size_t>(state.range(0))) };
+            constexpr std::size_t maxOngoingJobs{ 20 };
+
+            std::atomic<std::size_t> counter{};
+            std::vector<std::unique_ptr<IJob>> doneJobs;
+            for (auto _ : state)
+            {
+                for (std::size_t i{}; i < jobBatchSize; ++i)
+                {
+                    scheduler->scheduleJob(std::make_unique<TinyJob>(counter));
+                    scheduler->popJobsDone(doneJobs, maxOngoingJobs);
+                    scheduler->waitUntilJobCountAtMost(maxOngoingJobs);
+                }
+
+                scheduler->wait();
+                while (scheduler->popJobsDone(doneJobs, jobBatchSize) > 0)
+                    doneJobs.clear();
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(counter.load()));
+        }
+    } // namespace
+
+    static void BM_JobScheduler_TinyJobs(benchmark::State& state)
+    {
+        runTinyJobs(state, false);
+    }
+
+    static void BM_JobScheduler_TinyJobs_mixedPriorities(benchmark::State& state)
+    {
+        runTinyJobs(state, true);
+    }
+
+    static void BM_JobScheduler_TinyJobs_queue(benchmark::State& state)
+    {
+        runTinyJobsWithQueue(state);
+    }
+
+    BENCHMARK(BM_JobScheduler_TinyJobs)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+    BENCHMARK(BM_JobScheduler_TinyJobs_mixedPriorities)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+    BENCHMARK(BM_JobScheduler_TinyJobs_queue)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+} // namespace lms::core::benchs
@@ -159,7 +159,8 @@ namespace lms::core
         if (!_finished)
             kill();
 
-        wait(true);
+        if (!_waited)
+            wait(true);
     }
 
     void ChildProcess::kill()
@@ -237,4 +238,14 @@ namespace lms::core
     {
         return _finished;
     }
+
+    std::optional<int> ChildProcess::getExitCode()
+    {
+        assert(finished());
+
+        if (!_waited)
+            wait(true);
+
+        return _exitCode;
+    }
 } // namespace lms::core
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileChunkReader.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lms::core
+{
+    FileChunkReader::FileChunkReader(const std::filesystem::path& path)
+        : _fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) }
+    {
+        if (_fd == -1)
+            return;
+
+        struct stat fileStat;
+        if (::fstat(_fd, &fileStat) == -1)
+        {
+            ::close(_fd);
+            _fd = -1;
+            return;
+        }
+
+        _fileSize = static_cast<std::uint64_t>(fileStat.st_size);
+    }
+
+    FileChunkReader::~FileChunkReader()
+    {
+        if (_fd != -1)
+            ::close(_fd);
+    }
+
+    void FileChunkReader::adviseSequentialRead([[maybe_unused]] std::uint64_t offset, [[maybe_unused]] std::uint64_t size)
+    {
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(_fd, static_cast<::off_t>(offset), static_cast<::off_t>(size), POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    void FileChunkReader::adviseWillNeed([[maybe_unused]] std::uint64_t offset, [[maybe_unused]] std::uint64_t size)
+    {
+#if defined(POSIX_FADV_WILLNEED)
+        ::posix_fadvise(_fd, static_cast<::off_t>(offset), static_cast<::off_t>(size), POSIX_FADV_WILLNEED);
+#endif
+    }
+
+    std::size_t FileChunkReader::read(std::uint64_t offset, std::span<char> buffer, std::error_code& ec)
+    {
+        ec.clear();
+
+        std::size_t totalRead{};
+        while (totalRead < buffer.size())
+        {
+            const ::ssize_t res{ ::pread(_fd, buffer.data() + totalRead, buffer.size() - totalRead, static_cast<::off_t>(offset + totalRead)) };
+            if (res == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                ec = std::error_code{ errno, std::generic_category() };
+                break;
+            }
+
+            if (res == 0) // end of file
+                break;
+
+            totalRead += static_cast<std::size_t>(res);
+        }
+
+        return totalRead;
+    }
+} // namespace lms::core
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <system_error>
+
+namespace lms::core
+{
+    // Positional reads on a file, meant to stream it by chunks without keeping any stream state
+    class FileChunkReader
+    {
+    public:
+        explicit FileChunkReader(const std::filesystem::path& path);
+        ~FileChunkReader();
+        FileChunkReader(const FileChunkReader&) = delete;
+        FileChunkReader& operator=(const FileChunkReader&) = delete;
+
+        bool isOpen() const { return _fd != -1; }
+        std::uint64_t getFileSize() const { return _fileSize; }
+
+        // Hints only, silently ignored if not supported
+        void adviseSequentialRead(std::uint64_t offset, std::uint64_t size);
+        void adviseWillNeed(std::uint64_t offset, std::uint64_t size);
+
+        // Returns the number of bytes read, less than the buffer size only on end of file or error
+        std::size_t read(std::uint64_t offset, std::span<char> buffer, std::error_code& ec);
+
+    private:
+        int _fd{ -1 };
+        std::uint64_t _fileSize{};
+    };
+} // namespace lms::core
@@ -20,12 +20,29 @@
 #include "FileResourceHandler.hpp"
 
 #include <algorithm>
+#include <cassert>
+#include <span>
 
+#include "core/AlignedHeapArray.hpp"
 #include "core/ILogger.hpp"
 #include "core/MimeTypes.hpp"
 
 namespace lms::core
 {
+    namespace
+    {
+        constexpr std::size_t chunkSize{ 262'144 };
+        constexpr std::size_t readAheadSize{ 4 * chunkSize }; // prefetched while the current chunk is being sent
+
+        // Chunks are copied into the response right away: a single buffer per thread is enough
+        std::span<char> getThreadChunkBuffer(std::size_t size)
+        {
+            static thread_local AlignedHeapArray<char, 4096> buffer{ chunkSize };
+            assert(size <= buffer.size());
+            return std::span<char>{ buffer.data(), size };
+        }
+    } // namespace
+
     std::unique_ptr<IResourceHandler> createFileResourceHandler(const std::filesystem::path& path, std::string_view mimeType)
     {
         return std::make_unique<FileResourceHandler>(path, mimeType.empty() ? getMimeType(path.extension()) : mimeType);
@@ -33,15 +50,13 @@ namespace lms::core
 
     FileResourceHandler::FileResourceHandler(const std::filesystem::path& path, std::string_view mimeType)
         : _mimeType{ mimeType }
-        , _ifs{ path, std::ios::in | std::ios::binary }
+        , _reader{ path }
     {
-        if (!_ifs)
-            LMS_LOG(UTILS, ERROR, "Cannot open file stream for " << path);
+        if (!_reader.isOpen())
+            LMS_LOG(UTILS, ERROR, "Cannot open file " << path);
         else
         {
-            _ifs.seekg(0, std::ios::end);
-            if (!_ifs.fail())
-                _fileSize = static_cast<::uint64_t>(_ifs.tellg());
+            _fileSize = _reader.getFileSize();
             LMS_LOG(UTILS, DEBUG, "File " << path << ", fileSize = " << _fileSize);
         }
     }
@@ -50,7 +65,7 @@ namespace lms::core
     {
         if (_offset == 0)
         {
-            if (!_ifs)
+            if (!_reader.isOpen())
             {
                 response.setStatus(404);
                 return {};
@@ -97,26 +112,32 @@ namespace lms::core
             LMS_LOG(UTILS, DEBUG, "Mimetype set to '" << _mimeType << "'");
             response.setMimeType(_mimeType);
 
-            _ifs.seekg(static_cast<std::istream::pos_type>(_offset));
+            _reader.adviseSequentialRead(_offset, _beyondLastByte - _offset);
         } // end initial response setup
 
-        ::uint64_t restSize = _beyondLastByte - _offset;
-        ::uint64_t pieceSize = std::min(restSize, static_cast<::uint64_t>(_chunkSize));
+        const ::uint64_t restSize{ _beyondLastByte - _offset };
+        const ::uint64_t pieceSize{ std::min(restSize, static_cast<::uint64_t>(chunkSize)) };
+
+        // Let the kernel fetch the next chunks while this one is being sent
+        if (restSize > pieceSize)
+            _reader.adviseWillNeed(_offset + pieceSize, std::min(restSize - pieceSize, static_cast<::uint64_t>(readAheadSize)));
 
-        std::vector<char> buf(pieceSize);
+        const std::span<char> buffer{ getThreadChunkBuffer(static_cast<std::size_t>(pieceSize)) };
 
-        _ifs.read(buf.data(), buf.size());
-        const ::uint64_t actualPieceSize{ static_cast<::uint64_t>(_ifs.gcount()) };
+        std::error_code ec;
+        const ::uint64_t actualPieceSize{ _reader.read(_offset, buffer, ec) };
         if (actualPieceSize > 0)
         {
-            response.out().write(buf.data(), actualPieceSize);
+            response.out().write(buffer.data(), static_cast<std::streamsize>(actualPieceSize));
             LMS_LOG(UTILS, DEBUG, "Written " << actualPieceSize << " bytes, range = " << _offset << "-" << _offset + actualPieceSize - 1 << "");
         }
         else
             LMS_LOG(UTILS, DEBUG, "Written 0 byte");
 
-        if (!_ifs.good())
-            LMS_LOG(UTILS, WARNING, "Error reading from file!");
+        if (ec)
+            LMS_LOG(UTILS, WARNING, "Error reading from file: " << ec.message());
+        else if (actualPieceSize < pieceSize)
+            LMS_LOG(UTILS, WARNING, "Error reading from file: unexpected end of file");
         else if (actualPieceSize < restSize)
         {
             _offset += actualPieceSize;
@@ -20,12 +20,13 @@
 #pragma once
 
 #include <filesystem>
-#include <fstream>
 #include <string>
 #include <string_view>
 
 #include "core/IResourceHandler.hpp"
 
+#include "FileChunkReader.hpp"
+
 namespace lms::core
 {
     class FileResourceHandler final : public IResourceHandler
@@ -37,12 +38,10 @@ namespace lms::core
         Wt::Http::ResponseContinuation* processRequest(const Wt::Http::Request& request, Wt::Http::Response& response) override;
         void abort() override {};
 
-        static constexpr std::size_t _chunkSize{ 262'144 };
-
         std::string _mimeType;
         ::uint64_t _beyondLastByte{};
         ::uint64_t _offset{};
         ::uint64_t _fileSize{};
-        std::ifstream _ifs;
+        FileChunkReader _reader;
     };
 } // namespace lms::core
\ No newline at end of file
@@ -19,6 +19,10 @@
 
 #include "JobScheduler.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
 #include <boost/asio/post.hpp>
 
 #include "core/ITraceLogger.hpp"
@@ -27,18 +31,73 @@
 
 namespace lms::core
 {
+    namespace
+    {
+        struct CurrentJobInfo
+        {
+            JobScheduler* scheduler{};
+            JobPriority priority{};
+        };
+        thread_local CurrentJobInfo currentJobInfo;
+
+        class ScopedCurrentJobInfo
+        {
+        public:
+            ScopedCurrentJobInfo(JobScheduler* scheduler, JobPriority priority)
+                : _previous{ currentJobInfo }
+            {
+                currentJobInfo = CurrentJobInfo{ scheduler, priority };
+            }
+            ~ScopedCurrentJobInfo()
+            {
+                currentJobInfo = _previous;
+            }
+            ScopedCurrentJobInfo(const ScopedCurrentJobInfo&) = delete;
+            ScopedCurrentJobInfo& operator=(const ScopedCurrentJobInfo&) = delete;
+
+        private:
+            const CurrentJobInfo _previous;
+        };
+
+        std::size_t getCurrentThreadStatsShardIndex(std::size_t shardCount)
+        {
+            static std::atomic<std::size_t> nextIndex{};
+            static thread_local const std::size_t index{ nextIndex++ };
+
+            return index % shardCount;
+        }
+    } // namespace
+
     std::unique_ptr<IJobScheduler> createJobScheduler(core::LiteralString name, std::size_t threadCount)
     {
         return std::make_unique<JobScheduler>(name, threadCount);
     }
 
+    void yieldToInteractiveJobs()
+    {
+        const CurrentJobInfo jobInfo{ currentJobInfo };
+        if (!jobInfo.scheduler || jobInfo.priority != JobPriority::Background)
+            return;
+
+        while (jobInfo.scheduler->runPendingInteractiveJob())
+            ;
+    }
+
     JobScheduler::JobScheduler(core::LiteralString name, std::size_t threadCount)
         : _name{ name }
         , _ioContextRunner{ _ioContext, threadCount, name.str() }
     {
     }
 
-    JobScheduler::~JobScheduler() = default;
+    JobScheduler::~JobScheduler()
+    {
+        // worker threads must not access the queues past this point
+        _ioContextRunner.wait();
+
+        DoneJobNode* node{ _doneJobsHead.exchange(nullptr) };
+        while (node)
+            delete std::exchange(node, node->next);
+    }
 
     void JobScheduler::setShouldAbortCallback(ShouldAbortCallback callback)
     {
@@ -50,44 +109,109 @@ namespace lms::core
         return _ioContextRunner.getThreadCount();
     }
 
-    void JobScheduler::scheduleJob(std::unique_ptr<IJob> job)
+    void JobScheduler::scheduleJob(std::unique_ptr<IJob> job, JobPriority priority)
     {
+        _ongoingJobCount += 1;
+
         {
-            std::scoped_lock lock{ _mutex };
-            _ongoingJobCount += 1;
+            std::scoped_lock lock{ _pendingJobsMutex };
+            auto& pendingJobs{ priority == JobPriority::Interactive ? _pendingInteractiveJobs : _pendingBackgroundJobs };
+            pendingJobs.emplace_back(PendingJob{ std::move(job), priority, clock::now() });
         }
 
-        auto jobHandler{ [job = std::move(job), this]() mutable {
-            if (_abortCallback && _abortCallback())
+        // Each handler runs the most urgent pending job, not necessarily the one that has just been scheduled
+        // Some handlers may find nothing to do, if the job was already run by a yielding thread
+        boost::asio::post(_ioContext, [this] {
+            PendingJob pendingJob;
+            if (popPendingJob(pendingJob, false /* interactiveOnly */))
+                runPendingJob(pendingJob);
+        });
+    }
+
+    bool JobScheduler::runPendingInteractiveJob()
+    {
+        PendingJob pendingJob;
+        if (!popPendingJob(pendingJob, true /* interactiveOnly */))
+            return false;
+
+        runPendingJob(pendingJob);
+        return true;
+    }
+
+    bool JobScheduler::popPendingJob(PendingJob& pendingJob, bool interactiveOnly)
+    {
+        std::scoped_lock lock{ _pendingJobsMutex };
+
+        std::deque<PendingJob>* pendingJobs{};
+        if (!_pendingInteractiveJobs.empty())
+            pendingJobs = &_pendingInteractiveJobs;
+        else if (!interactiveOnly && !_pendingBackgroundJobs.empty())
+            pendingJobs = &_pendingBackgroundJobs;
+        else
+            return false;
+
+        pendingJob = std::move(pendingJobs->front());
+        pendingJobs->pop_front();
+        return true;
+    }
+
+    void JobScheduler::runPendingJob(PendingJob& pendingJob)
+    {
+        if (_abortCallback && _abortCallback())
+        {
+            pendingJob.job.reset();
+            onJobCompleted(false /* done */);
+        }
+        else
+        {
+            const clock::time_point startTime{ clock::now() };
             {
-                std::scoped_lock lock{ _mutex };
-                _ongoingJobCount -= 1;
+                ScopedCurrentJobInfo scopedJobInfo{ this, pendingJob.priority };
+                LMS_SCOPED_TRACE_OVERVIEW(_name, pendingJob.job->getName());
+                pendingJob.job->run();
             }
-            else
-            {
-                {
-                    LMS_SCOPED_TRACE_OVERVIEW(_name, job->getName());
-                    job->run();
-                }
+            recordJobStats(pendingJob.job->getName(), pendingJob.scheduleTime, startTime, clock::now());
 
-                {
-                    std::scoped_lock lock{ _mutex };
+            pushDoneJob(std::move(pendingJob.job));
+            onJobCompleted(true /* done */);
+        }
+    }
 
-                    _doneJobs.emplace_back(std::move(job));
-                    _ongoingJobCount -= 1;
-                }
-            }
+    void JobScheduler::pushDoneJob(std::unique_ptr<IJob> job)
+    {
+        // counted first so that the consumer never pops more than what was counted
+        _doneJobCount += 1;
 
-            _condVar.notify_all();
-        } };
+        DoneJobNode* node{ new DoneJobNode{ std::move(job), _doneJobsHead.load(std::memory_order_relaxed) } };
+        while (!_doneJobsHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    void JobScheduler::onJobCompleted(bool done)
+    {
+        const std::size_t ongoingJobCount{ --_ongoingJobCount };
 
-        boost::asio::post(_ioContext, std::move(jobHandler));
+        // Waking up the waiting thread for each job would cost way more than the tiny jobs themselves
+        if (static_cast<std::int64_t>(ongoingJobCount) <= _wakeUpOngoingJobCount || (done && _wakeUpOnJobDone))
+        {
+            // locking makes sure the waiting thread is either already waiting, or has not checked its condition yet
+            {
+                std::scoped_lock lock{ _wakeUpMutex };
+            }
+            _wakeUpCondVar.notify_one();
+        }
+    }
+
+    template<typename Predicate>
+    void JobScheduler::waitForWakeUp(Predicate predicate)
+    {
+        std::unique_lock lock{ _wakeUpMutex };
+        _wakeUpCondVar.wait(lock, predicate);
     }
 
     std::size_t JobScheduler::getJobsDoneCount() const
     {
-        std::scoped_lock lock{ _mutex };
-        return _doneJobs.size();
+        return _doneJobCount;
     }
 
     size_t JobScheduler::popJobsDone(std::vector<std::unique_ptr<IJob>>& doneJobs, std::size_t maxCount)
@@ -95,16 +219,28 @@ namespace lms::core
         doneJobs.clear();
         doneJobs.reserve(maxCount);
 
+        if (_flushedDoneJobs.size() < maxCount)
         {
-            std::scoped_lock lock{ _mutex };
-
-            while (doneJobs.size() < maxCount && !_doneJobs.empty())
+            // The stack is in reverse completion order
+            DoneJobNode* node{ _doneJobsHead.exchange(nullptr, std::memory_order_acquire) };
+            const std::size_t flushedCount{ _flushedDoneJobs.size() };
+            while (node)
             {
-                doneJobs.push_back(std::move(_doneJobs.front()));
-                _doneJobs.pop_front();
+                _flushedDoneJobs.push_back(std::move(node->job));
+                delete std::exchange(node, node->next);
             }
+            std::reverse(std::next(std::begin(_flushedDoneJobs), flushedCount), std::end(_flushedDoneJobs));
         }
 
+        while (doneJobs.size() < maxCount && !_flushedDoneJobs.empty())
+        {
+            doneJobs.push_back(std::move(_flushedDoneJobs.front()));
+            _flushedDoneJobs.pop_front();
+        }
+
+        assert(_doneJobCount >= doneJobs.size());
+        _doneJobCount -= doneJobs.size();
+
         return doneJobs.size();
     }
 
@@ -116,14 +252,93 @@ namespace lms::core
         {
             LMS_SCOPED_TRACE_OVERVIEW(_name, "WaitJobs");
 
-            std::unique_lock lock{ _mutex };
-            _condVar.wait(lock, [=, this] { return _ongoingJobCount <= maxOngoingJobs; });
+            _wakeUpOngoingJobCount = static_cast<std::int64_t>(maxOngoingJobs);
+            waitForWakeUp([=, this] { return _ongoingJobCount <= maxOngoingJobs; });
+            _wakeUpOngoingJobCount = -1;
         }
     }
 
+    void JobScheduler::waitUntilAnyJobDone()
+    {
+        LMS_SCOPED_TRACE_OVERVIEW(_name, "WaitJobs");
+
+        _wakeUpOngoingJobCount = 0;
+        _wakeUpOnJobDone = true;
+        waitForWakeUp([this] { return _doneJobCount > 0 || _ongoingJobCount == 0; });
+        _wakeUpOnJobDone = false;
+        _wakeUpOngoingJobCount = -1;
+    }
+
     void JobScheduler::wait()
     {
         waitUntilJobCountAtMost(0);
     }
 
+    void JobScheduler::recordJobStats(core::LiteralString name, clock::time_point scheduleTime, clock::time_point startTime, clock::time_point endTime)
+    {
+        StatsShard& shard{ _statsShards[getCurrentThreadStatsShardIndex(_statsShards.size())] };
+
+        const clock::duration waitDuration{ startTime - scheduleTime };
+        const clock::duration runDuration{ endTime - startTime };
+
+        std::scoped_lock lock{ shard.mutex };
+
+        RawJobStats& stats{ shard.stats[name.c_str()] };
+        stats.name = name;
+        stats.runCount += 1;
+        stats.totalRunDuration += runDuration;
+        stats.maxRunDuration = std::max(stats.maxRunDuration, runDuration);
+        stats.totalWaitDuration += waitDuration;
+        stats.maxWaitDuration = std::max(stats.maxWaitDuration, waitDuration);
+        stats.firstScheduleTime = std::min(stats.firstScheduleTime, scheduleTime);
+        stats.lastDoneTime = std::max(stats.lastDoneTime, endTime);
+    }
+
+    void JobScheduler::visitJobStats(const JobStatsVisitor& visitor) const
+    {
+        std::unordered_map<core::LiteralString, RawJobStats, core::LiteralStringHash, core::LiteralStringEqual> mergedStats;
+
+        for (const StatsShard& shard : _statsShards)
+        {
+            std::scoped_lock lock{ shard.mutex };
+
+            for (const auto& [namePtr, stats] : shard.stats)
+            {
+                RawJobStats& mergedStat{ mergedStats[stats.name] };
+                mergedStat.runCount += stats.runCount;
+                mergedStat.totalRunDuration += stats.totalRunDuration;
+                mergedStat.maxRunDuration = std::max(mergedStat.maxRunDuration, stats.maxRunDuration);
+                mergedStat.totalWaitDuration += stats.totalWaitDuration;
+                mergedStat.maxWaitDuration = std::max(mergedStat.maxWaitDuration, stats.maxWaitDuration);
+                mergedStat.firstScheduleTime = std::min(mergedStat.firstScheduleTime, stats.firstScheduleTime);
+                mergedStat.lastDoneTime = std::max(mergedStat.lastDoneTime, stats.lastDoneTime);
+            }
+        }
+
+        for (const auto& [name, stats] : mergedStats)
+        {
+            JobStats jobStats;
+            jobStats.name = name;
+            jobStats.runCount = stats.runCount;
+            jobStats.totalRunDuration = stats.totalRunDuration;
+            jobStats.maxRunDuration = stats.maxRunDuration;
+            jobStats.totalWaitDuration = stats.totalWaitDuration;
+            jobStats.maxWaitDuration = stats.maxWaitDuration;
+
+            const std::chrono::duration<float> activeDuration{ stats.lastDoneTime - stats.firstScheduleTime };
+            if (activeDuration.count() > 0)
+                jobStats.throughput = static_cast<float>(stats.runCount) / activeDuration.count();
+
+            visitor(jobStats);
+        }
+    }
+
+    void JobScheduler::resetJobStats()
+    {
+        for (StatsShard& shard : _statsShards)
+        {
+            std::scoped_lock lock{ shard.mutex };
+            shard.stats.clear();
+        }
+    }
 } // namespace lms::core
@@ -17,10 +17,14 @@
  * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <mutex>
+#include <unordered_map>
 
 #include "core/IJobScheduler.hpp"
 #include "core/IOContextRunner.hpp"
@@ -35,27 +39,87 @@ namespace lms::core
         JobScheduler(const JobScheduler&) = delete;
         JobScheduler& operator=(const JobScheduler&) = delete;
 
+        // Returns false if there is no pending interactive job
+        bool runPendingInteractiveJob();
+
     private:
         void setShouldAbortCallback(ShouldAbortCallback callback) override;
 
         std::size_t getThreadCount() const override;
-        void scheduleJob(std::unique_ptr<IJob> job) override;
+        void scheduleJob(std::unique_ptr<IJob> job, JobPriority priority) override;
 
         std::size_t getJobsDoneCount() const override;
         size_t popJobsDone(std::vector<std::unique_ptr<IJob>>& jobs, std::size_t maxCount) override;
 
         void waitUntilJobCountAtMost(std::size_t maxOngoingJobs) override;
+        void waitUntilAnyJobDone() override;
         void wait() override;
 
+        void visitJobStats(const JobStatsVisitor& visitor) const override;
+        void resetJobStats() override;
+
+        using clock = std::chrono::steady_clock;
+        struct PendingJob
+        {
+            std::unique_ptr<IJob> job;
+            JobPriority priority{};
+            clock::time_point scheduleTime;
+        };
+        bool popPendingJob(PendingJob& pendingJob, bool interactiveOnly);
+        void runPendingJob(PendingJob& pendingJob);
+        void pushDoneJob(std::unique_ptr<IJob> job);
+        void onJobCompleted(bool done);
+        template<typename Predicate>
+        void waitForWakeUp(Predicate predicate);
+
+        struct RawJobStats
+        {
+            core::LiteralString name;
+            std::size_t runCount{};
+            clock::duration totalRunDuration{};
+            clock::duration maxRunDuration{};
+            clock::duration totalWaitDuration{};
+            clock::duration maxWaitDuration{};
+            clock::time_point firstScheduleTime{ clock::time_point::max() };
+            clock::time_point lastDoneTime{};
+        };
+        void recordJobStats(core::LiteralString name, clock::time_point scheduleTime, clock::time_point startTime, clock::time_point endTime);
+
         core::LiteralString _name;
         boost::asio::io_context _ioContext;
         core::IOContextRunner _ioContextRunner;
 
         ShouldAbortCallback _abortCallback;
 
-        mutable std::mutex _mutex;
         std::atomic<std::size_t> _ongoingJobCount;
-        std::deque<std::unique_ptr<IJob>> _doneJobs;
-        std::condition_variable _condVar;
+
+        // Set by the waiting thread, so that the worker threads only wake it up when its condition may be met
+        std::atomic<std::int64_t> _wakeUpOngoingJobCount{ -1 }; // as soon as the ongoing job count is at most this value
+        std::atomic<bool> _wakeUpOnJobDone{};
+        std::mutex _wakeUpMutex;
+        std::condition_variable _wakeUpCondVar;
+
+        std::mutex _pendingJobsMutex;
+        std::deque<PendingJob> _pendingInteractiveJobs;
+        std::deque<PendingJob> _pendingBackgroundJobs;
+
+        // Lock-free stack, pushed by the worker threads and flushed at once by the single consumer
+        struct DoneJobNode
+        {
+            std::unique_ptr<IJob> job;
+            DoneJobNode* next{};
+        };
+        std::atomic<DoneJobNode*> _doneJobsHead{};
+        std::atomic<std::size_t> _doneJobCount;
+        std::deque<std::unique_ptr<IJob>> _flushedDoneJobs; // only accessed by the consumer
+
+        // Sharded to avoid contention between worker threads
+        static constexpr std::size_t statsShardCount{ 8 };
+        struct alignas(64) StatsShard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<const char*, RawJobStats> stats; // job names are literals: cheaper to compare addresses
+        };
+        std::array<StatsShard, statsShardCount> _statsShards;
     };
-} // namespace lms::core
\ No newline at end of file
+} // namespace lms::core
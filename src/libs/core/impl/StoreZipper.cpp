@@ -0,0 +1,534 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StoreZipper.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <iomanip>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <system_error>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+#include "core/Crc32Calculator.hpp"
+#include "core/ILogger.hpp"
+#include "core/XxHash3.hpp"
+
+namespace lms::zip
+{
+    std::unique_ptr<IZipper> createStoreZipper(const EntryContainer& entries)
+    {
+        return std::make_unique<StoreZipper>(entries);
+    }
+
+    class FileException : public Exception
+    {
+    public:
+        FileException(const std::filesystem::path& p, std::string_view message)
+            : Exception{ "File '" + p.string() + "': " + std::string{ message } }
+        {
+        }
+    };
+
+    class FileStdException : public FileException
+    {
+    public:
+        FileStdException(const std::filesystem::path& p, std::string_view message, int err)
+            : FileException{ p, std::string{ message } + ": " + std::error_code{ err, std::generic_category() }.message() }
+        {
+        }
+    };
+
+    namespace
+    {
+        constexpr std::uint32_t localFileHeaderSignature{ 0x04034b50 };
+        constexpr std::uint32_t dataDescriptorSignature{ 0x08074b50 };
+        constexpr std::uint32_t centralDirectoryHeaderSignature{ 0x02014b50 };
+        constexpr std::uint32_t zip64EndOfCentralDirectorySignature{ 0x06064b50 };
+        constexpr std::uint32_t zip64EndOfCentralDirectoryLocatorSignature{ 0x07064b50 };
+        constexpr std::uint32_t endOfCentralDirectorySignature{ 0x06054b50 };
+
+        constexpr std::uint16_t zip64ExtraFieldId{ 0x0001 };
+        constexpr std::uint16_t versionNeededDefault{ 20 }; // data descriptors
+        constexpr std::uint16_t versionNeededZip64{ 45 };
+        constexpr std::uint16_t versionMadeBy{ (3 << 8) | versionNeededZip64 }; // unix
+        constexpr std::uint16_t dataDescriptorFlag{ 1 << 3 };
+        constexpr std::uint16_t utf8FileNameFlag{ 1 << 11 };
+        constexpr std::uint16_t generalPurposeFlags{ dataDescriptorFlag | utf8FileNameFlag };
+        constexpr std::uint16_t storeCompressionMethod{ 0 };
+
+        constexpr std::size_t localFileHeaderSize{ 30 };
+        constexpr std::size_t dataDescriptorSize{ 16 };
+        constexpr std::size_t zip64DataDescriptorSize{ 24 };
+        constexpr std::size_t centralDirectoryHeaderSize{ 46 };
+        constexpr std::size_t zip64EndOfCentralDirectorySize{ 56 };
+        constexpr std::size_t zip64EndOfCentralDirectoryLocatorSize{ 20 };
+        constexpr std::size_t endOfCentralDirectorySize{ 22 };
+
+        constexpr std::uint64_t max16{ 0xFFFF };
+        constexpr std::uint64_t max32{ 0xFFFFFFFF };
+
+        // to be changed whenever the archive layout changes, so that resumed downloads do not mix layouts
+        constexpr std::uint32_t layoutVersion{ 2 };
+
+        void writeLE16(std::string& output, std::uint64_t value)
+        {
+            assert(value <= max16);
+            for (std::size_t i{}; i < 2; ++i)
+                output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+
+        void writeLE32(std::string& output, std::uint64_t value)
+        {
+            assert(value <= max32);
+            for (std::size_t i{}; i < 4; ++i)
+                output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+
+        void writeLE64(std::string& output, std::uint64_t value)
+        {
+            for (std::size_t i{}; i < 8; ++i)
+                output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+
+        bool needsZip64Sizes(std::uint64_t fileSize)
+        {
+            return fileSize >= max32;
+        }
+
+        std::size_t getLocalHeaderExtraSize(std::uint64_t fileSize)
+        {
+            return needsZip64Sizes(fileSize) ? 4 + 2 * 8 : 0;
+        }
+
+        std::size_t getDataDescriptorSize(std::uint64_t fileSize)
+        {
+            // sizes are 8 bytes long if the local header has a zip64 extra field
+            return needsZip64Sizes(fileSize) ? zip64DataDescriptorSize : dataDescriptorSize;
+        }
+
+        std::size_t getCentralDirectoryHeaderExtraSize(std::uint64_t fileSize, std::uint64_t localHeaderOffset)
+        {
+            std::size_t fieldCount{};
+            if (needsZip64Sizes(fileSize))
+                fieldCount += 2;
+            if (localHeaderOffset >= max32)
+                fieldCount += 1;
+
+            return fieldCount > 0 ? 4 + fieldCount * 8 : 0;
+        }
+
+        bool needsZip64EndOfCentralDirectory(std::size_t entryCount, std::uint64_t centralDirectoryOffset, std::uint64_t centralDirectorySize)
+        {
+            return entryCount >= max16 || centralDirectoryOffset >= max32 || centralDirectorySize >= max32;
+        }
+
+        void writeDosDateTime(std::string& output, std::time_t time)
+        {
+            std::tm tm{};
+            if (!::localtime_r(&time, &tm) || tm.tm_year < 80)
+            {
+                // earliest representable date
+                writeLE16(output, 0);
+                writeLE16(output, (1 << 5) | 1);
+                return;
+            }
+            if (tm.tm_year - 80 > 127)
+            {
+                // latest representable date (the year is stored on 7 bits), 2107-12-31 23:59:58
+                writeLE16(output, (23 << 11) | (59 << 5) | 29);
+                writeLE16(output, (127 << 9) | (12 << 5) | 31);
+                return;
+            }
+
+            writeLE16(output, static_cast<std::uint64_t>((tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2)));
+            writeLE16(output, static_cast<std::uint64_t>(((tm.tm_year - 80) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday));
+        }
+
+        // CRCs are costly to compute and do not depend on the archive: share them across downloads
+        class Crc32Cache
+        {
+        public:
+            std::optional<std::uint32_t> get(const std::filesystem::path& path, std::uint64_t fileSize, std::time_t lastWriteTime)
+            {
+                const std::scoped_lock lock{ _mutex };
+
+                const auto it{ _entries.find(path.string()) };
+                if (it == std::cend(_entries) || it->second.fileSize != fileSize || it->second.lastWriteTime != lastWriteTime)
+                    return std::nullopt;
+
+                return it->second.crc32;
+            }
+
+            void set(const std::filesystem::path& path, std::uint64_t fileSize, std::time_t lastWriteTime, std::uint32_t crc32)
+            {
+                const std::scoped_lock lock{ _mutex };
+
+                if (_entries.size() >= maxEntryCount)
+                    _entries.clear();
+
+                _entries[path.string()] = CacheEntry{ .fileSize = fileSize, .lastWriteTime = lastWriteTime, .crc32 = crc32 };
+            }
+
+        private:
+            static constexpr std::size_t maxEntryCount{ 20'000 };
+
+            struct CacheEntry
+            {
+                std::uint64_t fileSize;
+                std::time_t lastWriteTime;
+                std::uint32_t crc32;
+            };
+
+            std::mutex _mutex;
+            std::unordered_map<std::string, CacheEntry> _entries;
+        };
+
+        Crc32Cache& getCrc32Cache()
+        {
+            static Crc32Cache cache;
+            return cache;
+        }
+
+        template<typename T>
+        void hashValue(core::XxHash3_64& hasher, const T& value)
+        {
+            hasher.update(std::as_bytes(std::span{ &value, 1 }));
+        }
+    } // namespace
+
+    StoreZipper::StoreZipper(const EntryContainer& entries)
+        : _readBuffer(_readBufferSize)
+    {
+        core::XxHash3_64 hasher;
+        hashValue(hasher, layoutVersion);
+
+        std::uint64_t offset{};
+        std::uint64_t centralDirectorySize{};
+
+        _entries.reserve(entries.size());
+        for (const Entry& entry : entries)
+        {
+            struct stat fileStat;
+            if (::stat(entry.filePath.c_str(), &fileStat) == -1)
+                throw FileStdException{ entry.filePath, "cannot stat file", errno };
+
+            if (!S_ISREG(fileStat.st_mode))
+                throw FileException{ entry.filePath, "not a regular file" };
+
+            EntryLayout& layout{ _entries.emplace_back() };
+            layout.fileName = entry.fileName;
+            layout.filePath = entry.filePath;
+            layout.fileSize = static_cast<std::uint64_t>(fileStat.st_size);
+            layout.lastWriteTime = fileStat.st_mtime;
+            layout.mode = static_cast<std::uint32_t>(fileStat.st_mode);
+            layout.localHeaderOffset = offset;
+            layout.dataOffset = offset + localFileHeaderSize + layout.fileName.size() + getLocalHeaderExtraSize(layout.fileSize);
+            layout.dataDescriptorOffset = layout.dataOffset + layout.fileSize;
+
+            offset = layout.dataDescriptorOffset + getDataDescriptorSize(layout.fileSize);
+            centralDirectorySize += centralDirectoryHeaderSize + layout.fileName.size() + getCentralDirectoryHeaderExtraSize(layout.fileSize, layout.localHeaderOffset);
+
+            hasher.update(std::as_bytes(std::span{ layout.fileName }));
+            hashValue(hasher, layout.fileSize);
+            hashValue(hasher, layout.lastWriteTime);
+        }
+
+        _centralDirectoryOffset = offset;
+        _totalSize = _centralDirectoryOffset + centralDirectorySize + endOfCentralDirectorySize;
+        if (needsZip64EndOfCentralDirectory(_entries.size(), _centralDirectoryOffset, centralDirectorySize))
+            _totalSize += zip64EndOfCentralDirectorySize + zip64EndOfCentralDirectoryLocatorSize;
+
+        std::ostringstream etag;
+        etag << '"' << std::hex << std::setw(16) << std::setfill('0') << hasher.digest() << '"';
+        _etag = etag.str();
+    }
+
+    std::uint64_t StoreZipper::writeSome(std::ostream& output, std::uint64_t offset, std::uint64_t maxSize)
+    {
+        std::uint64_t totalWritten{};
+
+        auto writeSlice{ [&](const std::string& data, std::uint64_t dataOffset) {
+            const std::uint64_t offsetInData{ offset - dataOffset };
+            assert(offsetInData < data.size());
+            const std::uint64_t size{ std::min<std::uint64_t>(data.size() - offsetInData, maxSize - totalWritten) };
+
+            output.write(data.data() + offsetInData, static_cast<std::streamsize>(size));
+            return size;
+        } };
+
+        while (totalWritten < maxSize && offset < _totalSize)
+        {
+            std::uint64_t written{};
+
+            if (offset >= _centralDirectoryOffset)
+            {
+                written = writeSlice(getCentralDirectory(), _centralDirectoryOffset);
+            }
+            else
+            {
+                // last entry starting before offset
+                const auto itEntry{ std::prev(std::upper_bound(std::cbegin(_entries), std::cend(_entries), offset, [](std::uint64_t value, const EntryLayout& entry) { return value < entry.localHeaderOffset; })) };
+                const std::size_t entryIndex{ static_cast<std::size_t>(std::distance(std::cbegin(_entries), itEntry)) };
+                EntryLayout& entry{ _entries[entryIndex] };
+
+                if (offset < entry.dataOffset)
+                    written = writeSlice(createLocalHeader(entry), entry.localHeaderOffset);
+                else if (offset < entry.dataDescriptorOffset)
+                    written = writeFileData(output, entryIndex, offset - entry.dataOffset, std::min<std::uint64_t>(entry.dataDescriptorOffset - offset, maxSize - totalWritten));
+                else
+                    written = writeSlice(createDataDescriptor(entry), entry.dataDescriptorOffset);
+            }
+
+            if (!output)
+                throw Exception{ "Failed to write " + std::to_string(written) + " bytes in archive output!" };
+
+            offset += written;
+            totalWritten += written;
+        }
+
+        return totalWritten;
+    }
+
+    std::uint32_t StoreZipper::getCrc32(EntryLayout& entry)
+    {
+        if (entry.crc32)
+            return *entry.crc32;
+
+        // Only when the file data was not entirely written by this zipper (range requests): read the whole file
+
+        entry.crc32 = getCrc32Cache().get(entry.filePath, entry.fileSize, entry.lastWriteTime);
+        if (entry.crc32)
+            return *entry.crc32;
+
+        core::FileChunkReader reader{ entry.filePath };
+        if (!reader.isOpen())
+            throw FileStdException{ entry.filePath, "cannot open file", errno };
+        if (reader.getFileSize() != entry.fileSize)
+            throw FileException{ entry.filePath, "size changed" };
+
+        reader.adviseSequentialRead(0, entry.fileSize);
+
+        core::Crc32Calculator crc32Calculator;
+        for (std::uint64_t offset{}; offset < entry.fileSize;)
+        {
+            std::error_code ec;
+            const std::size_t readSize{ reader.read(offset, std::span{ _readBuffer.data(), static_cast<std::size_t>(std::min<std::uint64_t>(_readBuffer.size(), entry.fileSize - offset)) }, ec) };
+            if (ec)
+                throw FileException{ entry.filePath, "read failed: " + ec.message() };
+            if (readSize == 0)
+                throw FileException{ entry.filePath, "size changed" };
+
+            crc32Calculator.processBytes(reinterpret_cast<const std::byte*>(_readBuffer.data()), readSize);
+            offset += readSize;
+        }
+
+        entry.crc32 = crc32Calculator.getResult();
+        getCrc32Cache().set(entry.filePath, entry.fileSize, entry.lastWriteTime, *entry.crc32);
+
+        return *entry.crc32;
+    }
+
+    std::string StoreZipper::createLocalHeader(const EntryLayout& entry)
+    {
+        const bool zip64Sizes{ needsZip64Sizes(entry.fileSize) };
+
+        std::string header;
+        header.reserve(entry.dataOffset - entry.localHeaderOffset);
+
+        writeLE32(header, localFileHeaderSignature);
+        writeLE16(header, zip64Sizes ? versionNeededZip64 : versionNeededDefault);
+        writeLE16(header, generalPurposeFlags);
+        writeLE16(header, storeCompressionMethod);
+        writeDosDateTime(header, entry.lastWriteTime);
+        writeLE32(header, 0); // CRC, in the data descriptor
+        writeLE32(header, 0); // compressed size, in the data descriptor
+        writeLE32(header, 0); // uncompressed size, in the data descriptor
+        writeLE16(header, entry.fileName.size());
+        writeLE16(header, getLocalHeaderExtraSize(entry.fileSize));
+        header += entry.fileName;
+        if (zip64Sizes)
+        {
+            // only there to tell readers that the data descriptor has 8-byte sizes
+            writeLE16(header, zip64ExtraFieldId);
+            writeLE16(header, 2 * 8);
+            writeLE64(header, 0);
+            writeLE64(header, 0);
+        }
+
+        assert(header.size() == entry.dataOffset - entry.localHeaderOffset);
+        return header;
+    }
+
+    std::string StoreZipper::createDataDescriptor(EntryLayout& entry)
+    {
+        std::string dataDescriptor;
+        dataDescriptor.reserve(getDataDescriptorSize(entry.fileSize));
+
+        writeLE32(dataDescriptor, dataDescriptorSignature);
+        writeLE32(dataDescriptor, getCrc32(entry));
+        if (needsZip64Sizes(entry.fileSize))
+        {
+            writeLE64(dataDescriptor, entry.fileSize); // compressed size
+            writeLE64(dataDescriptor, entry.fileSize); // uncompressed size
+        }
+        else
+        {
+            writeLE32(dataDescriptor, entry.fileSize); // compressed size
+            writeLE32(dataDescriptor, entry.fileSize); // uncompressed size
+        }
+
+        assert(dataDescriptor.size() == getDataDescriptorSize(entry.fileSize));
+        return dataDescriptor;
+    }
+
+    const std::string& StoreZipper::getCentralDirectory()
+    {
+        if (!_centralDirectory.empty())
+            return _centralDirectory;
+
+        std::string& centralDirectory{ _centralDirectory };
+
+        for (EntryLayout& entry : _entries)
+        {
+            const bool zip64Sizes{ needsZip64Sizes(entry.fileSize) };
+            const bool zip64Offset{ entry.localHeaderOffset >= max32 };
+            const std::size_t extraSize{ getCentralDirectoryHeaderExtraSize(entry.fileSize, entry.localHeaderOffset) };
+
+            writeLE32(centralDirectory, centralDirectoryHeaderSignature);
+            writeLE16(centralDirectory, versionMadeBy);
+            writeLE16(centralDirectory, (zip64Sizes || zip64Offset) ? versionNeededZip64 : versionNeededDefault);
+            writeLE16(centralDirectory, generalPurposeFlags);
+            writeLE16(centralDirectory, storeCompressionMethod);
+            writeDosDateTime(centralDirectory, entry.lastWriteTime);
+            writeLE32(centralDirectory, getCrc32(entry));
+            writeLE32(centralDirectory, zip64Sizes ? max32 : entry.fileSize); // compressed size
+            writeLE32(centralDirectory, zip64Sizes ? max32 : entry.fileSize); // uncompressed size
+            writeLE16(centralDirectory, entry.fileName.size());
+            writeLE16(centralDirectory, extraSize);
+            writeLE16(centralDirectory, 0); // comment length
+            writeLE16(centralDirectory, 0); // disk number
+            writeLE16(centralDirectory, 0); // internal attributes
+            writeLE32(centralDirectory, static_cast<std::uint64_t>(entry.mode) << 16); // external attributes
+            writeLE32(centralDirectory, zip64Offset ? max32 : entry.localHeaderOffset);
+            centralDirectory += entry.fileName;
+            if (extraSize > 0)
+            {
+                writeLE16(centralDirectory, zip64ExtraFieldId);
+                writeLE16(centralDirectory, extraSize - 4);
+                if (zip64Sizes)
+                {
+                    writeLE64(centralDirectory, entry.fileSize);
+                    writeLE64(centralDirectory, entry.fileSize);
+                }
+                if (zip64Offset)
+                    writeLE64(centralDirectory, entry.localHeaderOffset);
+            }
+        }
+
+        const std::uint64_t centralDirectorySize{ centralDirectory.size() };
+        const bool zip64End{ needsZip64EndOfCentralDirectory(_entries.size(), _centralDirectoryOffset, centralDirectorySize) };
+        if (zip64End)
+        {
+            const std::uint64_t zip64EndOfCentralDirectoryOffset{ _centralDirectoryOffset + centralDirectorySize };
+
+            writeLE32(centralDirectory, zip64EndOfCentralDirectorySignature);
+            writeLE64(centralDirectory, zip64EndOfCentralDirectorySize - 12); // size of the remaining record
+            writeLE16(centralDirectory, versionMadeBy);
+            writeLE16(centralDirectory, versionNeededZip64);
+            writeLE32(centralDirectory, 0); // disk number
+            writeLE32(centralDirectory, 0); // disk with the central directory
+            writeLE64(centralDirectory, _entries.size());
+            writeLE64(centralDirectory, _entries.size());
+            writeLE64(centralDirectory, centralDirectorySize);
+            writeLE64(centralDirectory, _centralDirectoryOffset);
+
+            writeLE32(centralDirectory, zip64EndOfCentralDirectoryLocatorSignature);
+            writeLE32(centralDirectory, 0); // disk with the zip64 end of central directory
+            writeLE64(centralDirectory, zip64EndOfCentralDirectoryOffset);
+            writeLE32(centralDirectory, 1); // total number of disks
+        }
+
+        writeLE32(centralDirectory, endOfCentralDirectorySignature);
+        writeLE16(centralDirectory, 0); // disk number
+        writeLE16(centralDirectory, 0); // disk with the central directory
+        writeLE16(centralDirectory, std::min<std::uint64_t>(_entries.size(), max16));
+        writeLE16(centralDirectory, std::min<std::uint64_t>(_entries.size(), max16));
+        writeLE32(centralDirectory, std::min<std::uint64_t>(centralDirectorySize, max32));
+        writeLE32(centralDirectory, std::min<std::uint64_t>(_centralDirectoryOffset, max32));
+        writeLE16(centralDirectory, 0); // comment length
+
+        assert(_centralDirectoryOffset + centralDirectory.size() == _totalSize);
+        return centralDirectory;
+    }
+
+    std::uint64_t StoreZipper::writeFileData(std::ostream& output, std::size_t entryIndex, std::uint64_t offsetInFile, std::uint64_t size)
+    {
+        EntryLayout& entry{ _entries[entryIndex] };
+
+        if (!_currentReader || _currentReaderEntryIndex != entryIndex)
+        {
+            _currentReader = std::make_unique<core::FileChunkReader>(entry.filePath);
+            _currentReaderEntryIndex = entryIndex;
+            _currentCrc32Calculator = core::Crc32Calculator{};
+            _currentCrc32Offset = 0;
+
+            if (!_currentReader->isOpen())
+                throw FileStdException{ entry.filePath, "cannot open file", errno };
+            if (_currentReader->getFileSize() != entry.fileSize)
+                throw FileException{ entry.filePath, "size changed" };
+
+            _currentReader->adviseSequentialRead(offsetInFile, entry.fileSize - offsetInFile);
+        }
+
+        std::uint64_t totalRead{};
+        while (totalRead < size)
+        {
+            std::error_code ec;
+            const std::size_t readSize{ _currentReader->read(offsetInFile + totalRead, std::span{ _readBuffer.data(), static_cast<std::size_t>(std::min<std::uint64_t>(_readBuffer.size(), size - totalRead)) }, ec) };
+            if (ec)
+                throw FileException{ entry.filePath, "read failed: " + ec.message() };
+            if (readSize == 0)
+                throw FileException{ entry.filePath, "size changed" };
+
+            output.write(_readBuffer.data(), static_cast<std::streamsize>(readSize));
+
+            // the CRC is computed as the data is written, as long as it is written in order
+            if (!entry.crc32 && _currentCrc32Offset == offsetInFile + totalRead)
+            {
+                _currentCrc32Calculator.processBytes(reinterpret_cast<const std::byte*>(_readBuffer.data()), readSize);
+                _currentCrc32Offset += readSize;
+                if (_currentCrc32Offset == entry.fileSize)
+                {
+                    entry.crc32 = _currentCrc32Calculator.getResult();
+                    getCrc32Cache().set(entry.filePath, entry.fileSize, entry.lastWriteTime, *entry.crc32);
+                }
+            }
+
+            totalRead += readSize;
+        }
+
+        return totalRead;
+    }
+} // namespace lms::zip
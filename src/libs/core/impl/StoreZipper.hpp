@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/Crc32Calculator.hpp"
+#include "core/IZipper.hpp"
+
+#include "FileChunkReader.hpp"
+
+namespace lms::zip
+{
+    // Zip archive without compression, whose layout only depends on the entry names and sizes
+    // CRCs are written in data descriptors after each file data, so that they can be computed while the data is written
+    class StoreZipper : public IZipper
+    {
+    public:
+        StoreZipper(const EntryContainer& entries);
+        ~StoreZipper() override = default;
+        StoreZipper(const StoreZipper&) = delete;
+        StoreZipper& operator=(const StoreZipper&) = delete;
+
+    private:
+        std::uint64_t getTotalSize() const override { return _totalSize; }
+        std::string_view getETag() const override { return _etag; }
+        std::uint64_t writeSome(std::ostream& output, std::uint64_t offset, std::uint64_t maxSize) override;
+
+        struct EntryLayout
+        {
+            std::string fileName;
+            std::filesystem::path filePath;
+            std::uint64_t fileSize{};
+            std::time_t lastWriteTime{};
+            std::uint32_t mode{};
+            std::uint64_t localHeaderOffset{};
+            std::uint64_t dataOffset{};
+            std::uint64_t dataDescriptorOffset{};
+            std::optional<std::uint32_t> crc32;
+        };
+
+        std::uint32_t getCrc32(EntryLayout& entry);
+        std::string createLocalHeader(const EntryLayout& entry);
+        std::string createDataDescriptor(EntryLayout& entry);
+        const std::string& getCentralDirectory();
+        std::uint64_t writeFileData(std::ostream& output, std::size_t entryIndex, std::uint64_t offsetInFile, std::uint64_t size);
+
+        static constexpr std::size_t _readBufferSize{ 65'536 };
+
+        std::vector<EntryLayout> _entries;
+        std::uint64_t _centralDirectoryOffset{};
+        std::uint64_t _totalSize{};
+        std::string _etag;
+        std::string _centralDirectory; // up to the end of the archive, generated once all the CRCs are known
+
+        std::vector<char> _readBuffer;
+        std::size_t _currentReaderEntryIndex{};
+        std::unique_ptr<core::FileChunkReader> _currentReader;
+        core::Crc32Calculator _currentCrc32Calculator;
+        std::uint64_t _currentCrc32Offset{}; // the CRC of the current entry covers the data up to there
+    };
+} // namespace lms::zip
@@ -94,6 +94,25 @@ namespace lms::core::stringUtils
             }
         }
 
+        template<std::size_t N>
+        void appendEscapedString(std::string& output, std::string_view str, const std::pair<char, std::string_view> (&charsToEscape)[N])
+        {
+            // copy unescaped chars by runs
+            std::size_t runStart{};
+            for (std::size_t i{}; i < str.size(); ++i)
+            {
+                const char c{ str[i] };
+                auto itEntry{ std::find_if(std::cbegin(charsToEscape), std::cend(charsToEscape), [=](const auto& entry) { return entry.first == c; }) };
+                if (itEntry == std::cend(charsToEscape))
+                    continue;
+
+                output.append(str.data() + runStart, i - runStart);
+                output.append(itEntry->second);
+                runStart = i + 1;
+            }
+            output.append(str.data() + runStart, str.size() - runStart);
+        }
+
         template<typename StringType>
         std::string joinStrings(std::span<const StringType> strings, std::string_view delimiter)
         {
@@ -452,6 +471,11 @@ namespace lms::core::stringUtils
         detail::writeEscapedString(os, str, detail::jsonEscapeChars);
     }
 
+    void appendJsonEscapedString(std::string& output, std::string_view str)
+    {
+        detail::appendEscapedString(output, str, detail::jsonEscapeChars);
+    }
+
     std::string xmlEscape(std::string_view str)
     {
         return detail::escape(str, detail::xmlEscapeChars);
@@ -462,6 +486,11 @@ namespace lms::core::stringUtils
         detail::writeEscapedString(os, str, detail::xmlEscapeChars);
     }
 
+    void appendXmlEscapedString(std::string& output, std::string_view str)
+    {
+        detail::appendEscapedString(output, str, detail::xmlEscapeChars);
+    }
+
     std::string escapeString(std::string_view str, std::string_view charsToEscape, char escapeChar)
     {
         std::string res;
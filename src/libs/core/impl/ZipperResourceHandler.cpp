@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ZipperResourceHandler.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/ILogger.hpp"
+#include "core/ZipperResourceHandlerCreator.hpp"
+
+namespace lms::zip
+{
+    std::unique_ptr<core::IResourceHandler> createZipperResourceHandler(std::unique_ptr<IZipper> zipper)
+    {
+        return std::make_unique<ZipperResourceHandler>(std::move(zipper));
+    }
+
+    ZipperResourceHandler::ZipperResourceHandler(std::unique_ptr<IZipper> zipper)
+        : _zipper{ std::move(zipper) }
+    {
+    }
+
+    Wt::Http::ResponseContinuation* ZipperResourceHandler::processRequest(const Wt::Http::Request& request, Wt::Http::Response& response)
+    {
+        static constexpr std::uint64_t maxWriteSize{ 262'144 };
+
+        if (!_headersSent)
+        {
+            _headersSent = true;
+
+            const std::uint64_t totalSize{ _zipper->getTotalSize() };
+            const std::string etag{ _zipper->getETag() };
+
+            response.addHeader("Accept-Ranges", "bytes");
+            response.addHeader("ETag", etag);
+
+            // Only resume the transfer if the archive did not change in the meantime
+            const std::string ifRange{ request.headerValue("If-Range") };
+            const Wt::Http::Request::ByteRangeSpecifier ranges{ (ifRange.empty() || ifRange == etag) ? request.getRanges(totalSize) : Wt::Http::Request::ByteRangeSpecifier{} };
+            if (!ranges.isSatisfiable())
+            {
+                std::ostringstream contentRange;
+                contentRange << "bytes */" << totalSize;
+                response.setStatus(416); // Requested range not satisfiable
+                response.addHeader("Content-Range", contentRange.str());
+
+                LMS_LOG(UTILS, DEBUG, "Range not satisfiable");
+                return nullptr;
+            }
+
+            if (ranges.size() == 1)
+            {
+                LMS_LOG(UTILS, DEBUG, "Range requested = " << ranges[0].firstByte() << "-" << ranges[0].lastByte());
+
+                response.setStatus(206);
+                _offset = ranges[0].firstByte();
+                _beyondLastByte = ranges[0].lastByte() + 1;
+
+                std::ostringstream contentRange;
+                contentRange << "bytes " << _offset << "-" << _beyondLastByte - 1 << "/" << totalSize;
+
+                response.addHeader("Content-Range", contentRange.str());
+                response.setContentLength(_beyondLastByte - _offset);
+            }
+            else
+            {
+                response.setStatus(200);
+                _beyondLastByte = totalSize;
+                response.setContentLength(totalSize);
+            }
+
+            response.setMimeType("application/zip");
+        }
+
+        const std::uint64_t written{ _zipper->writeSome(response.out(), _offset, std::min(_beyondLastByte - _offset, maxWriteSize)) };
+        _offset += written;
+
+        if (written > 0 && _offset < _beyondLastByte)
+            return response.createContinuation();
+
+        LMS_LOG(UTILS, DEBUG, "Zip transfer complete!");
+        return nullptr;
+    }
+} // namespace lms::zip
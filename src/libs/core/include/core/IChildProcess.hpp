@@ -20,6 +20,7 @@
 
 #include <cstddef>
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -52,5 +53,9 @@ namespace lms::core
 
         virtual std::size_t readSome(std::byte* data, std::size_t bufferSize) = 0;
         virtual bool finished() const = 0;
+
+        // waits for the process to exit, only to be called once finished
+        // no value if the process did not exit normally (killed by a signal, etc.)
+        virtual std::optional<int> getExitCode() = 0;
     };
 } // namespace lms::core
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -28,6 +29,13 @@
 namespace lms::core
 {
     class IJob;
+
+    enum class JobPriority
+    {
+        Interactive, // always picked before background jobs
+        Background,
+    };
+
     class IJobScheduler
     {
     public:
@@ -37,14 +45,37 @@ namespace lms::core
         virtual void setShouldAbortCallback(ShouldAbortCallback callback) = 0;
 
         virtual std::size_t getThreadCount() const = 0;
-        virtual void scheduleJob(std::unique_ptr<IJob> job) = 0;
+        virtual void scheduleJob(std::unique_ptr<IJob> job, JobPriority priority = JobPriority::Background) = 0;
 
+        // Done jobs are expected to be popped and waited for by a single thread
         virtual std::size_t getJobsDoneCount() const = 0;
         virtual size_t popJobsDone(std::vector<std::unique_ptr<IJob>>& jobs, std::size_t maxCount) = 0;
 
         virtual void waitUntilJobCountAtMost(std::size_t maxOngoingJobs) = 0;
+        // Returns as soon as some jobs are done, or if there is no more ongoing job
+        virtual void waitUntilAnyJobDone() = 0;
         virtual void wait() = 0;
+
+        // Aggregated by job name, since the last reset
+        struct JobStats
+        {
+            core::LiteralString name;
+            std::size_t runCount{};
+            std::chrono::nanoseconds totalRunDuration{};
+            std::chrono::nanoseconds maxRunDuration{};
+            std::chrono::nanoseconds totalWaitDuration{}; // time spent in queue before being run
+            std::chrono::nanoseconds maxWaitDuration{};
+            float throughput{}; // jobs per second, between the first schedule and the last completion
+        };
+        using JobStatsVisitor = std::function<void(const JobStats&)>;
+        virtual void visitJobStats(const JobStatsVisitor& visitor) const = 0;
+        // Not to be called while jobs are ongoing, or their stats may be partially reset
+        virtual void resetJobStats() = 0;
     };
 
     std::unique_ptr<IJobScheduler> createJobScheduler(core::LiteralString name, std::size_t threadCount);
+
+    // To be called periodically by long running background jobs: runs the pending interactive jobs of the
+    // current scheduler, if any, on the calling thread. Does nothing if not called from a background job
+    void yieldToInteractiveJobs();
 } // namespace lms::core
\ No newline at end of file
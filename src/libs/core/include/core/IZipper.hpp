@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Exception.hpp"
@@ -40,15 +44,19 @@ namespace lms::zip
         using core::LmsException::LmsException;
     };
 
+    // Random access on an archive whose layout is computed upfront
     class IZipper
     {
     public:
         virtual ~IZipper() = default;
 
-        virtual std::uint64_t writeSome(std::ostream& output) = 0;
-        virtual bool isComplete() const = 0;
-        virtual void abort() = 0;
+        virtual std::uint64_t getTotalSize() const = 0;
+        virtual std::string_view getETag() const = 0; // changes if any entry is renamed or modified
+
+        // Writes at most maxSize bytes of the archive, starting at offset. Returns the number of bytes written
+        virtual std::uint64_t writeSome(std::ostream& output, std::uint64_t offset, std::uint64_t maxSize) = 0;
     };
 
-    std::unique_ptr<IZipper> createArchiveZipper(const EntryContainer& entries);
+    // No compression: meant for already compressed files, like audio files
+    std::unique_ptr<IZipper> createStoreZipper(const EntryContainer& entries);
 } // namespace lms::zip
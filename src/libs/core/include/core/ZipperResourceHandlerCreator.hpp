@@ -26,5 +26,6 @@
 
 namespace lms::zip
 {
-    std::unique_ptr<IResourceHandler> createZipperResourceHandler(std::unique_ptr<IZipper> zipper);
-}
+    // Handles range requests, so that downloads can be resumed
+    std::unique_ptr<core::IResourceHandler> createZipperResourceHandler(std::unique_ptr<IZipper> zipper);
+} // namespace lms::zip
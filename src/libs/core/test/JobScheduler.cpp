@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include <mutex>
 #include <thread>
 
 #include "core/IJob.hpp"
@@ -46,6 +47,24 @@ namespace lms::core
             std::atomic<std::size_t>& workCount;
         };
 
+        class FunctionJob : public IJob
+        {
+        public:
+            FunctionJob(std::function<void()> func)
+                : _func{ std::move(func) } {}
+
+        private:
+            LiteralString getName() const override { return "function"; };
+            void run() override { _func(); }
+
+            std::function<void()> _func;
+        };
+
+        void waitFor(const std::atomic<bool>& flag)
+        {
+            while (!flag)
+                std::this_thread::yield();
+        }
     } // namespace
     TEST(JobScheduler, basic)
     {
@@ -87,4 +106,144 @@ namespace lms::core
         EXPECT_EQ(doneJobs.size(), 0);
     }
 
-} // namespace lms::core
\ No newline at end of file
+    TEST(JobScheduler, waitUntilAnyJobDone)
+    {
+        std::atomic<std::size_t> workCount{ 0 };
+
+        auto scheduler{ createJobScheduler("TestScheduler", 2) };
+        ASSERT_NE(scheduler, nullptr);
+
+        // must not block if nothing is ongoing
+        scheduler->waitUntilAnyJobDone();
+
+        scheduler->scheduleJob(std::make_unique<TestJob>(workCount));
+        scheduler->waitUntilAnyJobDone();
+        EXPECT_EQ(scheduler->getJobsDoneCount(), 1);
+        EXPECT_EQ(workCount.load(), 1);
+
+        // must not block if jobs are aborted
+        scheduler->setShouldAbortCallback([] { return true; });
+        scheduler->scheduleJob(std::make_unique<TestJob>(workCount));
+        std::vector<std::unique_ptr<IJob>> doneJobs;
+        scheduler->popJobsDone(doneJobs, 10);
+        scheduler->waitUntilAnyJobDone();
+        scheduler->wait();
+        EXPECT_EQ(workCount.load(), 1);
+    }
+
+    TEST(JobScheduler, priority)
+    {
+        auto scheduler{ createJobScheduler("TestScheduler", 1) };
+
+        // keep the only thread busy while scheduling the other jobs
+        std::atomic<bool> release{};
+        scheduler->scheduleJob(std::make_unique<FunctionJob>([&] { waitFor(release); }));
+
+        std::mutex mutex;
+        std::vector<JobPriority> runOrder;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (const JobPriority priority : { JobPriority::Background, JobPriority::Interactive })
+            {
+                scheduler->scheduleJob(std::make_unique<FunctionJob>([&, priority] {
+                    std::scoped_lock lock{ mutex };
+                    runOrder.push_back(priority);
+                }),
+                                       priority);
+            }
+        }
+
+        release = true;
+        scheduler->wait();
+
+        const std::vector<JobPriority> expectedRunOrder{
+            JobPriority::Interactive,
+            JobPriority::Interactive,
+            JobPriority::Interactive,
+            JobPriority::Background,
+            JobPriority::Background,
+            JobPriority::Background,
+        };
+        EXPECT_EQ(runOrder, expectedRunOrder);
+
+        std::vector<std::unique_ptr<IJob>> doneJobs;
+        EXPECT_EQ(scheduler->popJobsDone(doneJobs, 10), 7);
+    }
+
+    TEST(JobScheduler, yieldToInteractiveJobs)
+    {
+        auto scheduler{ createJobScheduler("TestScheduler", 1) };
+
+        std::atomic<bool> interactiveJobScheduled{};
+        std::atomic<bool> interactiveJobDone{};
+        bool interactiveJobDoneBeforeBackgroundJob{};
+
+        scheduler->scheduleJob(std::make_unique<FunctionJob>([&] {
+            waitFor(interactiveJobScheduled);
+            yieldToInteractiveJobs();
+            interactiveJobDoneBeforeBackgroundJob = interactiveJobDone;
+        }));
+        scheduler->scheduleJob(std::make_unique<FunctionJob>([&] { interactiveJobDone = true; }), JobPriority::Interactive);
+        interactiveJobScheduled = true;
+
+        scheduler->wait();
+        EXPECT_TRUE(interactiveJobDoneBeforeBackgroundJob);
+        EXPECT_EQ(scheduler->getJobsDoneCount(), 2);
+
+        // no effect outside of a job
+        yieldToInteractiveJobs();
+    }
+
+    TEST(JobScheduler, popJobsDoneOrder)
+    {
+        auto scheduler{ createJobScheduler("TestScheduler", 1) };
+
+        std::vector<IJob*> scheduledJobs;
+        for (int i = 0; i < 10; ++i)
+        {
+            auto job{ std::make_unique<FunctionJob>([] {}) };
+            scheduledJobs.push_back(job.get());
+            scheduler->scheduleJob(std::move(job));
+        }
+        scheduler->wait();
+
+        std::vector<IJob*> doneJobs;
+        std::vector<std::unique_ptr<IJob>> jobs;
+        while (scheduler->popJobsDone(jobs, 3) > 0)
+        {
+            for (const auto& job : jobs)
+                doneJobs.push_back(job.get());
+        }
+
+        // single thread: completion order is the scheduling order
+        EXPECT_EQ(doneJobs, scheduledJobs);
+        EXPECT_EQ(scheduler->getJobsDoneCount(), 0);
+    }
+
+    TEST(JobScheduler, jobStats)
+    {
+        std::atomic<std::size_t> workCount{ 0 };
+
+        auto scheduler{ createJobScheduler("TestScheduler", 2) };
+        for (int i = 0; i < 10; ++i)
+            scheduler->scheduleJob(std::make_unique<TestJob>(workCount));
+        scheduler->wait();
+
+        std::size_t visitCount{};
+        scheduler->visitJobStats([&](const IJobScheduler::JobStats& stats) {
+            visitCount++;
+            EXPECT_EQ(stats.name, "test");
+            EXPECT_EQ(stats.runCount, 10);
+            EXPECT_GE(stats.totalRunDuration, std::chrono::milliseconds{ 100 });
+            EXPECT_GE(stats.maxRunDuration, std::chrono::milliseconds{ 10 });
+            EXPECT_LE(stats.maxRunDuration, stats.totalRunDuration);
+            EXPECT_LE(stats.maxWaitDuration, stats.totalWaitDuration);
+            EXPECT_GT(stats.throughput, 0);
+        });
+        EXPECT_EQ(visitCount, 1);
+
+        scheduler->resetJobStats();
+        scheduler->visitJobStats([&](const IJobScheduler::JobStats&) { visitCount++; });
+        EXPECT_EQ(visitCount, 1);
+    }
+} // namespace lms::core
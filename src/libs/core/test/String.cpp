@@ -244,6 +244,25 @@ namespace lms::core::stringUtils::tests
         EXPECT_EQ(xmlEscape("Line1\nLine2"), "Line1\nLine2");
     }
 
+    TEST(StringUtils, appendEscapedString)
+    {
+        std::string output{ "prefix:" };
+        appendJsonEscapedString(output, R"(\Test".mp3)");
+        EXPECT_EQ(output, R"(prefix:\\Test\".mp3)");
+
+        output.clear();
+        appendJsonEscapedString(output, "");
+        EXPECT_EQ(output, "");
+
+        output.clear();
+        appendXmlEscapedString(output, R"(<tag attr="val & val2">O'Hara</tag>)");
+        EXPECT_EQ(output, "&lt;tag attr=&quot;val &amp; val2&quot;&gt;O&apos;Hara&lt;/tag&gt;");
+
+        output.clear();
+        appendXmlEscapedString(output, "Test.mp3");
+        EXPECT_EQ(output, "Test.mp3");
+    }
+
     TEST(StringUtils, escapeString)
     {
         EXPECT_EQ(escapeString("", "*", ' '), "");
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/IZipper.hpp"
+
+namespace lms::zip::tests
+{
+    namespace
+    {
+        class ZipperTest : public ::testing::Test
+        {
+        protected:
+            void SetUp() override
+            {
+                _tmpDir = std::filesystem::temp_directory_path() / ("lms-zipper-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+                std::filesystem::create_directories(_tmpDir);
+            }
+
+            void TearDown() override
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(_tmpDir, ec);
+            }
+
+            std::filesystem::path createFile(std::string_view name, std::size_t size)
+            {
+                const std::filesystem::path path{ _tmpDir / name };
+
+                std::ofstream file{ path, std::ios::binary };
+                for (std::size_t i{}; i < size; ++i)
+                    file.put(static_cast<char>(i * 7 + 3));
+
+                return path;
+            }
+
+            static std::string writeAll(IZipper& zipper, std::uint64_t chunkSize)
+            {
+                std::ostringstream output;
+
+                std::uint64_t offset{};
+                while (offset < zipper.getTotalSize())
+                {
+                    const std::uint64_t written{ zipper.writeSome(output, offset, chunkSize) };
+                    if (written == 0)
+                        break;
+                    offset += written;
+                }
+
+                return output.str();
+            }
+
+            std::filesystem::path _tmpDir;
+        };
+
+        std::uint32_t readLE32(std::string_view data, std::size_t offset)
+        {
+            std::uint32_t res{};
+            for (std::size_t i{}; i < 4; ++i)
+                res |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+            return res;
+        }
+
+        std::uint16_t readLE16(std::string_view data, std::size_t offset)
+        {
+            return static_cast<std::uint16_t>(static_cast<unsigned char>(data[offset]) | (static_cast<unsigned char>(data[offset + 1]) << 8));
+        }
+
+        // bitwise implementation, independent from the one used by the zipper
+        std::uint32_t computeCrc32(std::string_view data)
+        {
+            std::uint32_t crc{ 0xFFFFFFFF };
+            for (const char c : data)
+            {
+                crc ^= static_cast<unsigned char>(c);
+                for (std::size_t i{}; i < 8; ++i)
+                    crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+            return ~crc;
+        }
+
+        std::string readFile(const std::filesystem::path& path)
+        {
+            std::ifstream file{ path, std::ios::binary };
+            std::ostringstream oss;
+            oss << file.rdbuf();
+            return oss.str();
+        }
+
+        struct ExtractedEntry
+        {
+            std::string fileName;
+            std::string data;
+            std::uint16_t dosDate{};
+        };
+
+        // Minimal reader for stored entries without zip64 records: walks the central directory,
+        // checks each entry against its local header and data descriptor, and the CRCs against the data
+        std::vector<ExtractedEntry> extractAll(std::string_view archive)
+        {
+            std::vector<ExtractedEntry> entries;
+
+            const std::size_t endOfCentralDirectoryOffset{ archive.size() - 22 };
+            EXPECT_EQ(readLE32(archive, endOfCentralDirectoryOffset), 0x06054b50);
+            const std::size_t entryCount{ readLE16(archive, endOfCentralDirectoryOffset + 10) };
+            std::size_t offset{ readLE32(archive, endOfCentralDirectoryOffset + 16) };
+
+            for (std::size_t i{}; i < entryCount; ++i)
+            {
+                EXPECT_EQ(readLE32(archive, offset), 0x02014b50);
+                const std::uint16_t flags{ readLE16(archive, offset + 8) };
+                EXPECT_EQ(readLE16(archive, offset + 10), 0); // stored
+                const std::uint32_t crc32{ readLE32(archive, offset + 16) };
+                const std::uint32_t size{ readLE32(archive, offset + 24) };
+                EXPECT_EQ(readLE32(archive, offset + 20), size);
+                const std::size_t fileNameSize{ readLE16(archive, offset + 28) };
+                const std::size_t extraSize{ readLE16(archive, offset + 30) };
+                const std::size_t commentSize{ readLE16(archive, offset + 32) };
+                const std::size_t localHeaderOffset{ readLE32(archive, offset + 42) };
+
+                ExtractedEntry& entry{ entries.emplace_back() };
+                entry.fileName = archive.substr(offset + 46, fileNameSize);
+                entry.dosDate = readLE16(archive, offset + 14);
+
+                EXPECT_EQ(readLE32(archive, localHeaderOffset), 0x04034b50);
+                EXPECT_EQ(readLE16(archive, localHeaderOffset + 6), flags);
+                EXPECT_EQ(archive.substr(localHeaderOffset + 30, readLE16(archive, localHeaderOffset + 26)), entry.fileName);
+                const std::size_t dataOffset{ localHeaderOffset + 30 + readLE16(archive, localHeaderOffset + 26) + readLE16(archive, localHeaderOffset + 28) };
+                entry.data = archive.substr(dataOffset, size);
+                EXPECT_EQ(computeCrc32(entry.data), crc32) << entry.fileName;
+
+                EXPECT_TRUE(flags & (1 << 3)); // data descriptor
+                const std::size_t dataDescriptorOffset{ dataOffset + size };
+                EXPECT_EQ(readLE32(archive, dataDescriptorOffset), 0x08074b50);
+                EXPECT_EQ(readLE32(archive, dataDescriptorOffset + 4), crc32);
+                EXPECT_EQ(readLE32(archive, dataDescriptorOffset + 8), size);
+                EXPECT_EQ(readLE32(archive, dataDescriptorOffset + 12), size);
+
+                offset += 46 + fileNameSize + extraSize + commentSize;
+            }
+
+            return entries;
+        }
+    } // namespace
+
+    TEST_F(ZipperTest, empty)
+    {
+        auto zipper{ createStoreZipper({}) };
+
+        const std::string archive{ writeAll(*zipper, 1024) };
+        ASSERT_EQ(archive.size(), zipper->getTotalSize());
+        ASSERT_EQ(archive.size(), 22); // end of central directory only
+        EXPECT_EQ(readLE32(archive, 0), 0x06054b50);
+    }
+
+    TEST_F(ZipperTest, totalSize)
+    {
+        const EntryContainer entries{
+            { "dir/file1.bin", createFile("file1.bin", 100) },
+            { "dir/file2.bin", createFile("file2.bin", 100'000) },
+            { "file3.bin", createFile("file3.bin", 0) },
+        };
+
+        auto zipper{ createStoreZipper(entries) };
+        const std::string archive{ writeAll(*zipper, 4096) };
+        ASSERT_EQ(archive.size(), zipper->getTotalSize());
+
+        EXPECT_EQ(readLE32(archive, 0), 0x04034b50); // first local file header
+        EXPECT_EQ(readLE32(archive, archive.size() - 22), 0x06054b50); // end of central directory
+    }
+
+    TEST_F(ZipperTest, roundTrip)
+    {
+        const EntryContainer entries{
+            { "dir/file1.bin", createFile("file1.bin", 100) },
+            { "dir/file2.bin", createFile("file2.bin", 200'000) },
+            { "file3.bin", createFile("file3.bin", 0) },
+            { "file4.bin", createFile("file4.bin", 65'537) },
+        };
+
+        for (const std::uint64_t chunkSize : { 1'000, 65'536, 1'000'000 })
+        {
+            const std::string archive{ writeAll(*createStoreZipper(entries), chunkSize) };
+
+            const std::vector<ExtractedEntry> extractedEntries{ extractAll(archive) };
+            ASSERT_EQ(extractedEntries.size(), entries.size());
+            for (std::size_t i{}; i < entries.size(); ++i)
+            {
+                EXPECT_EQ(extractedEntries[i].fileName, entries[i].fileName);
+                EXPECT_EQ(extractedEntries[i].data, readFile(entries[i].filePath));
+            }
+        }
+    }
+
+    TEST_F(ZipperTest, lastRepresentableDate)
+    {
+        const std::filesystem::path file{ createFile("file.bin", 10) };
+        std::filesystem::last_write_time(file, std::chrono::time_point_cast<std::filesystem::file_time_type::duration>(std::chrono::file_clock::from_sys(std::chrono::sys_seconds{ std::chrono::sys_days{ std::chrono::year{ 2200 } / 1 / 1 } })));
+
+        const std::string archive{ writeAll(*createStoreZipper({ { "file.bin", file } }), 1024) };
+        const std::vector<ExtractedEntry> extractedEntries{ extractAll(archive) };
+        ASSERT_EQ(extractedEntries.size(), 1);
+        EXPECT_EQ(extractedEntries[0].dosDate, (127 << 9) | (12 << 5) | 31); // 2107-12-31
+    }
+
+    TEST_F(ZipperTest, ranges)
+    {
+        const EntryContainer entries{
+            { "file1.bin", createFile("file1.bin", 70'000) },
+            { "file2.bin", createFile("file2.bin", 1234) },
+        };
+
+        const std::string archive{ writeAll(*createStoreZipper(entries), 1'000'000) };
+
+        // a fresh zipper must produce the same bytes for any range, in any order
+        auto zipper{ createStoreZipper(entries) };
+        for (std::uint64_t offset{ archive.size() }; offset > 0; offset = offset > 777 ? offset - 777 : 0)
+        {
+            std::ostringstream output;
+            const std::uint64_t written{ zipper->writeSome(output, offset - 1, 3333) };
+            ASSERT_EQ(output.str(), archive.substr(offset - 1, written));
+        }
+    }
+
+    TEST_F(ZipperTest, etag)
+    {
+        const std::filesystem::path file{ createFile("file.bin", 100) };
+
+        auto zipper1{ createStoreZipper({ { "file.bin", file } }) };
+        auto zipper2{ createStoreZipper({ { "file.bin", file } }) };
+        auto zipper3{ createStoreZipper({ { "other.bin", file } }) };
+
+        EXPECT_FALSE(zipper1->getETag().empty());
+        EXPECT_EQ(zipper1->getETag(), zipper2->getETag());
+        EXPECT_NE(zipper1->getETag(), zipper3->getETag());
+    }
+} // namespace lms::zip::tests
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace lms::core::testing
+{
+    // Writes the byteCount lowest bytes of value, least significant first
+    inline void writeLE(std::ostream& os, std::uint64_t value, std::size_t byteCount)
+    {
+        for (std::size_t i{}; i < byteCount; ++i)
+            os.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    // 16-bit PCM, to be followed by dataSize bytes of interleaved samples
+    inline void writeWavHeader(std::ostream& os, unsigned sampleRate, unsigned channelCount, std::size_t dataSize)
+    {
+        os.write("RIFF", 4);
+        writeLE(os, 36 + dataSize, 4);
+        os.write("WAVEfmt ", 8);
+        writeLE(os, 16, 4);
+        writeLE(os, 1, 2); // PCM
+        writeLE(os, channelCount, 2);
+        writeLE(os, sampleRate, 4);
+        writeLE(os, sampleRate * channelCount * 2, 4);
+        writeLE(os, channelCount * 2, 2);
+        writeLE(os, 16, 2);
+        os.write("data", 4);
+        writeLE(os, dataSize, 4);
+    }
+} // namespace lms::core::testing
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+namespace lms::core::testing
+{
+    // File in the temporary directory, removed on destruction
+    class TemporaryFile
+    {
+    public:
+        TemporaryFile(std::string_view name)
+            : _path{ std::filesystem::temp_directory_path() / name }
+        {
+        }
+        ~TemporaryFile()
+        {
+            std::error_code ec;
+            std::filesystem::remove(_path, ec);
+        }
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        const std::filesystem::path& getPath() const { return _path; }
+
+    private:
+        const std::filesystem::path _path;
+    };
+} // namespace lms::core::testing
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "database/Session.hpp"
+#include "database/objects/Cluster.hpp"
+
+#include "Common.hpp"
+
+namespace lms::db::benchs
+{
+    namespace
+    {
+        // Former implementation, cluster per cluster, kept as a reference
+        void updateCountsPerCluster(Session& session)
+        {
+            std::vector<ClusterId> clusterIds;
+            {
+                auto transaction{ session.createReadTransaction() };
+                clusterIds = std::move(Cluster::findIds(session, Cluster::FindParameters{}).results);
+            }
+
+            for (const ClusterId clusterId : clusterIds)
+            {
+                std::size_t trackCount;
+                std::size_t releaseCount;
+                {
+                    auto transaction{ session.createReadTransaction() };
+
+                    trackCount = Cluster::computeTrackCount(session, clusterId);
+                    releaseCount = Cluster::computeReleaseCount(session, clusterId);
+                }
+
+                {
+                    auto transaction{ session.createWriteTransaction() };
+
+                    auto cluster{ Cluster::find(session, clusterId) };
+                    cluster.modify()->setTrackCount(trackCount);
+                    cluster.modify()->setReleaseCount(releaseCount);
+                }
+            }
+        }
+
+        void BM_ClusterStats_perCluster(benchmark::State& state)
+        {
+            ClusterDatabase& database{ ClusterDatabase::getInstance(static_cast<std::size_t>(state.range(0))) };
+
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                database.resetCounts();
+                state.ResumeTiming();
+
+                updateCountsPerCluster(database.getSession());
+            }
+        }
+
+        void BM_ClusterStats_bulk(benchmark::State& state)
+        {
+            ClusterDatabase& database{ ClusterDatabase::getInstance(static_cast<std::size_t>(state.range(0))) };
+            Session& session{ database.getSession() };
+
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                database.resetCounts();
+                state.ResumeTiming();
+
+                auto transaction{ session.createWriteTransaction() };
+                benchmark::DoNotOptimize(Cluster::updateCounts(session));
+            }
+        }
+
+        void BM_ClusterStats_bulkNoChange(benchmark::State& state)
+        {
+            ClusterDatabase& database{ ClusterDatabase::getInstance(static_cast<std::size_t>(state.range(0))) };
+            Session& session{ database.getSession() };
+
+            for (auto _ : state)
+            {
+                auto transaction{ session.createWriteTransaction() };
+                benchmark::DoNotOptimize(Cluster::updateCounts(session));
+            }
+        }
+    } // namespace
+
+    BENCHMARK(BM_ClusterStats_perCluster)->Arg(1'000)->Arg(10'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_ClusterStats_bulk)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_ClusterStats_bulkNoChange)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+} // namespace lms::db::benchs
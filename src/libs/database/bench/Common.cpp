@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Common.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "database/objects/Cluster.hpp"
+#include "database/objects/Release.hpp"
+#include "database/objects/Track.hpp"
+
+namespace lms::db::benchs
+{
+    namespace
+    {
+        template<typename Database>
+        Database& getDatabaseInstance(std::size_t count)
+        {
+            static std::map<std::size_t, std::unique_ptr<Database>> databases;
+
+            std::unique_ptr<Database>& database{ databases[count] };
+            if (!database)
+                database = std::make_unique<Database>(count);
+
+            return *database;
+        }
+    } // namespace
+
+    TemporaryDatabase::TemporaryDatabase(std::string_view name)
+        : _dbPath{ std::filesystem::temp_directory_path() / ("lms-bench-" + std::string{ name } + ".db") }
+    {
+        std::filesystem::remove(_dbPath);
+        _db = createDb(_dbPath);
+
+        Session& session{ getSession() };
+        session.prepareTablesIfNeeded();
+        session.createIndexesIfNeeded();
+    }
+
+    TemporaryDatabase::~TemporaryDatabase()
+    {
+        _db.reset();
+
+        std::error_code ec;
+        std::filesystem::remove(_dbPath, ec);
+    }
+
+    ReleaseDatabase::ReleaseDatabase(std::size_t releaseCount)
+        : TemporaryDatabase{ "releases-" + std::to_string(releaseCount) }
+    {
+        constexpr std::size_t batchSize{ 10'000 };
+
+        Session& session{ getSession() };
+        for (std::size_t i{}; i < releaseCount; i += batchSize)
+        {
+            auto transaction{ session.createWriteTransaction() };
+
+            // names are not inserted in order, and some of them only differ by their case
+            for (std::size_t j{ i }; j < std::min(i + batchSize, releaseCount); ++j)
+                session.create<Release>(((j % 2) ? "Release " : "release ") + std::to_string((j * 7919) % (releaseCount / 2)));
+        }
+    }
+
+    ReleaseDatabase& ReleaseDatabase::getInstance(std::size_t releaseCount)
+    {
+        return getDatabaseInstance<ReleaseDatabase>(releaseCount);
+    }
+
+    ClusterDatabase::ClusterDatabase(std::size_t clusterCount)
+        : TemporaryDatabase{ "clusters-" + std::to_string(clusterCount) }
+    {
+        Session& session{ getSession() };
+        auto transaction{ session.createWriteTransaction() };
+
+        const ClusterType::pointer clusterType{ session.create<ClusterType>("genre") };
+        std::vector<Cluster::pointer> clusters;
+        clusters.reserve(clusterCount);
+        for (std::size_t i{}; i < clusterCount; ++i)
+            clusters.push_back(session.create<Cluster>(clusterType, "Cluster " + std::to_string(i)));
+
+        Release::pointer release;
+        for (std::size_t i{}; i < trackCount; ++i)
+        {
+            if (i % tracksPerRelease == 0)
+                release = session.create<Release>("Release " + std::to_string(i / tracksPerRelease));
+
+            Track::pointer track{ session.create<Track>() };
+            track.modify()->setRelease(release);
+            for (std::size_t j{}; j < clustersPerTrack; ++j)
+                clusters[(i * 7919 + j * 104729) % clusterCount].modify()->addTrack(track);
+        }
+    }
+
+    ClusterDatabase& ClusterDatabase::getInstance(std::size_t clusterCount)
+    {
+        return getDatabaseInstance<ClusterDatabase>(clusterCount);
+    }
+
+    void ClusterDatabase::resetCounts()
+    {
+        Session& session{ getSession() };
+
+        auto transaction{ session.createWriteTransaction() };
+        session.getDboSession()->execute("UPDATE cluster SET track_count = 0, release_count = 0");
+    }
+} // namespace lms::db::benchs
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "database/IDb.hpp"
+#include "database/Session.hpp"
+
+namespace lms::db::benchs
+{
+    // Database created from scratch in the temp directory, removed on destruction
+    class TemporaryDatabase
+    {
+    public:
+        TemporaryDatabase(std::string_view name);
+        ~TemporaryDatabase();
+        TemporaryDatabase(const TemporaryDatabase&) = delete;
+        TemporaryDatabase& operator=(const TemporaryDatabase&) = delete;
+
+        Session& getSession() { return _db->getTLSSession(); }
+
+    private:
+        const std::filesystem::path _dbPath;
+        std::unique_ptr<IDb> _db;
+    };
+
+    // Temporary database filled with releases that have no track
+    class ReleaseDatabase : public TemporaryDatabase
+    {
+    public:
+        ReleaseDatabase(std::size_t releaseCount);
+
+        // one shared instance per release count, created on first use
+        static ReleaseDatabase& getInstance(std::size_t releaseCount);
+    };
+
+    // Temporary database in which each track belongs to a few clusters
+    class ClusterDatabase : public TemporaryDatabase
+    {
+    public:
+        static constexpr std::size_t trackCount{ 20'000 };
+        static constexpr std::size_t tracksPerRelease{ 10 };
+        static constexpr std::size_t clustersPerTrack{ 3 };
+
+        ClusterDatabase(std::size_t clusterCount);
+
+        // one shared instance per cluster count, created on first use
+        static ClusterDatabase& getInstance(std::size_t clusterCount);
+
+        // so that the next count update has to write all the clusters
+        void resetCounts();
+    };
+} // namespace lms::db::benchs
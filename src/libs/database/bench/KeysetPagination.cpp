@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "database/Session.hpp"
+#include "database/objects/Release.hpp"
+
+#include "Common.hpp"
+
+namespace lms::db::benchs
+{
+    namespace
+    {
+        constexpr std::size_t pageSize{ 50 };
+
+        // Large enough to make the offset cost obvious
+        constexpr std::size_t releaseCount{ 520'000 };
+
+        void BM_Release_findIds_offset(benchmark::State& state)
+        {
+            Session& session{ ReleaseDatabase::getInstance(releaseCount).getSession() };
+            const std::size_t offset{ static_cast<std::size_t>(state.range(0)) };
+
+            auto transaction{ session.createReadTransaction() };
+
+            for (auto _ : state)
+            {
+                const auto releases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name).setRange(Range{ offset, pageSize })) };
+                benchmark::DoNotOptimize(releases);
+            }
+        }
+
+        void BM_Release_findIds_keyset(benchmark::State& state)
+        {
+            Session& session{ ReleaseDatabase::getInstance(releaseCount).getSession() };
+            const std::size_t offset{ static_cast<std::size_t>(state.range(0)) };
+
+            auto transaction{ session.createReadTransaction() };
+
+            // the last release of the previous page, as a client would have received it
+            ReleaseId lastReleaseId;
+            if (offset > 0)
+                lastReleaseId = Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name).setRange(Range{ offset - 1, 1 })).results.front();
+
+            for (auto _ : state)
+            {
+                const auto releases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name).setLastReleaseId(lastReleaseId).setRange(Range{ 0, pageSize })) };
+                benchmark::DoNotOptimize(releases);
+            }
+        }
+    } // namespace
+
+    BENCHMARK(BM_Release_findIds_offset)->Arg(0)->Arg(10'000)->Arg(100'000)->Arg(500'000)->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_Release_findIds_keyset)->Arg(0)->Arg(10'000)->Arg(100'000)->Arg(500'000)->Unit(benchmark::kMillisecond);
+} // namespace lms::db::benchs
+
+BENCHMARK_MAIN();
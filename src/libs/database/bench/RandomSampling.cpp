@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "database/Session.hpp"
+#include "database/objects/Release.hpp"
+
+#include "Common.hpp"
+
+namespace lms::db::benchs
+{
+    namespace
+    {
+        // latency should not depend on the number of releases
+        void BM_Release_findIds_random(benchmark::State& state)
+        {
+            Session& session{ ReleaseDatabase::getInstance(static_cast<std::size_t>(state.range(0))).getSession() };
+            const std::size_t count{ static_cast<std::size_t>(state.range(1)) };
+
+            auto transaction{ session.createReadTransaction() };
+
+            for (auto _ : state)
+            {
+                const auto releases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Random).setRange(Range{ 0, count })) };
+                benchmark::DoNotOptimize(releases);
+            }
+        }
+    } // namespace
+
+    BENCHMARK(BM_Release_findIds_random)->ArgsProduct({ { 10'000, 100'000, 520'000 }, { 10, 50, 500 } })->Unit(benchmark::kMillisecond);
+} // namespace lms::db::benchs
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FullTextSearch.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "database/Session.hpp"
+
+namespace lms::db::fts
+{
+    namespace
+    {
+        constexpr std::array<std::string_view, 2> artistColumns{ "name", "sort_name" };
+        constexpr std::array<std::string_view, 1> releaseColumns{ "name" };
+        constexpr std::array<std::string_view, 1> trackColumns{ "name" };
+
+        constexpr std::size_t minIndexableKeywordSize{ 3 };
+
+        std::string joinColumns(const Table& table, std::string_view prefix)
+        {
+            std::string res;
+            for (const std::string_view column : table.columns)
+            {
+                if (!res.empty())
+                    res += ", ";
+                res += prefix;
+                res += column;
+            }
+            return res;
+        }
+
+        void createTable(Session& session, const Table& table)
+        {
+            const std::string name{ table.name };
+            const std::string contentTable{ table.contentTable };
+            const std::string columns{ joinColumns(table, "") };
+            const std::string oldColumns{ joinColumns(table, "old.") };
+            const std::string newColumns{ joinColumns(table, "new.") };
+
+            session.execute("CREATE VIRTUAL TABLE IF NOT EXISTS " + name + " USING fts5(" + columns + ", content='" + contentTable + "', content_rowid='id', tokenize='trigram')");
+
+            session.execute("CREATE TRIGGER IF NOT EXISTS " + name + "_insert AFTER INSERT ON " + contentTable + " BEGIN"
+                                                                                                                 " INSERT INTO "
+                            + name + "(rowid, " + columns + ") VALUES (new.id, " + newColumns + ");"
+                                                                                                " END");
+            session.execute("CREATE TRIGGER IF NOT EXISTS " + name + "_delete AFTER DELETE ON " + contentTable + " BEGIN"
+                                                                                                                 " INSERT INTO "
+                            + name + "(" + name + ", rowid, " + columns + ") VALUES ('delete', old.id, " + oldColumns + ");"
+                                                                                                                        " END");
+            session.execute("CREATE TRIGGER IF NOT EXISTS " + name + "_update AFTER UPDATE OF " + columns + " ON " + contentTable + " BEGIN"
+                                                                                                                                    " INSERT INTO "
+                            + name + "(" + name + ", rowid, " + columns + ") VALUES ('delete', old.id, " + oldColumns + ");"
+                                                                                                                        " INSERT INTO "
+                            + name + "(rowid, " + columns + ") VALUES (new.id, " + newColumns + ");"
+                                                                                                " END");
+        }
+
+        void rebuildTable(Session& session, const Table& table)
+        {
+            const std::string name{ table.name };
+            session.execute("INSERT INTO " + name + "(" + name + ") VALUES ('rebuild')");
+        }
+
+        std::size_t getCharacterCount(std::string_view str)
+        {
+            // count UTF-8 code points
+            return std::count_if(std::cbegin(str), std::cend(str), [](char c) { return (static_cast<unsigned char>(c) & 0xC0) != 0x80; });
+        }
+
+        void appendQuotedString(std::string& output, std::string_view str)
+        {
+            output += '"';
+            for (const char c : str)
+            {
+                if (c == '"')
+                    output += '"';
+                output += c;
+            }
+            output += '"';
+        }
+    } // namespace
+
+    const Table artistTable{ "artist_fts", "artist", artistColumns };
+    const Table releaseTable{ "release_fts", "release", releaseColumns };
+    const Table trackTable{ "track_fts", "track", trackColumns };
+
+    void createTables(Session& session)
+    {
+        session.checkWriteTransaction();
+
+        for (const Table* table : { &artistTable, &releaseTable, &trackTable })
+            createTable(session, *table);
+    }
+
+    void rebuildTables(Session& session)
+    {
+        session.checkWriteTransaction();
+
+        for (const Table* table : { &artistTable, &releaseTable, &trackTable })
+            rebuildTable(session, *table);
+    }
+
+    bool isIndexableKeyword(std::string_view keyword)
+    {
+        return getCharacterCount(keyword) >= minIndexableKeywordSize;
+    }
+
+    std::string createMatchExpression(const Table& table, std::span<const std::string_view> keywords)
+    {
+        std::string keywordsExpression;
+        for (const std::string_view keyword : keywords)
+        {
+            if (!isIndexableKeyword(keyword))
+                continue;
+
+            if (!keywordsExpression.empty())
+                keywordsExpression += " AND ";
+            appendQuotedString(keywordsExpression, keyword);
+        }
+
+        if (keywordsExpression.empty())
+            return keywordsExpression;
+
+        std::string res;
+        for (const std::string_view column : table.columns)
+        {
+            if (!res.empty())
+                res += " OR ";
+            res += "{";
+            res += column;
+            res += "} : (";
+            res += keywordsExpression;
+            res += ")";
+        }
+
+        return res;
+    }
+
+    std::string getRankColumn(const Table& table)
+    {
+        return std::string{ table.name } + ".rank";
+    }
+} // namespace lms::db::fts
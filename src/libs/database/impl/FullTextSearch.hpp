@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/String.hpp"
+
+#include "Utils.hpp"
+
+namespace lms::db
+{
+    class Session;
+}
+
+namespace lms::db::fts
+{
+    // FTS5 tables using the trigram tokenizer: a quoted keyword matches any substring of the indexed columns, case insensitive
+    // The tables use external content and are kept in sync with their content table using triggers
+    struct Table
+    {
+        std::string_view name;
+        std::string_view contentTable;
+        std::span<const std::string_view> columns;
+    };
+
+    extern const Table artistTable;
+    extern const Table releaseTable;
+    extern const Table trackTable;
+
+    void createTables(Session& session); // does nothing for the tables that already exist
+    void rebuildTables(Session& session);
+
+    // Trigrams require at least 3 characters
+    bool isIndexableKeyword(std::string_view keyword);
+
+    // All the indexable keywords must be found in the same column, empty if there is no indexable keyword
+    std::string createMatchExpression(const Table& table, std::span<const std::string_view> keywords);
+
+    // Restrict the query to the entries that contain all the keywords, the entry table being referred to as tableAlias
+    // Keywords too short to be indexed fall back on a LIKE clause
+    // Returns true if the full text search table has been joined: results can then be ordered using getRankColumn
+    template<typename Query>
+    bool applyKeywordsFilter(Query& query, const Table& table, std::string_view tableAlias, std::span<const std::string_view> keywords)
+    {
+        bool joined{};
+        if (const std::string matchExpression{ createMatchExpression(table, keywords) }; !matchExpression.empty())
+        {
+            query.join(std::string{ table.name } + " ON " + std::string{ table.name } + ".rowid = " + std::string{ tableAlias } + ".id");
+            query.where(std::string{ table.name } + " MATCH ?").bind(matchExpression);
+            joined = true;
+        }
+
+        for (const std::string_view keyword : keywords)
+        {
+            if (isIndexableKeyword(keyword))
+                continue;
+
+            std::vector<std::string> clauses;
+            for (const std::string_view column : table.columns)
+            {
+                clauses.push_back(std::string{ tableAlias } + "." + std::string{ column } + " LIKE ? ESCAPE '" ESCAPE_CHAR_STR "'");
+                query.bind("%" + utils::escapeForLikeKeyword(keyword) + "%");
+            }
+            query.where("(" + core::stringUtils::joinStrings(clauses, " OR ") + ")");
+        }
+
+        return joined;
+    }
+
+    // Best matches first
+    std::string getRankColumn(const Table& table);
+} // namespace lms::db::fts
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KeysetPagination.hpp"
+
+#include <cassert>
+#include <iterator>
+
+namespace lms::db::keyset
+{
+    namespace
+    {
+        std::string createColumnList(const Ordering& ordering, std::string_view tableAlias, std::string_view suffix)
+        {
+            std::string res;
+            for (const std::string_view column : ordering.columns)
+            {
+                if (!res.empty())
+                    res += ",";
+                res += tableAlias;
+                res += ".";
+                res += column;
+                res += suffix;
+            }
+            return res;
+        }
+    } // namespace
+
+    std::string createOrderByClause(const Ordering& ordering, std::string_view tableAlias)
+    {
+        return createColumnList(ordering, tableAlias, ordering.descending ? " DESC" : "");
+    }
+
+    std::string createGroupByClause(const Ordering& ordering, std::string_view tableAlias)
+    {
+        return createColumnList(ordering, tableAlias, "");
+    }
+
+    std::string createStartAfterClause(const Ordering& ordering, std::string_view table, std::string_view tableAlias, std::size_t& bindCount)
+    {
+        assert(!ordering.columns.empty() && ordering.columns.back() == "id");
+
+        const std::string_view strictOp{ ordering.descending ? " < " : " > " };
+        const std::string_view op{ ordering.descending ? " <= " : " >= " };
+
+        // built from the last column (the id) up to the first one
+        std::string res{ std::string{ tableAlias } + ".id" + std::string{ strictOp } + "?" };
+        bindCount = 1;
+
+        for (auto itColumn{ std::next(std::crbegin(ordering.columns)) }; itColumn != std::crend(ordering.columns); ++itColumn)
+        {
+            const std::string column{ std::string{ tableAlias } + "." + std::string{ *itColumn } };
+            const std::string lastEntryValue{ "(SELECT k." + std::string{ *itColumn } + " FROM " + std::string{ table } + " k WHERE k.id = ?)" };
+
+            res = column + std::string{ op } + lastEntryValue + " AND (" + column + std::string{ strictOp } + lastEntryValue + " OR (" + res + "))";
+            bindCount += 2;
+        }
+
+        // The last entry may have been removed since it was retrieved: its position in the sort order is lost and the lookups above
+        // would return NULL. Return an explicit empty page rather than relying on how NULL propagates through the comparisons.
+        if (ordering.columns.size() > 1)
+        {
+            res = "EXISTS (SELECT 1 FROM " + std::string{ table } + " k WHERE k.id = ?) AND " + res;
+            bindCount += 1;
+        }
+
+        return res;
+    }
+} // namespace lms::db::keyset
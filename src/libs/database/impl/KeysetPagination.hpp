@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace lms::db::keyset
+{
+    // Total order on the entries of a table, using non nullable columns of this table only
+    // The last column must be the id, so that any entry can be used as a starting point
+    struct Ordering
+    {
+        std::span<const std::string_view> columns; // may specify a collation, ex: "name COLLATE NOCASE"
+        bool descending{};
+    };
+
+    // ex: "a.name COLLATE NOCASE,a.id"
+    std::string createOrderByClause(const Ordering& ordering, std::string_view tableAlias);
+
+    // Grouping on the whole sort key rather than on the id only allows using the sort index
+    std::string createGroupByClause(const Ordering& ordering, std::string_view tableAlias);
+
+    // Each '?' of the returned clause has to be bound to the id of the last entry
+    std::string createStartAfterClause(const Ordering& ordering, std::string_view table, std::string_view tableAlias, std::size_t& bindCount);
+
+    // Only keep the entries that come after lastEntryId, without paying for an offset
+    // No entry is kept if lastEntryId no longer exists: callers have to check it within the same transaction and fall back on an offset
+    // Expanded as "k >= v AND (k > v OR id > ?)" since the query planner does not use indexes on row value comparisons
+    template<typename Query, typename IdType>
+    void applyStartAfterFilter(Query& query, const Ordering& ordering, std::string_view table, std::string_view tableAlias, IdType lastEntryId)
+    {
+        std::size_t bindCount{};
+        query.where(createStartAfterClause(ordering, table, tableAlias, bindCount));
+        for (std::size_t i{}; i < bindCount; ++i)
+            query.bind(lastEntryId);
+    }
+} // namespace lms::db::keyset
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ListenStats.hpp"
+
+#include "database/Session.hpp"
+
+#include "Utils.hpp"
+
+namespace lms::db::listenStats
+{
+    void createTable(Session& session)
+    {
+        utils::executeCommand(*session.getDboSession(), R"(CREATE TABLE IF NOT EXISTS "listen_stats" (
+  "user_id" bigint not null,
+  "backend" integer not null,
+  "track_id" bigint not null,
+  "listen_count" integer not null,
+  "last_listen_date_time" text not null,
+  primary key ("user_id", "backend", "track_id"),
+  constraint "fk_listen_stats_user" foreign key ("user_id") references "user" ("id") on delete cascade deferrable initially deferred,
+  constraint "fk_listen_stats_track" foreign key ("track_id") references "track" ("id") on delete cascade deferrable initially deferred
+) WITHOUT ROWID)");
+
+        // Kept up to date by the database itself, whatever the way listens are added or removed
+        utils::executeCommand(*session.getDboSession(), "CREATE TRIGGER IF NOT EXISTS listen_stats_insert AFTER INSERT ON listen BEGIN"
+                                                        " INSERT INTO listen_stats (user_id, backend, track_id, listen_count, last_listen_date_time) VALUES (new.user_id, new.backend, new.track_id, 1, new.date_time)"
+                                                        " ON CONFLICT (user_id, backend, track_id) DO UPDATE SET listen_count = listen_count + 1, last_listen_date_time = MAX(last_listen_date_time, excluded.last_listen_date_time);"
+                                                        " END");
+        utils::executeCommand(*session.getDboSession(), "CREATE TRIGGER IF NOT EXISTS listen_stats_delete AFTER DELETE ON listen BEGIN"
+                                                        " UPDATE listen_stats SET listen_count = listen_count - 1,"
+                                                        " last_listen_date_time = IFNULL((SELECT MAX(l.date_time) FROM listen l WHERE l.user_id = old.user_id AND l.track_id = old.track_id AND l.backend = old.backend), last_listen_date_time)"
+                                                        " WHERE user_id = old.user_id AND backend = old.backend AND track_id = old.track_id;"
+                                                        " DELETE FROM listen_stats WHERE user_id = old.user_id AND backend = old.backend AND track_id = old.track_id AND listen_count <= 0;"
+                                                        " END");
+    }
+
+    void rebuildTable(Session& session)
+    {
+        session.checkWriteTransaction();
+
+        utils::executeCommand(*session.getDboSession(), "DELETE FROM listen_stats");
+        utils::executeCommand(*session.getDboSession(), "INSERT INTO listen_stats (user_id, backend, track_id, listen_count, last_listen_date_time)"
+                                                        " SELECT user_id, backend, track_id, COUNT(*), MAX(date_time) FROM listen GROUP BY user_id, backend, track_id");
+    }
+} // namespace lms::db::listenStats
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace lms::db
+{
+    class Session;
+}
+
+namespace lms::db::listenStats
+{
+    // Per user, backend and track aggregates of the listen table (listen count, last listen)
+    // Maintained by triggers on the listen table
+    void createTable(Session& session); // does nothing if the table already exists
+    void rebuildTable(Session& session);
+} // namespace lms::db::listenStats
@@ -24,18 +24,21 @@
 #include "core/Exception.hpp"
 #include "core/ILogger.hpp"
 #include "core/ITraceLogger.hpp"
+#include "core/UUID.hpp"
 
 #include "database/Session.hpp"
 #include "database/objects/ScanSettings.hpp"
 
 #include "Db.hpp"
+#include "FullTextSearch.hpp"
+#include "ListenStats.hpp"
 #include "Utils.hpp"
 
 namespace lms::db
 {
     namespace
     {
-        static constexpr Version LMS_DATABASE_VERSION{ 105 };
+        static constexpr Version LMS_DATABASE_VERSION{ 111 };
     }
 
     VersionInfo::VersionInfo()
@@ -1729,6 +1732,43 @@ FROM track)");
         utils::executeCommand(*session.getDboSession(), R"(ALTER TABLE "playlist_file" ADD COLUMN "cover_image_file" text NOT NULL DEFAULT '')");
     }
 
+    void migrateFromV105(Session& session)
+    {
+        // Offsets are filled in when tracks are (re)scanned, images are read the slow way meanwhile
+        utils::executeCommand(*session.getDboSession(), R"(ALTER TABLE "track_embedded_image_link" ADD COLUMN "data_offset" bigint)");
+    }
+
+    void migrateFromV106(Session& session)
+    {
+        // Full text search tables for artist/release/track names, filled in from the existing entries
+        fts::createTables(session);
+        fts::rebuildTables(session);
+    }
+
+    void migrateFromV107(Session& session)
+    {
+        // Listen stats table, filled in from the existing listens
+        listenStats::createTable(session);
+        listenStats::rebuildTable(session);
+    }
+
+    void migrateFromV108(Session& session)
+    {
+        utils::executeCommand(*session.getDboSession(), "ALTER TABLE scan_settings ADD COLUMN scan_generation INTEGER NOT NULL DEFAULT(0)");
+    }
+
+    void migrateFromV109(Session& session)
+    {
+        utils::executeCommand(*session.getDboSession(), "ALTER TABLE scan_settings ADD COLUMN database_id TEXT NOT NULL DEFAULT('')");
+        utils::executeCommand(*session.getDboSession(), "UPDATE scan_settings SET database_id = ?", std::string{ core::UUID::generate().getAsString() });
+    }
+
+    void migrateFromV110(Session& session)
+    {
+        // Existing thumbnails are checked against their source on the next scan
+        utils::executeCommand(*session.getDboSession(), "ALTER TABLE artwork ADD COLUMN thumbnails_rendered BOOLEAN NOT NULL DEFAULT(false)");
+    }
+
     bool doDbMigration(Session& session)
     {
         constexpr std::string_view outdatedMsg{ "Outdated database, please rebuild it (delete the .db file and restart)" };
@@ -1810,6 +1850,12 @@ FROM track)");
             { 102, migrateFromV102 },
             { 103, migrateFromV103 },
             { 104, migrateFromV104 },
+            { 105, migrateFromV105 },
+            { 106, migrateFromV106 },
+            { 107, migrateFromV107 },
+            { 108, migrateFromV108 },
+            { 109, migrateFromV109 },
+            { 110, migrateFromV110 },
         };
 
         bool migrationPerformed{};
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "core/Random.hpp"
+#include "database/Session.hpp"
+#include "database/Types.hpp"
+
+#include "Utils.hpp"
+
+namespace lms::db::randomSampling
+{
+    // Up to this number of matching entries per requested entry are fetched to estimate how selective the filters are
+    constexpr std::size_t estimationSampleRatio{ 4 };
+    // Below this ratio of matching entries in the probed id range, most probes would miss: ORDER BY RANDOM() is used instead
+    constexpr double minMatchingDensity{ 0.25 };
+    // The estimation only examines the first entries of the table: if they do not contain enough matching entries, the filters are too selective
+    constexpr std::size_t maxScannedEntryRatio{ static_cast<std::size_t>(estimationSampleRatio / minMatchingDensity) };
+    // Give up after this number of probes per requested entry
+    constexpr std::size_t maxProbeRatio{ 8 };
+
+    // Picks random entries with a cost that depends on the requested count rather than on the number of entries,
+    // whereas ORDER BY RANDOM() has to evaluate and sort the whole filtered set.
+    // The matching entries among the first entries of the table are fetched (bounded by a limit): if the whole table was examined, they are shuffled.
+    // Otherwise random ids of the matching id range are probed with point lookups, each probe keeping its id only if it matches:
+    // all the matching entries are equally likely to be picked and no probe scans the entries that follow it.
+    // createQuery must return a new query on the filtered entries of tableName, ordered by id.
+    // Returns std::nullopt if the matching entries are too sparse in the id space: ORDER BY RANDOM() has to be used instead
+    template<typename IdType, typename CreateQueryFunc>
+    std::optional<RangeResults<IdType>> sampleIds(Session& session, std::string_view tableName, std::string_view tableAlias, Range range, CreateQueryFunc createQuery)
+    {
+        // offsets are meaningless on random results, but keep the previous behavior
+        if (range.offset != 0 || range.size == 0)
+            return std::nullopt;
+
+        auto& randGenerator{ core::random::getRandGenerator() };
+        const std::string idColumn{ std::string{ tableAlias } + ".id" };
+        const std::string selectIds{ "SELECT id FROM " + std::string{ tableName } };
+
+        // last id of the examined entries, regardless of the filters
+        const std::size_t maxScannedEntryCount{ maxScannedEntryRatio * range.size };
+        auto scanEndQuery{ session.getDboSession()->query<IdType>(selectIds) };
+        scanEndQuery.orderBy("id");
+        scanEndQuery.limit(1);
+        scanEndQuery.offset(static_cast<int>(maxScannedEntryCount - 1));
+        const IdType scanEndId{ utils::fetchQuerySingleResult(scanEndQuery) }; // invalid if the table is smaller
+
+        const std::size_t estimationSampleSize{ estimationSampleRatio * range.size };
+        auto estimationQuery{ createQuery() };
+        if (scanEndId.isValid())
+            estimationQuery.where(idColumn + " <= ?").bind(scanEndId);
+        estimationQuery.limit(static_cast<int>(estimationSampleSize));
+        std::vector<IdType> firstIds{ utils::fetchQueryResults(estimationQuery) };
+
+        RangeResults<IdType> res;
+        if (firstIds.size() < estimationSampleSize)
+        {
+            // not enough matching entries among the examined ones: too selective filters
+            if (scanEndId.isValid())
+                return std::nullopt;
+
+            // these are all the matching entries
+            std::shuffle(std::begin(firstIds), std::end(firstIds), randGenerator);
+            res.moreResults = firstIds.size() > range.size;
+            if (res.moreResults)
+                firstIds.resize(range.size);
+
+            res.results = std::move(firstIds);
+            res.range = Range{ 0, res.results.size() };
+            return res;
+        }
+
+        const IdType firstId{ firstIds.front() };
+        const double density{ static_cast<double>(firstIds.size()) / static_cast<double>(firstIds.back().getValue() - firstId.getValue() + 1) };
+        if (density < minMatchingDensity)
+            return std::nullopt;
+
+        // the last matching id may be far from the end of the table, probes after it just miss
+        auto lastIdQuery{ session.getDboSession()->query<IdType>(selectIds) };
+        lastIdQuery.orderBy("id DESC");
+        lastIdQuery.limit(1);
+        const IdType lastId{ utils::fetchQuerySingleResult(lastIdQuery) };
+
+        std::uniform_int_distribution<typename IdType::ValueType> distribution{ firstId.getValue(), lastId.getValue() };
+        const std::string probeClause{ idColumn + " = ?" };
+        const std::size_t maxProbeCount{ maxProbeRatio * range.size };
+
+        res.results.reserve(range.size);
+        std::unordered_set<IdType> pickedIds;
+        for (std::size_t probeCount{}; res.results.size() < range.size; ++probeCount)
+        {
+            if (probeCount == maxProbeCount)
+                return std::nullopt;
+
+            const IdType id{ distribution(randGenerator) };
+            if (pickedIds.contains(id))
+                continue;
+
+            auto query{ createQuery() };
+            query.where(probeClause).bind(id);
+            query.limit(1);
+            if (utils::fetchQueryResults(query).empty())
+                continue;
+
+            pickedIds.insert(id);
+            res.results.push_back(id);
+        }
+
+        // the estimation query already found more matching entries than requested
+        res.moreResults = true;
+        res.range = Range{ 0, res.results.size() };
+
+        return res;
+    }
+} // namespace lms::db::randomSampling
@@ -59,6 +59,8 @@
 #include "database/objects/User.hpp"
 
 #include "Db.hpp"
+#include "FullTextSearch.hpp"
+#include "ListenStats.hpp"
 #include "Migration.hpp"
 #include "TransactionChecker.hpp"
 #include "Utils.hpp"
@@ -163,6 +165,12 @@ namespace lms::db
                 throw e;
             }
         }
+
+        // Not mapped, depends on the user and track tables
+        {
+            auto transaction{ createWriteTransaction() };
+            listenStats::createTable(*this);
+        }
     }
 
     bool Session::migrateSchemaIfNeeded()
@@ -200,6 +208,7 @@ namespace lms::db
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS artwork_id_idx ON artwork(id)");
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS artwork_image_idx ON artwork(image_id)");
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS artwork_track_embedded_image_idx ON artwork(track_embedded_image_id)");
+            utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS artwork_thumbnails_rendered_idx ON artwork(thumbnails_rendered, id)");
 
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS auth_token_user_domain_idx ON auth_token(user_id, domain)");
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS auth_token_domain_expiry_idx ON auth_token(domain, expiry)");
@@ -241,6 +250,10 @@ namespace lms::db
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS listen_track_user_backend_idx ON listen(track_id,user_id,backend)");
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS listen_user_track_backend_date_time_idx ON listen(user_id,track_id,backend,date_time)");
 
+            utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS listen_stats_track_idx ON listen_stats(track_id)");
+            utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS listen_stats_user_backend_listen_count_idx ON listen_stats(user_id,backend,listen_count DESC)");
+            utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS listen_stats_user_backend_last_listen_date_time_idx ON listen_stats(user_id,backend,last_listen_date_time DESC)");
+
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS media_library_id_idx ON media_library(id)");
 
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS medium_release_position_idx ON medium(release_id, position)");
@@ -320,6 +333,8 @@ namespace lms::db
 
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS starred_track_user_backend_idx ON starred_track(user_id,backend)");
             utils::executeCommand(_session, "CREATE INDEX IF NOT EXISTS starred_track_track_user_backend_idx ON starred_track(track_id,user_id,backend)");
+
+            fts::createTables(*this);
         }
 
         LMS_LOG(DB, INFO, "Indexes created!");
@@ -374,7 +389,8 @@ namespace lms::db
     {
         checkReadTransaction();
 
-        const std::vector<std::string> entryList{ utils::fetchQueryResults(_session.query<std::string>("SELECT name FROM sqlite_master WHERE type='table' AND name NOT LIKE 'sqlite_%'")) };
+        // full text search shadow tables are never empty
+        const std::vector<std::string> entryList{ utils::fetchQueryResults(_session.query<std::string>("SELECT name FROM sqlite_master WHERE type='table' AND name NOT LIKE 'sqlite_%' AND name NOT GLOB '*_fts_*'")) };
 
         return std::all_of(entryList.cbegin(), entryList.cend(), [this](const std::string& entry) {
             const auto count{ utils::fetchQuerySingleResult(_session.query<long>("SELECT COUNT(*) FROM " + entry)) };
@@ -93,6 +93,7 @@ namespace lms::db::utils
 
         ScopedQueryProfiler queryProfiler{ query };
         forEachResult(query.resultList(), [&](const auto& result) {
+            queryProfiler.addRows();
             queryProfiler.suspend();
             func(result);
             queryProfiler.resume();
@@ -106,7 +107,9 @@ namespace lms::db::utils
 
         ScopedQueryProfiler queryProfiler{ query };
         auto collection{ query.resultList() };
-        return std::vector<T>(collection.begin(), collection.end());
+        std::vector<T> results(collection.begin(), collection.end());
+        queryProfiler.addRows(results.size());
+        return results;
     }
 
     template<typename Query>
@@ -116,7 +119,9 @@ namespace lms::db::utils
 
         ScopedQueryProfiler queryProfiler{ query };
         auto collection{ query.resultList() };
-        return std::vector<typename QueryResultType<Query>::type>(collection.begin(), collection.end());
+        std::vector<typename QueryResultType<Query>::type> results(collection.begin(), collection.end());
+        queryProfiler.addRows(results.size());
+        return results;
     }
 
     template<typename Query>
@@ -124,6 +129,7 @@ namespace lms::db::utils
     {
         LMS_SCOPED_TRACE_DETAILED_WITH_ARG("Database", "FetchQuerySingleResult", "Query", query.asString());
         ScopedQueryProfiler queryProfiler{ query };
+        queryProfiler.addRows();
         return query.resultValue();
     }
 
@@ -184,6 +190,7 @@ namespace lms::db::utils
                 break;
             }
 
+            queryProfiler.addRows();
             queryProfiler.suspend();
             func(*it);
             queryProfiler.resume();
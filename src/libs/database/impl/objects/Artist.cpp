@@ -18,6 +18,8 @@
  */
 #include "database/objects/Artist.hpp"
 
+#include <array>
+
 #include <Wt/Dbo/Impl.h>
 #include <Wt/Dbo/WtSqlTraits.h>
 
@@ -30,6 +32,9 @@
 #include "database/objects/Track.hpp"
 #include "database/objects/User.hpp"
 
+#include "FullTextSearch.hpp"
+#include "KeysetPagination.hpp"
+#include "RandomSampling.hpp"
 #include "SqlQuery.hpp"
 #include "Utils.hpp"
 #include "objects/detail/Types.hpp"
@@ -42,6 +47,32 @@ namespace lms::db
 {
     namespace
     {
+        constexpr std::array<std::string_view, 1> artistIdSortColumns{ "id" };
+        constexpr std::array<std::string_view, 2> artistNameSortColumns{ "name COLLATE NOCASE", "id" };
+        constexpr std::array<std::string_view, 2> artistSortNameSortColumns{ "sort_name COLLATE NOCASE", "id" };
+
+        std::optional<keyset::Ordering> getKeysetOrdering(ArtistSortMethod sortMethod)
+        {
+            switch (sortMethod)
+            {
+            case ArtistSortMethod::Id:
+                return keyset::Ordering{ artistIdSortColumns };
+            case ArtistSortMethod::Name:
+                return keyset::Ordering{ artistNameSortColumns };
+            case ArtistSortMethod::SortName:
+                return keyset::Ordering{ artistSortNameSortColumns };
+            case ArtistSortMethod::None:
+            case ArtistSortMethod::Random:
+            case ArtistSortMethod::LastWrittenDesc:
+            case ArtistSortMethod::AddedDesc:
+            case ArtistSortMethod::StarredDateDesc:
+            case ArtistSortMethod::Relevance:
+                break;
+            }
+
+            return std::nullopt;
+        }
+
         template<typename ResultType>
         Wt::Dbo::Query<ResultType> createQuery(Session& session, std::string_view itemToSelect, const Artist::FindParameters& params)
         {
@@ -104,25 +135,7 @@ namespace lms::db
             if (params.trackArtistLinkType.has_value())
                 query.where("+t_a_l.type = ?").bind(*params.trackArtistLinkType); // Exclude this since the query planner does not do a good job when db is not analyzed
 
-            if (!params.keywords.empty())
-            {
-                std::vector<std::string> clauses;
-                std::vector<std::string> sortClauses;
-
-                for (const std::string_view keyword : params.keywords)
-                {
-                    clauses.push_back("a.name LIKE ? ESCAPE '" ESCAPE_CHAR_STR "'");
-                    query.bind("%" + utils::escapeForLikeKeyword(keyword) + "%");
-                }
-
-                for (const std::string_view keyword : params.keywords)
-                {
-                    sortClauses.push_back("a.sort_name LIKE ? ESCAPE '" ESCAPE_CHAR_STR "'");
-                    query.bind("%" + utils::escapeForLikeKeyword(keyword) + "%");
-                }
-
-                query.where("(" + core::stringUtils::joinStrings(clauses, " AND ") + ") OR (" + core::stringUtils::joinStrings(sortClauses, " AND ") + ")");
-            }
+            const bool fullTextSearchJoined{ fts::applyKeywordsFilter(query, fts::artistTable, "a", params.keywords) };
 
             if (params.starringUser.isValid())
             {
@@ -164,18 +177,21 @@ namespace lms::db
             if (params.track.isValid())
                 query.where("t_a_l.track_id = ?").bind(params.track);
 
+            const std::optional<keyset::Ordering> keysetOrdering{ getKeysetOrdering(params.sortMethod) };
+            if (params.lastArtistId.isValid())
+            {
+                assert(keysetOrdering);
+                keyset::applyStartAfterFilter(query, *keysetOrdering, "artist", "a", params.lastArtistId);
+            }
+
             switch (params.sortMethod)
             {
             case ArtistSortMethod::None:
                 break;
             case ArtistSortMethod::Id:
-                query.orderBy("a.id");
-                break;
             case ArtistSortMethod::Name:
-                query.orderBy("a.name COLLATE NOCASE");
-                break;
             case ArtistSortMethod::SortName:
-                query.orderBy("a.sort_name COLLATE NOCASE");
+                query.orderBy(keyset::createOrderByClause(*keysetOrdering, "a"));
                 break;
             case ArtistSortMethod::Random:
                 query.orderBy("RANDOM()");
@@ -190,9 +206,15 @@ namespace lms::db
                 assert(params.starringUser.isValid());
                 query.orderBy("s_a.date_time DESC");
                 break;
+            case ArtistSortMethod::Relevance:
+                if (fullTextSearchJoined)
+                    query.orderBy(fts::getRankColumn(fts::artistTable) + ",a.id");
+                else
+                    query.orderBy("a.id");
+                break;
             }
 
-            query.groupBy("a.id");
+            query.groupBy(keysetOrdering ? keyset::createGroupByClause(*keysetOrdering, "a") : "a.id");
 
             return query;
         }
@@ -211,6 +233,18 @@ namespace lms::db
 
             return createQuery<ResultType>(session, itemToSelect, params);
         }
+
+        std::optional<RangeResults<ArtistId>> sampleRandomIds(Session& session, const Artist::FindParameters& params)
+        {
+            if (params.sortMethod != ArtistSortMethod::Random || !params.range)
+                return std::nullopt;
+
+            Artist::FindParameters sampleParams{ params };
+            sampleParams.setSortMethod(ArtistSortMethod::Id);
+            sampleParams.setRange(std::nullopt);
+
+            return randomSampling::sampleIds<ArtistId>(session, "artist", "a", *params.range, [&] { return createQuery<ArtistId>(session, sampleParams); });
+        }
     } // namespace
 
     Artist::Artist(const std::string& name, const std::optional<core::UUID>& mbid)
@@ -286,6 +320,9 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledArtists{ sampleRandomIds(session, params) })
+            return std::move(*sampledArtists);
+
         auto query{ createQuery<ArtistId>(session, params) };
         return utils::execRangeQuery<ArtistId>(query, params.range);
     }
@@ -294,6 +331,16 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledArtists{ sampleRandomIds(session, params) })
+        {
+            RangeResults<pointer> res{ .range = sampledArtists->range, .results = {}, .moreResults = sampledArtists->moreResults };
+            res.results.reserve(sampledArtists->results.size());
+            for (const ArtistId artistId : sampledArtists->results)
+                res.results.push_back(find(session, artistId));
+
+            return res;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Artist>>(session, params) };
         return utils::execRangeQuery<Artist::pointer>(query, params.range);
     }
@@ -302,6 +349,14 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (const auto sampledArtists{ sampleRandomIds(session, params) })
+        {
+            for (const ArtistId artistId : sampledArtists->results)
+                func(find(session, artistId));
+
+            return;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Artist>>(session, params) };
         utils::forEachQueryRangeResult(query, params.range, func);
     }
@@ -347,6 +402,11 @@ AND NOT EXISTS (
         return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT 1 FROM artist").where("id = ?").bind(id)) == 1;
     }
 
+    bool Artist::isKeysetPaginationSupported(ArtistSortMethod sortMethod)
+    {
+        return getKeysetOrdering(sortMethod).has_value();
+    }
+
     RangeResults<Artist::pointer> Artist::findWithMBIDNameVariants(Session& session, ArtistId& lastRetrievedArtist, std::optional<Range> range)
     {
         session.checkReadTransaction();
@@ -54,6 +54,21 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<Wt::Dbo::ptr<ArtistInfo>>("SELECT a_i from artist_info a_i").where("a_i.absolute_file_path = ?").bind(p));
     }
 
+    void ArtistInfo::findFileInfos(Session& session, ArtistInfoId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<ArtistInfoId, std::filesystem::path, Wt::WDateTime, int>>("SELECT a_i.id, a_i.absolute_file_path, a_i.file_last_write, a_i.scan_version FROM artist_info a_i").orderBy("a_i.id").where("a_i.id > ?").bind(lastRetrievedId).limit(static_cast<int>(count)) };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            FileInfo fileInfo;
+            fileInfo.lastWrittenTime = std::get<2>(res);
+            fileInfo.scanVersion = std::get<3>(res);
+            func(std::get<1>(res), fileInfo);
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
     ArtistInfo::pointer ArtistInfo::find(Session& session, ArtistInfoId id)
     {
         session.checkReadTransaction();
@@ -80,6 +80,57 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<Wt::Dbo::ptr<Artwork>>("SELECT a FROM artwork a").where("a.image_id = ?").bind(id));
     }
 
+    void Artwork::findLastWrittenTime(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId, const Wt::WDateTime& lastWrittenTime)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<ArtworkId, Wt::WDateTime>>("SELECT artwork.id, MAX(COALESCE(image.file_last_write, track.file_last_write)) FROM artwork") };
+        query.leftJoin("image ON artwork.image_id = image.id");
+        query.leftJoin("track_embedded_image ON artwork.track_embedded_image_id = track_embedded_image.id");
+        query.leftJoin("track_embedded_image_link ON track_embedded_image.id = track_embedded_image_link.track_embedded_image_id");
+        query.leftJoin("track ON track.id = track_embedded_image_link.track_id");
+        query.where("artwork.id > ?").bind(lastRetrievedId);
+        query.groupBy("artwork.id");
+        query.orderBy("artwork.id");
+        query.limit(static_cast<int>(count));
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            func(std::get<0>(res), std::get<1>(res));
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
+    void Artwork::findIds(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<ArtworkId>("SELECT a.id FROM artwork a") };
+        query.where("a.id > ?").bind(lastRetrievedId);
+        query.orderBy("a.id");
+        query.limit(static_cast<int>(count));
+
+        utils::forEachQueryResult(query, [&](ArtworkId artworkId) {
+            func(artworkId);
+            lastRetrievedId = artworkId;
+        });
+    }
+
+    void Artwork::findIdsWithoutRenderedThumbnails(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<ArtworkId>("SELECT a.id FROM artwork a") };
+        query.where("a.thumbnails_rendered = FALSE");
+        query.where("a.id > ?").bind(lastRetrievedId);
+        query.orderBy("a.id");
+        query.limit(static_cast<int>(count));
+
+        utils::forEachQueryResult(query, [&](ArtworkId artworkId) {
+            func(artworkId);
+            lastRetrievedId = artworkId;
+        });
+    }
+
     Artwork::UnderlyingId Artwork::getUnderlyingId() const
     {
         Artwork::UnderlyingId res;
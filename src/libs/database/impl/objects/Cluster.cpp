@@ -178,6 +178,22 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT COUNT(DISTINCT t.release_id) FROM track t INNER JOIN track_cluster t_c ON t_c.track_id = t.id").where("t_c.cluster_id = ?").bind(id));
     }
 
+    std::size_t Cluster::updateCounts(Session& session)
+    {
+        session.checkWriteTransaction();
+
+        // Only write the rows that actually change
+        utils::executeCommand(*session.getDboSession(), R"(UPDATE cluster SET track_count = s.track_count, release_count = s.release_count
+FROM (SELECT c.id AS cluster_id, COUNT(t.id) AS track_count, COUNT(DISTINCT t.release_id) AS release_count
+    FROM cluster c
+    LEFT JOIN track_cluster t_c ON t_c.cluster_id = c.id
+    LEFT JOIN track t ON t.id = t_c.track_id
+    GROUP BY c.id) AS s
+WHERE cluster.id = s.cluster_id AND (cluster.track_count IS NOT s.track_count OR cluster.release_count IS NOT s.release_count))");
+
+        return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT changes()"));
+    }
+
     void Cluster::addTrack(ObjectPtr<Track> track)
     {
         _tracks.insert(getDboPtr(track));
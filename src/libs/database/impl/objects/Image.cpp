@@ -93,6 +93,20 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<Wt::Dbo::ptr<Image>>("SELECT i from image i").where("i.absolute_file_path = ?").bind(file));
     }
 
+    void Image::findFileInfos(Session& session, ImageId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<ImageId, std::filesystem::path, Wt::WDateTime>>("SELECT i.id, i.absolute_file_path, i.file_last_write FROM image i").orderBy("i.id").where("i.id > ?").bind(lastRetrievedId).limit(static_cast<int>(count)) };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            FileInfo fileInfo;
+            fileInfo.lastWrittenTime = std::get<2>(res);
+            func(std::get<1>(res), fileInfo);
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
     void Image::find(Session& session, ImageId& lastRetrievedId, std::size_t count, const std::function<void(const Image::pointer&)>& func)
     {
         session.checkReadTransaction();
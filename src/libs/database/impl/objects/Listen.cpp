@@ -26,6 +26,7 @@
 #include "database/objects/Track.hpp"
 #include "database/objects/User.hpp"
 
+#include "ListenStats.hpp"
 #include "SqlQuery.hpp"
 #include "Utils.hpp"
 #include "objects/detail/Types.hpp"
@@ -39,13 +40,13 @@ namespace lms::db
     {
         Wt::Dbo::Query<ArtistId> createArtistsQuery(Session& session, const Listen::ArtistStatsFindParameters& params)
         {
-            auto query{ session.getDboSession()->query<ArtistId>("SELECT a.id from artist a").join("track_artist_link t_a_l ON t_a_l.artist_id = a.id").join("listen l ON l.track_id = t_a_l.track_id") };
+            auto query{ session.getDboSession()->query<ArtistId>("SELECT a.id from artist a").join("track_artist_link t_a_l ON t_a_l.artist_id = a.id").join("listen_stats l_s ON l_s.track_id = t_a_l.track_id") };
 
             if (params.user.isValid())
-                query.where("l.user_id = ?").bind(params.user);
+                query.where("l_s.user_id = ?").bind(params.user);
 
             if (params.backend)
-                query.where("l.backend = ?").bind(*params.backend);
+                query.where("l_s.backend = ?").bind(*params.backend);
 
             assert(!params.artist.isValid()); // poor check
 
@@ -126,13 +127,13 @@ namespace lms::db
 
         Wt::Dbo::Query<ReleaseId> createReleasesQuery(Session& session, const Listen::StatsFindParameters& params)
         {
-            auto query{ session.getDboSession()->query<ReleaseId>("SELECT r.id from release r").join("track t ON t.release_id = r.id").join("listen l ON l.track_id = t.id") };
+            auto query{ session.getDboSession()->query<ReleaseId>("SELECT r.id from release r").join("track t ON t.release_id = r.id").join("listen_stats l_s ON l_s.track_id = t.id") };
 
             if (params.user.isValid())
-                query.where("l.user_id = ?").bind(params.user);
+                query.where("l_s.user_id = ?").bind(params.user);
 
             if (params.backend)
-                query.where("l.backend = ?").bind(*params.backend);
+                query.where("l_s.backend = ?").bind(*params.backend);
 
             if (params.artist.isValid())
             {
@@ -185,13 +186,13 @@ namespace lms::db
 
         Wt::Dbo::Query<TrackId> createTracksQuery(Session& session, const Listen::StatsFindParameters& params)
         {
-            auto query{ session.getDboSession()->query<TrackId>("SELECT t.id from track t").join("listen l ON l.track_id = t.id") };
+            auto query{ session.getDboSession()->query<TrackId>("SELECT t.id from track t").join("listen_stats l_s ON l_s.track_id = t.id") };
 
             if (params.user.isValid())
-                query.where("l.user_id = ?").bind(params.user);
+                query.where("l_s.user_id = ?").bind(params.user);
 
             if (params.backend)
-                query.where("l.backend = ?").bind(*params.backend);
+                query.where("l_s.backend = ?").bind(*params.backend);
 
             if (params.artist.isValid())
             {
@@ -296,11 +297,9 @@ namespace lms::db
     RangeResults<ArtistId> Listen::getTopArtists(Session& session, const ArtistStatsFindParameters& params)
     {
         session.checkReadTransaction();
-        auto query{ createArtistsQuery(session, params) };
-
-        auto collection{ query
-                             .orderBy("COUNT(a.id) DESC")
-                             .groupBy("a.id") };
+        auto query{ createArtistsQuery(session, params)
+                        .orderBy("SUM(l_s.listen_count) DESC")
+                        .groupBy("a.id") };
 
         return utils::execRangeQuery<ArtistId>(query, params.range);
     }
@@ -309,7 +308,7 @@ namespace lms::db
     {
         session.checkReadTransaction();
         auto query{ createReleasesQuery(session, params)
-                        .orderBy("COUNT(r.id) DESC")
+                        .orderBy("SUM(l_s.listen_count) DESC")
                         .groupBy("r.id") };
 
         return utils::execRangeQuery<ReleaseId>(query, params.range);
@@ -319,7 +318,7 @@ namespace lms::db
     {
         session.checkReadTransaction();
         auto query{ createTracksQuery(session, params)
-                        .orderBy("COUNT(t.id) DESC")
+                        .orderBy("SUM(l_s.listen_count) DESC")
                         .groupBy("t.id") };
 
         return utils::execRangeQuery<TrackId>(query, params.range);
@@ -330,8 +329,7 @@ namespace lms::db
         session.checkReadTransaction();
         auto query{ createArtistsQuery(session, params)
                         .groupBy("a.id")
-                        .having("l.date_time = MAX(l.date_time)")
-                        .orderBy("l.date_time DESC") };
+                        .orderBy("MAX(l_s.last_listen_date_time) DESC") };
 
         return utils::execRangeQuery<ArtistId>(query, params.range);
     }
@@ -341,8 +339,7 @@ namespace lms::db
         session.checkReadTransaction();
         auto query{ createReleasesQuery(session, params)
                         .groupBy("r.id")
-                        .having("l.date_time = MAX(l.date_time)")
-                        .orderBy("l.date_time DESC") };
+                        .orderBy("MAX(l_s.last_listen_date_time) DESC") };
 
         return utils::execRangeQuery<ReleaseId>(query, params.range);
     }
@@ -352,8 +349,7 @@ namespace lms::db
         session.checkReadTransaction();
         auto query{ createTracksQuery(session, params)
                         .groupBy("t.id")
-                        .having("l.date_time = MAX(l.date_time)")
-                        .orderBy("l.date_time DESC") };
+                        .orderBy("MAX(l_s.last_listen_date_time) DESC") };
 
         return utils::execRangeQuery<TrackId>(query, params.range);
     }
@@ -362,7 +358,7 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
-        return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT COUNT(*) from listen l").join("user u ON u.id = l.user_id").where("l.track_id = ?").bind(trackId).where("l.user_id = ?").bind(userId).where("l.backend = u.scrobbling_backend"));
+        return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT IFNULL(SUM(l_s.listen_count), 0) from listen_stats l_s").join("user u ON u.id = l_s.user_id").where("l_s.track_id = ?").bind(trackId).where("l_s.user_id = ?").bind(userId).where("l_s.backend = u.scrobbling_backend"));
     }
 
     std::size_t Listen::getCount(Session& session, UserId userId, ReleaseId releaseId)
@@ -370,18 +366,22 @@ namespace lms::db
         session.checkReadTransaction();
 
         return utils::fetchQuerySingleResult(session.getDboSession()->query<int>(
-                                                                        "SELECT IFNULL(MIN(count_result), 0)"
-                                                                        " FROM ("
-                                                                        " SELECT COUNT(l.track_id) AS count_result"
+                                                                        "SELECT IFNULL(MIN(IFNULL(l_s.listen_count, 0)), 0)"
                                                                         " FROM track t"
-                                                                        " LEFT JOIN listen l ON t.id = l.track_id AND l.backend = (SELECT scrobbling_backend FROM user WHERE id = ?) AND l.user_id = ?"
-                                                                        " WHERE t.release_id = ?"
-                                                                        " GROUP BY t.id)")
+                                                                        " LEFT JOIN listen_stats l_s ON t.id = l_s.track_id AND l_s.backend = (SELECT scrobbling_backend FROM user WHERE id = ?) AND l_s.user_id = ?"
+                                                                        " WHERE t.release_id = ?")
                                                  .bind(userId)
                                                  .bind(userId)
                                                  .bind(releaseId));
     }
 
+    void Listen::rebuildStats(Session& session)
+    {
+        session.checkWriteTransaction();
+
+        listenStats::rebuildTable(session);
+    }
+
     Listen::pointer Listen::getMostRecentListen(Session& session, UserId userId, ScrobblingBackend backend, ReleaseId releaseId)
     {
         session.checkReadTransaction();
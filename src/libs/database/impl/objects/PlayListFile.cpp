@@ -64,6 +64,20 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<Wt::Dbo::ptr<PlayListFile>>("SELECT pl_f from playlist_file pl_f").where("pl_f.absolute_file_path = ?").bind(p));
     }
 
+    void PlayListFile::findFileInfos(Session& session, PlayListFileId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<PlayListFileId, std::filesystem::path, Wt::WDateTime>>("SELECT pl_f.id, pl_f.absolute_file_path, pl_f.file_last_write FROM playlist_file pl_f").orderBy("pl_f.id").where("pl_f.id > ?").bind(lastRetrievedId).limit(static_cast<int>(count)) };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            FileInfo fileInfo;
+            fileInfo.lastWrittenTime = std::get<2>(res);
+            func(std::get<1>(res), fileInfo);
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
     void PlayListFile::find(Session& session, PlayListFileId& lastRetrievedId, std::size_t count, const std::function<void(const pointer&)>& func)
     {
         session.checkReadTransaction();
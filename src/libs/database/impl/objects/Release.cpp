@@ -19,6 +19,8 @@
 
 #include "database/objects/Release.hpp"
 
+#include <array>
+
 #include <Wt/Dbo/Impl.h>
 #include <Wt/Dbo/WtSqlTraits.h>
 
@@ -39,6 +41,9 @@
 #include "database/objects/TrackLyrics.hpp"
 #include "database/objects/User.hpp"
 
+#include "FullTextSearch.hpp"
+#include "KeysetPagination.hpp"
+#include "RandomSampling.hpp"
 #include "SqlQuery.hpp"
 #include "Utils.hpp"
 #include "detail/Types.hpp"
@@ -56,6 +61,37 @@ namespace lms::db
 {
     namespace
     {
+        constexpr std::array<std::string_view, 1> releaseIdSortColumns{ "id" };
+        constexpr std::array<std::string_view, 2> releaseNameSortColumns{ "name COLLATE NOCASE", "id" };
+        constexpr std::array<std::string_view, 2> releaseSortNameSortColumns{ "sort_name COLLATE NOCASE", "id" };
+
+        std::optional<keyset::Ordering> getKeysetOrdering(ReleaseSortMethod sortMethod)
+        {
+            switch (sortMethod)
+            {
+            case ReleaseSortMethod::Id:
+                return keyset::Ordering{ releaseIdSortColumns };
+            case ReleaseSortMethod::Name:
+                return keyset::Ordering{ releaseNameSortColumns };
+            case ReleaseSortMethod::SortName:
+                return keyset::Ordering{ releaseSortNameSortColumns };
+            case ReleaseSortMethod::None:
+            case ReleaseSortMethod::ArtistNameThenName:
+            case ReleaseSortMethod::DateAsc:
+            case ReleaseSortMethod::DateDesc:
+            case ReleaseSortMethod::OriginalDate:
+            case ReleaseSortMethod::OriginalDateDesc:
+            case ReleaseSortMethod::Random:
+            case ReleaseSortMethod::LastWrittenDesc:
+            case ReleaseSortMethod::AddedDesc:
+            case ReleaseSortMethod::StarredDateDesc:
+            case ReleaseSortMethod::Relevance:
+                break;
+            }
+
+            return std::nullopt;
+        }
+
         template<typename ResultType>
         Wt::Dbo::Query<ResultType> createQuery(Session& session, std::string_view itemToSelect, const Release::FindParameters& params)
         {
@@ -136,8 +172,7 @@ namespace lms::db
             if (!params.name.empty())
                 query.where("r.name = ?").bind(params.name);
 
-            for (std::string_view keyword : params.keywords)
-                query.where("r.name LIKE ? ESCAPE '" ESCAPE_CHAR_STR "'").bind("%" + utils::escapeForLikeKeyword(keyword) + "%");
+            const bool fullTextSearchJoined{ fts::applyKeywordsFilter(query, fts::releaseTable, "r", params.keywords) };
 
             if (params.starringUser.isValid())
             {
@@ -220,18 +255,21 @@ namespace lms::db
             if (params.releaseGroupMBID)
                 query.where("group_mbid = ?").bind(params.releaseGroupMBID->getAsString());
 
+            const std::optional<keyset::Ordering> keysetOrdering{ getKeysetOrdering(params.sortMethod) };
+            if (params.lastReleaseId.isValid())
+            {
+                assert(keysetOrdering);
+                keyset::applyStartAfterFilter(query, *keysetOrdering, "release", "r", params.lastReleaseId);
+            }
+
             switch (params.sortMethod)
             {
             case ReleaseSortMethod::None:
                 break;
             case ReleaseSortMethod::Id:
-                query.orderBy("r.id");
-                break;
             case ReleaseSortMethod::Name:
-                query.orderBy("r.name COLLATE NOCASE");
-                break;
             case ReleaseSortMethod::SortName:
-                query.orderBy("r.sort_name COLLATE NOCASE");
+                query.orderBy(keyset::createOrderByClause(*keysetOrdering, "r"));
                 break;
             case ReleaseSortMethod::ArtistNameThenName:
                 query.orderBy("a.name COLLATE NOCASE, r.name COLLATE NOCASE");
@@ -261,6 +299,12 @@ namespace lms::db
                 assert(params.starringUser.isValid());
                 query.orderBy("s_r.date_time DESC");
                 break;
+            case ReleaseSortMethod::Relevance:
+                if (fullTextSearchJoined)
+                    query.orderBy(fts::getRankColumn(fts::releaseTable) + ",r.id");
+                else
+                    query.orderBy("r.id");
+                break;
             }
 
             return query;
@@ -282,6 +326,17 @@ namespace lms::db
             return query;
         };
 
+        std::optional<RangeResults<ReleaseId>> sampleRandomIds(Session& session, const Release::FindParameters& params)
+        {
+            if (params.sortMethod != ReleaseSortMethod::Random || !params.range)
+                return std::nullopt;
+
+            Release::FindParameters sampleParams{ params };
+            sampleParams.setSortMethod(ReleaseSortMethod::Id);
+            sampleParams.setRange(std::nullopt);
+
+            return randomSampling::sampleIds<ReleaseId>(session, "release", "r", *params.range, [&] { return createQuery<ReleaseId>(session, "DISTINCT r.id", sampleParams); });
+        }
     } // namespace
 
     Country::Country(std::string_view name)
@@ -483,6 +538,11 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT 1 FROM release").where("id = ?").bind(id)) == 1;
     }
 
+    bool Release::isKeysetPaginationSupported(ReleaseSortMethod sortMethod)
+    {
+        return getKeysetOrdering(sortMethod).has_value();
+    }
+
     std::size_t Release::getCount(Session& session)
     {
         session.checkReadTransaction();
@@ -541,6 +601,16 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledReleases{ sampleRandomIds(session, params) })
+        {
+            RangeResults<pointer> res{ .range = sampledReleases->range, .results = {}, .moreResults = sampledReleases->moreResults };
+            res.results.reserve(sampledReleases->results.size());
+            for (const ReleaseId releaseId : sampledReleases->results)
+                res.results.push_back(find(session, releaseId));
+
+            return res;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Release>>(session, "DISTINCT r", params) };
         return utils::execRangeQuery<pointer>(query, params.range);
     }
@@ -549,6 +619,14 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (const auto sampledReleases{ sampleRandomIds(session, params) })
+        {
+            for (const ReleaseId releaseId : sampledReleases->results)
+                func(find(session, releaseId));
+
+            return;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Release>>(session, "DISTINCT r", params) };
         utils::forEachQueryRangeResult(query, params.range, func);
     }
@@ -557,6 +635,9 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledReleases{ sampleRandomIds(session, params) })
+            return std::move(*sampledReleases);
+
         auto query{ createQuery<ReleaseId>(session, "DISTINCT r.id", params) };
         return utils::execRangeQuery<ReleaseId>(query, params.range);
     }
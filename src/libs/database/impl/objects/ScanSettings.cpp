@@ -23,6 +23,7 @@
 #include <Wt/Dbo/WtSqlTraits.h>
 
 #include "core/String.hpp"
+#include "core/UUID.hpp"
 #include "database/Session.hpp"
 #include "database/objects/MediaLibrary.hpp"
 
@@ -36,6 +37,7 @@ namespace lms::db
 {
     ScanSettings::ScanSettings(std::string_view name)
         : _name{ name }
+        , _databaseId{ core::UUID::generate().getAsString() }
     {
     }
 
@@ -141,4 +143,9 @@ namespace lms::db
     {
         _audioScanVersion += 1;
     }
+
+    void ScanSettings::incScanGeneration()
+    {
+        _scanGeneration += 1;
+    }
 } // namespace lms::db
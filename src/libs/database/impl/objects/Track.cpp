@@ -19,6 +19,8 @@
 
 #include "database/objects/Track.hpp"
 
+#include <array>
+
 #include <Wt/Dbo/Impl.h>
 #include <Wt/Dbo/WtSqlTraits.h>
 
@@ -39,6 +41,9 @@
 #include "database/objects/TrackLyrics.hpp"
 #include "database/objects/User.hpp"
 
+#include "FullTextSearch.hpp"
+#include "KeysetPagination.hpp"
+#include "RandomSampling.hpp"
 #include "SqlQuery.hpp"
 #include "Utils.hpp"
 #include "objects/detail/Types.hpp"
@@ -53,6 +58,37 @@ namespace lms::db
 {
     namespace
     {
+        constexpr std::array<std::string_view, 1> trackIdSortColumns{ "id" };
+        constexpr std::array<std::string_view, 2> trackNameSortColumns{ "name COLLATE NOCASE", "id" };
+        constexpr std::array<std::string_view, 2> trackAbsoluteFilePathSortColumns{ "absolute_file_path COLLATE NOCASE", "id" };
+
+        std::optional<keyset::Ordering> getKeysetOrdering(TrackSortMethod sortMethod)
+        {
+            switch (sortMethod)
+            {
+            case TrackSortMethod::Id:
+                return keyset::Ordering{ trackIdSortColumns };
+            case TrackSortMethod::Name:
+                return keyset::Ordering{ trackNameSortColumns };
+            case TrackSortMethod::AbsoluteFilePath:
+                return keyset::Ordering{ trackAbsoluteFilePathSortColumns };
+            case TrackSortMethod::None:
+            case TrackSortMethod::Random:
+            case TrackSortMethod::LastWrittenDesc: // nullable columns
+            case TrackSortMethod::AddedDesc:
+            case TrackSortMethod::StarredDateDesc:
+            case TrackSortMethod::DateDescAndRelease:
+            case TrackSortMethod::OriginalDateDescAndRelease:
+            case TrackSortMethod::Release:
+            case TrackSortMethod::TrackList:
+            case TrackSortMethod::TrackNumber:
+            case TrackSortMethod::Relevance:
+                break;
+            }
+
+            return std::nullopt;
+        }
+
         template<typename ResultType>
         Wt::Dbo::Query<ResultType> createQuery(Session& session, std::string_view itemToSelect, const Track::FindParameters& params)
         {
@@ -61,8 +97,7 @@ namespace lms::db
             auto query{ session.getDboSession()->query<ResultType>("SELECT " + std::string{ itemToSelect } + " FROM track t") };
 
             assert(params.keywords.empty() || params.name.empty());
-            for (std::string_view keyword : params.keywords)
-                query.where("t.name LIKE ? ESCAPE '" ESCAPE_CHAR_STR "'").bind("%" + utils::escapeForLikeKeyword(keyword) + "%");
+            const bool fullTextSearchJoined{ fts::applyKeywordsFilter(query, fts::trackTable, "t", params.keywords) };
 
             if (!params.name.empty())
                 query.where("t.name = ?").bind(params.name);
@@ -198,12 +233,6 @@ namespace lms::db
                     query.where("NOT EXISTS (SELECT t_m_e.track_id FROM track_musicnn_embeddings t_m_e WHERE t_m_e.track_id = t.id)");
             }
 
-            if (params.lastTrackId.isValid())
-            {
-                assert(params.sortMethod == TrackSortMethod::Id);
-                query.where("t.id > ?").bind(params.lastTrackId);
-            }
-
             if (params.embeddedImageId.isValid())
             {
                 query.join("track_embedded_image_link t_e_i_l ON t_e_i_l.track_id = t.id");
@@ -213,12 +242,21 @@ namespace lms::db
             if (params.filters.codec.has_value())
                 query.where("t.codec = ?").bind(detail::getDbCodec(*params.filters.codec));
 
+            const std::optional<keyset::Ordering> keysetOrdering{ getKeysetOrdering(params.sortMethod) };
+            if (params.lastTrackId.isValid())
+            {
+                assert(keysetOrdering);
+                keyset::applyStartAfterFilter(query, *keysetOrdering, "track", "t", params.lastTrackId);
+            }
+
             switch (params.sortMethod)
             {
             case TrackSortMethod::None:
                 break;
             case TrackSortMethod::Id:
-                query.orderBy("t.id");
+            case TrackSortMethod::Name:
+            case TrackSortMethod::AbsoluteFilePath:
+                query.orderBy(keyset::createOrderByClause(*keysetOrdering, "t"));
                 break;
             case TrackSortMethod::LastWrittenDesc:
                 query.orderBy("t.file_last_write DESC");
@@ -233,12 +271,6 @@ namespace lms::db
                 assert(params.starringUser.isValid());
                 query.orderBy("s_t.date_time DESC");
                 break;
-            case TrackSortMethod::Name:
-                query.orderBy("t.name COLLATE NOCASE");
-                break;
-            case TrackSortMethod::AbsoluteFilePath:
-                query.orderBy("t.absolute_file_path COLLATE NOCASE");
-                break;
             case TrackSortMethod::DateDescAndRelease:
                 query.orderBy("t.date DESC,t.release_id,m.position,t.track_number");
                 break;
@@ -255,6 +287,12 @@ namespace lms::db
             case TrackSortMethod::TrackNumber:
                 query.orderBy("t.track_number");
                 break;
+            case TrackSortMethod::Relevance:
+                if (fullTextSearchJoined)
+                    query.orderBy(fts::getRankColumn(fts::trackTable) + ",t.id");
+                else
+                    query.orderBy("t.id");
+                break;
             }
             return query;
         }
@@ -273,6 +311,18 @@ namespace lms::db
 
             return createQuery<ResultType>(session, itemToSelect, params);
         }
+
+        std::optional<RangeResults<TrackId>> sampleRandomIds(Session& session, const Track::FindParameters& params)
+        {
+            if (params.sortMethod != TrackSortMethod::Random || !params.range)
+                return std::nullopt;
+
+            Track::FindParameters sampleParams{ params };
+            sampleParams.setSortMethod(TrackSortMethod::Id);
+            sampleParams.setRange(std::nullopt);
+
+            return randomSampling::sampleIds<TrackId>(session, "track", "t", *params.range, [&] { return createQuery<TrackId>(session, sampleParams); });
+        }
     } // namespace
 
     Track::pointer Track::create(Session& session)
@@ -313,6 +363,21 @@ namespace lms::db
         return result;
     }
 
+    void Track::findFileInfos(Session& session, TrackId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<TrackId, std::filesystem::path, Wt::WDateTime, int>>("SELECT t.id, t.absolute_file_path, t.file_last_write, t.scan_version FROM track t").orderBy("t.id").where("t.id > ?").bind(lastRetrievedId).limit(static_cast<int>(count)) };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            FileInfo fileInfo;
+            fileInfo.lastWrittenTime = std::get<2>(res);
+            fileInfo.scanVersion = std::get<3>(res);
+            func(std::get<1>(res), fileInfo);
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
     Track::pointer Track::find(Session& session, TrackId id)
     {
         session.checkReadTransaction();
@@ -360,6 +425,17 @@ namespace lms::db
         });
     }
 
+    void Track::findReleaseIds(Session& session, const std::function<void(TrackId trackId, ReleaseId releaseId)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<TrackId, ReleaseId>>("SELECT t.id, t.release_id FROM track t").where("t.release_id IS NOT NULL").orderBy("t.id") };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            func(std::get<0>(res), std::get<1>(res));
+        });
+    }
+
     void Track::find(Session& session, const IdRange<TrackId>& idRange, const std::function<void(const Track::pointer&)>& func)
     {
         assert(idRange.isValid());
@@ -388,6 +464,11 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<int>("SELECT 1 from track").where("id = ?").bind(id)) == 1;
     }
 
+    bool Track::isKeysetPaginationSupported(TrackSortMethod sortMethod)
+    {
+        return getKeysetOrdering(sortMethod).has_value();
+    }
+
     std::vector<Track::pointer> Track::findByMBID(Session& session, const core::UUID& mbid)
     {
         session.checkReadTransaction();
@@ -479,6 +560,9 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledTracks{ sampleRandomIds(session, parameters) })
+            return std::move(*sampledTracks);
+
         auto query{ createQuery<TrackId>(session, parameters) };
         return utils::execRangeQuery<TrackId>(query, parameters.range);
     }
@@ -487,6 +571,16 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (auto sampledTracks{ sampleRandomIds(session, parameters) })
+        {
+            RangeResults<Track::pointer> res{ .range = sampledTracks->range, .results = {}, .moreResults = sampledTracks->moreResults };
+            res.results.reserve(sampledTracks->results.size());
+            for (const TrackId trackId : sampledTracks->results)
+                res.results.push_back(find(session, trackId));
+
+            return res;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Track>>(session, parameters) };
         return utils::execRangeQuery<Track::pointer>(query, parameters.range);
     }
@@ -495,6 +589,14 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (const auto sampledTracks{ sampleRandomIds(session, params) })
+        {
+            for (const TrackId trackId : sampledTracks->results)
+                func(find(session, trackId));
+
+            return;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Track>>(session, params) };
         utils::forEachQueryRangeResult(query, params.range, func);
     }
@@ -503,6 +605,15 @@ namespace lms::db
     {
         session.checkReadTransaction();
 
+        if (const auto sampledTracks{ sampleRandomIds(session, params) })
+        {
+            for (const TrackId trackId : sampledTracks->results)
+                func(find(session, trackId));
+
+            moreResults = sampledTracks->moreResults;
+            return;
+        }
+
         auto query{ createQuery<Wt::Dbo::ptr<Track>>(session, params) };
         utils::forEachQueryRangeResult(query, params.range, moreResults, func);
     }
@@ -97,6 +97,20 @@ namespace lms::db
         return utils::fetchQuerySingleResult(session.getDboSession()->query<Wt::Dbo::ptr<TrackLyrics>>("SELECT t_lrc from track_lyrics t_lrc").where("t_lrc.absolute_file_path = ?").bind(path));
     }
 
+    void TrackLyrics::findFileInfos(Session& session, TrackLyricsId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<TrackLyricsId, std::filesystem::path, Wt::WDateTime>>("SELECT t_lrc.id, t_lrc.absolute_file_path, t_lrc.file_last_write FROM track_lyrics t_lrc").orderBy("t_lrc.id").where("t_lrc.id > ?").bind(lastRetrievedId).limit(static_cast<int>(count)) };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            FileInfo fileInfo;
+            fileInfo.lastWrittenTime = std::get<2>(res);
+            func(std::get<1>(res), fileInfo);
+            lastRetrievedId = std::get<0>(res);
+        });
+    }
+
     void TrackLyrics::find(Session& session, const FindParameters& params, const std::function<void(const TrackLyrics::pointer&)>& func)
     {
         session.checkReadTransaction();
@@ -80,6 +80,17 @@ namespace lms::db
         });
     }
 
+    void TrackMusicNNEmbeddings::findTrackIds(Session& session, const std::function<void(TrackMusicNNEmbeddingsId embeddingsId, TrackId trackId)>& func)
+    {
+        session.checkReadTransaction();
+
+        auto query{ session.getDboSession()->query<std::tuple<TrackMusicNNEmbeddingsId, TrackId>>("SELECT t_m_e.id, t_m_e.track_id FROM track_musicnn_embeddings t_m_e") };
+
+        utils::forEachQueryResult(query, [&](const auto& res) {
+            func(std::get<0>(res), std::get<1>(res));
+        });
+    }
+
     void TrackMusicNNEmbeddings::removeAll(Session& session)
     {
         session.checkWriteTransaction();
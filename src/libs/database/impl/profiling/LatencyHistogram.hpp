@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace lms::db
+{
+    // Log-linear histogram of durations, in microseconds
+    // Each power of two is split into 4 buckets: reported percentiles are at most 25% off
+    class LatencyHistogram
+    {
+    public:
+        void add(std::uint64_t valueUs)
+        {
+            ++_buckets[getBucketIndex(valueUs)];
+            ++_count;
+            _max = std::max(_max, valueUs);
+        }
+
+        void merge(const LatencyHistogram& other)
+        {
+            for (std::size_t i{}; i < bucketCount; ++i)
+                _buckets[i] += other._buckets[i];
+            _count += other._count;
+            _max = std::max(_max, other._max);
+        }
+
+        std::uint64_t getCount() const { return _count; }
+        std::uint64_t getMax() const { return _max; }
+
+        // percentile in [0, 1], returns the upper bound of the bucket that holds the value
+        std::uint64_t getPercentile(double percentile) const
+        {
+            if (_count == 0)
+                return 0;
+
+            const std::uint64_t rank{ std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::clamp(percentile, 0., 1.) * static_cast<double>(_count) + 0.5)) };
+
+            std::uint64_t cumulativeCount{};
+            for (std::size_t i{}; i < bucketCount; ++i)
+            {
+                cumulativeCount += _buckets[i];
+                if (cumulativeCount >= rank)
+                    return std::min(getBucketUpperBound(i), _max);
+            }
+
+            return _max;
+        }
+
+    private:
+        static constexpr unsigned subBucketBits{ 2 };
+        static constexpr std::uint64_t subBucketCount{ 1 << subBucketBits };
+        static constexpr unsigned maxExponent{ 40 }; // ~ 12 days, larger values go to the last bucket
+        static constexpr std::size_t bucketCount{ (maxExponent - subBucketBits + 1) * subBucketCount };
+
+        static constexpr std::size_t getBucketIndex(std::uint64_t value)
+        {
+            if (value < subBucketCount)
+                return value;
+
+            const unsigned exponent{ static_cast<unsigned>(std::bit_width(value)) - 1 };
+            if (exponent >= maxExponent)
+                return bucketCount - 1;
+
+            const std::uint64_t subBucket{ (value >> (exponent - subBucketBits)) & (subBucketCount - 1) };
+            return (exponent - subBucketBits + 1) * subBucketCount + subBucket;
+        }
+
+        // inclusive
+        static constexpr std::uint64_t getBucketUpperBound(std::size_t index)
+        {
+            if (index < subBucketCount)
+                return index;
+            if (index == bucketCount - 1)
+                return std::numeric_limits<std::uint64_t>::max(); // holds all the larger values
+
+            const unsigned exponent{ static_cast<unsigned>(index / subBucketCount) + subBucketBits - 1 };
+            const std::uint64_t subBucket{ index % subBucketCount };
+            return ((subBucketCount + subBucket + 1) << (exponent - subBucketBits)) - 1;
+        }
+
+        std::array<std::uint64_t, bucketCount> _buckets{};
+        std::uint64_t _count{};
+        std::uint64_t _max{};
+    };
+} // namespace lms::db
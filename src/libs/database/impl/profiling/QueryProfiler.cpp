@@ -19,8 +19,12 @@
 
 #include "profiling/QueryProfiler.hpp"
 
-#include <memory>
-#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <thread>
 
 #include <Wt/Dbo/SqlStatement.h>
 #include <Wt/Dbo/Transaction.h>
@@ -29,36 +33,150 @@
 
 namespace lms::db
 {
-    std::unique_ptr<IQueryProfiler> createQueryProfiler()
+    namespace
     {
-        return std::make_unique<QueryProfiler>();
+        thread_local std::string_view currentQueryOrigin;
+
+        std::chrono::microseconds toMicroseconds(double valueUs)
+        {
+            return std::chrono::microseconds{ static_cast<long long>(valueUs) };
+        }
+    } // namespace
+
+    ScopedQueryOrigin::ScopedQueryOrigin(std::string_view origin)
+        : _previousOrigin{ currentQueryOrigin }
+    {
+        currentQueryOrigin = origin;
+    }
+
+    ScopedQueryOrigin::~ScopedQueryOrigin()
+    {
+        currentQueryOrigin = _previousOrigin;
     }
 
-    QueryProfiler::QueryProfiler()
+    std::string_view ScopedQueryOrigin::getCurrent()
     {
-        LMS_LOG(DB, INFO, "Recording database queries");
+        return currentQueryOrigin;
+    }
+
+    std::unique_ptr<IQueryProfiler> createQueryProfiler(const QueryProfilerParameters& params)
+    {
+        return std::make_unique<QueryProfiler>(params);
+    }
+
+    QueryProfiler::QueryProfiler(const QueryProfilerParameters& params)
+        : _params{ params }
+        , _instanceId{ [] {
+            static std::atomic<std::size_t> instanceCount{};
+            return ++instanceCount;
+        }() }
+    {
+        LMS_LOG(DB, INFO, "Recording database queries, slow query threshold = " << _params.slowQueryThreshold.count() << " ms");
     }
 
     QueryProfiler::~QueryProfiler() = default;
 
     void QueryProfiler::visitQueries(const QueryVisitor& visitor) const
     {
-        const std::shared_lock lock{ _mutex };
+        struct MergedQueryData
+        {
+            math::StatsAccumulator<double> timeStats;
+            LatencyHistogram histogram;
+            std::size_t rowCount{};
+            std::unordered_map<std::string, std::size_t> callCountByOrigin;
+        };
+        std::map<std::string, MergedQueryData> queries;
+
+        {
+            const std::shared_lock lock{ _shardsMutex };
+
+            for (const auto& shard : _shards)
+            {
+                const std::scoped_lock shardLock{ shard->mutex };
+
+                for (const auto& [query, data] : shard->queries)
+                {
+                    MergedQueryData& mergedData{ queries[query] };
+                    mergedData.timeStats.merge(data.timeStats);
+                    mergedData.histogram.merge(data.histogram);
+                    mergedData.rowCount += data.rowCount;
+                    for (const auto& [origin, callCount] : data.callCountByOrigin)
+                        mergedData.callCountByOrigin[origin] += callCount;
+                }
+            }
+        }
+
+        const std::shared_lock lock{ _plansMutex };
 
-        for (const auto& [query, data] : _queries)
+        std::vector<QueryOriginStats> origins;
+        for (const auto& [query, data] : queries)
         {
+            origins.clear();
+            for (const auto& [origin, callCount] : data.callCountByOrigin)
+                origins.push_back(QueryOriginStats{ .origin = origin, .callCount = callCount });
+            std::sort(std::begin(origins), std::end(origins), [](const QueryOriginStats& lhs, const QueryOriginStats& rhs) { return lhs.callCount > rhs.callCount; });
+
+            const auto itPlan{ _plans.find(query) };
+
             const QueryStats stats{
                 .query = query,
-                .plan = data.plan,
+                .plan = itPlan != std::cend(_plans) ? std::string_view{ itPlan->second } : std::string_view{},
                 .callCount = data.timeStats.getCount(),
-                .totalTime = std::chrono::microseconds{ static_cast<long long>(data.timeStats.getMean() * static_cast<double>(data.timeStats.getCount())) },
-                .meanTime = std::chrono::microseconds{ static_cast<long long>(data.timeStats.getMean()) },
-                .stdDevTime = std::chrono::microseconds{ static_cast<long long>(data.timeStats.getSampleStdDev()) },
+                .rowCount = data.rowCount,
+                .totalTime = toMicroseconds(data.timeStats.getMean() * static_cast<double>(data.timeStats.getCount())),
+                .meanTime = toMicroseconds(data.timeStats.getMean()),
+                .stdDevTime = toMicroseconds(data.timeStats.getSampleStdDev()),
+                .p50Time = std::chrono::microseconds{ data.histogram.getPercentile(0.5) },
+                .p90Time = std::chrono::microseconds{ data.histogram.getPercentile(0.9) },
+                .p99Time = std::chrono::microseconds{ data.histogram.getPercentile(0.99) },
+                .maxTime = std::chrono::microseconds{ data.histogram.getMax() },
+                .origins = origins,
             };
             visitor(stats);
         }
     }
 
+    void QueryProfiler::visitSlowQueries(const SlowQueryVisitor& visitor) const
+    {
+        const std::scoped_lock lock{ _slowQueriesMutex };
+
+        for (const SlowQueryEntry& entry : _slowQueries)
+        {
+            const SlowQuery slowQuery{
+                .timestamp = entry.timestamp,
+                .query = entry.query,
+                .origin = entry.origin,
+                .duration = std::chrono::duration_cast<std::chrono::microseconds>(entry.duration),
+                .rowCount = entry.rowCount,
+            };
+            visitor(slowQuery);
+        }
+    }
+
+    QueryProfiler::Shard& QueryProfiler::getCurrentThreadShard()
+    {
+        // instance id used in case of several successive profilers
+        static thread_local std::size_t shardInstanceId{};
+        static thread_local Shard* shard{};
+
+        if (shardInstanceId != _instanceId)
+        {
+            auto newShard{ std::make_unique<Shard>() };
+
+            std::ostringstream oss;
+            oss << "thread " << std::this_thread::get_id();
+            newShard->threadOrigin = oss.str();
+
+            shard = newShard.get();
+            shardInstanceId = _instanceId;
+
+            const std::unique_lock lock{ _shardsMutex };
+            _shards.push_back(std::move(newShard));
+        }
+
+        return *shard;
+    }
+
     void QueryProfiler::recordQueryPlan(Wt::Dbo::Session& session, const std::string& query)
     {
         Wt::Dbo::Transaction transaction{ session };
@@ -108,24 +226,66 @@ namespace lms::db
         formatQuery(0, 0);
 
         {
-            const std::unique_lock lock{ _mutex };
-            _queries[query].plan = std::move(result);
+            const std::unique_lock lock{ _plansMutex };
+            _plans[query] = std::move(result);
         }
     }
 
-    void QueryProfiler::recordQueryExecution(Wt::Dbo::Session& session, const std::string& query, Clock::duration elapsed)
+    void QueryProfiler::recordSlowQuery(const std::string& query, std::string_view origin, Clock::duration elapsed, std::size_t rowCount)
     {
+        LMS_LOG(DB, WARNING, "Slow query (" << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms, " << rowCount << " rows, origin = '" << origin << "'): " << query);
+
+        const std::scoped_lock lock{ _slowQueriesMutex };
+
+        _slowQueries.push_front(SlowQueryEntry{
+            .timestamp = std::chrono::system_clock::now(),
+            .query = query,
+            .origin = std::string{ origin },
+            .duration = elapsed,
+            .rowCount = rowCount,
+        });
+
+        while (_slowQueries.size() > _params.maxSlowQueryCount)
+            _slowQueries.pop_back();
+    }
+
+    void QueryProfiler::recordQueryExecution(Wt::Dbo::Session& session, const std::string& query, Clock::duration elapsed, std::size_t rowCount)
+    {
+        Shard& shard{ getCurrentThreadShard() };
+        const std::string_view origin{ !ScopedQueryOrigin::getCurrent().empty() ? ScopedQueryOrigin::getCurrent() : std::string_view{ shard.threadOrigin } };
+
         bool needQueryPlan{};
         const double elapsedUs{ std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(elapsed).count() };
         {
-            std::unique_lock lock{ _mutex };
+            // only contended while visiting
+            const std::scoped_lock lock{ shard.mutex };
+
+            QueryData& queryData{ shard.queries[query] };
+            queryData.timeStats.add(elapsedUs);
+            queryData.histogram.add(static_cast<std::uint64_t>(elapsedUs));
+            queryData.rowCount += rowCount;
 
-            auto& queryStats{ _queries[query] };
-            queryStats.timeStats.add(elapsedUs);
-            needQueryPlan = queryStats.plan.empty();
+            auto itOrigin{ queryData.callCountByOrigin.find(origin) };
+            if (itOrigin == std::end(queryData.callCountByOrigin))
+                itOrigin = queryData.callCountByOrigin.emplace(std::string{ origin }, 0).first;
+            itOrigin->second++;
+
+            needQueryPlan = !queryData.planChecked;
+            queryData.planChecked = true;
         }
 
         if (needQueryPlan)
-            recordQueryPlan(session, query);
+        {
+            {
+                const std::shared_lock lock{ _plansMutex };
+                needQueryPlan = !_plans.contains(query);
+            }
+
+            if (needQueryPlan)
+                recordQueryPlan(session, query);
+        }
+
+        if (_params.slowQueryThreshold.count() > 0 && elapsed >= _params.slowQueryThreshold)
+            recordSlowQuery(query, origin, elapsed, rowCount);
     }
 } // namespace lms::db
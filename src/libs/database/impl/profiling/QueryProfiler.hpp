@@ -19,39 +19,77 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <Wt/Dbo/Session.h>
 
 #include "database/profiling/IQueryProfiler.hpp"
 #include "math/StatsAccumulator.hpp"
 
+#include "profiling/LatencyHistogram.hpp"
+
 namespace lms::db
 {
     class QueryProfiler : public IQueryProfiler
     {
     public:
-        QueryProfiler();
+        QueryProfiler(const QueryProfilerParameters& params);
         ~QueryProfiler() override;
         QueryProfiler(const QueryProfiler&) = delete;
         QueryProfiler& operator=(const QueryProfiler&) = delete;
 
         void visitQueries(const QueryVisitor& visitor) const override;
+        void visitSlowQueries(const SlowQueryVisitor& visitor) const override;
 
-        void recordQueryExecution(Wt::Dbo::Session& session, const std::string& query, Clock::duration elapsed);
+        void recordQueryExecution(Wt::Dbo::Session& session, const std::string& query, Clock::duration elapsed, std::size_t rowCount);
 
     private:
         void recordQueryPlan(Wt::Dbo::Session& session, const std::string& query);
+        void recordSlowQuery(const std::string& query, std::string_view origin, Clock::duration elapsed, std::size_t rowCount);
 
         struct QueryData
         {
-            std::string plan;
             math::StatsAccumulator<double> timeStats; // in Us
+            LatencyHistogram histogram;               // in Us
+            std::size_t rowCount{};
+            std::map<std::string, std::size_t, std::less<>> callCountByOrigin;
+            bool planChecked{};
         };
 
-        mutable std::shared_mutex _mutex;
-        std::map<std::string, QueryData> _queries;
+        // Each thread records in its own shard, so that recording does not serialize queries
+        struct Shard
+        {
+            std::mutex mutex;
+            std::string threadOrigin;
+            std::unordered_map<std::string, QueryData> queries;
+        };
+        Shard& getCurrentThreadShard();
+
+        const QueryProfilerParameters _params;
+        const std::size_t _instanceId;
+
+        mutable std::shared_mutex _shardsMutex;
+        std::vector<std::unique_ptr<Shard>> _shards;
+
+        mutable std::shared_mutex _plansMutex;
+        std::unordered_map<std::string, std::string> _plans;
+
+        struct SlowQueryEntry
+        {
+            std::chrono::system_clock::time_point timestamp;
+            std::string query;
+            std::string origin;
+            Clock::duration duration;
+            std::size_t rowCount;
+        };
+        mutable std::mutex _slowQueriesMutex;
+        std::deque<SlowQueryEntry> _slowQueries; // most recent first
     };
 } // namespace lms::db
@@ -49,7 +49,7 @@ namespace lms::db::utils
             {
                 if (_active)
                     _elapsed += IQueryProfiler::Clock::now() - _start;
-                _recorder->recordQueryExecution(_query->session(), _query->asString(), _elapsed);
+                _recorder->recordQueryExecution(_query->session(), _query->asString(), _elapsed, _rowCount);
             }
         }
 
@@ -66,6 +66,11 @@ namespace lms::db::utils
             }
         }
 
+        void addRows(std::size_t count = 1)
+        {
+            _rowCount += count;
+        }
+
         void resume()
         {
             if (_recorder)
@@ -81,6 +86,7 @@ namespace lms::db::utils
         const Query* _query{};
         IQueryProfiler::Clock::time_point _start;
         IQueryProfiler::Clock::duration _elapsed{};
+        std::size_t _rowCount{};
         bool _active{ true };
     };
 } // namespace lms::db::utils
@@ -69,6 +69,7 @@ namespace lms::db
             UserId starringUser;                            // only artists starred by this user
             std::optional<FeedbackBackend> feedbackBackend; // and for this feedback backend
             TrackId track;                                  // artists involved in this track
+            ArtistId lastArtistId;                          // if set, only artists that come after this one in the sort order (see isKeysetPaginationSupported), none if it no longer exists
 
             FindParameters& setFilters(const Filters& _filters)
             {
@@ -116,6 +117,11 @@ namespace lms::db
                 track = _track;
                 return *this;
             }
+            FindParameters& setLastArtistId(ArtistId _lastArtistId)
+            {
+                lastArtistId = _lastArtistId;
+                return *this;
+            }
         };
 
         Artist() = default;
@@ -133,6 +139,7 @@ namespace lms::db
         static RangeResults<ArtistId> findIds(Session& session, const FindParameters& params);
         static RangeResults<ArtistId> findOrphanIds(Session& session, std::optional<Range> range = std::nullopt); // No track related
         static bool exists(Session& session, ArtistId id);
+        static bool isKeysetPaginationSupported(ArtistSortMethod sortMethod); // if true, the last retrieved artist can be used instead of an offset to get the next entries
         static RangeResults<pointer> findWithMBIDNameVariants(Session& session, ArtistId& lastRetrievedArtist, std::optional<Range> range = std::nullopt);
 
         // Updates
@@ -32,6 +32,7 @@
 #include "database/objects/ArtistId.hpp"
 #include "database/objects/ArtistInfoId.hpp"
 #include "database/objects/DirectoryId.hpp"
+#include "database/objects/Types.hpp"
 
 namespace lms::db
 {
@@ -50,6 +51,7 @@ namespace lms::db
         static void find(Session& session, ArtistId id, std::optional<Range> range, const std::function<void(const pointer&)>& func);
         static void find(Session& session, ArtistId id, const std::function<void(const pointer&)>& func);
         static pointer find(Session& session, const std::filesystem::path& path);
+        static void findFileInfos(Session& session, ArtistInfoId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func);
         static void find(Session& session, ArtistInfoId& lastRetrievedId, std::size_t count, const std::function<void(const pointer&)>& func);
         static void findArtistNameNoLongerMatch(Session& session, std::optional<Range> range, const std::function<void(const pointer&)>& func);
         static void findWithArtistNameAmbiguity(Session& session, std::optional<Range> range, bool allowArtistMBIDFallback, const std::function<void(const pointer&)>& func);
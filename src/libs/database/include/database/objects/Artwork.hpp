@@ -20,6 +20,7 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
 #include <variant>
 
 #include <Wt/Dbo/Field.h>
@@ -46,6 +47,9 @@ namespace lms::db
         static pointer find(Session& session, ArtworkId id);
         static pointer find(Session& session, TrackEmbeddedImageId id);
         static pointer find(Session& session, ImageId id);
+        static void findLastWrittenTime(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId, const Wt::WDateTime& lastWrittenTime)>& func);
+        static void findIds(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId)>& func);
+        static void findIdsWithoutRenderedThumbnails(Session& session, ArtworkId& lastRetrievedId, std::size_t count, const std::function<void(ArtworkId artworkId)>& func);
 
         // getters
         using UnderlyingId = std::variant<std::monostate, TrackEmbeddedImageId, ImageId>;
@@ -54,10 +58,16 @@ namespace lms::db
         std::filesystem::path getAbsoluteFilePath() const;
         ObjectPtr<Image> getImage() const;
         ImageId getImageId() const;
+        bool areThumbnailsRendered() const { return _thumbnailsRendered; }
+
+        // setters
+        void setThumbnailsRendered(bool rendered) { _thumbnailsRendered = rendered; } // to be reset by the scanner each time the source is modified
 
         template<class Action>
         void persist(Action& a)
         {
+            Wt::Dbo::field(a, _thumbnailsRendered, "thumbnails_rendered");
+
             Wt::Dbo::belongsTo(a, _trackEmbeddedImage, "track_embedded_image", Wt::Dbo::OnDeleteCascade);
             Wt::Dbo::belongsTo(a, _image, "image", Wt::Dbo::OnDeleteCascade);
         }
@@ -69,6 +79,7 @@ namespace lms::db
         static pointer create(Session& session, ObjectPtr<TrackEmbeddedImage> trackEmbeddedImage);
         static pointer create(Session& session, ObjectPtr<Image> image);
 
+        bool _thumbnailsRendered{};
         Wt::Dbo::ptr<TrackEmbeddedImage> _trackEmbeddedImage;
         Wt::Dbo::ptr<Image> _image;
     };
@@ -100,6 +100,8 @@ namespace lms::db
         // May be very slow
         static std::size_t computeTrackCount(Session& session, ClusterId id);
         static std::size_t computeReleaseCount(Session& session, ClusterId id);
+        // Recomputes the cached track and release counts of all the clusters at once, returns the number of clusters whose counts changed
+        static std::size_t updateCounts(Session& session);
 
         // Accessors
         std::string_view getName() const { return _name; }
@@ -31,6 +31,7 @@
 #include "database/Types.hpp"
 #include "database/objects/DirectoryId.hpp"
 #include "database/objects/ImageId.hpp"
+#include "database/objects/Types.hpp"
 
 namespace lms::db
 {
@@ -73,6 +74,7 @@ namespace lms::db
         static std::size_t getCount(Session& session);
         static pointer find(Session& session, ImageId id);
         static pointer find(Session& session, const std::filesystem::path& file);
+        static void findFileInfos(Session& session, ImageId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func);
         static RangeResults<pointer> find(Session& session, const FindParameters& params);
         static void find(Session& session, const FindParameters& parameters, const std::function<void(const Image::pointer&)>& func);
         static void find(Session& session, ImageId& lastRetrievedId, std::size_t count, const std::function<void(const Image::pointer&)>& func);
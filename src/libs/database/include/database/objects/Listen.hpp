@@ -147,6 +147,9 @@ namespace lms::db
         static RangeResults<ReleaseId> getRecentReleases(Session& session, const StatsFindParameters& params);
         static RangeResults<TrackId> getRecentTracks(Session& session, const StatsFindParameters& params);
 
+        // Stats are maintained as listens are added/removed, this recomputes them from scratch
+        static void rebuildStats(Session& session);
+
         static std::size_t getCount(Session& session, UserId userId, TrackId trackId);   // for the current backend
         static std::size_t getCount(Session& session, UserId userId, ReleaseId trackId); // for the current backend
 
@@ -33,6 +33,7 @@
 #include "database/Object.hpp"
 #include "database/objects/ArtworkId.hpp"
 #include "database/objects/DirectoryId.hpp"
+#include "database/objects/Types.hpp"
 
 LMS_DECLARE_IDTYPE(PlayListFileId)
 
@@ -53,6 +54,7 @@ namespace lms::db
         static std::size_t getCount(Session& session);
         static pointer find(Session& session, PlayListFileId id);
         static pointer find(Session& session, const std::filesystem::path& path);
+        static void findFileInfos(Session& session, PlayListFileId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func);
         static void find(Session& session, PlayListFileId& lastRetrievedId, std::size_t count, const std::function<void(const pointer&)>& func);
         static void findAbsoluteFilePath(Session& session, PlayListFileId& lastRetrievedId, std::size_t count, const std::function<void(PlayListFileId playListFileId, const std::filesystem::path& absoluteFilePath)>& func);
         static void find(Session& session, const IdRange<PlayListFileId>& idRange, const std::function<void(const PlayListFile::pointer&)>& func);
@@ -179,6 +179,7 @@ namespace lms::db
             std::optional<core::UUID> releaseGroupMBID;              // If set, releases that belong to this release group
             DirectoryId directory;                                   // if set, releases in this directory (cannot be set with parent directory)
             DirectoryId parentDirectory;                             // if set, releases in this parent directory (cannot be set with directory)
+            ReleaseId lastReleaseId;                                 // if set, only releases that come after this one in the sort order (see isKeysetPaginationSupported), none if it no longer exists
 
             FindParameters& setFilters(const Filters& _filters)
             {
@@ -257,6 +258,11 @@ namespace lms::db
                 parentDirectory = _parentDirectory;
                 return *this;
             }
+            FindParameters& setLastReleaseId(ReleaseId _lastReleaseId)
+            {
+                lastReleaseId = _lastReleaseId;
+                return *this;
+            }
         };
 
         Release() = default;
@@ -264,6 +270,7 @@ namespace lms::db
         // Accessors
         static std::size_t getCount(Session& session);
         static bool exists(Session& session, ReleaseId id);
+        static bool isKeysetPaginationSupported(ReleaseSortMethod sortMethod); // if true, the last retrieved release can be used instead of an offset to get the next entries
         static pointer find(Session& session, const core::UUID& MBID);
         static pointer find(Session& session, ReleaseId id);
         static void find(Session& session, ReleaseId& lastRetrievedRelease, std::size_t count, const std::function<void(const Release::pointer&)>& func, MediaLibraryId library = {});
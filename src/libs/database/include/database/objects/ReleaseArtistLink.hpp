@@ -89,6 +89,7 @@ namespace lms::db
 
         // accessors
         ObjectPtr<Release> getRelease() const { return _release; }
+        ReleaseId getReleaseId() const { return _release.id(); }
         ObjectPtr<Artist> getArtist() const { return _artist; }
         ArtistId getArtistId() const { return _artist.id(); }
         std::string_view getArtistName() const { return _artistName; }
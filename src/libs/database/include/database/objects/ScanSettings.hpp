@@ -65,6 +65,8 @@ namespace lms::db
         // Getters
         std::size_t getAudioScanVersion() const { return _audioScanVersion; }
         std::size_t getArtistInfoScanVersion() const { return _artistInfoScanVersion; }
+        std::size_t getScanGeneration() const { return _scanGeneration; }
+        std::string_view getDatabaseId() const { return _databaseId; } // random, set once when the database is created
         std::string_view getMusicNNModelIdentifier() const { return _musicnnModelIdentifier; }
         Wt::WTime getUpdateStartTime() const { return _startTime; }
         UpdatePeriod getUpdatePeriod() const { return _updatePeriod; }
@@ -89,12 +91,15 @@ namespace lms::db
         void setAllowMBIDArtistMerge(bool value);
         void setArtistImageFallbackToReleaseField(bool value);
         void setMusicNNModelIdentifier(std::string_view identifier) { _musicnnModelIdentifier = identifier; }
+        void incScanGeneration(); // to be called each time a scan has changed the database
         template<class Action>
         void persist(Action& a)
         {
             Wt::Dbo::field(a, _name, "name");
             Wt::Dbo::field(a, _audioScanVersion, "audio_scan_version");
             Wt::Dbo::field(a, _artistInfoScanVersion, "artist_info_scan_version");
+            Wt::Dbo::field(a, _scanGeneration, "scan_generation");
+            Wt::Dbo::field(a, _databaseId, "database_id");
             Wt::Dbo::field(a, _startTime, "start_time");
             Wt::Dbo::field(a, _updatePeriod, "update_period");
             Wt::Dbo::field(a, _recommendationEngineType, "recommendation_engine_type");
@@ -119,6 +124,8 @@ namespace lms::db
         std::string _name;
         int _audioScanVersion{};
         int _artistInfoScanVersion{};
+        int _scanGeneration{};
+        std::string _databaseId;
         Wt::WTime _startTime = Wt::WTime{ 0, 0, 0 };
         UpdatePeriod _updatePeriod{ UpdatePeriod::Never };
         RecommendationEngineType _recommendationEngineType{ RecommendationEngineType::Clusters };
@@ -98,7 +98,7 @@ namespace lms::db
             std::optional<std::size_t> fileSize;                     // if set, tracks that match this file size
             TrackEmbeddedImageId embeddedImageId;                    // if set, tracks that have this embedded image
             std::optional<bool> hasMusicNNEmbeddings;                // If set, tracks that have (or not) MusicNN embeddings
-            TrackId lastTrackId;                                     // If set, tracks that are after this one, must be used with sort by id
+            TrackId lastTrackId;                                     // If set, tracks that come after this one in the sort order (see isKeysetPaginationSupported), none if it no longer exists
 
             FindParameters& setFilters(const Filters& _filters)
             {
@@ -211,6 +211,7 @@ namespace lms::db
         static std::size_t getCount(Session& session);
         static pointer findByPath(Session& session, const std::filesystem::path& p);
         static std::optional<FileInfo> findFileInfo(Session& session, const std::filesystem::path& p);
+        static void findFileInfos(Session& session, TrackId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func);
         static pointer find(Session& session, TrackId id);
         static void find(Session& session, TrackId& lastRetrievedId, std::size_t count, const std::function<void(const Track::pointer&)>& func, MediaLibraryId library = {});
         static void find(Session& session, const IdRange<TrackId>& idRange, const std::function<void(const Track::pointer&)>& func);
@@ -219,8 +220,10 @@ namespace lms::db
         using TrackLocationVisitor = std::function<void(TrackId trackId, const std::filesystem::path& absoluteFilePath)>;
         static void findAbsoluteFilePath(Session& session, TrackId& lastRetrievedId, std::size_t count, const TrackLocationVisitor& func);
         static void findAbsoluteFilePath(Session& session, const FindParameters& params, const TrackLocationVisitor& func);
+        static void findReleaseIds(Session& session, const std::function<void(TrackId trackId, ReleaseId releaseId)>& func); // tracks without release are skipped
 
         static bool exists(Session& session, TrackId id);
+        static bool isKeysetPaginationSupported(TrackSortMethod sortMethod); // if true, the last retrieved track can be used instead of an offset to get the next entries
         static std::vector<pointer> findByRecordingMBID(Session& session, const core::UUID& MBID);
         static std::vector<pointer> findByMBID(Session& session, const core::UUID& MBID);
         static RangeResults<TrackId> findIds(Session& session, const FindParameters& params);
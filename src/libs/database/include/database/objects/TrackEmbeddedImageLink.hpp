@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -54,11 +56,14 @@ namespace lms::db
         std::size_t getIndex() const { return _index; }
         core::media::ImageType getType() const;
         std::string_view getDescription() const { return _description; }
+        // position of the image data in the track file, if stored verbatim
+        std::optional<std::uint64_t> getDataOffset() const { return _dataOffset; }
 
         // setters
         void setIndex(std::size_t index) { _index = static_cast<int>(index); }
         void setType(core::media::ImageType type);
         void setDescription(std::string_view description) { _description = description; }
+        void setDataOffset(std::optional<std::uint64_t> dataOffset) { _dataOffset = dataOffset; }
 
         template<class Action>
         void persist(Action& a)
@@ -66,6 +71,7 @@ namespace lms::db
             Wt::Dbo::field(a, _index, "index");
             Wt::Dbo::field(a, _type, "type");
             Wt::Dbo::field(a, _description, "description");
+            Wt::Dbo::field(a, _dataOffset, "data_offset");
 
             Wt::Dbo::belongsTo(a, _track, "track", Wt::Dbo::OnDeleteCascade);
             Wt::Dbo::belongsTo(a, _image, "track_embedded_image", Wt::Dbo::OnDeleteCascade);
@@ -80,6 +86,7 @@ namespace lms::db
         int _index{}; // index within the track
         detail::ImageType _type{ detail::ImageType::Unknown };
         std::string _description;
+        std::optional<long long> _dataOffset;
 
         Wt::Dbo::ptr<Track> _track;
         Wt::Dbo::ptr<TrackEmbeddedImage> _image;
@@ -81,6 +81,7 @@ namespace lms::db
         static std::size_t getExternalLyricsCount(Session& session);
         static pointer find(Session& session, TrackLyricsId id);
         static pointer find(Session& session, const std::filesystem::path& file);
+        static void findFileInfos(Session& session, TrackLyricsId& lastRetrievedId, std::size_t count, const std::function<void(const std::filesystem::path& absoluteFilePath, const FileInfo& fileInfo)>& func);
         static void find(Session& session, const FindParameters& params, const std::function<void(const TrackLyrics::pointer&)>& func);
         static void find(Session& session, TrackLyricsId& lastRetrievedId, std::size_t count, const std::function<void(const TrackLyrics::pointer&)>& func);
         static RangeResults<TrackLyricsId> findOrphanIds(Session& session, std::optional<Range> range);
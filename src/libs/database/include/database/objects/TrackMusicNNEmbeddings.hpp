@@ -47,6 +47,7 @@ namespace lms::db
         static pointer find(Session& session, TrackId trackId);
         static RangeResults<TrackMusicNNEmbeddingsId> find(Session& session, std::optional<Range> range = std::nullopt);
         static void find(Session& session, std::function<void(const pointer&)> func);
+        static void findTrackIds(Session& session, const std::function<void(TrackMusicNNEmbeddingsId embeddingsId, TrackId trackId)>& func); // without loading the data
         static void removeAll(Session& session);
 
         // Accessors
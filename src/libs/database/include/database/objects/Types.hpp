@@ -51,6 +51,7 @@ namespace lms::db
         LastWrittenDesc,
         AddedDesc,
         StarredDateDesc,
+        Relevance, // best keyword matches first, same as Id if no keyword
     };
 
     enum class ClusterSortMethod
@@ -107,6 +108,7 @@ namespace lms::db
         LastWrittenDesc,
         AddedDesc,
         StarredDateDesc,
+        Relevance, // best keyword matches first, same as Id if no keyword
     };
 
     enum class ReleaseTypeSortMethod
@@ -152,6 +154,7 @@ namespace lms::db
         Release,   // order by disc/track number
         TrackList, // order by asc order in tracklist
         TrackNumber,
+        Relevance, // best keyword matches first, same as Id if no keyword
     };
 
     enum class TrackLyricsSortMethod
@@ -22,6 +22,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string_view>
 
 namespace lms::db
@@ -35,19 +36,65 @@ namespace lms::db
 
         using Clock = std::chrono::steady_clock;
 
+        struct QueryOriginStats
+        {
+            std::string_view origin; // see ScopedQueryOrigin, defaults to the thread that issued the query
+            std::size_t callCount{};
+        };
+
         struct QueryStats
         {
             std::string_view query;
             std::string_view plan;
             std::size_t callCount{};
+            std::size_t rowCount{}; // total number of rows returned
             std::chrono::microseconds totalTime{};
             std::chrono::microseconds meanTime{};
             std::chrono::microseconds stdDevTime{};
+            std::chrono::microseconds p50Time{};
+            std::chrono::microseconds p90Time{};
+            std::chrono::microseconds p99Time{};
+            std::chrono::microseconds maxTime{};
+            std::span<const QueryOriginStats> origins; // most frequent first
         };
 
         using QueryVisitor = std::function<void(const QueryStats&)>;
         virtual void visitQueries(const QueryVisitor& visitor) const = 0;
+
+        struct SlowQuery
+        {
+            std::chrono::system_clock::time_point timestamp;
+            std::string_view query; // bound parameters are not part of the query
+            std::string_view origin;
+            std::chrono::microseconds duration{};
+            std::size_t rowCount{};
+        };
+
+        // Most recent first, only the last entries are kept
+        using SlowQueryVisitor = std::function<void(const SlowQuery&)>;
+        virtual void visitSlowQueries(const SlowQueryVisitor& visitor) const = 0;
     };
 
-    std::unique_ptr<IQueryProfiler> createQueryProfiler();
+    struct QueryProfilerParameters
+    {
+        std::chrono::milliseconds slowQueryThreshold{ 100 }; // queries that take longer are logged and kept for inspection, 0 to disable
+        std::size_t maxSlowQueryCount{ 100 };
+    };
+    std::unique_ptr<IQueryProfiler> createQueryProfiler(const QueryProfilerParameters& params);
+
+    // Tags the queries issued by the current thread while in scope (ex: with the HTTP endpoint being served)
+    // origin must outlive this object
+    class ScopedQueryOrigin
+    {
+    public:
+        explicit ScopedQueryOrigin(std::string_view origin);
+        ~ScopedQueryOrigin();
+        ScopedQueryOrigin(const ScopedQueryOrigin&) = delete;
+        ScopedQueryOrigin& operator=(const ScopedQueryOrigin&) = delete;
+
+        static std::string_view getCurrent(); // empty if not set
+
+    private:
+        const std::string_view _previousOrigin;
+    };
 } // namespace lms::db
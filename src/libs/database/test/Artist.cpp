@@ -944,6 +944,46 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Artist_keysetPagination)
+    {
+        ScopedArtist artist1{ session, "artist1" };
+        ScopedArtist artist2{ session, "artist2" };
+        ScopedArtist artist3{ session, "artist3" };
+        ScopedArtist artist4{ session, "artist4" };
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+
+            artist1.get().modify()->setSortName("b");
+            artist2.get().modify()->setSortName("A");
+            artist3.get().modify()->setSortName("a");
+            artist4.get().modify()->setSortName("c");
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_TRUE(Artist::isKeysetPaginationSupported(ArtistSortMethod::SortName));
+            EXPECT_FALSE(Artist::isKeysetPaginationSupported(ArtistSortMethod::Random));
+
+            const std::vector<ArtistId> expectedArtists{ artist2.getId(), artist3.getId(), artist1.getId(), artist4.getId() };
+            EXPECT_EQ(Artist::findIds(session, Artist::FindParameters{}.setSortMethod(ArtistSortMethod::SortName)).results, expectedArtists);
+
+            std::vector<ArtistId> visitedArtists;
+            ArtistId lastArtistId;
+            while (true)
+            {
+                const auto artists{ Artist::findIds(session, Artist::FindParameters{}.setSortMethod(ArtistSortMethod::SortName).setLastArtistId(lastArtistId).setRange(Range{ 0, 3 })) };
+                visitedArtists.insert(std::end(visitedArtists), std::cbegin(artists.results), std::cend(artists.results));
+                if (!artists.moreResults)
+                    break;
+
+                lastArtistId = artists.results.back();
+            }
+            EXPECT_EQ(visitedArtists, expectedArtists);
+        }
+    }
+
     TEST_F(DatabaseFixture, Artist_nonReleaseTracks)
     {
         ScopedArtist artist{ session, "artist" };
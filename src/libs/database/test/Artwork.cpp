@@ -107,4 +107,109 @@ namespace lms::db::tests
             EXPECT_EQ(std::get<db::TrackEmbeddedImageId>(underlyingId), image2.getId());
         }
     }
-} // namespace lms::db::tests
\ No newline at end of file
+
+    TEST_F(DatabaseFixture, Artwork_findLastWrittenTime)
+    {
+        ScopedImage image{ session, "/MyImage" };
+        ScopedArtwork artwork1{ session, image.lockAndGet() };
+
+        ScopedTrackEmbeddedImage trackEmbeddedImage{ session };
+        ScopedTrack track{ session };
+        ScopedArtwork artwork2{ session, trackEmbeddedImage.lockAndGet() };
+
+        const Wt::WDateTime dateTime1{ Wt::WDate{ 2025, 1, 1 } };
+        const Wt::WDateTime dateTime2{ Wt::WDate{ 2025, 2, 1 } };
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            image.get().modify()->setLastWriteTime(dateTime1);
+            session.create<db::TrackEmbeddedImageLink>(track.get(), trackEmbeddedImage.get());
+            track.get().modify()->setLastWriteTime(dateTime2);
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<std::pair<ArtworkId, Wt::WDateTime>> visitedArtworks;
+            ArtworkId lastRetrievedId;
+            Artwork::findLastWrittenTime(session, lastRetrievedId, 1, [&](ArtworkId artworkId, const Wt::WDateTime& lastWrittenTime) {
+                visitedArtworks.emplace_back(artworkId, lastWrittenTime);
+            });
+            ASSERT_EQ(visitedArtworks.size(), 1);
+            EXPECT_EQ(visitedArtworks[0].first, artwork1.getId());
+            EXPECT_EQ(visitedArtworks[0].second, dateTime1);
+            EXPECT_EQ(lastRetrievedId, artwork1.getId());
+
+            Artwork::findLastWrittenTime(session, lastRetrievedId, 10, [&](ArtworkId artworkId, const Wt::WDateTime& lastWrittenTime) {
+                visitedArtworks.emplace_back(artworkId, lastWrittenTime);
+            });
+            ASSERT_EQ(visitedArtworks.size(), 2);
+            EXPECT_EQ(visitedArtworks[1].first, artwork2.getId());
+            EXPECT_EQ(visitedArtworks[1].second, dateTime2);
+            EXPECT_EQ(lastRetrievedId, artwork2.getId());
+        }
+    }
+
+    TEST_F(DatabaseFixture, Artwork_findIds)
+    {
+        ScopedImage image1{ session, "/MyImage1" };
+        ScopedImage image2{ session, "/MyImage2" };
+        ScopedArtwork artwork1{ session, image1.lockAndGet() };
+        ScopedArtwork artwork2{ session, image2.lockAndGet() };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<ArtworkId> visitedArtworks;
+            ArtworkId lastRetrievedId;
+            Artwork::findIds(session, lastRetrievedId, 1, [&](ArtworkId artworkId) { visitedArtworks.push_back(artworkId); });
+            ASSERT_EQ(visitedArtworks.size(), 1);
+            EXPECT_EQ(visitedArtworks[0], artwork1.getId());
+            EXPECT_EQ(lastRetrievedId, artwork1.getId());
+
+            Artwork::findIds(session, lastRetrievedId, 10, [&](ArtworkId artworkId) { visitedArtworks.push_back(artworkId); });
+            ASSERT_EQ(visitedArtworks.size(), 2);
+            EXPECT_EQ(visitedArtworks[1], artwork2.getId());
+            EXPECT_EQ(lastRetrievedId, artwork2.getId());
+        }
+    }
+
+    TEST_F(DatabaseFixture, Artwork_thumbnailsRendered)
+    {
+        ScopedImage image1{ session, "/MyImage1" };
+        ScopedImage image2{ session, "/MyImage2" };
+        ScopedArtwork artwork1{ session, image1.lockAndGet() };
+        ScopedArtwork artwork2{ session, image2.lockAndGet() };
+
+        const auto findIdsWithoutRenderedThumbnails{ [&] {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<ArtworkId> artworkIds;
+            ArtworkId lastRetrievedId;
+            Artwork::findIdsWithoutRenderedThumbnails(session, lastRetrievedId, 10, [&](ArtworkId artworkId) { artworkIds.push_back(artworkId); });
+            return artworkIds;
+        } };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_FALSE(artwork1.get()->areThumbnailsRendered());
+        }
+        EXPECT_EQ(findIdsWithoutRenderedThumbnails(), (std::vector<ArtworkId>{ artwork1.getId(), artwork2.getId() }));
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            artwork1.get().modify()->setThumbnailsRendered(true);
+        }
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_TRUE(artwork1.get()->areThumbnailsRendered());
+        }
+        EXPECT_EQ(findIdsWithoutRenderedThumbnails(), (std::vector<ArtworkId>{ artwork2.getId() }));
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            artwork1.get().modify()->setThumbnailsRendered(false);
+        }
+        EXPECT_EQ(findIdsWithoutRenderedThumbnails(), (std::vector<ArtworkId>{ artwork1.getId(), artwork2.getId() }));
+    }
+} // namespace lms::db::tests
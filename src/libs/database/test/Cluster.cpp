@@ -434,6 +434,70 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Cluster_updateCounts)
+    {
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+        ScopedTrack track3{ session };
+        ScopedRelease release{ session, "MyRelease" };
+
+        ScopedClusterType clusterType{ session, "MyClusterType" };
+        ScopedCluster cluster1{ session, clusterType.lockAndGet(), "MyCluster1" };
+        ScopedCluster cluster2{ session, clusterType.lockAndGet(), "MyCluster2" };
+        ScopedCluster unusedCluster{ session, clusterType.lockAndGet(), "MyClusterUnused" };
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+
+            track1.get().modify()->setRelease(release.get());
+            track2.get().modify()->setRelease(release.get());
+            cluster1.get().modify()->addTrack(track1.get());
+            cluster1.get().modify()->addTrack(track2.get());
+            cluster1.get().modify()->addTrack(track3.get());
+            cluster2.get().modify()->addTrack(track3.get());
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            EXPECT_EQ(Cluster::updateCounts(session), 2);
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_EQ(cluster1.get()->getTrackCount(), 3);
+            EXPECT_EQ(cluster1.get()->getReleasesCount(), 1);
+            EXPECT_EQ(cluster2.get()->getTrackCount(), 1);
+            EXPECT_EQ(cluster2.get()->getReleasesCount(), 0);
+            EXPECT_EQ(unusedCluster.get()->getTrackCount(), 0);
+            EXPECT_EQ(unusedCluster.get()->getReleasesCount(), 0);
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            EXPECT_EQ(Cluster::updateCounts(session), 0); // nothing changed
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            track3.get().remove();
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            EXPECT_EQ(Cluster::updateCounts(session), 2);
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_EQ(cluster1.get()->getTrackCount(), 2);
+            EXPECT_EQ(cluster1.get()->getReleasesCount(), 1);
+            EXPECT_EQ(cluster2.get()->getTrackCount(), 0);
+            EXPECT_EQ(cluster2.get()->getReleasesCount(), 0);
+        }
+    }
+
     TEST_F(DatabaseFixture, SingleTrackSingleArtistMultiClusters)
     {
         ScopedTrack track{ session };
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "profiling/LatencyHistogram.hpp"
+
+namespace lms::db::tests
+{
+    TEST(LatencyHistogram, empty)
+    {
+        const LatencyHistogram histogram;
+        EXPECT_EQ(histogram.getCount(), 0);
+        EXPECT_EQ(histogram.getPercentile(0.5), 0);
+    }
+
+    TEST(LatencyHistogram, percentiles)
+    {
+        LatencyHistogram histogram;
+        for (std::uint64_t value{ 1 }; value <= 1000; ++value)
+            histogram.add(value);
+
+        EXPECT_EQ(histogram.getCount(), 1000);
+        EXPECT_EQ(histogram.getMax(), 1000);
+
+        // at most 25% off
+        EXPECT_GE(histogram.getPercentile(0.5), 500);
+        EXPECT_LE(histogram.getPercentile(0.5), 625);
+        EXPECT_GE(histogram.getPercentile(0.99), 990);
+        EXPECT_LE(histogram.getPercentile(0.99), 1000);
+        EXPECT_EQ(histogram.getPercentile(1), 1000);
+    }
+
+    TEST(LatencyHistogram, largeValues)
+    {
+        LatencyHistogram histogram;
+        histogram.add(std::uint64_t{ 1 } << 40);
+        histogram.add((std::uint64_t{ 1 } << 41) + 3);
+        histogram.add(std::numeric_limits<std::uint64_t>::max());
+
+        EXPECT_EQ(histogram.getCount(), 3);
+        EXPECT_EQ(histogram.getMax(), std::numeric_limits<std::uint64_t>::max());
+        EXPECT_EQ(histogram.getPercentile(1), std::numeric_limits<std::uint64_t>::max());
+
+        LatencyHistogram other;
+        other.add(std::uint64_t{ 1 } << 40);
+        histogram.merge(other);
+        EXPECT_EQ(histogram.getCount(), 4);
+    }
+} // namespace lms::db::tests
@@ -1537,6 +1537,53 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Listen_stats)
+    {
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+        ScopedUser user{ session, "MyUser" };
+
+        auto getTopTracks{ [&] {
+            auto transaction{ session.createReadTransaction() };
+
+            Listen::StatsFindParameters params;
+            params.setUser(user->getId());
+            params.setScrobblingBackend(ScrobblingBackend::Internal);
+            return Listen::getTopTracks(session, params).results;
+        } };
+        auto getListenCount{ [&](TrackId trackId) {
+            auto transaction{ session.createReadTransaction() };
+            return Listen::getCount(session, user->getId(), trackId);
+        } };
+
+        const Wt::WDateTime dateTime1{ Wt::WDate{ 2000, 1, 2 }, Wt::WTime{ 12, 0, 1 } };
+        const Wt::WDateTime dateTime2{ Wt::WDate{ 2000, 1, 3 }, Wt::WTime{ 12, 0, 1 } };
+        ScopedListen listen1{ session, user.lockAndGet(), track1.lockAndGet(), ScrobblingBackend::Internal, dateTime1 };
+        ScopedListen listen2{ session, user.lockAndGet(), track2.lockAndGet(), ScrobblingBackend::Internal, dateTime1 };
+        {
+            ScopedListen listen3{ session, user.lockAndGet(), track2.lockAndGet(), ScrobblingBackend::Internal, dateTime2 };
+
+            EXPECT_EQ(getListenCount(track1.getId()), 1);
+            EXPECT_EQ(getListenCount(track2.getId()), 2);
+            EXPECT_EQ(getTopTracks(), (std::vector<TrackId>{ track2.getId(), track1.getId() }));
+        }
+
+        // removed listens are taken into account
+        EXPECT_EQ(getListenCount(track2.getId()), 1);
+
+        ScopedListen listen4{ session, user.lockAndGet(), track1.lockAndGet(), ScrobblingBackend::Internal, dateTime2 };
+        EXPECT_EQ(getTopTracks(), (std::vector<TrackId>{ track1.getId(), track2.getId() }));
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            Listen::rebuildStats(session);
+        }
+
+        EXPECT_EQ(getListenCount(track1.getId()), 2);
+        EXPECT_EQ(getListenCount(track2.getId()), 1);
+        EXPECT_EQ(getTopTracks(), (std::vector<TrackId>{ track1.getId(), track2.getId() }));
+    }
+
     TEST_F(DatabaseFixture, Listen_getCount_release)
     {
         ScopedTrack track1{ session };
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "core/Service.hpp"
+#include "database/objects/Track.hpp"
+#include "database/profiling/IQueryProfiler.hpp"
+
+#include "Common.hpp"
+
+namespace lms::db::tests
+{
+    TEST_F(DatabaseFixture, QueryProfiler)
+    {
+        core::Service<IQueryProfiler> profiler{ createQueryProfiler(QueryProfilerParameters{}) };
+
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+        ScopedTrack track3{ session };
+
+        {
+            const ScopedQueryOrigin origin{ "MyOrigin" };
+
+            auto transaction{ session.createReadTransaction() };
+            for (std::size_t i{}; i < 5; ++i)
+            {
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}) };
+                EXPECT_EQ(tracks.results.size(), 3);
+            }
+        }
+
+        bool found{};
+        profiler->visitQueries([&](const IQueryProfiler::QueryStats& stats) {
+            EXPECT_GE(stats.callCount, 1);
+            EXPECT_LE(stats.p50Time, stats.p90Time);
+            EXPECT_LE(stats.p90Time, stats.p99Time);
+            EXPECT_LE(stats.p99Time, stats.maxTime);
+            EXPECT_FALSE(stats.origins.empty());
+
+            const auto itOrigin{ std::find_if(std::cbegin(stats.origins), std::cend(stats.origins), [](const IQueryProfiler::QueryOriginStats& origin) { return origin.origin == "MyOrigin"; }) };
+            if (itOrigin == std::cend(stats.origins))
+                return;
+
+            found = true;
+            EXPECT_EQ(stats.callCount, 5);
+            EXPECT_EQ(stats.rowCount, 5 * 3);
+            EXPECT_EQ(itOrigin->callCount, 5);
+            EXPECT_FALSE(stats.plan.empty());
+        });
+        EXPECT_TRUE(found);
+    }
+} // namespace lms::db::tests
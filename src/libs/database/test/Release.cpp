@@ -17,6 +17,8 @@
  * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <optional>
+
 #include "Common.hpp"
 
 #include "core/PartialDateTime.hpp"
@@ -875,6 +877,7 @@ namespace lms::db::tests
 
             const auto links{ release->getArtistLinks() };
             ASSERT_EQ(links.size(), 2);
+            EXPECT_EQ(links[0]->getReleaseId(), release.getId());
             EXPECT_EQ(links[0]->getArtistId(), artist1.getId());
             EXPECT_EQ(links[0]->getArtistName(), "");
             EXPECT_EQ(links[0]->getArtistSortName(), "");
@@ -1657,6 +1660,59 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Release_keysetPagination)
+    {
+        ScopedRelease release1{ session, "b" };
+        ScopedRelease release2{ session, "A" };
+        ScopedRelease release3{ session, "B" };
+        ScopedRelease release4{ session, "a" };
+        ScopedRelease release5{ session, "c" };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_TRUE(Release::isKeysetPaginationSupported(ReleaseSortMethod::Name));
+            EXPECT_FALSE(Release::isKeysetPaginationSupported(ReleaseSortMethod::Random));
+
+            const auto allReleases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name)) };
+            const std::vector<ReleaseId> expectedReleases{ release2.getId(), release4.getId(), release1.getId(), release3.getId(), release5.getId() };
+            EXPECT_EQ(allReleases.results, expectedReleases);
+
+            std::vector<ReleaseId> visitedReleases;
+            ReleaseId lastReleaseId;
+            while (true)
+            {
+                const auto releases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name).setLastReleaseId(lastReleaseId).setRange(Range{ 0, 2 })) };
+                visitedReleases.insert(std::end(visitedReleases), std::cbegin(releases.results), std::cend(releases.results));
+                if (!releases.moreResults)
+                    break;
+
+                lastReleaseId = releases.results.back();
+            }
+            EXPECT_EQ(visitedReleases, expectedReleases);
+        }
+    }
+
+    TEST_F(DatabaseFixture, Release_keysetPaginationLastEntryRemoved)
+    {
+        ScopedRelease release1{ session, "a" };
+        std::optional<ScopedRelease> release2{ std::in_place, session, "b" };
+        ScopedRelease release3{ session, "c" };
+
+        const ReleaseId lastReleaseId{ release2->getId() };
+        release2.reset();
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_FALSE(Release::exists(session, lastReleaseId));
+
+            const auto releases{ Release::findIds(session, Release::FindParameters{}.setSortMethod(ReleaseSortMethod::Name).setLastReleaseId(lastReleaseId).setRange(Range{ 0, 2 })) };
+            EXPECT_TRUE(releases.results.empty());
+            EXPECT_FALSE(releases.moreResults);
+        }
+    }
+
     TEST_F(DatabaseFixture, Release_updateArtwork)
     {
         ScopedRelease release{ session, "MyRelease" };
@@ -21,6 +21,8 @@
 
 #include <initializer_list>
 
+#include "core/UUID.hpp"
+
 #include "Common.hpp"
 
 namespace lms::db::tests
@@ -49,4 +51,36 @@ namespace lms::db::tests
             ASSERT_EQ(artists.size(), 2);
         }
     }
+
+    TEST_F(DatabaseFixture, ScanSettings_scanGeneration)
+    {
+        ScopedScanSettings settings{ session, "test" };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_EQ(settings.get()->getScanGeneration(), 0);
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            settings.get().modify()->incScanGeneration();
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_EQ(settings.get()->getScanGeneration(), 1);
+        }
+    }
+
+    TEST_F(DatabaseFixture, ScanSettings_databaseId)
+    {
+        ScopedScanSettings settings1{ session, "test1" };
+        ScopedScanSettings settings2{ session, "test2" };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_TRUE(core::UUID::fromString(settings1.get()->getDatabaseId()));
+            EXPECT_NE(settings1.get()->getDatabaseId(), settings2.get()->getDatabaseId());
+        }
+    }
 } // namespace lms::db::tests
\ No newline at end of file
@@ -20,6 +20,9 @@
 #include "Common.hpp"
 
 #include <algorithm>
+#include <list>
+#include <set>
+#include <vector>
 
 #include "database/objects/Artwork.hpp"
 #include "database/objects/Image.hpp"
@@ -261,6 +264,108 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Track_findRandom)
+    {
+        std::list<ScopedTrack> tracks;
+        std::vector<TrackId> flacTrackIds;
+        for (std::size_t i{}; i < 40; ++i)
+        {
+            tracks.emplace_back(session);
+
+            auto transaction{ session.createWriteTransaction() };
+            tracks.back().get().modify()->setCodec(i % 2 ? core::media::Codec::FLAC : core::media::Codec::MP3);
+            if (i % 2)
+                flacTrackIds.push_back(tracks.back().getId());
+        }
+
+        auto checkDistinct{ [](std::vector<TrackId> trackIds) {
+            std::sort(std::begin(trackIds), std::end(trackIds));
+            return std::adjacent_find(std::cbegin(trackIds), std::cend(trackIds)) == std::cend(trackIds);
+        } };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            const auto randomTracks{ Track::findIds(session, Track::FindParameters{}.setSortMethod(TrackSortMethod::Random).setRange(Range{ 0, 5 })) };
+            EXPECT_EQ(randomTracks.results.size(), 5);
+            EXPECT_TRUE(randomTracks.moreResults);
+            EXPECT_TRUE(checkDistinct(randomTracks.results));
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            const auto randomTracks{ Track::findIds(session, Track::FindParameters{}.setSortMethod(TrackSortMethod::Random).setFilters(Filters{}.setCodec(core::media::Codec::FLAC)).setRange(Range{ 0, 5 })) };
+            EXPECT_EQ(randomTracks.results.size(), 5);
+            EXPECT_TRUE(checkDistinct(randomTracks.results));
+            for (const TrackId trackId : randomTracks.results)
+                EXPECT_TRUE(std::find(std::cbegin(flacTrackIds), std::cend(flacTrackIds), trackId) != std::cend(flacTrackIds));
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<TrackId> randomTracks;
+            Track::find(session, Track::FindParameters{}.setSortMethod(TrackSortMethod::Random).setFilters(Filters{}.setCodec(core::media::Codec::FLAC)).setRange(Range{ 0, 5 }), [&](const Track::pointer& track) {
+                EXPECT_TRUE(track->getCodec() == core::media::Codec::FLAC);
+                randomTracks.push_back(track->getId());
+            });
+            EXPECT_EQ(randomTracks.size(), 5);
+            EXPECT_TRUE(checkDistinct(randomTracks));
+        }
+
+        {
+            // more than available
+            auto transaction{ session.createReadTransaction() };
+
+            const auto randomTracks{ Track::findIds(session, Track::FindParameters{}.setSortMethod(TrackSortMethod::Random).setFilters(Filters{}.setCodec(core::media::Codec::FLAC)).setRange(Range{ 0, 30 })) };
+            EXPECT_EQ(randomTracks.results.size(), flacTrackIds.size());
+            EXPECT_FALSE(randomTracks.moreResults);
+            EXPECT_TRUE(checkDistinct(randomTracks.results));
+        }
+    }
+
+    TEST_F(DatabaseFixture, Track_findRandomCoverage)
+    {
+        // all the tracks are probed, whereas one FLAC track out of 5 is too sparse to be probed
+        std::list<ScopedTrack> tracks;
+        std::set<TrackId> allTrackIds;
+        std::set<TrackId> flacTrackIds;
+        for (std::size_t i{}; i < 100; ++i)
+        {
+            tracks.emplace_back(session);
+            allTrackIds.insert(tracks.back().getId());
+
+            auto transaction{ session.createWriteTransaction() };
+            tracks.back().get().modify()->setCodec(i % 5 ? core::media::Codec::MP3 : core::media::Codec::FLAC);
+            if (i % 5 == 0)
+                flacTrackIds.insert(tracks.back().getId());
+        }
+
+        auto pickAll{ [&](const Filters& filters, const std::set<TrackId>& expectedTrackIds) {
+            std::set<TrackId> pickedTrackIds;
+            for (std::size_t i{}; i < 1'000; ++i)
+            {
+                const auto randomTracks{ Track::findIds(session, Track::FindParameters{}.setSortMethod(TrackSortMethod::Random).setFilters(filters).setRange(Range{ 0, 2 })) };
+                EXPECT_EQ(randomTracks.results.size(), 2);
+                EXPECT_TRUE(randomTracks.moreResults);
+                for (const TrackId trackId : randomTracks.results)
+                {
+                    EXPECT_TRUE(expectedTrackIds.contains(trackId));
+                    pickedTrackIds.insert(trackId);
+                }
+            }
+
+            // no entry is out of reach
+            EXPECT_EQ(pickedTrackIds, expectedTrackIds);
+        } };
+
+        auto transaction{ session.createReadTransaction() };
+
+        pickAll(Filters{}, allTrackIds);
+        pickAll(Filters{}.setCodec(core::media::Codec::FLAC), flacTrackIds);
+    }
+
     TEST_F(DatabaseFixture, Track_MediaLibrary)
     {
         ScopedTrack track{ session };
@@ -309,6 +414,35 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Track_findReleaseIds)
+    {
+        ScopedRelease release{ session, "MyRelease" };
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+        ScopedTrack trackWithoutRelease{ session };
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            track1.get().modify()->setRelease(release.get());
+            track2.get().modify()->setRelease(release.get());
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<std::pair<TrackId, ReleaseId>> trackReleaseIds;
+            Track::findReleaseIds(session, [&](TrackId trackId, ReleaseId releaseId) {
+                trackReleaseIds.emplace_back(trackId, releaseId);
+            });
+
+            ASSERT_EQ(trackReleaseIds.size(), 2);
+            EXPECT_EQ(trackReleaseIds[0].first, track1.getId());
+            EXPECT_EQ(trackReleaseIds[0].second, release.getId());
+            EXPECT_EQ(trackReleaseIds[1].first, track2.getId());
+            EXPECT_EQ(trackReleaseIds[1].second, release.getId());
+        }
+    }
+
     TEST_F(DatabaseFixture, TrackNotExists)
     {
         auto transaction{ session.createReadTransaction() };
@@ -384,6 +518,84 @@ namespace lms::db::tests
         }
     }
 
+    TEST_F(DatabaseFixture, Track_findByKeywords)
+    {
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+        ScopedTrack track3{ session };
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            track1.get().modify()->setName("Some very long title with Yesterday inside");
+            track2.get().modify()->setName("Yesterday");
+            track3.get().modify()->setName("Strawberry Fields");
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            {
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "yesTER" }).setSortMethod(TrackSortMethod::Relevance)) };
+                ASSERT_EQ(tracks.results.size(), 2);
+                EXPECT_EQ(tracks.results[0], track2.getId());
+                EXPECT_EQ(tracks.results[1], track1.getId());
+            }
+            {
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "long", "yesterday" })) };
+                ASSERT_EQ(tracks.results.size(), 1);
+                EXPECT_EQ(tracks.results[0], track1.getId());
+            }
+            {
+                // too short to be indexed
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "Fields", "x" })) };
+                EXPECT_EQ(tracks.results.size(), 0);
+            }
+            {
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "Fields", "s" })) };
+                ASSERT_EQ(tracks.results.size(), 1);
+                EXPECT_EQ(tracks.results[0], track3.getId());
+            }
+            {
+                const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "e" }).setSortMethod(TrackSortMethod::Relevance)) };
+                ASSERT_EQ(tracks.results.size(), 3);
+                EXPECT_EQ(tracks.results[0], track1.getId());
+                EXPECT_EQ(tracks.results[1], track2.getId());
+                EXPECT_EQ(tracks.results[2], track3.getId());
+            }
+        }
+
+        {
+            auto transaction{ session.createWriteTransaction() };
+            track3.get().modify()->setName("Let It Be");
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            EXPECT_EQ(Track::findIds(session, Track::FindParameters{}.setKeywords({ "Strawberry" })).results.size(), 0);
+
+            const auto tracks{ Track::findIds(session, Track::FindParameters{}.setKeywords({ "let", "be" })) };
+            ASSERT_EQ(tracks.results.size(), 1);
+            EXPECT_EQ(tracks.results[0], track3.getId());
+        }
+
+        {
+            ScopedTrack track4{ session };
+            {
+                auto transaction{ session.createWriteTransaction() };
+                track4.get().modify()->setName("Yesterday once more");
+            }
+
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_EQ(Track::findIds(session, Track::FindParameters{}.setKeywords({ "yesterday" })).results.size(), 3);
+        }
+
+        {
+            auto transaction{ session.createReadTransaction() };
+            EXPECT_EQ(Track::findIds(session, Track::FindParameters{}.setKeywords({ "yesterday" })).results.size(), 2);
+        }
+    }
+
     TEST_F(DatabaseFixture, Track_date)
     {
         ScopedTrack track{ session };
@@ -409,6 +409,7 @@ namespace lms::db::tests
             EXPECT_EQ(link->getIndex(), 0);
             EXPECT_EQ(link->getType(), core::media::ImageType::Unknown);
             EXPECT_EQ(link->getDescription(), "");
+            EXPECT_EQ(link->getDataOffset(), std::nullopt);
             EXPECT_EQ(link->getTrack(), track.get());
             EXPECT_EQ(link->getImage(), image.get());
         }
@@ -421,6 +422,7 @@ namespace lms::db::tests
             link.modify()->setIndex(2);
             link.modify()->setType(core::media::ImageType::FrontCover);
             link.modify()->setDescription("MyDesc");
+            link.modify()->setDataOffset(5000000000);
         }
 
         {
@@ -431,6 +433,7 @@ namespace lms::db::tests
             EXPECT_EQ(img->getIndex(), 2);
             EXPECT_EQ(img->getType(), core::media::ImageType::FrontCover);
             EXPECT_EQ(img->getDescription(), "MyDesc");
+            EXPECT_EQ(img->getDataOffset(), 5000000000);
         }
 
         {
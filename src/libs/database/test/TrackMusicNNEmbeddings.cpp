@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/objects/TrackMusicNNEmbeddings.hpp"
+
+#include <vector>
+
+#include "Common.hpp"
+
+namespace lms::db::tests
+{
+    using ScopedTrackMusicNNEmbeddings = ScopedEntity<db::TrackMusicNNEmbeddings>;
+
+    TEST_F(DatabaseFixture, TrackMusicNNEmbeddings_findTrackIds)
+    {
+        ScopedTrack track1{ session };
+        ScopedTrack track2{ session };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            bool visited{};
+            TrackMusicNNEmbeddings::findTrackIds(session, [&](TrackMusicNNEmbeddingsId, TrackId) { visited = true; });
+            EXPECT_FALSE(visited);
+        }
+
+        ScopedTrackMusicNNEmbeddings embeddings{ session, track2.lockAndGet() };
+
+        {
+            auto transaction{ session.createReadTransaction() };
+
+            std::vector<std::pair<TrackMusicNNEmbeddingsId, TrackId>> visitedIds;
+            TrackMusicNNEmbeddings::findTrackIds(session, [&](TrackMusicNNEmbeddingsId embeddingsId, TrackId trackId) { visitedIds.emplace_back(embeddingsId, trackId); });
+            ASSERT_EQ(visitedIds.size(), 1);
+            EXPECT_EQ(visitedIds[0].first, embeddings.getId());
+            EXPECT_EQ(visitedIds[0].second, track2.getId());
+        }
+    }
+} // namespace lms::db::tests
@@ -25,8 +25,11 @@
 
 #include "core/Random.hpp"
 
+#include "math/BatchedDistance.hpp"
 #include "math/ChamferDistance.hpp"
+#include "math/NormalizedCosineDistance.hpp"
 #include "math/Vector.hpp"
+#include "math/VectorStore.hpp"
 
 namespace lms::core::benchs
 {
@@ -110,6 +113,53 @@ namespace lms::core::benchs
         state.SetItemsProcessed(state.iterations() * 2 * SetASize * SetBSize);
     }
 
+    template<std::size_t VectorSize>
+    static std::vector<math::Vector<VectorSize, float>> generateNormalizedVectors(std::minstd_rand& randomEngine, std::size_t count)
+    {
+        std::vector<math::Vector<VectorSize, float>> vectors(count);
+        for (auto& vec : vectors)
+        {
+            core::random::fillContainer(randomEngine, vec, 0.F, 1.F);
+            vec.normalizeL2();
+        }
+
+        return vectors;
+    }
+
+    // Distance used to compare release and artist profiles
+    template<std::size_t VectorSize, std::size_t SetASize, std::size_t SetBSize>
+    static void BM_SymmetricalChamferDistance_NormalizedCosine(benchmark::State& state)
+    {
+        std::minstd_rand randomEngine{ 0 };
+
+        const auto vecA{ generateNormalizedVectors<VectorSize>(randomEngine, SetASize) };
+        const auto vecB{ generateNormalizedVectors<VectorSize>(randomEngine, SetBSize) };
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(math::symmetricalChamferDistance<math::NormalizedCosineDistance<VectorSize, float>>(vecA, vecB));
+        }
+
+        state.SetItemsProcessed(state.iterations() * 2 * SetASize * SetBSize);
+    }
+
+    // Same distance, using the batched kernels on contiguous rows
+    template<std::size_t VectorSize, std::size_t SetASize, std::size_t SetBSize>
+    static void BM_SymmetricalChamferDistance_NormalizedCosineBatched(benchmark::State& state)
+    {
+        std::minstd_rand randomEngine{ 0 };
+
+        const math::VectorStore<VectorSize, float> vecA{ generateNormalizedVectors<VectorSize>(randomEngine, SetASize) };
+        const math::VectorStore<VectorSize, float> vecB{ generateNormalizedVectors<VectorSize>(randomEngine, SetBSize) };
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(math::computeSymmetricalNormalizedCosineChamferDistance(vecA.getView(), vecB.getView()));
+        }
+
+        state.SetItemsProcessed(state.iterations() * 2 * SetASize * SetBSize);
+    }
+
     // Benchmarks with different configurations
     BENCHMARK_TEMPLATE(BM_ChamferDistanceAtoB, 128, 10, 10);
     BENCHMARK_TEMPLATE(BM_ChamferDistanceAtoB, 128, 50, 50);
@@ -120,4 +170,11 @@ namespace lms::core::benchs
     BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance, 128, 50, 50);
     BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance, 256, 10, 10);
     BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance, 256, 50, 50);
+
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosine, 60, 10, 10);
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosine, 60, 50, 50);
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosine, 128, 50, 50);
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosineBatched, 60, 10, 10);
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosineBatched, 60, 50, 50);
+    BENCHMARK_TEMPLATE(BM_SymmetricalChamferDistance_NormalizedCosineBatched, 128, 50, 50);
 } // namespace lms::core::benchs
@@ -19,14 +19,27 @@
 
 #include <benchmark/benchmark.h>
 #include <random>
+#include <vector>
 
 #include "core/Random.hpp"
 
+#include "math/BatchedDistance.hpp"
 #include "math/CosineDistance.hpp"
 #include "math/NormalizedCosineDistance.hpp"
+#include "math/VectorStore.hpp"
 
 namespace lms::math::benchs
 {
+    namespace
+    {
+        const std::vector<std::int64_t> instructionSets{
+            static_cast<std::int64_t>(SimdInstructionSet::None),
+            static_cast<std::int64_t>(SimdInstructionSet::Avx2),
+            static_cast<std::int64_t>(SimdInstructionSet::Avx512),
+            static_cast<std::int64_t>(SimdInstructionSet::Neon),
+        };
+    } // namespace
+
     template<std::size_t Size>
     static void BM_CosineDistance(benchmark::State& state)
     {
@@ -93,6 +106,80 @@ namespace lms::math::benchs
         state.SetItemsProcessed(state.iterations() * Size);
     }
 
+    // One query against many vectors, one pair at a time
+    template<std::size_t Size>
+    static void BM_NormalizedCosineDistance_Loop(benchmark::State& state)
+    {
+        const std::size_t rowCount{ static_cast<std::size_t>(state.range(0)) };
+        std::minstd_rand randomEngine{ 0 };
+
+        Vector<Size, float> query;
+        core::random::fillContainer(randomEngine, query, 0.F, 1.F);
+        query.normalizeL2();
+
+        std::vector<Vector<Size, float>> rows(rowCount);
+        for (Vector<Size, float>& row : rows)
+        {
+            core::random::fillContainer(randomEngine, row, 0.F, 1.F);
+            row.normalizeL2();
+        }
+
+        std::vector<float> distances(rowCount);
+        for (auto _ : state)
+        {
+            const NormalizedCosineDistance<Size, float> dist{ query };
+            for (std::size_t i{}; i < rowCount; ++i)
+                distances[i] = dist(rows[i]);
+
+            benchmark::DoNotOptimize(distances.data());
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * rowCount * Size);
+    }
+
+    // Same, using the batched kernel of the given instruction set
+    template<std::size_t Size>
+    static void BM_NormalizedCosineDistance_Batched(benchmark::State& state)
+    {
+        const std::size_t rowCount{ static_cast<std::size_t>(state.range(0)) };
+        const auto instructionSet{ static_cast<SimdInstructionSet>(state.range(1)) };
+        if (!isSimdInstructionSetSupported(instructionSet))
+        {
+            state.SkipWithError("instruction set not supported");
+            return;
+        }
+
+        std::minstd_rand randomEngine{ 0 };
+
+        Vector<Size, float> query;
+        core::random::fillContainer(randomEngine, query, 0.F, 1.F);
+        query.normalizeL2();
+
+        VectorStore<Size, float> rows;
+        rows.reserve(rowCount);
+        for (std::size_t i{}; i < rowCount; ++i)
+        {
+            Vector<Size, float> row;
+            core::random::fillContainer(randomEngine, row, 0.F, 1.F);
+            row.normalizeL2();
+            rows.add(row);
+        }
+
+        std::vector<float> distances(rowCount);
+        for (auto _ : state)
+        {
+            computeDotProducts(query, rows.getView(), distances, instructionSet);
+            for (float& distance : distances)
+                distance = (1.F - distance) / 2.F;
+
+            benchmark::DoNotOptimize(distances.data());
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * rowCount * Size);
+    }
+
     BENCHMARK_TEMPLATE(BM_CosineDistance, 4);
     BENCHMARK_TEMPLATE(BM_CosineDistance, 50);
     BENCHMARK_TEMPLATE(BM_CosineDistance, 160);
@@ -102,4 +189,9 @@ namespace lms::math::benchs
     BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Functor, 4);
     BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Functor, 50);
     BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Functor, 160);
+
+    BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Loop, 60)->Arg(1'000)->Arg(100'000);
+    BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Loop, 200)->Arg(1'000)->Arg(100'000);
+    BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Batched, 60)->ArgsProduct({ { 1'000, 100'000 }, instructionSets });
+    BENCHMARK_TEMPLATE(BM_NormalizedCosineDistance_Batched, 200)->ArgsProduct({ { 1'000, 100'000 }, instructionSets });
 } // namespace lms::math::benchs
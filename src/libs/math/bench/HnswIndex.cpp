@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "math/HnswIndex.hpp"
+
+namespace lms::math::benchs
+{
+    namespace
+    {
+        constexpr std::size_t hnswDimCount{ 60 };
+        using HnswVector = Vector<hnswDimCount, float>;
+        using Index = HnswIndex<hnswDimCount, float>;
+        using Vectors = VectorStore<hnswDimCount, float>;
+
+        constexpr std::size_t queryCount{ 100 };
+        constexpr std::size_t neighborCount{ 32 };
+
+        // Random vectors in a lower dimensional subspace: embeddings are far from uniform noise, and
+        // the achievable recall mostly depends on this intrinsic dimension
+        std::vector<HnswVector> generateHnswVectors(std::size_t count, std::uint32_t seed)
+        {
+            constexpr std::size_t latentDimCount{ 16 };
+
+            std::mt19937 projectionRandomEngine{ 42 };
+            std::mt19937 randomEngine{ seed };
+            std::normal_distribution<float> distribution{ 0.F, 1.F };
+
+            std::array<std::array<float, latentDimCount>, hnswDimCount> projection;
+            for (auto& row : projection)
+            {
+                for (float& value : row)
+                    value = distribution(projectionRandomEngine);
+            }
+
+            std::vector<HnswVector> vectors(count);
+            std::array<float, latentDimCount> latentVector;
+            for (HnswVector& vector : vectors)
+            {
+                for (float& value : latentVector)
+                    value = distribution(randomEngine);
+
+                for (std::size_t i{}; i < hnswDimCount; ++i)
+                {
+                    vector[i] = 0;
+                    for (std::size_t j{}; j < latentDimCount; ++j)
+                        vector[i] += projection[i][j] * latentVector[j];
+                }
+                vector.normalizeL2();
+            }
+
+            return vectors;
+        }
+
+        std::vector<Index::Neighbor> searchBruteForce(const Vectors& vectors, const HnswVector& query, std::size_t maxCount)
+        {
+            std::vector<Index::Neighbor> neighbors;
+            neighbors.reserve(vectors.size());
+            for (std::size_t i{}; i < vectors.size(); ++i)
+                neighbors.push_back({ static_cast<Index::NodeIndex>(i), computeNormalizedCosineDistance(query, vectors[i]) });
+
+            maxCount = std::min(maxCount, neighbors.size());
+            std::partial_sort(std::begin(neighbors), std::next(std::begin(neighbors), static_cast<std::ptrdiff_t>(maxCount)), std::end(neighbors), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+            neighbors.resize(maxCount);
+            return neighbors;
+        }
+
+        // Indexed vectors and the index built on them, shared between benchmarks
+        struct Dataset
+        {
+            Vectors vectors;
+            std::vector<HnswVector> queries;
+            Index index;
+        };
+
+        Dataset& getDataset(std::size_t vectorCount)
+        {
+            static std::map<std::size_t, Dataset> datasets;
+
+            auto [it, inserted]{ datasets.try_emplace(vectorCount) };
+            if (inserted)
+            {
+                it->second.vectors = Vectors{ generateHnswVectors(vectorCount, 0) };
+                it->second.queries = generateHnswVectors(queryCount, 1);
+                it->second.index.build(it->second.vectors, {});
+            }
+
+            return it->second;
+        }
+    } // namespace
+
+    static void BM_HnswIndex_build(benchmark::State& state)
+    {
+        const Vectors vectors{ generateHnswVectors(static_cast<std::size_t>(state.range(0)), 0) };
+
+        for (auto _ : state)
+        {
+            Index index;
+            index.build(vectors, {});
+            benchmark::DoNotOptimize(index);
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    static void BM_HnswIndex_bruteForceSearch(benchmark::State& state)
+    {
+        const Dataset& dataset{ getDataset(static_cast<std::size_t>(state.range(0))) };
+
+        std::size_t queryIndex{};
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(searchBruteForce(dataset.vectors, dataset.queries[queryIndex], neighborCount));
+            queryIndex = (queryIndex + 1) % dataset.queries.size();
+        }
+    }
+
+    static void BM_HnswIndex_search(benchmark::State& state)
+    {
+        const Dataset& dataset{ getDataset(static_cast<std::size_t>(state.range(0))) };
+        const std::size_t candidateCount{ static_cast<std::size_t>(state.range(1)) };
+
+        std::size_t queryIndex{};
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(dataset.index.search(dataset.queries[queryIndex], neighborCount, candidateCount));
+            queryIndex = (queryIndex + 1) % dataset.queries.size();
+        }
+
+        // recall against the exact neighbors, not timed
+        std::size_t foundCount{};
+        for (const HnswVector& query : dataset.queries)
+        {
+            const auto expected{ searchBruteForce(dataset.vectors, query, neighborCount) };
+            for (const Index::Neighbor& neighbor : dataset.index.search(query, neighborCount, candidateCount))
+            {
+                if (std::any_of(std::cbegin(expected), std::cend(expected), [&](const Index::Neighbor& expectedNeighbor) { return expectedNeighbor.index == neighbor.index; }))
+                    foundCount++;
+            }
+        }
+        state.counters["recall"] = static_cast<double>(foundCount) / static_cast<double>(dataset.queries.size() * neighborCount);
+    }
+
+    BENCHMARK(BM_HnswIndex_build)->Arg(10'000)->Arg(100'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_HnswIndex_bruteForceSearch)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(BM_HnswIndex_search)->ArgsProduct({ { 10'000, 100'000 }, { 32, 64, 128, 256 } })->Unit(benchmark::kMicrosecond);
+} // namespace lms::math::benchs
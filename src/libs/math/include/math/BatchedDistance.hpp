@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "math/Vector.hpp"
+#include "math/VectorStore.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define LMS_MATH_SIMD_X86 1
+    #include <immintrin.h>
+#elif defined(__aarch64__)
+    #define LMS_MATH_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace lms::math
+{
+    // Distances from one query to many rows of a VectorStore
+    // On x86, the kernel is selected at runtime depending on the CPU (AVX-512, AVX2 or scalar), NEON is always used on aarch64
+
+    enum class SimdInstructionSet
+    {
+        None,
+        Avx2,
+        Avx512,
+        Neon,
+    };
+
+    namespace detail
+    {
+        inline SimdInstructionSet detectSimdInstructionSet()
+        {
+#if LMS_MATH_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return SimdInstructionSet::Avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return SimdInstructionSet::Avx2;
+            return SimdInstructionSet::None;
+#elif LMS_MATH_SIMD_NEON
+            return SimdInstructionSet::Neon;
+#else
+            return SimdInstructionSet::None;
+#endif
+        }
+
+        // Kernels: results[i] = dot(query, getRow(i)) for i in [0, rowCount)
+        // query and rows are 64-byte aligned and hold PaddedSize values
+
+        template<std::size_t PaddedSize, typename FloatType, typename GetRow>
+        void computeDotProductsScalar(const FloatType* query, std::size_t rowCount, GetRow getRow, FloatType* results)
+        {
+            for (std::size_t i{}; i < rowCount; ++i)
+            {
+                const FloatType* row{ getRow(i) };
+
+                FloatType res{};
+                for (std::size_t j{}; j < PaddedSize; ++j)
+                    res += query[j] * row[j];
+
+                results[i] = res;
+            }
+        }
+
+#if LMS_MATH_SIMD_X86
+        template<std::size_t PaddedSize, typename GetRow>
+        [[gnu::target("avx2,fma")]] void computeDotProductsAvx2(const float* query, std::size_t rowCount, GetRow getRow, float* results)
+        {
+            constexpr std::size_t registerSize{ 8 };
+            constexpr std::size_t registerCount{ PaddedSize / registerSize };
+            static_assert(PaddedSize % (2 * registerSize) == 0);
+
+            __m256 queryValues[registerCount];
+            for (std::size_t j{}; j < registerCount; ++j)
+                queryValues[j] = _mm256_load_ps(query + j * registerSize);
+
+            for (std::size_t i{}; i < rowCount; ++i)
+            {
+                const float* row{ getRow(i) };
+
+                // two accumulators to shorten the dependency chain
+                __m256 sum0{ _mm256_mul_ps(queryValues[0], _mm256_load_ps(row)) };
+                __m256 sum1{ _mm256_mul_ps(queryValues[1], _mm256_load_ps(row + registerSize)) };
+                for (std::size_t j{ 2 }; j < registerCount; j += 2)
+                {
+                    sum0 = _mm256_fmadd_ps(queryValues[j], _mm256_load_ps(row + j * registerSize), sum0);
+                    sum1 = _mm256_fmadd_ps(queryValues[j + 1], _mm256_load_ps(row + (j + 1) * registerSize), sum1);
+                }
+
+                const __m256 sum{ _mm256_add_ps(sum0, sum1) };
+                __m128 sum128{ _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)) };
+                sum128 = _mm_add_ps(sum128, _mm_movehl_ps(sum128, sum128));
+                sum128 = _mm_add_ss(sum128, _mm_shuffle_ps(sum128, sum128, 0x55));
+                results[i] = _mm_cvtss_f32(sum128);
+            }
+        }
+
+        template<std::size_t PaddedSize, typename GetRow>
+        [[gnu::target("avx512f")]] void computeDotProductsAvx512(const float* query, std::size_t rowCount, GetRow getRow, float* results)
+        {
+            constexpr std::size_t registerSize{ 16 };
+            constexpr std::size_t registerCount{ PaddedSize / registerSize };
+            static_assert(PaddedSize % registerSize == 0);
+
+            __m512 queryValues[registerCount];
+            for (std::size_t j{}; j < registerCount; ++j)
+                queryValues[j] = _mm512_load_ps(query + j * registerSize);
+
+            for (std::size_t i{}; i < rowCount; ++i)
+            {
+                const float* row{ getRow(i) };
+
+                __m512 sum{ _mm512_mul_ps(queryValues[0], _mm512_load_ps(row)) };
+                for (std::size_t j{ 1 }; j < registerCount; ++j)
+                    sum = _mm512_fmadd_ps(queryValues[j], _mm512_load_ps(row + j * registerSize), sum);
+
+                // going through memory: _mm512_reduce_add_ps and the 512-bit extracts trigger spurious maybe-uninitialized warnings on some GCC versions
+                alignas(64) float lanes[registerSize];
+                _mm512_store_ps(lanes, sum);
+                const __m256 sum256{ _mm256_add_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8)) };
+                __m128 sum128{ _mm_add_ps(_mm256_castps256_ps128(sum256), _mm256_extractf128_ps(sum256, 1)) };
+                sum128 = _mm_add_ps(sum128, _mm_movehl_ps(sum128, sum128));
+                sum128 = _mm_add_ss(sum128, _mm_shuffle_ps(sum128, sum128, 0x55));
+                results[i] = _mm_cvtss_f32(sum128);
+            }
+        }
+#endif
+
+#if LMS_MATH_SIMD_NEON
+        template<std::size_t PaddedSize, typename GetRow>
+        void computeDotProductsNeon(const float* query, std::size_t rowCount, GetRow getRow, float* results)
+        {
+            constexpr std::size_t registerSize{ 4 };
+            constexpr std::size_t registerCount{ PaddedSize / registerSize };
+            static_assert(PaddedSize % (2 * registerSize) == 0);
+
+            for (std::size_t i{}; i < rowCount; ++i)
+            {
+                const float* row{ getRow(i) };
+
+                float32x4_t sum0{ vmulq_f32(vld1q_f32(query), vld1q_f32(row)) };
+                float32x4_t sum1{ vmulq_f32(vld1q_f32(query + registerSize), vld1q_f32(row + registerSize)) };
+                for (std::size_t j{ 2 }; j < registerCount; j += 2)
+                {
+                    sum0 = vfmaq_f32(sum0, vld1q_f32(query + j * registerSize), vld1q_f32(row + j * registerSize));
+                    sum1 = vfmaq_f32(sum1, vld1q_f32(query + (j + 1) * registerSize), vld1q_f32(row + (j + 1) * registerSize));
+                }
+
+                results[i] = vaddvq_f32(vaddq_f32(sum0, sum1));
+            }
+        }
+#endif
+
+        template<std::size_t PaddedSize, typename FloatType, typename GetRow>
+        void computeDotProducts(SimdInstructionSet instructionSet, const FloatType* query, std::size_t rowCount, GetRow getRow, FloatType* results)
+        {
+            if constexpr (std::is_same_v<FloatType, float>)
+            {
+                switch (instructionSet)
+                {
+#if LMS_MATH_SIMD_X86
+                case SimdInstructionSet::Avx512:
+                    computeDotProductsAvx512<PaddedSize>(query, rowCount, getRow, results);
+                    return;
+                case SimdInstructionSet::Avx2:
+                    computeDotProductsAvx2<PaddedSize>(query, rowCount, getRow, results);
+                    return;
+#endif
+#if LMS_MATH_SIMD_NEON
+                case SimdInstructionSet::Neon:
+                    computeDotProductsNeon<PaddedSize>(query, rowCount, getRow, results);
+                    return;
+#endif
+                default:
+                    break;
+                }
+            }
+
+            computeDotProductsScalar<PaddedSize>(query, rowCount, getRow, results);
+        }
+    } // namespace detail
+
+    // Best instruction set supported by this CPU, detected once
+    inline SimdInstructionSet getSimdInstructionSet()
+    {
+        static const SimdInstructionSet instructionSet{ detail::detectSimdInstructionSet() };
+        return instructionSet;
+    }
+
+    inline bool isSimdInstructionSetSupported(SimdInstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+        case SimdInstructionSet::None:
+            return true;
+        case SimdInstructionSet::Avx2:
+            return getSimdInstructionSet() == SimdInstructionSet::Avx2 || getSimdInstructionSet() == SimdInstructionSet::Avx512;
+        case SimdInstructionSet::Avx512:
+        case SimdInstructionSet::Neon:
+            return getSimdInstructionSet() == instructionSet;
+        }
+
+        return false;
+    }
+
+    // results[i] = dot(query, rows[i])
+    template<std::size_t Size, typename FloatType>
+    void computeDotProducts(const Vector<Size, FloatType>& query, VectorStoreView<Size, FloatType> rows, std::type_identity_t<std::span<FloatType>> results, SimdInstructionSet instructionSet = getSimdInstructionSet())
+    {
+        using View = VectorStoreView<Size, FloatType>;
+        assert(results.size() >= rows.size());
+
+        const typename View::Row paddedQuery{ .vector = query };
+        const FloatType* rowData{ rows.data() };
+        detail::computeDotProducts<View::rowStride>(instructionSet, paddedQuery.vector.data(), rows.size(), [&](std::size_t i) { return rowData + i * View::rowStride; }, results.data());
+    }
+
+    // results[i] = dot(query, rows[rowIndices[i]])
+    template<std::size_t Size, typename FloatType>
+    void computeDotProducts(const Vector<Size, FloatType>& query, VectorStoreView<Size, FloatType> rows, std::span<const std::uint32_t> rowIndices, std::type_identity_t<std::span<FloatType>> results, SimdInstructionSet instructionSet = getSimdInstructionSet())
+    {
+        using View = VectorStoreView<Size, FloatType>;
+        assert(results.size() >= rowIndices.size());
+
+        const typename View::Row paddedQuery{ .vector = query };
+        const FloatType* rowData{ rows.data() };
+        detail::computeDotProducts<View::rowStride>(instructionSet, paddedQuery.vector.data(), rowIndices.size(), [&](std::size_t i) { assert(rowIndices[i] < rows.size()); return rowData + rowIndices[i] * View::rowStride; }, results.data());
+    }
+
+    // Batched computeNormalizedCosineDistance: query and rows are expected to be L2-normalized
+    template<std::size_t Size, typename FloatType>
+    void computeNormalizedCosineDistances(const Vector<Size, FloatType>& query, VectorStoreView<Size, FloatType> rows, std::type_identity_t<std::span<FloatType>> results)
+    {
+        computeDotProducts(query, rows, results);
+        for (std::size_t i{}; i < rows.size(); ++i)
+            results[i] = (FloatType{ 1 } - results[i]) / FloatType{ 2 };
+    }
+
+    template<std::size_t Size, typename FloatType>
+    void computeNormalizedCosineDistances(const Vector<Size, FloatType>& query, VectorStoreView<Size, FloatType> rows, std::span<const std::uint32_t> rowIndices, std::type_identity_t<std::span<FloatType>> results)
+    {
+        computeDotProducts(query, rows, rowIndices, results);
+        for (std::size_t i{}; i < rowIndices.size(); ++i)
+            results[i] = (FloatType{ 1 } - results[i]) / FloatType{ 2 };
+    }
+
+    namespace detail
+    {
+        // getRowA(i) returns the row i of A, computeDotProductsB(query, results) computes the dot products of query with all the rows of B
+        template<typename FloatType, typename GetRowA, typename ComputeDotProductsB>
+        FloatType computeSymmetricalNormalizedCosineChamferDistance(std::size_t sizeA, GetRowA getRowA, std::size_t sizeB, ComputeDotProductsB computeDotProductsB)
+        {
+            assert(sizeA > 0);
+            assert(sizeB > 0);
+
+            // closest rows have the highest dot products
+            std::vector<FloatType> dotProducts(sizeB);
+            std::vector<FloatType> bestDotProductsB(sizeB, std::numeric_limits<FloatType>::lowest());
+            FloatType sumBestDotProductsA{};
+
+            for (std::size_t i{}; i < sizeA; ++i)
+            {
+                computeDotProductsB(getRowA(i), std::span{ dotProducts });
+
+                FloatType bestDotProductA{ std::numeric_limits<FloatType>::lowest() };
+                for (std::size_t j{}; j < sizeB; ++j)
+                {
+                    bestDotProductA = std::max(bestDotProductA, dotProducts[j]);
+                    bestDotProductsB[j] = std::max(bestDotProductsB[j], dotProducts[j]);
+                }
+                sumBestDotProductsA += bestDotProductA;
+            }
+
+            FloatType sumBestDotProductsB{};
+            for (const FloatType bestDotProduct : bestDotProductsB)
+                sumBestDotProductsB += bestDotProduct;
+
+            const FloatType aToB{ (FloatType{ 1 } - sumBestDotProductsA / static_cast<FloatType>(sizeA)) / FloatType{ 2 } };
+            const FloatType bToA{ (FloatType{ 1 } - sumBestDotProductsB / static_cast<FloatType>(sizeB)) / FloatType{ 2 } };
+            return (aToB + bToA) / FloatType{ 2 };
+        }
+    } // namespace detail
+
+    // Same as symmetricalChamferDistance<NormalizedCosineDistance>(A, B), but each dot product is only computed once
+    template<std::size_t Size, typename FloatType>
+    FloatType computeSymmetricalNormalizedCosineChamferDistance(VectorStoreView<Size, FloatType> A, VectorStoreView<Size, FloatType> B)
+    {
+        return detail::computeSymmetricalNormalizedCosineChamferDistance<FloatType>(
+            A.size(), [&](std::size_t i) -> const Vector<Size, FloatType>& { return A[i]; },
+            B.size(), [&](const Vector<Size, FloatType>& query, std::span<FloatType> results) { computeDotProducts(query, B, results); });
+    }
+
+    // Same as above, A and B being the rows at rowIndicesA and rowIndicesB in rows
+    template<std::size_t Size, typename FloatType>
+    FloatType computeSymmetricalNormalizedCosineChamferDistance(VectorStoreView<Size, FloatType> rows, std::span<const std::uint32_t> rowIndicesA, std::span<const std::uint32_t> rowIndicesB)
+    {
+        return detail::computeSymmetricalNormalizedCosineChamferDistance<FloatType>(
+            rowIndicesA.size(), [&](std::size_t i) -> const Vector<Size, FloatType>& { assert(rowIndicesA[i] < rows.size()); return rows[rowIndicesA[i]]; },
+            rowIndicesB.size(), [&](const Vector<Size, FloatType>& query, std::span<FloatType> results) { computeDotProducts(query, rows, rowIndicesB, results); });
+    }
+} // namespace lms::math
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+namespace lms::math::binaryIO
+{
+    // Raw values, in native endianness: the files written using these helpers are caches, only meant to be read back on the same machine
+
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<typename T>
+    void writeValues(std::ostream& os, std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        os.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+    }
+
+    template<typename T>
+    bool readValue(std::istream& is, T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    template<typename T>
+    bool readValues(std::istream& is, std::span<T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size_bytes())));
+    }
+
+    // Writes to a temporary file first, then renames it: a partially written file is never read back
+    template<typename Writer>
+    std::error_code writeFileAtomically(const std::filesystem::path& path, Writer writer)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        const std::filesystem::path tmpFilePath{ path.string() + ".tmp" };
+        {
+            std::ofstream os{ tmpFilePath, std::ios::binary | std::ios::trunc };
+            writer(os);
+            if (!os.flush())
+            {
+                std::filesystem::remove(tmpFilePath, ec);
+                return std::make_error_code(std::errc::io_error);
+            }
+        }
+
+        std::filesystem::rename(tmpFilePath, path, ec);
+        if (ec)
+        {
+            std::error_code removeEc;
+            std::filesystem::remove(tmpFilePath, removeEc);
+        }
+
+        return ec;
+    }
+} // namespace lms::math::binaryIO
@@ -0,0 +1,657 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "math/BatchedDistance.hpp"
+#include "math/BinaryIO.hpp"
+#include "math/NormalizedCosineDistance.hpp"
+#include "math/Vector.hpp"
+#include "math/VectorStore.hpp"
+
+namespace lms::math
+{
+    // Approximate nearest neighbor index over L2-normalized vectors, using the normalized cosine distance
+    // Hierarchical Navigable Small World graph (Malkov & Yashunin): each level is a proximity graph, and searches
+    // go greedily from the sparse upper levels down to the base level, that links all the vectors
+    // The index does not own the vectors: they must outlive it and must not be modified
+    // Once built or loaded, the index can be searched concurrently
+    template<std::size_t Size, typename FloatType = float>
+    class HnswIndex
+    {
+    public:
+        using VectorType = Vector<Size, FloatType>;
+        using Vectors = VectorStore<Size, FloatType>;
+        using NodeIndex = std::uint32_t;
+        using Distance = FloatType;
+
+        struct BuildParameters
+        {
+            std::size_t maxNeighborCount{ 16 }; // per node and per level (twice on the base level): higher gives a better recall but a larger index
+            std::size_t candidateCount{ 100 }; // explored candidates when inserting a vector: higher gives a better graph but a longer build
+            std::uint32_t seed{ 42 };
+        };
+
+        struct Neighbor
+        {
+            NodeIndex index; // in the indexed vectors
+            Distance distance;
+        };
+
+        void build(const Vectors& vectors, const BuildParameters& params)
+        {
+            assert(vectors.size() < std::numeric_limits<NodeIndex>::max());
+
+            clear();
+            _vectors = vectors.getView();
+            _maxNeighborCount = std::max<std::size_t>(params.maxNeighborCount, 2);
+            if (_vectors.empty())
+                return;
+
+            const std::size_t nodeCount{ _vectors.size() };
+            allocateNodes(nodeCount);
+
+            std::mt19937 randomEngine{ params.seed };
+            for (std::size_t node{}; node < nodeCount; ++node)
+                setLevel(static_cast<NodeIndex>(node), drawLevel(randomEngine));
+
+            _entryPoint = 0;
+            _topLevel = _levels[0];
+            const std::size_t candidateCount{ std::max(params.candidateCount, _maxNeighborCount) };
+            for (std::size_t node{ 1 }; node < nodeCount; ++node)
+                insert(static_cast<NodeIndex>(node), candidateCount);
+        }
+
+        // Same as build, starting from the graph of previous (that must still be usable): previousNodes gives, for each vector,
+        // its node in previous if this is the very same vector
+        // Reused nodes keep their level and their links, links to the nodes that are gone are replaced by the neighbors of these nodes,
+        // and only the other vectors are inserted. Falls back to a full build if nothing can be reused
+        void update(const HnswIndex& previous, const Vectors& vectors, std::span<const std::optional<NodeIndex>> previousNodes, const BuildParameters& params)
+        {
+            assert(&previous != this);
+            assert(previousNodes.size() == vectors.size());
+            assert(vectors.size() < std::numeric_limits<NodeIndex>::max());
+
+            if (previous.empty() || previous._maxNeighborCount != std::max<std::size_t>(params.maxNeighborCount, 2))
+            {
+                build(vectors, params);
+                return;
+            }
+
+            // new node of each previous node, if reused
+            std::vector<NodeIndex> newNodes(previous.size(), invalidNode);
+            std::size_t reusedNodeCount{};
+            for (std::size_t node{}; node < previousNodes.size(); ++node)
+            {
+                if (const std::optional<NodeIndex> previousNode{ previousNodes[node] })
+                {
+                    assert(*previousNode < previous.size());
+                    newNodes[*previousNode] = static_cast<NodeIndex>(node);
+                    reusedNodeCount++;
+                }
+            }
+
+            if (reusedNodeCount == 0)
+            {
+                build(vectors, params);
+                return;
+            }
+
+            clear();
+            _vectors = vectors.getView();
+            _maxNeighborCount = previous._maxNeighborCount;
+
+            const std::size_t nodeCount{ _vectors.size() };
+            allocateNodes(nodeCount);
+
+            std::vector<NodeIndex> addedNodes;
+            std::mt19937 randomEngine{ params.seed };
+            for (std::size_t node{}; node < nodeCount; ++node)
+            {
+                if (const std::optional<NodeIndex> previousNode{ previousNodes[node] })
+                {
+                    setLevel(static_cast<NodeIndex>(node), previous._levels[*previousNode]);
+                }
+                else
+                {
+                    setLevel(static_cast<NodeIndex>(node), drawLevel(randomEngine));
+                    addedNodes.push_back(static_cast<NodeIndex>(node));
+                }
+            }
+
+            // the previous entry point has the highest level, otherwise take the highest reused node
+            if (newNodes[previous._entryPoint] != invalidNode)
+            {
+                _entryPoint = newNodes[previous._entryPoint];
+            }
+            else
+            {
+                _entryPoint = invalidNode;
+                for (std::size_t node{}; node < nodeCount; ++node)
+                {
+                    if (previousNodes[node] && (_entryPoint == invalidNode || _levels[node] > _levels[_entryPoint]))
+                        _entryPoint = static_cast<NodeIndex>(node);
+                }
+            }
+            _topLevel = _levels[_entryPoint];
+
+            std::vector<NodeIndex> orphanNodes;
+            for (std::size_t node{}; node < nodeCount; ++node)
+            {
+                const std::optional<NodeIndex> previousNode{ previousNodes[node] };
+                if (!previousNode)
+                    continue;
+
+                for (std::size_t level{}; level <= _levels[node]; ++level)
+                    copyLinks(previous, *previousNode, newNodes, level);
+
+                // may happen if all its neighbors are gone, must be linked again to be reachable
+                if (getLinks(static_cast<NodeIndex>(node), 0).empty() && node != _entryPoint)
+                    orphanNodes.push_back(static_cast<NodeIndex>(node));
+            }
+
+            const std::size_t candidateCount{ std::max(params.candidateCount, _maxNeighborCount) };
+            for (const NodeIndex node : orphanNodes)
+                insert(node, candidateCount);
+            for (const NodeIndex node : addedNodes)
+                insert(node, candidateCount);
+        }
+
+        // Returns up to maxCount neighbors, closest first
+        // candidateCount is the number of explored candidates: higher gives a better recall but slower searches
+        std::vector<Neighbor> search(const VectorType& query, std::size_t maxCount, std::size_t candidateCount) const
+        {
+            if (empty() || maxCount == 0)
+                return {};
+
+            NodeIndex entryPoint{ _entryPoint };
+            for (std::size_t level{ _topLevel }; level > 0; --level)
+                entryPoint = searchClosest(query, entryPoint, level);
+
+            std::vector<Neighbor> neighbors{ searchLevel(query, entryPoint, std::max(candidateCount, maxCount), 0) };
+            std::sort(std::begin(neighbors), std::end(neighbors), [](const Neighbor& lhs, const Neighbor& rhs) { return lhs.distance < rhs.distance; });
+            if (neighbors.size() > maxCount)
+                neighbors.resize(maxCount);
+
+            return neighbors;
+        }
+
+        void save(std::ostream& os) const
+        {
+            using namespace binaryIO;
+
+            writeValue(os, fileMagic);
+            writeValue(os, fileVersion);
+            writeValue(os, static_cast<std::uint32_t>(Size));
+            writeValue(os, static_cast<std::uint32_t>(sizeof(FloatType)));
+            writeValue(os, static_cast<std::uint64_t>(size()));
+            writeValue(os, static_cast<std::uint32_t>(_maxNeighborCount));
+            writeValue(os, _entryPoint);
+            writeValue(os, static_cast<std::uint32_t>(_topLevel));
+
+            writeValues(os, std::span{ _levels });
+            writeValues(os, std::span{ _baseLinks });
+            for (const std::vector<NodeIndex>& upperLinks : _upperLinks)
+                writeValues(os, std::span{ upperLinks });
+        }
+
+        // Returns false if the saved index is invalid, or if it was not built from the same number of vectors
+        bool load(std::istream& is, const Vectors& vectors)
+        {
+            clear();
+            if (!doLoad(is, vectors.getView()))
+            {
+                clear();
+                return false;
+            }
+
+            return true;
+        }
+
+        std::size_t size() const { return _levels.size(); }
+        bool empty() const { return _levels.empty(); }
+
+    private:
+        static constexpr std::uint32_t fileMagic{ 0x574E5348 };
+        static constexpr std::uint32_t fileVersion{ 1 };
+        static constexpr std::size_t maxLevel{ 16 };
+        static constexpr NodeIndex invalidNode{ std::numeric_limits<NodeIndex>::max() };
+
+        // Cheap visited set, reused by all the searches of a thread
+        struct VisitedNodes
+        {
+            std::vector<std::uint16_t> tags;
+            std::uint16_t currentTag{};
+
+            void reset(std::size_t nodeCount)
+            {
+                if (tags.size() < nodeCount)
+                    tags.resize(nodeCount, 0);
+
+                if (++currentTag == 0)
+                {
+                    std::fill(std::begin(tags), std::end(tags), 0);
+                    currentTag = 1;
+                }
+            }
+
+            // false if already visited
+            bool insert(NodeIndex node)
+            {
+                if (tags[node] == currentTag)
+                    return false;
+
+                tags[node] = currentTag;
+                return true;
+            }
+        };
+
+        static VisitedNodes& getVisitedNodes()
+        {
+            thread_local VisitedNodes visitedNodes;
+            return visitedNodes;
+        }
+
+        static bool isCloser(const Neighbor& lhs, const Neighbor& rhs) { return lhs.distance < rhs.distance; }
+        static bool isFarther(const Neighbor& lhs, const Neighbor& rhs) { return lhs.distance > rhs.distance; }
+
+        void clear()
+        {
+            _vectors = {};
+            _levels.clear();
+            _baseLinks.clear();
+            _upperLinks.clear();
+            _entryPoint = 0;
+            _topLevel = 0;
+        }
+
+        void allocateNodes(std::size_t nodeCount)
+        {
+            _levels.assign(nodeCount, 0);
+            _baseLinks.assign(nodeCount * (getMaxNeighborCount(0) + 1), 0);
+            _upperLinks.assign(nodeCount, {});
+        }
+
+        void setLevel(NodeIndex node, std::size_t level)
+        {
+            _levels[node] = static_cast<std::uint8_t>(level);
+            _upperLinks[node].assign(level * (_maxNeighborCount + 1), 0);
+        }
+
+        // level of a new node, drawn from an exponentially decaying distribution
+        std::size_t drawLevel(std::mt19937& randomEngine) const
+        {
+            std::uniform_real_distribution<double> distribution{ std::numeric_limits<double>::min(), 1.0 };
+            const double levelFactor{ 1.0 / std::log(static_cast<double>(_maxNeighborCount)) };
+            return std::min(maxLevel, static_cast<std::size_t>(-std::log(distribution(randomEngine)) * levelFactor));
+        }
+
+        Distance computeDistance(const VectorType& query, NodeIndex node) const
+        {
+            return computeNormalizedCosineDistance(query, _vectors[node]);
+        }
+
+        std::size_t getMaxNeighborCount(std::size_t level) const
+        {
+            return level == 0 ? 2 * _maxNeighborCount : _maxNeighborCount;
+        }
+
+        // Links are stored as [count, neighbors...], with a fixed capacity per node and per level
+        const NodeIndex* getLinkBlock(NodeIndex node, std::size_t level) const
+        {
+            if (level == 0)
+                return &_baseLinks[node * (getMaxNeighborCount(0) + 1)];
+
+            return &_upperLinks[node][(level - 1) * (_maxNeighborCount + 1)];
+        }
+
+        NodeIndex* getLinkBlock(NodeIndex node, std::size_t level)
+        {
+            return const_cast<NodeIndex*>(std::as_const(*this).getLinkBlock(node, level));
+        }
+
+        std::span<const NodeIndex> getLinks(NodeIndex node, std::size_t level) const
+        {
+            const NodeIndex* block{ getLinkBlock(node, level) };
+            return { block + 1, block[0] };
+        }
+
+        void setLinks(NodeIndex node, std::size_t level, std::span<const Neighbor> neighbors)
+        {
+            assert(neighbors.size() <= getMaxNeighborCount(level));
+
+            NodeIndex* block{ getLinkBlock(node, level) };
+            block[0] = static_cast<NodeIndex>(neighbors.size());
+            for (std::size_t i{}; i < neighbors.size(); ++i)
+                block[i + 1] = neighbors[i].index;
+        }
+
+        void setLinks(NodeIndex node, std::size_t level, std::span<const NodeIndex> neighbors)
+        {
+            assert(neighbors.size() <= getMaxNeighborCount(level));
+
+            NodeIndex* block{ getLinkBlock(node, level) };
+            block[0] = static_cast<NodeIndex>(neighbors.size());
+            std::copy(std::cbegin(neighbors), std::cend(neighbors), block + 1);
+        }
+
+        // Copies the links of previousNode, at this level, to its new node
+        // Removed neighbors are replaced by their own reused neighbors, so that the graph stays navigable around them
+        void copyLinks(const HnswIndex& previous, NodeIndex previousNode, std::span<const NodeIndex> newNodes, std::size_t level)
+        {
+            const NodeIndex node{ newNodes[previousNode] };
+            const std::span<const NodeIndex> previousLinks{ previous.getLinks(previousNode, level) };
+
+            std::vector<NodeIndex> links;
+            links.reserve(previousLinks.size());
+            bool hasRemovedNeighbor{};
+            for (const NodeIndex previousNeighbor : previousLinks)
+            {
+                if (newNodes[previousNeighbor] != invalidNode)
+                    links.push_back(newNodes[previousNeighbor]);
+                else
+                    hasRemovedNeighbor = true;
+            }
+
+            if (!hasRemovedNeighbor)
+            {
+                setLinks(node, level, links);
+                return;
+            }
+
+            for (const NodeIndex previousNeighbor : previousLinks)
+            {
+                if (newNodes[previousNeighbor] != invalidNode)
+                    continue;
+
+                for (const NodeIndex previousSecondNeighbor : previous.getLinks(previousNeighbor, level))
+                {
+                    const NodeIndex secondNeighbor{ newNodes[previousSecondNeighbor] };
+                    if (secondNeighbor != invalidNode && secondNeighbor != node)
+                        links.push_back(secondNeighbor);
+                }
+            }
+
+            std::sort(std::begin(links), std::end(links));
+            links.erase(std::unique(std::begin(links), std::end(links)), std::end(links));
+
+            std::vector<Neighbor> candidates;
+            candidates.reserve(links.size());
+            for (const NodeIndex neighbor : links)
+                candidates.push_back({ neighbor, computeDistance(_vectors[node], neighbor) });
+
+            setLinks(node, level, selectNeighbors(std::move(candidates), getMaxNeighborCount(level)));
+        }
+
+        // Greedy walk, used on the upper levels
+        NodeIndex searchClosest(const VectorType& query, NodeIndex entryPoint, std::size_t level) const
+        {
+            NodeIndex closest{ entryPoint };
+            Distance closestDistance{ computeDistance(query, closest) };
+
+            bool changed{ true };
+            while (changed)
+            {
+                changed = false;
+                for (const NodeIndex neighbor : getLinks(closest, level))
+                {
+                    const Distance distance{ computeDistance(query, neighbor) };
+                    if (distance < closestDistance)
+                    {
+                        closest = neighbor;
+                        closestDistance = distance;
+                        changed = true;
+                    }
+                }
+            }
+
+            return closest;
+        }
+
+        // Returns up to candidateCount nodes close to the query, in no particular order
+        std::vector<Neighbor> searchLevel(const VectorType& query, NodeIndex entryPoint, std::size_t candidateCount, std::size_t level) const
+        {
+            VisitedNodes& visitedNodes{ getVisitedNodes() };
+            visitedNodes.reset(size());
+
+            std::vector<Neighbor> candidates; // heap, closest on top
+            std::vector<Neighbor> results; // heap, farthest on top
+            candidates.reserve(candidateCount);
+            results.reserve(candidateCount + 1);
+
+            const Neighbor entry{ entryPoint, computeDistance(query, entryPoint) };
+            visitedNodes.insert(entryPoint);
+            candidates.push_back(entry);
+            results.push_back(entry);
+
+            std::vector<NodeIndex> newNeighbors(getMaxNeighborCount(level));
+            std::vector<Distance> newNeighborDistances(getMaxNeighborCount(level));
+
+            while (!candidates.empty())
+            {
+                const Neighbor candidate{ candidates.front() };
+                if (candidate.distance > results.front().distance && results.size() >= candidateCount)
+                    break;
+
+                std::pop_heap(std::begin(candidates), std::end(candidates), isFarther);
+                candidates.pop_back();
+
+                // distances to the unvisited neighbors are computed in a single batch
+                std::size_t newNeighborCount{};
+                for (const NodeIndex neighbor : getLinks(candidate.index, level))
+                {
+                    if (visitedNodes.insert(neighbor))
+                        newNeighbors[newNeighborCount++] = neighbor;
+                }
+                computeNormalizedCosineDistances(query, _vectors, std::span{ newNeighbors }.first(newNeighborCount), std::span{ newNeighborDistances }.first(newNeighborCount));
+
+                for (std::size_t i{}; i < newNeighborCount; ++i)
+                {
+                    const NodeIndex neighbor{ newNeighbors[i] };
+                    const Distance distance{ newNeighborDistances[i] };
+                    if (results.size() < candidateCount || distance < results.front().distance)
+                    {
+                        candidates.push_back({ neighbor, distance });
+                        std::push_heap(std::begin(candidates), std::end(candidates), isFarther);
+
+                        results.push_back({ neighbor, distance });
+                        std::push_heap(std::begin(results), std::end(results), isCloser);
+                        if (results.size() > candidateCount)
+                        {
+                            std::pop_heap(std::begin(results), std::end(results), isCloser);
+                            results.pop_back();
+                        }
+                    }
+                }
+            }
+
+            return results;
+        }
+
+        // Keeps the closest candidates that are closer to the base node than to any already selected neighbor,
+        // so that links go in various directions
+        std::vector<Neighbor> selectNeighbors(std::vector<Neighbor> candidates, std::size_t maxCount) const
+        {
+            if (candidates.size() <= maxCount)
+                return candidates;
+
+            std::sort(std::begin(candidates), std::end(candidates), isCloser);
+
+            std::vector<Neighbor> selectedNeighbors;
+            selectedNeighbors.reserve(maxCount);
+            for (const Neighbor& candidate : candidates)
+            {
+                if (selectedNeighbors.size() >= maxCount)
+                    break;
+
+                const bool isDiverse{ std::none_of(std::cbegin(selectedNeighbors), std::cend(selectedNeighbors), [&](const Neighbor& selectedNeighbor) {
+                    return computeDistance(_vectors[candidate.index], selectedNeighbor.index) < candidate.distance;
+                }) };
+
+                if (isDiverse)
+                    selectedNeighbors.push_back(candidate);
+            }
+
+            return selectedNeighbors;
+        }
+
+        void connect(NodeIndex node, NodeIndex newNeighbor, Distance distance, std::size_t level)
+        {
+            NodeIndex* block{ getLinkBlock(node, level) };
+            const std::size_t linkCount{ block[0] };
+            if (std::find(block + 1, block + 1 + linkCount, newNeighbor) != block + 1 + linkCount)
+                return; // reinserted node, already linked
+
+            if (linkCount < getMaxNeighborCount(level))
+            {
+                block[linkCount + 1] = newNeighbor;
+                block[0] = static_cast<NodeIndex>(linkCount + 1);
+                return;
+            }
+
+            std::vector<Neighbor> candidates;
+            candidates.reserve(linkCount + 1);
+            candidates.push_back({ newNeighbor, distance });
+            for (const NodeIndex neighbor : getLinks(node, level))
+                candidates.push_back({ neighbor, computeDistance(_vectors[node], neighbor) });
+
+            setLinks(node, level, selectNeighbors(std::move(candidates), getMaxNeighborCount(level)));
+        }
+
+        void insert(NodeIndex node, std::size_t candidateCount)
+        {
+            const VectorType& vector{ _vectors[node] };
+            const std::size_t nodeLevel{ _levels[node] };
+
+            // a reinserted node may still be reached through the links of other nodes
+            auto searchCandidates{ [&](NodeIndex levelEntryPoint, std::size_t level) {
+                std::vector<Neighbor> candidates{ searchLevel(vector, levelEntryPoint, candidateCount, level) };
+                std::erase_if(candidates, [&](const Neighbor& candidate) { return candidate.index == node; });
+                return candidates;
+            } };
+
+            NodeIndex entryPoint{ _entryPoint };
+            for (std::size_t level{ _topLevel }; level > nodeLevel; --level)
+                entryPoint = searchClosest(vector, entryPoint, level);
+
+            for (std::size_t level{ std::min(nodeLevel, _topLevel) + 1 }; level-- > 0;)
+            {
+                std::vector<Neighbor> candidates{ searchCandidates(entryPoint, level) };
+                if (candidates.empty()) // reinserted node, reached without any link to follow
+                    candidates = searchCandidates(_entryPoint, level);
+                assert(!candidates.empty());
+                entryPoint = std::min_element(std::cbegin(candidates), std::cend(candidates), isCloser)->index;
+
+                const std::vector<Neighbor> neighbors{ selectNeighbors(std::move(candidates), _maxNeighborCount) };
+                setLinks(node, level, neighbors);
+                for (const Neighbor& neighbor : neighbors)
+                    connect(neighbor.index, node, neighbor.distance, level);
+            }
+
+            if (nodeLevel > _topLevel)
+            {
+                _topLevel = nodeLevel;
+                _entryPoint = node;
+            }
+        }
+
+        bool doLoad(std::istream& is, typename Vectors::View vectors)
+        {
+            using namespace binaryIO;
+
+            std::uint32_t magic{};
+            std::uint32_t version{};
+            std::uint32_t vectorSize{};
+            std::uint32_t floatSize{};
+            std::uint64_t nodeCount{};
+            std::uint32_t maxNeighborCount{};
+            std::uint32_t topLevel{};
+            if (!readValue(is, magic) || !readValue(is, version) || !readValue(is, vectorSize) || !readValue(is, floatSize)
+                || !readValue(is, nodeCount) || !readValue(is, maxNeighborCount) || !readValue(is, _entryPoint) || !readValue(is, topLevel))
+                return false;
+
+            if (magic != fileMagic || version != fileVersion || vectorSize != Size || floatSize != sizeof(FloatType))
+                return false;
+            if (nodeCount != vectors.size() || maxNeighborCount < 2 || maxNeighborCount > 1024 || topLevel > maxLevel)
+                return false;
+            if (nodeCount > 0 && _entryPoint >= nodeCount)
+                return false;
+
+            _vectors = vectors;
+            _maxNeighborCount = maxNeighborCount;
+            _topLevel = topLevel;
+
+            _levels.resize(nodeCount);
+            _baseLinks.resize(nodeCount * (getMaxNeighborCount(0) + 1));
+            _upperLinks.resize(nodeCount);
+            if (!readValues(is, std::span{ _levels }) || !readValues(is, std::span{ _baseLinks }))
+                return false;
+            if (nodeCount > 0 && _levels[_entryPoint] != _topLevel)
+                return false;
+
+            for (std::size_t node{}; node < nodeCount; ++node)
+            {
+                if (_levels[node] > _topLevel)
+                    return false;
+
+                _upperLinks[node].resize(_levels[node] * (_maxNeighborCount + 1));
+                if (!readValues(is, std::span{ _upperLinks[node] }))
+                    return false;
+            }
+
+            // make sure the searches cannot go out of bounds
+            for (std::size_t node{}; node < nodeCount; ++node)
+            {
+                for (std::size_t level{}; level <= _levels[node]; ++level)
+                {
+                    const NodeIndex* block{ getLinkBlock(static_cast<NodeIndex>(node), level) };
+                    if (block[0] > getMaxNeighborCount(level))
+                        return false;
+
+                    const std::span<const NodeIndex> links{ block + 1, block[0] };
+                    if (std::any_of(std::cbegin(links), std::cend(links), [&](NodeIndex neighbor) { return neighbor >= nodeCount || _levels[neighbor] < level; }))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        typename Vectors::View _vectors;
+        std::size_t _maxNeighborCount{};
+        std::vector<std::uint8_t> _levels; // top level of each node
+        std::vector<NodeIndex> _baseLinks; // level 0 links of all the nodes
+        std::vector<std::vector<NodeIndex>> _upperLinks; // level 1 and above, per node
+        NodeIndex _entryPoint{};
+        std::size_t _topLevel{};
+    };
+} // namespace lms::math
@@ -29,6 +29,7 @@ namespace lms::math
     {
     public:
         constexpr void add(FloatType x);
+        constexpr void merge(const StatsAccumulator& other); // as if all the values of other had been added
         constexpr std::size_t getCount() const;
         constexpr FloatType getMean() const;
 
@@ -58,6 +59,23 @@ namespace lms::math
         M2 += term1;
     }
 
+    template<typename FloatType>
+    inline constexpr void StatsAccumulator<FloatType>::merge(const StatsAccumulator& other)
+    {
+        if (other.n == 0)
+            return;
+
+        const double n1{ static_cast<double>(n) };
+        const double n2{ static_cast<double>(other.n) };
+        const double nn{ n1 + n2 };
+
+        const double delta{ other.mean - mean };
+
+        mean += delta * n2 / nn;
+        M2 += other.M2 + delta * delta * n1 * n2 / nn;
+        n += other.n;
+    }
+
     template<typename FloatType>
     inline constexpr std::size_t StatsAccumulator<FloatType>::getCount() const
     {
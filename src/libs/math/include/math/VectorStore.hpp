@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "math/BinaryIO.hpp"
+#include "math/Vector.hpp"
+
+namespace lms::math
+{
+    namespace detail
+    {
+        // Cache line size, and also the size of an AVX-512 register
+        inline constexpr std::size_t vectorStoreAlignment{ 64 };
+
+        template<std::size_t Size, typename FloatType>
+        constexpr std::size_t computeVectorStoreRowStride()
+        {
+            constexpr std::size_t valuesPerAlignment{ vectorStoreAlignment / sizeof(FloatType) };
+            return (Size + valuesPerAlignment - 1) / valuesPerAlignment * valuesPerAlignment;
+        }
+
+        // Vector followed by zeros, up to the next multiple of the alignment
+        template<std::size_t Size, typename FloatType, std::size_t PaddingSize>
+        struct alignas(vectorStoreAlignment) PaddedVector
+        {
+            Vector<Size, FloatType> vector;
+            std::array<FloatType, PaddingSize> padding{};
+        };
+
+        template<std::size_t Size, typename FloatType>
+        struct alignas(vectorStoreAlignment) PaddedVector<Size, FloatType, 0>
+        {
+            Vector<Size, FloatType> vector;
+        };
+    } // namespace detail
+
+    // Non owning view on contiguous rows of a VectorStore
+    template<std::size_t Size, typename FloatType = float>
+    class VectorStoreView
+    {
+    public:
+        using VectorType = Vector<Size, FloatType>;
+        static constexpr std::size_t rowStride{ detail::computeVectorStoreRowStride<Size, FloatType>() }; // in values
+        using Row = detail::PaddedVector<Size, FloatType, rowStride - Size>;
+        static_assert(sizeof(Row) == rowStride * sizeof(FloatType));
+
+        constexpr VectorStoreView() = default;
+        constexpr VectorStoreView(std::span<const Row> rows)
+            : _rows{ rows }
+        {
+        }
+
+        std::size_t size() const { return _rows.size(); }
+        bool empty() const { return _rows.empty(); }
+
+        const VectorType& operator[](std::size_t index) const
+        {
+            assert(index < _rows.size());
+            return _rows[index].vector;
+        }
+
+        VectorStoreView subView(std::size_t first, std::size_t count) const { return VectorStoreView{ _rows.subspan(first, count) }; }
+
+        // size() rows of rowStride values, the values past Size are zeros
+        const FloatType* data() const { return _rows.empty() ? nullptr : _rows.front().vector.data(); }
+
+    private:
+        std::span<const Row> _rows;
+    };
+
+    // Vectors stored as the rows of a single contiguous matrix
+    // Each row is 64-byte aligned and zero padded so that the batched distance kernels can process whole SIMD registers
+    template<std::size_t Size, typename FloatType = float>
+    class VectorStore
+    {
+    public:
+        using View = VectorStoreView<Size, FloatType>;
+        using VectorType = typename View::VectorType;
+        static constexpr std::size_t rowStride{ View::rowStride };
+
+        VectorStore() = default;
+        explicit VectorStore(std::span<const VectorType> vectors)
+        {
+            reserve(vectors.size());
+            for (const VectorType& vector : vectors)
+                add(vector);
+        }
+
+        // returns the index of the added row
+        std::size_t add(const VectorType& vector)
+        {
+            _rows.push_back(Row{ .vector = vector });
+            return _rows.size() - 1;
+        }
+
+        void reserve(std::size_t count) { _rows.reserve(count); }
+        void clear() { _rows.clear(); }
+        void shrinkToFit() { _rows.shrink_to_fit(); }
+
+        std::size_t size() const { return _rows.size(); }
+        bool empty() const { return _rows.empty(); }
+
+        const VectorType& operator[](std::size_t index) const
+        {
+            assert(index < _rows.size());
+            return _rows[index].vector;
+        }
+
+        View getView() const { return View{ _rows }; }
+        View getView(std::size_t first, std::size_t count) const { return getView().subView(first, count); }
+
+        // Rows are written as they are laid out in memory, native endianness
+        void save(std::ostream& os) const
+        {
+            binaryIO::writeValue(os, static_cast<std::uint32_t>(Size));
+            binaryIO::writeValue(os, static_cast<std::uint32_t>(sizeof(FloatType)));
+            binaryIO::writeValue(os, static_cast<std::uint64_t>(_rows.size()));
+            binaryIO::writeValues(os, std::span{ _rows });
+        }
+
+        // Returns false if the saved store is invalid, the store is left empty in that case
+        bool load(std::istream& is)
+        {
+            _rows.clear();
+
+            std::uint32_t vectorSize{};
+            std::uint32_t floatSize{};
+            std::uint64_t rowCount{};
+            if (!binaryIO::readValue(is, vectorSize) || !binaryIO::readValue(is, floatSize) || !binaryIO::readValue(is, rowCount))
+                return false;
+            if (vectorSize != Size || floatSize != sizeof(FloatType) || rowCount > maxLoadedRowCount)
+                return false;
+
+            _rows.resize(rowCount);
+            if (!binaryIO::readValues(is, std::span{ _rows }))
+            {
+                _rows.clear();
+                return false;
+            }
+
+            // the kernels rely on the padding being zero
+            for (Row& row : _rows)
+                row = Row{ .vector = row.vector };
+
+            return true;
+        }
+
+    private:
+        using Row = typename View::Row;
+        static constexpr std::uint64_t maxLoadedRowCount{ std::uint64_t{ 1 } << 32 }; // sanity check, before allocating
+
+        std::vector<Row> _rows; // over-aligned allocations are honored since C++17
+    };
+} // namespace lms::math
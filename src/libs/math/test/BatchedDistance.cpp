@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "math/BatchedDistance.hpp"
+#include "math/ChamferDistance.hpp"
+#include "math/DotProduct.hpp"
+#include "math/NormalizedCosineDistance.hpp"
+
+namespace lms::math::batchedDistanceTests
+{
+    namespace
+    {
+        constexpr float epsilon{ 1e-5F };
+
+        template<std::size_t Size>
+        std::vector<Vector<Size, float>> generateNormalizedVectors(std::size_t count, std::uint32_t seed)
+        {
+            std::mt19937 randomEngine{ seed };
+            std::normal_distribution<float> distribution{ 0.F, 1.F };
+
+            std::vector<Vector<Size, float>> vectors(count);
+            for (auto& vector : vectors)
+            {
+                for (float& value : vector)
+                    value = distribution(randomEngine);
+                vector.normalizeL2();
+            }
+
+            return vectors;
+        }
+
+        const std::vector<SimdInstructionSet> allInstructionSets{
+            SimdInstructionSet::None,
+            SimdInstructionSet::Avx2,
+            SimdInstructionSet::Avx512,
+            SimdInstructionSet::Neon,
+        };
+
+        // all the kernels supported by this CPU must give the same results as the reference implementation
+        template<std::size_t Size>
+        void checkDotProducts()
+        {
+            const auto vectors{ generateNormalizedVectors<Size>(37, 0) };
+            const VectorStore<Size, float> store{ vectors };
+            const Vector<Size, float> query{ generateNormalizedVectors<Size>(1, 1).front() };
+
+            for (const SimdInstructionSet instructionSet : allInstructionSets)
+            {
+                if (!isSimdInstructionSetSupported(instructionSet))
+                    continue;
+
+                std::vector<float> results(vectors.size());
+                computeDotProducts(query, store.getView(), results, instructionSet);
+                for (std::size_t i{}; i < vectors.size(); ++i)
+                    EXPECT_NEAR(results[i], computeDotProduct(query, vectors[i]), epsilon) << "instruction set = " << static_cast<int>(instructionSet) << ", i = " << i;
+            }
+        }
+    } // namespace
+
+    TEST(BatchedDistance, dotProducts)
+    {
+        checkDotProducts<1>();
+        checkDotProducts<16>();
+        checkDotProducts<33>();
+        checkDotProducts<60>();
+        checkDotProducts<200>();
+    }
+
+    TEST(BatchedDistance, dotProductsDouble)
+    {
+        const std::vector<Vector<3, double>> vectors{ { 1., 2., 3. }, { -1., 0., 0.5 } };
+        const VectorStore<3, double> store{ vectors };
+        const Vector<3, double> query{ 2., 1., 0. };
+
+        std::vector<double> results(vectors.size());
+        computeDotProducts(query, store.getView(), results);
+        EXPECT_DOUBLE_EQ(results[0], 4.);
+        EXPECT_DOUBLE_EQ(results[1], -2.);
+    }
+
+    TEST(BatchedDistance, empty)
+    {
+        const VectorStore<60, float> store;
+        const Vector<60, float> query{ 1.F };
+
+        std::vector<float> results;
+        computeNormalizedCosineDistances(query, store.getView(), results);
+        EXPECT_TRUE(results.empty());
+    }
+
+    TEST(BatchedDistance, normalizedCosineDistances)
+    {
+        const auto vectors{ generateNormalizedVectors<60>(100, 2) };
+        const VectorStore<60, float> store{ vectors };
+        const Vector<60, float> query{ generateNormalizedVectors<60>(1, 3).front() };
+
+        std::vector<float> results(vectors.size());
+        computeNormalizedCosineDistances(query, store.getView(), results);
+        for (std::size_t i{}; i < vectors.size(); ++i)
+            EXPECT_NEAR(results[i], computeNormalizedCosineDistance(query, vectors[i]), epsilon);
+
+        // on a sub view
+        computeNormalizedCosineDistances(query, store.getView(10, 5), results);
+        for (std::size_t i{}; i < 5; ++i)
+            EXPECT_NEAR(results[i], computeNormalizedCosineDistance(query, vectors[10 + i]), epsilon);
+    }
+
+    TEST(BatchedDistance, normalizedCosineDistancesGather)
+    {
+        const auto vectors{ generateNormalizedVectors<60>(100, 4) };
+        const VectorStore<60, float> store{ vectors };
+        const Vector<60, float> query{ generateNormalizedVectors<60>(1, 5).front() };
+
+        const std::vector<std::uint32_t> rowIndices{ 99, 0, 42, 42, 7 };
+        std::vector<float> results(rowIndices.size());
+        computeNormalizedCosineDistances(query, store.getView(), rowIndices, results);
+        for (std::size_t i{}; i < rowIndices.size(); ++i)
+            EXPECT_NEAR(results[i], computeNormalizedCosineDistance(query, vectors[rowIndices[i]]), epsilon);
+    }
+
+    TEST(BatchedDistance, symmetricalChamferDistance)
+    {
+        using Distance = NormalizedCosineDistance<60, float>;
+
+        const auto vectorsA{ generateNormalizedVectors<60>(7, 6) };
+        const auto vectorsB{ generateNormalizedVectors<60>(13, 7) };
+        const VectorStore<60, float> storeA{ vectorsA };
+        const VectorStore<60, float> storeB{ vectorsB };
+
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(storeA.getView(), storeB.getView()), symmetricalChamferDistance<Distance>(vectorsA, vectorsB), epsilon);
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(storeB.getView(), storeA.getView()), symmetricalChamferDistance<Distance>(vectorsB, vectorsA), epsilon);
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(storeA.getView(), storeA.getView()), 0.F, epsilon);
+    }
+
+    TEST(BatchedDistance, symmetricalChamferDistanceGathered)
+    {
+        using Distance = NormalizedCosineDistance<60, float>;
+
+        const auto vectors{ generateNormalizedVectors<60>(20, 8) };
+        const VectorStore<60, float> store{ vectors };
+
+        const std::vector<std::uint32_t> rowIndicesA{ 3, 17, 0, 9 };
+        const std::vector<std::uint32_t> rowIndicesB{ 12, 5, 19, 1, 8, 4 };
+        std::vector<Vector<60, float>> vectorsA;
+        for (const std::uint32_t rowIndex : rowIndicesA)
+            vectorsA.push_back(vectors[rowIndex]);
+        std::vector<Vector<60, float>> vectorsB;
+        for (const std::uint32_t rowIndex : rowIndicesB)
+            vectorsB.push_back(vectors[rowIndex]);
+
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(store.getView(), rowIndicesA, rowIndicesB), symmetricalChamferDistance<Distance>(vectorsA, vectorsB), epsilon);
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(store.getView(), rowIndicesB, rowIndicesA), symmetricalChamferDistance<Distance>(vectorsB, vectorsA), epsilon);
+        EXPECT_NEAR(computeSymmetricalNormalizedCosineChamferDistance(store.getView(), rowIndicesA, rowIndicesA), 0.F, epsilon);
+    }
+} // namespace lms::math::batchedDistanceTests
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "math/BinaryIO.hpp"
+
+namespace lms::math::binaryIOTests
+{
+    TEST(BinaryIO, writeFileAtomically)
+    {
+        const std::filesystem::path directory{ std::filesystem::temp_directory_path() / "lms-test-binary-io" };
+        const std::filesystem::path filePath{ directory / "values.bin" };
+        std::filesystem::remove_all(directory);
+
+        const std::uint64_t value{ 0x0123456789ABCDEF };
+        EXPECT_FALSE(binaryIO::writeFileAtomically(filePath, [&](std::ostream& os) { binaryIO::writeValue(os, value); }));
+        EXPECT_FALSE(std::filesystem::exists(filePath.string() + ".tmp"));
+
+        {
+            std::ifstream is{ filePath, std::ios::binary };
+            std::uint64_t readValue{};
+            ASSERT_TRUE(binaryIO::readValue(is, readValue));
+            EXPECT_EQ(readValue, value);
+        }
+
+        // failed write: the previous file is kept
+        EXPECT_TRUE(binaryIO::writeFileAtomically(filePath, [&](std::ostream& os) { os.setstate(std::ios::badbit); }));
+        EXPECT_EQ(std::filesystem::file_size(filePath), sizeof(value));
+        EXPECT_FALSE(std::filesystem::exists(filePath.string() + ".tmp"));
+
+        std::filesystem::remove_all(directory);
+    }
+} // namespace lms::math::binaryIOTests
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "math/HnswIndex.hpp"
+
+namespace lms::math::hnswIndexTests
+{
+    namespace
+    {
+        constexpr std::size_t dimCount{ 16 };
+        using TestVector = Vector<dimCount, float>;
+        using TestIndex = HnswIndex<dimCount, float>;
+        using TestVectors = VectorStore<dimCount, float>;
+
+        // Normalized vectors spread around a few centers, closer to real embeddings than uniform noise
+        std::vector<TestVector> generateVectors(std::size_t count, std::uint32_t seed)
+        {
+            std::mt19937 randomEngine{ seed };
+            std::normal_distribution<float> distribution{ 0.F, 1.F };
+
+            constexpr std::size_t centerCount{ 20 };
+            std::vector<TestVector> centers(centerCount);
+            for (TestVector& center : centers)
+            {
+                for (float& value : center)
+                    value = distribution(randomEngine);
+            }
+
+            std::vector<TestVector> vectors(count);
+            for (std::size_t i{}; i < count; ++i)
+            {
+                vectors[i] = centers[i % centerCount];
+                for (float& value : vectors[i])
+                    value += 0.5F * distribution(randomEngine);
+                vectors[i].normalizeL2();
+            }
+
+            return vectors;
+        }
+
+        std::vector<TestIndex::NodeIndex> findNearestBruteForce(const TestVectors& vectors, const TestVector& query, std::size_t maxCount)
+        {
+            std::vector<TestIndex::Neighbor> neighbors;
+            for (std::size_t i{}; i < vectors.size(); ++i)
+                neighbors.push_back({ static_cast<TestIndex::NodeIndex>(i), computeNormalizedCosineDistance(query, vectors[i]) });
+
+            std::sort(std::begin(neighbors), std::end(neighbors), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+
+            std::vector<TestIndex::NodeIndex> res;
+            for (std::size_t i{}; i < std::min(maxCount, neighbors.size()); ++i)
+                res.push_back(neighbors[i].index);
+            return res;
+        }
+
+        double computeRecall(const TestIndex& index, const TestVectors& vectors, std::span<const TestVector> queries, std::size_t maxCount, std::size_t candidateCount)
+        {
+            std::size_t foundCount{};
+            for (const TestVector& query : queries)
+            {
+                const std::vector<TestIndex::NodeIndex> expected{ findNearestBruteForce(vectors, query, maxCount) };
+                for (const TestIndex::Neighbor& neighbor : index.search(query, maxCount, candidateCount))
+                {
+                    if (std::find(std::cbegin(expected), std::cend(expected), neighbor.index) != std::cend(expected))
+                        foundCount++;
+                }
+            }
+
+            return static_cast<double>(foundCount) / static_cast<double>(queries.size() * maxCount);
+        }
+    } // namespace
+
+    TEST(HnswIndex, empty)
+    {
+        const TestVectors vectors;
+
+        TestIndex index;
+        index.build(vectors, {});
+
+        EXPECT_TRUE(index.empty());
+        EXPECT_TRUE(index.search(TestVector{ 1.F }, 10, 10).empty());
+    }
+
+    TEST(HnswIndex, singleVector)
+    {
+        const TestVectors vectors{ generateVectors(1, 0) };
+
+        TestIndex index;
+        index.build(vectors, {});
+
+        const auto neighbors{ index.search(vectors[0], 10, 10) };
+        ASSERT_EQ(neighbors.size(), 1);
+        EXPECT_EQ(neighbors[0].index, 0);
+        EXPECT_NEAR(neighbors[0].distance, 0.F, 1e-5F);
+    }
+
+    TEST(HnswIndex, exactMatch)
+    {
+        const TestVectors vectors{ generateVectors(2'000, 1) };
+
+        TestIndex index;
+        index.build(vectors, {});
+        ASSERT_EQ(index.size(), vectors.size());
+
+        for (std::size_t i{}; i < vectors.size(); i += 97)
+        {
+            const auto neighbors{ index.search(vectors[i], 5, 32) };
+            ASSERT_EQ(neighbors.size(), 5);
+            EXPECT_EQ(neighbors[0].index, i);
+            EXPECT_TRUE(std::is_sorted(std::cbegin(neighbors), std::cend(neighbors), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; }));
+        }
+    }
+
+    TEST(HnswIndex, recall)
+    {
+        const TestVectors vectors{ generateVectors(5'000, 2) };
+        const std::vector<TestVector> queries{ generateVectors(100, 3) };
+
+        TestIndex index;
+        index.build(vectors, { .maxNeighborCount = 16, .candidateCount = 100 });
+
+        const double lowRecall{ computeRecall(index, vectors, queries, 10, 10) };
+        const double highRecall{ computeRecall(index, vectors, queries, 10, 100) };
+
+        EXPECT_GT(highRecall, 0.95);
+        EXPECT_GE(highRecall, lowRecall);
+    }
+
+    TEST(HnswIndex, update)
+    {
+        const std::vector<TestVector> previousVectors{ generateVectors(5'000, 6) };
+        const std::vector<TestVector> addedVectors{ generateVectors(500, 7) };
+        const std::vector<TestVector> queries{ generateVectors(100, 8) };
+        const TestIndex::BuildParameters params{ .maxNeighborCount = 16, .candidateCount = 100 };
+
+        const TestVectors previousStore{ previousVectors };
+        TestIndex previousIndex;
+        previousIndex.build(previousStore, params);
+
+        // every 10th vector is removed, the others are kept in the same order, then the added ones
+        std::vector<TestVector> vectors;
+        std::vector<std::optional<TestIndex::NodeIndex>> previousNodes;
+        for (std::size_t i{}; i < previousVectors.size(); ++i)
+        {
+            if (i % 10 == 0)
+                continue;
+
+            vectors.push_back(previousVectors[i]);
+            previousNodes.push_back(static_cast<TestIndex::NodeIndex>(i));
+        }
+        for (const TestVector& vector : addedVectors)
+        {
+            vectors.push_back(vector);
+            previousNodes.push_back(std::nullopt);
+        }
+        const TestVectors store{ vectors };
+
+        TestIndex index;
+        index.update(previousIndex, store, previousNodes, params);
+        ASSERT_EQ(index.size(), store.size());
+
+        TestIndex builtIndex;
+        builtIndex.build(store, params);
+
+        const double recall{ computeRecall(index, store, queries, 10, 100) };
+        EXPECT_GT(recall, 0.95);
+        EXPECT_GT(recall, computeRecall(builtIndex, store, queries, 10, 100) - 0.02);
+
+        // both the reused and the added vectors can be reached
+        for (std::size_t i{}; i < store.size(); i += 13)
+        {
+            const auto neighbors{ index.search(store[i], 1, 32) };
+            ASSERT_EQ(neighbors.size(), 1);
+            EXPECT_EQ(neighbors[0].index, i);
+        }
+
+        // the links are consistent
+        std::stringstream ss;
+        index.save(ss);
+        TestIndex loadedIndex;
+        EXPECT_TRUE(loadedIndex.load(ss, store));
+    }
+
+    TEST(HnswIndex, updateNothingReused)
+    {
+        const TestVectors previousVectors{ generateVectors(500, 9) };
+        const TestVectors vectors{ generateVectors(1'000, 10) };
+        const std::vector<std::optional<TestIndex::NodeIndex>> previousNodes(vectors.size());
+
+        TestIndex previousIndex;
+        previousIndex.build(previousVectors, {});
+
+        // same as a full build
+        TestIndex index;
+        index.update(previousIndex, vectors, previousNodes, {});
+        TestIndex builtIndex;
+        builtIndex.build(vectors, {});
+
+        ASSERT_EQ(index.size(), vectors.size());
+        for (std::size_t i{}; i < vectors.size(); i += 31)
+        {
+            const auto expected{ builtIndex.search(vectors[i], 10, 20) };
+            const auto neighbors{ index.search(vectors[i], 10, 20) };
+            ASSERT_EQ(neighbors.size(), expected.size());
+            for (std::size_t j{}; j < neighbors.size(); ++j)
+                EXPECT_EQ(neighbors[j].index, expected[j].index);
+        }
+    }
+
+    TEST(HnswIndex, updateAllRemovedButOne)
+    {
+        const TestVectors previousVectors{ generateVectors(1'000, 11) };
+
+        TestIndex previousIndex;
+        previousIndex.build(previousVectors, {});
+
+        std::vector<TestVector> vectors{ previousVectors[500] };
+        std::vector<std::optional<TestIndex::NodeIndex>> previousNodes{ TestIndex::NodeIndex{ 500 } };
+        for (const TestVector& vector : generateVectors(200, 12))
+        {
+            vectors.push_back(vector);
+            previousNodes.push_back(std::nullopt);
+        }
+        const TestVectors store{ vectors };
+
+        TestIndex index;
+        index.update(previousIndex, store, previousNodes, {});
+        ASSERT_EQ(index.size(), store.size());
+
+        for (std::size_t i{}; i < store.size(); ++i)
+        {
+            const auto neighbors{ index.search(store[i], 1, 32) };
+            ASSERT_EQ(neighbors.size(), 1);
+            EXPECT_EQ(neighbors[0].index, i);
+        }
+    }
+
+    TEST(HnswIndex, saveLoad)
+    {
+        const TestVectors vectors{ generateVectors(1'000, 4) };
+
+        TestIndex index;
+        index.build(vectors, { .maxNeighborCount = 8, .candidateCount = 50 });
+
+        std::stringstream ss;
+        index.save(ss);
+
+        TestIndex loadedIndex;
+        ASSERT_TRUE(loadedIndex.load(ss, vectors));
+        ASSERT_EQ(loadedIndex.size(), vectors.size());
+
+        for (std::size_t i{}; i < vectors.size(); i += 31)
+        {
+            const auto expected{ index.search(vectors[i], 10, 20) };
+            const auto neighbors{ loadedIndex.search(vectors[i], 10, 20) };
+            ASSERT_EQ(neighbors.size(), expected.size());
+            for (std::size_t j{}; j < neighbors.size(); ++j)
+                EXPECT_EQ(neighbors[j].index, expected[j].index);
+        }
+    }
+
+    TEST(HnswIndex, loadMismatch)
+    {
+        const TestVectors vectors{ generateVectors(100, 5) };
+
+        TestIndex index;
+        index.build(vectors, {});
+
+        std::stringstream ss;
+        index.save(ss);
+        const std::string data{ ss.str() };
+
+        {
+            // not the same vectors
+            const TestVectors otherVectors{ generateVectors(50, 5) };
+            std::istringstream is{ data };
+            TestIndex loadedIndex;
+            EXPECT_FALSE(loadedIndex.load(is, otherVectors));
+            EXPECT_TRUE(loadedIndex.empty());
+        }
+
+        {
+            // truncated
+            std::istringstream is{ data.substr(0, data.size() / 2) };
+            TestIndex loadedIndex;
+            EXPECT_FALSE(loadedIndex.load(is, vectors));
+        }
+
+        {
+            // the entry point is not on the top level
+            std::string corruptedData{ data };
+            constexpr std::size_t topLevelOffset{ 4 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t) + sizeof(TestIndex::NodeIndex) };
+            std::uint32_t topLevel{};
+            std::memcpy(&topLevel, corruptedData.data() + topLevelOffset, sizeof(topLevel));
+            topLevel += 1;
+            std::memcpy(corruptedData.data() + topLevelOffset, &topLevel, sizeof(topLevel));
+
+            std::istringstream is{ corruptedData };
+            TestIndex loadedIndex;
+            EXPECT_FALSE(loadedIndex.load(is, vectors));
+        }
+
+        {
+            std::istringstream is{ "garbage" };
+            TestIndex loadedIndex;
+            EXPECT_FALSE(loadedIndex.load(is, vectors));
+        }
+    }
+} // namespace lms::math::hnswIndexTests
@@ -169,4 +169,29 @@ namespace lms::math::statsAccumulatorTests
         EXPECT_GE(stats.getSampleVariance(), 0.F);
         EXPECT_GE(stats.getSampleStdDev(), 0.F);
     }
+    TEST(StatsAccumulator, merge)
+    {
+        constexpr float values[]{ 2.F, 4.F, 6.F, 7.F, -3.F };
+        StatsAccumulator all;
+        StatsAccumulator first;
+        StatsAccumulator second;
+        StatsAccumulator empty;
+        for (std::size_t i{}; i < std::size(values); ++i)
+        {
+            all.add(values[i]);
+            (i < 2 ? first : second).add(values[i]);
+        }
+
+        first.merge(second);
+        first.merge(empty);
+
+        EXPECT_EQ(first.getCount(), all.getCount());
+        EXPECT_NEAR(first.getMean(), all.getMean(), epsilon);
+        EXPECT_NEAR(first.getSampleVariance(), all.getSampleVariance(), epsilon);
+
+        empty.merge(all);
+        EXPECT_EQ(empty.getCount(), all.getCount());
+        EXPECT_NEAR(empty.getMean(), all.getMean(), epsilon);
+        EXPECT_NEAR(empty.getSampleVariance(), all.getSampleVariance(), epsilon);
+    }
 } // namespace lms::math::statsAccumulatorTests
\ No newline at end of file
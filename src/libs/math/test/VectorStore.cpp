@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "math/VectorStore.hpp"
+
+namespace lms::math::vectorStoreTests
+{
+    TEST(VectorStore, rowLayout)
+    {
+        static_assert(VectorStore<60, float>::rowStride == 64);
+        static_assert(VectorStore<64, float>::rowStride == 64);
+        static_assert(VectorStore<3, float>::rowStride == 16);
+        static_assert(VectorStore<3, double>::rowStride == 8);
+
+        VectorStore<3, float> store;
+        for (std::size_t i{}; i < 10; ++i)
+            EXPECT_EQ(store.add(Vector<3, float>{ static_cast<float>(i), 1.F, 2.F }), i);
+
+        ASSERT_EQ(store.size(), 10);
+        const auto view{ store.getView() };
+        for (std::size_t i{}; i < store.size(); ++i)
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&store[i]) % 64, 0);
+            EXPECT_EQ(store[i][0], static_cast<float>(i));
+            EXPECT_EQ(view[i][0], static_cast<float>(i));
+
+            // padding is zero filled
+            const float* row{ view.data() + i * view.rowStride };
+            EXPECT_EQ(row, store[i].data());
+            for (std::size_t j{ 3 }; j < view.rowStride; ++j)
+                EXPECT_EQ(row[j], 0.F);
+        }
+    }
+
+    TEST(VectorStore, subView)
+    {
+        const std::vector<Vector<2, float>> vectors{ { 0.F, 0.F }, { 1.F, 1.F }, { 2.F, 2.F }, { 3.F, 3.F } };
+        const VectorStore<2, float> store{ vectors };
+
+        const auto view{ store.getView(1, 2) };
+        ASSERT_EQ(view.size(), 2);
+        EXPECT_EQ(view[0][0], 1.F);
+        EXPECT_EQ(view[1][0], 2.F);
+        EXPECT_EQ(&view[0], &store[1]);
+
+        EXPECT_TRUE(store.getView(4, 0).empty());
+    }
+
+    TEST(VectorStore, clear)
+    {
+        VectorStore<2, float> store;
+        EXPECT_TRUE(store.empty());
+        EXPECT_EQ(store.getView().data(), nullptr);
+
+        store.add(Vector<2, float>{ 1.F, 2.F });
+        EXPECT_FALSE(store.empty());
+
+        store.clear();
+        EXPECT_TRUE(store.empty());
+        EXPECT_TRUE(store.getView().empty());
+    }
+
+    TEST(VectorStore, saveLoad)
+    {
+        const std::vector<Vector<3, float>> vectors{ { 1.F, 2.F, 3.F }, { 4.F, 5.F, 6.F } };
+        const VectorStore<3, float> store{ vectors };
+
+        std::stringstream ss;
+        store.save(ss);
+
+        VectorStore<3, float> loadedStore;
+        ASSERT_TRUE(loadedStore.load(ss));
+        ASSERT_EQ(loadedStore.size(), store.size());
+        for (std::size_t i{}; i < store.size(); ++i)
+        {
+            for (std::size_t j{}; j < 3; ++j)
+                EXPECT_EQ(loadedStore[i][j], store[i][j]);
+        }
+    }
+
+    TEST(VectorStore, loadMismatch)
+    {
+        const std::vector<Vector<3, float>> vectors{ { 1.F, 2.F, 3.F }, { 4.F, 5.F, 6.F } };
+        const VectorStore<3, float> store{ vectors };
+
+        std::stringstream ss;
+        store.save(ss);
+        const std::string data{ ss.str() };
+
+        {
+            // other vector size
+            std::istringstream is{ data };
+            VectorStore<4, float> loadedStore;
+            EXPECT_FALSE(loadedStore.load(is));
+            EXPECT_TRUE(loadedStore.empty());
+        }
+
+        {
+            // truncated
+            std::istringstream is{ data.substr(0, data.size() - 1) };
+            VectorStore<3, float> loadedStore;
+            EXPECT_FALSE(loadedStore.load(is));
+            EXPECT_TRUE(loadedStore.empty());
+        }
+    }
+} // namespace lms::math::vectorStoreTests
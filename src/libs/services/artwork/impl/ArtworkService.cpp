@@ -20,9 +20,13 @@
 #include "ArtworkService.hpp"
 
 #include <algorithm>
+#include <ctime>
+#include <limits>
 
 #include "core/IConfig.hpp"
 #include "core/ILogger.hpp"
+#include "core/String.hpp"
+#include "core/XxHash3.hpp"
 
 #include "audio/Exception.hpp"
 #include "audio/IAudioFileInfo.hpp"
@@ -46,22 +50,50 @@
 
 namespace lms::artwork
 {
-    std::unique_ptr<IArtworkService> createArtworkService(db::IDb& db, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath)
+    namespace
     {
-        return std::make_unique<ArtworkService>(db, defaultReleaseCoverSvgPath, defaultArtistImageSvgPath);
+        std::vector<image::ImageSize> readThumbnailSizes()
+        {
+            std::vector<image::ImageSize> sizes;
+            core::Service<core::IConfig>::get()->visitStrings("cover-thumbnail-sizes",
+                                                              [&sizes](std::string_view str) {
+                                                                  if (const auto size{ core::stringUtils::readAs<image::ImageSize>(str) }; size && *size > 0)
+                                                                      sizes.push_back(*size);
+                                                                  else
+                                                                      LMS_LOG(COVER, ERROR, "Invalid thumbnail size '" << str << "'");
+                                                              },
+                                                              { "128", "512" });
+
+            std::sort(std::begin(sizes), std::end(sizes), std::greater<>{});
+            sizes.erase(std::unique(std::begin(sizes), std::end(sizes)), std::end(sizes));
+
+            return sizes;
+        }
+    } // namespace
+
+    std::unique_ptr<IArtworkService> createArtworkService(db::IDb& db, const std::filesystem::path& cachePath, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath)
+    {
+        return std::make_unique<ArtworkService>(db, cachePath, defaultReleaseCoverSvgPath, defaultArtistImageSvgPath);
     }
 
     ArtworkService::ArtworkService(db::IDb& db,
+                                   const std::filesystem::path& cachePath,
                                    const std::filesystem::path& defaultReleaseCoverSvgPath,
                                    const std::filesystem::path& defaultArtistImageSvgPath)
         : _db{ db }
         , _cache{ core::Service<core::IConfig>::get()->getULong("cover-max-cache-size", 30) * 1000 * 1000 }
+        , _diskCache{ cachePath / "cache", core::Service<core::IConfig>::get()->getULong("cover-max-disk-cache-size", 500) * 1000 * 1000 }
+        , _thumbnailSizes{ readThumbnailSizes() }
+        , _thumbnailStore{ cachePath / "thumbnails", _thumbnailSizes.empty() ? 0 : std::numeric_limits<std::size_t>::max() } // never evicted, entries are removed by the scanner
         , _audioFileInfoParser{ audio::createAudioFileInfoParser() }
     {
         setJpegQuality(core::Service<core::IConfig>::get()->getULong("cover-jpeg-quality", 75));
 
         LMS_LOG(COVER, INFO, "Default release cover path = " << defaultReleaseCoverSvgPath);
         LMS_LOG(COVER, INFO, "Max cache size = " << _cache.getMaxCacheSize());
+        LMS_LOG(COVER, INFO, "Max disk cache size = " << _diskCache.getMaxCacheSize());
+        for (const image::ImageSize size : _thumbnailSizes)
+            LMS_LOG(COVER, INFO, "Thumbnail size = " << size);
 
         _defaultReleaseCover = image::readImage(defaultReleaseCoverSvgPath); // may throw
         _defaultArtistImage = image::readImage(defaultArtistImageSvgPath);   // may throw
@@ -104,10 +136,86 @@ namespace lms::artwork
         return _defaultArtistImage;
     }
 
-    std::unique_ptr<image::IEncodedImage> ArtworkService::getTrackImage(const std::filesystem::path& p, std::size_t index, std::optional<image::ImageSize> width) const
+    std::unique_ptr<image::IEncodedImage> ArtworkService::getTrackImage(const TrackImageLocation& location, std::optional<image::ImageSize> width) const
     {
         std::unique_ptr<image::IEncodedImage> image;
 
+        visitTrackImage(location, [&](const audio::Image& parsedImage) {
+            try
+            {
+                if (!width)
+                {
+                    image = image::readImage(parsedImage.data, parsedImage.mimeType);
+                }
+                else
+                {
+                    auto rawImage{ image::decodeImage(parsedImage.data) };
+                    rawImage->resize(*width);
+                    image = image::encodeToJPEG(*rawImage, _jpegQuality);
+                }
+            }
+            catch (const image::Exception& e)
+            {
+                LMS_LOG(COVER, ERROR, "Cannot decode image from track " << location.trackPath << ": " << e.what());
+            }
+        });
+
+        return image;
+    }
+
+    std::optional<ArtworkService::TrackImageLocation> ArtworkService::findTrackImageLocation(db::TrackEmbeddedImageId trackEmbeddedImageId)
+    {
+        std::optional<TrackImageLocation> location;
+
+        db::Session& session{ _db.getTLSSession() };
+        auto transaction{ session.createReadTransaction() };
+
+        db::TrackEmbeddedImageLink::find(session, trackEmbeddedImageId, [&](const db::TrackEmbeddedImageLink::pointer& link) {
+            if (location)
+                return;
+
+            const db::TrackEmbeddedImage::pointer image{ link->getImage() };
+            location.emplace(TrackImageLocation{
+                .trackPath = link->getTrack()->getAbsoluteFilePath(),
+                .index = link->getIndex(),
+                .dataOffset = link->getDataOffset(),
+                .dataSize = image->getSize(),
+                .dataHash = image->getHash().value(),
+                .mimeType = std::string{ image->getMimeType() },
+            });
+        });
+
+        return location;
+    }
+
+    void ArtworkService::visitTrackImage(const TrackImageLocation& location, const std::function<void(const audio::Image&)>& visitor) const
+    {
+        // Fast path: directly read the data at the location recorded during the scan
+        if (location.dataOffset)
+        {
+            try
+            {
+                const std::vector<std::byte> data{ audio::readImageData(location.trackPath, *location.dataOffset, location.dataSize) };
+
+                // the file may have been modified since the last scan
+                if (core::XxHash3_64::hash(data) == location.dataHash)
+                {
+                    audio::Image image;
+                    image.mimeType = location.mimeType;
+                    image.data = data;
+                    image.dataOffset = location.dataOffset;
+                    visitor(image);
+                    return;
+                }
+
+                LMS_LOG(COVER, DEBUG, "Image data mismatch at offset " << *location.dataOffset << " in track " << location.trackPath << ", parsing file");
+            }
+            catch (const audio::Exception& e)
+            {
+                LMS_LOG(COVER, DEBUG, "Cannot read image data from track " << location.trackPath << ": " << e.what() << ", parsing file");
+            }
+        }
+
         try
         {
             std::size_t currentIndex{};
@@ -117,37 +225,17 @@ namespace lms::artwork
             options.readTags = false;
             options.readImages = true;
 
-            const auto audioFileInfo{ _audioFileInfoParser->parse(p, options) };
+            const auto audioFileInfo{ _audioFileInfoParser->parse(location.trackPath, options) };
             assert(audioFileInfo->getImageReader());
             audioFileInfo->getImageReader()->visitImages([&](const audio::Image& parsedImage) {
-                if (currentIndex++ != index)
-                    return;
-
-                try
-                {
-                    if (!width)
-                    {
-                        image = image::readImage(parsedImage.data, parsedImage.mimeType);
-                    }
-                    else
-                    {
-                        auto rawImage{ image::decodeImage(parsedImage.data) };
-                        rawImage->resize(*width);
-                        image = image::encodeToJPEG(*rawImage, _jpegQuality);
-                    }
-                }
-                catch (const image::Exception& e)
-                {
-                    LMS_LOG(COVER, ERROR, "Cannot decode image from track " << p << ": " << e.what());
-                }
+                if (currentIndex++ == location.index)
+                    visitor(parsedImage);
             });
         }
         catch (const audio::Exception& e)
         {
-            LMS_LOG(COVER, ERROR, "Cannot parse images from track " << p << ": " << e.what());
+            LMS_LOG(COVER, ERROR, "Cannot parse images from track " << location.trackPath << ": " << e.what());
         }
-
-        return image;
     }
 
     db::ArtworkId ArtworkService::findTrackListImage(db::TrackListId trackListId)
@@ -189,31 +277,108 @@ namespace lms::artwork
     }
 
     std::shared_ptr<image::IEncodedImage> ArtworkService::getImage(db::ArtworkId artworkId, std::optional<image::ImageSize> width)
+    {
+        if (std::shared_ptr<image::IEncodedImage> image{ _cache.getImage(ImageCache::EntryDesc{ artworkId, width }) })
+            return image;
+
+        // Concurrent requests for the same image are coalesced: only the first one computes the image, others wait for its result
+        const PendingRequestDesc requestDesc{ artworkId, width };
+        std::promise<std::shared_ptr<image::IEncodedImage>> promise;
+        std::shared_future<std::shared_ptr<image::IEncodedImage>> pendingRequestFuture;
+        {
+            const std::scoped_lock lock{ _pendingRequestsMutex };
+
+            if (const auto it{ _pendingRequests.find(requestDesc) }; it != std::cend(_pendingRequests))
+            {
+                pendingRequestFuture = it->second;
+                ++_pendingRequestsWaitCount;
+            }
+            else
+                _pendingRequests.emplace(requestDesc, promise.get_future().share());
+        }
+
+        if (pendingRequestFuture.valid())
+            return pendingRequestFuture.get(); // may throw
+
+        std::shared_ptr<image::IEncodedImage> image;
+        try
+        {
+            image = computeImage(artworkId, width);
+            promise.set_value(image);
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+
+            const std::scoped_lock lock{ _pendingRequestsMutex };
+            _pendingRequests.erase(requestDesc);
+            throw;
+        }
+
+        // resized images are in the memory cache at this point (unless too large for it), so new requests won't need to wait
+        // unresized images are never cached in memory: new requests will compute them again
+        const std::scoped_lock lock{ _pendingRequestsMutex };
+        _pendingRequests.erase(requestDesc);
+
+        return image;
+    }
+
+    std::shared_ptr<image::IEncodedImage> ArtworkService::computeImage(db::ArtworkId artworkId, std::optional<image::ImageSize> width)
     {
         const ImageCache::EntryDesc cacheEntryDesc{ artworkId, width };
 
+        // may have been computed by a concurrent request that just completed
         std::shared_ptr<image::IEncodedImage> image{ _cache.getImage(cacheEntryDesc) };
         if (image)
             return image;
 
         db::Artwork::UnderlyingId underlyingArtworkId;
+        std::time_t sourceTimestamp{};
 
         {
             db::Session& session{ _db.getTLSSession() };
             auto transaction{ session.createReadTransaction() };
 
             db::Artwork::pointer artwork{ db::Artwork::find(session, artworkId) };
-            if (artwork)
-                underlyingArtworkId = artwork->getUnderlyingId();
+            if (!artwork)
+                return nullptr;
+
+            underlyingArtworkId = artwork->getUnderlyingId();
+            sourceTimestamp = artwork->getLastWrittenTime().toTime_t();
         }
 
-        if (const auto* trackEmbeddedImageId = std::get_if<db::TrackEmbeddedImageId>(&underlyingArtworkId))
-            image = getTrackEmbeddedImage(*trackEmbeddedImageId, width);
-        else if (const auto* imageId = std::get_if<db::ImageId>(&underlyingArtworkId))
-            image = getImage(*imageId, width);
+        // pre-rendered thumbnails don't need any decoding
+        if (width && isThumbnailSize(*width))
+        {
+            image = _thumbnailStore.getImage(DiskImageCache::EntryDesc{ artworkId, *width, _jpegQuality }, sourceTimestamp);
+            if (image)
+            {
+                _cache.addImage(cacheEntryDesc, image, sourceTimestamp);
+                return image;
+            }
+        }
+
+        // only resized images are worth being stored on disk
+        std::optional<DiskImageCache::EntryDesc> diskCacheEntryDesc;
+        if (width)
+        {
+            diskCacheEntryDesc = DiskImageCache::EntryDesc{ artworkId, *width, _jpegQuality };
+            image = _diskCache.getImage(*diskCacheEntryDesc, sourceTimestamp);
+        }
+
+        if (!image)
+        {
+            if (const auto* trackEmbeddedImageId = std::get_if<db::TrackEmbeddedImageId>(&underlyingArtworkId))
+                image = getTrackEmbeddedImage(*trackEmbeddedImageId, width);
+            else if (const auto* imageId = std::get_if<db::ImageId>(&underlyingArtworkId))
+                image = getImage(*imageId, width);
+
+            if (image && diskCacheEntryDesc)
+                _diskCache.addImage(*diskCacheEntryDesc, *image, sourceTimestamp);
+        }
 
         if (image)
-            _cache.addImage(cacheEntryDesc, image);
+            _cache.addImage(cacheEntryDesc, image, sourceTimestamp);
 
         return image;
     }
@@ -239,25 +404,176 @@ namespace lms::artwork
 
     std::shared_ptr<image::IEncodedImage> ArtworkService::getTrackEmbeddedImage(db::TrackEmbeddedImageId trackEmbeddedImageId, std::optional<image::ImageSize> width)
     {
-        std::shared_ptr<image::IEncodedImage> image;
+        const std::optional<TrackImageLocation> location{ findTrackImageLocation(trackEmbeddedImageId) };
+        if (!location)
+            return nullptr;
 
+        return getTrackImage(*location, width);
+    }
+
+    void ArtworkService::refreshCache()
+    {
+        std::vector<std::pair<db::ArtworkId, std::time_t>> cachedArtworks;
+        _cache.visitEntries([&](db::ArtworkId id, std::time_t sourceTimestamp) {
+            cachedArtworks.emplace_back(id, sourceTimestamp);
+        });
+
+        std::sort(std::begin(cachedArtworks), std::end(cachedArtworks));
+        cachedArtworks.erase(std::unique(std::begin(cachedArtworks), std::end(cachedArtworks)), std::end(cachedArtworks));
+
+        std::vector<db::ArtworkId> staleArtworkIds;
         {
             db::Session& session{ _db.getTLSSession() };
             auto transaction{ session.createReadTransaction() };
 
-            // TODO: could be put outside transaction
-            db::TrackEmbeddedImageLink::find(session, trackEmbeddedImageId, [&](const db::TrackEmbeddedImageLink::pointer& link) {
-                if (!image)
-                    image = getTrackImage(link->getTrack()->getAbsoluteFilePath(), link->getIndex(), width);
-            });
+            for (const auto& [artworkId, sourceTimestamp] : cachedArtworks)
+            {
+                const db::Artwork::pointer artwork{ db::Artwork::find(session, artworkId) };
+                if (!artwork || artwork->getLastWrittenTime().toTime_t() != sourceTimestamp)
+                    staleArtworkIds.push_back(artworkId);
+            }
         }
 
-        return image;
+        // Disk entries are also checked against the source timestamp when accessed
+        for (const db::ArtworkId artworkId : staleArtworkIds)
+        {
+            _cache.invalidate(artworkId);
+            _diskCache.invalidate(artworkId);
+        }
+
+        const CacheStats memoryStats{ _cache.getStats() };
+        const CacheStats diskStats{ _diskCache.getStats() };
+        std::size_t pendingRequestsWaitCount;
+        {
+            const std::scoped_lock lock{ _pendingRequestsMutex };
+            pendingRequestsWaitCount = _pendingRequestsWaitCount;
+        }
+
+        LMS_LOG(COVER, DEBUG, "Invalidated " << staleArtworkIds.size() << " artworks, coalesced requests = " << pendingRequestsWaitCount);
+        LMS_LOG(COVER, DEBUG, "Memory cache stats: hits = " << memoryStats.hits << ", misses = " << memoryStats.misses << ", evictions = " << memoryStats.evictions << ", nb entries = " << memoryStats.entryCount << ", size = " << memoryStats.size);
+        LMS_LOG(COVER, DEBUG, "Disk cache stats: hits = " << diskStats.hits << ", misses = " << diskStats.misses << ", evictions = " << diskStats.evictions << ", nb entries = " << diskStats.entryCount << ", size = " << diskStats.size);
+    }
+
+    CacheStats ArtworkService::getMemoryCacheStats() const
+    {
+        return _cache.getStats();
+    }
+
+    CacheStats ArtworkService::getDiskCacheStats() const
+    {
+        return _diskCache.getStats();
+    }
+
+    bool ArtworkService::hasThumbnails(db::ArtworkId artworkId, std::time_t sourceTimestamp) const
+    {
+        return std::all_of(std::cbegin(_thumbnailSizes), std::cend(_thumbnailSizes), [&](image::ImageSize size) {
+            return _thumbnailStore.hasImage(DiskImageCache::EntryDesc{ artworkId, size, _jpegQuality }, sourceTimestamp);
+        });
+    }
+
+    void ArtworkService::renderThumbnails(db::ArtworkId artworkId)
+    {
+        if (_thumbnailSizes.empty())
+            return;
+
+        db::Artwork::UnderlyingId underlyingArtworkId;
+        std::time_t sourceTimestamp{};
+        {
+            db::Session& session{ _db.getTLSSession() };
+            auto transaction{ session.createReadTransaction() };
+
+            db::Artwork::pointer artwork{ db::Artwork::find(session, artworkId) };
+            if (!artwork)
+                return;
+
+            underlyingArtworkId = artwork->getUnderlyingId();
+            sourceTimestamp = artwork->getLastWrittenTime().toTime_t();
+        }
+
+        if (hasThumbnails(artworkId, sourceTimestamp))
+            return;
+
+        // Decode the source only once, thumbnails are rendered from the largest to the smallest
+        std::unique_ptr<image::IRawImage> rawImage;
+        if (const auto* trackEmbeddedImageId = std::get_if<db::TrackEmbeddedImageId>(&underlyingArtworkId))
+            rawImage = decodeTrackEmbeddedImage(*trackEmbeddedImageId);
+        else if (const auto* imageId = std::get_if<db::ImageId>(&underlyingArtworkId))
+            rawImage = decodeImage(*imageId);
+
+        if (!rawImage)
+            return;
+
+        try
+        {
+            for (const image::ImageSize size : _thumbnailSizes)
+            {
+                rawImage->resize(size);
+                const auto encodedImage{ image::encodeToJPEG(*rawImage, _jpegQuality) };
+                _thumbnailStore.addImage(DiskImageCache::EntryDesc{ artworkId, size, _jpegQuality }, *encodedImage, sourceTimestamp);
+            }
+        }
+        catch (const image::Exception& e)
+        {
+            LMS_LOG(COVER, ERROR, "Cannot render thumbnails for artwork " << artworkId.toString() << ": " << e.what());
+        }
+    }
+
+    void ArtworkService::removeThumbnails(const ThumbnailPredicate& predicate)
+    {
+        _thumbnailStore.invalidateIf(predicate);
+    }
+
+    std::unique_ptr<image::IRawImage> ArtworkService::decodeImage(db::ImageId imageId)
+    {
+        std::filesystem::path imageFile;
+        {
+            db::Session& session{ _db.getTLSSession() };
+            auto transaction{ session.createReadTransaction() };
+
+            const db::Image::pointer image{ db::Image::find(session, imageId) };
+            if (!image)
+                return nullptr;
+
+            imageFile = image->getAbsoluteFilePath();
+        }
+
+        std::unique_ptr<image::IRawImage> rawImage;
+        try
+        {
+            rawImage = image::decodeImage(imageFile);
+        }
+        catch (const image::Exception& e)
+        {
+            LMS_LOG(COVER, ERROR, "Cannot read cover in file " << imageFile << ": " << e.what());
+        }
+
+        return rawImage;
+    }
+
+    std::unique_ptr<image::IRawImage> ArtworkService::decodeTrackEmbeddedImage(db::TrackEmbeddedImageId trackEmbeddedImageId)
+    {
+        const std::optional<TrackImageLocation> location{ findTrackImageLocation(trackEmbeddedImageId) };
+        if (!location)
+            return nullptr;
+
+        std::unique_ptr<image::IRawImage> rawImage;
+        visitTrackImage(*location, [&](const audio::Image& parsedImage) {
+            try
+            {
+                rawImage = image::decodeImage(parsedImage.data);
+            }
+            catch (const image::Exception& e)
+            {
+                LMS_LOG(COVER, ERROR, "Cannot decode image from track " << location->trackPath << ": " << e.what());
+            }
+        });
+
+        return rawImage;
     }
 
-    void ArtworkService::flushCache()
+    bool ArtworkService::isThumbnailSize(image::ImageSize size) const
     {
-        _cache.flush();
+        return std::find(std::cbegin(_thumbnailSizes), std::cend(_thumbnailSizes), size) != std::cend(_thumbnailSizes);
     }
 
     void ArtworkService::setJpegQuality(unsigned quality)
@@ -19,18 +19,30 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
 #include <vector>
 
 #include "database/objects/ImageId.hpp"
 #include "database/objects/TrackEmbeddedImageId.hpp"
 #include "services/artwork/IArtworkService.hpp"
 
+#include "DiskImageCache.hpp"
 #include "ImageCache.hpp"
 
 namespace lms::audio
 {
     class IAudioFileInfoParser;
+    struct Image;
+} // namespace lms::audio
+
+namespace lms::image
+{
+    class IRawImage;
 }
 
 namespace lms::db
@@ -43,7 +55,7 @@ namespace lms::artwork
     class ArtworkService : public IArtworkService
     {
     public:
-        ArtworkService(db::IDb& db, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath);
+        ArtworkService(db::IDb& db, const std::filesystem::path& cachePath, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath);
         ~ArtworkService() override;
         ArtworkService(const ArtworkService&) = delete;
         ArtworkService& operator=(const ArtworkService&) = delete;
@@ -56,18 +68,55 @@ namespace lms::artwork
         std::shared_ptr<image::IEncodedImage> getDefaultReleaseArtwork() override;
         std::shared_ptr<image::IEncodedImage> getDefaultArtistArtwork() override;
 
-        void flushCache() override;
+        void refreshCache() override;
+        CacheStats getMemoryCacheStats() const override;
+        CacheStats getDiskCacheStats() const override;
+        bool hasThumbnails(db::ArtworkId artworkId, std::time_t sourceTimestamp) const override;
+        void renderThumbnails(db::ArtworkId artworkId) override;
+        void removeThumbnails(const ThumbnailPredicate& predicate) override;
         void setJpegQuality(unsigned quality) override;
 
+        std::shared_ptr<image::IEncodedImage> computeImage(db::ArtworkId artworkId, std::optional<image::ImageSize> width);
         std::shared_ptr<image::IEncodedImage> getImage(db::ImageId imageId, std::optional<image::ImageSize> width);
         std::shared_ptr<image::IEncodedImage> getTrackEmbeddedImage(db::TrackEmbeddedImageId trackEmbeddedImageId, std::optional<image::ImageSize> width);
 
         std::unique_ptr<image::IEncodedImage> getFromImageFile(const std::filesystem::path& p, std::string_view mimeType, std::optional<image::ImageSize> width) const;
-        std::unique_ptr<image::IEncodedImage> getTrackImage(const std::filesystem::path& path, std::size_t index, std::optional<image::ImageSize> width) const;
+
+        struct TrackImageLocation
+        {
+            std::filesystem::path trackPath;
+            std::size_t index; // within the track
+            std::optional<std::uint64_t> dataOffset;
+            std::size_t dataSize;
+            std::uint64_t dataHash;
+            std::string mimeType;
+        };
+        std::optional<TrackImageLocation> findTrackImageLocation(db::TrackEmbeddedImageId trackEmbeddedImageId);
+        std::unique_ptr<image::IEncodedImage> getTrackImage(const TrackImageLocation& location, std::optional<image::ImageSize> width) const;
+        void visitTrackImage(const TrackImageLocation& location, const std::function<void(const audio::Image&)>& visitor) const;
+
+        std::unique_ptr<image::IRawImage> decodeImage(db::ImageId imageId);
+        std::unique_ptr<image::IRawImage> decodeTrackEmbeddedImage(db::TrackEmbeddedImageId trackEmbeddedImageId);
+        bool isThumbnailSize(image::ImageSize size) const;
 
         db::IDb& _db;
 
         ImageCache _cache;
+        DiskImageCache _diskCache;
+        std::vector<image::ImageSize> _thumbnailSizes; // largest first
+        DiskImageCache _thumbnailStore;
+
+        struct PendingRequestDesc
+        {
+            db::ArtworkId id;
+            std::optional<image::ImageSize> width;
+
+            auto operator<=>(const PendingRequestDesc& other) const = default;
+        };
+        std::mutex _pendingRequestsMutex;
+        std::map<PendingRequestDesc, std::shared_future<std::shared_ptr<image::IEncodedImage>>> _pendingRequests;
+        std::size_t _pendingRequestsWaitCount{};
+
         std::shared_ptr<image::IEncodedImage> _defaultReleaseCover;
         std::shared_ptr<image::IEncodedImage> _defaultArtistImage;
         std::unique_ptr<audio::IAudioFileInfoParser> _audioFileInfoParser;
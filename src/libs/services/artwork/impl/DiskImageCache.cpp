@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiskImageCache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "core/ILogger.hpp"
+#include "core/String.hpp"
+#include "image/Exception.hpp"
+#include "image/Image.hpp"
+
+namespace lms::artwork
+{
+    namespace
+    {
+        constexpr std::string_view diskImageCacheFileExtension{ ".jpg" };
+        constexpr std::string_view diskImageCacheTmpFileExtension{ ".tmp" };
+        constexpr std::size_t diskImageCacheDirectoryCount{ 256 };
+    } // namespace
+
+    DiskImageCache::DiskImageCache(const std::filesystem::path& rootPath, std::size_t maxCacheSize)
+        : _rootPath{ rootPath }
+        , _maxCacheSize{ maxCacheSize }
+    {
+        if (_maxCacheSize == 0)
+            return;
+
+        std::filesystem::create_directories(_rootPath);
+        loadEntries();
+    }
+
+    DiskImageCache::~DiskImageCache()
+    {
+        LMS_LOG(COVER, DEBUG, "Disk cache stats: hits = " << _cacheHits << ", misses = " << _cacheMisses << ", evictions = " << _cacheEvictions << ", invalidations = " << _cacheInvalidations << ", nb entries = " << _entries.size() << ", size = " << _cacheSize);
+    }
+
+    std::unique_ptr<image::IEncodedImage> DiskImageCache::getImage(const EntryDesc& entryDesc, std::time_t sourceTimestamp)
+    {
+        if (_maxCacheSize == 0)
+            return nullptr;
+
+        std::filesystem::path entryPath;
+        {
+            const std::scoped_lock lock{ _mutex };
+
+            const auto it{ _entriesByDesc.find(entryDesc) };
+            if (it == std::cend(_entriesByDesc))
+            {
+                ++_cacheMisses;
+                return nullptr;
+            }
+
+            if (it->second->sourceTimestamp != sourceTimestamp)
+            {
+                removeEntry(it->second);
+                ++_cacheInvalidations;
+                ++_cacheMisses;
+                return nullptr;
+            }
+
+            ++_cacheHits;
+            _entries.splice(std::begin(_entries), _entries, it->second);
+            entryPath = getEntryPath(entryDesc, sourceTimestamp);
+        }
+
+        std::unique_ptr<image::IEncodedImage> image;
+        try
+        {
+            image = image::readImage(entryPath, "image/jpeg");
+
+            // used to restore LRU order after a restart
+            std::error_code ec;
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+        }
+        catch (const image::Exception& e)
+        {
+            LMS_LOG(COVER, ERROR, "Cannot read cached image " << entryPath << ": " << e.what());
+
+            const std::scoped_lock lock{ _mutex };
+            if (const auto it{ _entriesByDesc.find(entryDesc) }; it != std::cend(_entriesByDesc) && it->second->sourceTimestamp == sourceTimestamp)
+                removeEntry(it->second);
+        }
+
+        return image;
+    }
+
+    void DiskImageCache::addImage(const EntryDesc& entryDesc, const image::IEncodedImage& image, std::time_t sourceTimestamp)
+    {
+        const std::span<const std::byte> data{ image.getData() };
+        if (_maxCacheSize == 0 || data.size() > _maxCacheSize)
+            return;
+
+        const std::filesystem::path entryPath{ getEntryPath(entryDesc, sourceTimestamp) };
+
+        // Write in a temporary file first, so that readers never see partially written files
+        std::filesystem::path tmpPath{ entryPath };
+        tmpPath += "." + std::to_string(_tmpFileCounter++);
+        tmpPath += diskImageCacheTmpFileExtension;
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(entryPath.parent_path(), ec);
+
+            std::ofstream file{ tmpPath, std::ios::binary | std::ios::trunc };
+            if (!file || !file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+            {
+                LMS_LOG(COVER, ERROR, "Cannot write cached image " << tmpPath);
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, entryPath, ec);
+        if (ec)
+        {
+            LMS_LOG(COVER, ERROR, "Cannot rename " << tmpPath << " to " << entryPath << ": " << ec.message());
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+
+        const std::scoped_lock lock{ _mutex };
+
+        if (const auto it{ _entriesByDesc.find(entryDesc) }; it != std::cend(_entriesByDesc))
+        {
+            // Same file name means we just overwrote it
+            if (it->second->sourceTimestamp == sourceTimestamp)
+            {
+                _cacheSize -= it->second->fileSize;
+                _entriesByDesc.erase(it->second->desc);
+                _entries.erase(it->second);
+            }
+            else
+                removeEntry(it->second);
+        }
+
+        evictEntries(data.size());
+        insertEntry(Entry{ entryDesc, sourceTimestamp, data.size() });
+    }
+
+    bool DiskImageCache::hasImage(const EntryDesc& entryDesc, std::time_t sourceTimestamp) const
+    {
+        if (_maxCacheSize == 0)
+            return false;
+
+        const std::scoped_lock lock{ _mutex };
+
+        const auto it{ _entriesByDesc.find(entryDesc) };
+        return it != std::cend(_entriesByDesc) && it->second->sourceTimestamp == sourceTimestamp;
+    }
+
+    void DiskImageCache::invalidate(db::ArtworkId id)
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        auto it{ _entriesByDesc.lower_bound(EntryDesc{ id, 0, 0 }) };
+        while (it != std::end(_entriesByDesc) && it->first.id == id)
+        {
+            auto itNext{ std::next(it) };
+            removeEntry(it->second);
+            ++_cacheInvalidations;
+            it = itNext;
+        }
+    }
+
+    void DiskImageCache::invalidateIf(const InvalidatePredicate& predicate)
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        for (auto it{ std::begin(_entries) }; it != std::end(_entries);)
+        {
+            auto itNext{ std::next(it) };
+            if (predicate(it->desc.id, it->sourceTimestamp))
+            {
+                removeEntry(it);
+                ++_cacheInvalidations;
+            }
+            it = itNext;
+        }
+    }
+
+    CacheStats DiskImageCache::getStats() const
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        return CacheStats{
+            .hits = _cacheHits,
+            .misses = _cacheMisses,
+            .evictions = _cacheEvictions,
+            .invalidations = _cacheInvalidations,
+            .entryCount = _entries.size(),
+            .size = _cacheSize,
+        };
+    }
+
+    void DiskImageCache::loadEntries()
+    {
+        struct LoadedEntry
+        {
+            Entry entry;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+        std::vector<LoadedEntry> loadedEntries;
+
+        std::error_code ec;
+        for (auto itPath{ std::filesystem::recursive_directory_iterator{ _rootPath, ec } }; !ec && itPath != std::filesystem::recursive_directory_iterator{}; itPath.increment(ec))
+        {
+            std::error_code fileEc;
+            if (!itPath->is_regular_file(fileEc))
+                continue;
+
+            const std::filesystem::path& path{ itPath->path() };
+            std::optional<Entry> entry{ parseEntryPath(path) };
+            if (entry)
+            {
+                entry->fileSize = itPath->file_size(fileEc);
+                if (!fileEc && getEntryPath(entry->desc, entry->sourceTimestamp) == path)
+                {
+                    loadedEntries.push_back(LoadedEntry{ *entry, itPath->last_write_time(fileEc) });
+                    continue;
+                }
+            }
+
+            // Leftovers from interrupted writes or from an older layout
+            LMS_LOG(COVER, DEBUG, "Removing unexpected file " << path << " from the disk cache");
+            std::filesystem::remove(path, fileEc);
+        }
+
+        if (ec)
+            LMS_LOG(COVER, ERROR, "Cannot explore disk cache directory " << _rootPath << ": " << ec.message());
+
+        std::sort(std::begin(loadedEntries), std::end(loadedEntries), [](const LoadedEntry& lhs, const LoadedEntry& rhs) { return lhs.lastWriteTime > rhs.lastWriteTime; });
+
+        const std::scoped_lock lock{ _mutex };
+        for (const LoadedEntry& loadedEntry : loadedEntries)
+        {
+            // Duplicate entries may exist if the application was stopped while overwriting an entry
+            if (_entriesByDesc.contains(loadedEntry.entry.desc) || _cacheSize + loadedEntry.entry.fileSize > _maxCacheSize)
+            {
+                std::filesystem::remove(getEntryPath(loadedEntry.entry.desc, loadedEntry.entry.sourceTimestamp), ec);
+                continue;
+            }
+
+            _entries.push_back(loadedEntry.entry);
+            _entriesByDesc.emplace(loadedEntry.entry.desc, std::prev(std::end(_entries)));
+            _cacheSize += loadedEntry.entry.fileSize;
+        }
+
+        LMS_LOG(COVER, INFO, "Disk cache loaded: nb entries = " << _entries.size() << ", size = " << _cacheSize << ", max size = " << _maxCacheSize);
+    }
+
+    std::filesystem::path DiskImageCache::getEntryPath(const EntryDesc& entryDesc, std::time_t sourceTimestamp) const
+    {
+        const auto id{ entryDesc.id.getValue() };
+
+        std::string fileName{ std::to_string(id) + "_" + std::to_string(entryDesc.size) + "_" + std::to_string(entryDesc.jpegQuality) + "_" + std::to_string(sourceTimestamp) };
+        fileName += diskImageCacheFileExtension;
+
+        return _rootPath / std::to_string(static_cast<std::size_t>(id) % diskImageCacheDirectoryCount) / fileName;
+    }
+
+    std::optional<DiskImageCache::Entry> DiskImageCache::parseEntryPath(const std::filesystem::path& path)
+    {
+        if (path.extension() != diskImageCacheFileExtension)
+            return std::nullopt;
+
+        const std::string stem{ path.stem().string() };
+        const std::vector<std::string_view> fields{ core::stringUtils::splitString(stem, '_') };
+        if (fields.size() != 4)
+            return std::nullopt;
+
+        const auto id{ core::stringUtils::readAs<db::ArtworkId::ValueType>(fields[0]) };
+        const auto size{ core::stringUtils::readAs<image::ImageSize>(fields[1]) };
+        const auto jpegQuality{ core::stringUtils::readAs<unsigned>(fields[2]) };
+        const auto sourceTimestamp{ core::stringUtils::readAs<std::time_t>(fields[3]) };
+        if (!id || !size || !jpegQuality || !sourceTimestamp)
+            return std::nullopt;
+
+        return Entry{ EntryDesc{ db::ArtworkId{ *id }, *size, *jpegQuality }, *sourceTimestamp, 0 };
+    }
+
+    void DiskImageCache::insertEntry(const Entry& entry)
+    {
+        _entries.push_front(entry);
+        _entriesByDesc.emplace(entry.desc, std::begin(_entries));
+        _cacheSize += entry.fileSize;
+    }
+
+    void DiskImageCache::removeEntry(EntryList::iterator it)
+    {
+        std::error_code ec;
+        std::filesystem::remove(getEntryPath(it->desc, it->sourceTimestamp), ec);
+        if (ec)
+            LMS_LOG(COVER, ERROR, "Cannot remove cached image: " << ec.message());
+
+        _cacheSize -= it->fileSize;
+        _entriesByDesc.erase(it->desc);
+        _entries.erase(it);
+    }
+
+    void DiskImageCache::evictEntries(std::size_t requestedSize)
+    {
+        while (_cacheSize + requestedSize > _maxCacheSize && !_entries.empty())
+        {
+            removeEntry(std::prev(std::end(_entries)));
+            ++_cacheEvictions;
+        }
+    }
+} // namespace lms::artwork
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "database/objects/ArtworkId.hpp"
+#include "image/IEncodedImage.hpp"
+#include "services/artwork/IArtworkService.hpp"
+
+namespace lms::artwork
+{
+    // Persistent cache for resized images, least recently used entries are evicted first
+    // Files are named after the entry desc and the source timestamp, so that the cache can be reloaded after a restart
+    class DiskImageCache
+    {
+    public:
+        DiskImageCache(const std::filesystem::path& rootPath, std::size_t maxCacheSize);
+        ~DiskImageCache();
+        DiskImageCache(const DiskImageCache&) = delete;
+        DiskImageCache& operator=(const DiskImageCache&) = delete;
+
+        struct EntryDesc
+        {
+            db::ArtworkId id;
+            image::ImageSize size;
+            unsigned jpegQuality;
+
+            auto operator<=>(const EntryDesc& other) const = default;
+        };
+
+        std::size_t getMaxCacheSize() const { return _maxCacheSize; }
+
+        // Entries whose source timestamp does not match are considered stale and are removed
+        std::unique_ptr<image::IEncodedImage> getImage(const EntryDesc& entryDesc, std::time_t sourceTimestamp);
+        void addImage(const EntryDesc& entryDesc, const image::IEncodedImage& image, std::time_t sourceTimestamp);
+        // Does not affect LRU order nor stats
+        bool hasImage(const EntryDesc& entryDesc, std::time_t sourceTimestamp) const;
+
+        // Remove all the entries related to the given artwork (all sizes/qualities)
+        void invalidate(db::ArtworkId id);
+        using InvalidatePredicate = std::function<bool(db::ArtworkId id, std::time_t sourceTimestamp)>;
+        void invalidateIf(const InvalidatePredicate& predicate);
+
+        CacheStats getStats() const;
+
+    private:
+        struct Entry
+        {
+            EntryDesc desc;
+            std::time_t sourceTimestamp;
+            std::size_t fileSize;
+        };
+        using EntryList = std::list<Entry>;
+
+        void loadEntries();
+        std::filesystem::path getEntryPath(const EntryDesc& entryDesc, std::time_t sourceTimestamp) const;
+        static std::optional<Entry> parseEntryPath(const std::filesystem::path& path);
+
+        void insertEntry(const Entry& entry);
+        void removeEntry(EntryList::iterator it);
+        void evictEntries(std::size_t requestedSize);
+
+        const std::filesystem::path _rootPath;
+        const std::size_t _maxCacheSize;
+
+        mutable std::mutex _mutex;
+        EntryList _entries; // most recently used first
+        std::map<EntryDesc, EntryList::iterator> _entriesByDesc;
+        std::size_t _cacheSize{};
+        std::size_t _cacheHits{};
+        std::size_t _cacheMisses{};
+        std::size_t _cacheEvictions{};
+        std::size_t _cacheInvalidations{};
+        std::atomic<std::size_t> _tmpFileCounter{};
+    };
+} // namespace lms::artwork
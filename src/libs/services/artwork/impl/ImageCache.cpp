@@ -19,11 +19,6 @@
 
 #include "ImageCache.hpp"
 
-#include <mutex>
-
-#include "core/ILogger.hpp"
-#include "core/Random.hpp"
-
 namespace lms::artwork
 {
     ImageCache::ImageCache(std::size_t maxCacheSize)
@@ -31,52 +26,94 @@ namespace lms::artwork
     {
     }
 
-    void ImageCache::addImage(const EntryDesc& entryDesc, std::shared_ptr<image::IEncodedImage> image)
+    void ImageCache::addImage(const EntryDesc& entryDesc, std::shared_ptr<image::IEncodedImage> image, std::time_t sourceTimestamp)
     {
         // cache only resized files
         if (!entryDesc.size)
             return;
 
-        const std::unique_lock lock{ _mutex };
+        const std::size_t imageSize{ image->getData().size() };
+        if (imageSize > _maxCacheSize)
+            return;
+
+        const std::scoped_lock lock{ _mutex };
+
+        if (const auto it{ _entriesByDesc.find(entryDesc) }; it != std::cend(_entriesByDesc))
+            removeEntry(it->second);
 
-        while (_cacheSize + image->getData().size() > _maxCacheSize && !_cache.empty())
+        while (_cacheSize + imageSize > _maxCacheSize && !_entries.empty())
         {
-            auto itRandom{ core::random::pickRandom(_cache) };
-            _cacheSize -= itRandom->second->getData().size();
-            _cache.erase(itRandom);
+            removeEntry(std::prev(std::end(_entries)));
+            ++_cacheEvictions;
         }
 
-        _cacheSize += image->getData().size();
-        _cache[entryDesc] = image;
+        _entries.push_front(Entry{ entryDesc, std::move(image), sourceTimestamp });
+        _entriesByDesc.emplace(entryDesc, std::begin(_entries));
+        _cacheSize += imageSize;
     }
 
-    std::shared_ptr<image::IEncodedImage> ImageCache::getImage(const EntryDesc& entryDesc) const
+    std::shared_ptr<image::IEncodedImage> ImageCache::getImage(const EntryDesc& entryDesc)
     {
         // cache only resized files
         if (!entryDesc.size)
             return {};
 
-        const std::shared_lock lock{ _mutex };
+        const std::scoped_lock lock{ _mutex };
 
-        const auto it{ _cache.find(entryDesc) };
-        if (it == std::cend(_cache))
+        const auto it{ _entriesByDesc.find(entryDesc) };
+        if (it == std::cend(_entriesByDesc))
         {
             ++_cacheMisses;
             return nullptr;
         }
 
         ++_cacheHits;
-        return it->second;
+        _entries.splice(std::begin(_entries), _entries, it->second);
+        return it->second->image;
+    }
+
+    void ImageCache::visitEntries(const EntryVisitor& visitor) const
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        for (const Entry& entry : _entries)
+            visitor(entry.desc.id, entry.sourceTimestamp);
     }
 
-    void ImageCache::flush()
+    void ImageCache::invalidate(db::ArtworkId id)
     {
-        const std::unique_lock lock{ _mutex };
+        const std::scoped_lock lock{ _mutex };
 
-        LMS_LOG(COVER, DEBUG, "Cache stats: hits = " << _cacheHits.load() << ", misses = " << _cacheMisses.load() << ", nb entries = " << _cache.size() << ", size = " << _cacheSize);
-        _cacheHits = 0;
-        _cacheMisses = 0;
-        _cacheSize = 0;
-        _cache.clear();
+        for (auto it{ std::begin(_entries) }; it != std::end(_entries);)
+        {
+            auto itNext{ std::next(it) };
+            if (it->desc.id == id)
+            {
+                removeEntry(it);
+                ++_cacheInvalidations;
+            }
+            it = itNext;
+        }
+    }
+
+    CacheStats ImageCache::getStats() const
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        return CacheStats{
+            .hits = _cacheHits,
+            .misses = _cacheMisses,
+            .evictions = _cacheEvictions,
+            .invalidations = _cacheInvalidations,
+            .entryCount = _entries.size(),
+            .size = _cacheSize,
+        };
+    }
+
+    void ImageCache::removeEntry(EntryList::iterator it)
+    {
+        _cacheSize -= it->image->getData().size();
+        _entriesByDesc.erase(it->desc);
+        _entries.erase(it);
     }
-} // namespace lms::artwork
\ No newline at end of file
+} // namespace lms::artwork
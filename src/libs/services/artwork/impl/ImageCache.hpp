@@ -19,18 +19,22 @@
 
 #pragma once
 
-#include <atomic>
 #include <cassert>
+#include <ctime>
+#include <functional>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
-#include <shared_mutex>
 #include <unordered_map>
 
 #include "database/objects/ArtworkId.hpp"
 #include "image/IEncodedImage.hpp"
+#include "services/artwork/IArtworkService.hpp"
 
 namespace lms::artwork
 {
+    // In-memory cache, least recently used entries are evicted first
     class ImageCache
     {
     public:
@@ -46,15 +50,21 @@ namespace lms::artwork
 
         std::size_t getMaxCacheSize() const { return _maxCacheSize; }
 
-        void addImage(const EntryDesc& entryDesc, std::shared_ptr<image::IEncodedImage> image);
-        std::shared_ptr<image::IEncodedImage> getImage(const EntryDesc& entryDesc) const;
-        void flush();
+        // sourceTimestamp is the last write time of the artwork source, used to detect stale entries
+        void addImage(const EntryDesc& entryDesc, std::shared_ptr<image::IEncodedImage> image, std::time_t sourceTimestamp);
+        std::shared_ptr<image::IEncodedImage> getImage(const EntryDesc& entryDesc);
+
+        using EntryVisitor = std::function<void(db::ArtworkId id, std::time_t sourceTimestamp)>;
+        void visitEntries(const EntryVisitor& visitor) const;
+
+        // Remove all the entries related to the given artwork (all sizes)
+        void invalidate(db::ArtworkId id);
+
+        CacheStats getStats() const;
 
     private:
         const std::size_t _maxCacheSize;
 
-        mutable std::shared_mutex _mutex;
-
         struct EntryHasher
         {
             std::size_t operator()(const EntryDesc& entry) const
@@ -64,9 +74,23 @@ namespace lms::artwork
             }
         };
 
-        std::unordered_map<EntryDesc, std::shared_ptr<image::IEncodedImage>, EntryHasher> _cache;
+        struct Entry
+        {
+            EntryDesc desc;
+            std::shared_ptr<image::IEncodedImage> image;
+            std::time_t sourceTimestamp;
+        };
+        using EntryList = std::list<Entry>;
+
+        void removeEntry(EntryList::iterator it);
+
+        mutable std::mutex _mutex;
+        EntryList _entries; // most recently used first
+        std::unordered_map<EntryDesc, EntryList::iterator, EntryHasher> _entriesByDesc;
         std::size_t _cacheSize{};
-        mutable std::atomic<std::size_t> _cacheMisses;
-        mutable std::atomic<std::size_t> _cacheHits;
+        std::size_t _cacheHits{};
+        std::size_t _cacheMisses{};
+        std::size_t _cacheEvictions{};
+        std::size_t _cacheInvalidations{};
     };
-} // namespace lms::artwork
\ No newline at end of file
+} // namespace lms::artwork
@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <ctime>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -34,6 +37,16 @@ namespace lms::db
 
 namespace lms::artwork
 {
+    struct CacheStats
+    {
+        std::size_t hits{};
+        std::size_t misses{};
+        std::size_t evictions{};
+        std::size_t invalidations{};
+        std::size_t entryCount{};
+        std::size_t size{}; // in bytes
+    };
+
     class IArtworkService
     {
     public:
@@ -49,11 +62,20 @@ namespace lms::artwork
         virtual std::shared_ptr<image::IEncodedImage> getDefaultReleaseArtwork() = 0;
         virtual std::shared_ptr<image::IEncodedImage> getDefaultArtistArtwork() = 0;
 
-        virtual void flushCache() = 0;
+        // Drop the cached images whose artwork was removed or whose source was modified
+        virtual void refreshCache() = 0;
+        virtual CacheStats getMemoryCacheStats() const = 0;
+        virtual CacheStats getDiskCacheStats() const = 0;
+
+        // Thumbnails are pre-rendered at the configured sizes and stored on disk, so that they can be served without decoding the source
+        virtual bool hasThumbnails(db::ArtworkId artworkId, std::time_t sourceTimestamp) const = 0;
+        virtual void renderThumbnails(db::ArtworkId artworkId) = 0;
+        using ThumbnailPredicate = std::function<bool(db::ArtworkId artworkId, std::time_t sourceTimestamp)>;
+        virtual void removeThumbnails(const ThumbnailPredicate& predicate) = 0;
 
         virtual void setJpegQuality(unsigned quality) = 0; // from 1 to 100
     };
 
-    std::unique_ptr<IArtworkService> createArtworkService(db::IDb& db, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath);
+    std::unique_ptr<IArtworkService> createArtworkService(db::IDb& db, const std::filesystem::path& cachePath, const std::filesystem::path& defaultReleaseCoverSvgPath, const std::filesystem::path& defaultArtistImageSvgPath);
 
 } // namespace lms::artwork
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <memory>
 #include <span>
 
 #include "core/EnumSet.hpp"
@@ -41,6 +42,10 @@ namespace lms::recommendation
 
         virtual void load() = 0;
 
+        // Returns a new loaded engine, up to date with the database
+        // Whatever is still valid in this engine may be reused, this engine is left untouched and can keep on serving requests meanwhile
+        virtual std::unique_ptr<IEngine> createUpdatedEngine() const = 0;
+
         virtual TrackResults findSimilarTracksFromTrackList(db::TrackListId tracklistId, std::size_t maxCount) const = 0;
         virtual TrackResults findSimilarTracks(std::span<const db::TrackId> tracksId, std::size_t maxCount) const = 0;
         virtual ReleaseResults findSimilarReleases(db::ReleaseId releaseId, std::size_t maxCount) const = 0;
@@ -24,6 +24,7 @@
 #include "audio/IMusicNNEmbeddingExtractor.hpp"
 #include "database/IDb.hpp"
 #include "database/Session.hpp"
+#include "database/objects/ScanSettings.hpp"
 
 #include "audio-similarity/musicnn/MusicNNEmbeddingEngine.hpp"
 #include "clusters/ClustersEngine.hpp"
@@ -52,14 +53,14 @@ namespace lms::recommendation
             return EngineType::None;
         }
 
-        std::unique_ptr<IEngine> createEngine(db::ScanSettings::RecommendationEngineType type, db::IDb& db)
+        std::unique_ptr<IEngine> createEngine(db::ScanSettings::RecommendationEngineType type, db::IDb& db, const std::filesystem::path& cachePath)
         {
             switch (type)
             {
             case db::ScanSettings::RecommendationEngineType::Clusters:
                 return std::make_unique<ClusterEngine>(db);
             case db::ScanSettings::RecommendationEngineType::AudioSimilarity:
-                return std::make_unique<MusicNNEmbeddingEngine>(db);
+                return std::make_unique<MusicNNEmbeddingEngine>(db, cachePath);
             case db::ScanSettings::RecommendationEngineType::None:
                 return nullptr;
             }
@@ -67,13 +68,14 @@ namespace lms::recommendation
         }
     } // namespace
 
-    std::unique_ptr<IRecommendationService> createRecommendationService(db::IDb& db)
+    std::unique_ptr<IRecommendationService> createRecommendationService(db::IDb& db, const std::filesystem::path& cachePath)
     {
-        return std::make_unique<RecommendationService>(db);
+        return std::make_unique<RecommendationService>(db, cachePath);
     }
 
-    RecommendationService::RecommendationService(db::IDb& db)
+    RecommendationService::RecommendationService(db::IDb& db, const std::filesystem::path& cachePath)
         : _db{ db }
+        , _cachePath{ cachePath }
         , _ioContextRunner{ _ioContext, 1, "RecommendationEngine" }
     {
         requestReload();
@@ -81,47 +83,47 @@ namespace lms::recommendation
 
     TrackResults RecommendationService::findSimilarTracks(db::TrackListId trackListId, std::size_t maxCount) const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        if (!lock || !_engine)
+        const auto engine{ getEngine() };
+        if (!engine)
             return {};
 
-        return _engine->findSimilarTracksFromTrackList(trackListId, maxCount);
+        return engine->findSimilarTracksFromTrackList(trackListId, maxCount);
     }
 
     TrackResults RecommendationService::findSimilarTracks(std::span<const db::TrackId> trackIds, std::size_t maxCount) const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        if (!lock || !_engine)
+        const auto engine{ getEngine() };
+        if (!engine)
             return {};
 
-        return _engine->findSimilarTracks(trackIds, maxCount);
+        return engine->findSimilarTracks(trackIds, maxCount);
     }
 
     ReleaseResults RecommendationService::findSimilarReleases(db::ReleaseId releaseId, std::size_t maxCount) const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        if (!lock || !_engine)
+        const auto engine{ getEngine() };
+        if (!engine)
             return {};
 
-        return _engine->findSimilarReleases(releaseId, maxCount);
+        return engine->findSimilarReleases(releaseId, maxCount);
     }
 
     ArtistResults RecommendationService::findSimilarArtists(db::ArtistId artistId, core::EnumSet<db::TrackArtistLinkType> linkTypes, std::size_t maxCount) const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        if (!lock || !_engine)
+        const auto engine{ getEngine() };
+        if (!engine)
             return {};
 
-        return _engine->findSimilarArtists(artistId, linkTypes, maxCount);
+        return engine->findSimilarArtists(artistId, linkTypes, maxCount);
     }
 
     TrackResults RecommendationService::findTrackSimilarityPath(db::TrackId startTrackId, db::TrackId endTrackId, std::size_t maxCount) const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        if (!lock || !_engine)
+        const auto engine{ getEngine() };
+        if (!engine)
             return {};
 
-        return _engine->findTrackSimilarityPath(startTrackId, endTrackId, maxCount);
+        return engine->findTrackSimilarityPath(startTrackId, endTrackId, maxCount);
     }
 
     bool RecommendationService::isEngineTypeSupported(EngineType type) const
@@ -139,13 +141,10 @@ namespace lms::recommendation
         return false;
     }
 
-    db::ScanSettings::RecommendationEngineType RecommendationService::prepareReload()
+    std::shared_ptr<const IEngine> RecommendationService::getEngine() const
     {
-        const auto type{ getRecommendationEngineType(_db.getTLSSession()) };
-        std::unique_lock lock{ _mutex };
-        _engineType = toEngineType(type);
-        _engine.reset();
-        return type;
+        std::shared_lock lock{ _mutex };
+        return _engine;
     }
 
     EngineType RecommendationService::getEngineType() const
@@ -156,22 +155,49 @@ namespace lms::recommendation
 
     void RecommendationService::requestReload()
     {
-        const auto type{ prepareReload() };
+        const auto type{ getRecommendationEngineType(_db.getTLSSession()) };
+        {
+            std::unique_lock lock{ _mutex };
+            if (_engineType != toEngineType(type))
+            {
+                // an engine cannot be updated to another type
+                _engineType = toEngineType(type);
+                _engine.reset();
+            }
+        }
 
         boost::asio::post(_ioContext, [this, type] {
-            auto newEngine{ createEngine(type, _db) };
-            if (!newEngine)
-                return;
-            newEngine->load();
+            std::shared_ptr<const IEngine> currentEngine;
+            {
+                std::shared_lock lock{ _mutex };
+                if (_engineType != toEngineType(type))
+                    return; // superseded by a later request
+
+                currentEngine = _engine;
+            }
+
+            // the current engine keeps on serving requests until the new one is ready
+            std::unique_ptr<IEngine> newEngine;
+            if (currentEngine)
+            {
+                newEngine = currentEngine->createUpdatedEngine();
+            }
+            else
+            {
+                newEngine = createEngine(type, _db, _cachePath);
+                if (!newEngine)
+                    return;
+                newEngine->load();
+            }
 
             std::unique_lock lock{ _mutex };
-            _engine = std::move(newEngine);
+            if (_engineType == toEngineType(type))
+                _engine = std::move(newEngine); // the previous engine is released by currentEngine, outside the lock
         });
     }
 
     bool RecommendationService::isLoaded() const
     {
-        std::shared_lock lock{ _mutex, std::try_to_lock };
-        return lock && _engine != nullptr;
+        return getEngine() != nullptr;
     }
 } // namespace lms::recommendation
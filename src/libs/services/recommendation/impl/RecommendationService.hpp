@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <shared_mutex>
 
@@ -26,7 +27,6 @@
 
 #include "core/IOContextRunner.hpp"
 
-#include "database/objects/ScanSettings.hpp"
 #include "services/recommendation/IRecommendationService.hpp"
 
 #include "IEngine.hpp"
@@ -41,7 +41,7 @@ namespace lms::recommendation
     class RecommendationService : public IRecommendationService
     {
     public:
-        RecommendationService(db::IDb& db);
+        RecommendationService(db::IDb& db, const std::filesystem::path& cachePath);
         ~RecommendationService() override = default;
         RecommendationService(const RecommendationService&) = delete;
         RecommendationService& operator=(const RecommendationService&) = delete;
@@ -59,12 +59,13 @@ namespace lms::recommendation
         ArtistResults findSimilarArtists(db::ArtistId artistId, core::EnumSet<db::TrackArtistLinkType> linkTypes, std::size_t maxCount) const override;
         TrackResults findTrackSimilarityPath(db::TrackId startTrackId, db::TrackId endTrackId, std::size_t maxCount) const override;
 
-        db::ScanSettings::RecommendationEngineType prepareReload();
+        std::shared_ptr<const IEngine> getEngine() const;
 
         db::IDb& _db;
+        const std::filesystem::path _cachePath;
         mutable std::shared_mutex _mutex;
         EngineType _engineType{ EngineType::None };
-        std::unique_ptr<IEngine> _engine;
+        std::shared_ptr<const IEngine> _engine; // swapped once a new engine is ready, in-flight requests keep the previous one alive
         boost::asio::io_context _ioContext;
         core::IOContextRunner _ioContextRunner;
     };
@@ -19,18 +19,27 @@
 
 #pragma once
 
-#include <functional>
-#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "database/Object.hpp"
 #include "database/objects/ArtistId.hpp"
 #include "database/objects/ReleaseId.hpp"
 #include "database/objects/TrackId.hpp"
+#include "math/HnswIndex.hpp"
 #include "math/Vector.hpp"
 
 #include "AudioVectorProvider.hpp"
 #include "IEngine.hpp"
+#include "ProfileVectorStore.hpp"
+#include "TrackVectorStore.hpp"
 #include "Types.hpp"
 #include "track-selection-constraints/TrackCandidateEvaluator.hpp"
 #include "track-selection-constraints/TrackMetadata.hpp"
@@ -41,7 +50,7 @@ namespace lms::recommendation
     class AudioSimilarityEngine : public IEngine
     {
     public:
-        AudioSimilarityEngine(db::IDb& db);
+        AudioSimilarityEngine(db::IDb& db, const std::filesystem::path& cachePath);
         ~AudioSimilarityEngine() override;
 
         AudioSimilarityEngine(const AudioSimilarityEngine&) = delete;
@@ -49,10 +58,26 @@ namespace lms::recommendation
 
     private:
         using SourceVector = typename Provider::Vector;
+        using VectorVersion = typename Provider::VectorVersion;
         using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
+        using TrackIndex = typename TrackVectorStore<ReducedDimCount>::Index;
+        using NearestNeighborIndex = math::HnswIndex<ReducedDimCount, FloatType>;
         static inline constexpr std::size_t SourceDimCount{ SourceVector::getSize() };
 
+        // to be bumped each time what is saved in the snapshot, or the way it is computed, changes
+        static constexpr std::uint32_t snapshotFileMagic{ 0x4E534153 };
+        static constexpr std::uint32_t snapshotFileVersion{ 4 };
+
+        struct NearestNeighborIndexSettings
+        {
+            std::size_t minTrackCount{ 20'000 }; // smaller collections are searched exhaustively
+            std::size_t maxNeighborCount{ 16 };
+            std::size_t buildCandidateCount{ 100 };
+            std::size_t searchCandidateCount{ 128 }; // recall/latency trade-off
+        };
+
         void load() override;
+        std::unique_ptr<IEngine> createUpdatedEngine() const override;
 
         TrackResults findSimilarTracksFromTrackList(db::TrackListId tracklistId, std::size_t maxCount) const override;
         TrackResults findSimilarTracks(std::span<const db::TrackId> tracksId, std::size_t maxCount) const override;
@@ -62,19 +87,52 @@ namespace lms::recommendation
 
         void initializeConstraints();
 
+        // Database content a snapshot is computed from
+        struct SnapshotKey
+        {
+            std::string databaseId; // databases sharing the same cache directory must not load each other's snapshot
+            std::uint64_t scanGeneration{};
+        };
+        SnapshotKey getSnapshotKey() const;
+        bool loadSnapshot(const SnapshotKey& snapshotKey);
+        bool doLoadSnapshot(std::istream& is, const SnapshotKey& snapshotKey);
+        void saveSnapshot(const SnapshotKey& snapshotKey) const;
+        void doSaveSnapshot(std::ostream& os, const SnapshotKey& snapshotKey) const;
+
+        bool update(const AudioSimilarityEngine& previous);
         void computeDatasetStats();
         void computeReducedFeatures();
+        void computeProfiles(db::Session& session, const AudioSimilarityEngine* previous, std::span<const std::optional<TrackIndex>> previousTrackRows);
+        template<typename IdType>
+        void addProfile(ProfileVectorStore<IdType, ReducedDimCount>& profiles, IdType id, std::span<const TrackIndex> rows, const ProfileVectorStore<IdType, ReducedDimCount>* previousProfiles) const;
         void computeTrackDistanceThreshold();
         void computeReleaseDistanceThreshold();
         void computeArtistDistanceThreshold();
+        template<typename IdType>
+        static FloatType computeProfileDistanceThreshold(const TrackVectorStore<ReducedDimCount>& trackVectors, const ProfileVectorStore<IdType, ReducedDimCount>& profiles, std::string_view profileType);
+        void loadNearestNeighborIndex();
+        void updateNearestNeighborIndex(const AudioSimilarityEngine& previous, std::span<const std::optional<TrackIndex>> previousTrackRows);
+        typename NearestNeighborIndex::BuildParameters getNearestNeighborIndexBuildParameters() const;
+        void saveNearestNeighborIndex(std::uint64_t key) const;
+        std::uint64_t computeNearestNeighborIndexKey(const typename NearestNeighborIndex::BuildParameters& params) const;
+
+        template<typename IdType>
+        static ResultContainer<IdType> findSimilarProfiles(const TrackVectorStore<ReducedDimCount>& trackVectors, const ProfileVectorStore<IdType, ReducedDimCount>& profiles, IdType id, FloatType distanceThreshold, std::size_t maxCount);
+
+        // Nearest tracks of the query vector (expected to be normalized), closest first
+        TrackResults findNearestTracks(const ReducedVector& queryVector, std::size_t maxCount, std::span<const db::TrackId> excludedTrackIds) const;
 
         void getReducedVector(const SourceVector& sourceVector, ReducedVector& output) const;
         void projectToReduced(const SourceVector& sourceVectorCentered, ReducedVector& output) const;
 
         db::IDb& _db;
+        const std::filesystem::path _cachePath;
+        NearestNeighborIndexSettings _nearestNeighborIndexSettings;
+        std::size_t _maxDriftPercent{ 20 }; // refit the PCA once the vectors added and removed since the fit exceed this ratio of the fitted tracks
 
         // Stats, used to normalize input data
         std::size_t _trackCount{};
+        std::size_t _driftedTrackCount{}; // vectors added or removed since the stats were computed, a changed vector counts twice
         SourceVector _sourceMeans;
 
         // PCA basis: top pcaDimCount eigenvectors (rows) and whitening scales
@@ -83,12 +141,11 @@ namespace lms::recommendation
         bool _pcaReady{};
 
         // In-memory cache of reduced feature vectors
-        std::vector<ReducedVector> _vectors;
-        std::unordered_map<db::TrackId, const ReducedVector*> _trackVectors;
-        std::unordered_map<db::ReleaseId, std::vector<std::reference_wrapper<const ReducedVector>>> _releaseVectors;
-        std::unordered_map<db::ReleaseId, const ReducedVector*> _releaseMedoids;
-        std::unordered_map<db::ArtistId, std::vector<std::reference_wrapper<const ReducedVector>>> _artistVectors;
-        std::unordered_map<db::ArtistId, const ReducedVector*> _artistMedoids;
+        TrackVectorStore<ReducedDimCount> _trackVectors;
+        std::vector<VectorVersion> _trackVectorVersions; // indexed by _trackVectors rows
+        NearestNeighborIndex _nearestNeighborIndex; // over _trackVectors, empty if not used
+        ProfileVectorStore<db::ReleaseId, ReducedDimCount> _releaseVectors;
+        ProfileVectorStore<db::ArtistId, ReducedDimCount> _artistVectors;
         TrackMetadataMap _trackMetadata;
 
         FloatType _trackDistanceThreshold{};
@@ -23,26 +23,34 @@
 
 #include <algorithm>
 #include <array>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
+#include "core/IConfig.hpp"
 #include "core/ILogger.hpp"
 #include "core/ITraceLogger.hpp"
 #include "core/Random.hpp"
+#include "core/Service.hpp"
+#include "core/XxHash3.hpp"
 
 #include "database/IDb.hpp"
 #include "database/Session.hpp"
 #include "database/objects/Artist.hpp"
-#include "database/objects/Release.hpp"
 #include "database/objects/ReleaseArtistLink.hpp"
+#include "database/objects/ScanSettings.hpp"
 #include "database/objects/Track.hpp"
 #include "database/objects/TrackArtistLink.hpp"
 #include "database/objects/TrackList.hpp"
 #include "database/objects/TrackMusicNNEmbeddings.hpp"
-#include "math/ChamferDistance.hpp"
+#include "math/BatchedDistance.hpp"
+#include "math/BinaryIO.hpp"
 #include "math/CovarianceCalculator.hpp"
 #include "math/MedoidCalculator.hpp"
 #include "math/NormalizedCosineDistance.hpp"
@@ -63,47 +71,21 @@
 
 namespace lms::recommendation
 {
-    namespace detail
-    {
-        template<typename ReducedVector>
-        TrackResults findNearestNeighbors(
-            const ReducedVector& queryVector, // expected to be normalized
-            const std::unordered_map<db::TrackId, const ReducedVector*>& trackVectors,
-            std::size_t maxNeighbors,
-            db::TrackId excludeTrackId)
-        {
-            const math::NormalizedCosineDistance distFunc{ queryVector };
-
-            TrackResults neighbors;
-            neighbors.reserve(trackVectors.size());
-
-            for (const auto& [trackId, trackVector] : trackVectors)
-            {
-                if (trackId == excludeTrackId)
-                    continue;
-
-                neighbors.push_back({ .id = trackId, .distance = distFunc(*trackVector) });
-            }
-
-            maxNeighbors = std::min(maxNeighbors, neighbors.size());
-            if (maxNeighbors == 0)
-                return {};
-
-            std::nth_element(neighbors.begin(), neighbors.begin() + static_cast<std::ptrdiff_t>(maxNeighbors), neighbors.end(), [](const auto& lhs, const auto& rhs) {
-                return lhs.distance < rhs.distance;
-            });
-            neighbors.resize(maxNeighbors);
-            std::sort(neighbors.begin(), neighbors.end(), [](const auto& lhs, const auto& rhs) {
-                return lhs.distance < rhs.distance;
-            });
-            return neighbors;
-        }
-    } // namespace detail
-
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
-    AudioSimilarityEngine<Provider, ReducedDimCount>::AudioSimilarityEngine(db::IDb& db)
+    AudioSimilarityEngine<Provider, ReducedDimCount>::AudioSimilarityEngine(db::IDb& db, const std::filesystem::path& cachePath)
         : _db{ db }
+        , _cachePath{ cachePath }
     {
+        if (core::IConfig* config{ core::Service<core::IConfig>::get() })
+        {
+            NearestNeighborIndexSettings& settings{ _nearestNeighborIndexSettings };
+            settings.minTrackCount = config->getULong("recommendation-ann-min-track-count", settings.minTrackCount);
+            settings.maxNeighborCount = config->getULong("recommendation-ann-max-neighbor-count", settings.maxNeighborCount);
+            settings.buildCandidateCount = config->getULong("recommendation-ann-build-candidate-count", settings.buildCandidateCount);
+            settings.searchCandidateCount = config->getULong("recommendation-ann-search-candidate-count", settings.searchCandidateCount);
+
+            _maxDriftPercent = config->getULong("recommendation-pca-max-drift-percent", _maxDriftPercent);
+        }
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
@@ -176,38 +158,18 @@ namespace lms::recommendation
         math::MedoidCalculator<ReducedVector> medoidCalculator;
         for (const db::TrackId trackId : tracksId)
         {
-            const auto it{ _trackVectors.find(trackId) };
-            if (it == _trackVectors.cend())
-                continue;
-
-            medoidCalculator.add(*it->second);
+            if (const ReducedVector * trackVector{ _trackVectors.find(trackId) })
+                medoidCalculator.add(*trackVector);
         }
 
         if (medoidCalculator.empty())
             return res;
 
         const ReducedVector& queryVector{ *medoidCalculator.finalize() };
-        const math::NormalizedCosineDistance distFunc{ queryVector };
-
-        using Distance = float;
-        std::vector<std::pair<db::TrackId, Distance>> rankedTracks;
-        rankedTracks.reserve(_trackVectors.size());
-
-        for (const auto& [trackId, vectors] : _trackVectors)
-        {
-            if (std::find(std::cbegin(tracksId), std::cend(tracksId), trackId) != std::cend(tracksId))
-                continue;
-
-            rankedTracks.emplace_back(trackId, distFunc(*vectors));
-        }
 
         // Oversample to give the diversity selection enough candidates to work with
         static constexpr std::size_t oversamplingFactor{ 5 };
-        const std::size_t candidateCount{ std::min(maxCount * oversamplingFactor, rankedTracks.size()) };
-        std::partial_sort(std::begin(rankedTracks), std::next(std::begin(rankedTracks), static_cast<std::ptrdiff_t>(candidateCount)), std::end(rankedTracks), [](const auto& lhs, const auto& rhs) {
-            return lhs.second < rhs.second;
-        });
-        rankedTracks.resize(candidateCount);
+        TrackResults rankedTracks{ findNearestTracks(queryVector, maxCount * oversamplingFactor, tracksId) };
 
         // Greedy selection: at each step pick the candidate with the lowest penalized score.
         // Pre-seed selectedTracks with the input tracks so that soft constraints (same release,
@@ -224,7 +186,7 @@ namespace lms::recommendation
 
             for (std::size_t i{}; i < rankedTracks.size(); ++i)
             {
-                const db::TrackId candidateId{ rankedTracks[i].first };
+                const db::TrackId candidateId{ rankedTracks[i].id };
 
                 const TrackCandidateContext context{
                     .candidateTrackId = candidateId,
@@ -246,9 +208,8 @@ namespace lms::recommendation
             if (!bestIdx)
                 break;
 
-            const auto& [selectedId, distanceToQuery]{ rankedTracks[*bestIdx] };
-            res.push_back({ .id = selectedId, .distance = distanceToQuery });
-            selectedTracks.push_back(selectedId);
+            res.push_back(rankedTracks[*bestIdx]);
+            selectedTracks.push_back(rankedTracks[*bestIdx].id);
             rankedTracks.erase(std::begin(rankedTracks) + static_cast<std::ptrdiff_t>(*bestIdx));
         }
 
@@ -263,13 +224,13 @@ namespace lms::recommendation
         if (maxCount == 0)
             return {};
 
-        const auto itStart{ _trackVectors.find(startTrackId) };
-        const auto itEnd{ _trackVectors.find(endTrackId) };
-        if (itStart == _trackVectors.cend() || itEnd == _trackVectors.cend())
+        const ReducedVector* startTrackVector{ _trackVectors.find(startTrackId) };
+        const ReducedVector* endTrackVector{ _trackVectors.find(endTrackId) };
+        if (!startTrackVector || !endTrackVector)
             return {};
 
-        const ReducedVector startVector{ *itStart->second };
-        const ReducedVector endVector{ *itEnd->second };
+        const ReducedVector startVector{ *startTrackVector };
+        const ReducedVector endVector{ *endTrackVector };
         const ReducedVector direction{ endVector - startVector };
 
         std::vector<db::TrackId> path;
@@ -285,7 +246,7 @@ namespace lms::recommendation
             auto queryPoint{ startVector + direction * t };
             queryPoint.normalizeL2();
 
-            const auto neighbors{ detail::findNearestNeighbors(queryPoint, _trackVectors, NeighborCount, endTrackId) };
+            const auto neighbors{ findNearestTracks(queryPoint, NeighborCount, std::span{ &endTrackId, 1 }) };
             const db::TrackId stepSeedTrackId{ neighbors.empty() ? startTrackId : neighbors[0].id };
             const std::array<db::TrackId, 1> stepSeedTrackIds{ stepSeedTrackId };
 
@@ -326,7 +287,8 @@ namespace lms::recommendation
         const math::NormalizedCosineDistance startDistFunc{ startVector };
         for (const db::TrackId trackId : path)
         {
-            const auto* trackVector{ _trackVectors.at(trackId) };
+            const ReducedVector* trackVector{ _trackVectors.find(trackId) };
+            assert(trackVector);
             results.push_back({ .id = trackId, .distance = startDistFunc(*trackVector) });
         }
 
@@ -338,133 +300,381 @@ namespace lms::recommendation
     {
         LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "Find similar releases");
 
-        ResultContainer<db::ReleaseId> res;
+        return findSimilarProfiles(_trackVectors, _releaseVectors, releaseId, _releaseDistanceThreshold, maxCount);
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    ArtistResults AudioSimilarityEngine<Provider, ReducedDimCount>::findSimilarArtists(db::ArtistId artistId, core::EnumSet<db::TrackArtistLinkType> linkTypes, std::size_t maxCount) const
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "Find similar artists");
+
+        if (!linkTypes.contains(db::TrackArtistLinkType::Artist))
+            return {};
+
+        return findSimilarProfiles(_trackVectors, _artistVectors, artistId, _artistDistanceThreshold, maxCount);
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    template<typename IdType>
+    ResultContainer<IdType> AudioSimilarityEngine<Provider, ReducedDimCount>::findSimilarProfiles(const TrackVectorStore<ReducedDimCount>& trackVectors, const ProfileVectorStore<IdType, ReducedDimCount>& profiles, IdType id, FloatType distanceThreshold, std::size_t maxCount)
+    {
+        using ProfileIndex = typename ProfileVectorStore<IdType, ReducedDimCount>::Index;
+
+        ResultContainer<IdType> res;
         if (maxCount == 0)
             return res;
 
-        const auto itQueryRelease{ _releaseVectors.find(releaseId) };
-        if (itQueryRelease == _releaseVectors.cend() || itQueryRelease->second.empty())
+        const std::optional<ProfileIndex> queryIndex{ profiles.findIndex(id) };
+        if (!queryIndex)
             return res;
 
-        const auto& queryReleaseFeatures{ itQueryRelease->second };
-
-        using Distance = float;
-        using CosineDistance = math::NormalizedCosineDistance<ReducedVector::getSize(), FloatType>;
-
         // Stage 1: fast medoid scan to get top candidates
         constexpr std::size_t preFilterMultiplier{ 10 };
         constexpr std::size_t preFilterMinCount{ 50 };
-        const std::size_t preFilterCount{ std::min(_releaseMedoids.size() - 1, std::max(preFilterMinCount, maxCount * preFilterMultiplier)) };
+        const std::size_t preFilterCount{ std::min(profiles.size() - 1, std::max(preFilterMinCount, maxCount * preFilterMultiplier)) };
 
-        const math::NormalizedCosineDistance queryMedoidDist{ *_releaseMedoids.at(releaseId) };
-        std::vector<std::pair<db::ReleaseId, FloatType>> medoidCandidates;
-        medoidCandidates.reserve(_releaseMedoids.size());
-        for (const auto& [candidateId, medoid] : _releaseMedoids)
+        std::vector<FloatType> medoidDistances(profiles.size());
+        math::computeNormalizedCosineDistances(profiles.getMedoid(*queryIndex), profiles.getMedoids(), medoidDistances);
+
+        std::vector<std::pair<ProfileIndex, FloatType>> medoidCandidates;
+        medoidCandidates.reserve(profiles.size());
+        for (std::size_t i{}; i < medoidDistances.size(); ++i)
         {
-            if (candidateId != releaseId)
-                medoidCandidates.emplace_back(candidateId, queryMedoidDist(*medoid));
+            if (i != *queryIndex)
+                medoidCandidates.emplace_back(static_cast<ProfileIndex>(i), medoidDistances[i]);
         }
         std::nth_element(medoidCandidates.begin(), std::next(medoidCandidates.begin(), preFilterCount), medoidCandidates.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
         medoidCandidates.resize(preFilterCount);
 
         // Stage 2: Chamfer re-rank on top candidates
-        std::vector<std::pair<db::ReleaseId, Distance>> rankedReleases;
-        rankedReleases.reserve(preFilterCount);
-        for (const auto& [candidateId, _] : medoidCandidates)
+        const auto trackRows{ trackVectors.getVectors().getView() };
+        const auto queryTrackRows{ profiles.getTrackRows(*queryIndex) };
+        std::vector<std::pair<IdType, FloatType>> rankedProfiles;
+        rankedProfiles.reserve(preFilterCount);
+        for (const auto& [candidateIndex, _] : medoidCandidates)
         {
-            const FloatType distance{ math::symmetricalChamferDistance<CosineDistance>(queryReleaseFeatures, _releaseVectors.at(candidateId)) };
+            const FloatType distance{ math::computeSymmetricalNormalizedCosineChamferDistance(trackRows, queryTrackRows, profiles.getTrackRows(candidateIndex)) };
 
-            if (distance <= _releaseDistanceThreshold)
-                rankedReleases.emplace_back(candidateId, distance);
+            if (distance <= distanceThreshold)
+                rankedProfiles.emplace_back(profiles.getId(candidateIndex), distance);
         }
 
-        const std::size_t resultCount{ std::min(maxCount, rankedReleases.size()) };
-        std::partial_sort(std::begin(rankedReleases), std::next(std::begin(rankedReleases), static_cast<std::ptrdiff_t>(resultCount)), std::end(rankedReleases), [](const auto& lhs, const auto& rhs) {
+        const std::size_t resultCount{ std::min(maxCount, rankedProfiles.size()) };
+        std::partial_sort(std::begin(rankedProfiles), std::next(std::begin(rankedProfiles), static_cast<std::ptrdiff_t>(resultCount)), std::end(rankedProfiles), [](const auto& lhs, const auto& rhs) {
             return lhs.second < rhs.second;
         });
 
         res.reserve(resultCount);
         for (std::size_t i{}; i < resultCount; ++i)
-            res.push_back({ .id = rankedReleases[i].first, .distance = rankedReleases[i].second });
+            res.push_back({ .id = rankedProfiles[i].first, .distance = rankedProfiles[i].second });
 
         return res;
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
-    ArtistResults AudioSimilarityEngine<Provider, ReducedDimCount>::findSimilarArtists(db::ArtistId artistId, core::EnumSet<db::TrackArtistLinkType> linkTypes, std::size_t maxCount) const
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::load()
     {
-        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "Find similar artists");
+        LMS_SCOPED_TRACE_OVERVIEW("AudioSimilarityEngine", "Loading");
 
-        ArtistResults res;
-        if (maxCount == 0)
-            return res;
+        LOG(INFO, "loading...");
 
-        if (!linkTypes.contains(db::TrackArtistLinkType::Artist))
-            return res;
+        // read before the data, so that a snapshot of data changed by a concurrent scan is saved with an outdated generation
+        const SnapshotKey snapshotKey{ getSnapshotKey() };
+        if (!loadSnapshot(snapshotKey))
+        {
+            computeDatasetStats();
+            computeReducedFeatures();
+            computeTrackDistanceThreshold();
+            computeReleaseDistanceThreshold();
+            computeArtistDistanceThreshold();
+            saveSnapshot(snapshotKey);
+        }
+        loadNearestNeighborIndex();
+        initializeConstraints();
 
-        const auto itQueryArtist{ _artistVectors.find(artistId) };
-        if (itQueryArtist == _artistVectors.cend() || itQueryArtist->second.empty())
-            return res;
+        LOG(INFO, "loading complete!");
+    }
 
-        const auto& queryArtistFeatures{ itQueryArtist->second };
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    std::unique_ptr<IEngine> AudioSimilarityEngine<Provider, ReducedDimCount>::createUpdatedEngine() const
+    {
+        LMS_SCOPED_TRACE_OVERVIEW("AudioSimilarityEngine", "Updating");
 
-        using Distance = float;
-        using CosineDistance = math::NormalizedCosineDistance<ReducedVector::getSize(), typename ReducedVector::value_type>;
+        auto engine{ std::make_unique<AudioSimilarityEngine>(_db, _cachePath) };
+        if (!engine->update(*this))
+            engine->load();
 
-        // Stage 1: fast medoid scan to get top-K candidates
-        constexpr std::size_t preFilterMultiplier{ 10 };
-        constexpr std::size_t preFilterMinCount{ 50 };
-        const std::size_t preFilterCount{ std::min(_artistMedoids.size() - 1, std::max(preFilterMinCount, maxCount * preFilterMultiplier)) };
+        return engine;
+    }
+
+    // Projects the new and changed vectors using the PCA of previous, reuses everything else
+    // Returns false if a full load is required instead
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    bool AudioSimilarityEngine<Provider, ReducedDimCount>::update(const AudioSimilarityEngine& previous)
+    {
+        if (!previous._pcaReady || previous._trackCount == 0)
+            return false;
+
+        LOG(INFO, "updating...");
 
-        const math::NormalizedCosineDistance queryMedoidDist{ *_artistMedoids.at(artistId) };
-        std::vector<std::pair<db::ArtistId, FloatType>> medoidCandidates;
-        medoidCandidates.reserve(_artistMedoids.size());
-        for (const auto& [candidateId, medoid] : _artistMedoids)
+        // read before the data, see load()
+        const SnapshotKey snapshotKey{ getSnapshotKey() };
+
+        db::Session& session{ _db.getTLSSession() };
+
+        std::vector<std::pair<db::TrackId, VectorVersion>> trackVectorVersions;
+        trackVectorVersions.reserve(previous._trackVectors.size());
         {
-            if (candidateId != artistId)
-                medoidCandidates.emplace_back(candidateId, queryMedoidDist(*medoid));
+            auto transaction{ session.createReadTransaction() };
+
+            Provider::visitVectorVersions(session, [&](db::TrackId trackId, VectorVersion version) {
+                trackVectorVersions.emplace_back(trackId, version);
+            });
         }
-        std::nth_element(medoidCandidates.begin(), std::next(medoidCandidates.begin(), preFilterCount), medoidCandidates.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
-        medoidCandidates.resize(preFilterCount);
 
-        // Stage 2: Chamfer re-rank on top-K candidates
-        std::vector<std::pair<db::ArtistId, Distance>> rankedArtists;
-        rankedArtists.reserve(preFilterCount);
-        for (const auto& [candidateId, _] : medoidCandidates)
+        auto findReusableRow{ [&](db::TrackId trackId, VectorVersion version) -> std::optional<TrackIndex> {
+            const std::optional<TrackIndex> row{ previous._trackVectors.findIndex(trackId) };
+            if (!row || previous._trackVectorVersions[*row] != version)
+                return std::nullopt;
+            return row;
+        } };
+
+        const std::size_t reusedTrackCount{ static_cast<std::size_t>(std::count_if(std::cbegin(trackVectorVersions), std::cend(trackVectorVersions), [&](const auto& trackVectorVersion) {
+            return findReusableRow(trackVectorVersion.first, trackVectorVersion.second).has_value();
+        })) };
+        const std::size_t addedTrackCount{ trackVectorVersions.size() - reusedTrackCount };
+        const std::size_t removedTrackCount{ previous._trackVectors.size() - reusedTrackCount };
+
+        const std::size_t driftedTrackCount{ previous._driftedTrackCount + addedTrackCount + removedTrackCount };
+        if (driftedTrackCount * 100 > previous._trackCount * _maxDriftPercent)
         {
-            const FloatType distance{ math::symmetricalChamferDistance<CosineDistance>(queryArtistFeatures, _artistVectors.at(candidateId)) };
+            LOG(INFO, "too many changes since the last fit (" << driftedTrackCount << " added or removed vectors for " << previous._trackCount << " fitted tracks), recomputing everything");
+            return false;
+        }
+
+        _trackCount = previous._trackCount;
+        _driftedTrackCount = driftedTrackCount;
+        _sourceMeans = previous._sourceMeans;
+        _pcaBasis = previous._pcaBasis;
+        _pcaScale = previous._pcaScale;
+        _pcaReady = true;
+
+        _trackVectors.clear();
+        _trackVectors.reserve(trackVectorVersions.size());
+        _trackVectorVersions.clear();
+        _trackVectorVersions.reserve(trackVectorVersions.size());
+
+        std::vector<std::optional<TrackIndex>> previousTrackRows; // indexed by _trackVectors rows: row of the same vector in previous, if reused
+        previousTrackRows.reserve(trackVectorVersions.size());
+
+        {
+            // read after the versions: a vector changed in between is saved with its previous version, and is then refreshed by the next update
+            auto transaction{ session.createReadTransaction() };
+
+            SourceVector sourceVector;
+            ReducedVector reducedVector;
+            for (const auto& [trackId, version] : trackVectorVersions)
+            {
+                bool added{};
+                const std::optional<TrackIndex> previousRow{ findReusableRow(trackId, version) };
+                if (previousRow)
+                {
+                    added = _trackVectors.add(trackId, previous._trackVectors.getVector(*previousRow));
+                }
+                else if (Provider::getVector(session, trackId, sourceVector)) // may have been removed meanwhile
+                {
+                    getReducedVector(sourceVector, reducedVector);
+                    added = _trackVectors.add(trackId, reducedVector);
+                }
 
-            if (distance <= _artistDistanceThreshold)
-                rankedArtists.emplace_back(candidateId, distance);
+                if (added)
+                {
+                    _trackVectorVersions.push_back(version);
+                    previousTrackRows.push_back(previousRow);
+                }
+            }
+
+            computeProfiles(session, &previous, previousTrackRows);
         }
 
-        const std::size_t resultCount{ std::min(maxCount, rankedArtists.size()) };
-        std::partial_sort(std::begin(rankedArtists), std::next(std::begin(rankedArtists), resultCount), std::end(rankedArtists), [](const auto& lhs, const auto& rhs) {
-            return lhs.second < rhs.second;
-        });
+        // the distributions are not expected to move much until the next fit
+        _trackDistanceThreshold = previous._trackDistanceThreshold;
+        _releaseDistanceThreshold = previous._releaseDistanceThreshold;
+        _artistDistanceThreshold = previous._artistDistanceThreshold;
 
-        res.reserve(resultCount);
-        for (std::size_t i{}; i < resultCount; ++i)
-            res.push_back({ .id = rankedArtists[i].first, .distance = rankedArtists[i].second });
+        saveSnapshot(snapshotKey);
+        updateNearestNeighborIndex(previous, previousTrackRows);
+        initializeConstraints();
 
-        return res;
+        LOG(INFO, "update complete: " << reusedTrackCount << " reused vectors, " << addedTrackCount << " new or changed vectors, " << removedTrackCount << " removed or changed vectors");
+        return true;
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
-    void AudioSimilarityEngine<Provider, ReducedDimCount>::load()
+    typename AudioSimilarityEngine<Provider, ReducedDimCount>::SnapshotKey AudioSimilarityEngine<Provider, ReducedDimCount>::getSnapshotKey() const
     {
-        LMS_SCOPED_TRACE_OVERVIEW("AudioSimilarityEngine", "Loading");
+        db::Session& session{ _db.getTLSSession() };
+        auto transaction{ session.createReadTransaction() };
 
-        LOG(INFO, "loading...");
+        const db::ScanSettings::pointer scanSettings{ db::ScanSettings::find(session) };
+        return SnapshotKey{ .databaseId = std::string{ scanSettings->getDatabaseId() }, .scanGeneration = scanSettings->getScanGeneration() };
+    }
 
-        computeDatasetStats();
-        computeReducedFeatures();
-        computeTrackDistanceThreshold();
-        computeReleaseDistanceThreshold();
-        computeArtistDistanceThreshold();
-        initializeConstraints();
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    bool AudioSimilarityEngine<Provider, ReducedDimCount>::loadSnapshot(const SnapshotKey& snapshotKey)
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "LoadSnapshot");
 
-        LOG(INFO, "loading complete!");
+        if (_cachePath.empty())
+            return false;
+
+        const std::filesystem::path snapshotFilePath{ _cachePath / "audio-similarity.snapshot" };
+        std::ifstream is{ snapshotFilePath, std::ios::binary };
+        if (!is)
+            return false;
+
+        if (!doLoadSnapshot(is, snapshotKey))
+        {
+            LOG(INFO, "snapshot " << snapshotFilePath << " is outdated or invalid, recomputing everything");
+
+            _pcaReady = false;
+            _trackCount = 0;
+            _driftedTrackCount = 0;
+            _trackVectors.clear();
+            _trackVectorVersions.clear();
+            _releaseVectors.clear();
+            _artistVectors.clear();
+            _trackMetadata.clear();
+            return false;
+        }
+
+        LOG(INFO, "loaded snapshot from " << snapshotFilePath << ": " << _trackVectors.size() << " tracks, " << _releaseVectors.size() << " releases, " << _artistVectors.size() << " artists");
+        return true;
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    bool AudioSimilarityEngine<Provider, ReducedDimCount>::doLoadSnapshot(std::istream& is, const SnapshotKey& snapshotKey)
+    {
+        using namespace math::binaryIO;
+
+        std::uint32_t magic{};
+        std::uint32_t version{};
+        std::uint32_t sourceDimCount{};
+        std::uint32_t reducedDimCount{};
+        std::uint32_t floatSize{};
+        if (!readValue(is, magic) || !readValue(is, version) || !readValue(is, sourceDimCount) || !readValue(is, reducedDimCount) || !readValue(is, floatSize))
+            return false;
+
+        if (magic != snapshotFileMagic || version != snapshotFileVersion || sourceDimCount != SourceDimCount || reducedDimCount != ReducedDimCount || floatSize != sizeof(FloatType))
+            return false;
+
+        // checked before reading anything else: the snapshot may come from another database
+        std::uint32_t databaseIdSize{};
+        if (!readValue(is, databaseIdSize) || databaseIdSize != snapshotKey.databaseId.size())
+            return false;
+        std::string savedDatabaseId(databaseIdSize, '\0');
+        std::uint64_t savedScanGeneration{};
+        if (!readValues(is, std::span{ savedDatabaseId }) || !readValue(is, savedScanGeneration))
+            return false;
+        if (savedDatabaseId != snapshotKey.databaseId || savedScanGeneration != snapshotKey.scanGeneration)
+            return false;
+
+        std::uint64_t trackCount{};
+        std::uint64_t driftedTrackCount{};
+        if (!readValue(is, trackCount) || !readValue(is, driftedTrackCount) || !readValue(is, _sourceMeans) || !readValue(is, _pcaBasis) || !readValue(is, _pcaScale))
+            return false;
+        _trackCount = trackCount;
+        _driftedTrackCount = driftedTrackCount;
+
+        if (!readValue(is, _trackDistanceThreshold) || !readValue(is, _releaseDistanceThreshold) || !readValue(is, _artistDistanceThreshold))
+            return false;
+
+        if (!_trackVectors.load(is))
+            return false;
+
+        _trackVectorVersions.resize(_trackVectors.size());
+        if (!readValues(is, std::span{ _trackVectorVersions }))
+            return false;
+
+        if (!_releaseVectors.load(is, _trackVectors.size()) || !_artistVectors.load(is, _trackVectors.size()))
+            return false;
+
+        std::uint64_t metadataCount{};
+        if (!readValue(is, metadataCount) || metadataCount > _trackVectors.size())
+            return false;
+
+        _trackMetadata.clear();
+        _trackMetadata.reserve(metadataCount);
+        for (std::uint64_t i{}; i < metadataCount; ++i)
+        {
+            db::TrackId trackId;
+            TrackMetadata metadata;
+            std::uint32_t artistCount{};
+            if (!readValue(is, trackId) || !readValue(is, metadata.releaseId) || !readValue(is, artistCount) || artistCount > _artistVectors.size())
+                return false;
+
+            metadata.artistIds.resize(artistCount);
+            if (!readValues(is, std::span{ metadata.artistIds }))
+                return false;
+
+            _trackMetadata.emplace(trackId, std::move(metadata));
+        }
+
+        _pcaReady = true;
+        return true;
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::saveSnapshot(const SnapshotKey& snapshotKey) const
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "SaveSnapshot");
+
+        if (_cachePath.empty())
+            return;
+
+        const std::filesystem::path snapshotFilePath{ _cachePath / "audio-similarity.snapshot" };
+        const std::error_code ec{ math::binaryIO::writeFileAtomically(snapshotFilePath, [&](std::ostream& os) { doSaveSnapshot(os, snapshotKey); }) };
+        if (ec)
+            LOG(WARNING, "cannot save snapshot to " << snapshotFilePath << ": " << ec.message());
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::doSaveSnapshot(std::ostream& os, const SnapshotKey& snapshotKey) const
+    {
+        using namespace math::binaryIO;
+
+        writeValue(os, snapshotFileMagic);
+        writeValue(os, snapshotFileVersion);
+        writeValue(os, static_cast<std::uint32_t>(SourceDimCount));
+        writeValue(os, static_cast<std::uint32_t>(ReducedDimCount));
+        writeValue(os, static_cast<std::uint32_t>(sizeof(FloatType)));
+        writeValue(os, static_cast<std::uint32_t>(snapshotKey.databaseId.size()));
+        writeValues(os, std::span{ snapshotKey.databaseId });
+        writeValue(os, snapshotKey.scanGeneration);
+
+        writeValue(os, static_cast<std::uint64_t>(_trackCount));
+        writeValue(os, static_cast<std::uint64_t>(_driftedTrackCount));
+        writeValue(os, _sourceMeans);
+        writeValue(os, _pcaBasis);
+        writeValue(os, _pcaScale);
+
+        writeValue(os, _trackDistanceThreshold);
+        writeValue(os, _releaseDistanceThreshold);
+        writeValue(os, _artistDistanceThreshold);
+
+        _trackVectors.save(os);
+        writeValues(os, std::span{ _trackVectorVersions });
+        _releaseVectors.save(os);
+        _artistVectors.save(os);
+
+        writeValue(os, static_cast<std::uint64_t>(_trackMetadata.size()));
+        for (const auto& [trackId, metadata] : _trackMetadata)
+        {
+            writeValue(os, trackId);
+            writeValue(os, metadata.releaseId);
+            writeValue(os, static_cast<std::uint32_t>(metadata.artistIds.size()));
+            writeValues(os, std::span{ metadata.artistIds });
+        }
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
@@ -572,108 +782,309 @@ namespace lms::recommendation
         db::Session& session{ _db.getTLSSession() };
         auto transaction{ session.createReadTransaction() };
 
+        _driftedTrackCount = 0;
         _trackVectors.clear();
-        _vectors.clear();
-        _vectors.reserve(_trackCount); // must keep pointers valid
-        _releaseVectors.clear();
-        _releaseMedoids.clear();
-        _artistVectors.clear();
-        _artistMedoids.clear();
-        _trackMetadata.clear();
+        _trackVectors.reserve(_trackCount);
+        _trackVectorVersions.clear();
+        _trackVectorVersions.reserve(_trackCount);
+
+        // read before the vectors: a vector changed in between is saved with its previous version, and is then refreshed by the next update
+        std::unordered_map<db::TrackId, VectorVersion> trackVectorVersions;
+        trackVectorVersions.reserve(_trackCount);
+        Provider::visitVectorVersions(session, [&](db::TrackId trackId, VectorVersion version) {
+            trackVectorVersions.emplace(trackId, version);
+        });
 
         Provider::visitVectors(session, [&](db::TrackId trackId, const SourceVector& sourceVector) {
-            if (_vectors.size() >= _trackCount)
-                return; // more tracks appeared since computeDatasetStats(); skip to avoid reallocation (a further reload will include them)
-            auto& reducedVector{ _vectors.emplace_back() };
+            if (_trackVectors.contains(trackId))
+                return;
+
+            ReducedVector reducedVector;
             getReducedVector(sourceVector, reducedVector);
-            _trackVectors.try_emplace(trackId, &reducedVector);
+            _trackVectors.add(trackId, reducedVector);
+
+            const auto itVersion{ trackVectorVersions.find(trackId) };
+            _trackVectorVersions.push_back(itVersion != std::cend(trackVectorVersions) ? itVersion->second : VectorVersion{});
         });
 
-        db::Release::find(session, db::Release::FindParameters{}, [&](const db::Release::pointer& release) {
-            std::vector<std::reference_wrapper<const ReducedVector>> releaseTrackFeatures;
+        computeProfiles(session, nullptr, {});
+
+        LOG(INFO, "computed reduced vectors: " << _trackVectors.size() << " tracks, " << _releaseVectors.size() << " releases, " << _artistVectors.size() << " artists");
+    }
 
-            db::Track::FindParameters params;
-            params.setRelease(release->getId());
+    // Builds the release and artist profiles, along with the track metadata, from _trackVectors
+    // If previous is set, only the profiles linked to tracks that changed since previous are computed again, the medoids of the other ones are reused
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::computeProfiles(db::Session& session, const AudioSimilarityEngine* previous, std::span<const std::optional<TrackIndex>> previousTrackRows)
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "ComputeProfiles");
 
-            const auto trackIds{ db::Track::findIds(session, params) };
-            for (const db::TrackId trackId : trackIds.results)
+        _releaseVectors.clear();
+        _artistVectors.clear();
+        _trackMetadata.clear();
+
+        // rows of each release and of each artist, using a single query for all the tracks and another one for all the release artists
+        std::map<db::ReleaseId, std::vector<TrackIndex>> releaseRows;
+        db::Track::findReleaseIds(session, [&](db::TrackId trackId, db::ReleaseId releaseId) {
+            if (const auto row{ _trackVectors.findIndex(trackId) })
             {
-                const auto itFeatures{ _trackVectors.find(trackId) };
-                if (itFeatures != std::cend(_trackVectors))
-                {
-                    assert(itFeatures->second);
-                    releaseTrackFeatures.emplace_back(*itFeatures->second);
-                    _trackMetadata[trackId].releaseId = release->getId();
-                }
+                releaseRows[releaseId].push_back(*row);
+                _trackMetadata[trackId].releaseId = releaseId;
             }
-
-            if (!releaseTrackFeatures.empty())
-                _releaseVectors.try_emplace(release->getId(), std::move(releaseTrackFeatures));
         });
 
-        db::Artist::find(session, db::Artist::FindParameters{}, [&](const db::Artist::pointer& artist) {
-            const auto mbid{ artist->getMBID() };
-            // skip "Various Artists" to avoid false artist matches
-            if (mbid && mbid->getAsString() == "89ad4ac3-39f7-470e-963a-56509c546377")
+        // skip "Various Artists" to avoid false artist matches
+        db::ArtistId variousArtistsId;
+        if (const db::Artist::pointer variousArtists{ db::Artist::find(session, *core::UUID::fromString("89ad4ac3-39f7-470e-963a-56509c546377")) })
+            variousArtistsId = variousArtists->getId();
+
+        std::map<db::ArtistId, std::vector<TrackIndex>> artistRows;
+        db::ReleaseArtistLink::find(session, db::ReleaseArtistLink::FindParameters{}, [&](const db::ReleaseArtistLink::pointer& link) {
+            const auto itReleaseRows{ releaseRows.find(link->getReleaseId()) };
+            if (itReleaseRows == std::cend(releaseRows) || link->getArtistId() == variousArtistsId)
                 return;
 
-            std::unordered_set<db::TrackId> artistTrackIds;
+            std::vector<TrackIndex>& rows{ artistRows[link->getArtistId()] };
+            rows.insert(std::cend(rows), std::cbegin(itReleaseRows->second), std::cend(itReleaseRows->second));
+        });
+
+        // profile rows are sorted by track, and an artist may be linked several times to the same release
+        auto sortProfileRows{ [&](std::vector<TrackIndex>& rows) {
+            std::sort(std::begin(rows), std::end(rows), [&](TrackIndex lhs, TrackIndex rhs) { return _trackVectors.getTrackId(lhs) < _trackVectors.getTrackId(rhs); });
+            rows.erase(std::unique(std::begin(rows), std::end(rows)), std::end(rows));
+        } };
 
+        for (auto& [releaseId, rows] : releaseRows)
+            sortProfileRows(rows);
+
+        // artists are visited by id, so that the artistIds of each track end up sorted, for set-intersection in SameArtistConstraint
+        for (auto& [artistId, rows] : artistRows)
+        {
+            sortProfileRows(rows);
+            for (const TrackIndex row : rows)
+                _trackMetadata[_trackVectors.getTrackId(row)].artistIds.push_back(artistId);
+        }
+
+        // releases and artists linked to a track whose vector, release or artists changed, as they were in previous and as they are now
+        std::unordered_set<db::ReleaseId> changedReleaseIds;
+        std::unordered_set<db::ArtistId> changedArtistIds;
+        if (previous)
+        {
+            auto findTrackMetadata{ [](const TrackMetadataMap& trackMetadata, db::TrackId trackId) -> const TrackMetadata* {
+                const auto itMetadata{ trackMetadata.find(trackId) };
+                return itMetadata != std::cend(trackMetadata) ? &itMetadata->second : nullptr;
+            } };
+
+            auto addChangedTrack{ [&](const TrackMetadata* metadata) {
+                if (!metadata)
+                    return;
+
+                changedReleaseIds.insert(metadata->releaseId);
+                changedArtistIds.insert(std::cbegin(metadata->artistIds), std::cend(metadata->artistIds));
+            } };
+
+            std::vector<bool> isPreviousRowReused(previous->_trackVectors.size());
+            for (std::size_t row{}; row < _trackVectors.size(); ++row)
             {
-                db::Release::FindParameters params;
-                params.setArtist(artist->getId());
-                for (const db::ReleaseId releaseId : db::Release::findIds(session, params).results)
+                const db::TrackId trackId{ _trackVectors.getTrackId(static_cast<TrackIndex>(row)) };
+                const TrackMetadata* metadata{ findTrackMetadata(_trackMetadata, trackId) };
+                const TrackMetadata* previousMetadata{ findTrackMetadata(previous->_trackMetadata, trackId) };
+
+                const std::optional<TrackIndex> previousRow{ previousTrackRows[row] };
+                if (previousRow)
+                    isPreviousRowReused[*previousRow] = true;
+
+                const bool isSameMetadata{ (!metadata && !previousMetadata)
+                                           || (metadata && previousMetadata && metadata->releaseId == previousMetadata->releaseId && metadata->artistIds == previousMetadata->artistIds) };
+                if (!previousRow || !isSameMetadata)
                 {
-                    if (_releaseVectors.contains(releaseId))
-                    {
-                        db::Track::FindParameters trackParams;
-                        trackParams.setRelease(releaseId);
-                        for (const db::TrackId trackId : db::Track::findIds(session, trackParams).results)
-                            artistTrackIds.insert(trackId);
-                    }
+                    addChangedTrack(metadata);
+                    addChangedTrack(previousMetadata);
                 }
             }
 
-            // Build vectors from deduplicated track IDs
-            std::vector<std::reference_wrapper<const ReducedVector>> artistTrackVectors;
-            artistTrackVectors.reserve(artistTrackIds.size());
-            for (const db::TrackId trackId : artistTrackIds)
+            // tracks that are gone, or whose vector changed
+            for (std::size_t previousRow{}; previousRow < isPreviousRowReused.size(); ++previousRow)
             {
-                const auto it{ _trackVectors.find(trackId) };
-                if (it != std::cend(_trackVectors))
-                {
-                    assert(it->second);
-                    artistTrackVectors.emplace_back(*it->second);
-                    _trackMetadata[trackId].artistIds.push_back(artist->getId());
-                }
+                if (!isPreviousRowReused[previousRow])
+                    addChangedTrack(findTrackMetadata(previous->_trackMetadata, previous->_trackVectors.getTrackId(static_cast<TrackIndex>(previousRow))));
+            }
+
+            LOG(DEBUG, "computing the profiles of " << changedReleaseIds.size() << " releases and " << changedArtistIds.size() << " artists linked to changed tracks");
+        }
+
+        for (const auto& [releaseId, rows] : releaseRows)
+            addProfile(_releaseVectors, releaseId, rows, previous && !changedReleaseIds.contains(releaseId) ? &previous->_releaseVectors : nullptr);
+
+        for (const auto& [artistId, rows] : artistRows)
+            addProfile(_artistVectors, artistId, rows, previous && !changedArtistIds.contains(artistId) ? &previous->_artistVectors : nullptr);
+    }
+
+    // previousProfiles is only set if the profile is not linked to any changed track
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    template<typename IdType>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::addProfile(ProfileVectorStore<IdType, ReducedDimCount>& profiles, IdType id, std::span<const TrackIndex> rows, const ProfileVectorStore<IdType, ReducedDimCount>* previousProfiles) const
+    {
+        if (previousProfiles)
+        {
+            if (const auto previousIndex{ previousProfiles->findIndex(id) })
+            {
+                // same tracks, with the same vectors: no need to compute the medoid again
+                assert(previousProfiles->getTrackRows(*previousIndex).size() == rows.size());
+                profiles.add(id, rows, previousProfiles->getMedoid(*previousIndex));
+                return;
             }
+        }
+
+        profiles.add(id, _trackVectors, rows);
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    TrackResults AudioSimilarityEngine<Provider, ReducedDimCount>::findNearestTracks(const ReducedVector& queryVector, std::size_t maxCount, std::span<const db::TrackId> excludedTrackIds) const
+    {
+        auto isExcluded{ [&](db::TrackId trackId) {
+            return std::find(std::cbegin(excludedTrackIds), std::cend(excludedTrackIds), trackId) != std::cend(excludedTrackIds);
+        } };
+
+        TrackResults neighbors;
+
+        if (!_nearestNeighborIndex.empty())
+        {
+            // excluded tracks may be part of the results
+            for (const auto& neighbor : _nearestNeighborIndex.search(queryVector, maxCount + excludedTrackIds.size(), _nearestNeighborIndexSettings.searchCandidateCount))
+            {
+                const db::TrackId trackId{ _trackVectors.getTrackId(neighbor.index) };
+                if (!isExcluded(trackId))
+                    neighbors.push_back({ .id = trackId, .distance = neighbor.distance });
+            }
+
+            if (neighbors.size() > maxCount)
+                neighbors.resize(maxCount);
+
+            return neighbors;
+        }
 
-            if (!artistTrackVectors.empty())
-                _artistVectors.try_emplace(artist->getId(), std::move(artistTrackVectors));
+        std::vector<FloatType> distances(_trackVectors.size());
+        math::computeNormalizedCosineDistances(queryVector, _trackVectors.getVectors().getView(), distances);
+
+        const std::span<const db::TrackId> trackIds{ _trackVectors.getTrackIds() };
+        neighbors.reserve(trackIds.size());
+        for (std::size_t i{}; i < trackIds.size(); ++i)
+        {
+            if (!isExcluded(trackIds[i]))
+                neighbors.push_back({ .id = trackIds[i], .distance = distances[i] });
+        }
+
+        maxCount = std::min(maxCount, neighbors.size());
+        std::partial_sort(std::begin(neighbors), std::next(std::begin(neighbors), static_cast<std::ptrdiff_t>(maxCount)), std::end(neighbors), [](const auto& lhs, const auto& rhs) {
+            return lhs.distance < rhs.distance;
         });
+        neighbors.resize(maxCount);
+
+        return neighbors;
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::loadNearestNeighborIndex()
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "LoadNearestNeighborIndex");
 
-        math::MedoidCalculator<ReducedVector> calc;
-        for (const auto& [id, vecs] : _releaseVectors)
+        _nearestNeighborIndex = {};
+        if (_trackVectors.size() < _nearestNeighborIndexSettings.minTrackCount)
         {
-            calc.clear();
-            for (const auto& v : vecs)
-                calc.add(v.get());
-            _releaseMedoids.try_emplace(id, calc.finalize());
+            LOG(DEBUG, "not using a nearest neighbor index for " << _trackVectors.size() << " tracks");
+            return;
         }
 
-        for (const auto& [id, vecs] : _artistVectors)
+        const typename NearestNeighborIndex::BuildParameters params{ getNearestNeighborIndexBuildParameters() };
+
+        // The saved index is only valid for the very same vectors, built using the same parameters
+        const std::uint64_t key{ computeNearestNeighborIndexKey(params) };
+
+        if (!_cachePath.empty())
         {
-            calc.clear();
-            for (const auto& v : vecs)
-                calc.add(v.get());
-            _artistMedoids.try_emplace(id, calc.finalize());
+            const std::filesystem::path indexFilePath{ _cachePath / "audio-similarity.index" };
+            std::ifstream is{ indexFilePath, std::ios::binary };
+            std::uint64_t savedKey{};
+            if (math::binaryIO::readValue(is, savedKey) && savedKey == key && _nearestNeighborIndex.load(is, _trackVectors.getVectors()))
+            {
+                LOG(INFO, "loaded nearest neighbor index from " << indexFilePath);
+                return;
+            }
         }
 
-        // Sort artistIds in each TrackMetadata entry for set-intersection in SameArtistConstraint
-        for (auto& [trackId, metadata] : _trackMetadata)
-            std::sort(metadata.artistIds.begin(), metadata.artistIds.end());
+        LOG(INFO, "building nearest neighbor index for " << _trackVectors.size() << " tracks...");
+        _nearestNeighborIndex.build(_trackVectors.getVectors(), params);
+        LOG(INFO, "building nearest neighbor index done");
 
-        LOG(INFO, "computed reduced vectors: " << _trackVectors.size() << " tracks, " << _releaseVectors.size() << " releases, " << _artistVectors.size() << " artists");
+        saveNearestNeighborIndex(key);
+    }
+
+    // Reuses the graph of the previous index: only the new and changed vectors are inserted
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::updateNearestNeighborIndex(const AudioSimilarityEngine& previous, std::span<const std::optional<TrackIndex>> previousTrackRows)
+    {
+        LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "UpdateNearestNeighborIndex");
+
+        if (previous._nearestNeighborIndex.empty() || _trackVectors.size() < _nearestNeighborIndexSettings.minTrackCount)
+        {
+            loadNearestNeighborIndex();
+            return;
+        }
+
+        const typename NearestNeighborIndex::BuildParameters params{ getNearestNeighborIndexBuildParameters() };
+
+        LOG(INFO, "updating nearest neighbor index for " << _trackVectors.size() << " tracks...");
+        _nearestNeighborIndex.update(previous._nearestNeighborIndex, _trackVectors.getVectors(), previousTrackRows, params);
+        LOG(INFO, "updating nearest neighbor index done");
+
+        saveNearestNeighborIndex(computeNearestNeighborIndexKey(params));
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    typename AudioSimilarityEngine<Provider, ReducedDimCount>::NearestNeighborIndex::BuildParameters AudioSimilarityEngine<Provider, ReducedDimCount>::getNearestNeighborIndexBuildParameters() const
+    {
+        return typename NearestNeighborIndex::BuildParameters{
+            .maxNeighborCount = _nearestNeighborIndexSettings.maxNeighborCount,
+            .candidateCount = _nearestNeighborIndexSettings.buildCandidateCount,
+        };
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    void AudioSimilarityEngine<Provider, ReducedDimCount>::saveNearestNeighborIndex(std::uint64_t key) const
+    {
+        if (_cachePath.empty())
+            return;
+
+        const std::filesystem::path indexFilePath{ _cachePath / "audio-similarity.index" };
+        const std::error_code ec{ math::binaryIO::writeFileAtomically(indexFilePath, [&](std::ostream& os) {
+            math::binaryIO::writeValue(os, key);
+            _nearestNeighborIndex.save(os);
+        }) };
+        if (ec)
+            LOG(WARNING, "cannot save nearest neighbor index to " << indexFilePath << ": " << ec.message());
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    std::uint64_t AudioSimilarityEngine<Provider, ReducedDimCount>::computeNearestNeighborIndexKey(const typename NearestNeighborIndex::BuildParameters& params) const
+    {
+        core::XxHash3_64 hasher;
+
+        auto hashValue{ [&](const auto& value) {
+            hasher.update(std::as_bytes(std::span{ &value, 1 }));
+        } };
+
+        hashValue(params.maxNeighborCount);
+        hashValue(params.candidateCount);
+        hashValue(params.seed);
+        for (const db::TrackId trackId : _trackVectors.getTrackIds())
+            hashValue(trackId.getValue());
+
+        const auto& vectors{ _trackVectors.getVectors() };
+        for (std::size_t i{}; i < vectors.size(); ++i)
+            hasher.update(std::as_bytes(std::span{ vectors[i].data(), ReducedDimCount }));
+
+        return hasher.digest();
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
@@ -688,30 +1099,27 @@ namespace lms::recommendation
 
         LOG(INFO, "computing track distance threshold using " << sampleCount << " samples...");
 
-        // Collect all vector pointers and shuffle for an unbiased random sample.
-        std::vector<const ReducedVector*> allVectors;
-        allVectors.reserve(_trackVectors.size());
-        for (const auto& [id, vec] : _trackVectors)
-            allVectors.push_back(vec);
+        // Shuffle all the rows for an unbiased random sample
+        std::vector<std::size_t> rows(_trackVectors.size());
+        std::iota(std::begin(rows), std::end(rows), 0);
 
         std::minstd_rand randomEngine{ 42 };
-        core::random::shuffleContainer(randomEngine, allVectors);
+        core::random::shuffleContainer(randomEngine, rows);
+
+        const auto vectors{ _trackVectors.getVectors().getView() };
+        std::vector<FloatType> distances(vectors.size());
 
         math::StatsAccumulator<FloatType> stats;
         for (std::size_t i{}; i < sampleCount; ++i)
         {
-            const ReducedVector* queryVector{ allVectors[i] };
-            const math::NormalizedCosineDistance distFunc{ *queryVector };
-            FloatType minDist{ std::numeric_limits<FloatType>::max() };
+            const std::size_t queryRow{ rows[i] };
+            math::computeNormalizedCosineDistances(vectors[queryRow], vectors, distances);
 
-            for (const ReducedVector* candidateVector : allVectors)
+            FloatType minDist{ std::numeric_limits<FloatType>::max() };
+            for (std::size_t candidateRow{}; candidateRow < distances.size(); ++candidateRow)
             {
-                if (candidateVector == queryVector)
-                    continue;
-
-                const FloatType d{ distFunc(*candidateVector) };
-                if (d < minDist)
-                    minDist = d;
+                if (candidateRow != queryRow && distances[candidateRow] < minDist)
+                    minDist = distances[candidateRow];
             }
 
             stats.add(minDist);
@@ -730,52 +1138,7 @@ namespace lms::recommendation
     {
         LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "ComputeReleaseDistanceThreshold");
 
-        constexpr std::size_t maxSampleCount{ 200 };
-        constexpr std::size_t maxCandidateCount{ 1'000 };
-        constexpr float stdDevMultiplier{ 2.F };
-        using CosineDistance = math::NormalizedCosineDistance<ReducedVector::getSize(), FloatType>;
-
-        std::vector<const std::vector<std::reference_wrapper<const ReducedVector>>*> allProfiles;
-        allProfiles.reserve(_releaseVectors.size());
-        for (const auto& [id, vecs] : _releaseVectors)
-            allProfiles.push_back(&vecs);
-
-        // move maxCandidateCount random elements to the front
-        const std::size_t candidateCount{ std::min(allProfiles.size(), maxCandidateCount) };
-        std::minstd_rand randomEngine{ 42 };
-        for (std::size_t i{}; i < candidateCount; ++i)
-        {
-            std::uniform_int_distribution<std::size_t> dist{ i, allProfiles.size() - 1 };
-            std::swap(allProfiles[i], allProfiles[dist(randomEngine)]);
-        }
-        allProfiles.resize(candidateCount);
-
-        const std::size_t sampleCount{ std::min(candidateCount, maxSampleCount) };
-        LOG(INFO, "computing release distance threshold using " << sampleCount << " samples on " << candidateCount << " candidates...");
-
-        math::StatsAccumulator<FloatType> stats;
-        for (std::size_t i{}; i < sampleCount; ++i)
-        {
-            FloatType minDist{ std::numeric_limits<FloatType>::max() };
-            for (const auto* candidate : allProfiles)
-            {
-                if (candidate == allProfiles[i])
-                    continue;
-
-                const FloatType d{ math::symmetricalChamferDistance<CosineDistance>(*allProfiles[i], *candidate) };
-                if (d < minDist)
-                    minDist = d;
-            }
-            if (minDist < std::numeric_limits<FloatType>::max())
-                stats.add(minDist);
-        }
-
-        if (stats.getCount() >= 2)
-            _releaseDistanceThreshold = stats.getMean() + stdDevMultiplier * stats.getSampleStdDev();
-        else
-            _releaseDistanceThreshold = std::numeric_limits<FloatType>::max();
-
-        LOG(INFO, "release distance threshold = " << _releaseDistanceThreshold);
+        _releaseDistanceThreshold = computeProfileDistanceThreshold(_trackVectors, _releaseVectors, "release");
     }
 
     template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
@@ -783,15 +1146,21 @@ namespace lms::recommendation
     {
         LMS_SCOPED_TRACE_DETAILED("AudioSimilarityEngine", "ComputeArtistDistanceThreshold");
 
+        _artistDistanceThreshold = computeProfileDistanceThreshold(_trackVectors, _artistVectors, "artist");
+    }
+
+    template<AudioVectorProvider Provider, std::size_t ReducedDimCount>
+    template<typename IdType>
+    FloatType AudioSimilarityEngine<Provider, ReducedDimCount>::computeProfileDistanceThreshold(const TrackVectorStore<ReducedDimCount>& trackVectors, const ProfileVectorStore<IdType, ReducedDimCount>& profiles, std::string_view profileType)
+    {
+        using ProfileIndex = typename ProfileVectorStore<IdType, ReducedDimCount>::Index;
+
         constexpr std::size_t maxSampleCount{ 200 };
         constexpr std::size_t maxCandidateCount{ 1'000 };
         constexpr float stdDevMultiplier{ 2.F };
-        using CosineDistance = math::NormalizedCosineDistance<ReducedVector::getSize(), FloatType>;
 
-        std::vector<const std::vector<std::reference_wrapper<const ReducedVector>>*> allProfiles;
-        allProfiles.reserve(_artistVectors.size());
-        for (const auto& [id, vecs] : _artistVectors)
-            allProfiles.push_back(&vecs);
+        std::vector<ProfileIndex> allProfiles(profiles.size());
+        std::iota(std::begin(allProfiles), std::end(allProfiles), 0);
 
         // move maxCandidateCount random elements to the front
         const std::size_t candidateCount{ std::min(allProfiles.size(), maxCandidateCount) };
@@ -804,18 +1173,21 @@ namespace lms::recommendation
         allProfiles.resize(candidateCount);
 
         const std::size_t sampleCount{ std::min(candidateCount, maxSampleCount) };
-        LOG(INFO, "computing artist distance threshold using " << sampleCount << " samples on " << candidateCount << " candidates...");
+        LOG(INFO, "computing " << profileType << " distance threshold using " << sampleCount << " samples on " << candidateCount << " candidates...");
 
+        const auto trackRows{ trackVectors.getVectors().getView() };
         math::StatsAccumulator<FloatType> stats;
         for (std::size_t i{}; i < sampleCount; ++i)
         {
+            const auto sampleTrackRows{ profiles.getTrackRows(allProfiles[i]) };
+
             FloatType minDist{ std::numeric_limits<FloatType>::max() };
-            for (const auto* candidate : allProfiles)
+            for (const ProfileIndex candidate : allProfiles)
             {
                 if (candidate == allProfiles[i])
                     continue;
 
-                const FloatType d{ math::symmetricalChamferDistance<CosineDistance>(*allProfiles[i], *candidate) };
+                const FloatType d{ math::computeSymmetricalNormalizedCosineChamferDistance(trackRows, sampleTrackRows, profiles.getTrackRows(candidate)) };
                 if (d < minDist)
                     minDist = d;
             }
@@ -823,12 +1195,13 @@ namespace lms::recommendation
                 stats.add(minDist);
         }
 
+        FloatType threshold{ std::numeric_limits<FloatType>::max() };
         if (stats.getCount() >= 2)
-            _artistDistanceThreshold = stats.getMean() + stdDevMultiplier * stats.getSampleStdDev();
-        else
-            _artistDistanceThreshold = std::numeric_limits<FloatType>::max();
+            threshold = stats.getMean() + stdDevMultiplier * stats.getSampleStdDev();
+
+        LOG(INFO, profileType << " distance threshold = " << threshold);
 
-        LOG(INFO, "artist distance threshold = " << _artistDistanceThreshold);
+        return threshold;
     }
 } // namespace lms::recommendation
 
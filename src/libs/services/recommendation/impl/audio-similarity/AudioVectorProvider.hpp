@@ -31,8 +31,10 @@ namespace lms::recommendation
     template<typename T>
     concept AudioVectorProvider = requires(const T provider, db::Session& session, db::TrackId id, typename T::Vector& v) {
         typename T::Vector;
+        typename T::VectorVersion; // must change each time the vector of a track changes, trivially copyable
 
         { provider.getVector(session, id, v) } -> std::same_as<bool>;
         provider.visitVectors(session, [](db::TrackId, typename T::Vector&) {});
+        provider.visitVectorVersions(session, [](db::TrackId, typename T::VectorVersion) {});
     };
 } // namespace lms::recommendation
\ No newline at end of file
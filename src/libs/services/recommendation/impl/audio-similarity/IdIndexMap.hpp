@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace lms::recommendation
+{
+    // Dense index of database ids, stored in an array indexed by the id values
+    // Database ids are allocated sequentially, so this is much more compact and faster than a hash map
+    template<typename IdType>
+    class IdIndexMap
+    {
+    public:
+        using Index = std::uint32_t;
+
+        void clear() { _indices.clear(); }
+
+        // returns false if the id already has an index
+        bool insert(IdType id, Index index)
+        {
+            assert(id.getValue() >= 0);
+            assert(index != invalidIndex);
+
+            const auto value{ static_cast<std::size_t>(id.getValue()) };
+            if (value >= _indices.size())
+                _indices.resize(value + 1, invalidIndex);
+
+            if (_indices[value] != invalidIndex)
+                return false;
+
+            _indices[value] = index;
+            return true;
+        }
+
+        std::optional<Index> find(IdType id) const
+        {
+            if (id.getValue() < 0 || static_cast<std::size_t>(id.getValue()) >= _indices.size())
+                return std::nullopt;
+
+            const Index index{ _indices[static_cast<std::size_t>(id.getValue())] };
+            if (index == invalidIndex)
+                return std::nullopt;
+
+            return index;
+        }
+
+        bool contains(IdType id) const { return find(id).has_value(); }
+
+    private:
+        static constexpr Index invalidIndex{ std::numeric_limits<Index>::max() };
+        std::vector<Index> _indices;
+    };
+} // namespace lms::recommendation
@@ -20,12 +20,11 @@
 #pragma once
 
 #include <optional>
-#include <unordered_map>
-
 #include "database/objects/TrackId.hpp"
 #include "math/NormalizedCosineDistance.hpp"
 #include "math/Vector.hpp"
 
+#include "TrackVectorStore.hpp"
 #include "Types.hpp"
 #include "track-selection-constraints/ITrackCandidateSoftConstraint.hpp"
 
@@ -36,9 +35,8 @@ namespace lms::recommendation
     {
     public:
         using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
-        using TrackVectorMap = std::unordered_map<db::TrackId, const ReducedVector*>;
 
-        explicit InterpolationFitConstraint(const TrackVectorMap& trackVectors)
+        explicit InterpolationFitConstraint(const TrackVectorStore<ReducedDimCount>& trackVectors)
             : _trackVectors{ trackVectors }
         {
         }
@@ -49,17 +47,16 @@ namespace lms::recommendation
 
         float computeScore(const TrackCandidateContext& context) const override
         {
-            const auto itCand{ _trackVectors.find(context.candidateTrackId) };
-            if (itCand == _trackVectors.cend())
+            const ReducedVector* candidateVector{ _trackVectors.find(context.candidateTrackId) };
+            if (!candidateVector)
                 return {};
 
             std::optional<float> best;
             for (const db::TrackId seedId : context.seedTrackIds)
             {
-                const auto it{ _trackVectors.find(seedId) };
-                if (it != _trackVectors.cend())
+                if (const ReducedVector * seedVector{ _trackVectors.find(seedId) })
                 {
-                    const float dist{ math::computeNormalizedCosineDistance(*it->second, *itCand->second) };
+                    const float dist{ math::computeNormalizedCosineDistance(*seedVector, *candidateVector) };
                     best = best ? std::min(*best, dist) : dist;
                 }
             }
@@ -67,6 +64,6 @@ namespace lms::recommendation
         }
 
     private:
-        const TrackVectorMap& _trackVectors;
+        const TrackVectorStore<ReducedDimCount>& _trackVectors;
     };
 } // namespace lms::recommendation
@@ -19,12 +19,11 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "database/objects/TrackId.hpp"
 #include "math/NormalizedCosineDistance.hpp"
 #include "math/Vector.hpp"
 
+#include "TrackVectorStore.hpp"
 #include "Types.hpp"
 #include "track-selection-constraints/ITrackCandidateHardConstraint.hpp"
 
@@ -36,9 +35,8 @@ namespace lms::recommendation
     {
     public:
         using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
-        using TrackVectorMap = std::unordered_map<db::TrackId, const ReducedVector*>;
 
-        MaxDistanceConstraint(const TrackVectorMap& trackVectors, float threshold)
+        MaxDistanceConstraint(const TrackVectorStore<ReducedDimCount>& trackVectors, float threshold)
             : _trackVectors{ trackVectors }
             , _threshold{ threshold }
         {
@@ -50,21 +48,21 @@ namespace lms::recommendation
 
         bool rejects(const TrackCandidateContext& context) const override
         {
-            const auto itCand{ _trackVectors.find(context.candidateTrackId) };
-            if (itCand == _trackVectors.cend())
+            const ReducedVector* candidateVector{ _trackVectors.find(context.candidateTrackId) };
+            if (!candidateVector)
                 return false;
 
             for (const db::TrackId seedId : context.seedTrackIds)
             {
-                const auto it{ _trackVectors.find(seedId) };
-                if (it != _trackVectors.cend() && math::computeNormalizedCosineDistance(*it->second, *itCand->second) <= _threshold)
+                const ReducedVector* seedVector{ _trackVectors.find(seedId) };
+                if (seedVector && math::computeNormalizedCosineDistance(*seedVector, *candidateVector) <= _threshold)
                     return false;
             }
             return !context.seedTrackIds.empty();
         }
 
     private:
-        const TrackVectorMap& _trackVectors;
+        const TrackVectorStore<ReducedDimCount>& _trackVectors;
         float _threshold;
     };
 } // namespace lms::recommendation
@@ -19,12 +19,11 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "database/objects/TrackId.hpp"
 #include "math/NormalizedCosineDistance.hpp"
 #include "math/Vector.hpp"
 
+#include "TrackVectorStore.hpp"
 #include "Types.hpp"
 #include "track-selection-constraints/ITrackCandidateHardConstraint.hpp"
 
@@ -37,9 +36,8 @@ namespace lms::recommendation
     {
     public:
         using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
-        using TrackVectorMap = std::unordered_map<db::TrackId, const ReducedVector*>;
 
-        NearDuplicateEmbeddingConstraint(const TrackVectorMap& trackVectors, float threshold)
+        NearDuplicateEmbeddingConstraint(const TrackVectorStore<ReducedDimCount>& trackVectors, float threshold)
             : _trackVectors{ trackVectors }
             , _threshold{ threshold }
         {
@@ -47,22 +45,22 @@ namespace lms::recommendation
 
         bool rejects(const TrackCandidateContext& context) const override
         {
-            const auto itCandidate{ _trackVectors.find(context.candidateTrackId) };
-            if (itCandidate == _trackVectors.cend())
+            const ReducedVector* candidateVector{ _trackVectors.find(context.candidateTrackId) };
+            if (!candidateVector)
                 return false;
 
-            const math::NormalizedCosineDistance distFunc{ *itCandidate->second };
+            const math::NormalizedCosineDistance distFunc{ *candidateVector };
             for (const db::TrackId selectedId : context.selectedTracks)
             {
-                const auto it{ _trackVectors.find(selectedId) };
-                if (it != _trackVectors.cend() && distFunc(*it->second) < _threshold)
+                const ReducedVector* selectedVector{ _trackVectors.find(selectedId) };
+                if (selectedVector && distFunc(*selectedVector) < _threshold)
                     return true;
             }
             return false;
         }
 
     private:
-        const TrackVectorMap& _trackVectors;
+        const TrackVectorStore<ReducedDimCount>& _trackVectors;
         float _threshold;
     };
 } // namespace lms::recommendation
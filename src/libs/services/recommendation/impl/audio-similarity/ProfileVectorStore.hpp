@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "math/BinaryIO.hpp"
+#include "math/MedoidCalculator.hpp"
+#include "math/Vector.hpp"
+#include "math/VectorStore.hpp"
+
+#include "IdIndexMap.hpp"
+#include "TrackVectorStore.hpp"
+#include "Types.hpp"
+
+namespace lms::recommendation
+{
+    // Tracks of each release (or artist), as rows of the track vector store, along with their medoid
+    // The rows of a profile are sorted by track, and refer to the track vector store the profile was built from
+    template<typename IdType, std::size_t ReducedDimCount>
+    class ProfileVectorStore
+    {
+    public:
+        using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
+        using Vectors = math::VectorStore<ReducedDimCount, FloatType>;
+        using Index = typename IdIndexMap<IdType>::Index;
+        using TrackVectors = TrackVectorStore<ReducedDimCount>;
+        using TrackIndex = typename TrackVectors::Index;
+
+        void clear()
+        {
+            _trackRows.clear();
+            _offsets.assign(1, 0);
+            _medoids.clear();
+            _ids.clear();
+            _indices.clear();
+        }
+
+        // Adds the rows of trackVectors as the profile of id, ignored if id already has a profile
+        void add(IdType id, const TrackVectors& trackVectors, std::span<const TrackIndex> rows)
+        {
+            assert(!rows.empty());
+
+            math::MedoidCalculator<ReducedVector> medoidCalculator;
+            for (const TrackIndex row : rows)
+                medoidCalculator.add(trackVectors.getVector(row));
+
+            add(id, rows, *medoidCalculator.finalize());
+        }
+
+        // Same as above, using an already known medoid
+        void add(IdType id, std::span<const TrackIndex> rows, const ReducedVector& medoid)
+        {
+            assert(!rows.empty());
+            if (!_indices.insert(id, static_cast<Index>(_ids.size())))
+                return;
+
+            _trackRows.insert(std::cend(_trackRows), std::cbegin(rows), std::cend(rows));
+            _offsets.push_back(_trackRows.size());
+            _medoids.add(medoid);
+            _ids.push_back(id);
+        }
+
+        std::size_t size() const { return _ids.size(); }
+        bool empty() const { return _ids.empty(); }
+
+        std::optional<Index> findIndex(IdType id) const { return _indices.find(id); }
+        bool contains(IdType id) const { return _indices.contains(id); }
+        IdType getId(Index index) const { return _ids[index]; }
+
+        std::span<const TrackIndex> getTrackRows(Index index) const { return std::span{ _trackRows }.subspan(_offsets[index], _offsets[index + 1] - _offsets[index]); }
+        const ReducedVector& getMedoid(Index index) const { return _medoids[index]; }
+        typename Vectors::View getMedoids() const { return _medoids.getView(); } // row i is the medoid of the profile i
+
+        void save(std::ostream& os) const
+        {
+            _medoids.save(os);
+            const std::uint64_t trackRowCount{ _trackRows.size() };
+            math::binaryIO::writeValue(os, trackRowCount);
+            math::binaryIO::writeValues(os, std::span{ _trackRows });
+            math::binaryIO::writeValues(os, std::span{ _offsets });
+            math::binaryIO::writeValues(os, std::span{ _ids });
+        }
+
+        // Returns false if the saved store is invalid or does not fit a track vector store of trackCount rows, the store is left empty in that case
+        bool load(std::istream& is, std::size_t trackCount)
+        {
+            clear();
+            if (!doLoad(is, trackCount))
+            {
+                clear();
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        bool doLoad(std::istream& is, std::size_t trackCount)
+        {
+            std::uint64_t trackRowCount{};
+            if (!_medoids.load(is) || !math::binaryIO::readValue(is, trackRowCount))
+                return false;
+
+            // a profile lists each of its tracks once
+            if (trackRowCount > trackCount * _medoids.size())
+                return false;
+
+            _trackRows.resize(trackRowCount);
+            _offsets.resize(_medoids.size() + 1);
+            _ids.resize(_medoids.size());
+            if (!math::binaryIO::readValues(is, std::span{ _trackRows }) || !math::binaryIO::readValues(is, std::span{ _offsets }) || !math::binaryIO::readValues(is, std::span{ _ids }))
+                return false;
+
+            if (std::any_of(std::cbegin(_trackRows), std::cend(_trackRows), [=](TrackIndex row) { return row >= trackCount; }))
+                return false;
+
+            // each profile has at least one track
+            if (_offsets.front() != 0 || _offsets.back() != _trackRows.size() || std::adjacent_find(std::cbegin(_offsets), std::cend(_offsets), std::greater_equal{}) != std::cend(_offsets))
+                return false;
+
+            for (std::size_t i{}; i < _ids.size(); ++i)
+            {
+                if (!_ids[i].isValid() || !_indices.insert(_ids[i], static_cast<Index>(i)))
+                    return false;
+            }
+
+            return true;
+        }
+
+        std::vector<TrackIndex> _trackRows; // all the profiles, one after another
+        std::vector<std::size_t> _offsets{ 0 }; // first row of each profile in _trackRows, plus the end
+        Vectors _medoids;
+        std::vector<IdType> _ids; // dense index -> id
+        IdIndexMap<IdType> _indices; // id -> dense index
+    };
+} // namespace lms::recommendation
@@ -19,12 +19,11 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "database/objects/TrackId.hpp"
 #include "math/NormalizedCosineDistance.hpp"
 #include "math/Vector.hpp"
 
+#include "TrackVectorStore.hpp"
 #include "Types.hpp"
 #include "track-selection-constraints/ITrackCandidateSoftConstraint.hpp"
 
@@ -35,9 +34,8 @@ namespace lms::recommendation
     {
     public:
         using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
-        using TrackVectorMap = std::unordered_map<db::TrackId, const ReducedVector*>;
 
-        explicit SmoothTransitionConstraint(const TrackVectorMap& trackVectors)
+        explicit SmoothTransitionConstraint(const TrackVectorStore<ReducedDimCount>& trackVectors)
             : _trackVectors{ trackVectors }
         {
         }
@@ -51,18 +49,18 @@ namespace lms::recommendation
             if (context.selectedTracks.empty())
                 return {};
 
-            const auto itCand{ _trackVectors.find(context.candidateTrackId) };
-            if (itCand == _trackVectors.cend())
+            const ReducedVector* candidateVector{ _trackVectors.find(context.candidateTrackId) };
+            if (!candidateVector)
                 return {};
 
-            const auto it{ _trackVectors.find(context.selectedTracks.back()) };
-            if (it == _trackVectors.cend())
+            const ReducedVector* lastSelectedVector{ _trackVectors.find(context.selectedTracks.back()) };
+            if (!lastSelectedVector)
                 return {};
 
-            return math::computeNormalizedCosineDistance(*it->second, *itCand->second);
+            return math::computeNormalizedCosineDistance(*lastSelectedVector, *candidateVector);
         }
 
     private:
-        const TrackVectorMap& _trackVectors;
+        const TrackVectorStore<ReducedDimCount>& _trackVectors;
     };
 } // namespace lms::recommendation
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "database/objects/TrackId.hpp"
+#include "math/BinaryIO.hpp"
+#include "math/Vector.hpp"
+#include "math/VectorStore.hpp"
+
+#include "IdIndexMap.hpp"
+#include "Types.hpp"
+
+namespace lms::recommendation
+{
+    // Reduced vectors of the tracks, stored contiguously
+    // The dense index of a track is its row in the vector store
+    template<std::size_t ReducedDimCount>
+    class TrackVectorStore
+    {
+    public:
+        using ReducedVector = math::Vector<ReducedDimCount, FloatType>;
+        using Vectors = math::VectorStore<ReducedDimCount, FloatType>;
+        using Index = typename IdIndexMap<db::TrackId>::Index;
+
+        void clear()
+        {
+            _vectors.clear();
+            _trackIds.clear();
+            _indices.clear();
+        }
+
+        void reserve(std::size_t count)
+        {
+            _vectors.reserve(count);
+            _trackIds.reserve(count);
+        }
+
+        // returns false if the track already has a vector
+        bool add(db::TrackId trackId, const ReducedVector& vector)
+        {
+            if (!_indices.insert(trackId, static_cast<Index>(_vectors.size())))
+                return false;
+
+            _vectors.add(vector);
+            _trackIds.push_back(trackId);
+            return true;
+        }
+
+        std::size_t size() const { return _vectors.size(); }
+        bool empty() const { return _vectors.empty(); }
+
+        std::optional<Index> findIndex(db::TrackId trackId) const { return _indices.find(trackId); }
+        bool contains(db::TrackId trackId) const { return _indices.contains(trackId); }
+
+        // nullptr if the track has no vector
+        const ReducedVector* find(db::TrackId trackId) const
+        {
+            const std::optional<Index> index{ _indices.find(trackId) };
+            return index ? &_vectors[*index] : nullptr;
+        }
+
+        const ReducedVector& getVector(Index index) const { return _vectors[index]; }
+        db::TrackId getTrackId(Index index) const { return _trackIds[index]; }
+
+        const Vectors& getVectors() const { return _vectors; }
+        std::span<const db::TrackId> getTrackIds() const { return _trackIds; }
+
+        void save(std::ostream& os) const
+        {
+            _vectors.save(os);
+            math::binaryIO::writeValues(os, std::span{ _trackIds });
+        }
+
+        // Returns false if the saved store is invalid, the store is left empty in that case
+        bool load(std::istream& is)
+        {
+            clear();
+            if (!doLoad(is))
+            {
+                clear();
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        bool doLoad(std::istream& is)
+        {
+            if (!_vectors.load(is))
+                return false;
+
+            _trackIds.resize(_vectors.size());
+            if (!math::binaryIO::readValues(is, std::span{ _trackIds }))
+                return false;
+
+            for (std::size_t i{}; i < _trackIds.size(); ++i)
+            {
+                if (!_trackIds[i].isValid() || !_indices.insert(_trackIds[i], static_cast<Index>(i)))
+                    return false;
+            }
+
+            return true;
+        }
+
+        Vectors _vectors;
+        std::vector<db::TrackId> _trackIds; // dense index -> track
+        IdIndexMap<db::TrackId> _indices; // track -> dense index
+    };
+} // namespace lms::recommendation
@@ -64,4 +64,13 @@ namespace lms::recommendation
             visitor(embeddings->getTrackId(), vec);
         });
     }
+
+    void MusicNNEmbeddingProvider::visitVectorVersions(db::Session& session, const std::function<void(db::TrackId, VectorVersion)>& visitor)
+    {
+        session.checkReadTransaction();
+
+        db::TrackMusicNNEmbeddings::findTrackIds(session, [&](db::TrackMusicNNEmbeddingsId embeddingsId, db::TrackId trackId) {
+            visitor(trackId, embeddingsId);
+        });
+    }
 } // namespace lms::recommendation
@@ -22,6 +22,7 @@
 #include <functional>
 
 #include "database/objects/TrackId.hpp"
+#include "database/objects/TrackMusicNNEmbeddings.hpp"
 
 #include "math/Vector.hpp"
 
@@ -39,9 +40,11 @@ namespace lms::recommendation
     public:
         static constexpr std::size_t DimCount{ 200 };
         using Vector = math::Vector<DimCount, FloatType>;
+        using VectorVersion = db::TrackMusicNNEmbeddingsId; // embeddings are recreated each time they are extracted
 
         static std::size_t getCount(db::Session& session);
         static bool getVector(db::Session& session, db::TrackId trackId, Vector& vec);
         static void visitVectors(db::Session& session, const std::function<void(db::TrackId, Vector&)>& visitor);
+        static void visitVectorVersions(db::Session& session, const std::function<void(db::TrackId, VectorVersion)>& visitor);
     };
 } // namespace lms::recommendation
@@ -130,6 +130,14 @@ namespace lms::recommendation
         LOG(INFO, "loaded " << _trackClusters.size() << " tracks, " << _releaseClusters.size() << " releases, " << _artistClusters.size() << " artists");
     }
 
+    std::unique_ptr<IEngine> ClusterEngine::createUpdatedEngine() const
+    {
+        // Everything here is a direct mapping of the database clusters, there is no costly derived data worth reusing
+        auto engine{ std::make_unique<ClusterEngine>(_db) };
+        engine->load();
+        return engine;
+    }
+
     void ClusterEngine::buildTrackMetadata(db::Session& session)
     {
         LOG(DEBUG, "building track metadata...");
@@ -46,6 +46,7 @@ namespace lms::recommendation
 
     private:
         void load() override;
+        std::unique_ptr<IEngine> createUpdatedEngine() const override;
 
         TrackResults findSimilarTracksFromTrackList(db::TrackListId tracklistId, std::size_t maxCount) const override;
         TrackResults findSimilarTracks(std::span<const db::TrackId> trackIds, std::size_t maxCount) const override;
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <span>
 
@@ -62,5 +63,6 @@ namespace lms::recommendation
         virtual TrackResults findTrackSimilarityPath(db::TrackId startTrackId, db::TrackId endTrackId, std::size_t maxCount) const = 0;
     };
 
-    std::unique_ptr<IRecommendationService> createRecommendationService(db::IDb& db);
+    // cachePath is used to store data that is long to compute
+    std::unique_ptr<IRecommendationService> createRecommendationService(db::IDb& db, const std::filesystem::path& cachePath);
 } // namespace lms::recommendation
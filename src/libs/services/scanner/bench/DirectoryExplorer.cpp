@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/IJob.hpp"
+#include "core/IJobScheduler.hpp"
+
+#include "IgnoreRules.hpp"
+#include "steps/DirectoryExplorer.hpp"
+#include "steps/JobQueue.hpp"
+
+namespace lms::scanner::benchmarks
+{
+    namespace
+    {
+        // Synthetic library: artist/album/disc directories, each leaf holding a few tracks and a cover
+        class SyntheticTree
+        {
+        public:
+            static constexpr std::size_t fanOut{ 8 };
+            static constexpr std::size_t depth{ 3 };
+            static constexpr std::size_t filesPerLeaf{ 12 };
+
+            SyntheticTree()
+                : _rootDirectory{ std::filesystem::temp_directory_path() / "lms-bench-explore" }
+            {
+                std::filesystem::remove_all(_rootDirectory);
+                createDirectory(_rootDirectory, 0);
+            }
+            ~SyntheticTree()
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(_rootDirectory, ec);
+            }
+            SyntheticTree(const SyntheticTree&) = delete;
+            SyntheticTree& operator=(const SyntheticTree&) = delete;
+
+            static const SyntheticTree& getInstance()
+            {
+                static const SyntheticTree tree;
+                return tree;
+            }
+
+            const std::filesystem::path& getRootDirectory() const { return _rootDirectory; }
+
+        private:
+            void createDirectory(const std::filesystem::path& directory, std::size_t currentDepth)
+            {
+                std::filesystem::create_directories(directory);
+
+                if (currentDepth == depth)
+                {
+                    for (std::size_t i{}; i < filesPerLeaf; ++i)
+                        std::ofstream{ directory / ("track" + std::to_string(i) + ".flac") };
+                    std::ofstream{ directory / "cover.jpg" };
+                    return;
+                }
+
+                for (std::size_t i{}; i < fanOut; ++i)
+                    createDirectory(directory / ("dir" + std::to_string(i)), currentDepth + 1);
+            }
+
+            const std::filesystem::path _rootDirectory;
+        };
+
+        const IgnoreRules& getIgnoreRules()
+        {
+            static const IgnoreRules ignoreRules{ "*.log\n/dir7/dir7/\n" };
+            return ignoreRules;
+        }
+
+        // Former single threaded exploration, kept as a reference
+        void exploreSequential(const std::filesystem::path& rootDirectory, const std::filesystem::path& directory, const IgnoreRules& ignoreRules, std::size_t& fileCount)
+        {
+            std::error_code ec;
+            for (std::filesystem::directory_iterator itPath{ directory, std::filesystem::directory_options::follow_directory_symlink, ec }; !ec && itPath != std::filesystem::directory_iterator{}; itPath.increment(ec))
+            {
+                const std::filesystem::directory_entry& entry{ *itPath };
+                if (entry.is_regular_file())
+                {
+                    if (!ignoreRules.isIgnored(std::filesystem::relative(entry.path(), rootDirectory), IgnoreRules::IsDirectory{ false }))
+                        fileCount++;
+                }
+                else if (entry.is_directory())
+                {
+                    if (!ignoreRules.isIgnored(std::filesystem::relative(entry.path(), rootDirectory), IgnoreRules::IsDirectory{ true }))
+                        exploreSequential(rootDirectory, entry.path(), ignoreRules, fileCount);
+                }
+            }
+        }
+    } // namespace
+
+    static void BM_ExploreDirectories_sequential(benchmark::State& state)
+    {
+        const SyntheticTree& tree{ SyntheticTree::getInstance() };
+
+        std::size_t fileCount{};
+        for (auto _ : state)
+        {
+            fileCount = 0;
+            exploreSequential(tree.getRootDirectory(), tree.getRootDirectory(), getIgnoreRules(), fileCount);
+        }
+
+        state.SetItemsProcessed(state.iterations() * fileCount);
+    }
+
+    static void BM_ExploreDirectories_parallel(benchmark::State& state)
+    {
+        const SyntheticTree& tree{ SyntheticTree::getInstance() };
+        const auto scheduler{ core::createJobScheduler("Explore", static_cast<std::size_t>(state.range(0))) };
+
+        std::size_t fileCount{};
+        for (auto _ : state)
+        {
+            DirectoryExplorer explorer{ tree.getRootDirectory(), getIgnoreRules() };
+            std::vector<std::filesystem::directory_entry> files;
+            std::vector<DirectoryExplorer::Error> errors;
+
+            auto processDoneJobs = [&](std::span<std::unique_ptr<core::IJob>> jobsDone) {
+                for (const auto& jobDone : jobsDone)
+                    explorer.processJobDone(*jobDone, files, errors);
+            };
+
+            {
+                JobQueue queue{ *scheduler, processDoneJobs, { .maxQueueSize = 50, .processBatchSize = 1 } };
+
+                while (!explorer.isComplete())
+                {
+                    if (std::unique_ptr<core::IJob> job{ explorer.createNextJob() })
+                        queue.push(std::move(job));
+                    else
+                        queue.processJobsDone();
+                }
+            }
+
+            fileCount = files.size();
+        }
+
+        state.SetItemsProcessed(state.iterations() * fileCount);
+    }
+
+    BENCHMARK(BM_ExploreDirectories_sequential)->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_ExploreDirectories_parallel)->Unit(benchmark::kMillisecond)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+} // namespace lms::scanner::benchmarks
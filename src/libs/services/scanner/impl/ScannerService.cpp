@@ -52,7 +52,9 @@
 #include "steps/ScanStepComputeClusterStats.hpp"
 #include "steps/ScanStepExtractMusicNNEmbeddings.hpp"
 #include "steps/ScanStepOptimize.hpp"
+#include "steps/ScanStepRebuildListenStats.hpp"
 #include "steps/ScanStepRemoveOrphanedDbEntries.hpp"
+#include "steps/ScanStepRenderArtworkThumbnails.hpp"
 #include "steps/ScanStepScanFiles.hpp"
 #include "steps/ScanStepUpdateLibraryFields.hpp"
 
@@ -149,6 +151,13 @@ namespace lms::scanner
             // TODO add more fields
         }
 
+        void incScanGeneration(db::Session& session)
+        {
+            auto transaction{ session.createWriteTransaction() };
+
+            ScanSettings::find(session).modify()->incScanGeneration();
+        }
+
         std::size_t getScannerThreadCount()
         {
             std::size_t threadCount{ core::Service<core::IConfig>::get()->getULong("scanner-thread-count", 0) };
@@ -390,8 +399,13 @@ namespace lms::scanner
         ScanStats& stats{ scanContext.stats };
         stats.startTime = Wt::WDateTime::currentDateTime();
 
+        _jobScheduler->resetJobStats();
         processScanSteps(scanContext);
 
+        // even partial changes outdate what was computed from the database (recommendation snapshot, etc.)
+        if (stats.getChangesCount() > 0 || stats.featureExtractions > 0)
+            incScanGeneration(_db.getTLSSession());
+
         {
             std::unique_lock lock{ _statusMutex };
 
@@ -402,6 +416,10 @@ namespace lms::scanner
         refreshTracingLoggerStats();
         LMS_LOG(DBUPDATER, INFO, "Scan " << (_abortScan ? "aborted" : "complete") << ". Changes = " << stats.getChangesCount() << " (added = " << stats.additions << ", removed = " << stats.deletions << ", updated = " << stats.updates << ", failures = " << stats.failures << "), Not changed = " << stats.skips << ", Scanned = " << stats.scans << " (errors = " << stats.errorsCount << "), audio features extracted = " << stats.featureExtractions << ",  duplicates = " << stats.duplicates.size());
 
+        _jobScheduler->visitJobStats([](const core::IJobScheduler::JobStats& jobStats) {
+            LMS_LOG(DBUPDATER, DEBUG, "Job '" << jobStats.name << "' stats: count = " << jobStats.runCount << ", total run time = " << std::chrono::duration_cast<std::chrono::milliseconds>(jobStats.totalRunDuration).count() << " ms (max = " << std::chrono::duration_cast<std::chrono::milliseconds>(jobStats.maxRunDuration).count() << " ms), total wait time = " << std::chrono::duration_cast<std::chrono::milliseconds>(jobStats.totalWaitDuration).count() << " ms (max = " << std::chrono::duration_cast<std::chrono::milliseconds>(jobStats.maxWaitDuration).count() << " ms), throughput = " << jobStats.throughput << " jobs/s");
+        });
+
         {
             auto transaction{ _db.getTLSSession().createReadTransaction() };
             const db::FileStats stats{ _db.getTLSSession().getFileStats() };
@@ -529,7 +547,9 @@ namespace lms::scanner
         _scanSteps.emplace_back(std::make_unique<ScanStepCompact>(params));
         _scanSteps.emplace_back(std::make_unique<ScanStepOptimize>(params));
         _scanSteps.emplace_back(std::make_unique<ScanStepComputeClusterStats>(params));
+        _scanSteps.emplace_back(std::make_unique<ScanStepRebuildListenStats>(params));
         _scanSteps.emplace_back(std::make_unique<ScanStepCheckForDuplicatedFiles>(params));
+        _scanSteps.emplace_back(std::make_unique<ScanStepRenderArtworkThumbnails>(params)); // must come after the image association steps
 
         // Audio extraction scan step must be last as it is the most long running
         if (_settings.extractMusicNNEmbeddings)
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileInfoSnapshot.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "core/XxHash3.hpp"
+
+namespace lms::scanner
+{
+    void FileInfoSnapshot::add(const std::filesystem::path& path, const Wt::WDateTime& lastWriteTime, std::size_t scanVersion)
+    {
+        _entries.push_back(Entry{
+            .pathHash = computePathHash(path),
+            .lastWriteTime = toSeconds(lastWriteTime),
+            .scanVersion = static_cast<std::uint32_t>(scanVersion),
+            .ambiguous = false,
+        });
+    }
+
+    void FileInfoSnapshot::finalize()
+    {
+        std::sort(std::begin(_entries), std::end(_entries), [](const Entry& lhs, const Entry& rhs) { return lhs.pathHash < rhs.pathHash; });
+
+        // Hash collisions are very unlikely, just make sure the colliding files are rescanned
+        for (std::size_t i{ 1 }; i < _entries.size(); ++i)
+        {
+            if (_entries[i].pathHash == _entries[i - 1].pathHash)
+            {
+                _entries[i].ambiguous = true;
+                _entries[i - 1].ambiguous = true;
+            }
+        }
+
+        _entries.shrink_to_fit();
+    }
+
+    bool FileInfoSnapshot::isUpToDate(const std::filesystem::path& path, const Wt::WDateTime& lastWriteTime, std::size_t scanVersion) const
+    {
+        const std::uint64_t pathHash{ computePathHash(path) };
+
+        const auto it{ std::lower_bound(std::cbegin(_entries), std::cend(_entries), pathHash, [](const Entry& entry, std::uint64_t hash) { return entry.pathHash < hash; }) };
+        if (it == std::cend(_entries) || it->pathHash != pathHash || it->ambiguous)
+            return false;
+
+        return it->lastWriteTime == toSeconds(lastWriteTime) && it->scanVersion == scanVersion;
+    }
+
+    std::uint64_t FileInfoSnapshot::computePathHash(const std::filesystem::path& path)
+    {
+        return core::XxHash3_64::hash(std::as_bytes(std::span{ path.native() }));
+    }
+
+    std::int64_t FileInfoSnapshot::toSeconds(const Wt::WDateTime& dateTime)
+    {
+        // never matches any file
+        if (!dateTime.isValid())
+            return std::numeric_limits<std::int64_t>::min();
+
+        return static_cast<std::int64_t>(dateTime.toTime_t());
+    }
+} // namespace lms::scanner
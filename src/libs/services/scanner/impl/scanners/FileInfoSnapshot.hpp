@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <Wt/WDateTime.h>
+
+namespace lms::scanner
+{
+    // Compact view of the files already known in the database, used to tell whether a file needs to be scanned
+    // Entries are keyed by the hash of their path, in a sorted flat array
+    // Once finalized, the snapshot is read-only and can be queried concurrently without any lock
+    class FileInfoSnapshot
+    {
+    public:
+        void add(const std::filesystem::path& path, const Wt::WDateTime& lastWriteTime, std::size_t scanVersion);
+        // Must be called once all the files have been added, and before any call to isUpToDate
+        void finalize();
+
+        // False if the file is unknown, or if it was modified or scanned with another scan version
+        bool isUpToDate(const std::filesystem::path& path, const Wt::WDateTime& lastWriteTime, std::size_t scanVersion) const;
+
+        std::size_t size() const { return _entries.size(); }
+
+    private:
+        struct Entry
+        {
+            std::uint64_t pathHash;
+            std::int64_t lastWriteTime; // seconds, as stored in the database
+            std::uint32_t scanVersion;
+            bool ambiguous; // another path has the same hash
+        };
+
+        static std::uint64_t computePathHash(const std::filesystem::path& path);
+        static std::int64_t toSeconds(const Wt::WDateTime& dateTime);
+
+        std::vector<Entry> _entries;
+    };
+} // namespace lms::scanner
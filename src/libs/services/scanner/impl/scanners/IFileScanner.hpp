@@ -28,6 +28,7 @@
 
 namespace lms::scanner
 {
+    class FileInfoSnapshot;
     class IFileScanOperation;
 
     class IFileScanner
@@ -38,7 +39,9 @@ namespace lms::scanner
         virtual core::LiteralString getName() const = 0;
         virtual std::span<const std::filesystem::path> getSupportedFiles() const = 0;
         virtual std::span<const std::filesystem::path> getSupportedExtensions() const = 0;
-        virtual bool needsScan(const FileToScan& file) const = 0;
+        // Adds the files already known in the database, so that needsScan does not need any further query
+        virtual void loadFileInfos(FileInfoSnapshot& snapshot) const = 0;
+        virtual bool needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const = 0;
         virtual std::unique_ptr<IFileScanOperation> createScanOperation(FileToScan&& fileToScan) const = 0;
     };
 } // namespace lms::scanner
\ No newline at end of file
@@ -90,6 +90,10 @@ namespace lms::scanner
                 image = dbSession.create<db::Image>(getFilePath());
                 dbSession.create<db::Artwork>(image);
             }
+            else if (db::Artwork::pointer artwork{ db::Artwork::find(dbSession, image->getId()) }; artwork && artwork->areThumbnailsRendered())
+            {
+                artwork.modify()->setThumbnailsRendered(false);
+            }
 
             image.modify()->setLastWriteTime(getLastWriteTime());
             image.modify()->setFileSize(getFileSize());
@@ -130,13 +134,14 @@ namespace lms::scanner
         return image::getSupportedFileExtensions();
     }
 
-    bool ImageFileScanner::needsScan(const FileToScan& file) const
+    void ImageFileScanner::loadFileInfos(FileInfoSnapshot& snapshot) const
     {
-        db::Session& dbSession{ _db.getTLSSession() };
-        auto transaction{ _db.getTLSSession().createReadTransaction() };
+        utils::loadFileInfos<db::Image>(_db.getTLSSession(), snapshot);
+    }
 
-        const db::Image::pointer image{ db::Image::find(dbSession, file.filePath) };
-        return (!image || image->getLastWriteTime() != file.lastWriteTime);
+    bool ImageFileScanner::needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const
+    {
+        return !snapshot.isUpToDate(file.filePath, file.lastWriteTime, 0);
     }
 
     std::unique_ptr<IFileScanOperation> ImageFileScanner::createScanOperation(FileToScan&& fileToScan) const
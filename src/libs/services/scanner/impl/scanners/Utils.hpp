@@ -22,6 +22,10 @@
 #include <filesystem>
 
 #include "database/Object.hpp"
+#include "database/Session.hpp"
+#include "database/objects/Types.hpp"
+
+#include "FileInfoSnapshot.hpp"
 
 namespace lms::db
 {
@@ -33,4 +37,24 @@ namespace lms::db
 namespace lms::scanner::utils
 {
     db::ObjectPtr<db::Directory> getOrCreateDirectory(db::Session& session, const std::filesystem::path& path, const db::ObjectPtr<db::MediaLibrary>& mediaLibrary);
+
+    // Adds the file infos of all the objects of the given type, using short read transactions
+    template<typename Object>
+    void loadFileInfos(db::Session& session, FileInfoSnapshot& snapshot)
+    {
+        constexpr std::size_t readBatchSize{ 1'000 };
+
+        typename Object::IdType lastRetrievedId;
+        std::size_t retrievedCount;
+        do
+        {
+            retrievedCount = 0;
+
+            auto transaction{ session.createReadTransaction() };
+            Object::findFileInfos(session, lastRetrievedId, readBatchSize, [&](const std::filesystem::path& absoluteFilePath, const db::FileInfo& fileInfo) {
+                snapshot.add(absoluteFilePath, fileInfo.lastWrittenTime, fileInfo.scanVersion);
+                retrievedCount++;
+            });
+        } while (retrievedCount == readBatchSize);
+    }
 } // namespace lms::scanner::utils
\ No newline at end of file
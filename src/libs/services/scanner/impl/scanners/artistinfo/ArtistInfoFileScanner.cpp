@@ -175,20 +175,19 @@ namespace lms::scanner
         return {};
     }
 
-    bool ArtistInfoFileScanner::needsScan(const FileToScan& file) const
+    void ArtistInfoFileScanner::loadFileInfos(FileInfoSnapshot& snapshot) const
+    {
+        utils::loadFileInfos<db::ArtistInfo>(_db.getTLSSession(), snapshot);
+    }
+
+    bool ArtistInfoFileScanner::needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const
     {
         // Special case: only files named "artist.nfo" are compatible with this scanner
         // Hack here since the scanner framework only handle extensions (the discover count is not accurate)
         if (!core::stringUtils::stringCaseInsensitiveEqual(file.filePath.stem().string(), "artist"))
             return false;
 
-        db::Session& dbSession{ _db.getTLSSession() };
-        auto transaction{ dbSession.createReadTransaction() };
-        db::ArtistInfo::pointer artistInfo{ db::ArtistInfo::find(dbSession, file.filePath) };
-
-        return !artistInfo
-            || artistInfo->getLastWriteTime() != file.lastWriteTime
-            || artistInfo->getScanVersion() != _settings.artistInfoScanVersion;
+        return !snapshot.isUpToDate(file.filePath, file.lastWriteTime, _settings.artistInfoScanVersion);
     }
 
     std::unique_ptr<IFileScanOperation> ArtistInfoFileScanner::createScanOperation(FileToScan&& fileToScan) const
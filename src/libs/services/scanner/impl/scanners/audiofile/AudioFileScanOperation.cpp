@@ -369,6 +369,11 @@ namespace lms::scanner
 
                 session.create<db::Artwork>(image);
             }
+            else if (db::Artwork::pointer artwork{ db::Artwork::find(session, image->getId()) }; artwork && artwork->areThumbnailsRendered())
+            {
+                // the thumbnails are tied to the last written time of the tracks embedding this image
+                artwork.modify()->setThumbnailsRendered(false);
+            }
 
             return image;
         }
@@ -380,6 +385,7 @@ namespace lms::scanner
             imageLink.modify()->setIndex(imageInfo.index);
             imageLink.modify()->setType(imageInfo.type);
             imageLink.modify()->setDescription(imageInfo.description);
+            imageLink.modify()->setDataOffset(imageInfo.dataOffset);
 
             return imageLink;
         }
@@ -561,6 +567,7 @@ namespace lms::scanner
                     info.mimeType = image.mimeType;
                     info.description = image.description;
                     info.properties = properties;
+                    info.dataOffset = image.dataOffset;
 
                     _file->images.push_back(std::move(info));
                 }
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "core/media/ImageType.hpp"
@@ -51,6 +53,7 @@ namespace lms::scanner
         image::ImageProperties properties;
         std::string mimeType;
         std::string description;
+        std::optional<std::uint64_t> dataOffset;
     };
 
     class AudioFileScanOperation : public FileScanOperationBase
@@ -71,15 +71,14 @@ namespace lms::scanner
         return _audioFileInfoParserSet.supportedExtensions;
     }
 
-    bool AudioFileScanner::needsScan(const FileToScan& file) const
+    void AudioFileScanner::loadFileInfos(FileInfoSnapshot& snapshot) const
     {
-        db::Session& dbSession{ _db.getTLSSession() };
-        auto transaction{ dbSession.createReadTransaction() };
+        utils::loadFileInfos<db::Track>(_db.getTLSSession(), snapshot);
+    }
 
-        std::optional<db::FileInfo> fileInfo{ db::Track::findFileInfo(dbSession, file.filePath) };
-        return !fileInfo
-            || fileInfo->lastWrittenTime != file.lastWriteTime
-            || fileInfo->scanVersion != _settings.audioScanVersion;
+    bool AudioFileScanner::needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const
+    {
+        return !snapshot.isUpToDate(file.filePath, file.lastWriteTime, _settings.audioScanVersion);
     }
 
     std::unique_ptr<IFileScanOperation> AudioFileScanner::createScanOperation(FileToScan&& fileToScan) const
@@ -138,13 +138,14 @@ namespace lms::scanner
         return getSupportedLyricsFileExtensions();
     }
 
-    bool LyricsFileScanner::needsScan(const FileToScan& file) const
+    void LyricsFileScanner::loadFileInfos(FileInfoSnapshot& snapshot) const
     {
-        db::Session& dbSession{ _db.getTLSSession() };
-        auto transaction{ _db.getTLSSession().createReadTransaction() };
+        utils::loadFileInfos<db::TrackLyrics>(_db.getTLSSession(), snapshot);
+    }
 
-        const db::TrackLyrics::pointer lyrics{ db::TrackLyrics::find(dbSession, file.filePath) };
-        return !lyrics || lyrics->getLastWriteTime() != file.lastWriteTime;
+    bool LyricsFileScanner::needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const
+    {
+        return !snapshot.isUpToDate(file.filePath, file.lastWriteTime, 0);
     }
 
     std::unique_ptr<IFileScanOperation> LyricsFileScanner::createScanOperation(FileToScan&& fileToScan) const
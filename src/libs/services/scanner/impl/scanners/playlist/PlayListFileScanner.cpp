@@ -134,13 +134,14 @@ namespace lms::scanner
         return getSupportedPlayListFileExtensions();
     }
 
-    bool PlayListFileScanner::needsScan(const FileToScan& file) const
+    void PlayListFileScanner::loadFileInfos(FileInfoSnapshot& snapshot) const
     {
-        db::Session& dbSession{ _db.getTLSSession() };
-        auto transaction{ _db.getTLSSession().createReadTransaction() };
+        utils::loadFileInfos<db::PlayListFile>(_db.getTLSSession(), snapshot);
+    }
 
-        const db::PlayListFile::pointer playList{ db::PlayListFile::find(dbSession, file.filePath) };
-        return !playList || playList->getLastWriteTime() != file.lastWriteTime;
+    bool PlayListFileScanner::needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const
+    {
+        return !snapshot.isUpToDate(file.filePath, file.lastWriteTime, 0);
     }
 
     std::unique_ptr<IFileScanOperation> PlayListFileScanner::createScanOperation(FileToScan&& fileToScan) const
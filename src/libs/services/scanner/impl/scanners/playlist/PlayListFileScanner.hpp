@@ -42,7 +42,8 @@ namespace lms::scanner
         core::LiteralString getName() const override;
         std::span<const std::filesystem::path> getSupportedFiles() const override;
         std::span<const std::filesystem::path> getSupportedExtensions() const override;
-        bool needsScan(const FileToScan& file) const override;
+        void loadFileInfos(FileInfoSnapshot& snapshot) const override;
+        bool needsScan(const FileToScan& file, const FileInfoSnapshot& snapshot) const override;
         std::unique_ptr<IFileScanOperation> createScanOperation(FileToScan&& fileToScan) const override;
 
         db::IDb& _db;
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DirectoryExplorer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include "core/IJob.hpp"
+#include "core/ILogger.hpp"
+
+#include "IgnoreRules.hpp"
+
+namespace lms::scanner
+{
+    namespace
+    {
+        // Lists a single directory, sub directories are reported to be explored by other jobs
+        class ExploreDirectoryJob : public core::IJob
+        {
+        public:
+            ExploreDirectoryJob(const DirectoryExplorer& explorer, const std::filesystem::path& rootDirectory, const std::filesystem::path& relativeDirectory, const IgnoreRules& ignoreRules)
+                : _explorer{ explorer }
+                , _rootDirectory{ rootDirectory }
+                , _relativeDirectory{ relativeDirectory }
+                , _ignoreRules{ ignoreRules }
+            {
+            }
+
+            const DirectoryExplorer& getExplorer() const { return _explorer; }
+            std::vector<std::filesystem::directory_entry>& getFiles() { return _files; }
+            std::vector<std::filesystem::path>& getSubDirectories() { return _subDirectories; }
+            std::vector<DirectoryExplorer::Error>& getErrors() { return _errors; }
+
+        private:
+            core::LiteralString getName() const override { return "Explore Directory"; }
+
+            void run() override
+            {
+                const std::filesystem::path directory{ _relativeDirectory.empty() ? _rootDirectory : _rootDirectory / _relativeDirectory };
+
+                std::error_code ec;
+                std::filesystem::directory_iterator itPath{ directory, std::filesystem::directory_options::follow_directory_symlink, ec };
+                const std::filesystem::directory_iterator itEnd;
+                for (; !ec && itPath != itEnd; itPath.increment(ec))
+                {
+                    const std::filesystem::directory_entry& entry{ *itPath };
+
+                    std::error_code entryEc;
+                    if (entry.is_regular_file(entryEc))
+                    {
+                        if (isIgnored(entry, IgnoreRules::IsDirectory{ false }))
+                        {
+                            LMS_LOG(DBUPDATER, DEBUG, "Ignoring file " << entry.path() << " (matched .lmsignore rule)");
+                            continue;
+                        }
+                        _files.push_back(entry);
+                    }
+                    else if (entry.is_directory(entryEc))
+                    {
+                        if (isIgnored(entry, IgnoreRules::IsDirectory{ true }))
+                        {
+                            LMS_LOG(DBUPDATER, DEBUG, "Ignoring directory " << entry.path() << " (matched .lmsignore rule)");
+                            continue;
+                        }
+                        _subDirectories.push_back(_relativeDirectory / entry.path().filename());
+                    }
+                }
+
+                if (ec)
+                    _errors.push_back(DirectoryExplorer::Error{ directory, ec });
+            }
+
+            bool isIgnored(const std::filesystem::directory_entry& entry, IgnoreRules::IsDirectory isDir) const
+            {
+                // Relative path is built from the parent one, much cheaper than calling std::filesystem::relative on each entry
+                return !_ignoreRules.isEmpty() && _ignoreRules.isIgnored(_relativeDirectory / entry.path().filename(), isDir);
+            }
+
+            const DirectoryExplorer& _explorer;
+            const std::filesystem::path& _rootDirectory;
+            const std::filesystem::path _relativeDirectory;
+            const IgnoreRules& _ignoreRules;
+
+            std::vector<std::filesystem::directory_entry> _files;
+            std::vector<std::filesystem::path> _subDirectories;
+            std::vector<DirectoryExplorer::Error> _errors;
+        };
+    } // namespace
+
+    DirectoryExplorer::DirectoryExplorer(const std::filesystem::path& rootDirectory, const IgnoreRules& ignoreRules)
+        : _rootDirectory{ rootDirectory }
+        , _ignoreRules{ ignoreRules }
+    {
+        _pendingDirectories.emplace_back();
+    }
+
+    DirectoryExplorer::~DirectoryExplorer() = default;
+
+    std::unique_ptr<core::IJob> DirectoryExplorer::createNextJob()
+    {
+        if (_pendingDirectories.empty())
+            return nullptr;
+
+        auto job{ std::make_unique<ExploreDirectoryJob>(*this, _rootDirectory, _pendingDirectories.back(), _ignoreRules) };
+        _pendingDirectories.pop_back();
+        _ongoingJobCount++;
+
+        return job;
+    }
+
+    bool DirectoryExplorer::processJobDone(core::IJob& job, std::vector<std::filesystem::directory_entry>& files, std::vector<Error>& errors)
+    {
+        auto* exploreJob{ dynamic_cast<ExploreDirectoryJob*>(&job) };
+        if (!exploreJob || &exploreJob->getExplorer() != this)
+            return false;
+
+        assert(_ongoingJobCount > 0);
+        _ongoingJobCount--;
+
+        std::vector<std::filesystem::directory_entry>& jobFiles{ exploreJob->getFiles() };
+        files.insert(std::end(files), std::make_move_iterator(std::begin(jobFiles)), std::make_move_iterator(std::end(jobFiles)));
+
+        std::vector<Error>& jobErrors{ exploreJob->getErrors() };
+        errors.insert(std::end(errors), std::make_move_iterator(std::begin(jobErrors)), std::make_move_iterator(std::end(jobErrors)));
+
+        // Reversed so that sub directories are explored in listing order
+        std::vector<std::filesystem::path>& subDirectories{ exploreJob->getSubDirectories() };
+        std::move(std::rbegin(subDirectories), std::rend(subDirectories), std::back_inserter(_pendingDirectories));
+
+        return true;
+    }
+} // namespace lms::scanner
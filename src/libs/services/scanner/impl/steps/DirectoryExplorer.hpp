@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+namespace lms::core
+{
+    class IJob;
+}
+
+namespace lms::scanner
+{
+    class IgnoreRules;
+
+    // Explores a directory tree using one job per directory, so that directories can be listed in parallel
+    // Jobs are expected to be scheduled by the caller (see JobQueue), and their results fed back using processJobDone
+    class DirectoryExplorer
+    {
+    public:
+        DirectoryExplorer(const std::filesystem::path& rootDirectory, const IgnoreRules& ignoreRules);
+        ~DirectoryExplorer();
+        DirectoryExplorer(const DirectoryExplorer&) = delete;
+        DirectoryExplorer& operator=(const DirectoryExplorer&) = delete;
+
+        // true when all the directories have been explored and all the jobs processed
+        bool isComplete() const { return _pendingDirectories.empty() && _ongoingJobCount == 0; }
+
+        // Returns nullptr if there is no directory left to explore for now
+        std::unique_ptr<core::IJob> createNextJob();
+
+        struct Error
+        {
+            std::filesystem::path path;
+            std::error_code ec;
+        };
+        // Returns false if the job was not created by this explorer
+        bool processJobDone(core::IJob& job, std::vector<std::filesystem::directory_entry>& files, std::vector<Error>& errors);
+
+    private:
+        const std::filesystem::path _rootDirectory;
+        const IgnoreRules& _ignoreRules;
+        std::vector<std::filesystem::path> _pendingDirectories; // relative to root, depth first
+        std::size_t _ongoingJobCount{};
+    };
+} // namespace lms::scanner
@@ -41,12 +41,22 @@ namespace lms::scanner
         finish();
     }
 
-    void JobQueue::push(std::unique_ptr<core::IJob> job)
+    void JobQueue::push(std::unique_ptr<core::IJob> job, core::JobPriority priority)
     {
-        _scheduler.scheduleJob(std::move(job));
+        _scheduler.scheduleJob(std::move(job), priority);
         drainIfNeeded();
     }
 
+    void JobQueue::processJobsDone()
+    {
+        _scheduler.waitUntilAnyJobDone();
+        while (_scheduler.popJobsDone(_jobsDone, _batchSize) > 0)
+        {
+            _processJobsDoneFunc(std::span{ _jobsDone });
+            _jobsDone.clear();
+        }
+    }
+
     void JobQueue::finish()
     {
         _scheduler.wait();
@@ -24,10 +24,11 @@
 #include <span>
 #include <vector>
 
+#include "core/IJobScheduler.hpp"
+
 namespace lms::core
 {
     class IJob;
-    class IJobScheduler;
 } // namespace lms::core
 
 namespace lms::scanner
@@ -50,7 +51,9 @@ namespace lms::scanner
         JobQueue& operator=(const JobQueue&) = delete;
 
         // push can wait and invoke the supplied ProcessFunction
-        void push(std::unique_ptr<core::IJob> job);
+        void push(std::unique_ptr<core::IJob> job, core::JobPriority priority = core::JobPriority::Background);
+        // Wait for some jobs to complete (if any is ongoing) and invoke the supplied ProcessFunction
+        void processJobsDone();
         void finish();
 
     private:
@@ -40,54 +40,18 @@ namespace lms::scanner
 
         Session& dbSession{ _db.getTLSSession() };
 
-        const std::size_t clusterCount{ [&] {
-            auto transaction{ dbSession.createReadTransaction() };
-            return Cluster::getCount(dbSession);
-        }() };
+        // Recomputing all the clusters at once is way faster than doing it cluster per cluster, even if only a few of them changed
+        std::size_t updatedClusterCount;
+        {
+            auto transaction{ dbSession.createWriteTransaction() };
 
-        context.currentStepStats.totalElems = clusterCount;
+            context.currentStepStats.totalElems = Cluster::getCount(dbSession);
+            updatedClusterCount = Cluster::updateCounts(dbSession);
+        }
 
-        foreachSubRange(Range{ 0, clusterCount }, 100, [&](Range range) {
-            const std::vector<ClusterId> clusterIds{ [&] {
-                Cluster::FindParameters params;
-                params.setRange(range);
+        context.currentStepStats.processedElems = context.currentStepStats.totalElems;
+        _progressCallback(context.currentStepStats);
 
-                {
-                    auto transaction{ dbSession.createReadTransaction() };
-                    return std::move(Cluster::findIds(dbSession, params).results);
-                }
-            }() };
-
-            for (const ClusterId clusterId : clusterIds)
-            {
-                if (_abortScan)
-                    break;
-
-                std::size_t trackCount;
-                std::size_t releaseCount;
-
-                {
-                    auto transaction{ dbSession.createReadTransaction() };
-
-                    trackCount = Cluster::computeTrackCount(dbSession, clusterId);
-                    releaseCount = Cluster::computeReleaseCount(dbSession, clusterId);
-                }
-
-                {
-                    auto transaction{ dbSession.createWriteTransaction() };
-
-                    auto cluster{ Cluster::find(dbSession, clusterId) };
-                    cluster.modify()->setTrackCount(trackCount);
-                    cluster.modify()->setReleaseCount(releaseCount);
-                }
-
-                context.currentStepStats.processedElems++;
-                _progressCallback(context.currentStepStats);
-            }
-
-            return true;
-        });
-
-        LMS_LOG(DBUPDATER, DEBUG, "Recomputed stats for " << context.currentStepStats.processedElems << " clusters!");
+        LMS_LOG(DBUPDATER, DEBUG, "Recomputed stats for " << context.currentStepStats.processedElems << " clusters, " << updatedClusterCount << " updated!");
     }
 } // namespace lms::scanner
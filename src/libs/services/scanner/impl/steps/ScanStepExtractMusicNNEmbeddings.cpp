@@ -19,8 +19,10 @@
 
 #include "ScanStepExtractMusicNNEmbeddings.hpp"
 
+#include <chrono>
 #include <deque>
 #include <optional>
+#include <unordered_set>
 
 #include "core/IJob.hpp"
 #include "core/IJobScheduler.hpp"
@@ -31,9 +33,11 @@
 #include "audio/MusicNNEmbeddings.hpp"
 #include "database/IDb.hpp"
 #include "database/Session.hpp"
+#include "database/objects/Listen.hpp"
 #include "database/objects/ScanSettings.hpp"
 #include "database/objects/Track.hpp"
 #include "database/objects/TrackMusicNNEmbeddings.hpp"
+#include "database/objects/User.hpp"
 #include "services/scanner/ScanErrors.hpp"
 
 #include "JobQueue.hpp"
@@ -79,6 +83,35 @@ namespace lms::scanner
             return trackLocation.track.isValid();
         }
 
+        // Tracks being played are likely to be used soon as seeds for similarity searches
+        // Only the ones not yet reached by the main walk, as the other ones are being or have already been extracted
+        std::vector<TrackLocation> fetchRecentlyPlayedTracksWithoutEmbeddings(db::Session& session, db::TrackId lastRetrievedTrackId, const std::unordered_set<db::TrackId>& scheduledTrackIds)
+        {
+            constexpr std::size_t maxRecentTrackCountPerUser{ 10 };
+
+            std::vector<TrackLocation> trackLocations;
+
+            auto transaction{ session.createReadTransaction() };
+
+            for (const db::UserId userId : db::User::find(session, db::User::FindParameters{}).results)
+            {
+                db::Listen::StatsFindParameters params;
+                params.setUser(userId);
+                params.setRange(db::Range{ .offset = 0, .size = maxRecentTrackCountPerUser });
+
+                for (const db::TrackId trackId : db::Listen::getRecentTracks(session, params).results)
+                {
+                    if (trackId <= lastRetrievedTrackId || scheduledTrackIds.contains(trackId) || db::TrackMusicNNEmbeddings::find(session, trackId))
+                        continue;
+
+                    if (const db::Track::pointer track{ db::Track::find(session, trackId) })
+                        trackLocations.push_back(TrackLocation{ .track = trackId, .trackPath = track->getAbsoluteFilePath() });
+                }
+            }
+
+            return trackLocations;
+        }
+
         class ExtractMusicNNEmbeddingsJob : public core::IJob
         {
         public:
@@ -216,10 +249,29 @@ namespace lms::scanner
         {
             JobQueue queue{ getJobScheduler(), processResults, { .maxQueueSize = 50 } };
 
+            // Extracting a whole library can take hours: regularly look for the tracks played meanwhile
+            constexpr std::chrono::seconds recentlyPlayedTracksCheckPeriod{ 30 };
+            std::chrono::steady_clock::time_point nextRecentlyPlayedTracksCheck{};
+            std::unordered_set<db::TrackId> recentlyPlayedTrackIds; // skipped by the main walk
+
             db::TrackId lastRetrievedTrackId;
             TrackLocation trackLocation;
             while (!_abortScan && fetchNextTrackWithoutEmbeddings(dbSession, lastRetrievedTrackId, trackLocation))
-                queue.push(std::make_unique<ExtractMusicNNEmbeddingsJob>(*_embeddingExtractor, trackLocation));
+            {
+                if (const auto now{ std::chrono::steady_clock::now() }; now >= nextRecentlyPlayedTracksCheck)
+                {
+                    for (const TrackLocation& recentlyPlayedTrackLocation : fetchRecentlyPlayedTracksWithoutEmbeddings(dbSession, lastRetrievedTrackId, recentlyPlayedTrackIds))
+                    {
+                        LMS_LOG(DBUPDATER, DEBUG, "Prioritizing MusicNN embeddings extraction of recently played " << recentlyPlayedTrackLocation.trackPath);
+                        recentlyPlayedTrackIds.insert(recentlyPlayedTrackLocation.track);
+                        queue.push(std::make_unique<ExtractMusicNNEmbeddingsJob>(*_embeddingExtractor, recentlyPlayedTrackLocation), core::JobPriority::Interactive);
+                    }
+                    nextRecentlyPlayedTracksCheck = now + recentlyPlayedTracksCheckPeriod;
+                }
+
+                if (!recentlyPlayedTrackIds.contains(trackLocation.track))
+                    queue.push(std::make_unique<ExtractMusicNNEmbeddingsJob>(*_embeddingExtractor, trackLocation));
+            }
         }
 
         writeEmbeddings(context, dbSession, pendingAssocs, false);
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ScanStepRebuildListenStats.hpp"
+
+#include "core/ILogger.hpp"
+#include "database/IDb.hpp"
+#include "database/Session.hpp"
+#include "database/objects/Listen.hpp"
+
+#include "ScanContext.hpp"
+
+namespace lms::scanner
+{
+    bool ScanStepRebuildListenStats::needProcess(const ScanContext& context) const
+    {
+        // Stats are maintained each time a listen is added, only resync them on full scans
+        return context.scanOptions.fullScan;
+    }
+
+    void ScanStepRebuildListenStats::process([[maybe_unused]] ScanContext& context)
+    {
+        LMS_LOG(DBUPDATER, DEBUG, "Rebuilding listen stats...");
+
+        auto& session{ _db.getTLSSession() };
+        {
+            auto transaction{ session.createWriteTransaction() };
+            db::Listen::rebuildStats(session);
+        }
+
+        LMS_LOG(DBUPDATER, DEBUG, "Listen stats rebuilt");
+    }
+} // namespace lms::scanner
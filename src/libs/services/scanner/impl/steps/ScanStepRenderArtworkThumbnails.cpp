@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ScanStepRenderArtworkThumbnails.hpp"
+
+#include <ctime>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/IJob.hpp"
+#include "core/ILogger.hpp"
+#include "core/Service.hpp"
+
+#include "database/IDb.hpp"
+#include "database/Session.hpp"
+#include "database/objects/Artwork.hpp"
+#include "services/artwork/IArtworkService.hpp"
+
+#include "JobQueue.hpp"
+#include "ScanContext.hpp"
+
+namespace lms::scanner
+{
+    namespace
+    {
+        constexpr std::size_t readArtworkBatchSize{ 100 };
+        constexpr std::size_t writeArtworkBatchSize{ 50 };
+
+        using ArtworkTimestampMap = std::unordered_map<db::ArtworkId, std::time_t>;
+
+        bool fetchNextArtworkTimestamps(db::Session& session, db::ArtworkId& lastRetrievedId, ArtworkTimestampMap& artworkTimestamps)
+        {
+            const db::ArtworkId previousLastRetrievedId{ lastRetrievedId };
+
+            auto transaction{ session.createReadTransaction() };
+            db::Artwork::findLastWrittenTime(session, lastRetrievedId, readArtworkBatchSize, [&](db::ArtworkId artworkId, const Wt::WDateTime& lastWrittenTime) {
+                artworkTimestamps.emplace(artworkId, lastWrittenTime.toTime_t());
+            });
+
+            return previousLastRetrievedId != lastRetrievedId;
+        }
+
+        bool fetchNextArtworkIdsWithoutRenderedThumbnails(db::Session& session, db::ArtworkId& lastRetrievedId, std::vector<db::ArtworkId>& artworkIds)
+        {
+            const db::ArtworkId previousLastRetrievedId{ lastRetrievedId };
+
+            auto transaction{ session.createReadTransaction() };
+            db::Artwork::findIdsWithoutRenderedThumbnails(session, lastRetrievedId, readArtworkBatchSize, [&](db::ArtworkId artworkId) {
+                artworkIds.push_back(artworkId);
+            });
+
+            return previousLastRetrievedId != lastRetrievedId;
+        }
+
+        bool fetchNextArtworkIds(db::Session& session, db::ArtworkId& lastRetrievedId, std::unordered_set<db::ArtworkId>& artworkIds)
+        {
+            const db::ArtworkId previousLastRetrievedId{ lastRetrievedId };
+
+            auto transaction{ session.createReadTransaction() };
+            db::Artwork::findIds(session, lastRetrievedId, readArtworkBatchSize, [&](db::ArtworkId artworkId) {
+                artworkIds.insert(artworkId);
+            });
+
+            return previousLastRetrievedId != lastRetrievedId;
+        }
+
+        void markThumbnailsRendered(db::Session& session, std::vector<db::ArtworkId>& artworkIds)
+        {
+            if (artworkIds.empty())
+                return;
+
+            auto transaction{ session.createWriteTransaction() };
+
+            for (const db::ArtworkId artworkId : artworkIds)
+            {
+                db::Artwork::pointer artwork{ db::Artwork::find(session, artworkId) };
+                if (artwork && !artwork->areThumbnailsRendered())
+                    artwork.modify()->setThumbnailsRendered(true);
+            }
+
+            artworkIds.clear();
+        }
+
+        class RenderArtworkThumbnailsJob : public core::IJob
+        {
+        public:
+            RenderArtworkThumbnailsJob(artwork::IArtworkService& artworkService, db::ArtworkId artworkId)
+                : _artworkService{ artworkService }
+                , _artworkId{ artworkId }
+            {
+            }
+            ~RenderArtworkThumbnailsJob() override = default;
+            RenderArtworkThumbnailsJob(const RenderArtworkThumbnailsJob&) = delete;
+            RenderArtworkThumbnailsJob& operator=(const RenderArtworkThumbnailsJob&) = delete;
+
+            db::ArtworkId getArtworkId() const { return _artworkId; }
+
+        private:
+            core::LiteralString getName() const override { return "Render Artwork Thumbnails"; }
+
+            void run() override
+            {
+                _artworkService.renderThumbnails(_artworkId);
+            }
+
+            artwork::IArtworkService& _artworkService;
+            const db::ArtworkId _artworkId;
+        };
+    } // namespace
+
+    bool ScanStepRenderArtworkThumbnails::needProcess([[maybe_unused]] const ScanContext& context) const
+    {
+        return core::Service<artwork::IArtworkService>::exists();
+    }
+
+    void ScanStepRenderArtworkThumbnails::process(ScanContext& context)
+    {
+        artwork::IArtworkService& artworkService{ *core::Service<artwork::IArtworkService>::get() };
+        db::Session& session{ _db.getTLSSession() };
+
+        // Artworks are flagged once their thumbnails are rendered, and the scanner resets this flag when the source is modified.
+        // Full scans check all the thumbnails against the timestamp of their source: this catches up with the thumbnail settings
+        // and with the sources whose timestamp changed without being flagged (removed tracks, etc.)
+        const bool fullScan{ context.scanOptions.fullScan };
+
+        ArtworkTimestampMap artworkTimestamps;
+        std::vector<db::ArtworkId> artworkIds;
+        db::ArtworkId lastRetrievedId;
+        if (fullScan)
+        {
+            while (!_abortScan && fetchNextArtworkTimestamps(session, lastRetrievedId, artworkTimestamps))
+                ;
+
+            artworkIds.reserve(artworkTimestamps.size());
+            for (const auto& [artworkId, sourceTimestamp] : artworkTimestamps)
+                artworkIds.push_back(artworkId);
+        }
+        else
+        {
+            while (!_abortScan && fetchNextArtworkIdsWithoutRenderedThumbnails(session, lastRetrievedId, artworkIds))
+                ;
+        }
+
+        if (_abortScan)
+            return;
+
+        context.currentStepStats.totalElems = artworkIds.size();
+
+        std::vector<db::ArtworkId> renderedArtworkIds;
+        auto processResults{ [&](std::span<std::unique_ptr<core::IJob>> jobs) {
+            for (const auto& job : jobs)
+                renderedArtworkIds.push_back(static_cast<const RenderArtworkThumbnailsJob&>(*job).getArtworkId());
+
+            if (renderedArtworkIds.size() >= writeArtworkBatchSize)
+                markThumbnailsRendered(session, renderedArtworkIds);
+
+            context.currentStepStats.processedElems += jobs.size();
+            _progressCallback(context.currentStepStats);
+        } };
+
+        std::size_t renderCount{};
+        {
+            JobQueue queue{ getJobScheduler(), processResults, { .maxQueueSize = 50 } };
+
+            for (const db::ArtworkId artworkId : artworkIds)
+            {
+                if (_abortScan)
+                    break;
+
+                if (fullScan && artworkService.hasThumbnails(artworkId, artworkTimestamps.at(artworkId)))
+                {
+                    renderedArtworkIds.push_back(artworkId);
+                    if (renderedArtworkIds.size() >= writeArtworkBatchSize)
+                        markThumbnailsRendered(session, renderedArtworkIds);
+
+                    context.currentStepStats.processedElems++;
+                    continue;
+                }
+
+                queue.push(std::make_unique<RenderArtworkThumbnailsJob>(artworkService, artworkId));
+                renderCount++;
+            }
+        }
+        markThumbnailsRendered(session, renderedArtworkIds);
+
+        if (_abortScan)
+            return;
+
+        if (fullScan)
+        {
+            // Thumbnails of removed artworks, or rendered from an older version of the source
+            artworkService.removeThumbnails([&](db::ArtworkId artworkId, std::time_t sourceTimestamp) {
+                const auto it{ artworkTimestamps.find(artworkId) };
+                return it == std::cend(artworkTimestamps) || it->second != sourceTimestamp;
+            });
+        }
+        else if (context.stats.getChangesCount() > 0)
+        {
+            // Thumbnails of removed artworks, the ones of modified artworks have been replaced when rendered again
+            std::unordered_set<db::ArtworkId> existingArtworkIds;
+            lastRetrievedId = {};
+            while (!_abortScan && fetchNextArtworkIds(session, lastRetrievedId, existingArtworkIds))
+                ;
+
+            if (_abortScan)
+                return;
+
+            artworkService.removeThumbnails([&](db::ArtworkId artworkId, std::time_t) {
+                return !existingArtworkIds.contains(artworkId);
+            });
+        }
+
+        LMS_LOG(DBUPDATER, DEBUG, "Rendered thumbnails for " << renderCount << " artworks");
+    }
+} // namespace lms::scanner
@@ -19,6 +19,7 @@
 
 #include "ScanStepScanFiles.hpp"
 
+#include <algorithm>
 #include <deque>
 
 #include "ScannerSettings.hpp"
@@ -28,12 +29,13 @@
 #include "core/ITraceLogger.hpp"
 #include "database/IDb.hpp"
 #include "database/Session.hpp"
+#include "scanners/FileInfoSnapshot.hpp"
 #include "scanners/FileToScan.hpp"
 #include "scanners/IFileScanOperation.hpp"
 #include "scanners/IFileScanner.hpp"
 
+#include "DirectoryExplorer.hpp"
 #include "FileScanners.hpp"
-#include "IgnoreRules.hpp"
 #include "JobQueue.hpp"
 #include "ScanContext.hpp"
 
@@ -41,67 +43,12 @@ namespace lms::scanner
 {
     namespace
     {
-        using ExploreFileCallback = std::function<bool(std::error_code, const std::filesystem::path& path, const std::filesystem::directory_entry*)>;
-        using ShouldIgnoreCallback = std::function<bool(const std::filesystem::path& absPath, IgnoreRules::IsDirectory)>;
-
-        bool exploreFilesRecursive(const std::filesystem::path& directory, const ExploreFileCallback& cb, const ShouldIgnoreCallback& shouldIgnore)
-        {
-            std::error_code ec;
-            std::filesystem::directory_iterator itPath{ directory, std::filesystem::directory_options::follow_directory_symlink, ec };
-
-            if (ec)
-            {
-                cb(ec, directory, nullptr);
-                return true; // try to continue exploring anyway
-            }
-
-            std::filesystem::directory_iterator itEnd;
-            while (itPath != itEnd)
-            {
-                bool continueExploring{ true };
-
-                const std::filesystem::directory_entry& entry{ *itPath };
-                const std::filesystem::path& path{ entry.path() };
-
-                if (ec)
-                {
-                    continueExploring = cb(ec, path, nullptr);
-                }
-                else if (entry.is_regular_file())
-                {
-                    if (shouldIgnore(path, IgnoreRules::IsDirectory{ false }))
-                    {
-                        LMS_LOG(DBUPDATER, DEBUG, "Ignoring file " << path << " (matched .lmsignore rule)");
-                        itPath.increment(ec);
-                        continue;
-                    }
-                    continueExploring = cb(ec, path, &entry);
-                }
-                else if (entry.is_directory())
-                {
-                    if (shouldIgnore(path, IgnoreRules::IsDirectory{ true }))
-                    {
-                        LMS_LOG(DBUPDATER, DEBUG, "Ignoring directory " << path << " (matched .lmsignore rule)");
-                        itPath.increment(ec);
-                        continue;
-                    }
-                    continueExploring = exploreFilesRecursive(path, cb, shouldIgnore);
-                }
-
-                if (!continueExploring)
-                    return false;
-
-                itPath.increment(ec);
-            }
-
-            return true;
-        }
-
         class FileScanJob : public core::IJob
         {
         public:
-            FileScanJob(const FileScanners& fileScanners, const MediaLibraryInfo& mediaLibrary, bool fullScan, std::span<const std::filesystem::directory_entry> files)
+            FileScanJob(const FileScanners& fileScanners, const FileInfoSnapshot& fileInfos, const MediaLibraryInfo& mediaLibrary, bool fullScan, std::span<const std::filesystem::directory_entry> files)
                 : _fileScanners{ fileScanners }
+                , _fileInfos{ fileInfos }
                 , _mediaLibrary{ mediaLibrary }
                 , _fullScan{ fullScan }
                 , _processCount{}
@@ -141,7 +88,7 @@ namespace lms::scanner
                     }
                     fileToScan.fileSize = file.file_size();
 
-                    if (_fullScan || scanner->needsScan(fileToScan))
+                    if (_fullScan || scanner->needsScan(fileToScan, _fileInfos))
                     {
                         auto scanOperation{ scanner->createScanOperation(std::move(fileToScan)) };
 
@@ -155,10 +102,14 @@ namespace lms::scanner
                         _skipCount++;
 
                     _processCount++;
+
+                    // a scan job may take a while: let more urgent jobs run in between files
+                    core::yieldToInteractiveJobs();
                 }
             }
 
             const FileScanners& _fileScanners;
+            const FileInfoSnapshot& _fileInfos;
             const MediaLibraryInfo& _mediaLibrary;
             const bool _fullScan;
             std::size_t _processCount;
@@ -176,13 +127,27 @@ namespace lms::scanner
 
     void ScanStepScanFiles::process(ScanContext& context)
     {
+        // Load all the known files at once, so that the scan jobs do not have to query the database for each file
+        FileInfoSnapshot fileInfos;
+        if (!context.scanOptions.fullScan)
+        {
+            LMS_SCOPED_TRACE_OVERVIEW("Scanner", "LoadFileInfos");
+
+            getFileScanners().visit([&](const IFileScanner& scanner) {
+                scanner.loadFileInfos(fileInfos);
+            });
+            fileInfos.finalize();
+
+            LMS_LOG(DBUPDATER, DEBUG, "Loaded " << fileInfos.size() << " known files");
+        }
+
         for (const MediaLibraryInfo& mediaLibrary : _settings.mediaLibraries)
-            process(context, mediaLibrary);
+            process(context, mediaLibrary, fileInfos);
 
         context.stats.totalFileCount = context.currentStepStats.processedElems;
     }
 
-    void ScanStepScanFiles::process(ScanContext& context, const MediaLibraryInfo& mediaLibrary)
+    void ScanStepScanFiles::process(ScanContext& context, const MediaLibraryInfo& mediaLibrary, const FileInfoSnapshot& fileInfos)
     {
         constexpr std::size_t filesPerScanJob{ 10 };
         constexpr std::size_t scanQueueMaxSize{ 50 };
@@ -191,9 +156,17 @@ namespace lms::scanner
 
         std::deque<std::unique_ptr<IFileScanOperation>> operations;
 
+        DirectoryExplorer explorer{ mediaLibrary.rootDirectory, mediaLibrary.ignoreRules };
+        // Jobs cannot be pushed from processDoneJobs: reported files are buffered and dispatched by the main loop
+        std::vector<std::filesystem::directory_entry> filesToScan;
+        std::vector<DirectoryExplorer::Error> exploreErrors;
+
         auto processDoneJobs = [&](std::span<std::unique_ptr<core::IJob>> jobsDone) {
             for (const auto& jobDone : jobsDone)
             {
+                if (explorer.processJobDone(*jobDone, filesToScan, exploreErrors))
+                    continue;
+
                 auto& fileScanJob{ static_cast<FileScanJob&>(*jobDone) };
                 for (std::unique_ptr<IFileScanOperation>& scanOperation : fileScanJob.getScanOperations())
                     operations.push_back(std::move(scanOperation));
@@ -202,6 +175,13 @@ namespace lms::scanner
                 context.stats.skips += fileScanJob.getSkipCount();
             }
 
+            for (const DirectoryExplorer::Error& error : exploreErrors)
+            {
+                addError<IOScanError>(context, error.path, error.ec);
+                context.stats.skips++;
+            }
+            exploreErrors.clear();
+
             if (!_abortScan)
                 processFileScanOperations(context, operations, true /* force batch */);
 
@@ -211,42 +191,28 @@ namespace lms::scanner
         {
             JobQueue queue{ getJobScheduler(), processDoneJobs, { .maxQueueSize = scanQueueMaxSize, .processBatchSize = processFileResultsBatchSize, .drainThreshold = drainRatio } };
 
-            std::vector<std::filesystem::directory_entry> filesToScan;
-
-            exploreFilesRecursive(
-                mediaLibrary.rootDirectory,
-                [&](std::error_code ec, const std::filesystem::path& path, const std::filesystem::directory_entry* fileEntry) {
-                    LMS_SCOPED_TRACE_DETAILED("Scanner", "OnExploreFile");
-
-                    assert((ec && !fileEntry) || (!ec && fileEntry));
-
-                    if (_abortScan)
-                        return false; // stop iterating
-
-                    if (ec)
-                    {
-                        addError<IOScanError>(context, path, ec);
-                        context.stats.skips++;
-                    }
-                    else
-                    {
-                        filesToScan.push_back(*fileEntry);
-
-                        if (filesToScan.size() >= filesPerScanJob)
-                        {
-                            queue.push(std::make_unique<FileScanJob>(getFileScanners(), mediaLibrary, context.scanOptions.fullScan, filesToScan));
-                            filesToScan.clear();
-                        }
-                    }
+            auto pushFileScanJobs = [&](std::size_t minFileCount) {
+                std::size_t offset{};
+                while (!_abortScan && offset < filesToScan.size() && filesToScan.size() - offset >= minFileCount)
+                {
+                    const std::size_t fileCount{ std::min(filesPerScanJob, filesToScan.size() - offset) };
+                    queue.push(std::make_unique<FileScanJob>(getFileScanners(), fileInfos, mediaLibrary, context.scanOptions.fullScan, std::span{ filesToScan }.subspan(offset, fileCount)));
+                    offset += fileCount;
+                }
+                filesToScan.erase(std::begin(filesToScan), std::next(std::begin(filesToScan), offset));
+            };
 
-                    return true;
-                },
-                [&](const std::filesystem::path& path, IgnoreRules::IsDirectory isDir) {
-                    return !mediaLibrary.ignoreRules.isEmpty() && mediaLibrary.ignoreRules.isIgnored(std::filesystem::relative(path, mediaLibrary.rootDirectory), isDir);
-                });
+            // Directories are listed in parallel by the scheduler threads, along with the file scan jobs
+            while (!_abortScan && !explorer.isComplete())
+            {
+                if (std::unique_ptr<core::IJob> exploreJob{ explorer.createNextJob() })
+                    queue.push(std::move(exploreJob));
+                else
+                    queue.processJobsDone();
 
-            if (!filesToScan.empty())
-                queue.push(std::make_unique<FileScanJob>(getFileScanners(), mediaLibrary, context.scanOptions.fullScan, filesToScan));
+                pushFileScanJobs(filesPerScanJob);
+            }
+            pushFileScanJobs(1);
 
             _progressCallback(context.currentStepStats);
         }
@@ -30,6 +30,7 @@ namespace lms::core
 
 namespace lms::scanner
 {
+    class FileInfoSnapshot;
     class IFileScanOperation;
     struct MediaLibraryInfo;
 
@@ -44,7 +45,7 @@ namespace lms::scanner
         bool needProcess(const ScanContext& context) const override;
         void process(ScanContext& context) override;
 
-        void process(ScanContext& context, const MediaLibraryInfo& mediaLibrary);
+        void process(ScanContext& context, const MediaLibraryInfo& mediaLibrary, const FileInfoSnapshot& fileInfos);
         std::size_t processFileScanOperations(ScanContext& context, std::deque<std::unique_ptr<IFileScanOperation>>& scanOperations, bool forceBatch);
         void processFileScanOperation(ScanContext& context, IFileScanOperation& operation);
     };
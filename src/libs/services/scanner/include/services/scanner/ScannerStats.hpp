@@ -57,9 +57,11 @@ namespace lms::scanner
         Compact,
         ExtractMusicNNEmbeddings,
         Optimize,
+        RebuildListenStats,
         ReconciliateArtists,
         ReloadRecommendationEngine,
         RemoveOrphanedDbEntries,
+        RenderArtworkThumbnails,
         ScanFiles,
         UpdateLibraryFields,
     };
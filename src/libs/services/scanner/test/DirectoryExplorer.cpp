@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "core/IJob.hpp"
+#include "core/IJobScheduler.hpp"
+
+#include "IgnoreRules.hpp"
+#include "steps/DirectoryExplorer.hpp"
+#include "steps/JobQueue.hpp"
+
+namespace lms::scanner::tests
+{
+    namespace
+    {
+        std::set<std::filesystem::path> exploreAll(const std::filesystem::path& rootDirectory, const IgnoreRules& ignoreRules, std::vector<DirectoryExplorer::Error>& errors)
+        {
+            const auto scheduler{ core::createJobScheduler("Explore", 2) };
+
+            DirectoryExplorer explorer{ rootDirectory, ignoreRules };
+            std::vector<std::filesystem::directory_entry> files;
+
+            auto processDoneJobs = [&](std::span<std::unique_ptr<core::IJob>> jobsDone) {
+                for (const auto& jobDone : jobsDone)
+                    EXPECT_TRUE(explorer.processJobDone(*jobDone, files, errors));
+            };
+
+            {
+                JobQueue queue{ *scheduler, processDoneJobs, { .maxQueueSize = 4 } };
+                while (!explorer.isComplete())
+                {
+                    if (std::unique_ptr<core::IJob> job{ explorer.createNextJob() })
+                        queue.push(std::move(job));
+                    else
+                        queue.processJobsDone();
+                }
+            }
+
+            std::set<std::filesystem::path> res;
+            std::transform(std::cbegin(files), std::cend(files), std::inserter(res, std::end(res)), [&](const std::filesystem::directory_entry& file) { return std::filesystem::relative(file.path(), rootDirectory); });
+            return res;
+        }
+
+        class DirectoryExplorerTest : public ::testing::Test
+        {
+        protected:
+            void SetUp() override
+            {
+                _rootDirectory = std::filesystem::temp_directory_path() / ("lms-test-explorer-" + std::string{ ::testing::UnitTest::GetInstance()->current_test_info()->name() });
+                std::filesystem::remove_all(_rootDirectory);
+                std::filesystem::create_directories(_rootDirectory);
+            }
+
+            void TearDown() override
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(_rootDirectory, ec);
+            }
+
+            void createFile(const std::filesystem::path& relativePath)
+            {
+                std::filesystem::create_directories((_rootDirectory / relativePath).parent_path());
+                std::ofstream{ _rootDirectory / relativePath };
+            }
+
+            std::filesystem::path _rootDirectory;
+        };
+    } // namespace
+
+    TEST_F(DirectoryExplorerTest, empty)
+    {
+        std::vector<DirectoryExplorer::Error> errors;
+        EXPECT_TRUE(exploreAll(_rootDirectory, IgnoreRules{ "" }, errors).empty());
+        EXPECT_TRUE(errors.empty());
+    }
+
+    TEST_F(DirectoryExplorerTest, tree)
+    {
+        createFile("root.flac");
+        createFile("artist1/album1/track1.flac");
+        createFile("artist1/album1/track2.flac");
+        createFile("artist1/album2/track1.mp3");
+        createFile("artist2/album1/cd1/track1.flac");
+        std::filesystem::create_directories(_rootDirectory / "artist3" / "empty");
+
+        std::vector<DirectoryExplorer::Error> errors;
+        const std::set<std::filesystem::path> expected{ "root.flac", "artist1/album1/track1.flac", "artist1/album1/track2.flac", "artist1/album2/track1.mp3", "artist2/album1/cd1/track1.flac" };
+        EXPECT_EQ(exploreAll(_rootDirectory, IgnoreRules{ "" }, errors), expected);
+        EXPECT_TRUE(errors.empty());
+    }
+
+    TEST_F(DirectoryExplorerTest, ignoreRules)
+    {
+        createFile("root.flac");
+        createFile("root.nfo");
+        createFile("artist1/album1/track1.flac");
+        createFile("artist1/album1/track1.nfo");
+        createFile("artist1/album2/track1.flac");
+        createFile("artist2/album2/track1.flac");
+        createFile("tmp/track1.flac");
+
+        std::vector<DirectoryExplorer::Error> errors;
+        const std::set<std::filesystem::path> expected{ "root.flac", "artist1/album1/track1.flac", "artist2/album2/track1.flac" };
+        EXPECT_EQ(exploreAll(_rootDirectory, IgnoreRules{ "*.nfo\n/artist1/album2/\ntmp/\n" }, errors), expected);
+        EXPECT_TRUE(errors.empty());
+    }
+
+    TEST_F(DirectoryExplorerTest, missingRoot)
+    {
+        std::vector<DirectoryExplorer::Error> errors;
+        EXPECT_TRUE(exploreAll(_rootDirectory / "missing", IgnoreRules{ "" }, errors).empty());
+        ASSERT_EQ(errors.size(), 1);
+        EXPECT_EQ(errors.front().path, _rootDirectory / "missing");
+    }
+} // namespace lms::scanner::tests
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "scanners/FileInfoSnapshot.hpp"
+
+namespace lms::scanner::tests
+{
+    namespace
+    {
+        Wt::WDateTime fromTime_t(std::time_t t)
+        {
+            Wt::WDateTime res;
+            res.setTime_t(t);
+            return res;
+        }
+    } // namespace
+
+    TEST(FileInfoSnapshot, empty)
+    {
+        FileInfoSnapshot snapshot;
+        snapshot.finalize();
+
+        EXPECT_EQ(snapshot.size(), 0);
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file.mp3", fromTime_t(1000), 0));
+    }
+
+    TEST(FileInfoSnapshot, isUpToDate)
+    {
+        FileInfoSnapshot snapshot;
+        snapshot.add("/root/file1.mp3", fromTime_t(1000), 5);
+        snapshot.add("/root/file2.mp3", fromTime_t(2000), 5);
+        snapshot.add("/root/folder.jpg", fromTime_t(3000), 0);
+        snapshot.finalize();
+
+        EXPECT_EQ(snapshot.size(), 3);
+
+        EXPECT_TRUE(snapshot.isUpToDate("/root/file1.mp3", fromTime_t(1000), 5));
+        EXPECT_TRUE(snapshot.isUpToDate("/root/file2.mp3", fromTime_t(2000), 5));
+        EXPECT_TRUE(snapshot.isUpToDate("/root/folder.jpg", fromTime_t(3000), 0));
+
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file1.mp3", fromTime_t(1001), 5)) << "modified file";
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file1.mp3", fromTime_t(1000), 6)) << "new scan version";
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file3.mp3", fromTime_t(1000), 5)) << "unknown file";
+        EXPECT_FALSE(snapshot.isUpToDate("/root/File1.mp3", fromTime_t(1000), 5)) << "paths are case sensitive";
+    }
+
+    TEST(FileInfoSnapshot, invalidLastWriteTime)
+    {
+        FileInfoSnapshot snapshot;
+        snapshot.add("/root/file.mp3", Wt::WDateTime{}, 0);
+        snapshot.finalize();
+
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file.mp3", fromTime_t(0), 0));
+    }
+
+    TEST(FileInfoSnapshot, duplicates)
+    {
+        // same path stored twice (should not happen): rescan it rather than picking one of the entries
+        FileInfoSnapshot snapshot;
+        snapshot.add("/root/file.mp3", fromTime_t(1000), 0);
+        snapshot.add("/root/file.mp3", fromTime_t(1000), 0);
+        snapshot.add("/root/other.mp3", fromTime_t(1000), 0);
+        snapshot.finalize();
+
+        EXPECT_FALSE(snapshot.isUpToDate("/root/file.mp3", fromTime_t(1000), 0));
+        EXPECT_TRUE(snapshot.isUpToDate("/root/other.mp3", fromTime_t(1000), 0));
+    }
+
+    TEST(FileInfoSnapshot, manyFiles)
+    {
+        constexpr std::size_t fileCount{ 10'000 };
+
+        FileInfoSnapshot snapshot;
+        for (std::size_t i{}; i < fileCount; ++i)
+            snapshot.add("/root/artist " + std::to_string(i % 100) + "/track " + std::to_string(i) + ".flac", fromTime_t(static_cast<std::time_t>(i)), 1);
+        snapshot.finalize();
+
+        ASSERT_EQ(snapshot.size(), fileCount);
+        for (std::size_t i{}; i < fileCount; ++i)
+            ASSERT_TRUE(snapshot.isUpToDate("/root/artist " + std::to_string(i % 100) + "/track " + std::to_string(i) + ".flac", fromTime_t(static_cast<std::time_t>(i)), 1));
+    }
+} // namespace lms::scanner::tests
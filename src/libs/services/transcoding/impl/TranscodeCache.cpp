@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TranscodeCache.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "core/ILogger.hpp"
+#include "core/XxHash3.hpp"
+
+namespace lms::transcoding
+{
+    namespace
+    {
+        constexpr std::string_view transcodeCacheFileExtension{ ".cache" };
+        constexpr std::string_view transcodeCacheTmpFileExtension{ ".tmp" };
+
+        template<typename T>
+        void writeOptional(std::ostream& os, const std::optional<T>& value)
+        {
+            if (value)
+                os << *value;
+            os << '|';
+        }
+    } // namespace
+
+    TranscodeCache::TranscodeCache(const std::filesystem::path& rootPath, std::size_t maxCacheSize)
+        : _rootPath{ rootPath }
+        , _maxCacheSize{ maxCacheSize }
+    {
+        if (_maxCacheSize == 0)
+            return;
+
+        std::filesystem::create_directories(_rootPath);
+        loadEntries();
+    }
+
+    TranscodeCache::~TranscodeCache()
+    {
+        LMS_LOG(TRANSCODING, DEBUG, "Cache stats: hits = " << _cacheHits << ", misses = " << _cacheMisses << ", evictions = " << _cacheEvictions << ", nb entries = " << _entries.size() << ", size = " << _cacheSize);
+    }
+
+    std::optional<TranscodeCache::EntryKey> TranscodeCache::computeEntryKey(const audio::TranscodeParameters& parameters)
+    {
+        const audio::TranscodeInputParameters& inputParameters{ parameters.inputParameters };
+        const audio::TranscodeOutputParameters& outputParameters{ parameters.outputParameters };
+
+        if (inputParameters.offset != std::chrono::milliseconds{ 0 })
+            return std::nullopt;
+
+        std::error_code ec;
+        const std::filesystem::file_time_type lastWriteTime{ std::filesystem::last_write_time(inputParameters.filePath, ec) };
+        if (ec)
+            return std::nullopt;
+
+        std::ostringstream oss;
+        oss << inputParameters.filePath.string() << '|' << lastWriteTime.time_since_epoch().count() << '|';
+        if (outputParameters.format)
+            oss << static_cast<int>(outputParameters.format->container) << '/' << static_cast<int>(outputParameters.format->codec);
+        oss << '|';
+        writeOptional(oss, outputParameters.bitrate);
+        writeOptional(oss, outputParameters.bitsPerSample);
+        writeOptional(oss, outputParameters.channelCount);
+        writeOptional(oss, outputParameters.sampleRate);
+        oss << outputParameters.stripMetadata;
+
+        const std::string key{ oss.str() };
+        return core::XxHash3_64::hash(std::as_bytes(std::span{ key }));
+    }
+
+    std::optional<std::filesystem::path> TranscodeCache::getEntry(EntryKey key)
+    {
+        if (_maxCacheSize == 0)
+            return std::nullopt;
+
+        std::filesystem::path entryPath;
+        {
+            const std::scoped_lock lock{ _mutex };
+
+            const auto it{ _entriesByKey.find(key) };
+            if (it == std::cend(_entriesByKey))
+            {
+                ++_cacheMisses;
+                return std::nullopt;
+            }
+
+            ++_cacheHits;
+            _entries.splice(std::begin(_entries), _entries, it->second);
+            entryPath = getEntryPath(key);
+        }
+
+        // used to restore LRU order after a restart
+        std::error_code ec;
+        std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+
+        return entryPath;
+    }
+
+    std::unique_ptr<TranscodeCache::EntryWriter> TranscodeCache::createEntryWriter(EntryKey key)
+    {
+        if (_maxCacheSize == 0)
+            return nullptr;
+
+        std::filesystem::path tmpPath{ getEntryPath(key) };
+        tmpPath += "." + std::to_string(_tmpFileCounter++);
+        tmpPath += transcodeCacheTmpFileExtension;
+
+        return std::make_unique<EntryWriter>(*this, key, tmpPath);
+    }
+
+    TranscodeCacheStats TranscodeCache::getStats() const
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        return TranscodeCacheStats{
+            .hits = _cacheHits,
+            .misses = _cacheMisses,
+            .evictions = _cacheEvictions,
+            .entryCount = _entries.size(),
+            .size = _cacheSize,
+        };
+    }
+
+    TranscodeCache::EntryWriter::EntryWriter(TranscodeCache& cache, EntryKey key, const std::filesystem::path& tmpPath)
+        : _cache{ cache }
+        , _key{ key }
+        , _tmpPath{ tmpPath }
+        , _file{ tmpPath, std::ios::binary | std::ios::trunc }
+    {
+        if (!_file)
+            LMS_LOG(TRANSCODING, ERROR, "Cannot create cache file " << _tmpPath);
+    }
+
+    TranscodeCache::EntryWriter::~EntryWriter()
+    {
+        if (_committed)
+            return;
+
+        // Partial transcode (aborted by the client, write error, etc.)
+        _file.close();
+        std::error_code ec;
+        std::filesystem::remove(_tmpPath, ec);
+    }
+
+    void TranscodeCache::EntryWriter::write(std::span<const std::byte> data)
+    {
+        if (!_file)
+            return;
+
+        if (_size + data.size() > _cache.getMaxCacheSize())
+        {
+            LMS_LOG(TRANSCODING, DEBUG, "Transcoded file too large to be cached");
+            _file.close();
+            return;
+        }
+
+        if (!_file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+        {
+            LMS_LOG(TRANSCODING, ERROR, "Cannot write cache file " << _tmpPath);
+            return;
+        }
+
+        _size += data.size();
+    }
+
+    void TranscodeCache::EntryWriter::commit()
+    {
+        if (!_file.is_open() || _size == 0)
+            return;
+
+        _file.close();
+        if (!_file)
+        {
+            LMS_LOG(TRANSCODING, ERROR, "Cannot write cache file " << _tmpPath);
+            return;
+        }
+
+        _cache.commitEntry(_key, _tmpPath, _size);
+        _committed = true;
+    }
+
+    void TranscodeCache::commitEntry(EntryKey key, const std::filesystem::path& tmpPath, std::size_t fileSize)
+    {
+        const std::filesystem::path entryPath{ getEntryPath(key) };
+
+        const std::scoped_lock lock{ _mutex };
+
+        // Concurrent transcodes of the same file: just keep the last one
+        if (const auto it{ _entriesByKey.find(key) }; it != std::cend(_entriesByKey))
+        {
+            _cacheSize -= it->second->fileSize;
+            _entries.erase(it->second);
+            _entriesByKey.erase(it);
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, entryPath, ec);
+        if (ec)
+        {
+            LMS_LOG(TRANSCODING, ERROR, "Cannot rename " << tmpPath << " to " << entryPath << ": " << ec.message());
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+
+        evictEntries(fileSize);
+        insertEntry(Entry{ key, fileSize });
+
+        LMS_LOG(TRANSCODING, DEBUG, "Added " << entryPath << " to cache, size = " << fileSize << ", cache size = " << _cacheSize << ", nb entries = " << _entries.size());
+    }
+
+    void TranscodeCache::loadEntries()
+    {
+        struct LoadedEntry
+        {
+            Entry entry;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+        std::vector<LoadedEntry> loadedEntries;
+
+        std::error_code ec;
+        for (auto itPath{ std::filesystem::directory_iterator{ _rootPath, ec } }; !ec && itPath != std::filesystem::directory_iterator{}; itPath.increment(ec))
+        {
+            std::error_code fileEc;
+            const std::filesystem::path& path{ itPath->path() };
+            if (itPath->is_regular_file(fileEc))
+            {
+                if (const std::optional<EntryKey> key{ parseEntryPath(path) })
+                {
+                    const std::size_t fileSize{ static_cast<std::size_t>(itPath->file_size(fileEc)) };
+                    if (!fileEc)
+                    {
+                        loadedEntries.push_back(LoadedEntry{ Entry{ *key, fileSize }, itPath->last_write_time(fileEc) });
+                        continue;
+                    }
+                }
+            }
+
+            // Leftovers from interrupted transcodes
+            LMS_LOG(TRANSCODING, DEBUG, "Removing unexpected file " << path << " from the cache");
+            std::filesystem::remove_all(path, fileEc);
+        }
+
+        if (ec)
+            LMS_LOG(TRANSCODING, ERROR, "Cannot explore cache directory " << _rootPath << ": " << ec.message());
+
+        std::sort(std::begin(loadedEntries), std::end(loadedEntries), [](const LoadedEntry& lhs, const LoadedEntry& rhs) { return lhs.lastWriteTime > rhs.lastWriteTime; });
+
+        const std::scoped_lock lock{ _mutex };
+        for (const LoadedEntry& loadedEntry : loadedEntries)
+        {
+            if (_cacheSize + loadedEntry.entry.fileSize > _maxCacheSize)
+            {
+                std::filesystem::remove(getEntryPath(loadedEntry.entry.key), ec);
+                continue;
+            }
+
+            _entries.push_back(loadedEntry.entry);
+            _entriesByKey.emplace(loadedEntry.entry.key, std::prev(std::end(_entries)));
+            _cacheSize += loadedEntry.entry.fileSize;
+        }
+
+        LMS_LOG(TRANSCODING, INFO, "Cache loaded: nb entries = " << _entries.size() << ", size = " << _cacheSize << ", max size = " << _maxCacheSize);
+    }
+
+    std::filesystem::path TranscodeCache::getEntryPath(EntryKey key) const
+    {
+        std::ostringstream oss;
+        oss << std::hex << std::setw(16) << std::setfill('0') << key << transcodeCacheFileExtension;
+
+        return _rootPath / oss.str();
+    }
+
+    std::optional<TranscodeCache::EntryKey> TranscodeCache::parseEntryPath(const std::filesystem::path& path)
+    {
+        if (path.extension() != transcodeCacheFileExtension)
+            return std::nullopt;
+
+        const std::string stem{ path.stem().string() };
+        if (stem.size() != 16)
+            return std::nullopt;
+
+        EntryKey key{};
+        const auto [ptr, ec]{ std::from_chars(stem.data(), stem.data() + stem.size(), key, 16) };
+        if (ec != std::errc{} || ptr != stem.data() + stem.size())
+            return std::nullopt;
+
+        return key;
+    }
+
+    void TranscodeCache::insertEntry(const Entry& entry)
+    {
+        _entries.push_front(entry);
+        _entriesByKey.emplace(entry.key, std::begin(_entries));
+        _cacheSize += entry.fileSize;
+    }
+
+    void TranscodeCache::removeEntry(EntryList::iterator it)
+    {
+        // Files being served remain readable until closed
+        std::error_code ec;
+        std::filesystem::remove(getEntryPath(it->key), ec);
+        if (ec)
+            LMS_LOG(TRANSCODING, ERROR, "Cannot remove cached file: " << ec.message());
+
+        _cacheSize -= it->fileSize;
+        _entriesByKey.erase(it->key);
+        _entries.erase(it);
+    }
+
+    void TranscodeCache::evictEntries(std::size_t requestedSize)
+    {
+        while (_cacheSize + requestedSize > _maxCacheSize && !_entries.empty())
+        {
+            removeEntry(std::prev(std::end(_entries)));
+            ++_cacheEvictions;
+        }
+    }
+} // namespace lms::transcoding
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+#include "audio/TranscodeTypes.hpp"
+#include "services/transcoding/ITranscodeService.hpp"
+
+namespace lms::transcoding
+{
+    // Persistent cache for transcoded files, least recently used entries are evicted first
+    // Entries are named after a hash of the transcode parameters and of the input file last write time
+    class TranscodeCache
+    {
+    public:
+        TranscodeCache(const std::filesystem::path& rootPath, std::size_t maxCacheSize);
+        ~TranscodeCache();
+        TranscodeCache(const TranscodeCache&) = delete;
+        TranscodeCache& operator=(const TranscodeCache&) = delete;
+
+        using EntryKey = std::uint64_t;
+
+        std::size_t getMaxCacheSize() const { return _maxCacheSize; }
+
+        // Only full transcodes are cached: no key for parameters using an offset
+        static std::optional<EntryKey> computeEntryKey(const audio::TranscodeParameters& parameters);
+
+        std::optional<std::filesystem::path> getEntry(EntryKey key);
+
+        // Data is written in a temporary file, only added to the cache once committed
+        class EntryWriter
+        {
+        public:
+            EntryWriter(TranscodeCache& cache, EntryKey key, const std::filesystem::path& tmpPath);
+            ~EntryWriter();
+            EntryWriter(const EntryWriter&) = delete;
+            EntryWriter& operator=(const EntryWriter&) = delete;
+
+            void write(std::span<const std::byte> data);
+            void commit();
+
+        private:
+            TranscodeCache& _cache;
+            const EntryKey _key;
+            const std::filesystem::path _tmpPath;
+            std::ofstream _file;
+            std::size_t _size{};
+            bool _committed{};
+        };
+        // may return nullptr if the cache is disabled
+        std::unique_ptr<EntryWriter> createEntryWriter(EntryKey key);
+
+        TranscodeCacheStats getStats() const;
+
+    private:
+        struct Entry
+        {
+            EntryKey key;
+            std::size_t fileSize;
+        };
+        using EntryList = std::list<Entry>;
+
+        void loadEntries();
+        void commitEntry(EntryKey key, const std::filesystem::path& tmpPath, std::size_t fileSize);
+        std::filesystem::path getEntryPath(EntryKey key) const;
+        static std::optional<EntryKey> parseEntryPath(const std::filesystem::path& path);
+
+        void insertEntry(const Entry& entry);
+        void removeEntry(EntryList::iterator it);
+        void evictEntries(std::size_t requestedSize);
+
+        const std::filesystem::path _rootPath;
+        const std::size_t _maxCacheSize;
+
+        mutable std::mutex _mutex;
+        EntryList _entries; // most recently used first
+        std::unordered_map<EntryKey, EntryList::iterator> _entriesByKey;
+        std::size_t _cacheSize{};
+        std::size_t _cacheHits{};
+        std::size_t _cacheMisses{};
+        std::size_t _cacheEvictions{};
+        std::atomic<std::size_t> _tmpFileCounter{};
+    };
+} // namespace lms::transcoding
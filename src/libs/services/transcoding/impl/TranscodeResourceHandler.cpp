@@ -20,6 +20,7 @@
 #include "TranscodeResourceHandler.hpp"
 
 #include "core/ILogger.hpp"
+#include "core/media/MimeType.hpp"
 
 #include "audio/Exception.hpp"
 #include "audio/ITranscoder.hpp"
@@ -28,37 +29,87 @@ namespace lms::transcoding
 {
     // TODO set some nice HTTP return code
 
-    ResourceHandler::ResourceHandler(const audio::TranscodeParameters& parameters, std::optional<std::size_t> estimatedContentLength)
-        : _estimatedContentLength{ estimatedContentLength }
+    ResourceHandler::ResourceHandler(boost::asio::io_context& ioContext, const audio::TranscodeParameters& parameters, audio::TranscoderBackend backend, std::optional<std::size_t> estimatedContentLength, std::unique_ptr<TranscodeCache::EntryWriter> cacheEntryWriter, std::unique_ptr<TranscodeScheduler::Ticket> ticket)
+        : _ioContext{ ioContext }
+        , _parameters{ parameters }
+        , _backend{ backend }
+        , _estimatedContentLength{ estimatedContentLength }
+        , _ticket{ std::move(ticket) }
+        , _cacheEntryWriter{ std::move(cacheEntryWriter) }
+    {
+        if (_estimatedContentLength)
+            LMS_LOG(TRANSCODING, DEBUG, "Estimated content length = " << *_estimatedContentLength);
+        else
+            LMS_LOG(TRANSCODING, DEBUG, "Not using estimated content length");
+
+        if (_ticket->isAdmitted())
+            createTranscoder();
+    }
+
+    ResourceHandler::~ResourceHandler() = default;
+
+    std::string_view ResourceHandler::getOutputMimeType(const audio::TranscodeParameters& parameters)
+    {
+        if (parameters.outputParameters.format)
+            return core::media::getMimeType(parameters.outputParameters.format->container, parameters.outputParameters.format->codec).str();
+
+        return core::media::getMimeType(parameters.inputParameters.audioProperties.container, parameters.inputParameters.audioProperties.codec).str();
+    }
+
+    void ResourceHandler::createTranscoder()
     {
         try
         {
-            _transcoder = createTranscoder(parameters);
-
-            if (_estimatedContentLength)
-                LMS_LOG(TRANSCODING, DEBUG, "Estimated content length = " << *_estimatedContentLength);
-            else
-                LMS_LOG(TRANSCODING, DEBUG, "Not using estimated content length");
+            _transcoder = audio::createTranscoder(_ioContext, _parameters, _backend);
         }
         catch (audio::Exception& e)
         {
             LMS_LOG(TRANSCODING, ERROR, "Failed to create transcoder: " << e.what());
         }
-    }
 
-    ResourceHandler::~ResourceHandler() = default;
+        // Could not start, give the slot back
+        if (!_transcoder)
+            _ticket.reset();
+    }
 
     Wt::Http::ResponseContinuation* ResourceHandler::processRequest(const Wt::Http::Request& /*request*/, Wt::Http::Response& response)
     {
         if (!_transcoder)
         {
-            response.setStatus(404);
-            return {};
+            // Headers are not sent yet: errors can still be reported
+            if (!_ticket)
+            {
+                response.setStatus(404);
+                return {};
+            }
+
+            if (!_ticket->isAdmitted())
+            {
+                LMS_LOG(TRANSCODING, DEBUG, "Waiting for a free encode slot");
+
+                Wt::Http::ResponseContinuation* continuation{ response.createContinuation() };
+                continuation->waitForMoreData();
+                _ticket->setAdmittedCallback([continuation] { continuation->haveMoreData(); });
+
+                return continuation;
+            }
+
+            createTranscoder();
+            if (!_transcoder)
+            {
+                response.setStatus(404);
+                return {};
+            }
+        }
+
+        if (!_headersSet)
+        {
+            if (_estimatedContentLength)
+                response.setContentLength(*_estimatedContentLength);
+            response.setMimeType(std::string{ getOutputMimeType(_parameters) });
+            _headersSet = true;
         }
 
-        if (_estimatedContentLength)
-            response.setContentLength(*_estimatedContentLength);
-        response.setMimeType(std::string{ _transcoder->getOutputMimeType() });
         LMS_LOG(TRANSCODING, DEBUG, "Transcoder finished = " << _transcoder->finished() << ", total served bytes = " << _totalServedByteCount << ", mime type = " << _transcoder->getOutputMimeType());
 
         if (_bytesReadyCount > 0)
@@ -66,6 +117,8 @@ namespace lms::transcoding
             LMS_LOG(TRANSCODING, DEBUG, "Writing " << _bytesReadyCount << " bytes back to client");
 
             response.out().write(reinterpret_cast<const char*>(_buffer.data()), _bytesReadyCount);
+            if (_cacheEntryWriter)
+                _cacheEntryWriter->write(std::span{ _buffer.data(), _bytesReadyCount });
             _totalServedByteCount += _bytesReadyCount;
             _bytesReadyCount = 0;
         }
@@ -85,6 +138,20 @@ namespace lms::transcoding
             return continuation;
         }
 
+        const bool transcodeFailed{ _transcoder->failed() };
+        _transcoder.reset();
+        _ticket.reset();
+
+        if (_cacheEntryWriter)
+        {
+            // a failed transcode has a truncated output: do not let the cache serve it
+            if (transcodeFailed)
+                LMS_LOG(TRANSCODING, ERROR, "Transcode failed, not caching output of " << _parameters.inputParameters.filePath);
+            else
+                _cacheEntryWriter->commit();
+            _cacheEntryWriter.reset();
+        }
+
         // pad with 0 if necessary as duration may not be accurate
         if (_estimatedContentLength && *_estimatedContentLength > _totalServedByteCount)
         {
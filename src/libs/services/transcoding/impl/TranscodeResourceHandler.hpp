@@ -23,29 +23,45 @@
 #include <memory>
 #include <optional>
 
+#include <boost/asio/io_context.hpp>
+
 #include "audio/ITranscoder.hpp"
 #include "core/IResourceHandler.hpp"
 
+#include "TranscodeCache.hpp"
+#include "TranscodeScheduler.hpp"
+
 namespace lms::transcoding
 {
     class ResourceHandler final : public core::IResourceHandler
     {
     public:
-        ResourceHandler(const audio::TranscodeParameters& parameters, std::optional<std::size_t> estimatedContentLength);
+        // The transcoder is started once the ticket is admitted
+        ResourceHandler(boost::asio::io_context& ioContext, const audio::TranscodeParameters& parameters, audio::TranscoderBackend backend, std::optional<std::size_t> estimatedContentLength, std::unique_ptr<TranscodeCache::EntryWriter> cacheEntryWriter, std::unique_ptr<TranscodeScheduler::Ticket> ticket);
         ~ResourceHandler() override;
 
         ResourceHandler(const ResourceHandler&) = delete;
         ResourceHandler& operator=(const ResourceHandler&) = delete;
 
+        static std::string_view getOutputMimeType(const audio::TranscodeParameters& parameters);
+
     private:
         Wt::Http::ResponseContinuation* processRequest(const Wt::Http::Request& request, Wt::Http::Response& response) override;
         void abort() override {};
 
+        void createTranscoder();
+
+        boost::asio::io_context& _ioContext;
+        const audio::TranscodeParameters _parameters;
+        const audio::TranscoderBackend _backend;
         static constexpr std::size_t _chunkSize{ 262'144 };
         std::optional<std::size_t> _estimatedContentLength;
         std::array<std::byte, _chunkSize> _buffer;
         std::size_t _bytesReadyCount{};
         std::size_t _totalServedByteCount{};
+        bool _headersSet{};
+        std::unique_ptr<TranscodeScheduler::Ticket> _ticket; // released as soon as the transcoder is finished
         std::unique_ptr<audio::ITranscoder> _transcoder;
+        std::unique_ptr<TranscodeCache::EntryWriter> _cacheEntryWriter; // transcoder output is also written to the cache
     };
 } // namespace lms::transcoding
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TranscodeScheduler.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "core/ILogger.hpp"
+
+namespace lms::transcoding
+{
+    TranscodeScheduler::Ticket::Ticket(TranscodeScheduler& scheduler, const TicketDesc& desc)
+        : _scheduler{ scheduler }
+        , _desc{ desc }
+        , _creationTime{ std::chrono::steady_clock::now() }
+    {
+    }
+
+    TranscodeScheduler::Ticket::~Ticket()
+    {
+        {
+            // wait for the callback in progress, if any
+            const std::scoped_lock lock{ _admittedCallback->mutex };
+            _admittedCallback->function = {};
+        }
+
+        _scheduler.onTicketDestroyed(*this);
+    }
+
+    void TranscodeScheduler::Ticket::setAdmittedCallback(std::function<void()> callback)
+    {
+        // same lock order as when the scheduler calls it: callback, then scheduler
+        {
+            const std::scoped_lock callbackLock{ _admittedCallback->mutex };
+            const std::scoped_lock lock{ _scheduler._mutex };
+
+            if (!_admitted)
+            {
+                _admittedCallback->function = std::move(callback);
+                return;
+            }
+        }
+
+        callback();
+    }
+
+    TranscodeScheduler::TranscodeScheduler(std::size_t maxActiveEncodeCount, std::size_t maxQueueSize)
+        : _maxActiveEncodeCount{ maxActiveEncodeCount }
+        , _maxQueueSize{ maxQueueSize }
+    {
+    }
+
+    TranscodeScheduler::~TranscodeScheduler()
+    {
+        LMS_LOG(TRANSCODING, DEBUG, "Scheduler stats: admitted = " << _admittedCount << ", queued = " << _queuedCount << ", total wait time = " << _totalWaitTime.count() << " ms, max wait time = " << _maxWaitTime.count() << " ms, direct stream fallbacks = " << _directStreamFallbackCount << ", rejected = " << _rejectedCount);
+    }
+
+    std::unique_ptr<TranscodeScheduler::Ticket> TranscodeScheduler::createTicket(const TicketDesc& desc)
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        if (!hasFreeSlot() && _waitingTickets.size() >= _maxQueueSize)
+        {
+            ++_rejectedCount;
+            LMS_LOG(TRANSCODING, DEBUG, "Encoders saturated: active encodes = " << _activeEncodeCount << ", queue depth = " << _waitingTickets.size());
+            return nullptr;
+        }
+
+        std::unique_ptr<Ticket> ticket{ new Ticket{ *this, desc } };
+        if (hasFreeSlot())
+        {
+            admit(*ticket, false); // no callback set yet
+        }
+        else
+        {
+            _waitingTickets.push_back(ticket.get());
+            LMS_LOG(TRANSCODING, DEBUG, "Encode queued: active encodes = " << _activeEncodeCount << ", queue depth = " << _waitingTickets.size());
+        }
+
+        return ticket;
+    }
+
+    void TranscodeScheduler::onDirectStreamFallback()
+    {
+        const std::scoped_lock lock{ _mutex };
+        ++_directStreamFallbackCount;
+    }
+
+    TranscodeSchedulerStats TranscodeScheduler::getStats() const
+    {
+        const std::scoped_lock lock{ _mutex };
+
+        return TranscodeSchedulerStats{
+            .maxActiveEncodeCount = _maxActiveEncodeCount,
+            .activeEncodeCount = _activeEncodeCount,
+            .queueDepth = _waitingTickets.size(),
+            .admittedCount = _admittedCount,
+            .queuedCount = _queuedCount,
+            .totalWaitTime = _totalWaitTime,
+            .maxWaitTime = _maxWaitTime,
+            .directStreamFallbackCount = _directStreamFallbackCount,
+            .rejectedCount = _rejectedCount,
+        };
+    }
+
+    bool TranscodeScheduler::hasFreeSlot() const
+    {
+        return _maxActiveEncodeCount == 0 || _activeEncodeCount < _maxActiveEncodeCount;
+    }
+
+    std::shared_ptr<TranscodeScheduler::Ticket::AdmittedCallback> TranscodeScheduler::admit(Ticket& ticket, bool waited)
+    {
+        ticket._admitted = true;
+        ++_activeEncodeCount;
+        ++_activeEncodeCountByUser[ticket._desc.userId];
+        ++_admittedCount;
+
+        if (waited)
+        {
+            const auto waitTime{ std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - ticket._creationTime) };
+            ++_queuedCount;
+            _totalWaitTime += waitTime;
+            _maxWaitTime = std::max(_maxWaitTime, waitTime);
+            LMS_LOG(TRANSCODING, DEBUG, "Encode admitted after " << waitTime.count() << " ms, queue depth = " << _waitingTickets.size());
+        }
+
+        return ticket._admittedCallback;
+    }
+
+    std::vector<std::shared_ptr<TranscodeScheduler::Ticket::AdmittedCallback>> TranscodeScheduler::admitWaitingTickets()
+    {
+        std::vector<std::shared_ptr<Ticket::AdmittedCallback>> admittedCallbacks;
+
+        while (hasFreeSlot() && !_waitingTickets.empty())
+        {
+            // Users with no active encode are likely waiting for their first stream, whatever the requested priority
+            const auto getAdmissionKey{ [this](const Ticket& ticket) {
+                const auto itActiveEncodeCount{ _activeEncodeCountByUser.find(ticket._desc.userId) };
+                const std::size_t userActiveEncodeCount{ itActiveEncodeCount != std::cend(_activeEncodeCountByUser) ? itActiveEncodeCount->second : 0 };
+                const bool isPlayhead{ ticket._desc.priority == TranscodePriority::Playhead || userActiveEncodeCount == 0 };
+
+                return std::make_tuple(!isPlayhead, userActiveEncodeCount);
+            } };
+
+            auto itBestTicket{ std::begin(_waitingTickets) };
+            auto bestAdmissionKey{ getAdmissionKey(**itBestTicket) };
+            for (auto it{ std::next(itBestTicket) }; it != std::end(_waitingTickets); ++it)
+            {
+                const auto admissionKey{ getAdmissionKey(**it) };
+                if (admissionKey < bestAdmissionKey)
+                {
+                    itBestTicket = it;
+                    bestAdmissionKey = admissionKey;
+                }
+            }
+
+            Ticket& ticket{ **itBestTicket };
+            _waitingTickets.erase(itBestTicket);
+            admittedCallbacks.push_back(admit(ticket, true));
+        }
+
+        return admittedCallbacks;
+    }
+
+    void TranscodeScheduler::onTicketDestroyed(Ticket& ticket)
+    {
+        std::vector<std::shared_ptr<Ticket::AdmittedCallback>> admittedCallbacks;
+
+        {
+            const std::scoped_lock lock{ _mutex };
+
+            if (!ticket._admitted)
+            {
+                _waitingTickets.remove(&ticket);
+                return;
+            }
+
+            --_activeEncodeCount;
+            if (const auto it{ _activeEncodeCountByUser.find(ticket._desc.userId) }; --it->second == 0)
+                _activeEncodeCountByUser.erase(it);
+
+            admittedCallbacks = admitWaitingTickets();
+        }
+
+        // callbacks may resume requests that in turn destroy tickets
+        // tickets destroyed meanwhile have cleared their callback
+        for (const std::shared_ptr<Ticket::AdmittedCallback>& admittedCallback : admittedCallbacks)
+        {
+            const std::scoped_lock lock{ admittedCallback->mutex };
+            if (const std::function<void()> function{ std::exchange(admittedCallback->function, {}) })
+                function();
+        }
+    }
+} // namespace lms::transcoding
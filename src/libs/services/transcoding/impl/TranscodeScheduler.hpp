@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "database/objects/UserId.hpp"
+#include "services/transcoding/ITranscodeService.hpp"
+
+namespace lms::transcoding
+{
+    // Limits the number of concurrent encodes, other ones wait in a queue
+    // Waiting encodes are admitted by priority, then in favor of the users with the fewest active encodes, then in arrival order
+    class TranscodeScheduler
+    {
+    public:
+        // maxActiveEncodeCount = 0 means unlimited
+        TranscodeScheduler(std::size_t maxActiveEncodeCount, std::size_t maxQueueSize);
+        ~TranscodeScheduler();
+        TranscodeScheduler(const TranscodeScheduler&) = delete;
+        TranscodeScheduler& operator=(const TranscodeScheduler&) = delete;
+
+        struct TicketDesc
+        {
+            std::optional<db::UserId> userId;
+            TranscodePriority priority;
+        };
+
+        // Holds a slot once admitted, leaves the queue or releases the slot on destruction
+        class Ticket
+        {
+        public:
+            ~Ticket();
+            Ticket(const Ticket&) = delete;
+            Ticket& operator=(const Ticket&) = delete;
+
+            bool isAdmitted() const { return _admitted; }
+
+            // Called once admitted (immediately if already admitted), outside of the scheduler lock
+            // Never called once the ticket is destroyed
+            void setAdmittedCallback(std::function<void()> callback);
+
+        private:
+            friend class TranscodeScheduler;
+            Ticket(TranscodeScheduler& scheduler, const TicketDesc& desc);
+
+            // Shared with the scheduler, that may call it after the ticket is destroyed
+            struct AdmittedCallback
+            {
+                std::recursive_mutex mutex; // held during the call, recursive as the callback may destroy its own ticket
+                std::function<void()> function;
+            };
+
+            TranscodeScheduler& _scheduler;
+            const TicketDesc _desc;
+            const std::chrono::steady_clock::time_point _creationTime;
+            std::atomic<bool> _admitted{};
+            const std::shared_ptr<AdmittedCallback> _admittedCallback{ std::make_shared<AdmittedCallback>() };
+        };
+
+        // Returns nullptr if no slot is available and the queue is full
+        std::unique_ptr<Ticket> createTicket(const TicketDesc& desc);
+
+        void onDirectStreamFallback();
+        TranscodeSchedulerStats getStats() const;
+
+    private:
+        bool hasFreeSlot() const;
+        // return the admitted callbacks, to be called once unlocked
+        std::shared_ptr<Ticket::AdmittedCallback> admit(Ticket& ticket, bool waited);
+        [[nodiscard]] std::vector<std::shared_ptr<Ticket::AdmittedCallback>> admitWaitingTickets();
+        void onTicketDestroyed(Ticket& ticket);
+
+        const std::size_t _maxActiveEncodeCount;
+        const std::size_t _maxQueueSize;
+
+        mutable std::mutex _mutex;
+        std::list<Ticket*> _waitingTickets; // arrival order
+        std::map<std::optional<db::UserId>, std::size_t> _activeEncodeCountByUser;
+        std::size_t _activeEncodeCount{};
+        std::size_t _admittedCount{};
+        std::size_t _queuedCount{};
+        std::chrono::milliseconds _totalWaitTime{};
+        std::chrono::milliseconds _maxWaitTime{};
+        std::size_t _directStreamFallbackCount{};
+        std::size_t _rejectedCount{};
+    };
+} // namespace lms::transcoding
@@ -19,7 +19,16 @@
 
 #include "TranscodeService.hpp"
 
+#include <algorithm>
+#include <thread>
+
+#include "core/Exception.hpp"
+#include "core/FileResourceHandlerCreator.hpp"
+#include "core/IConfig.hpp"
 #include "core/ILogger.hpp"
+#include "core/IResourceHandler.hpp"
+#include "core/Service.hpp"
+#include "core/media/MimeType.hpp"
 
 #include "TranscodeResourceHandler.hpp"
 
@@ -32,15 +41,55 @@ namespace lms::transcoding
             const std::size_t estimatedContentLength{ static_cast<size_t>((bitrate / 8 * duration.count()) / 1000) };
             return estimatedContentLength;
         }
+
+        class ServiceUnavailableResourceHandler final : public core::IResourceHandler
+        {
+        private:
+            Wt::Http::ResponseContinuation* processRequest(const Wt::Http::Request& /*request*/, Wt::Http::Response& response) override
+            {
+                response.setStatus(503);
+                return {};
+            }
+            void abort() override {};
+        };
+
+        audio::TranscoderBackend getTranscoderBackend()
+        {
+            const std::string_view backend{ core::Service<core::IConfig>::get()->getString("transcoder-backend", "child-process") };
+
+            if (backend == "child-process")
+                return audio::TranscoderBackend::ChildProcess;
+            if (backend == "in-process")
+                return audio::TranscoderBackend::InProcess;
+
+            throw core::LmsException{ "Invalid value for 'transcoder-backend'" };
+        }
+
+        std::size_t getMaxActiveEncodeCount()
+        {
+            std::size_t maxActiveEncodeCount{ core::Service<core::IConfig>::get()->getULong("transcode-max-active-encodes", 0) };
+
+            if (maxActiveEncodeCount == 0)
+                maxActiveEncodeCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+            return maxActiveEncodeCount;
+        }
     } // namespace
 
-    std::unique_ptr<ITranscodeService> createTranscodeService()
+    std::unique_ptr<ITranscodeService> createTranscodeService(boost::asio::io_context& ioContext, const std::filesystem::path& cachePath)
     {
-        return std::make_unique<TranscodeService>();
+        return std::make_unique<TranscodeService>(ioContext, cachePath);
     }
 
-    TranscodeService::TranscodeService()
+    TranscodeService::TranscodeService(boost::asio::io_context& ioContext, const std::filesystem::path& cachePath)
+        : _ioContext{ ioContext }
+        , _transcoderBackend{ getTranscoderBackend() }
+        , _cache{ cachePath, core::Service<core::IConfig>::get()->getULong("transcode-cache-max-size", 1000) * 1000 * 1000 }
+        , _scheduler{ getMaxActiveEncodeCount(), core::Service<core::IConfig>::get()->getULong("transcode-max-queue-size", 32) }
     {
+        LMS_LOG(TRANSCODING, INFO, "Using " << (_transcoderBackend == audio::TranscoderBackend::InProcess ? "in-process" : "child-process") << " transcoder backend");
+        LMS_LOG(TRANSCODING, INFO, "Max cache size = " << _cache.getMaxCacheSize());
+        LMS_LOG(TRANSCODING, INFO, "Max active encodes = " << _scheduler.getStats().maxActiveEncodeCount);
         LMS_LOG(TRANSCODING, INFO, "Service started!");
     }
 
@@ -49,11 +98,39 @@ namespace lms::transcoding
         LMS_LOG(TRANSCODING, INFO, "Service stopped!");
     }
 
-    std::unique_ptr<core::IResourceHandler> TranscodeService::createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, bool estimateContentLength)
+    std::unique_ptr<core::IResourceHandler> TranscodeService::createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, const TranscodeRequestOptions& options)
     {
+        const std::optional<TranscodeCache::EntryKey> cacheEntryKey{ TranscodeCache::computeEntryKey(parameters) };
+        if (cacheEntryKey)
+        {
+            if (const std::optional<std::filesystem::path> cacheEntryPath{ _cache.getEntry(*cacheEntryKey) })
+            {
+                LMS_LOG(TRANSCODING, DEBUG, "Serving " << parameters.inputParameters.filePath << " from cache entry " << *cacheEntryPath);
+                return core::createFileResourceHandler(*cacheEntryPath, ResourceHandler::getOutputMimeType(parameters));
+            }
+        }
+
+        std::unique_ptr<TranscodeScheduler::Ticket> ticket{ _scheduler.createTicket(TranscodeScheduler::TicketDesc{ .userId = options.userId, .priority = options.priority }) };
+        if (!ticket)
+        {
+            if (options.allowDirectStreamFallback)
+            {
+                LMS_LOG(TRANSCODING, DEBUG, "Encoders saturated, serving " << parameters.inputParameters.filePath << " without transcoding");
+                _scheduler.onDirectStreamFallback();
+                return core::createFileResourceHandler(parameters.inputParameters.filePath, core::media::getMimeType(parameters.inputParameters.audioProperties.container, parameters.inputParameters.audioProperties.codec).str());
+            }
+
+            LMS_LOG(TRANSCODING, WARNING, "Encoders saturated, rejecting transcode of " << parameters.inputParameters.filePath);
+            return std::make_unique<ServiceUnavailableResourceHandler>();
+        }
+
+        std::unique_ptr<TranscodeCache::EntryWriter> cacheEntryWriter;
+        if (cacheEntryKey)
+            cacheEntryWriter = _cache.createEntryWriter(*cacheEntryKey);
+
         std::optional<std::size_t> estimatedContentLength;
 
-        if (estimateContentLength)
+        if (options.estimateContentLength)
         {
             if (parameters.inputParameters.offset < parameters.inputParameters.audioProperties.duration)
                 estimatedContentLength = doEstimateContentLength(*parameters.outputParameters.bitrate, parameters.inputParameters.audioProperties.duration - parameters.inputParameters.offset);
@@ -61,6 +138,16 @@ namespace lms::transcoding
                 LMS_LOG(TRANSCODING, WARNING, "Offset " << parameters.inputParameters.offset << " is greater than audio file duration " << parameters.inputParameters.audioProperties.duration << ": not estimating content length");
         }
 
-        return std::make_unique<transcoding::ResourceHandler>(parameters, estimatedContentLength);
+        return std::make_unique<transcoding::ResourceHandler>(_ioContext, parameters, _transcoderBackend, estimatedContentLength, std::move(cacheEntryWriter), std::move(ticket));
+    }
+
+    TranscodeCacheStats TranscodeService::getCacheStats() const
+    {
+        return _cache.getStats();
+    }
+
+    TranscodeSchedulerStats TranscodeService::getSchedulerStats() const
+    {
+        return _scheduler.getStats();
     }
 } // namespace lms::transcoding
@@ -19,20 +19,33 @@
 
 #pragma once
 
+#include <boost/asio/io_context.hpp>
+
+#include "audio/ITranscoder.hpp"
 #include "services/transcoding/ITranscodeService.hpp"
 
+#include "TranscodeCache.hpp"
+#include "TranscodeScheduler.hpp"
+
 namespace lms::transcoding
 {
     class TranscodeService : public ITranscodeService
     {
     public:
-        explicit TranscodeService();
+        TranscodeService(boost::asio::io_context& ioContext, const std::filesystem::path& cachePath);
         ~TranscodeService() override;
 
         TranscodeService(const TranscodeService&) = delete;
         TranscodeService& operator=(const TranscodeService&) = delete;
 
     private:
-        std::unique_ptr<core::IResourceHandler> createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, bool estimateContentLength) override;
+        std::unique_ptr<core::IResourceHandler> createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, const TranscodeRequestOptions& options) override;
+        TranscodeCacheStats getCacheStats() const override;
+        TranscodeSchedulerStats getSchedulerStats() const override;
+
+        boost::asio::io_context& _ioContext;
+        const audio::TranscoderBackend _transcoderBackend;
+        TranscodeCache _cache;
+        TranscodeScheduler _scheduler;
     };
 } // namespace lms::transcoding
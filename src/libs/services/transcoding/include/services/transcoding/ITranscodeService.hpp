@@ -19,9 +19,16 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
 #include <memory>
+#include <optional>
+
+#include <boost/asio/io_context.hpp>
 
 #include "audio/TranscodeTypes.hpp"
+#include "database/objects/UserId.hpp"
 
 namespace lms::core
 {
@@ -30,13 +37,55 @@ namespace lms::core
 
 namespace lms::transcoding
 {
+    struct TranscodeCacheStats
+    {
+        std::size_t hits{};
+        std::size_t misses{};
+        std::size_t evictions{};
+        std::size_t entryCount{};
+        std::size_t size{}; // in bytes
+    };
+
+    struct TranscodeSchedulerStats
+    {
+        std::size_t maxActiveEncodeCount{}; // 0 means unlimited
+        std::size_t activeEncodeCount{};
+        std::size_t queueDepth{};
+        std::size_t admittedCount{};
+        std::size_t queuedCount{}; // admitted after having waited in the queue
+        std::chrono::milliseconds totalWaitTime{};
+        std::chrono::milliseconds maxWaitTime{};
+        std::size_t directStreamFallbackCount{};
+        std::size_t rejectedCount{};
+    };
+
+    enum class TranscodePriority
+    {
+        Playhead, // the user is waiting for this stream to start playing
+        Prefetch, // the stream is likely to be played later
+    };
+
+    struct TranscodeRequestOptions
+    {
+        std::optional<db::UserId> userId; // used to share the encoders fairly between users
+        TranscodePriority priority{ TranscodePriority::Playhead };
+        bool estimateContentLength{};
+        bool allowDirectStreamFallback{}; // the source file can be served as is if the encoders are saturated
+    };
+
     class ITranscodeService
     {
     public:
         virtual ~ITranscodeService() = default;
 
-        virtual std::unique_ptr<core::IResourceHandler> createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, bool estimateContentLength = false) = 0;
+        // Complete transcodes are served from the cache if possible, with range support and exact content length
+        // Otherwise, the encode waits for a free slot (see transcode-max-active-encodes)
+        virtual std::unique_ptr<core::IResourceHandler> createTranscodeResourceHandler(const audio::TranscodeParameters& parameters, const TranscodeRequestOptions& options = {}) = 0;
+
+        virtual TranscodeCacheStats getCacheStats() const = 0;
+        virtual TranscodeSchedulerStats getSchedulerStats() const = 0;
     };
 
-    std::unique_ptr<ITranscodeService> createTranscodeService();
+    // ioContext runs the in-process transcodes
+    std::unique_ptr<ITranscodeService> createTranscodeService(boost::asio::io_context& ioContext, const std::filesystem::path& cachePath);
 } // namespace lms::transcoding
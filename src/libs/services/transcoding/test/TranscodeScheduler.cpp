@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "TranscodeScheduler.hpp"
+
+namespace lms::transcoding::tests
+{
+    TEST(TranscodeScheduler, admitUpToMaxActiveEncodes)
+    {
+        TranscodeScheduler scheduler{ 2, 1 };
+
+        auto ticket1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket2{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket3{ scheduler.createTicket({ .userId = db::UserId{ 3 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket4{ scheduler.createTicket({ .userId = db::UserId{ 4 }, .priority = TranscodePriority::Playhead }) };
+
+        ASSERT_TRUE(ticket1);
+        ASSERT_TRUE(ticket2);
+        ASSERT_TRUE(ticket3);
+        EXPECT_FALSE(ticket4); // queue full
+        EXPECT_TRUE(ticket1->isAdmitted());
+        EXPECT_TRUE(ticket2->isAdmitted());
+        EXPECT_FALSE(ticket3->isAdmitted());
+
+        {
+            const TranscodeSchedulerStats stats{ scheduler.getStats() };
+            EXPECT_EQ(stats.activeEncodeCount, 2);
+            EXPECT_EQ(stats.queueDepth, 1);
+            EXPECT_EQ(stats.rejectedCount, 1);
+        }
+
+        bool admitted{};
+        ticket3->setAdmittedCallback([&] { admitted = true; });
+        EXPECT_FALSE(admitted);
+
+        ticket1.reset();
+        EXPECT_TRUE(admitted);
+        EXPECT_TRUE(ticket3->isAdmitted());
+
+        {
+            const TranscodeSchedulerStats stats{ scheduler.getStats() };
+            EXPECT_EQ(stats.activeEncodeCount, 2);
+            EXPECT_EQ(stats.queueDepth, 0);
+            EXPECT_EQ(stats.admittedCount, 3);
+            EXPECT_EQ(stats.queuedCount, 1);
+        }
+    }
+
+    TEST(TranscodeScheduler, unlimited)
+    {
+        TranscodeScheduler scheduler{ 0, 0 };
+
+        std::vector<std::unique_ptr<TranscodeScheduler::Ticket>> tickets;
+        for (std::size_t i{}; i < 100; ++i)
+        {
+            tickets.push_back(scheduler.createTicket({ .userId = std::nullopt, .priority = TranscodePriority::Prefetch }));
+            ASSERT_TRUE(tickets.back());
+            EXPECT_TRUE(tickets.back()->isAdmitted());
+        }
+    }
+
+    TEST(TranscodeScheduler, cancelWaitingTicket)
+    {
+        TranscodeScheduler scheduler{ 1, 2 };
+
+        auto ticket1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket2{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket3{ scheduler.createTicket({ .userId = db::UserId{ 3 }, .priority = TranscodePriority::Playhead }) };
+
+        ticket2.reset();
+        EXPECT_EQ(scheduler.getStats().queueDepth, 1);
+
+        ticket1.reset();
+        EXPECT_TRUE(ticket3->isAdmitted());
+    }
+
+    TEST(TranscodeScheduler, admittedCallbackDestroysTicket)
+    {
+        TranscodeScheduler scheduler{ 1, 2 };
+
+        auto ticket1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket2{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+        auto ticket3{ scheduler.createTicket({ .userId = db::UserId{ 3 }, .priority = TranscodePriority::Playhead }) };
+
+        // as a request that completes as soon as it is resumed
+        ticket2->setAdmittedCallback([&] { ticket2.reset(); });
+        bool ticket3Admitted{};
+        ticket3->setAdmittedCallback([&] { ticket3Admitted = true; });
+
+        ticket1.reset();
+        EXPECT_FALSE(ticket2);
+        EXPECT_TRUE(ticket3Admitted);
+        EXPECT_EQ(scheduler.getStats().activeEncodeCount, 1);
+
+        // already admitted: called immediately
+        ticket3->setAdmittedCallback([&] { ticket3.reset(); });
+        EXPECT_FALSE(ticket3);
+        EXPECT_EQ(scheduler.getStats().activeEncodeCount, 0);
+    }
+
+    TEST(TranscodeScheduler, waitingTicketDestroyedWhileAdmitted)
+    {
+        // as a request aborted while another one releases its slot
+        struct Request
+        {
+            std::unique_ptr<TranscodeScheduler::Ticket> ticket;
+            bool resumed{};
+        };
+
+        for (std::size_t i{}; i < 1'000; ++i)
+        {
+            TranscodeScheduler scheduler{ 1, 1 };
+
+            auto activeTicket{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+            auto request{ std::make_unique<Request>() };
+            request->ticket = scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead });
+            request->ticket->setAdmittedCallback([&request = *request] { request.resumed = true; });
+
+            std::thread releaseThread{ [&] { activeTicket.reset(); } };
+            request.reset();
+            releaseThread.join();
+
+            EXPECT_EQ(scheduler.getStats().activeEncodeCount, 0);
+        }
+    }
+
+    TEST(TranscodeScheduler, playheadBeforePrefetch)
+    {
+        TranscodeScheduler scheduler{ 3, 10 };
+
+        auto activeTicket1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto activeTicket2{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+        auto activeTicket3{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+
+        // user 1 prefetches while already streaming, user 2 seeks
+        auto prefetchTicket{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Prefetch }) };
+        auto playheadTicket{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+
+        // both users now have one active encode
+        activeTicket3.reset();
+        EXPECT_TRUE(playheadTicket->isAdmitted());
+        EXPECT_FALSE(prefetchTicket->isAdmitted());
+    }
+
+    TEST(TranscodeScheduler, prefetchOfIdleUserIsPlayhead)
+    {
+        TranscodeScheduler scheduler{ 2, 10 };
+
+        auto activeTicketUser1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto activeTicketUser3{ scheduler.createTicket({ .userId = db::UserId{ 3 }, .priority = TranscodePriority::Playhead }) };
+
+        // user 1 has an active encode, user 2 has none: its request is likely the one being waited for
+        auto ticketUser1{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Prefetch }) };
+        auto ticketUser2{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Prefetch }) };
+
+        activeTicketUser3.reset();
+        EXPECT_TRUE(ticketUser2->isAdmitted());
+        EXPECT_FALSE(ticketUser1->isAdmitted());
+    }
+
+    TEST(TranscodeScheduler, fairBetweenUsers)
+    {
+        TranscodeScheduler scheduler{ 3, 10 };
+
+        auto ticketUser1a{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticketUser1b{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticketUser2a{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+
+        auto ticketUser1c{ scheduler.createTicket({ .userId = db::UserId{ 1 }, .priority = TranscodePriority::Playhead }) };
+        auto ticketUser2b{ scheduler.createTicket({ .userId = db::UserId{ 2 }, .priority = TranscodePriority::Playhead }) };
+
+        // user 1 has more active encodes than user 2
+        ticketUser2a.reset();
+        EXPECT_TRUE(ticketUser2b->isAdmitted());
+        EXPECT_FALSE(ticketUser1c->isAdmitted());
+    }
+} // namespace lms::transcoding::tests
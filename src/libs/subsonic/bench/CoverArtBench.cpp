@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include <Wt/WDateTime.h>
+#include <benchmark/benchmark.h>
+
+#include "core/IConfig.hpp"
+#include "core/Service.hpp"
+#include "core/testing/FileWriters.hpp"
+#include "database/IDb.hpp"
+#include "database/Session.hpp"
+#include "database/objects/Artwork.hpp"
+#include "database/objects/Image.hpp"
+#include "image/Image.hpp"
+#include "services/artwork/IArtworkService.hpp"
+
+namespace lms::api::subsonic::benchs
+{
+    namespace
+    {
+        using core::testing::writeLE;
+
+        constexpr std::size_t sourceImageSize{ 1500 };
+
+        // 24-bit uncompressed BMP, with a gradient to avoid trivially compressible data
+        void writeBmpFile(const std::filesystem::path& path, std::size_t width, std::size_t height)
+        {
+            const std::size_t rowSize{ (width * 3 + 3) & ~std::size_t{ 3 } };
+            const std::size_t dataSize{ rowSize * height };
+
+            std::ofstream os{ path, std::ios::binary | std::ios::trunc };
+            os.put('B');
+            os.put('M');
+            writeLE(os, 54 + dataSize, 4);
+            writeLE(os, 0, 4);
+            writeLE(os, 54, 4);
+            writeLE(os, 40, 4);
+            writeLE(os, width, 4);
+            writeLE(os, height, 4);
+            writeLE(os, 1, 2);
+            writeLE(os, 24, 2);
+            writeLE(os, 0, 4);
+            writeLE(os, dataSize, 4);
+            writeLE(os, 2835, 4);
+            writeLE(os, 2835, 4);
+            writeLE(os, 0, 4);
+            writeLE(os, 0, 4);
+
+            for (std::size_t y{}; y < height; ++y)
+            {
+                for (std::size_t x{}; x < width; ++x)
+                {
+                    os.put(static_cast<char>(x % 256));
+                    os.put(static_cast<char>(y % 256));
+                    os.put(static_cast<char>((x + y) % 256));
+                }
+                for (std::size_t i{ width * 3 }; i < rowSize; ++i)
+                    os.put(0);
+            }
+        }
+
+        class ArtworkServiceFixture
+        {
+        public:
+            ArtworkServiceFixture()
+                : _tmpDir{ std::filesystem::temp_directory_path() / "lms-bench-coverart" }
+            {
+                std::filesystem::create_directories(_tmpDir);
+
+                // Disable caches so that each round really computes the image
+                {
+                    std::ofstream configFile{ _tmpDir / "lms.conf" };
+                    configFile << "cover-max-cache-size = 0;\n"
+                               << "cover-max-disk-cache-size = 0;\n";
+                }
+                _config.assign(core::createConfig(_tmpDir / "lms.conf"));
+
+                for (const char* svgFile : { "unknown-cover.svg", "unknown-artist.svg" })
+                {
+                    std::ofstream os{ _tmpDir / svgFile };
+                    os << "<svg xmlns=\"http://www.w3.org/2000/svg\"/>";
+                }
+
+                const std::filesystem::path imagePath{ _tmpDir / "cover.bmp" };
+                writeBmpFile(imagePath, sourceImageSize, sourceImageSize);
+
+                image::init("");
+
+                _db = db::createDb(_tmpDir / "lms.db");
+                {
+                    db::Session session{ *_db };
+                    session.prepareTablesIfNeeded();
+                    session.createIndexesIfNeeded();
+
+                    auto transaction{ session.createWriteTransaction() };
+
+                    db::Image::pointer image{ session.create<db::Image>(imagePath) };
+                    image.modify()->setMimeType("image/bmp");
+                    image.modify()->setLastWriteTime(Wt::WDateTime::currentDateTime());
+                    image.modify()->setFileSize(std::filesystem::file_size(imagePath));
+                    image.modify()->setWidth(sourceImageSize);
+                    image.modify()->setHeight(sourceImageSize);
+
+                    _artworkId = session.create<db::Artwork>(image)->getId();
+                }
+
+                _artworkService = artwork::createArtworkService(*_db, _tmpDir / "cache", _tmpDir / "unknown-cover.svg", _tmpDir / "unknown-artist.svg");
+            }
+
+            ~ArtworkServiceFixture()
+            {
+                _artworkService.reset();
+                _db.reset();
+
+                std::error_code ec;
+                std::filesystem::remove_all(_tmpDir, ec);
+            }
+
+            ArtworkServiceFixture(const ArtworkServiceFixture&) = delete;
+            ArtworkServiceFixture& operator=(const ArtworkServiceFixture&) = delete;
+
+            artwork::IArtworkService& getArtworkService() { return *_artworkService; }
+            db::ArtworkId getArtworkId() const { return _artworkId; }
+
+        private:
+            const std::filesystem::path _tmpDir;
+            core::Service<core::IConfig> _config;
+            std::unique_ptr<db::IDb> _db;
+            db::ArtworkId _artworkId;
+            std::unique_ptr<artwork::IArtworkService> _artworkService;
+        };
+
+        ArtworkServiceFixture& getArtworkServiceFixture()
+        {
+            static ArtworkServiceFixture fixture;
+            return fixture;
+        }
+    } // namespace
+
+    // All the threads request the same artwork at the same size, as a client browsing an album grid would do
+    static void BM_ArtworkService_getImage_sameRequests(benchmark::State& state)
+    {
+        ArtworkServiceFixture& fixture{ getArtworkServiceFixture() };
+
+        for (auto _ : state)
+        {
+            auto image{ fixture.getArtworkService().getImage(fixture.getArtworkId(), 512) };
+            benchmark::DoNotOptimize(image);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Each thread requests a different size, no request can be coalesced
+    static void BM_ArtworkService_getImage_distinctRequests(benchmark::State& state)
+    {
+        ArtworkServiceFixture& fixture{ getArtworkServiceFixture() };
+        const image::ImageSize size{ static_cast<image::ImageSize>(512 + state.thread_index()) };
+
+        for (auto _ : state)
+        {
+            auto image{ fixture.getArtworkService().getImage(fixture.getArtworkId(), size) };
+            benchmark::DoNotOptimize(image);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    BENCHMARK(BM_ArtworkService_getImage_sameRequests)->ThreadRange(1, 32)->UseRealTime();
+    BENCHMARK(BM_ArtworkService_getImage_distinctRequests)->ThreadRange(1, 32)->UseRealTime();
+} // namespace lms::api::subsonic::benchs
@@ -17,11 +17,14 @@
  * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sstream>
+#include <string>
 #include <thread>
 
 #include <benchmark/benchmark.h>
 
 #include "SubsonicResponse.hpp"
+#include "SubsonicResponseWriter.hpp"
 
 namespace lms::api::subsonic::benchs
 {
@@ -48,6 +51,107 @@ namespace lms::api::subsonic::benchs
 
             return response;
         }
+
+        // Roughly the shape of a song entry
+        void writeFakeSong(ResponseWriter& writer, std::size_t index)
+        {
+            writer.setAttribute("id", "tr-" + std::to_string(index));
+            writer.setAttribute("parent", "dir-42");
+            writer.setAttribute("isDir", false);
+            writer.setAttribute("title", "Some \"quoted\" title & more");
+            writer.setAttribute("album", "Some album");
+            writer.setAttribute("albumId", "al-42");
+            writer.setAttribute("artist", "Some artist");
+            writer.setAttribute("artistId", "ar-42");
+            writer.setAttribute("track", index % 20);
+            writer.setAttribute("discNumber", 1);
+            writer.setAttribute("year", 1998);
+            writer.setAttribute("genre", "Rock");
+            writer.setAttribute("coverArt", "tr-" + std::to_string(index) + "-1700000000");
+            writer.setAttribute("size", 8'000'000 + index);
+            writer.setAttribute("contentType", "audio/flac");
+            writer.setAttribute("suffix", "flac");
+            writer.setAttribute("duration", 240);
+            writer.setAttribute("bitRate", 1000);
+            writer.setAttribute("path", "Some artist/Some album/01 - Some title.flac");
+            writer.setAttribute("playCount", index % 7);
+            writer.setAttribute("created", "2025-01-01T12:00:00.000Z");
+            writer.setAttribute("type", "music");
+            writer.setAttribute("comment", "");
+            writer.setAttribute("bitDepth", 16);
+            writer.setAttribute("samplingRate", 44100);
+            writer.setAttribute("channelCount", 2);
+            writer.setAttribute("mediaType", "song");
+            writer.setAttribute("played", "");
+            writer.setAttribute("musicBrainzId", "8e5b4b6a-2e5b-4c3e-9f2b-2d9d1f0c4a11");
+            writer.setAttribute("displayArtist", "Some artist");
+            writer.setAttribute("displayAlbumArtist", "Some artist");
+            writer.setAttribute("explicitStatus", "");
+
+            writer.beginArray("artists");
+            writer.beginArrayChild();
+            writer.setAttribute("id", "ar-42");
+            writer.setAttribute("name", "Some artist");
+            writer.endChild();
+            writer.endArray();
+
+            writer.beginArray("albumArtists");
+            writer.beginArrayChild();
+            writer.setAttribute("id", "ar-42");
+            writer.setAttribute("name", "Some artist");
+            writer.endChild();
+            writer.endArray();
+
+            writer.beginArray("contributors");
+            writer.endArray();
+
+            writer.beginValueArray("moods");
+            writer.endArray();
+
+            writer.beginArray("genres");
+            writer.beginArrayChild();
+            writer.setAttribute("name", "Rock");
+            writer.endChild();
+            writer.endArray();
+
+            writer.beginChild("replayGain");
+            writer.setAttribute("trackGain", -7.5F);
+            writer.setAttribute("trackPeak", 0.98F);
+            writer.endChild();
+        }
+
+        Response generateFakeSongListResponse(std::size_t songCount)
+        {
+            Response response{ Response::createOkResponse(defaultServerProtocolVersion) };
+            Response::Node& songListNode{ response.createNode("searchResult3") };
+
+            for (std::size_t i{}; i < songCount; ++i)
+            {
+                Response::Node songNode;
+                writeFakeSong(*createResponseNodeWriter(songNode), i);
+                songListNode.addArrayChild("song", std::move(songNode));
+            }
+
+            return response;
+        }
+
+        void writeFakeSongListResponse(ResponseWriter& writer, std::size_t songCount)
+        {
+            writer.beginOkResponse(defaultServerProtocolVersion);
+            writer.beginChild("searchResult3");
+            writer.beginArray("song");
+
+            for (std::size_t i{}; i < songCount; ++i)
+            {
+                writer.beginArrayChild();
+                writeFakeSong(writer, i);
+                writer.endChild();
+            }
+
+            writer.endArray();
+            writer.endChild();
+            writer.endResponse();
+        }
     } // namespace
 
     static void BM_SubsonicResponse_generate(benchmark::State& state)
@@ -72,9 +176,80 @@ namespace lms::api::subsonic::benchs
         }
     }
 
+    // Build a single song node, as done by createSongNode
+    static void BM_SubsonicResponse_songNode(benchmark::State& state)
+    {
+        TLSMonotonicMemoryResource& memoryResource{ TLSMonotonicMemoryResource::getInstance() };
+        std::size_t allocationCount{};
+        std::size_t allocatedBytes{};
+
+        for (auto _ : state)
+        {
+            {
+                Response::Node songNode;
+                writeFakeSong(*createResponseNodeWriter(songNode), 0);
+                benchmark::DoNotOptimize(songNode);
+            }
+            allocationCount += memoryResource.getStats().allocationCount;
+            allocatedBytes += memoryResource.getStats().allocatedBytes;
+            memoryResource.reset();
+        }
+
+        state.counters["allocs/node"] = benchmark::Counter(static_cast<double>(allocationCount), benchmark::Counter::kAvgIterations);
+        state.counters["bytes/node"] = benchmark::Counter(static_cast<double>(allocatedBytes), benchmark::Counter::kAvgIterations);
+    }
+
+    // Build the whole node tree, then serialize it
+    template<ResponseFormat responseFormat>
+    static void BM_SubsonicResponse_songList_node(benchmark::State& state)
+    {
+        const std::size_t songCount{ static_cast<std::size_t>(state.range(0)) };
+        std::size_t outputSize{};
+
+        for (auto _ : state)
+        {
+            std::ostringstream oss;
+            {
+                const Response response{ generateFakeSongListResponse(songCount) };
+                response.write(oss, responseFormat);
+            }
+            outputSize = oss.view().size();
+            benchmark::DoNotOptimize(oss);
+            TLSMonotonicMemoryResource::getInstance().reset();
+        }
+
+        state.SetItemsProcessed(state.iterations() * songCount);
+        state.SetBytesProcessed(state.iterations() * outputSize);
+    }
+
+    // Write the response directly into a preallocated buffer
+    template<ResponseFormat responseFormat>
+    static void BM_SubsonicResponse_songList_writer(benchmark::State& state)
+    {
+        const std::size_t songCount{ static_cast<std::size_t>(state.range(0)) };
+        std::string buffer;
+        buffer.reserve(64 * 1024);
+
+        for (auto _ : state)
+        {
+            buffer.clear();
+            const auto writer{ createResponseWriter(buffer, responseFormat) };
+            writeFakeSongListResponse(*writer, songCount);
+            benchmark::DoNotOptimize(buffer);
+        }
+
+        state.SetItemsProcessed(state.iterations() * songCount);
+        state.SetBytesProcessed(state.iterations() * buffer.size());
+    }
+
     BENCHMARK(BM_SubsonicResponse_generate)->Threads(1)->Threads(std::thread::hardware_concurrency());
     BENCHMARK(BM_SubsonicResponse_serialize<ResponseFormat::json>);
     BENCHMARK(BM_SubsonicResponse_serialize<ResponseFormat::xml>);
+    BENCHMARK(BM_SubsonicResponse_songNode);
+    BENCHMARK(BM_SubsonicResponse_songList_node<ResponseFormat::json>)->Arg(10)->Arg(100)->Arg(1000);
+    BENCHMARK(BM_SubsonicResponse_songList_writer<ResponseFormat::json>)->Arg(10)->Arg(100)->Arg(1000);
+    BENCHMARK(BM_SubsonicResponse_songList_node<ResponseFormat::xml>)->Arg(10)->Arg(100)->Arg(1000);
+    BENCHMARK(BM_SubsonicResponse_songList_writer<ResponseFormat::xml>)->Arg(10)->Arg(100)->Arg(1000);
 } // namespace lms::api::subsonic::benchs
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "core/Random.hpp"
+#include "database/objects/MediaLibraryId.hpp"
+#include "database/objects/UserId.hpp"
+
+namespace lms::api::subsonic
+{
+    // List endpoints can be used to scan/sync the database
+    // This class is used to keep track of the current scans, in order to retrieve the last objectId
+    // to speed up the query of the following range (avoid the 'offset' cost)
+    // The last objectId acts as a continuation token, kept on server side since the API only provides offsets
+    template<typename ObjectId>
+    class ScanTracker
+    {
+    public:
+        struct ScanInfo
+        {
+            std::string clientAddress;
+            std::string clientName;
+            db::UserId user;
+            db::MediaLibraryId library;
+            std::string context; // endpoint specific parameters that affect the results (list type, genre, etc.)
+            std::size_t offset{};
+            auto operator<=>(const ScanInfo&) const = default;
+        };
+
+        ObjectId extractLastRetrievedObjectId(const ScanInfo& info);
+        void setObjectId(const ScanInfo& info, ObjectId lastRetrievedId);
+
+    private:
+        using ClockType = std::chrono::steady_clock;
+
+        struct Entry
+        {
+            ClockType::time_point timePoint;
+            ObjectId objectId;
+        };
+
+        static constexpr std::size_t maxScanCount{ 50 };
+        static constexpr ClockType::duration maxEntryDuration{ std::chrono::seconds{ 30 } };
+
+        std::mutex _mutex;
+        std::map<ScanInfo, Entry> _ongoingScans;
+    };
+
+    template<typename ObjectId>
+    ObjectId ScanTracker<ObjectId>::extractLastRetrievedObjectId(const ScanInfo& scanInfo)
+    {
+        ObjectId res;
+
+        {
+            const std::scoped_lock lock{ _mutex };
+
+            auto it{ _ongoingScans.find(scanInfo) };
+            if (it != _ongoingScans.end())
+            {
+                res = it->second.objectId;
+                _ongoingScans.erase(it);
+            }
+        }
+
+        return res;
+    }
+
+    template<typename ObjectId>
+    void ScanTracker<ObjectId>::setObjectId(const ScanInfo& scanInfo, ObjectId lastRetrievedId)
+    {
+        const ClockType::time_point now{ ClockType::now() };
+
+        const std::scoped_lock lock{ _mutex };
+
+        // clean outdated scan entries; we do this to not have to flush everything each time we add/remove entries in the database
+        std::erase_if(_ongoingScans, [&](const auto& entry) { return now > entry.second.timePoint + maxEntryDuration; });
+        // prevent the cache size from going out of control
+        if (_ongoingScans.size() == maxScanCount)
+            _ongoingScans.erase(core::random::pickRandom(_ongoingScans));
+
+        _ongoingScans[scanInfo] = { now, lastRetrievedId };
+    }
+} // namespace lms::api::subsonic
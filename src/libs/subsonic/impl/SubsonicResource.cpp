@@ -20,7 +20,9 @@
 #include "SubsonicResource.hpp"
 
 #include <atomic>
+#include <optional>
 #include <unordered_map>
+#include <variant>
 
 #include "core/EnumSet.hpp"
 #include "core/IConfig.hpp"
@@ -29,15 +31,18 @@
 #include "core/LiteralString.hpp"
 #include "core/Service.hpp"
 #include "core/String.hpp"
+#include "core/Utils.hpp"
 #include "database/IDb.hpp"
 #include "database/Session.hpp"
 #include "database/objects/User.hpp"
+#include "database/profiling/IQueryProfiler.hpp"
 #include "services/auth/IAuthTokenService.hpp"
 #include "services/auth/IPasswordService.hpp"
 
 #include "ParameterParsing.hpp"
 #include "RequestContext.hpp"
 #include "SubsonicResponse.hpp"
+#include "SubsonicResponseWriter.hpp"
 #include "endpoints/AlbumSongLists.hpp"
 #include "endpoints/Bookmarks.hpp"
 #include "endpoints/Browsing.hpp"
@@ -123,9 +128,11 @@ namespace lms::api::subsonic
             Unauthenticated,
         };
         using RequestHandlerFunc = std::function<Response(RequestContext& context)>;
+        // For endpoints that may return a lot of entries: the content is directly written, without building the whole response tree
+        using StreamedRequestHandlerFunc = std::function<void(RequestContext& context, ResponseWriter& writer)>;
         struct RequestEntryPointInfo
         {
-            RequestHandlerFunc func;
+            std::variant<RequestHandlerFunc, StreamedRequestHandlerFunc> func;
             AuthenticationMode authMode{ AuthenticationMode::Authenticated };
             core::EnumSet<db::UserType> allowedUserTypes{ db::UserType::DEMO, db::UserType::REGULAR, db::UserType::ADMIN };
         };
@@ -269,6 +276,22 @@ namespace lms::api::subsonic
             TLSMonotonicMemoryResourceCleaner& operator=(const TLSMonotonicMemoryResourceCleaner&) = delete;
         };
 
+        std::string& getStreamedResponseBuffer()
+        {
+            constexpr std::size_t initialCapacity{ 64 * 1024 };
+            constexpr std::size_t maxRetainedCapacity{ 4 * 1024 * 1024 };
+
+            // Kept per thread so that the memory is reused across requests
+            static thread_local std::string buffer;
+
+            buffer.clear();
+            if (buffer.capacity() > maxRetainedCapacity)
+                buffer.shrink_to_fit();
+            buffer.reserve(initialCapacity);
+
+            return buffer;
+        }
+
         db::User::pointer getUserFromUserId(db::Session& session, db::UserId userId)
         {
             auto transaction{ session.createReadTransaction() };
@@ -298,6 +321,16 @@ namespace lms::api::subsonic
         if (core::stringUtils::stringEndsWith(requestPath, optionalSuffix))
             requestPath.resize(requestPath.length() - optionalSuffix.size());
 
+        // unknown endpoints share the same origin, to keep the number of distinct origins bounded
+        std::string queryOrigin;
+        std::optional<db::ScopedQueryOrigin> scopedQueryOrigin;
+        if (core::Service<db::IQueryProfiler>::get())
+        {
+            const bool isKnownEndpoint{ requestEntryPoints.contains(requestPath) || mediaRetrievalHandlers.contains(requestPath) };
+            queryOrigin = "subsonic:" + (isKnownEndpoint ? requestPath : std::string{ "<unknown>" });
+            scopedQueryOrigin.emplace(queryOrigin);
+        }
+
         LMS_LOG(API_SUBSONIC, DEBUG, "Handling request " << requestId << " to '" << requestPath << " with params = " << parameterMapToDebugString(request.getParameterMap()) << "', continuation = " << (request.continuation() ? "true" : "false"));
 
         try
@@ -401,12 +434,31 @@ namespace lms::api::subsonic
                     requestContext->setUser(user);
                 }
 
-                const Response resp{ [&] {
-                    LMS_SCOPED_TRACE_DETAILED("Subsonic", "HandleRequest");
-                    return itEntryPoint->second.func(*requestContext);
-                }() };
-
-                writeResponse(resp, requestContext->getResponseFormat());
+                std::visit(core::utils::overloads{
+                               [&](const RequestHandlerFunc& func) {
+                                   const Response resp{ [&] {
+                                       LMS_SCOPED_TRACE_DETAILED("Subsonic", "HandleRequest");
+                                       return func(*requestContext);
+                                   }() };
+
+                                   writeResponse(resp, requestContext->getResponseFormat());
+                               },
+                               [&](const StreamedRequestHandlerFunc& func) {
+                                   // Nothing is sent until the handler succeeds, so that a failed response can still be sent
+                                   std::string& buffer{ getStreamedResponseBuffer() };
+                                   {
+                                       LMS_SCOPED_TRACE_DETAILED("Subsonic", "HandleRequest");
+
+                                       const auto writer{ createResponseWriter(buffer, requestContext->getResponseFormat()) };
+                                       writer->beginOkResponse(requestContext->getServerProtocolVersion());
+                                       func(*requestContext, *writer);
+                                       writer->endResponse();
+                                   }
+
+                                   response.out().write(buffer.data(), buffer.size());
+                                   response.setMimeType(std::string{ ResponseFormatToMimeType(requestContext->getResponseFormat()) });
+                               } },
+                           itEntryPoint->second.func);
                 return;
             }
             // do not disclose unhandled commands for unauthenticated users
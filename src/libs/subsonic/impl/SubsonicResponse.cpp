@@ -58,8 +58,8 @@ namespace lms::api::subsonic
     void Response::Node::createEmptyArrayChild(Key key)
     {
         assert(!_value);
-        assert(_children.find(key) == std::cend(_children));
-        _childrenArrays.emplace(key, vector<Node>{});
+        assert(!_children.contains(key));
+        _childrenArrays[key];
     }
 
     void Response::Node::addArrayChild(Key key, Node&& node)
@@ -73,7 +73,7 @@ namespace lms::api::subsonic
     {
         assert(!_value);
         assert(!_children.contains(key));
-        _childrenValues.emplace(key, ValuesType{});
+        _childrenValues[key];
     }
 
     void Response::Node::addArrayValue(Key key, std::string_view value)
@@ -103,8 +103,7 @@ namespace lms::api::subsonic
     {
         assert(!_value);
         assert(!_children.contains(key));
-        _childrenArrays[key].emplace_back();
-        return _childrenArrays[key].back();
+        return _childrenArrays[key].emplace_back();
     }
 
     void Response::Node::setVersionAttribute(ProtocolVersion protocolVersion)
@@ -18,10 +18,10 @@
  */
 #pragma once
 
-#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -33,6 +33,8 @@
 
 namespace lms::api::subsonic
 {
+    class ResponseWriter;
+
     // Max count expected from all API methods that expose a count
     static inline constexpr std::size_t defaultMaxCountSize{ 1'000 };
 
@@ -279,6 +281,7 @@ namespace lms::api::subsonic
             // A Node has either a single value or an array of values or some children
             void setValue(std::string_view value);
             void setValue(long long value);
+            // Returned references are invalidated by the next child creation on the same node
             Node& createChild(Key key);
             Node& createArrayChild(Key key);
 
@@ -293,23 +296,63 @@ namespace lms::api::subsonic
             void setVersionAttribute(ProtocolVersion version);
 
             friend class Response;
-
-            template<typename Key, typename Value>
-            using map = std::map<Key, Value, std::less<Key>, ResponseAllocator<std::pair<const Key, Value>>>;
+            friend class ResponseWriter;
 
             template<typename T>
             using vector = std::vector<T, ResponseAllocator<T>>;
 
+            // Entries are kept in insertion order, lookups are linear since a node only has a few distinct keys
+            template<typename Value>
+            class FlatMap
+            {
+            public:
+                using Entry = std::pair<Key, Value>;
+
+                auto begin() const { return std::cbegin(_entries); }
+                auto end() const { return std::cend(_entries); }
+                bool empty() const { return _entries.empty(); }
+                std::size_t size() const { return _entries.size(); }
+
+                const Value* find(Key key) const
+                {
+                    // most recently added keys are more likely to be accessed
+                    for (auto it{ std::crbegin(_entries) }; it != std::crend(_entries); ++it)
+                    {
+                        if (isSameKey(it->first, key))
+                            return &it->second;
+                    }
+                    return nullptr;
+                }
+                Value* find(Key key) { return const_cast<Value*>(std::as_const(*this).find(key)); }
+                bool contains(Key key) const { return find(key); }
+
+                Value& operator[](Key key)
+                {
+                    if (Value* value{ find(key) })
+                        return *value;
+                    return _entries.emplace_back(key, Value{}).second;
+                }
+
+            private:
+                static bool isSameKey(Key lhs, Key rhs)
+                {
+                    // same literals are usually merged
+                    return (lhs.c_str() == rhs.c_str() && lhs.length() == rhs.length()) || lhs == rhs;
+                }
+
+                vector<Entry> _entries;
+            };
+
             using string = std::basic_string<char, std::char_traits<char>, ResponseAllocator<char>>;
 
             using ValueType = std::variant<string, bool, float, long long>;
-            map<Key, ValueType> _attributes;
+            FlatMap<ValueType> _attributes;
             std::optional<ValueType> _value;
-            map<Key, Node> _children;
-            map<Key, vector<Node>> _childrenArrays;
+            FlatMap<Node> _children;
+            FlatMap<vector<Node>> _childrenArrays;
 
             using ValuesType = vector<ValueType>;
-            map<Key, ValuesType> _childrenValues;
+            FlatMap<ValuesType> _childrenValues;
         };
 
         static Response createOkResponse(ProtocolVersion protocolVersion);
@@ -0,0 +1,570 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SubsonicResponseWriter.hpp"
+
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "core/String.hpp"
+#include "core/Utils.hpp"
+#include "core/Version.hpp"
+
+namespace lms::api::subsonic
+{
+    namespace
+    {
+        constexpr std::string_view subsonicResponseTagName{ "subsonic-response" };
+
+        void appendInteger(std::string& output, long long value)
+        {
+            std::array<char, std::numeric_limits<long long>::digits10 + 3> buffer;
+            const auto result{ std::to_chars(buffer.data(), buffer.data() + buffer.size(), value) };
+            output.append(buffer.data(), result.ptr);
+        }
+
+        // Same output as std::ostream's default formatting
+        void appendFloat(std::string& output, float value)
+        {
+            std::array<char, 32> buffer;
+            const auto result{ std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::general, 6) };
+            output.append(buffer.data(), result.ptr);
+        }
+
+        std::string_view boolToString(bool value)
+        {
+            return value ? "true" : "false";
+        }
+
+        class JsonResponseWriter final : public ResponseWriter
+        {
+        public:
+            JsonResponseWriter(std::string& output)
+                : _output{ output }
+            {
+                _frames.reserve(16);
+            }
+
+        private:
+            struct Frame
+            {
+                bool hasContent{};
+            };
+
+            void beginDocument() override
+            {
+                _output += '{';
+                _frames.push_back(Frame{});
+            }
+
+            void endDocument() override
+            {
+                assert(_frames.size() == 1);
+                _frames.pop_back();
+                _output += '}';
+            }
+
+            void beginChild(Key key) override
+            {
+                writeKey(key);
+                _output += '{';
+                _frames.push_back(Frame{});
+            }
+
+            void endChild() override
+            {
+                _frames.pop_back();
+                _output += '}';
+            }
+
+            void beginArray(Key key) override
+            {
+                writeKey(key);
+                _output += '[';
+                _frames.push_back(Frame{});
+            }
+
+            void beginArrayChild() override
+            {
+                writeSeparator();
+                _output += '{';
+                _frames.push_back(Frame{});
+            }
+
+            void beginValueArray(Key key) override
+            {
+                beginArray(key);
+            }
+
+            void addArrayValue(std::string_view value) override
+            {
+                writeSeparator();
+                writeString(value);
+            }
+
+            void addArrayValue(long long value) override
+            {
+                writeSeparator();
+                appendInteger(_output, value);
+            }
+
+            void endArray() override
+            {
+                _frames.pop_back();
+                _output += ']';
+            }
+
+            void setStringAttribute(Key key, std::string_view value) override
+            {
+                writeKey(key);
+                writeString(value);
+            }
+
+            void setBoolAttribute(Key key, bool value) override
+            {
+                writeKey(key);
+                _output += boolToString(value);
+            }
+
+            void setFloatAttribute(Key key, float value) override
+            {
+                writeKey(key);
+                if (std::isnan(value) || std::fabs(value) == std::numeric_limits<float>::infinity())
+                    _output += "null";
+                else
+                    appendFloat(_output, value);
+            }
+
+            void setIntegerAttribute(Key key, long long value) override
+            {
+                writeKey(key);
+                appendInteger(_output, value);
+            }
+
+            void setValue(std::string_view) override
+            {
+                // Values are handled manually (using attributes) in json format
+                assert(false);
+            }
+
+            void setValue(long long) override
+            {
+                assert(false);
+            }
+
+            void writeSeparator()
+            {
+                assert(!_frames.empty());
+                if (_frames.back().hasContent)
+                    _output += ',';
+                _frames.back().hasContent = true;
+            }
+
+            void writeKey(Key key)
+            {
+                writeSeparator();
+                writeString(key.str());
+                _output += ':';
+            }
+
+            void writeString(std::string_view str)
+            {
+                _output += '"';
+                core::stringUtils::appendJsonEscapedString(_output, str);
+                _output += '"';
+            }
+
+            std::string& _output;
+            std::vector<Frame> _frames;
+        };
+
+        class XmlResponseWriter final : public ResponseWriter
+        {
+        public:
+            XmlResponseWriter(std::string& output)
+                : _output{ output }
+            {
+                _frames.reserve(16);
+            }
+
+        private:
+            enum class FrameType
+            {
+                Child,
+                Array,
+                ValueArray,
+            };
+
+            struct Frame
+            {
+                FrameType type;
+                std::string_view tagName;
+                bool openingTagPending{}; // attributes can still be added
+            };
+
+            void beginDocument() override
+            {
+                _output += R"(<?xml version="1.0" encoding="utf-8"?>)";
+                _output += '\n';
+            }
+
+            void endDocument() override
+            {
+                assert(_frames.empty());
+            }
+
+            void beginChild(Key key) override
+            {
+                openChild(key.str());
+            }
+
+            void endChild() override
+            {
+                assert(!_frames.empty() && _frames.back().type == FrameType::Child);
+                const Frame& frame{ _frames.back() };
+                if (frame.openingTagPending)
+                {
+                    writeOpeningTagSuffix(frame);
+                    _output += "/>";
+                }
+                else
+                {
+                    _output += "</";
+                    _output += frame.tagName;
+                    _output += '>';
+                }
+                _frames.pop_back();
+            }
+
+            void beginArray(Key key) override
+            {
+                closeOpeningTag();
+                _frames.push_back(Frame{ .type = FrameType::Array, .tagName = key.str() });
+            }
+
+            void beginArrayChild() override
+            {
+                assert(!_frames.empty() && _frames.back().type == FrameType::Array);
+                openChild(_frames.back().tagName);
+            }
+
+            void beginValueArray(Key key) override
+            {
+                closeOpeningTag();
+                _frames.push_back(Frame{ .type = FrameType::ValueArray, .tagName = key.str() });
+            }
+
+            void addArrayValue(std::string_view value) override
+            {
+                assert(!_frames.empty() && _frames.back().type == FrameType::ValueArray);
+                openValueTag();
+                core::stringUtils::appendXmlEscapedString(_output, value);
+                closeValueTag();
+            }
+
+            void addArrayValue(long long value) override
+            {
+                assert(!_frames.empty() && _frames.back().type == FrameType::ValueArray);
+                openValueTag();
+                appendInteger(_output, value);
+                closeValueTag();
+            }
+
+            void endArray() override
+            {
+                assert(!_frames.empty() && _frames.back().type != FrameType::Child);
+                _frames.pop_back();
+            }
+
+            void setStringAttribute(Key key, std::string_view value) override
+            {
+                beginAttribute(key);
+                core::stringUtils::appendXmlEscapedString(_output, value);
+                _output += '"';
+            }
+
+            void setBoolAttribute(Key key, bool value) override
+            {
+                beginAttribute(key);
+                _output += boolToString(value);
+                _output += '"';
+            }
+
+            void setFloatAttribute(Key key, float value) override
+            {
+                beginAttribute(key);
+                appendFloat(_output, value);
+                _output += '"';
+            }
+
+            void setIntegerAttribute(Key key, long long value) override
+            {
+                beginAttribute(key);
+                appendInteger(_output, value);
+                _output += '"';
+            }
+
+            void setValue(std::string_view value) override
+            {
+                closeOpeningTag();
+                core::stringUtils::appendXmlEscapedString(_output, value);
+            }
+
+            void setValue(long long value) override
+            {
+                closeOpeningTag();
+                appendInteger(_output, value);
+            }
+
+            void openChild(std::string_view tagName)
+            {
+                closeOpeningTag();
+                _output += '<';
+                _output += tagName;
+                _frames.push_back(Frame{ .type = FrameType::Child, .tagName = tagName, .openingTagPending = true });
+            }
+
+            void beginAttribute(Key key)
+            {
+                assert(!_frames.empty() && _frames.back().openingTagPending);
+                _output += ' ';
+                _output += key.str();
+                _output += "=\"";
+            }
+
+            void writeOpeningTagSuffix(const Frame& frame)
+            {
+                // Hack
+                if (frame.tagName == subsonicResponseTagName)
+                    _output += " xmlns=\"http://subsonic.org/restapi\"";
+            }
+
+            void closeOpeningTag()
+            {
+                if (_frames.empty() || !_frames.back().openingTagPending)
+                    return;
+
+                writeOpeningTagSuffix(_frames.back());
+                _output += '>';
+                _frames.back().openingTagPending = false;
+            }
+
+            void openValueTag()
+            {
+                _output += '<';
+                _output += _frames.back().tagName;
+                _output += '>';
+            }
+
+            void closeValueTag()
+            {
+                _output += "</";
+                _output += _frames.back().tagName;
+                _output += '>';
+            }
+
+            std::string& _output;
+            std::vector<Frame> _frames;
+        };
+
+        class ResponseNodeWriter final : public ResponseWriter
+        {
+        public:
+            ResponseNodeWriter(Response::Node& node)
+            {
+                _frames.push_back(Frame{ .node = &node, .arrayKey = {} });
+            }
+
+        private:
+            struct Frame
+            {
+                Response::Node* node;
+                std::optional<Key> arrayKey;
+            };
+
+            void beginDocument() override {}
+            void endDocument() override {}
+
+            void beginChild(Key key) override
+            {
+                _frames.push_back(Frame{ .node = &getCurrentNode().createChild(key), .arrayKey = {} });
+            }
+
+            void endChild() override
+            {
+                assert(_frames.size() > 1 && !_frames.back().arrayKey);
+                _frames.pop_back();
+            }
+
+            void beginArray(Key key) override
+            {
+                getCurrentNode().createEmptyArrayChild(key);
+                _frames.push_back(Frame{ .node = &getCurrentNode(), .arrayKey = key });
+            }
+
+            void beginArrayChild() override
+            {
+                assert(_frames.back().arrayKey);
+                _frames.push_back(Frame{ .node = &getCurrentNode().createArrayChild(*_frames.back().arrayKey), .arrayKey = {} });
+            }
+
+            void beginValueArray(Key key) override
+            {
+                getCurrentNode().createEmptyArrayValue(key);
+                _frames.push_back(Frame{ .node = &getCurrentNode(), .arrayKey = key });
+            }
+
+            void addArrayValue(std::string_view value) override
+            {
+                assert(_frames.back().arrayKey);
+                getCurrentNode().addArrayValue(*_frames.back().arrayKey, value);
+            }
+
+            void addArrayValue(long long value) override
+            {
+                assert(_frames.back().arrayKey);
+                getCurrentNode().addArrayValue(*_frames.back().arrayKey, value);
+            }
+
+            void endArray() override
+            {
+                assert(_frames.back().arrayKey);
+                _frames.pop_back();
+            }
+
+            void setStringAttribute(Key key, std::string_view value) override { getCurrentNode().setAttribute(key, value); }
+            void setBoolAttribute(Key key, bool value) override { getCurrentNode().setAttribute(key, value); }
+            void setFloatAttribute(Key key, float value) override { getCurrentNode().setAttribute(key, value); }
+            void setIntegerAttribute(Key key, long long value) override { getCurrentNode().setAttribute(key, value); }
+
+            void setValue(std::string_view value) override { getCurrentNode().setValue(value); }
+            void setValue(long long value) override { getCurrentNode().setValue(value); }
+
+            Response::Node& getCurrentNode() { return *_frames.back().node; }
+
+            std::vector<Frame> _frames;
+        };
+    } // namespace
+
+    void ResponseWriter::beginOkResponse(ProtocolVersion protocolVersion)
+    {
+        beginDocument();
+        beginChild(Key{ "subsonic-response" });
+
+        // Same fields as Response::createOkResponse, in the same order
+        setAttribute("status", "ok");
+        setAttribute("version", std::to_string(protocolVersion.major) + "." + std::to_string(protocolVersion.minor) + "." + std::to_string(protocolVersion.patch));
+        setAttribute("type", "lms");
+        setAttribute("serverVersion", core::getVersion());
+        setAttribute("openSubsonic", true);
+    }
+
+    void ResponseWriter::endResponse()
+    {
+        endChild();
+        endDocument();
+    }
+
+    void ResponseWriter::addChild(Key key, const Response::Node& node)
+    {
+        beginChild(key);
+        addNodeContent(node);
+        endChild();
+    }
+
+    void ResponseWriter::addArrayChild(const Response::Node& node)
+    {
+        beginArrayChild();
+        addNodeContent(node);
+        endChild();
+    }
+
+    void ResponseWriter::addNodeContent(const Response::Node& node)
+    {
+        for (const auto& [key, value] : node._attributes)
+        {
+            std::visit(core::utils::overloads{
+                           [&](const Response::Node::string& str) { setStringAttribute(key, str); },
+                           [&](bool value) { setBoolAttribute(key, value); },
+                           [&](float value) { setFloatAttribute(key, value); },
+                           [&](long long value) { setIntegerAttribute(key, value); } },
+                       value);
+        }
+
+        if (node._value)
+        {
+            std::visit(core::utils::overloads{
+                           [&](const Response::Node::string& str) { setValue(str); },
+                           [&](bool value) { setValue(boolToString(value)); },
+                           [&](float) { assert(false); },
+                           [&](long long value) { setValue(value); } },
+                       *node._value);
+        }
+
+        for (const auto& [key, childNode] : node._children)
+            addChild(key, childNode);
+
+        for (const auto& [key, childArrayNodes] : node._childrenArrays)
+        {
+            beginArray(key);
+            for (const Response::Node& childNode : childArrayNodes)
+                addArrayChild(childNode);
+            endArray();
+        }
+
+        for (const auto& [key, childValues] : node._childrenValues)
+        {
+            beginValueArray(key);
+            for (const Response::Node::ValueType& value : childValues)
+            {
+                std::visit(core::utils::overloads{
+                               [&](const Response::Node::string& str) { addArrayValue(std::string_view{ str }); },
+                               [&](bool value) { addArrayValue(boolToString(value)); },
+                               [&](float) { assert(false); },
+                               [&](long long value) { addArrayValue(value); } },
+                           value);
+            }
+            endArray();
+        }
+    }
+
+    std::unique_ptr<ResponseWriter> createResponseWriter(std::string& output, ResponseFormat format)
+    {
+        switch (format)
+        {
+        case ResponseFormat::xml:
+            return std::make_unique<XmlResponseWriter>(output);
+        case ResponseFormat::json:
+            return std::make_unique<JsonResponseWriter>(output);
+        }
+
+        return nullptr;
+    }
+
+    std::unique_ptr<ResponseWriter> createResponseNodeWriter(Response::Node& node)
+    {
+        return std::make_unique<ResponseNodeWriter>(node);
+    }
+} // namespace lms::api::subsonic
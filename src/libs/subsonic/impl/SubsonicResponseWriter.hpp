@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 Emeric Poupon
+ *
+ * This file is part of LMS.
+ *
+ * LMS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "ProtocolVersion.hpp"
+#include "ResponseFormat.hpp"
+#include "SubsonicResponse.hpp"
+
+namespace lms::api::subsonic
+{
+    // Push-style alternative to Response::Node: the content is written as it is produced, without building any intermediate tree
+    // Since the XML format requires it, all the attributes of a child must be set before its own children, arrays or value
+    class ResponseWriter
+    {
+    public:
+        using Key = Response::Node::Key;
+
+        virtual ~ResponseWriter() = default;
+        ResponseWriter(const ResponseWriter&) = delete;
+        ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+        // Envelope (subsonic-response), the content must be written between both calls
+        void beginOkResponse(ProtocolVersion protocolVersion);
+        void endResponse();
+
+        template<typename T, std::enable_if_t<std::is_arithmetic<T>::value>* = nullptr>
+        void setAttribute(Key key, T value)
+        {
+            if constexpr (std::is_same<bool, T>::value)
+                setBoolAttribute(key, value);
+            else if constexpr (std::is_floating_point<T>::value)
+                setFloatAttribute(key, static_cast<float>(value));
+            else if constexpr (std::is_integral<T>::value)
+                setIntegerAttribute(key, static_cast<long long>(value));
+            else
+                static_assert("Unhandled type");
+        }
+        void setAttribute(Key key, std::string_view value) { setStringAttribute(key, value); }
+        void setAttribute(Key key, const char* value) { setStringAttribute(key, value); }
+        void setAttribute(Key key, const std::string& value) { setStringAttribute(key, value); }
+
+        virtual void beginChild(Key key) = 0;
+        virtual void endChild() = 0;
+
+        // Array of children: each entry is opened using beginArrayChild and closed using endChild
+        virtual void beginArray(Key key) = 0;
+        virtual void beginArrayChild() = 0;
+        // Array of values
+        virtual void beginValueArray(Key key) = 0;
+        virtual void addArrayValue(std::string_view value) = 0;
+        virtual void addArrayValue(long long value) = 0;
+        virtual void endArray() = 0;
+
+        // Helpers to write small nodes built using the regular API
+        void addChild(Key key, const Response::Node& node);
+        void addArrayChild(const Response::Node& node);
+        // Write the attributes and children of the node into the current child
+        void addNodeContent(const Response::Node& node);
+
+    protected:
+        ResponseWriter() = default;
+
+        virtual void beginDocument() = 0;
+        virtual void endDocument() = 0;
+
+        virtual void setStringAttribute(Key key, std::string_view value) = 0;
+        virtual void setBoolAttribute(Key key, bool value) = 0;
+        virtual void setFloatAttribute(Key key, float value) = 0;
+        virtual void setIntegerAttribute(Key key, long long value) = 0;
+
+        // Only supported by the XML format
+        virtual void setValue(std::string_view value) = 0;
+        virtual void setValue(long long value) = 0;
+    };
+
+    // Tokens are appended to output, whose capacity is expected to be reserved by the caller
+    std::unique_ptr<ResponseWriter> createResponseWriter(std::string& output, ResponseFormat format);
+
+    // Fills the given node, used to share the same code between both APIs
+    std::unique_ptr<ResponseWriter> createResponseNodeWriter(Response::Node& node);
+} // namespace lms::api::subsonic
@@ -57,6 +57,9 @@ namespace lms::api::subsonic
             std::byte* res{ currentAddrAligned };
             _currentAddr = currentAddrAligned + byteCount;
 
+            _stats.allocationCount++;
+            _stats.allocatedBytes += byteCount;
+
             return res;
         }
 
@@ -76,8 +79,17 @@ namespace lms::api::subsonic
 
             _currentBlock = &_blocks.front();
             _currentAddr = _currentBlock->data.get();
+            _stats = Stats{};
         }
 
+        // Since last reset
+        struct Stats
+        {
+            std::size_t allocationCount{};
+            std::size_t allocatedBytes{};
+        };
+        const Stats& getStats() const { return _stats; }
+
     private:
         void allocateNewBlock(std::size_t size)
         {
@@ -114,5 +126,6 @@ namespace lms::api::subsonic
         std::vector<Block> _blocks;
         Block* _currentBlock{};
         std::byte* _currentAddr{};
+        Stats _stats;
     };
 } // namespace lms::api::subsonic
\ No newline at end of file
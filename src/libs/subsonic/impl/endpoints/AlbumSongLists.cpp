@@ -20,6 +20,7 @@
 #include "AlbumSongLists.hpp"
 
 #include <algorithm>
+#include <cassert>
 
 #include "core/Service.hpp"
 #include "database/Session.hpp"
@@ -33,6 +34,7 @@
 #include "services/scrobbling/IScrobblingService.hpp"
 
 #include "ParameterParsing.hpp"
+#include "ScanTracker.hpp"
 #include "SubsonicId.hpp"
 #include "responses/Album.hpp"
 #include "responses/Artist.hpp"
@@ -44,7 +46,45 @@ namespace lms::api::subsonic
 
     namespace
     {
-        Response handleGetAlbumListRequestCommon(RequestContext& context, bool id3)
+        // Clients syncing their whole library iterate over the pages: resume from the last release of the previous page instead of paying the offset cost
+        RangeResults<ReleaseId> findReleaseIdsUsingScanTracker(RequestContext& context, Release::FindParameters params, std::string scanContext)
+        {
+            static ScanTracker<ReleaseId> currentScansInProgress;
+
+            assert(params.range);
+            assert(Release::isKeysetPaginationSupported(params.sortMethod));
+
+            const Range requestedRange{ *params.range };
+            ScanTracker<ReleaseId>::ScanInfo scanInfo{
+                .clientAddress = context.getClientIpAddr(),
+                .clientName = std::string{ context.getClientName() },
+                .user = context.getUser()->getId(),
+                .library = params.filters.mediaLibrary,
+                .context = std::move(scanContext),
+                .offset = requestedRange.offset
+            };
+
+            // the cached release may have been removed in the meantime
+            const ReleaseId cachedLastRetrievedId{ currentScansInProgress.extractLastRetrievedObjectId(scanInfo) };
+            if (cachedLastRetrievedId.isValid() && Release::exists(context.getDbSession(), cachedLastRetrievedId))
+            {
+                params.setLastReleaseId(cachedLastRetrievedId);
+                params.setRange(Range{ 0, requestedRange.size });
+            }
+
+            RangeResults<ReleaseId> releases{ Release::findIds(context.getDbSession(), params) };
+            releases.range.offset = requestedRange.offset;
+
+            if (!releases.results.empty())
+            {
+                scanInfo.offset = requestedRange.offset + requestedRange.size;
+                currentScansInProgress.setObjectId(scanInfo, releases.results.back());
+            }
+
+            return releases;
+        }
+
+        void handleGetAlbumListRequestCommon(RequestContext& context, ResponseWriter& writer, bool id3)
         {
             // Mandatory params
             const std::string type{ getMandatoryParameterAs<std::string>(context.getParameters(), "type") };
@@ -71,7 +111,7 @@ namespace lms::api::subsonic
                 params.setRange(range);
                 params.filters.setMediaLibrary(mediaLibraryId);
 
-                releases = Release::findIds(context.getDbSession(), params);
+                releases = findReleaseIdsUsingScanTracker(context, params, type);
             }
             else if (type == "alphabeticalByArtist")
             {
@@ -97,7 +137,7 @@ namespace lms::api::subsonic
                         params.setSortMethod(ReleaseSortMethod::Name);
                         params.setRange(range);
 
-                        releases = Release::findIds(context.getDbSession(), params);
+                        releases = findReleaseIdsUsingScanTracker(context, params, type + "/" + genre);
                     }
                 }
             }
@@ -166,16 +206,21 @@ namespace lms::api::subsonic
                 throw NotImplementedGenericError{};
             }
 
-            Response response{ Response::createOkResponse(context.getServerProtocolVersion()) };
-            Response::Node& albumListNode{ response.createNode(id3 ? Response::Node::Key{ "albumList2" } : Response::Node::Key{ "albumList" }) };
+            // Albums are written as they are fetched, lists can be large
+            writer.beginChild(id3 ? ResponseWriter::Key{ "albumList2" } : ResponseWriter::Key{ "albumList" });
+            writer.beginArray("album");
 
             for (const ReleaseId releaseId : releases.results)
             {
                 const Release::pointer release{ Release::find(context.getDbSession(), releaseId) };
-                albumListNode.addArrayChild("album", createAlbumNode(context, release, id3));
+
+                writer.beginArrayChild();
+                writeAlbum(writer, context, release, id3);
+                writer.endChild();
             }
 
-            return response;
+            writer.endArray();
+            writer.endChild();
         }
 
         Response handleGetStarredRequestCommon(RequestContext& context, bool id3)
@@ -223,14 +268,14 @@ namespace lms::api::subsonic
         }
     } // namespace
 
-    Response handleGetAlbumListRequest(RequestContext& context)
+    void handleGetAlbumListRequest(RequestContext& context, ResponseWriter& writer)
     {
-        return handleGetAlbumListRequestCommon(context, false /* no id3 */);
+        handleGetAlbumListRequestCommon(context, writer, false /* no id3 */);
     }
 
-    Response handleGetAlbumList2Request(RequestContext& context)
+    void handleGetAlbumList2Request(RequestContext& context, ResponseWriter& writer)
     {
-        return handleGetAlbumListRequestCommon(context, true /* id3 */);
+        handleGetAlbumListRequestCommon(context, writer, true /* id3 */);
     }
 
     Response handleGetRandomSongsRequest(RequestContext& context)
@@ -284,15 +329,42 @@ namespace lms::api::subsonic
         Response response{ Response::createOkResponse(context.getServerProtocolVersion()) };
         Response::Node& songsByGenreNode{ response.createNode("songsByGenre") };
 
+        static ScanTracker<TrackId> currentScansInProgress;
+
+        ScanTracker<TrackId>::ScanInfo scanInfo{
+            .clientAddress = context.getClientIpAddr(),
+            .clientName = std::string{ context.getClientName() },
+            .user = context.getUser()->getId(),
+            .library = mediaLibrary,
+            .context = genre,
+            .offset = offset
+        };
+
         Track::FindParameters params;
         params.filters.setClusters(std::initializer_list<ClusterId>{ cluster->getId() });
         params.filters.setMediaLibrary(mediaLibrary);
+        params.setSortMethod(TrackSortMethod::Id); // needed to resume from the last retrieved track
         params.setRange(Range{ offset, count });
 
+        // the cached track may have been removed in the meantime
+        if (const TrackId cachedLastRetrievedId{ currentScansInProgress.extractLastRetrievedObjectId(scanInfo) }; cachedLastRetrievedId.isValid() && Track::exists(context.getDbSession(), cachedLastRetrievedId))
+        {
+            params.setLastTrackId(cachedLastRetrievedId);
+            params.setRange(Range{ 0, count });
+        }
+
+        TrackId lastRetrievedId;
         Track::find(context.getDbSession(), params, [&](const Track::pointer& track) {
             songsByGenreNode.addArrayChild("song", createSongNode(context, track, context.getUser()));
+            lastRetrievedId = track->getId();
         });
 
+        if (lastRetrievedId.isValid())
+        {
+            scanInfo.offset = offset + count;
+            currentScansInProgress.setObjectId(scanInfo, lastRetrievedId);
+        }
+
         return response;
     }
 
@@ -21,11 +21,12 @@
 
 #include "RequestContext.hpp"
 #include "SubsonicResponse.hpp"
+#include "SubsonicResponseWriter.hpp"
 
 namespace lms::api::subsonic
 {
-    Response handleGetAlbumListRequest(RequestContext& context);
-    Response handleGetAlbumList2Request(RequestContext& context);
+    void handleGetAlbumListRequest(RequestContext& context, ResponseWriter& writer);
+    void handleGetAlbumList2Request(RequestContext& context, ResponseWriter& writer);
     Response handleGetRandomSongsRequest(RequestContext& context);
     Response handleGetSongsByGenreRequest(RequestContext& context);
     Response handleGetNowPlayingRequest(RequestContext& context);
@@ -111,7 +111,7 @@ namespace lms::api::subsonic
             std::filesystem::path filePath;
             audio::AudioProperties audioProperties;
             std::optional<audio::TranscodeParameters> transcodeParameters;
-            bool estimateContentLength{};
+            transcoding::TranscodeRequestOptions transcodeRequestOptions;
         };
 
         StreamParameters getStreamParameters(RequestContext& context)
@@ -135,7 +135,8 @@ namespace lms::api::subsonic
             StreamParameters parameters;
             parameters.audioProperties = audioFileInfo.audioProperties;
             parameters.filePath = audioFileInfo.path;
-            parameters.estimateContentLength = estimateContentLength;
+            parameters.transcodeRequestOptions.userId = context.getUser()->getId();
+            parameters.transcodeRequestOptions.estimateContentLength = estimateContentLength;
 
             if (format == "raw")   // raw => no transcoding
                 return parameters; // TODO: what if offset is not 0?
@@ -226,6 +227,12 @@ namespace lms::api::subsonic
 
             transcodeParameters.outputParameters.stripMetadata = false; // We want clients to use metadata (offline use, replay gain, etc.)
 
+            // Nothing tells a prefetch from a play: the scheduler already ranks the extra encodes of a user behind the first ones of other users
+            parameters.transcodeRequestOptions.priority = transcoding::TranscodePriority::Playhead;
+            // The source file is only known to be playable if it is already in the requested format, then only the bitrate limit is exceeded
+            // It can only be served from its start
+            parameters.transcodeRequestOptions.allowDirectStreamFallback = timeOffset == 0 && requestedFormat->container == audioFileInfo.audioProperties.container && requestedFormat->codec == audioFileInfo.audioProperties.codec;
+
             LMS_LOG(API_SUBSONIC, DEBUG, "Transcoding to format '" << requestedFormat->name << "'" << (bitrate ? (" with bitrate " + std::to_string(*bitrate) + " bps") : ""));
 
             return parameters;
@@ -342,7 +349,7 @@ namespace lms::api::subsonic
         {
             StreamParameters streamParameters{ getStreamParameters(context) };
             if (streamParameters.transcodeParameters)
-                resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(*streamParameters.transcodeParameters, streamParameters.estimateContentLength);
+                resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(*streamParameters.transcodeParameters, streamParameters.transcodeRequestOptions);
             else
                 resourceHandler = core::createFileResourceHandler(streamParameters.filePath, core::media::getMimeType(streamParameters.audioProperties.container, streamParameters.audioProperties.codec).str());
         }
@@ -49,6 +49,25 @@ namespace lms::api::subsonic
                 throw RequestedDataNotFoundError{};
             }
         }
+
+        void writePlaylist(ResponseWriter& writer, RequestContext& context, const db::TrackList::pointer& trackList)
+        {
+            writer.beginChild("playlist");
+            writer.addNodeContent(createPlaylistNode(context, trackList));
+
+            // Entries are written as they are fetched, playlists can be large
+            writer.beginArray("entry");
+            auto entries{ trackList->getEntries() };
+            for (const TrackListEntry::pointer& entry : entries.results)
+            {
+                writer.beginArrayChild();
+                writeSong(writer, context, entry->getTrack(), context.getUser());
+                writer.endChild();
+            }
+            writer.endArray();
+
+            writer.endChild();
+        }
     } // namespace
 
     Response handleGetPlaylistsRequest(RequestContext& context)
@@ -89,7 +108,7 @@ namespace lms::api::subsonic
         return response;
     }
 
-    Response handleGetPlaylistRequest(RequestContext& context)
+    void handleGetPlaylistRequest(RequestContext& context, ResponseWriter& writer)
     {
         // Mandatory params
         TrackListId trackListId{ getMandatoryParameterAs<TrackListId>(context.getParameters(), "id") };
@@ -103,19 +122,10 @@ namespace lms::api::subsonic
         if (trackList->getUserId() != context.getUser()->getId() && trackList->getVisibility() != TrackList::Visibility::Public)
             throw RequestedDataNotFoundError{};
 
-        Response response{ Response::createOkResponse(context.getServerProtocolVersion()) };
-        Response::Node playlistNode{ createPlaylistNode(context, trackList) };
-
-        auto entries{ trackList->getEntries() };
-        for (const TrackListEntry::pointer& entry : entries.results)
-            playlistNode.addArrayChild("entry", createSongNode(context, entry->getTrack(), context.getUser()));
-
-        response.addNode("playlist", std::move(playlistNode));
-
-        return response;
+        writePlaylist(writer, context, trackList);
     }
 
-    Response handleCreatePlaylistRequest(RequestContext& context)
+    void handleCreatePlaylistRequest(RequestContext& context, ResponseWriter& writer)
     {
         // Optional params
         const auto id{ getParameterAs<TrackListId>(context.getParameters(), "playlistId") };
@@ -156,16 +166,7 @@ namespace lms::api::subsonic
             context.getDbSession().create<TrackListEntry>(track, trackList);
         }
 
-        Response response{ Response::createOkResponse(context.getServerProtocolVersion()) };
-        Response::Node playlistNode{ createPlaylistNode(context, trackList) };
-
-        auto entries{ trackList->getEntries() };
-        for (const TrackListEntry::pointer& entry : entries.results)
-            playlistNode.addArrayChild("entry", createSongNode(context, entry->getTrack(), context.getUser()));
-
-        response.addNode("playlist", std::move(playlistNode));
-
-        return response;
+        writePlaylist(writer, context, trackList);
     }
 
     Response handleUpdatePlaylistRequest(RequestContext& context)
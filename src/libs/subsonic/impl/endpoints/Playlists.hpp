@@ -21,12 +21,13 @@
 
 #include "RequestContext.hpp"
 #include "SubsonicResponse.hpp"
+#include "SubsonicResponseWriter.hpp"
 
 namespace lms::api::subsonic
 {
     Response handleGetPlaylistsRequest(RequestContext& context);
-    Response handleGetPlaylistRequest(RequestContext& context);
-    Response handleCreatePlaylistRequest(RequestContext& context);
+    void handleGetPlaylistRequest(RequestContext& context, ResponseWriter& writer);
+    void handleCreatePlaylistRequest(RequestContext& context, ResponseWriter& writer);
     Response handleUpdatePlaylistRequest(RequestContext& context);
     Response handleDeletePlaylistRequest(RequestContext& context);
 } // namespace lms::api::subsonic
\ No newline at end of file
@@ -19,11 +19,8 @@
 
 #include "Searching.hpp"
 
-#include <chrono>
-#include <map>
-#include <mutex>
+#include <exception>
 
-#include "core/Random.hpp"
 #include "core/UUID.hpp"
 #include "database/Session.hpp"
 #include "database/objects/Artist.hpp"
@@ -33,6 +30,7 @@
 #include "database/objects/User.hpp"
 
 #include "ParameterParsing.hpp"
+#include "ScanTracker.hpp"
 #include "SubsonicId.hpp"
 #include "responses/Album.hpp"
 #include "responses/Artist.hpp"
@@ -44,78 +42,31 @@ namespace lms::api::subsonic
 
     namespace
     {
-        // Search endpoints can be used to scan/sync the database
-        // This class is used to keep track of the current scans, in order to retrieve the last objectId
-        // to speed up the query of the following range (avoid the 'offset' cost)
-        template<typename ObjectId>
-        class ScanTracker
+        // Ends the array when leaving the scope (the whole response is discarded on error)
+        class ScopedResponseArray
         {
         public:
-            struct ScanInfo
+            ScopedResponseArray(ResponseWriter& writer, ResponseWriter::Key key)
+                : _writer{ writer }
+                , _uncaughtExceptionCount{ std::uncaught_exceptions() }
             {
-                std::string clientAddress;
-                std::string clientName;
-                UserId user;
-                MediaLibraryId library;
-                std::size_t offset{};
-                auto operator<=>(const ScanInfo&) const = default;
-            };
-
-            ObjectId extractLastRetrievedObjectId(const ScanInfo& info);
-            void setObjectId(const ScanInfo& info, ObjectId lastRetrievedId);
-
-        private:
-            using ClockType = std::chrono::steady_clock;
-
-            struct Entry
-            {
-                ClockType::time_point timePoint;
-                ObjectId objectId;
-            };
-
-            static constexpr std::size_t maxScanCount{ 50 };
-            static constexpr ClockType::duration maxEntryDuration{ std::chrono::seconds{ 30 } };
-
-            std::mutex _mutex;
-            std::map<ScanInfo, Entry> _ongoingScans;
-        };
-
-        template<typename ObjectId>
-        ObjectId ScanTracker<ObjectId>::extractLastRetrievedObjectId(const ScanInfo& scanInfo)
-        {
-            ObjectId res;
-
+                _writer.beginArray(key);
+            }
+            ~ScopedResponseArray()
             {
-                const std::scoped_lock lock{ _mutex };
-
-                auto it{ _ongoingScans.find(scanInfo) };
-                if (it != _ongoingScans.end())
-                {
-                    res = it->second.objectId;
-                    _ongoingScans.erase(it);
-                }
+                if (std::uncaught_exceptions() == _uncaughtExceptionCount)
+                    _writer.endArray();
             }
 
-            return res;
-        }
-
-        template<typename ObjectId>
-        void ScanTracker<ObjectId>::setObjectId(const ScanInfo& scanInfo, ObjectId lastRetrievedId)
-        {
-            const ClockType::time_point now{ ClockType::now() };
-
-            const std::scoped_lock lock{ _mutex };
-
-            // clean outdated scan entries; we do this to not have to flush everything each time we add/remove entries in the database
-            std::erase_if(_ongoingScans, [&](const auto& entry) { return now > entry.second.timePoint + maxEntryDuration; });
-            // prevent the cache size from going out of control
-            if (_ongoingScans.size() == maxScanCount)
-                _ongoingScans.erase(core::random::pickRandom(_ongoingScans));
+        private:
+            ScopedResponseArray(const ScopedResponseArray&) = delete;
+            ScopedResponseArray& operator=(const ScopedResponseArray&) = delete;
 
-            _ongoingScans[scanInfo] = { now, lastRetrievedId };
-        }
+            ResponseWriter& _writer;
+            const int _uncaughtExceptionCount;
+        };
 
-        void findRequestedArtistDirectories(RequestContext& context, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, Response::Node& searchResultNode)
+        void findRequestedArtistDirectories(RequestContext& context, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, ResponseWriter& writer)
         {
             // For now, no need to optimize all this
             // Find all the directories that match the name and that do not contain any track (considered by the legacy API as artists)
@@ -134,17 +85,17 @@ namespace lms::api::subsonic
             params.setWithNoTrack(true);
             params.setMediaLibrary(mediaLibrary);
 
+            const ScopedResponseArray artistArray{ writer, "artist" };
             Directory::find(context.getDbSession(), params, [&](const Directory::pointer& directory) {
-                Response::Node childNode;
-                childNode.setAttribute("id", idToString(directory->getId()));
-                childNode.setAttribute("name", directory->getName());
-                childNode.setAttribute("isDir", true);
-
-                searchResultNode.addArrayChild("artist", std::move(childNode));
+                writer.beginArrayChild();
+                writer.setAttribute("id", idToString(directory->getId()));
+                writer.setAttribute("name", directory->getName());
+                writer.setAttribute("isDir", true);
+                writer.endChild();
             });
         }
 
-        void findRequestedArtists(RequestContext& context, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, Response::Node& searchResultNode)
+        void findRequestedArtists(RequestContext& context, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, ResponseWriter& writer)
         {
             static ScanTracker<ArtistId> currentScansInProgress;
 
@@ -157,16 +108,17 @@ namespace lms::api::subsonic
 
             const std::size_t artistOffset{ getParameterAs<std::size_t>(context.getParameters(), "artistOffset").value_or(0) };
 
+            const ScopedResponseArray artistArray{ writer, "artist" };
             ArtistId lastRetrievedId;
             auto findArtists{ [&] {
                 Artist::FindParameters params;
                 params.filters.setMediaLibrary(mediaLibrary);
                 params.setKeywords(keywords);
                 params.setRange(Range{ artistOffset, artistCount });
-                params.setSortMethod(ArtistSortMethod::Id); // must be consistent with both methods
+                params.setSortMethod(ArtistSortMethod::Relevance); // same as Id without keywords: must be consistent with both methods
 
                 Artist::find(context.getDbSession(), params, [&](const Artist::pointer& artist) {
-                    searchResultNode.addArrayChild("artist", createArtistNode(context, artist));
+                    writer.addArrayChild(createArtistNode(context, artist));
                     lastRetrievedId = artist->getId();
                 });
             } };
@@ -179,7 +131,7 @@ namespace lms::api::subsonic
                     {
                         if (const auto artist{ Artist::find(context.getDbSession(), *mbid) })
                         {
-                            searchResultNode.addArrayChild("artist", createArtistNode(context, artist));
+                            writer.addArrayChild(createArtistNode(context, artist));
                             return;
                         }
                     }
@@ -201,7 +153,7 @@ namespace lms::api::subsonic
             {
                 Artist::find(
                     context.getDbSession(), cachedLastRetrievedId, artistCount, [&](const Artist::pointer& artist) {
-                        searchResultNode.addArrayChild("artist", createArtistNode(context, artist));
+                        writer.addArrayChild(createArtistNode(context, artist));
                     },
                     mediaLibrary);
                 lastRetrievedId = cachedLastRetrievedId;
@@ -218,7 +170,7 @@ namespace lms::api::subsonic
             }
         }
 
-        void findRequestedAlbums(RequestContext& context, bool id3, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, Response::Node& searchResultNode)
+        void findRequestedAlbums(RequestContext& context, bool id3, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, ResponseWriter& writer)
         {
             static ScanTracker<ReleaseId> currentScansInProgress;
 
@@ -231,6 +183,13 @@ namespace lms::api::subsonic
 
             const std::size_t albumOffset{ getParameterAs<std::size_t>(context.getParameters(), "albumOffset").value_or(0) };
 
+            const ScopedResponseArray albumArray{ writer, "album" };
+            auto writeAlbumEntry{ [&](const Release::pointer& release) {
+                writer.beginArrayChild();
+                writeAlbum(writer, context, release, id3);
+                writer.endChild();
+            } };
+
             ReleaseId lastRetrievedId;
 
             auto findReleases{ [&] {
@@ -238,10 +197,10 @@ namespace lms::api::subsonic
                 params.setKeywords(keywords);
                 params.setRange(Range{ albumOffset, albumCount });
                 params.filters.setMediaLibrary(mediaLibrary);
-                params.setSortMethod(ReleaseSortMethod::Id); // must be consistent with both methods
+                params.setSortMethod(ReleaseSortMethod::Relevance); // same as Id without keywords: must be consistent with both methods
 
                 Release::find(context.getDbSession(), params, [&](const Release::pointer& release) {
-                    searchResultNode.addArrayChild("album", createAlbumNode(context, release, id3));
+                    writeAlbumEntry(release);
                     lastRetrievedId = release->getId();
                 });
             } };
@@ -254,7 +213,7 @@ namespace lms::api::subsonic
                     {
                         if (const auto release{ Release::find(context.getDbSession(), *mbid) })
                         {
-                            searchResultNode.addArrayChild("album", createAlbumNode(context, release, id3));
+                            writeAlbumEntry(release);
                             return;
                         }
                     }
@@ -276,7 +235,7 @@ namespace lms::api::subsonic
             {
                 Release::find(
                     context.getDbSession(), cachedLastRetrievedId, albumCount, [&](const Release::pointer& release) {
-                        searchResultNode.addArrayChild("album", createAlbumNode(context, release, id3));
+                        writeAlbumEntry(release);
                     },
                     mediaLibrary);
                 lastRetrievedId = cachedLastRetrievedId;
@@ -293,7 +252,7 @@ namespace lms::api::subsonic
             }
         }
 
-        void findRequestedTracks(RequestContext& context, bool id3, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, Response::Node& searchResultNode)
+        void findRequestedTracks(RequestContext& context, bool id3, const std::vector<std::string_view>& keywords, MediaLibraryId mediaLibrary, ResponseWriter& writer)
         {
             static ScanTracker<TrackId> currentScansInProgress;
 
@@ -306,6 +265,13 @@ namespace lms::api::subsonic
 
             const std::size_t songOffset{ getParameterAs<std::size_t>(context.getParameters(), "songOffset").value_or(0) };
 
+            const ScopedResponseArray songArray{ writer, "song" };
+            auto writeSongEntry{ [&](const Track::pointer& track) {
+                writer.beginArrayChild();
+                writeSong(writer, context, track, id3);
+                writer.endChild();
+            } };
+
             TrackId lastRetrievedId;
 
             auto findTracks{ [&] {
@@ -313,10 +279,10 @@ namespace lms::api::subsonic
                 params.setKeywords(keywords);
                 params.setRange(Range{ songOffset, songCount });
                 params.filters.setMediaLibrary(mediaLibrary);
-                params.setSortMethod(TrackSortMethod::Id); // must be consistent with both methods
+                params.setSortMethod(TrackSortMethod::Relevance); // same as Id without keywords: must be consistent with both methods
 
                 Track::find(context.getDbSession(), params, [&](const Track::pointer& track) {
-                    searchResultNode.addArrayChild("song", createSongNode(context, track, id3));
+                    writeSongEntry(track);
                     lastRetrievedId = track->getId();
                 });
             } };
@@ -339,7 +305,7 @@ namespace lms::api::subsonic
             {
                 Track::find(
                     context.getDbSession(), cachedLastRetrievedId, songCount, [&](const Track::pointer& track) {
-                        searchResultNode.addArrayChild("song", createSongNode(context, track, id3));
+                        writeSongEntry(track);
                     },
                     mediaLibrary);
                 lastRetrievedId = cachedLastRetrievedId;
@@ -356,7 +322,7 @@ namespace lms::api::subsonic
             }
         }
 
-        Response handleSearchRequestCommon(RequestContext& context, bool id3)
+        void handleSearchRequestCommon(RequestContext& context, ResponseWriter& writer, bool id3)
         {
             // Mandatory params
             const std::string queryString{ getMandatoryParameterAs<std::string>(context.getParameters(), "query") };
@@ -373,29 +339,29 @@ namespace lms::api::subsonic
             if (!query.empty())
                 keywords = core::stringUtils::splitString(query, ' ');
 
-            Response response{ Response::createOkResponse(context.getServerProtocolVersion()) };
-            Response::Node& searchResultNode{ response.createNode(id3 ? "searchResult3" : "searchResult2") };
+            // Results are written as they are fetched
+            writer.beginChild(id3 ? ResponseWriter::Key{ "searchResult3" } : ResponseWriter::Key{ "searchResult2" });
 
             auto transaction{ context.getDbSession().createReadTransaction() };
 
             if (id3)
-                findRequestedArtists(context, keywords, mediaLibrary, searchResultNode);
+                findRequestedArtists(context, keywords, mediaLibrary, writer);
             else
-                findRequestedArtistDirectories(context, keywords, mediaLibrary, searchResultNode);
-            findRequestedAlbums(context, id3, keywords, mediaLibrary, searchResultNode);
-            findRequestedTracks(context, id3, keywords, mediaLibrary, searchResultNode);
+                findRequestedArtistDirectories(context, keywords, mediaLibrary, writer);
+            findRequestedAlbums(context, id3, keywords, mediaLibrary, writer);
+            findRequestedTracks(context, id3, keywords, mediaLibrary, writer);
 
-            return response;
+            writer.endChild();
         }
     } // namespace
 
-    Response handleSearch2Request(RequestContext& context)
+    void handleSearch2Request(RequestContext& context, ResponseWriter& writer)
     {
-        return handleSearchRequestCommon(context, false /* no id3 */);
+        handleSearchRequestCommon(context, writer, false /* no id3 */);
     }
 
-    Response handleSearch3Request(RequestContext& context)
+    void handleSearch3Request(RequestContext& context, ResponseWriter& writer)
     {
-        return handleSearchRequestCommon(context, true /* id3 */);
+        handleSearchRequestCommon(context, writer, true /* id3 */);
     }
 } // namespace lms::api::subsonic
\ No newline at end of file
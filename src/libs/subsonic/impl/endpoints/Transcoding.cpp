@@ -166,7 +166,14 @@ namespace lms::api::subsonic
         if (!continuation)
         {
             const audio::TranscodeParameters params{ getTranscodingParameters(context) };
-            resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(params, false /* estimate content length */);
+
+            transcoding::TranscodeRequestOptions options;
+            options.userId = context.getUser()->getId();
+            options.priority = transcoding::TranscodePriority::Playhead; // nothing tells a prefetch from a play
+            options.estimateContentLength = false;
+            options.allowDirectStreamFallback = false; // the client explicitly asked for this transcode
+
+            resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(params, options);
         }
         else
         {
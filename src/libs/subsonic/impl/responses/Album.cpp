@@ -38,6 +38,7 @@
 #include "CoverArtId.hpp"
 #include "RequestContext.hpp"
 #include "SubsonicId.hpp"
+#include "SubsonicResponseWriter.hpp"
 #include "responses/Artist.hpp"
 #include "responses/DiscTitle.hpp"
 #include "responses/ItemDate.hpp"
@@ -50,16 +51,22 @@ namespace lms::api::subsonic
 
     Response::Node createAlbumNode(RequestContext& context, const Release::pointer& release, bool id3, const Directory::pointer& directory)
     {
-        LMS_SCOPED_TRACE_DETAILED("Subsonic", "CreateAlbum");
-
         Response::Node albumNode;
+        writeAlbum(*createResponseNodeWriter(albumNode), context, release, id3, directory);
+
+        return albumNode;
+    }
+
+    void writeAlbum(ResponseWriter& writer, RequestContext& context, const Release::pointer& release, bool id3, const Directory::pointer& directory)
+    {
+        LMS_SCOPED_TRACE_DETAILED("Subsonic", "WriteAlbum");
 
         if (id3)
         {
-            albumNode.setAttribute("id", idToString(release->getId()));
-            albumNode.setAttribute("name", release->getName());
-            albumNode.setAttribute("songCount", release->getTrackCount());
-            albumNode.setAttribute("duration", std::chrono::duration_cast<std::chrono::seconds>(release->getDuration()).count());
+            writer.setAttribute("id", idToString(release->getId()));
+            writer.setAttribute("name", release->getName());
+            writer.setAttribute("songCount", release->getTrackCount());
+            writer.setAttribute("duration", std::chrono::duration_cast<std::chrono::seconds>(release->getDuration()).count());
         }
         else
         {
@@ -77,28 +84,28 @@ namespace lms::api::subsonic
 
             if (directoryToReport)
             {
-                albumNode.setAttribute("title", directoryToReport->getName());
-                albumNode.setAttribute("id", idToString(directoryToReport->getId()));
+                writer.setAttribute("title", directoryToReport->getName());
+                writer.setAttribute("id", idToString(directoryToReport->getId()));
                 if (const Directory::pointer & parentDirectory{ directoryToReport->getParentDirectory() })
-                    albumNode.setAttribute("parent", idToString(parentDirectory->getId()));
+                    writer.setAttribute("parent", idToString(parentDirectory->getId()));
             }
 
-            albumNode.setAttribute("album", release->getName());
-            albumNode.setAttribute("isDir", true);
+            writer.setAttribute("album", release->getName());
+            writer.setAttribute("isDir", true);
         }
 
-        albumNode.setAttribute("created", core::stringUtils::toISO8601String(release->getAddedTime()));
+        writer.setAttribute("created", core::stringUtils::toISO8601String(release->getAddedTime()));
 
         if (const auto artwork{ release->getPreferredArtwork() })
         {
             CoverArtId coverArtId{ artwork->getId(), artwork->getLastWrittenTime().toTime_t() };
-            albumNode.setAttribute("coverArt", idToString(coverArtId));
+            writer.setAttribute("coverArt", idToString(coverArtId));
         }
 
         if (const auto originalYear{ release->getOriginalYear() })
-            albumNode.setAttribute("year", *originalYear);
+            writer.setAttribute("year", *originalYear);
         else if (const auto year{ release->getYear() })
-            albumNode.setAttribute("year", *year);
+            writer.setAttribute("year", *year);
 
         struct Artist
         {
@@ -127,12 +134,12 @@ namespace lms::api::subsonic
 
         if (artist)
         {
-            albumNode.setAttribute("artist", artist->name);
+            writer.setAttribute("artist", artist->name);
             if (!artist->id.empty())
-                albumNode.setAttribute("artistId", artist->id);
+                writer.setAttribute("artistId", artist->id);
         }
 
-        albumNode.setAttribute("playCount", core::Service<scrobbling::IScrobblingService>::get()->getCount(context.getUser()->getId(), release->getId()));
+        writer.setAttribute("playCount", core::Service<scrobbling::IScrobblingService>::get()->getCount(context.getUser()->getId(), release->getId()));
 
         // Report the first GENRE for this track
         const ClusterType::pointer genreClusterType{ ClusterType::find(context.getDbSession(), "GENRE") };
@@ -140,51 +147,78 @@ namespace lms::api::subsonic
         {
             const auto clusters{ release->getClusters(genreClusterType->getId(), 1) };
             if (!clusters.empty())
-                albumNode.setAttribute("genre", clusters.front()->getName());
+                writer.setAttribute("genre", clusters.front()->getName());
         }
 
         if (const Wt::WDateTime dateTime{ core::Service<feedback::IFeedbackService>::get()->getStarredDateTime(context.getUser()->getId(), release->getId()) }; dateTime.isValid())
-            albumNode.setAttribute("starred", core::stringUtils::toISO8601String(dateTime));
+            writer.setAttribute("starred", core::stringUtils::toISO8601String(dateTime));
 
         // Always report user rating, even if legacy API only specified it for directories
         if (const auto rating{ core::Service<feedback::IFeedbackService>::get()->getRating(context.getUser()->getId(), release->getId()) })
-            albumNode.setAttribute("userRating", *rating);
+            writer.setAttribute("userRating", *rating);
 
         if (!context.isOpenSubsonicEnabled())
-            return albumNode;
+            return;
 
         // OpenSubsonic specific fields (must always be set)
-        albumNode.setAttribute("version", release->getComment());
-        albumNode.setAttribute("sortName", release->getSortName());
-        albumNode.setAttribute("mediaType", "album");
+        writer.setAttribute("version", release->getComment());
+        writer.setAttribute("sortName", release->getSortName());
+        writer.setAttribute("mediaType", "album");
 
         {
             const Wt::WDateTime dateTime{ core::Service<scrobbling::IScrobblingService>::get()->getLastListenDateTime(context.getUser()->getId(), release->getId()) };
-            albumNode.setAttribute("played", dateTime.isValid() ? core::stringUtils::toISO8601String(dateTime) : std::string{ "" });
+            writer.setAttribute("played", dateTime.isValid() ? core::stringUtils::toISO8601String(dateTime) : std::string{ "" });
         }
 
         {
             std::optional<core::UUID> mbid{ release->getMBID() };
-            albumNode.setAttribute("musicBrainzId", mbid ? mbid->getAsString() : "");
+            writer.setAttribute("musicBrainzId", mbid ? mbid->getAsString() : "");
         }
 
-        auto addClusters{ [&](Response::Node::Key field, std::string_view clusterTypeName) {
-            albumNode.createEmptyArrayValue(field);
+        if (id3)
+        {
+            writer.setAttribute("displayArtist", release->getArtistDisplayName());
+        }
+        else
+        {
+            writer.setAttribute("displayAlbumArtist", release->getArtistDisplayName());
+            writer.setAttribute("displayArtist", "");
+        }
+
+        writer.setAttribute("isCompilation", release->isCompilation());
+
+        auto advisoryToExplicitStatus = [&](const core::EnumSet<db::Advisory> advisories) -> std::string_view {
+            if (advisories.contains(db::Advisory::Explicit))
+                return "explicit";
+
+            if (advisories.contains(db::Advisory::Clean))
+                return "clean";
+
+            return "";
+        };
+
+        writer.setAttribute("explicitStatus", advisoryToExplicitStatus(release->getAdvisories()));
+
+        // Attributes must all be set at this point
+        auto addClusters{ [&](ResponseWriter::Key field, std::string_view clusterTypeName) {
+            writer.beginValueArray(field);
 
             Cluster::FindParameters params;
             params.setRelease(release->getId());
             params.setClusterTypeName(clusterTypeName);
 
             Cluster::find(context.getDbSession(), params, [&](const Cluster::pointer& cluster) {
-                albumNode.addArrayValue(field, cluster->getName());
+                writer.addArrayValue(cluster->getName());
             });
+
+            writer.endArray();
         } };
 
         addClusters("moods", "MOOD");
         addClusters("groupings", "GROUPING");
 
         // Genres
-        albumNode.createEmptyArrayChild("genres");
+        writer.beginArray("genres");
         if (genreClusterType)
         {
             Cluster::FindParameters params;
@@ -192,64 +226,49 @@ namespace lms::api::subsonic
             params.setClusterType(genreClusterType->getId());
 
             Cluster::find(context.getDbSession(), params, [&](const Cluster::pointer& cluster) {
-                albumNode.addArrayChild("genres", createItemGenreNode(cluster->getName()));
+                writer.addArrayChild(createItemGenreNode(cluster->getName()));
             });
         }
+        writer.endArray();
 
-        if (id3)
+        if (!id3)
         {
-            albumNode.createEmptyArrayChild("artists");
+            writer.beginArray("albumArtists");
             for (const db::ReleaseArtistLink::pointer& artistLink : artistLinks)
-                albumNode.addArrayChild("artists", createMinimalArtistNode(artistLink));
-
-            albumNode.setAttribute("displayArtist", release->getArtistDisplayName());
+                writer.addArrayChild(createMinimalArtistNode(artistLink));
+            writer.endArray();
         }
-        else
+
+        writer.beginArray("artists");
+        if (id3)
         {
-            albumNode.createEmptyArrayChild("albumArtists");
             for (const db::ReleaseArtistLink::pointer& artistLink : artistLinks)
-                albumNode.addArrayChild("albumArtists", createMinimalArtistNode(artistLink));
-
-            albumNode.setAttribute("displayAlbumArtist", release->getArtistDisplayName());
-
-            albumNode.createEmptyArrayChild("artists");
-            albumNode.setAttribute("displayArtist", "");
+                writer.addArrayChild(createMinimalArtistNode(artistLink));
         }
-        albumNode.addChild("originalReleaseDate", createItemDateNode(release->getOriginalDate()));
-        albumNode.addChild("releaseDate", createItemDateNode(release->getDate()));
+        writer.endArray();
 
-        albumNode.setAttribute("isCompilation", release->isCompilation());
+        writer.addChild("originalReleaseDate", createItemDateNode(release->getOriginalDate()));
+        writer.addChild("releaseDate", createItemDateNode(release->getDate()));
 
-        albumNode.createEmptyArrayValue("releaseTypes");
+        writer.beginValueArray("releaseTypes");
         for (std::string_view releaseType : release->getReleaseTypeNames())
-            albumNode.addArrayValue("releaseTypes", releaseType);
+            writer.addArrayValue(releaseType);
+        writer.endArray();
 
-        albumNode.createEmptyArrayChild("discTitles");
+        writer.beginArray("discTitles");
         for (const auto& medium : release->getMediums())
         {
             if (medium->getName().empty())
                 continue;
 
-            albumNode.addArrayChild("discTitles", createDiscTitle(medium));
+            writer.addArrayChild(createDiscTitle(medium));
         }
+        writer.endArray();
 
-        albumNode.createEmptyArrayChild("recordLabels");
+        writer.beginArray("recordLabels");
         release->visitLabels([&](const Label::pointer& label) {
-            albumNode.addArrayChild("recordLabels", createRecordLabel(label));
+            writer.addArrayChild(createRecordLabel(label));
         });
-
-        auto advisoryToExplicitStatus = [&](const core::EnumSet<db::Advisory> advisories) -> std::string_view {
-            if (advisories.contains(db::Advisory::Explicit))
-                return "explicit";
-
-            if (advisories.contains(db::Advisory::Clean))
-                return "clean";
-
-            return "";
-        };
-
-        albumNode.setAttribute("explicitStatus", advisoryToExplicitStatus(release->getAdvisories()));
-
-        return albumNode;
+        writer.endArray();
     }
 } // namespace lms::api::subsonic
\ No newline at end of file
@@ -36,4 +36,6 @@ namespace lms::api::subsonic
     class RequestContext;
 
     Response::Node createAlbumNode(RequestContext& context, const db::ObjectPtr<db::Release>& release, bool id3, const db::ObjectPtr<db::Directory>& directory = {});
+    // Writes the album fields into the current child
+    void writeAlbum(ResponseWriter& writer, RequestContext& context, const db::ObjectPtr<db::Release>& release, bool id3, const db::ObjectPtr<db::Directory>& directory = {});
 } // namespace lms::api::subsonic
\ No newline at end of file
@@ -46,6 +46,7 @@
 #include "CoverArtId.hpp"
 #include "RequestContext.hpp"
 #include "SubsonicId.hpp"
+#include "SubsonicResponseWriter.hpp"
 #include "responses/Artist.hpp"
 #include "responses/Contributor.hpp"
 #include "responses/ItemGenre.hpp"
@@ -73,30 +74,36 @@ namespace lms::api::subsonic
 
     Response::Node createSongNode(RequestContext& context, const db::Track::pointer& track, bool id3)
     {
-        LMS_SCOPED_TRACE_DETAILED("Subsonic", "CreateSong");
+        Response::Node trackResponse;
+        writeSong(*createResponseNodeWriter(trackResponse), context, track, id3);
 
-        const auto medium{ track->getMedium() };
+        return trackResponse;
+    }
 
-        Response::Node trackResponse;
+    void writeSong(ResponseWriter& writer, RequestContext& context, const db::Track::pointer& track, bool id3)
+    {
+        LMS_SCOPED_TRACE_DETAILED("Subsonic", "WriteSong");
+
+        const auto medium{ track->getMedium() };
 
         if (!id3)
         {
             if (const auto directory{ track->getDirectory() })
-                trackResponse.setAttribute("parent", idToString(directory->getId()));
+                writer.setAttribute("parent", idToString(directory->getId()));
         }
 
-        trackResponse.setAttribute("isDir", false);
-        trackResponse.setAttribute("id", idToString(track->getId()));
-        trackResponse.setAttribute("title", track->getName());
+        writer.setAttribute("isDir", false);
+        writer.setAttribute("id", idToString(track->getId()));
+        writer.setAttribute("title", track->getName());
         if (track->getTrackNumber())
-            trackResponse.setAttribute("track", *track->getTrackNumber());
+            writer.setAttribute("track", *track->getTrackNumber());
         if (medium && medium->getPosition())
-            trackResponse.setAttribute("discNumber", *medium->getPosition());
+            writer.setAttribute("discNumber", *medium->getPosition());
         if (const auto originalYear{ track->getOriginalYear() })
-            trackResponse.setAttribute("year", *originalYear);
+            writer.setAttribute("year", *originalYear);
         else if (const auto year{ track->getYear() })
-            trackResponse.setAttribute("year", *year);
-        trackResponse.setAttribute("playCount", core::Service<scrobbling::IScrobblingService>::get()->getCount(context.getUser()->getId(), track->getId()));
+            writer.setAttribute("year", *year);
+        writer.setAttribute("playCount", core::Service<scrobbling::IScrobblingService>::get()->getCount(context.getUser()->getId(), track->getId()));
 
         // maybe not available if user just removed the library without rescanning
         if (const db::MediaLibrary::pointer library{ track->getMediaLibrary() })
@@ -104,22 +111,22 @@ namespace lms::api::subsonic
             std::error_code ec;
             const std::filesystem::path relativeTrackPath{ std::filesystem::relative(track->getAbsoluteFilePath(), library->getPath(), ec) };
             if (!ec && !relativeTrackPath.empty())
-                trackResponse.setAttribute("path", relativeTrackPath.c_str());
+                writer.setAttribute("path", relativeTrackPath.c_str());
         }
 
-        trackResponse.setAttribute("size", track->getFileSize());
+        writer.setAttribute("size", track->getFileSize());
 
         if (track->getAbsoluteFilePath().has_extension())
         {
             auto extension{ track->getAbsoluteFilePath().extension() };
-            trackResponse.setAttribute("suffix", extension.string().substr(1) /* skip leading .*/);
+            writer.setAttribute("suffix", extension.string().substr(1) /* skip leading .*/);
         }
 
         if (context.getUser()->getSubsonicEnableTranscodingByDefault())
         {
             const std::string fileSuffix{ formatToSuffix(context.getUser()->getSubsonicDefaultTranscodingOutputFormat()) };
-            trackResponse.setAttribute("transcodedSuffix", fileSuffix);
-            trackResponse.setAttribute("transcodedContentType", core::getMimeType(std::filesystem::path{ "." + fileSuffix }));
+            writer.setAttribute("transcodedSuffix", fileSuffix);
+            writer.setAttribute("transcodedContentType", core::getMimeType(std::filesystem::path{ "." + fileSuffix }));
         }
 
         auto artwork{ track->getPreferredMediaArtwork() };
@@ -129,38 +136,38 @@ namespace lms::api::subsonic
         if (artwork)
         {
             CoverArtId coverArtId{ artwork->getId(), artwork->getLastWrittenTime().toTime_t() };
-            trackResponse.setAttribute("coverArt", idToString(coverArtId));
+            writer.setAttribute("coverArt", idToString(coverArtId));
         }
 
         const std::vector<db::Artist::pointer>& artists{ track->getArtists({ db::TrackArtistLinkType::Artist }) };
         if (!artists.empty())
         {
             if (!track->getArtistDisplayName().empty())
-                trackResponse.setAttribute("artist", track->getArtistDisplayName());
+                writer.setAttribute("artist", track->getArtistDisplayName());
             else
-                trackResponse.setAttribute("artist", utils::joinArtistNames(artists));
+                writer.setAttribute("artist", utils::joinArtistNames(artists));
 
             if (artists.size() == 1)
-                trackResponse.setAttribute("artistId", idToString(artists.front()->getId()));
+                writer.setAttribute("artistId", idToString(artists.front()->getId()));
         }
 
         const db::Release::pointer release{ track->getRelease() };
         if (release)
         {
-            trackResponse.setAttribute("album", release->getName());
-            trackResponse.setAttribute("albumId", idToString(release->getId()));
+            writer.setAttribute("album", release->getName());
+            writer.setAttribute("albumId", idToString(release->getId()));
         }
 
-        trackResponse.setAttribute("duration", std::chrono::duration_cast<std::chrono::seconds>(track->getDuration()).count());
-        trackResponse.setAttribute("bitRate", (track->getBitrate() / 1000));
-        trackResponse.setAttribute("type", "music");
-        trackResponse.setAttribute("created", core::stringUtils::toISO8601String(track->getAddedTime()));
-        trackResponse.setAttribute("contentType", core::getMimeType(track->getAbsoluteFilePath().extension()));
+        writer.setAttribute("duration", std::chrono::duration_cast<std::chrono::seconds>(track->getDuration()).count());
+        writer.setAttribute("bitRate", (track->getBitrate() / 1000));
+        writer.setAttribute("type", "music");
+        writer.setAttribute("created", core::stringUtils::toISO8601String(track->getAddedTime()));
+        writer.setAttribute("contentType", core::getMimeType(track->getAbsoluteFilePath().extension()));
         if (const auto rating{ core::Service<feedback::IFeedbackService>::get()->getRating(context.getUser()->getId(), track->getId()) })
-            trackResponse.setAttribute("userRating", *rating);
+            writer.setAttribute("userRating", *rating);
 
         if (const Wt::WDateTime dateTime{ core::Service<feedback::IFeedbackService>::get()->getStarredDateTime(context.getUser()->getId(), track->getId()) }; dateTime.isValid())
-            trackResponse.setAttribute("starred", core::stringUtils::toISO8601String(dateTime));
+            writer.setAttribute("starred", core::stringUtils::toISO8601String(dateTime));
 
         // Report the first GENRE for this track
         std::vector<db::Cluster::pointer> genres;
@@ -171,95 +178,102 @@ namespace lms::api::subsonic
 
             genres = db::Cluster::find(context.getDbSession(), params).results;
             if (!genres.empty())
-                trackResponse.setAttribute("genre", genres.front()->getName());
+                writer.setAttribute("genre", genres.front()->getName());
         }
 
         // OpenSubsonic specific fields (must always be set)
         if (!context.isOpenSubsonicEnabled())
-            return trackResponse;
+            return;
 
-        trackResponse.setAttribute("comment", track->getComment());
-        trackResponse.setAttribute("bitDepth", track->getBitsPerSample() ? *track->getBitsPerSample() : 0);
-        trackResponse.setAttribute("samplingRate", track->getSampleRate());
-        trackResponse.setAttribute("channelCount", track->getChannelCount());
+        writer.setAttribute("comment", track->getComment());
+        writer.setAttribute("bitDepth", track->getBitsPerSample() ? *track->getBitsPerSample() : 0);
+        writer.setAttribute("samplingRate", track->getSampleRate());
+        writer.setAttribute("channelCount", track->getChannelCount());
 
-        trackResponse.setAttribute("mediaType", "song");
+        writer.setAttribute("mediaType", "song");
 
         {
             const Wt::WDateTime dateTime{ core::Service<scrobbling::IScrobblingService>::get()->getLastListenDateTime(context.getUser()->getId(), track->getId()) };
-            trackResponse.setAttribute("played", dateTime.isValid() ? core::stringUtils::toISO8601String(dateTime) : "");
+            writer.setAttribute("played", dateTime.isValid() ? core::stringUtils::toISO8601String(dateTime) : "");
         }
 
         {
             std::optional<core::UUID> mbid{ track->getRecordingMBID() };
-            trackResponse.setAttribute("musicBrainzId", mbid ? mbid->getAsString() : "");
+            writer.setAttribute("musicBrainzId", mbid ? mbid->getAsString() : "");
         }
 
+        writer.setAttribute("displayArtist", track->getArtistDisplayName());
+        if (release)
+            writer.setAttribute("displayAlbumArtist", release->getArtistDisplayName());
+
+        auto advisoryToExplicitStatus = [](db::Advisory advisory) -> std::string_view {
+            switch (advisory)
+            {
+            case db::Advisory::Clean:
+                return "clean";
+            case db::Advisory::Explicit:
+                return "explicit";
+            case db::Advisory::Unknown:
+            case db::Advisory::UnSet:
+                break;
+            }
+
+            return "";
+        };
+        writer.setAttribute("explicitStatus", advisoryToExplicitStatus(track->getAdvisory()));
+
+        // Attributes must all be set at this point
         {
-            trackResponse.createEmptyArrayChild("albumArtists");
-            trackResponse.createEmptyArrayChild("artists");
-            trackResponse.createEmptyArrayChild("contributors");
-
-            track->visitArtistLinks([&](const db::TrackArtistLink::pointer& artistLink) {
-                switch (artistLink->getType())
-                {
-                case db::TrackArtistLinkType::Artist:
-                    trackResponse.addArrayChild("artists", createMinimalArtistNode(artistLink));
-                    break;
-                default:
-                    trackResponse.addArrayChild("contributors", createContributorNode(artistLink));
-                }
-            });
+            const std::vector<db::TrackArtistLink::pointer> artistLinks{ track->getArtistLinks() };
 
+            writer.beginArray("albumArtists");
             if (release)
             {
                 release->visitArtistLinks([&](const db::ReleaseArtistLink::pointer& artistLink) {
-                    trackResponse.addArrayChild("albumArtists", createMinimalArtistNode(artistLink));
+                    writer.addArrayChild(createMinimalArtistNode(artistLink));
                 });
             }
-        }
+            writer.endArray();
 
-        trackResponse.setAttribute("displayArtist", track->getArtistDisplayName());
-        if (release)
-            trackResponse.setAttribute("displayAlbumArtist", release->getArtistDisplayName());
+            writer.beginArray("artists");
+            for (const db::TrackArtistLink::pointer& artistLink : artistLinks)
+            {
+                if (artistLink->getType() == db::TrackArtistLinkType::Artist)
+                    writer.addArrayChild(createMinimalArtistNode(artistLink));
+            }
+            writer.endArray();
+
+            writer.beginArray("contributors");
+            for (const db::TrackArtistLink::pointer& artistLink : artistLinks)
+            {
+                if (artistLink->getType() != db::TrackArtistLinkType::Artist)
+                    writer.addArrayChild(createContributorNode(artistLink));
+            }
+            writer.endArray();
+        }
 
-        auto addClusters{ [&](Response::Node::Key field, std::string_view clusterTypeName) {
-            trackResponse.createEmptyArrayValue(field);
+        auto addClusters{ [&](ResponseWriter::Key field, std::string_view clusterTypeName) {
+            writer.beginValueArray(field);
 
             db::Cluster::FindParameters params;
             params.setTrack(track->getId());
             params.setClusterTypeName(clusterTypeName);
 
             for (const auto& cluster : db::Cluster::find(context.getDbSession(), params).results)
-                trackResponse.addArrayValue(field, cluster->getName());
+                writer.addArrayValue(cluster->getName());
+
+            writer.endArray();
         } };
 
         addClusters("moods", "MOOD");
         addClusters("groupings", "GROUPING");
 
         // Genres
-        trackResponse.createEmptyArrayChild("genres");
+        writer.beginArray("genres");
         for (const auto& genre : genres)
-            trackResponse.addArrayChild("genres", createItemGenreNode(genre->getName()));
+            writer.addArrayChild(createItemGenreNode(genre->getName()));
+        writer.endArray();
 
-        auto advisoryToExplicitStatus = [](db::Advisory advisory) -> std::string_view {
-            switch (advisory)
-            {
-            case db::Advisory::Clean:
-                return "clean";
-            case db::Advisory::Explicit:
-                return "explicit";
-            case db::Advisory::Unknown:
-            case db::Advisory::UnSet:
-                break;
-            }
-
-            return "";
-        };
-        trackResponse.setAttribute("explicitStatus", advisoryToExplicitStatus(track->getAdvisory()));
-
-        trackResponse.addChild("replayGain", createReplayGainNode(track, medium));
-
-        return trackResponse;
+        writer.addChild("replayGain", createReplayGainNode(track, medium));
     }
 } // namespace lms::api::subsonic
\ No newline at end of file
@@ -35,4 +35,6 @@ namespace lms::api::subsonic
     class RequestContext;
 
     Response::Node createSongNode(RequestContext& context, const db::ObjectPtr<db::Track>& track, bool id3);
+    // Writes the song fields into the current child
+    void writeSong(ResponseWriter& writer, RequestContext& context, const db::ObjectPtr<db::Track>& track, bool id3);
 } // namespace lms::api::subsonic
\ No newline at end of file
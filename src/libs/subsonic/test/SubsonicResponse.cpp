@@ -27,6 +27,7 @@
 
 #include "ProtocolVersion.hpp"
 #include "SubsonicResponse.hpp"
+#include "SubsonicResponseWriter.hpp"
 
 namespace lms::api::subsonic::tests
 {
@@ -58,6 +59,55 @@ namespace lms::api::subsonic::tests
 
             return response;
         }
+
+        // Same content as generateFakeResponse's node, written in the serialization order
+        void writeFakeNodeContent(ResponseWriter& writer)
+        {
+            writer.setAttribute("Attr1", "value1");
+            writer.setAttribute("Attr2", "value2");
+            writer.setAttribute("attr3", "<value3=\"foo\">");
+            writer.setAttribute("attr4", true);
+            writer.setAttribute("attr5", false);
+            writer.setAttribute("attr6", 3.14159265359);
+            writer.setAttribute("attr7", 333666);
+
+            writer.beginArray("MyArrayChild");
+            for (std::size_t i{}; i < 2; ++i)
+            {
+                writer.beginArrayChild();
+                writer.setAttribute("Attr42", i);
+                writer.endChild();
+            }
+            writer.endArray();
+
+            writer.beginValueArray("MyArray1");
+            for (std::size_t i{}; i < 2; ++i)
+            {
+                writer.addArrayValue("value1");
+                writer.addArrayValue("value2");
+            }
+            writer.endArray();
+
+            writer.beginValueArray("MyArray2");
+            writer.addArrayValue(0LL);
+            writer.endArray();
+        }
+
+        void writeFakeResponse(ResponseWriter& writer)
+        {
+            writer.beginOkResponse(defaultServerProtocolVersion);
+            writer.beginChild("MyNode");
+            writeFakeNodeContent(writer);
+            writer.endChild();
+            writer.endResponse();
+        }
+
+        std::string serialize(const Response& response, ResponseFormat format)
+        {
+            std::ostringstream oss;
+            response.write(oss, format);
+            return oss.str();
+        }
     } // namespace
 
     TEST(SubsonicResponse, emptyJson)
@@ -67,7 +117,7 @@ namespace lms::api::subsonic::tests
         std::ostringstream oss;
         response.write(oss, ResponseFormat::json);
 
-        std::string expected{ R"({"subsonic-response":{"openSubsonic":true,"serverVersion":"${VERSION}","status":"ok","type":"lms","version":"1.16.1"}})" };
+        std::string expected{ R"({"subsonic-response":{"status":"ok","version":"1.16.1","type":"lms","serverVersion":"${VERSION}","openSubsonic":true}})" };
         expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
 
         EXPECT_EQ(oss.str(), expected);
@@ -80,7 +130,7 @@ namespace lms::api::subsonic::tests
         std::ostringstream oss;
         response.write(oss, ResponseFormat::json);
 
-        std::string expected{ R"({"subsonic-response":{"openSubsonic":true,"serverVersion":"${VERSION}","status":"ok","type":"lms","version":"1.16.1","MyNode":{"Attr1":"value1","Attr2":"value2","attr3":"<value3=\"foo\">","attr4":true,"attr5":false,"attr6":3.14159,"attr7":333666,"MyArrayChild":[{"Attr42":0},{"Attr42":1}],"MyArray1":["value1","value2","value1","value2"],"MyArray2":[0]}}})" };
+        std::string expected{ R"({"subsonic-response":{"status":"ok","version":"1.16.1","type":"lms","serverVersion":"${VERSION}","openSubsonic":true,"MyNode":{"Attr1":"value1","Attr2":"value2","attr3":"<value3=\"foo\">","attr4":true,"attr5":false,"attr6":3.14159,"attr7":333666,"MyArrayChild":[{"Attr42":0},{"Attr42":1}],"MyArray1":["value1","value2","value1","value2"],"MyArray2":[0]}}})" };
         expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
 
         EXPECT_EQ(oss.str(), expected);
@@ -94,7 +144,7 @@ namespace lms::api::subsonic::tests
         response.write(oss, ResponseFormat::xml);
 
         std::string expected{ R"(<?xml version="1.0" encoding="utf-8"?>
-<subsonic-response openSubsonic="true" serverVersion="${VERSION}" status="ok" type="lms" version="1.16.1" xmlns="http://subsonic.org/restapi"/>)" };
+<subsonic-response status="ok" version="1.16.1" type="lms" serverVersion="${VERSION}" openSubsonic="true" xmlns="http://subsonic.org/restapi"/>)" };
         expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
 
         EXPECT_EQ(oss.str(), expected);
@@ -108,7 +158,7 @@ namespace lms::api::subsonic::tests
         response.write(oss, ResponseFormat::xml);
 
         std::string expected{ R"(<?xml version="1.0" encoding="utf-8"?>
-<subsonic-response openSubsonic="true" serverVersion="${VERSION}" status="ok" type="lms" version="1.16.1" xmlns="http://subsonic.org/restapi"><MyNode Attr1="value1" Attr2="value2" attr3="&lt;value3=&quot;foo&quot;&gt;" attr4="true" attr5="false" attr6="3.14159" attr7="333666"><MyArrayChild Attr42="0"/><MyArrayChild Attr42="1"/><MyArray1>value1</MyArray1><MyArray1>value2</MyArray1><MyArray1>value1</MyArray1><MyArray1>value2</MyArray1><MyArray2>0</MyArray2></MyNode></subsonic-response>)" };
+<subsonic-response status="ok" version="1.16.1" type="lms" serverVersion="${VERSION}" openSubsonic="true" xmlns="http://subsonic.org/restapi"><MyNode Attr1="value1" Attr2="value2" attr3="&lt;value3=&quot;foo&quot;&gt;" attr4="true" attr5="false" attr6="3.14159" attr7="333666"><MyArrayChild Attr42="0"/><MyArrayChild Attr42="1"/><MyArray1>value1</MyArray1><MyArray1>value2</MyArray1><MyArray1>value1</MyArray1><MyArray1>value2</MyArray1><MyArray2>0</MyArray2></MyNode></subsonic-response>)" };
         expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
 
         EXPECT_EQ(oss.str(), expected);
@@ -127,10 +177,93 @@ namespace lms::api::subsonic::tests
         std::ostringstream oss;
         response.write(oss, ResponseFormat::json);
 
-        std::string expected{ R"({"subsonic-response":{"openSubsonic":true,"serverVersion":"${VERSION}","status":"ok","type":"lms","version":"1.16.1","MyMath":{"finite":1.25,"nan":null,"negInf":null,"posInf":null}}})" };
+        std::string expected{ R"({"subsonic-response":{"status":"ok","version":"1.16.1","type":"lms","serverVersion":"${VERSION}","openSubsonic":true,"MyMath":{"finite":1.25,"nan":null,"negInf":null,"posInf":null}}})" };
         expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
 
         EXPECT_EQ(oss.str(), expected);
     }
 
+    TEST(SubsonicResponse, insertionOrder)
+    {
+        Response response{ Response::createOkResponse(defaultServerProtocolVersion) };
+
+        Response::Node& node{ response.createNode("MyNode") };
+        node.setAttribute("b", 1);
+        node.setAttribute("a", 2);
+        node.setAttribute("c", 3);
+        node.setAttribute("a", 4); // overwrite keeps the original position
+        node.createChild("z").setAttribute("value", 5);
+        node.createChild("y").setAttribute("value", 6);
+        node.createChild("z").setAttribute("other", 7); // returns the existing child
+        node.addArrayValue("w", 8);
+        node.addArrayValue("v", 9);
+        node.addArrayValue("w", 10);
+
+        std::ostringstream oss;
+        response.write(oss, ResponseFormat::json);
+
+        std::string expected{ R"({"subsonic-response":{"status":"ok","version":"1.16.1","type":"lms","serverVersion":"${VERSION}","openSubsonic":true,"MyNode":{"b":1,"a":4,"c":3,"z":{"value":5,"other":7},"y":{"value":6},"w":[8,10],"v":[9]}}})" };
+        expected = core::stringUtils::replaceInString(expected, "${VERSION}", core::getVersion());
+
+        EXPECT_EQ(oss.str(), expected);
+    }
+
+    TEST(SubsonicResponseWriter, empty)
+    {
+        for (const ResponseFormat format : { ResponseFormat::json, ResponseFormat::xml })
+        {
+            std::string output;
+            auto writer{ createResponseWriter(output, format) };
+            writer->beginOkResponse(defaultServerProtocolVersion);
+            writer->endResponse();
+
+            EXPECT_EQ(output, serialize(Response::createOkResponse(defaultServerProtocolVersion), format));
+        }
+    }
+
+    TEST(SubsonicResponseWriter, sameOutputAsNode)
+    {
+        const Response response{ generateFakeResponse() };
+
+        for (const ResponseFormat format : { ResponseFormat::json, ResponseFormat::xml })
+        {
+            std::string output;
+            auto writer{ createResponseWriter(output, format) };
+            writeFakeResponse(*writer);
+
+            EXPECT_EQ(output, serialize(response, format));
+        }
+    }
+
+    TEST(SubsonicResponseWriter, addNode)
+    {
+        Response response{ Response::createOkResponse(defaultServerProtocolVersion) };
+        Response::Node& node{ response.createNode("MyNode") };
+        node.setAttribute("Attr1", "value1");
+        node.createChild("MyChild").setValue("text & value");
+        node.createEmptyArrayChild("MyEmptyArray");
+        node.addArrayValue("MyValues", 42);
+
+        std::string output;
+        auto writer{ createResponseWriter(output, ResponseFormat::xml) };
+        writer->beginOkResponse(defaultServerProtocolVersion);
+        writer->addChild("MyNode", node);
+        writer->endResponse();
+
+        EXPECT_EQ(output, serialize(response, ResponseFormat::xml));
+    }
+
+    TEST(SubsonicResponseWriter, nodeWriter)
+    {
+        Response response{ Response::createOkResponse(defaultServerProtocolVersion) };
+        {
+            Response::Node& node{ response.createNode("MyNode") };
+            auto writer{ createResponseNodeWriter(node) };
+            writeFakeNodeContent(*writer);
+        }
+
+        for (const ResponseFormat format : { ResponseFormat::json, ResponseFormat::xml })
+            EXPECT_EQ(serialize(response, format), serialize(generateFakeResponse(), format));
+    }
+
 } // namespace lms::api::subsonic::tests
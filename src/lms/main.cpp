@@ -387,7 +387,7 @@ namespace lms
             if (const auto level{ getTracingLevel() })
                 traceLogger.assign(core::tracing::createTraceLogger(level.value(), config->getULong("tracing-buffer-size", core::tracing::MinBufferSizeInMBytes)));
 
-            // use system locale. libarchive relies on this to write filenames
+            // use system locale
             if (char* locale{ ::setlocale(LC_ALL, "") })
                 LMS_LOG(MAIN, INFO, "locale set to '" << locale << "'");
             else
@@ -428,7 +428,11 @@ namespace lms
 
             core::Service<db::IQueryProfiler> QueryProfiler;
             if (config->getBool("db-profile-queries", false))
-                QueryProfiler.assign(db::createQueryProfiler());
+            {
+                db::QueryProfilerParameters params;
+                params.slowQueryThreshold = std::chrono::milliseconds{ config->getULong("db-profile-slow-query-threshold", 100) };
+                QueryProfiler.assign(db::createQueryProfiler(params));
+            }
 
             // Connection pool size must be twice the number of threads: we have at least 2 io pools with getThreadCount() each and they all may access the database
             auto database{ db::createDb(config->getPath("working-dir", "/var/lms") / "lms.db", getThreadCount() * 2) };
@@ -480,10 +484,10 @@ namespace lms
             }
 
             image::init(argv[0]);
-            core::Service<artwork::IArtworkService> artworkService{ artwork::createArtworkService(*database, server.appRoot() + "/images/unknown-cover.svg", server.appRoot() + "/images/unknown-artist.svg") };
-            core::Service<recommendation::IRecommendationService> recommendationService{ recommendation::createRecommendationService(*database) };
+            core::Service<artwork::IArtworkService> artworkService{ artwork::createArtworkService(*database, cachePath / "artwork", server.appRoot() + "/images/unknown-cover.svg", server.appRoot() + "/images/unknown-artist.svg") };
+            core::Service<recommendation::IRecommendationService> recommendationService{ recommendation::createRecommendationService(*database, cachePath / "recommendation") };
             core::Service<scanner::IScannerService> scannerService{ scanner::createScannerService(*database, cachePath) };
-            core::Service<transcoding::ITranscodeService> transcodingService{ transcoding::createTranscodeService() };
+            core::Service<transcoding::ITranscodeService> transcodingService{ transcoding::createTranscodeService(ioContext, cachePath / "transcode") };
             core::Service<podcast::IPodcastService> podcastService{ podcast::createPodcastService(ioContext, *database, cachePath / "podcasts") };
 
             const auto jukeboxAudioBackend{ getJukeboxAudioOutputBackend() };
@@ -491,9 +495,10 @@ namespace lms
 
             scannerService->getEvents().scanComplete.connect([&](const scanner::ScanStats& stats) {
                 if (stats.getChangesCount() > 0)
-                    artworkService->flushCache();
+                    artworkService->refreshCache();
 
-                if (stats.featureExtractions > 0)
+                // removed tracks must be dropped as well, updates are incremental
+                if (stats.getChangesCount() > 0 || stats.featureExtractions > 0)
                     recommendationService->requestReload();
             });
 
@@ -296,6 +296,7 @@ namespace lms::ui
     void LmsApplication::handleException(LmsApplicationException& e)
     {
         root()->clear();
+        _mainRouter = nullptr;
         Wt::WTemplate* t{ root()->addNew<Wt::WTemplate>(Wt::WString::tr("Lms.Error.template")) };
         t->addFunction("tr", &Wt::WTemplate::Functions::tr);
 
@@ -443,6 +444,7 @@ namespace lms::ui
         }
 
         PathRouter* mainRouter{ main->bindNew<PathRouter>("contents") };
+        _mainRouter = mainRouter;
 
         _playQueue = mainRouter->add<PlayQueue>("/playqueue", Wt::WString::tr("Lms.PlayQueue.playqueue"));
 
@@ -530,6 +532,16 @@ namespace lms::ui
 
     void LmsApplication::notify(const Wt::WEvent& event)
     {
+        // tag with the route rather than with the internal path, that contains ids: the number of distinct origins stays bounded
+        std::string queryOrigin;
+        std::optional<db::ScopedQueryOrigin> scopedQueryOrigin;
+        if (core::Service<db::IQueryProfiler>::get())
+        {
+            const std::string_view routePath{ _mainRouter ? _mainRouter->getCurrentRoutePath() : std::string_view{} };
+            queryOrigin = "ui:" + (routePath.empty() ? std::string{ "<unknown>" } : std::string{ routePath });
+            scopedQueryOrigin.emplace(queryOrigin);
+        }
+
         try
         {
             LMS_SCOPED_TRACE_OVERVIEW("UI", "ProcessEvent");
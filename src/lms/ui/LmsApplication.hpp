@@ -49,6 +49,7 @@ namespace lms::ui
     class LmsApplicationManager;
     class NotificationContainer;
     class ModalManager;
+    class PathRouter;
 
     class LmsApplication : public Wt::WApplication
     {
@@ -124,6 +125,7 @@ namespace lms::ui
         std::shared_ptr<ArtworkResource> _artworkResource;
         MediaPlayer* _mediaPlayer{};
         PlayQueue* _playQueue{};
+        PathRouter* _mainRouter{};
         NotificationContainer* _notificationContainer{};
         ModalManager* _modalManager{};
     };
@@ -229,6 +229,10 @@ namespace lms::ui
                                      .arg(stepStats.progress()));
             break;
 
+        case ScanStep::RebuildListenStats:
+            _stepStatus->setText(Wt::WString::tr("Lms.Admin.ScannerController.step-rebuild-listen-stats"));
+            break;
+
         case ScanStep::ReconciliateArtists:
             _stepStatus->setText(Wt::WString::tr("Lms.Admin.ScannerController.step-reconciliate-artists")
                                      .arg(stepStats.processedElems));
@@ -244,6 +248,11 @@ namespace lms::ui
                                      .arg(stepStats.progress()));
             break;
 
+        case ScanStep::RenderArtworkThumbnails:
+            _stepStatus->setText(Wt::WString::tr("Lms.Admin.ScannerController.step-rendering-artwork-thumbnails")
+                                     .arg(stepStats.progress()));
+            break;
+
         case ScanStep::ScanFiles:
             _stepStatus->setText(Wt::WString::tr("Lms.Admin.ScannerController.step-scanning-files")
                                      .arg(stepStats.processedElems));
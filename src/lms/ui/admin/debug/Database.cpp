@@ -19,6 +19,9 @@
 
 #include "Database.hpp"
 
+#include <chrono>
+#include <utility>
+
 #include <Wt/Http/Response.h>
 #include <Wt/Utils.h>
 #include <Wt/WDateTime.h>
@@ -37,8 +40,15 @@ namespace lms::ui
         class QueryProfilingReportResource : public Wt::WResource
         {
         public:
-            QueryProfilingReportResource(const db::IQueryProfiler& recorder)
+            enum class Format
+            {
+                Text,
+                Json,
+            };
+
+            QueryProfilingReportResource(const db::IQueryProfiler& recorder, Format format)
                 : _recorder{ recorder }
+                , _format{ format }
             {
             }
 
@@ -52,27 +62,109 @@ namespace lms::ui
         private:
             void handleRequest(const Wt::Http::Request&, Wt::Http::Response& response)
             {
-                response.setMimeType("application/text");
+                response.setMimeType(_format == Format::Json ? "application/json" : "application/text");
 
                 auto encodeHttpHeaderField = [](const std::string& fieldName, const std::string& fieldValue) {
                     // This implements RFC 5987
                     return fieldName + "*=UTF-8''" + Wt::Utils::urlEncode(fieldValue);
                 };
 
-                const std::string cdp{ encodeHttpHeaderField("filename", "LMS_db_query_profiling_" + core::stringUtils::toISO8601String(Wt::WDateTime::currentDateTime()) + ".txt") };
+                const std::string cdp{ encodeHttpHeaderField("filename", "LMS_db_query_profiling_" + core::stringUtils::toISO8601String(Wt::WDateTime::currentDateTime()) + (_format == Format::Json ? ".json" : ".txt")) };
                 response.addHeader("Content-Disposition", "attachment; " + cdp);
 
+                switch (_format)
+                {
+                case Format::Text:
+                    writeTextReport(response.out());
+                    break;
+                case Format::Json:
+                    writeJsonReport(response.out());
+                    break;
+                }
+            }
+
+            void writeTextReport(std::ostream& os) const
+            {
+                os << "Slow queries (most recent first):\n";
+                _recorder.visitSlowQueries([&](const db::IQueryProfiler::SlowQuery& slowQuery) {
+                    os << core::stringUtils::toISO8601String(Wt::WDateTime{ slowQuery.timestamp })
+                       << " | " << slowQuery.duration.count() << " µs"
+                       << " | Rows: " << slowQuery.rowCount
+                       << " | Origin: " << slowQuery.origin << '\n';
+                    os << slowQuery.query << '\n';
+                });
+                os << "=========================\n";
+
+                _recorder.visitQueries([&](const db::IQueryProfiler::QueryStats& stats) {
+                    os << stats.query << '\n';
+                    os << "Calls: " << stats.callCount
+                       << " | Rows: " << stats.rowCount
+                       << " | Total: " << stats.totalTime.count() << " µs"
+                       << " | Mean: " << stats.meanTime.count() << " µs"
+                       << " | StdDev: " << stats.stdDevTime.count() << " µs\n";
+                    os << "P50: " << stats.p50Time.count() << " µs"
+                       << " | P90: " << stats.p90Time.count() << " µs"
+                       << " | P99: " << stats.p99Time.count() << " µs"
+                       << " | Max: " << stats.maxTime.count() << " µs\n";
+                    os << "Origins:";
+                    for (const db::IQueryProfiler::QueryOriginStats& origin : stats.origins)
+                        os << " " << origin.origin << " (" << origin.callCount << ")";
+                    os << '\n';
+                    os << stats.plan << "\n-------------------------\n";
+                });
+            }
+
+            void writeJsonReport(std::ostream& os) const
+            {
+                os << "{\"slowQueries\":[";
+                bool first{ true };
+                _recorder.visitSlowQueries([&](const db::IQueryProfiler::SlowQuery& slowQuery) {
+                    if (!std::exchange(first, false))
+                        os << ',';
+                    os << "{\"timestamp\":\"" << core::stringUtils::toISO8601String(Wt::WDateTime{ slowQuery.timestamp }) << "\"";
+                    os << ",\"query\":\"";
+                    core::stringUtils::writeJsonEscapedString(os, slowQuery.query);
+                    os << "\",\"origin\":\"";
+                    core::stringUtils::writeJsonEscapedString(os, slowQuery.origin);
+                    os << "\",\"durationUs\":" << slowQuery.duration.count();
+                    os << ",\"rowCount\":" << slowQuery.rowCount << '}';
+                });
+
+                os << "],\"queries\":[";
+                first = true;
                 _recorder.visitQueries([&](const db::IQueryProfiler::QueryStats& stats) {
-                    response.out() << stats.query << '\n';
-                    response.out() << "Calls: " << stats.callCount
-                                   << " | Total: " << stats.totalTime.count() << " µs"
-                                   << " | Mean: " << stats.meanTime.count() << " µs"
-                                   << " | StdDev: " << stats.stdDevTime.count() << " µs\n";
-                    response.out() << stats.plan << "\n-------------------------\n";
+                    if (!std::exchange(first, false))
+                        os << ',';
+                    os << "{\"query\":\"";
+                    core::stringUtils::writeJsonEscapedString(os, stats.query);
+                    os << "\",\"plan\":\"";
+                    core::stringUtils::writeJsonEscapedString(os, stats.plan);
+                    os << "\",\"callCount\":" << stats.callCount;
+                    os << ",\"rowCount\":" << stats.rowCount;
+                    os << ",\"totalUs\":" << stats.totalTime.count();
+                    os << ",\"meanUs\":" << stats.meanTime.count();
+                    os << ",\"stdDevUs\":" << stats.stdDevTime.count();
+                    os << ",\"p50Us\":" << stats.p50Time.count();
+                    os << ",\"p90Us\":" << stats.p90Time.count();
+                    os << ",\"p99Us\":" << stats.p99Time.count();
+                    os << ",\"maxUs\":" << stats.maxTime.count();
+                    os << ",\"origins\":[";
+                    bool firstOrigin{ true };
+                    for (const db::IQueryProfiler::QueryOriginStats& origin : stats.origins)
+                    {
+                        if (!std::exchange(firstOrigin, false))
+                            os << ',';
+                        os << "{\"origin\":\"";
+                        core::stringUtils::writeJsonEscapedString(os, origin.origin);
+                        os << "\",\"callCount\":" << origin.callCount << '}';
+                    }
+                    os << "]}";
                 });
+                os << "]}";
             }
 
             const db::IQueryProfiler& _recorder;
+            const Format _format;
         };
     } // namespace
 
@@ -82,15 +174,23 @@ namespace lms::ui
         addFunction("tr", &Wt::WTemplate::Functions::tr);
 
         Wt::WPushButton* dumpBtn{ bindNew<Wt::WPushButton>("export-query-profiling-btn", Wt::WString::tr("Lms.Admin.DebugTools.Db.export-query-profiling")) };
+        Wt::WPushButton* dumpJsonBtn{ bindNew<Wt::WPushButton>("export-query-profiling-json-btn", Wt::WString::tr("Lms.Admin.DebugTools.Db.export-query-profiling-json")) };
 
         if (const auto* recorder{ core::Service<db::IQueryProfiler>::get() })
         {
-            Wt::WLink link{ std::make_shared<QueryProfilingReportResource>(*recorder) };
+            Wt::WLink link{ std::make_shared<QueryProfilingReportResource>(*recorder, QueryProfilingReportResource::Format::Text) };
             link.setTarget(Wt::LinkTarget::NewWindow);
             dumpBtn->setLink(link);
+
+            Wt::WLink jsonLink{ std::make_shared<QueryProfilingReportResource>(*recorder, QueryProfilingReportResource::Format::Json) };
+            jsonLink.setTarget(Wt::LinkTarget::NewWindow);
+            dumpJsonBtn->setLink(jsonLink);
         }
         else
+        {
             dumpBtn->setEnabled(false);
+            dumpJsonBtn->setEnabled(false);
+        }
     }
 
 } // namespace lms::ui
@@ -44,18 +44,26 @@ namespace lms::ui
         handlePathChange();
     }
 
+    std::string_view PathRouter::getCurrentRoutePath() const
+    {
+        return _currentRouteIndex ? std::string_view{ _routes[*_currentRouteIndex].path } : std::string_view{};
+    }
+
     void PathRouter::handlePathChange()
     {
-        for (const auto& route : _routes)
+        for (std::size_t i{}; i < _routes.size(); ++i)
         {
+            const Route& route{ _routes[i] };
             if (LmsApp->internalPathMatches(route.path))
             {
+                _currentRouteIndex = i;
                 _stack->setCurrentWidget(route.widget);
                 if (route.title)
                     LmsApp->setTitle(*route.title);
                 return;
             }
         }
+        _currentRouteIndex.reset();
         _noMatchSignal.emit();
     }
 } // namespace lms::ui
@@ -46,6 +46,9 @@ namespace lms::ui
 
         void addRoute(std::string_view path, std::optional<Wt::WString> title, Wt::WWidget* widget);
 
+        // Path of the route that matches the current internal path, empty if none
+        std::string_view getCurrentRoutePath() const;
+
         // Emitted when no registered route matches the current internal path.
         Wt::Signal<>& noMatch() { return _noMatchSignal; }
 
@@ -65,5 +68,6 @@ namespace lms::ui
             std::optional<Wt::WString> title;
         };
         std::vector<Route> _routes;
+        std::optional<std::size_t> _currentRouteIndex;
     };
 } // namespace lms::ui
@@ -156,8 +156,18 @@ namespace lms::ui
 
                 {
                     auto transaction{ LmsApp->getDbSession().createReadTransaction() };
+
+                    // the last artist may have been removed in the meantime
+                    if (const db::ArtistId lastArtistId{ _allArtistsCursor.getLastId(range) }; lastArtistId.isValid() && db::Artist::exists(LmsApp->getDbSession(), lastArtistId))
+                    {
+                        params.setLastArtistId(lastArtistId);
+                        params.setRange(db::Range{ 0, range.size });
+                    }
+
                     artists = db::Artist::findIds(LmsApp->getDbSession(), params);
                 }
+                artists.range.offset = range.offset;
+                _allArtistsCursor.update(range, artists);
                 break;
             }
         }
@@ -39,12 +39,17 @@ namespace lms::ui
         using DatabaseCollectorBase::DatabaseCollectorBase;
 
         db::RangeResults<db::ArtistId> get(std::optional<db::Range> range = std::nullopt);
-        void reset() { _randomArtists.reset(); }
+        void reset()
+        {
+            _randomArtists.reset();
+            _allArtistsCursor.reset();
+        }
         void setArtistType(ArtistType artistType) { _artistType = artistType; }
 
     private:
         db::RangeResults<db::ArtistId> getRandomArtists(Range range);
         std::optional<db::RangeResults<db::ArtistId>> _randomArtists;
+        KeysetCursor<db::ArtistId> _allArtistsCursor;
         ArtistType _artistType;
     };
 } // namespace lms::ui
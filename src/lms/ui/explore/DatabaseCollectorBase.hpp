@@ -60,6 +60,25 @@ namespace lms::ui
         void setSearch(std::string_view search);
 
     protected:
+        // Remembers the last entry of the previous batch, so that the following batch can be fetched without paying the offset cost
+        template<typename IdType>
+        class KeysetCursor
+        {
+        public:
+            // invalid if the requested range does not directly follow the previous batch
+            IdType getLastId(Range range) const { return range.offset == _nextOffset ? _lastId : IdType{}; }
+            void update(Range range, const db::RangeResults<IdType>& results)
+            {
+                _nextOffset = range.offset + results.results.size();
+                _lastId = results.results.empty() ? IdType{} : results.results.back();
+            }
+            void reset() { *this = KeysetCursor{}; }
+
+        private:
+            std::size_t _nextOffset{};
+            IdType _lastId;
+        };
+
         Range getActualRange(std::optional<Range> range) const;
         std::size_t getMaxCount() const;
         const db::Filters& getDbFilters() const;
@@ -121,8 +121,18 @@ namespace lms::ui
 
                 {
                     auto transaction{ LmsApp->getDbSession().createReadTransaction() };
+
+                    // the last release may have been removed in the meantime
+                    if (const db::ReleaseId lastReleaseId{ _allReleasesCursor.getLastId(range) }; lastReleaseId.isValid() && db::Release::exists(LmsApp->getDbSession(), lastReleaseId))
+                    {
+                        params.setLastReleaseId(lastReleaseId);
+                        params.setRange(db::Range{ 0, range.size });
+                    }
+
                     releases = db::Release::findIds(LmsApp->getDbSession(), params);
                 }
+                releases.range.offset = range.offset;
+                _allReleasesCursor.update(range, releases);
                 break;
             }
         }
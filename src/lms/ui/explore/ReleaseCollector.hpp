@@ -39,10 +39,15 @@ namespace lms::ui
         using DatabaseCollectorBase::DatabaseCollectorBase;
 
         db::RangeResults<db::ReleaseId> get(std::optional<db::Range> range = std::nullopt);
-        void reset() { _randomReleases.reset(); }
+        void reset()
+        {
+            _randomReleases.reset();
+            _allReleasesCursor.reset();
+        }
 
     private:
         db::RangeResults<db::ReleaseId> getRandomReleases(Range range);
         std::optional<db::RangeResults<db::ReleaseId>> _randomReleases;
+        KeysetCursor<db::ReleaseId> _allReleasesCursor;
     };
 } // namespace lms::ui
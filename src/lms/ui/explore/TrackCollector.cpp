@@ -117,12 +117,23 @@ namespace lms::ui
                 db::Track::FindParameters params;
                 params.setFilters(getDbFilters());
                 params.setKeywords(getSearchKeywords());
+                params.setSortMethod(db::TrackSortMethod::Id); // needed to resume from the last track
                 params.setRange(range);
 
                 {
                     auto transaction{ LmsApp->getDbSession().createReadTransaction() };
+
+                    // the last track may have been removed in the meantime
+                    if (const db::TrackId lastTrackId{ _allTracksCursor.getLastId(range) }; lastTrackId.isValid() && db::Track::exists(LmsApp->getDbSession(), lastTrackId))
+                    {
+                        params.setLastTrackId(lastTrackId);
+                        params.setRange(db::Range{ 0, range.size });
+                    }
+
                     tracks = db::Track::findIds(LmsApp->getDbSession(), params);
                 }
+                tracks.range.offset = range.offset;
+                _allTracksCursor.update(range, tracks);
                 break;
             }
         }
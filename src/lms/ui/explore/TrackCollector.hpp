@@ -38,10 +38,15 @@ namespace lms::ui
         using DatabaseCollectorBase::DatabaseCollectorBase;
 
         db::RangeResults<db::TrackId> get(std::optional<db::Range> range = std::nullopt);
-        void reset() { _randomTracks.reset(); }
+        void reset()
+        {
+            _randomTracks.reset();
+            _allTracksCursor.reset();
+        }
 
     private:
         db::RangeResults<db::TrackId> getRandomTracks(Range range);
         std::optional<db::RangeResults<db::TrackId>> _randomTracks;
+        KeysetCursor<db::TrackId> _allTracksCursor;
     };
 } // namespace lms::ui
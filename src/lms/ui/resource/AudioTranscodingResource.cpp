@@ -222,7 +222,14 @@ namespace lms::ui
         if (!continuation)
         {
             if (const auto& parameters{ readTranscodingParameters(request) })
-                resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(*parameters);
+            {
+                // The web player only requests the track being played
+                transcoding::TranscodeRequestOptions options;
+                options.userId = LmsApp->getUserId();
+                options.priority = transcoding::TranscodePriority::Playhead;
+
+                resourceHandler = core::Service<transcoding::ITranscodeService>::get()->createTranscodeResourceHandler(*parameters, options);
+            }
         }
         else
         {
@@ -23,6 +23,7 @@
 #include <Wt/WDateTime.h>
 
 #include "core/ILogger.hpp"
+#include "core/ZipperResourceHandlerCreator.hpp"
 #include "database/Session.hpp"
 #include "database/objects/Artist.hpp"
 #include "database/objects/Medium.hpp"
@@ -45,14 +46,14 @@ namespace lms::ui
     {
         try
         {
-            std::shared_ptr<zip::IZipper> zipper;
+            std::shared_ptr<core::IResourceHandler> zipperResourceHandler;
 
             // First, see if this request is for a continuation
             if (Wt::Http::ResponseContinuation * continuation{ request.continuation() })
-                zipper = Wt::cpp17::any_cast<std::shared_ptr<zip::IZipper>>(continuation->data());
+                zipperResourceHandler = Wt::cpp17::any_cast<std::shared_ptr<core::IResourceHandler>>(continuation->data());
             else
             {
-                zipper = createZipper();
+                std::unique_ptr<zip::IZipper> zipper{ createZipper() };
                 if (!zipper)
                 {
                     // no track, may be a legit case
@@ -60,15 +61,11 @@ namespace lms::ui
                     return;
                 }
 
-                response.setMimeType("application/zip");
+                zipperResourceHandler = zip::createZipperResourceHandler(std::move(zipper));
             }
 
-            zipper->writeSome(response.out());
-            if (!zipper->isComplete())
-            {
-                auto* continuation{ response.createContinuation() };
-                continuation->setData(zipper);
-            }
+            if (auto* continuation{ zipperResourceHandler->processRequest(request, response) })
+                continuation->setData(zipperResourceHandler);
         }
         catch (zip::Exception& exception)
         {
@@ -163,7 +160,7 @@ namespace lms::ui
                 files.emplace_back(zip::Entry{ fileName, track->getAbsoluteFilePath() });
             }
 
-            return zip::createArchiveZipper(files);
+            return zip::createStoreZipper(files);
         }
     } // namespace detail
 
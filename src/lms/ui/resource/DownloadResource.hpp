@@ -33,8 +33,6 @@ namespace lms::ui
     class DownloadResource : public Wt::WResource
     {
     public:
-        static constexpr std::size_t bufferSize{ 32768 };
-
         ~DownloadResource() override;
 
     private:
@@ -17,6 +17,7 @@
  * along with LMS.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <filesystem>
@@ -26,6 +27,7 @@
 
 #include <boost/program_options.hpp>
 
+#include "audio/MusicNNEmbeddings.hpp"
 #include "core/IConfig.hpp"
 #include "core/ILogger.hpp"
 #include "core/Service.hpp"
@@ -40,6 +42,7 @@
 #include "database/objects/Release.hpp"
 #include "database/objects/Track.hpp"
 #include "database/objects/TrackMusicNNEmbeddings.hpp"
+#include "math/HnswIndex.hpp"
 #include "services/recommendation/IRecommendationService.hpp"
 
 namespace lms
@@ -441,6 +444,115 @@ namespace lms
             }
         }
     }
+
+    // Compares the approximate nearest neighbor index to an exhaustive search
+    // Note: uses the raw track embeddings, not the reduced vectors used by the recommendation engine
+    void benchmarkNearestNeighborIndex(
+        db::Session session,
+        std::size_t queryCount,
+        unsigned seed,
+        unsigned maxCount,
+        std::span<const std::size_t> searchCandidateCounts)
+    {
+        using Vector = math::Vector<audio::MusicNNEmbedding::size, float>;
+        using Index = math::HnswIndex<audio::MusicNNEmbedding::size, float>;
+
+        if (queryCount == 0 || maxCount == 0)
+            return;
+
+        std::vector<Vector> vectors;
+        {
+            auto transaction{ session.createReadTransaction() };
+            vectors.reserve(db::TrackMusicNNEmbeddings::getCount(session));
+            db::TrackMusicNNEmbeddings::find(session, [&](const db::TrackMusicNNEmbeddings::pointer& dbEmbeddings) {
+                audio::TrackMusicNNEmbeddings embeddings{};
+                audio::trackMusicNNEmbeddingsFromBlob(dbEmbeddings->getData(), embeddings);
+
+                Vector& vector{ vectors.emplace_back() };
+                std::copy(std::cbegin(embeddings.mean.values), std::cend(embeddings.mean.values), std::begin(vector));
+                vector.normalizeL2();
+            });
+        }
+
+        std::cout << "*** Nearest neighbor index benchmark ***" << std::endl;
+        if (vectors.empty())
+        {
+            std::cout << "No tracks with TrackMusicNNEmbeddings found" << std::endl;
+            return;
+        }
+
+        Index::BuildParameters params;
+        params.maxNeighborCount = core::Service<core::IConfig>::get()->getULong("recommendation-ann-max-neighbor-count", params.maxNeighborCount);
+        params.candidateCount = core::Service<core::IConfig>::get()->getULong("recommendation-ann-build-candidate-count", params.candidateCount);
+
+        using Clock = std::chrono::steady_clock;
+        using Microseconds = std::chrono::duration<double, std::micro>;
+
+        Index index;
+        {
+            const Clock::time_point start{ Clock::now() };
+            index.build(vectors, params);
+            std::cout << "Built index for " << vectors.size() << " tracks in " << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count() << " ms (max neighbor count = " << params.maxNeighborCount << ", build candidate count = " << params.candidateCount << ")" << std::endl;
+        }
+
+        const unsigned effectiveSeed{ seed != 0 ? seed : std::random_device{}() };
+        std::minstd_rand rng{ effectiveSeed };
+        std::uniform_int_distribution<std::size_t> queryDistribution{ 0, vectors.size() - 1 };
+
+        std::vector<std::size_t> queries(std::min(queryCount, vectors.size()));
+        for (std::size_t& query : queries)
+            query = queryDistribution(rng);
+
+        // exact results
+        std::vector<std::vector<Index::NodeIndex>> expectedNeighbors;
+        Microseconds bruteForceDuration{};
+        for (const std::size_t query : queries)
+        {
+            const Clock::time_point start{ Clock::now() };
+
+            std::vector<Index::Neighbor> neighbors;
+            neighbors.reserve(vectors.size());
+            for (std::size_t i{}; i < vectors.size(); ++i)
+                neighbors.push_back({ static_cast<Index::NodeIndex>(i), math::computeNormalizedCosineDistance(vectors[query], vectors[i]) });
+
+            const std::size_t neighborCount{ std::min<std::size_t>(maxCount, neighbors.size()) };
+            std::partial_sort(std::begin(neighbors), std::next(std::begin(neighbors), static_cast<std::ptrdiff_t>(neighborCount)), std::end(neighbors), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+
+            bruteForceDuration += Clock::now() - start;
+
+            auto& expected{ expectedNeighbors.emplace_back() };
+            for (std::size_t i{}; i < neighborCount; ++i)
+                expected.push_back(neighbors[i].index);
+        }
+
+        std::cout << "seed=" << effectiveSeed << ", queries=" << queries.size() << ", max=" << maxCount << std::endl;
+        std::cout << "exhaustive search: " << bruteForceDuration.count() / static_cast<double>(queries.size()) << " us/query" << std::endl;
+
+        for (const std::size_t searchCandidateCount : searchCandidateCounts)
+        {
+            std::size_t foundCount{};
+            std::size_t expectedCount{};
+            Microseconds searchDuration{};
+
+            for (std::size_t i{}; i < queries.size(); ++i)
+            {
+                const Clock::time_point start{ Clock::now() };
+                const std::vector<Index::Neighbor> neighbors{ index.search(vectors[queries[i]], maxCount, searchCandidateCount) };
+                searchDuration += Clock::now() - start;
+
+                const std::vector<Index::NodeIndex>& expected{ expectedNeighbors[i] };
+                expectedCount += expected.size();
+                for (const Index::Neighbor& neighbor : neighbors)
+                {
+                    if (std::find(std::cbegin(expected), std::cend(expected), neighbor.index) != std::cend(expected))
+                        foundCount++;
+                }
+            }
+
+            std::cout << "search candidate count " << searchCandidateCount << ": recall = " << static_cast<double>(foundCount) / static_cast<double>(expectedCount)
+                      << ", " << searchDuration.count() / static_cast<double>(queries.size()) << " us/query" << std::endl;
+        }
+    }
 } // namespace lms
 
 int main(int argc, char* argv[])
@@ -466,7 +578,9 @@ int main(int argc, char* argv[])
             ("random-tracks", po::value<unsigned>(), "Display recommendation for N random tracks")
             ("random-releases", po::value<unsigned>(), "Display recommendation for N random releases")
             ("random-artists", po::value<unsigned>(), "Display recommendation for N random artists")
-            ("seed", po::value<unsigned>()->default_value(0), "Seed used with --random-tracks/--random-releases/--random-artists (0 means random seed)")
+            ("ann-recall", po::value<unsigned>(), "Benchmark the approximate nearest neighbor index against an exhaustive search, using N random tracks as queries")
+            ("ann-search-candidate-counts", po::value<std::string>()->default_value("32,64,128,256"), "Comma separated search candidate counts to evaluate with --ann-recall")
+            ("seed", po::value<unsigned>()->default_value(0), "Seed used with --random-tracks/--random-releases/--random-artists/--ann-recall (0 means random seed)")
             ("max,m", po::value<unsigned>()->default_value(10), "Max recommendation result count");
         // clang-format on
 
@@ -481,10 +595,28 @@ int main(int argc, char* argv[])
 
         core::Service<core::IConfig> config{ core::createConfig(vm["conf"].as<std::string>()) };
 
-        auto db{ db::createDb(config->getPath("working-dir", "/var/lms") / "lms.db") };
+        const std::filesystem::path workingDirectoryPath{ config->getPath("working-dir", "/var/lms") };
+        auto db{ db::createDb(workingDirectoryPath / "lms.db") };
         db::Session session{ *db };
 
-        const auto recommendationService{ recommendation::createRecommendationService(*db) };
+        unsigned maxCount{ vm["max"].as<unsigned>() };
+
+        // does not need the recommendation engine
+        if (vm.count("ann-recall"))
+        {
+            const std::string searchCandidateCountsStr{ vm["ann-search-candidate-counts"].as<std::string>() };
+            std::vector<std::size_t> searchCandidateCounts;
+            for (std::string_view str : core::stringUtils::splitString(searchCandidateCountsStr, ','))
+            {
+                if (const auto value{ core::stringUtils::readAs<std::size_t>(str) })
+                    searchCandidateCounts.push_back(*value);
+            }
+
+            benchmarkNearestNeighborIndex(*db, vm["ann-recall"].as<unsigned>(), vm["seed"].as<unsigned>(), maxCount, searchCandidateCounts);
+            return EXIT_SUCCESS;
+        }
+
+        const auto recommendationService{ recommendation::createRecommendationService(*db, workingDirectoryPath / "cache" / "recommendation") };
 
         if (recommendationService->getEngineType() == recommendation::EngineType::None)
         {
@@ -495,8 +627,6 @@ int main(int argc, char* argv[])
         while (!recommendationService->isLoaded())
             std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
 
-        unsigned maxCount{ vm["max"].as<unsigned>() };
-
         if (vm.count("track"))
             dumpTracksRecommendation(*db, *recommendationService, vm["track"].as<std::string>(), maxCount);
 
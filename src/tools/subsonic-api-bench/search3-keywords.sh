@@ -0,0 +1,42 @@
+#!/bin/bash
+
+if [ "$#" -lt 4 ]; then
+    echo "Usage: $0 <base_url> <user> <run_count> <query> [query...]"
+    echo "Example: $0 http://localhost:5082 admin 50 \"love\" \"the beat\" \"yesterday\""
+    exit 1
+fi
+
+# make any command failure exit
+set -e
+
+read -r -s -p "Enter password: " user_password
+echo
+
+base_url="$1"
+user="$2"
+run_count="$3"
+shift 3
+
+for query in "$@"; do
+    encoded_query=$(printf '%s' "$query" | jq -sRr @uri)
+
+    # warm up caches
+    wget -q -O - "$base_url/rest/search3.view?u=$user&p=$user_password&v=1.13.0&c=benchmark&f=json&query=$encoded_query" > /dev/null
+
+    durations=()
+    for ((i = 0; i < run_count; i++)); do
+        start_time=$(date +%s%N)
+        wget -q -O - "$base_url/rest/search3.view?u=$user&p=$user_password&v=1.13.0&c=benchmark&f=json&query=$encoded_query" > /dev/null
+        end_time=$(date +%s%N)
+        durations+=($(((end_time - start_time) / 1000)))
+    done
+
+    # durations are in microseconds
+    printf '%s\n' "${durations[@]}" | sort -n | awk -v query="$query" '
+        { values[NR] = $1; total += $1 }
+        END {
+            p50 = values[int((NR - 1) * 0.50) + 1]
+            p95 = values[int((NR - 1) * 0.95) + 1]
+            printf "\"%s\": runs = %d, min = %.2f ms, avg = %.2f ms, p50 = %.2f ms, p95 = %.2f ms, max = %.2f ms\n", query, NR, values[1] / 1000, total / NR / 1000, p50 / 1000, p95 / 1000, values[NR] / 1000
+        }'
+done